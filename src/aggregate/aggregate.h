@@ -214,6 +214,11 @@ typedef struct AREQ {
 
   ProfilePrinterCtx profileCtx;
 
+  /** Key of the reply in the index query cache, NULL if the reply is not cached */
+  sds queryCacheKey;
+  /** Index write epoch read before the request started executing */
+  uint64_t queryCacheEpoch;
+
 } AREQ;
 
 /* Forward declaration; full type lives in hybrid_request.h. */
@@ -432,6 +437,23 @@ ResultProcessor *Grouper_GetRP(Grouper *gr);
  */
 void Grouper_AddReducer(Grouper *g, Reducer *r, RLookupKey *dst);
 
+/**
+ * Group the rows in `num` partitions of the group keys, each updated by a different worker
+ * thread, see QUERY_MAX_PARALLELISM. Must be called after all the reducers were added.
+ * Every partition but the first needs its own instances of the reducers, added in the same
+ * order with Grouper_AddPartitionReducer.
+ */
+void Grouper_SetPartitions(Grouper *g, size_t num);
+
+/**
+ * Adds the instance of the next reducer for a partition (see Grouper_SetPartitions). Its
+ * destination key is the one of the matching reducer added with Grouper_AddReducer.
+ */
+void Grouper_AddPartitionReducer(Grouper *g, size_t partition, Reducer *r);
+
+/** The number of partitions of the grouper result processor, reported by FT.PROFILE. */
+size_t Grouper_NumPartitions(const ResultProcessor *rp);
+
 void AREQ_Execute(AREQ *req, RedisModuleCtx *outctx);
 void sendChunk(AREQ *req, RedisModule_Reply *reply, size_t limit);
 void sendChunk_ReplyOnly_EmptyResults(RedisModuleCtx *ctx, AREQ *req);
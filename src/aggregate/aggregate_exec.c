@@ -25,12 +25,16 @@
 #include "aggregate_exec_common.h"
 #include "cursor.h"
 #include "concurrent_ctx.h"
+#include "coord/rmr/command.h"
 #include "rmutil/util.h"
 #include "util/timeout.h"
 #include "util/workers.h"
 #include "score_explain.h"
 #include "profile/profile.h"
 #include "query_optimizer.h"
+#include "query_cache.h"
+#include "filter_cache.h"
+#include "indexing_pipeline.h"
 #include "resp3.h"
 #include "query_error_ffi.h"
 #include "query_eval_ffi.h"
@@ -515,6 +519,42 @@ long calc_results_len(AREQ *req, size_t limit) {
   return 1 + MIN(limit, MIN(reqLimit, reqResults)) * resultFactor;
 }
 
+/* Start recording the reply of a request whose reply is to be cached */
+static void queryCacheStartRecording(AREQ *req, RedisModule_Reply *reply) {
+  if (req->queryCacheKey) {
+    reply->recording = ReplyRecording_New();
+  }
+}
+
+/* Cache the recorded reply, unless the run was cut short or partial, or the
+ * index was written to since the request started (the spec lock may have been
+ * yielded meanwhile). Must run before finishSendChunk clears the query error. */
+static void queryCacheFinishRecording(AREQ *req, RedisModule_Reply *reply, int rc) {
+  ReplyRecording *rec = reply->recording;
+  if (!rec) {
+    return;
+  }
+  reply->recording = NULL;
+
+  QueryProcessingCtx *qctx = AREQ_QueryProcessingCtx(req);
+  IndexSpec *spec = AREQ_SearchCtx(req)->spec;
+  const bool complete =
+      (rc == RS_RESULT_OK || rc == RS_RESULT_EOF) && QueryError_IsOk(qctx->err) &&
+      !QueryError_HasQueryOOMWarning(qctx->err) &&
+      !QueryError_HasReachedMaxPrefixExpansionsWarning(qctx->err) &&
+      !(req->stateflags & (QEXEC_S_ASM_TRIMMING_DELAY_TIMEOUT | QEXEC_S_SHARD_TIMED_OUT_WARNING |
+                           QEXEC_S_MAX_TIMEOUT_CAPPED)) &&
+      !qctx->bgScanOOM && !spec->scan_failed_OOM;
+
+  if (!complete || IndexSpec_GetWriteEpoch(spec) != req->queryCacheEpoch) {
+    ReplyRecording_Free(rec);
+    return;
+  }
+  QueryCache_Put(spec->queryCache, req->queryCacheKey, req->queryCacheEpoch, rec,
+                 RSGlobalConfig.queryCacheMaxMemory);
+  req->queryCacheKey = NULL;
+}
+
 static void finishSendChunk(AREQ *req, SearchResult **results, SearchResult *r, bool cursor_done) {
   if (results) {
     destroyResults(results);
@@ -829,7 +869,9 @@ static void sendChunk_Resp2(AREQ *req, RedisModule_Reply *reply, size_t limit,
 
     state.r = &r;
 
+    queryCacheStartRecording(req, reply);
     rc = serializeAndReplyResults_Resp2(req, reply, rp, qctx, rc, limit, &cv, &state);
+    queryCacheFinishRecording(req, reply, rc);
 
     finishSendChunk(req, state.results, &r, state.cursor_done);
 
@@ -1035,7 +1077,9 @@ static void sendChunk_Resp3(AREQ *req, RedisModule_Reply *reply, size_t limit,
 
     state.r = &r;
 
+    queryCacheStartRecording(req, reply);
     rc = serializeAndReplyResults_Resp3(req, reply, rp, qctx, rc, &cv, &state);
+    queryCacheFinishRecording(req, reply, rc);
 
     finishSendChunk(req, state.results, &r, state.cursor_done);
 }
@@ -1465,6 +1509,74 @@ static int validateSortbyForDiskIndex(AREQ *req, QueryError *status) {
 
 // Assumes the spec is guarded by its own lock (for read), such that races with
 // main-thread/GC updates are avoided.
+/* Node types that are evaluated again for every partition of a parallel scan. Expansions and
+ * vector queries are costly to evaluate and may record state on the request, so they stay serial. */
+static int isPartitionableNode(QueryNode *node, QueryNode *q, void *ctx) {
+  switch (node->type) {
+    case QN_PHRASE:
+    case QN_UNION:
+    case QN_TOKEN:
+    case QN_NUMERIC:
+    case QN_NOT:
+    case QN_OPTIONAL:
+    case QN_GEO:
+    case QN_IDS:
+    case QN_WILDCARD:
+    case QN_TAG:
+    case QN_NULL:
+    case QN_MISSING:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/* Partition the scan of a large query across the worker threads, by building one more iterator
+ * tree of the query for every extra partition. The query stays serial if it is estimated to match
+ * fewer than QUERY_PARALLEL_MIN_DOCS documents, or if its pipeline needs the index results. */
+static void partitionScan(AREQ *req) {
+  RedisSearchCtx *sctx = AREQ_SearchCtx(req);
+  size_t numPartitions = RSGlobalConfig.queryMaxParallelism;
+  if (numPartitions > RSGlobalConfig.numWorkerThreads) {
+    numPartitions = RSGlobalConfig.numWorkerThreads;
+  }
+  if (numPartitions < 2 || sctx->spec->diskSpec || IsProfile(req) || IsDebug(req) ||
+      IsOptimized(req) || IsHybrid(req) ||
+      (req->ast.metricRequests && array_len(req->ast.metricRequests)) || !req->ast.root ||
+      !QueryNode_ForEach(req->ast.root, isPartitionableNode, NULL, 0)) {
+    return;
+  }
+
+  QueryProcessingCtx *qctx = AREQ_QueryProcessingCtx(req);
+  QueryIterator *root = QITR_GetRootFilter(qctx);
+  if (!root || !RPQueryIterator_CanReadAhead(qctx->rootProc) ||
+      root->NumEstimated(root) < RSGlobalConfig.queryParallelMinDocs) {
+    return;
+  }
+
+  QueryIterator **iterators = rm_malloc((numPartitions - 1) * sizeof(*iterators));
+  QueryError status = QueryError_Default();
+  size_t num = 0;
+  for (; num < numPartitions - 1; ++num) {
+    iterators[num] = QAST_Iterate(&req->ast, &req->searchopts, sctx, AREQ_RequestFlags(req), req, &status);
+    if (!iterators[num] || QueryError_HasError(&status)) {
+      break;
+    }
+  }
+  if (num == numPartitions - 1) {
+    RPQueryIterator_SetPartitions(qctx->rootProc, iterators, num);
+  } else {
+    // Evaluating the query a second time should not fail, but if it does the query stays serial
+    for (size_t ii = 0; ii <= num; ++ii) {
+      if (iterators[ii]) {
+        iterators[ii]->Free(iterators[ii]);
+      }
+    }
+  }
+  QueryError_ClearError(&status);
+  rm_free(iterators);
+}
+
 int prepareExecutionPlan(AREQ *req, QueryError *status) {
   int rc = REDISMODULE_ERR;
   RedisSearchCtx *sctx = AREQ_SearchCtx(req);
@@ -1527,6 +1639,9 @@ int prepareExecutionPlan(AREQ *req, QueryError *status) {
   }
 
   rc = AREQ_BuildPipeline(req, status);
+  if (rc == REDISMODULE_OK) {
+    partitionScan(req);
+  }
 
   if (is_profile) {
     req->profileClocks.profilePipelineBuildTime = rs_wall_clock_elapsed_ns(&parseClock);
@@ -1745,11 +1860,13 @@ void AREQ_ReplyWithStoredResults(RedisModuleCtx *ctx, AREQ *req) {
   RedisModule_Reply _reply = RedisModule_NewReply(ctx), *reply = &_reply;
 
   // Call serializeAndReplyResults like the normal sendChunk path
+  queryCacheStartRecording(req, reply);
   if (reply->resp3) {
     rc = serializeAndReplyResults_Resp3(req, reply, rp, qctx, rc, &stored->cv, &state);
   } else {
     rc = serializeAndReplyResults_Resp2(req, reply, rp, qctx, rc, stored->limit, &stored->cv, &state);
   }
+  queryCacheFinishRecording(req, reply, rc);
 
   RedisModule_EndReply(reply);
 
@@ -1944,8 +2061,138 @@ static int rejectDiskLoaderInlineExecution(AREQ *r, const RedisSearchCtx *sctx,
   return REDISMODULE_OK;
 }
 
+static sds queryCacheAppend(sds key, const void *data, size_t len) {
+  key = sdscatlen(key, &len, sizeof(len));
+  return len ? sdscatlen(key, data, len) : key;
+}
+
+static sds queryCacheAppendStr(sds key, const char *str) {
+  return queryCacheAppend(key, str, str ? strlen(str) : 0);
+}
+
+/* Build the query cache key of the request: the parsed query, plus the
+ * resolved options and the arguments that follow the query string, which shape
+ * the reply (LIMIT, SORTBY, RETURN, LOAD, pipeline steps...). The global
+ * configs the query runs with are part of the key, so that changing them at
+ * runtime does not serve replies computed under the previous values. */
+static sds queryCacheBuildKey(const AREQ *r) {
+  const RSSearchOptions *opts = &r->searchopts;
+  struct {
+    QEFlags reqflags;
+    int protocol;
+    uint32_t searchFlags;
+    int slop;
+    t_fieldMask fieldmask;
+    RSLanguage language;
+    unsigned int dialectVersion;
+    unsigned int defaultDialectVersion;
+    unsigned int BM25STD_TanhFactor;
+    long long queryTimeoutMS;
+    RSTimeoutPolicy timeoutPolicy;
+    RSOomPolicy oomPolicy;
+    IteratorsConfig iteratorsConfig;
+    size_t maxSearchResults;
+    size_t maxAggregateResults;
+  } header;
+  // Zeroed so the padding bytes do not leak into the key
+  memset(&header, 0, sizeof(header));
+  header.reqflags = r->reqflags;
+  header.protocol = r->protocol;
+  header.searchFlags = opts->flags;
+  header.slop = opts->slop;
+  header.fieldmask = opts->fieldmask;
+  header.language = opts->language;
+  header.dialectVersion = r->reqConfig.dialectVersion;
+  header.defaultDialectVersion = RSGlobalConfig.requestConfigParams.dialectVersion;
+  header.BM25STD_TanhFactor = r->reqConfig.BM25STD_TanhFactor;
+  header.queryTimeoutMS = r->reqConfig.queryTimeoutMS;
+  header.timeoutPolicy = r->reqConfig.timeoutPolicy;
+  header.oomPolicy = r->reqConfig.oomPolicy;
+  iteratorsConfig_init(&header.iteratorsConfig);
+  header.maxSearchResults = r->maxSearchResults;
+  header.maxAggregateResults = r->maxAggregateResults;
+
+  sds key = sdsnewlen(&header, sizeof(header));
+  key = queryCacheAppendStr(key, opts->scorerName);
+  key = queryCacheAppendStr(key, opts->expanderName);
+  key = QAST_CacheKey(key, &r->ast);
+
+  const QueryRequestArgs *args = &r->base.args;
+  for (uint32_t ii = args->queryOffset + 1; ii < args->parseArgc; ++ii) {
+    size_t len;
+    const char *arg = RedisModule_StringPtrLen(args->argv[ii], &len);
+    if (len == sizeof(COORD_DISPATCH_TIME_STR) - 1 && !memcmp(arg, COORD_DISPATCH_TIME_STR, len)) {
+      ++ii;  // Differs on every dispatch, and does not shape the reply
+      continue;
+    }
+    key = queryCacheAppend(key, arg, len);
+  }
+  return key;
+}
+
+/* Reply from the index query cache if the request's reply is cached. Otherwise,
+ * set the request up to fill the cache, if its reply may be cached.
+ * Called on the main thread, before the request is dispatched. */
+static bool queryCacheTryReply(AREQ *r, RedisModuleCtx *ctx) {
+  IndexSpec *spec = AREQ_SearchCtx(r)->spec;
+  const size_t maxMemory = RSGlobalConfig.queryCacheMaxMemory;
+  if (!maxMemory) {
+    if (spec && spec->queryCache) {
+      QueryCache_Clear(spec->queryCache);
+    }
+    return false;
+  }
+  // Replies of indexes with expiring documents or fields depend on the time
+  if (!spec || spec->diskSpec || spec->docs.ttl || spec->docs.hasDocExpiration ||
+      (r->searchopts.flags & Search_NoCache) || IsCursor(r) || IsProfile(r) || IsDebug(r) ||
+      IsHybrid(r) || IsCoordinator(r) || r->base.args.queryOffset == QUERY_OFFSET_NONE) {
+    return false;
+  }
+
+  if (!spec->queryCache) {
+    // Created here, on the main thread, before any worker may fill it
+    spec->queryCache = QueryCache_New();
+  }
+  r->queryCacheEpoch = IndexSpec_GetWriteEpoch(spec);
+  r->queryCacheKey = queryCacheBuildKey(r);
+
+  RedisModule_Reply _reply = RedisModule_NewReply(ctx), *reply = &_reply;
+  bool hit = QueryCache_Reply(spec->queryCache, r->queryCacheKey, r->queryCacheEpoch, reply);
+  RedisModule_EndReply(reply);
+  if (hit) {
+    rs_wall_clock_ns_t duration = rs_wall_clock_elapsed_ns(&r->profileClocks.initClock);
+    TotalGlobalStats_CountQuery(AREQ_RequestFlags(r), duration);
+  }
+  return hit;
+}
+
+/* Create the index filter cache when it is enabled, or drop its entries when it
+ * is not. Called on the main thread, before the request is dispatched, so the
+ * cache exists before any worker may fill it. */
+static void filterCachePrepare(IndexSpec *spec) {
+  if (!spec || spec->diskSpec) {
+    return;
+  }
+  if (!RSGlobalConfig.filterCacheMaxMemory) {
+    if (spec->filterCache) {
+      FilterCache_Clear(spec->filterCache);
+    }
+  } else if (!spec->filterCache) {
+    spec->filterCache = FilterCache_New();
+  }
+}
+
 static int buildPipelineAndExecute(AREQ *r, RedisModuleCtx *ctx, QueryError *status) {
   RedisSearchCtx *sctx = AREQ_SearchCtx(r);
+  if (sctx->spec) {
+    IndexingPipeline_FlushForQuery(sctx->spec);
+  }
+  filterCachePrepare(sctx->spec);
+  if (queryCacheTryReply(r, ctx)) {
+    AREQ_DecrRef(r);
+    CurrentThread_ClearIndexSpec();
+    return REDISMODULE_OK;
+  }
   if (RunInThread(ctx)) {
     StrongRef spec_ref = IndexSpec_GetStrongRefUnsafe(sctx->spec);
 
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "batch.h"
+
+#include <math.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include "rlookup_ffi.h"
+#include "search_result_ffi.h"
+#include "value_ffi.h"
+#include "rmalloc.h"
+#include "rmutil/rm_assert.h"
+#include "util/arr/arr.h"
+
+typedef enum {
+  BATCH_NUMBER,     // Push a constant column
+  BATCH_PROPERTY,   // Push the values of a property
+  BATCH_OP,         // Pop two columns, push the result of an arithmetic operator
+  BATCH_PREDICATE,  // Pop two columns, push the result of a comparison or a logical operator
+  BATCH_NOT,        // Negate the top column
+  BATCH_FUNCTION,   // Apply a numeric kernel to the top column
+} ExprBatchOpcode;
+
+typedef struct {
+  ExprBatchOpcode code;
+  union {
+    double number;
+    const RLookupKey *key;
+    unsigned char op;
+    RSCondition cond;
+    RSNumericFunction kernel;
+  };
+} ExprBatchInstr;
+
+struct ExprBatch {
+  ExprBatchInstr *prog;  // arr, in postfix order
+  size_t depth;          // Number of columns of the stack
+  double *stack;         // depth * EXPR_BATCH_SIZE values
+};
+
+static bool compile(ExprBatch *b, const RSExpr *e, size_t sp) {
+  ExprBatchInstr ins = {0};
+  switch (e->t) {
+    case RSExpr_Literal: {
+      const RSValue *v = RSValue_Dereference(e->literal);
+      if (!RSValue_IsNumber(v)) {
+        return false;
+      }
+      ins.code = BATCH_NUMBER;
+      ins.number = RSValue_Number_Get(v);
+      break;
+    }
+    case RSExpr_Property:
+      if (!e->property.lookupObj) {
+        return false;
+      }
+      ins.code = BATCH_PROPERTY;
+      ins.key = e->property.lookupObj;
+      break;
+    case RSExpr_Op:
+      if (!compile(b, e->op.left, sp) || !compile(b, e->op.right, sp + 1)) {
+        return false;
+      }
+      ins.code = BATCH_OP;
+      ins.op = e->op.op;
+      break;
+    case RSExpr_Predicate:
+      if (!compile(b, e->pred.left, sp) || !compile(b, e->pred.right, sp + 1)) {
+        return false;
+      }
+      ins.code = BATCH_PREDICATE;
+      ins.cond = e->pred.cond;
+      break;
+    case RSExpr_Inverted:
+      if (!compile(b, e->inverted.child, sp)) {
+        return false;
+      }
+      ins.code = BATCH_NOT;
+      break;
+    case RSExpr_Function:
+      if (!e->func.Numeric || e->func.args->len != 1 || !compile(b, e->func.args->args[0], sp)) {
+        return false;
+      }
+      ins.code = BATCH_FUNCTION;
+      ins.kernel = e->func.Numeric;
+      break;
+    default:
+      return false;
+  }
+  b->depth = MAX(b->depth, sp + 1);
+  array_append(b->prog, ins);
+  return true;
+}
+
+ExprBatch *ExprBatch_Compile(const RSExpr *root) {
+  // A literal or a property at the root evaluates to (a reference to) that value, which is not
+  // necessarily a number
+  if (root->t == RSExpr_Literal || root->t == RSExpr_Property) {
+    return NULL;
+  }
+  ExprBatch *b = rm_calloc(1, sizeof(*b));
+  b->prog = array_new(ExprBatchInstr, 8);
+  if (!compile(b, root, 0)) {
+    ExprBatch_Free(b);
+    return NULL;
+  }
+  b->stack = rm_malloc(b->depth * EXPR_BATCH_SIZE * sizeof(*b->stack));
+  return b;
+}
+
+void ExprBatch_Free(ExprBatch *b) {
+  array_free(b->prog);
+  rm_free(b->stack);
+  rm_free(b);
+}
+
+static void loadProperty(const RLookupKey *key, const SearchResult *results, size_t n,
+                         double *col, uint8_t *valid) {
+  for (size_t ii = 0; ii < n; ++ii) {
+    const RSValue *v = RLookupRow_Get(key, SearchResult_GetRowData(&results[ii]));
+    if (v && RSValue_IsNumber(v = RSValue_Dereference(v))) {
+      col[ii] = RSValue_Number_Get(v);
+    } else {
+      col[ii] = 0;
+      valid[ii] = 0;
+    }
+  }
+}
+
+#define COLUMN_LOOP(expr)             \
+  for (size_t ii = 0; ii < n; ++ii) { \
+    l[ii] = (expr);                   \
+  }
+
+static void evalOp(unsigned char op, double *restrict l, const double *restrict r, size_t n) {
+  switch (op) {
+    case '+': COLUMN_LOOP(l[ii] + r[ii]); break;
+    case '-': COLUMN_LOOP(l[ii] - r[ii]); break;
+    case '*': COLUMN_LOOP(l[ii] * r[ii]); break;
+    case '/': COLUMN_LOOP(l[ii] / r[ii]); break;
+    case '%': COLUMN_LOOP(fmod(l[ii], r[ii])); break;
+    case '^': COLUMN_LOOP(pow(l[ii], r[ii])); break;
+    default: RS_LOG_ASSERT_FMT(0, "Invalid operator %c", op);
+  }
+}
+
+// Numbers compare as RSValue_Cmp and RSValue_Equal do: NaN is equal to everything
+static void evalPredicate(RSCondition cond, double *restrict l, const double *restrict r,
+                          size_t n) {
+  switch (cond) {
+    case RSCondition_Eq: COLUMN_LOOP(!(l[ii] < r[ii]) && !(l[ii] > r[ii])); break;
+    case RSCondition_Ne: COLUMN_LOOP(l[ii] < r[ii] || l[ii] > r[ii]); break;
+    case RSCondition_Lt: COLUMN_LOOP(l[ii] < r[ii]); break;
+    case RSCondition_Le: COLUMN_LOOP(!(l[ii] > r[ii])); break;
+    case RSCondition_Gt: COLUMN_LOOP(l[ii] > r[ii]); break;
+    case RSCondition_Ge: COLUMN_LOOP(!(l[ii] < r[ii])); break;
+    case RSCondition_And: COLUMN_LOOP(l[ii] != 0 && r[ii] != 0); break;
+    case RSCondition_Or: COLUMN_LOOP(l[ii] != 0 || r[ii] != 0); break;
+    default: RS_ABORT("invalid RSCondition");
+  }
+}
+
+void ExprBatch_Eval(ExprBatch *b, const SearchResult *results, size_t n, double *out,
+                    uint8_t *valid) {
+  RS_ASSERT(n <= EXPR_BATCH_SIZE);
+  memset(valid, 1, n);
+  size_t sp = 0;  // Number of columns on the stack
+#define COLUMN(idx) (b->stack + (idx) * EXPR_BATCH_SIZE)
+  for (size_t ii = 0; ii < array_len(b->prog); ++ii) {
+    const ExprBatchInstr *ins = &b->prog[ii];
+    switch (ins->code) {
+      case BATCH_NUMBER:
+        for (size_t jj = 0; jj < n; ++jj) {
+          COLUMN(sp)[jj] = ins->number;
+        }
+        ++sp;
+        break;
+      case BATCH_PROPERTY:
+        loadProperty(ins->key, results, n, COLUMN(sp), valid);
+        ++sp;
+        break;
+      case BATCH_OP:
+        evalOp(ins->op, COLUMN(sp - 2), COLUMN(sp - 1), n);
+        --sp;
+        break;
+      case BATCH_PREDICATE:
+        evalPredicate(ins->cond, COLUMN(sp - 2), COLUMN(sp - 1), n);
+        --sp;
+        break;
+      case BATCH_NOT:
+        for (double *top = COLUMN(sp - 1), *end = top + n; top < end; ++top) {
+          *top = *top == 0;
+        }
+        break;
+      case BATCH_FUNCTION:
+        ins->kernel(COLUMN(sp - 1), valid, n);
+        break;
+    }
+  }
+  RS_ASSERT(sp == 1);
+  memcpy(out, COLUMN(0), n * sizeof(*out));
+#undef COLUMN
+}
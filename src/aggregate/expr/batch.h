@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "expression.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Batch evaluation of numeric expressions.
+ *
+ * An expression made only of numeric literals, properties, arithmetic, predicates, NOT and
+ * functions with a numeric kernel is compiled to a postfix program over columns of doubles.
+ * A batch of rows is then evaluated one node at a time, each node being a tight loop over the
+ * column, instead of walking the tree and allocating values for every row.
+ *
+ * Every row of the batch has a valid flag, cleared when a property is missing or is not a
+ * number, or when a function does not return a number. The value of such a row is left to the
+ * row evaluator (ExprEval_Eval), which also reports its errors.
+ */
+#define EXPR_BATCH_SIZE 1024
+
+typedef struct ExprBatch ExprBatch;
+
+/**
+ * Compile `root`, whose properties were resolved by ExprAST_GetLookupKeys.
+ * Returns NULL if the expression can not be evaluated in batches, or if the result of its
+ * root is not a number computed by the expression.
+ */
+ExprBatch *ExprBatch_Compile(const RSExpr *root);
+
+void ExprBatch_Free(ExprBatch *batch);
+
+/**
+ * Evaluate the expression over the rows of the `n` results, n <= EXPR_BATCH_SIZE.
+ * `out[ii]` is the value of the expression for results[ii], if `valid[ii]` is set.
+ */
+void ExprBatch_Eval(ExprBatch *batch, const SearchResult *results, size_t n, double *out,
+                    uint8_t *valid);
+
+#ifdef __cplusplus
+}
+#endif
@@ -106,6 +106,7 @@ RSExpr *RS_NewFunc(RSFunctionInfo *cb, RSArgList *args) {
   e->func.args = args;
   e->func.name = cb->name;
   e->func.Call = cb->f;
+  e->func.Numeric = cb->numeric;
   return e;
 }
 
@@ -7,6 +7,8 @@
  * GNU Affero General Public License v3 (AGPLv3).
 */
 #include "expression.h"
+#include "batch.h"
+#include "exprast.h"
 
 #include <math.h>
 #include <string.h>
@@ -312,6 +314,12 @@ static int evalProperty(ExprEval *eval, const RSLookupExpr *e, RSValue *res) {
 
 static int evalInternal(ExprEval *eval, const RSExpr *e, RSValue *res) {
   RSValue_Clear(res);
+  // Literals and properties evaluate to references to their value
+  double n;
+  if (e->numeric && e->t != RSExpr_Literal && e->t != RSExpr_Property && e->numeric(eval, e, &n)) {
+    RSValue_SetNumber(res, n);
+    return EXPR_EVAL_OK;
+  }
   switch (e->t) {
     case RSExpr_Property:
       return evalProperty(eval, &e->property, res);
@@ -334,6 +342,218 @@ int ExprEval_Eval(ExprEval *evaluator, RSValue *result) {
   return evalInternal(evaluator, evaluator->root, result);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Numeric evaluation functions, see ExprAST_Compile */
+
+static bool numLiteral(ExprEval *eval, const RSExpr *e, double *out) {
+  *out = RSValue_Number_Get(e->literal);
+  return true;
+}
+
+static bool numProperty(ExprEval *eval, const RSExpr *e, double *out) {
+  const RSValue *v = RLookupRow_Get(e->property.lookupObj, eval->srcrow);
+  if (!v || !RSValue_IsNumber(v = RSValue_Dereference(v))) {
+    return false;
+  }
+  *out = RSValue_Number_Get(v);
+  return true;
+}
+
+#define NUMERIC_BINARY(name, node, expr)                                 \
+  static bool name(ExprEval *eval, const RSExpr *e, double *out) {       \
+    const RSExpr *left = e->node.left, *right = e->node.right;           \
+    double l, r;                                                         \
+    if (!left->numeric(eval, left, &l) || !right->numeric(eval, right, &r)) { \
+      return false;                                                      \
+    }                                                                    \
+    *out = (expr);                                                       \
+    return true;                                                         \
+  }
+
+NUMERIC_BINARY(numAdd, op, l + r)
+NUMERIC_BINARY(numSub, op, l - r)
+NUMERIC_BINARY(numMul, op, l * r)
+NUMERIC_BINARY(numDiv, op, l / r)
+NUMERIC_BINARY(numMod, op, fmod(l, r))
+NUMERIC_BINARY(numPow, op, pow(l, r))
+// Numbers compare as RSValue_Cmp and RSValue_Equal do: NaN is equal to everything
+NUMERIC_BINARY(numEq, pred, !(l < r) && !(l > r))
+NUMERIC_BINARY(numNe, pred, l < r || l > r)
+NUMERIC_BINARY(numLt, pred, l < r)
+NUMERIC_BINARY(numLe, pred, !(l > r))
+NUMERIC_BINARY(numGt, pred, l > r)
+NUMERIC_BINARY(numGe, pred, !(l < r))
+
+// The logical operators short circuit as evalPredicate does
+static bool numAnd(ExprEval *eval, const RSExpr *e, double *out) {
+  double l, r;
+  if (!e->pred.left->numeric(eval, e->pred.left, &l)) {
+    return false;
+  }
+  if (l == 0) {
+    *out = 0;
+    return true;
+  }
+  if (!e->pred.right->numeric(eval, e->pred.right, &r)) {
+    return false;
+  }
+  *out = r != 0;
+  return true;
+}
+
+static bool numOr(ExprEval *eval, const RSExpr *e, double *out) {
+  double l, r;
+  if (!e->pred.left->numeric(eval, e->pred.left, &l)) {
+    return false;
+  }
+  if (l != 0) {
+    *out = 1;
+    return true;
+  }
+  if (!e->pred.right->numeric(eval, e->pred.right, &r)) {
+    return false;
+  }
+  *out = r != 0;
+  return true;
+}
+
+static bool numNot(ExprEval *eval, const RSExpr *e, double *out) {
+  double v;
+  if (!e->inverted.child->numeric(eval, e->inverted.child, &v)) {
+    return false;
+  }
+  *out = v == 0;
+  return true;
+}
+
+static bool numFunction(ExprEval *eval, const RSExpr *e, double *out) {
+  const RSExpr *arg = e->func.args->args[0];
+  uint8_t valid = 1;
+  if (!arg->numeric(eval, arg, out)) {
+    return false;
+  }
+  e->func.Numeric(out, &valid, 1);
+  return valid;
+}
+
+static RSExprNumeric numericOp(unsigned char op) {
+  switch (op) {
+    case '+': return numAdd;
+    case '-': return numSub;
+    case '*': return numMul;
+    case '/': return numDiv;
+    case '%': return numMod;
+    case '^': return numPow;
+    default: return NULL;
+  }
+}
+
+static RSExprNumeric numericPredicate(RSCondition cond) {
+  switch (cond) {
+    case RSCondition_Eq: return numEq;
+    case RSCondition_Ne: return numNe;
+    case RSCondition_Lt: return numLt;
+    case RSCondition_Le: return numLe;
+    case RSCondition_Gt: return numGt;
+    case RSCondition_Ge: return numGe;
+    case RSCondition_And: return numAnd;
+    case RSCondition_Or: return numOr;
+    default: return NULL;
+  }
+}
+
+/* Replace a numeric expression without properties by its value */
+static void foldConstant(RSExpr *e) {
+  double n;
+  if (!e->numeric(NULL, e, &n)) {
+    return;  // e.g. a function without a value for its argument, left to the generic evaluation
+  }
+  switch (e->t) {
+    case RSExpr_Op:
+      RSExpr_Free(e->op.left);
+      RSExpr_Free(e->op.right);
+      break;
+    case RSExpr_Predicate:
+      RSExpr_Free(e->pred.left);
+      RSExpr_Free(e->pred.right);
+      break;
+    case RSExpr_Inverted:
+      RSExpr_Free(e->inverted.child);
+      break;
+    case RSExpr_Function:
+      RSArgList_Free(e->func.args);
+      break;
+    default:
+      return;
+  }
+  e->t = RSExpr_Literal;
+  e->literal = RSValue_NewNumber(n);
+  e->numeric = numLiteral;
+}
+
+/* Compile `e` and its children. Returns true if `e` reads no property */
+static bool compileExpr(RSExpr *e) {
+  bool constant = true;
+  e->numeric = NULL;
+  switch (e->t) {
+    case RSExpr_Literal:
+      if (RSValue_IsNumber(RSValue_Dereference(e->literal))) {
+        e->numeric = numLiteral;
+      }
+      return true;
+    case RSExpr_Property: {
+      // Values of the other schema fields are strings, or arrays and maps of JSON documents
+      const RLookupKey *key = e->property.lookupObj;
+      const uint32_t flags = key ? RLookupKey_GetFlags(key) : 0;
+      if (key && (!(flags & RLOOKUP_F_SCHEMASRC) || (flags & RLOOKUP_F_NUMERIC))) {
+        e->numeric = numProperty;
+      }
+      return false;
+    }
+    case RSExpr_Op:
+      constant &= compileExpr(e->op.left);
+      constant &= compileExpr(e->op.right);
+      if (e->op.left->numeric && e->op.right->numeric) {
+        e->numeric = numericOp(e->op.op);
+      }
+      break;
+    case RSExpr_Predicate:
+      constant &= compileExpr(e->pred.left);
+      constant &= compileExpr(e->pred.right);
+      if (e->pred.left->numeric && e->pred.right->numeric) {
+        e->numeric = numericPredicate(e->pred.cond);
+      }
+      break;
+    case RSExpr_Inverted:
+      constant &= compileExpr(e->inverted.child);
+      if (e->inverted.child->numeric) {
+        e->numeric = numNot;
+      }
+      break;
+    case RSExpr_Function:
+      for (size_t ii = 0; ii < e->func.args->len; ii++) {
+        constant &= compileExpr(e->func.args->args[ii]);
+      }
+      // Only functions with a numeric kernel are known not to read the result itself
+      if (!e->func.Numeric) {
+        return false;
+      }
+      if (e->func.args->args[0]->numeric) {
+        e->numeric = numFunction;
+      }
+      break;
+  }
+  if (constant && e->numeric) {
+    foldConstant(e);
+  }
+  return constant;
+}
+
+void ExprAST_Compile(RSExpr *root) {
+  compileExpr(root);
+}
+
 int ExprAST_GetLookupKeys(RSExpr *expr, RLookup *lookup, QueryError *err) {
 #define RECURSE(v)                                                                                 \
   if (!v) {                                                                                        \
@@ -468,6 +688,15 @@ typedef struct RPEvaluator {
   RSValue *val;
   const RLookupKey *outkey;
   int isFilter;
+
+  // Batch mode, see rpevalNext_init
+  ExprBatch *batch;
+  SearchResult *buffered;  // EXPR_BATCH_SIZE results read from upstream
+  double *out;             // The values of the expression for the buffered results..
+  uint8_t *valid;          // ..and whether they were computed, see ExprBatch_Eval
+  size_t nbuffered;
+  size_t nyielded;
+  int pendingRc;           // What upstream returned after the buffered results
 } RPEvaluator;
 
 #define RESULT_EVAL_ERR RS_RESULT_MAX + 1
@@ -529,18 +758,145 @@ static int rpevalNext_filter(ResultProcessor *rp, SearchResult *r) {
   return rc;
 }
 
+/* Read the next batch of results from upstream, and evaluate the expression over them */
+static void rpevalFill(RPEvaluator *pc) {
+  ResultProcessor *upstream = pc->base.upstream;
+  size_t n = 0;
+  int rc;
+  while (n < EXPR_BATCH_SIZE && (rc = upstream->Next(upstream, &pc->buffered[n])) == RS_RESULT_OK) {
+    // The result outlives the next read of upstream
+    SearchResult_BufferIndexResult(&pc->base, &pc->buffered[n]);
+    ++n;
+  }
+  if (n < EXPR_BATCH_SIZE) {
+    SearchResult_Clear(&pc->buffered[n]);
+    pc->pendingRc = rc;
+  }
+  pc->nbuffered = n;
+  pc->nyielded = 0;
+  ExprBatch_Eval(pc->batch, pc->buffered, n, pc->out, pc->valid);
+}
+
+/* Yield the buffered results one by one. The results whose value was not computed by the batch
+ * go through the row evaluator, which reports their errors in order */
+static int rpevalNext_batched(ResultProcessor *rp, SearchResult *r) {
+  RPEvaluator *pc = (RPEvaluator *)rp;
+  while (true) {
+    if (pc->nyielded == pc->nbuffered) {
+      if (pc->pendingRc != RS_RESULT_OK) {
+        // Paused or timed out results may be read again
+        int rc = pc->pendingRc;
+        pc->pendingRc = RS_RESULT_OK;
+        return rc;
+      }
+      rpevalFill(pc);
+      continue;
+    }
+
+    const size_t idx = pc->nyielded++;
+    SearchResult_Override(r, &pc->buffered[idx]);
+    pc->buffered[idx] = SearchResult_New();
+
+    int keep;
+    if (pc->valid[idx]) {
+      if (!pc->isFilter) {
+        RLookup_WriteOwnKey(pc->outkey, SearchResult_GetRowDataMut(r), RSValue_NewNumber(pc->out[idx]));
+        return RS_RESULT_OK;
+      }
+      keep = pc->out[idx] != 0;
+    } else {
+      pc->eval.res = r;
+      pc->eval.srcrow = SearchResult_GetRowData(r);
+      pc->eval.err = pc->base.parent->err;
+      if (!pc->val) {
+        pc->val = RSValue_NewUndefined();
+      }
+      if (ExprEval_Eval(&pc->eval, pc->val) != EXPR_EVAL_OK) {
+        return RS_RESULT_ERROR;
+      }
+      if (!pc->isFilter) {
+        RLookup_WriteOwnKey(pc->outkey, SearchResult_GetRowDataMut(r), pc->val);
+        pc->val = NULL;
+        return RS_RESULT_OK;
+      }
+      keep = RSValue_BoolTest(pc->val);
+      RSValue_Clear(pc->val);
+    }
+
+    if (keep) {
+      return RS_RESULT_OK;
+    }
+    RS_ASSERT(rp->parent->totalResults > 0);
+    rp->parent->totalResults--;
+    SearchResult_Clear(r);
+  }
+}
+
+/* Does the chain downstream of the evaluator read everything anyway? Reading ahead of a pager
+ * that stops early would do wasted work and change the number of results counted */
+static bool rpevalDownstreamDepletes(const RPEvaluator *pc) {
+  bool depletes = false;
+  for (const ResultProcessor *rp = pc->base.parent->endProc; rp != &pc->base; rp = rp->upstream) {
+    if (!rp || rp->type >= RP_MAX) {
+      return false;  // Not a plain chain, or debug processors counting reads
+    }
+    switch (rp->type) {
+      case RP_COUNTER:
+      case RP_SORTER:
+      case RP_GROUP:
+      case RP_SAFE_DEPLETER:
+      case RP_DEPLETER:
+        depletes = true;
+        break;
+      case RP_PAGER_LIMITER:
+        depletes = false;
+        break;
+      default:
+        break;
+    }
+  }
+  return depletes;
+}
+
+/* First Next: the chain and the lookup keys of the expression are complete by now. Evaluate in
+ * batches if the expression is numeric and everything read ahead is consumed */
+static int rpevalNext_init(ResultProcessor *rp, SearchResult *r) {
+  RPEvaluator *pc = (RPEvaluator *)rp;
+  rp->Next = pc->isFilter ? rpevalNext_filter : rpevalNext_project;
+  if (rpevalDownstreamDepletes(pc) && (pc->batch = ExprBatch_Compile(pc->eval.root))) {
+    pc->buffered = rm_malloc(EXPR_BATCH_SIZE * sizeof(*pc->buffered));
+    for (size_t ii = 0; ii < EXPR_BATCH_SIZE; ++ii) {
+      pc->buffered[ii] = SearchResult_New();
+    }
+    pc->out = rm_malloc(EXPR_BATCH_SIZE * sizeof(*pc->out));
+    pc->valid = rm_malloc(EXPR_BATCH_SIZE * sizeof(*pc->valid));
+    pc->pendingRc = RS_RESULT_OK;
+    rp->Next = rpevalNext_batched;
+  }
+  return rp->Next(rp, r);
+}
+
 static void rpevalFree(ResultProcessor *rp) {
   RPEvaluator *ee = (RPEvaluator *)rp;
   if (ee->val) {
     RSValue_DecrRef(ee->val);
   }
+  if (ee->batch) {
+    for (size_t ii = 0; ii < EXPR_BATCH_SIZE; ++ii) {
+      SearchResult_Destroy(&ee->buffered[ii]);
+    }
+    rm_free(ee->buffered);
+    rm_free(ee->out);
+    rm_free(ee->valid);
+    ExprBatch_Free(ee->batch);
+  }
   BlkAlloc_FreeAll(&ee->eval.stralloc, NULL, NULL, 0);
   rm_free(ee);
 }
 static ResultProcessor *RPEvaluator_NewCommon(RSExpr *ast, const RLookup *lookup,
                                               const RLookupKey *dstkey, int isFilter) {
   RPEvaluator *rp = rm_calloc(1, sizeof(*rp));
-  rp->base.Next = isFilter ? rpevalNext_filter : rpevalNext_project;
+  rp->base.Next = rpevalNext_init;
   rp->base.Free = rpevalFree;
   rp->base.type = isFilter ? RP_FILTER : RP_PROJECTOR;
   rp->eval.mode = EVAL_MODE_QUERY;
@@ -95,6 +95,7 @@ typedef struct {
   const char *name;
   RSArgList *args;
   RSFunction Call;
+  RSNumericFunction Numeric;  // NULL if the function has no numeric kernel
 } RSFunctionExpr;
 
 typedef struct {
@@ -102,6 +103,12 @@ typedef struct {
   const RLookupKey *lookupObj;
 } RSLookupExpr;
 
+/**
+ * Evaluate the expression `e` to a number, without creating values. Returns false if some
+ * value is missing or is not a number, in which case the expression is evaluated generically.
+ */
+typedef bool (*RSExprNumeric)(struct ExprEval *eval, const struct RSExpr *e, double *out);
+
 typedef struct RSExpr {
   RSExprType t;
   union {
@@ -112,6 +119,8 @@ typedef struct RSExpr {
     RSLookupExpr property;
     RSInverted inverted;
   };
+  // Set by ExprAST_Compile if the expression is expected to evaluate to a number
+  RSExprNumeric numeric;
 } RSExpr;
 
 /**
@@ -173,6 +182,14 @@ int EvalCtx_EvalExprStr(EvalCtx *r, const HiddenString *exprstr);
  *  the error.
  */
 int ExprAST_GetLookupKeys(RSExpr *root, RLookup *lookup, QueryError *err);
+
+/**
+ * Prepare an expression whose lookup keys were resolved for the evaluation of many rows.
+ * Numeric sub-expressions without properties are replaced by their value. Sub-expressions
+ * expected to compute a number, given the types of the schema fields they read, get a numeric
+ * evaluation function specialized for each node, tried before the generic evaluation.
+ */
+void ExprAST_Compile(RSExpr *root);
 int ExprEval_Eval(ExprEval *evaluator, RSValue *result);
 
 void ExprAST_Free(RSExpr *expr);
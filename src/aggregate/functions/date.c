@@ -84,191 +84,110 @@ static time_t fast_timegm(const struct tm *ltm) {
   return (days * (24 * 60 * 60)) + (ltm->tm_hour * (60 * 60)) + (ltm->tm_min * 60) + ltm->tm_sec;
 }
 
-static int func_hour(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
-  struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
+/* The date functions of a timestamp. Negative timestamps are rejected by the callers */
 
+static double date_hour(double d) {
+  time_t ts = (time_t)d;
+  struct tm tmm = {0};
   gmtime_r(&ts, &tmm);
   tmm.tm_sec = 0;
   tmm.tm_min = 0;
-  ts = fast_timegm(&tmm);
-  RSValue_SetNumber(result, (double)ts);
-
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)fast_timegm(&tmm);
 }
 
-static int func_minute(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  RSValue_SetNumber(result, floor(d - fmod(d, 60)));
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+static double date_minute(double d) {
+  return floor(d - fmod(d, 60));
 }
 
 /* Round timestamp to its day start */
-static int func_day(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_day(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
-
   gmtime_r(&ts, &tmm);
   tmm.tm_sec = 0;
   tmm.tm_hour = 0;
   tmm.tm_min = 0;
-  ts = fast_timegm(&tmm);
-  RSValue_SetNumber(result, (double)ts);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)fast_timegm(&tmm);
 }
 
-static int func_dayofmonth(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_dayofmonth(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
   gmtime_r(&ts, &tmm);
-
-  RSValue_SetNumber(result, (double)tmm.tm_mday);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)tmm.tm_mday;
 }
 
-static int func_dayofweek(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_dayofweek(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
   gmtime_r(&ts, &tmm);
-
-  RSValue_SetNumber(result, (double)tmm.tm_wday);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)tmm.tm_wday;
 }
 
-static int func_dayofyear(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_dayofyear(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
   gmtime_r(&ts, &tmm);
-
-  RSValue_SetNumber(result, (double)tmm.tm_yday);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)tmm.tm_yday;
 }
 
-static int func_year(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_year(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
   gmtime_r(&ts, &tmm);
-
-  RSValue_SetNumber(result, (double)tmm.tm_year + 1900);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)tmm.tm_year + 1900;
 }
 
 /* Round a timestamp to the beginning of the month */
-static int func_month(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_month(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
-
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
-  }
-  ts = (time_t)d;
   gmtime_r(&ts, &tmm);
   tmm.tm_sec = 0;
   tmm.tm_hour = 0;
   tmm.tm_min = 0;
   tmm.tm_yday -= tmm.tm_mday - 1; // set to first day of month
-  ts = fast_timegm(&tmm);
-  RSValue_SetNumber(result, (double)ts);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
-
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
+  return (double)fast_timegm(&tmm);
 }
 
-static int func_monthofyear(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
-  double d = 0.0;
-  time_t ts = 0;
+static double date_monthofyear(double d) {
+  time_t ts = (time_t)d;
   struct tm tmm = {0};
+  gmtime_r(&ts, &tmm);
+  return (double)tmm.tm_mon;
+}
 
-  if (!RSValue_ToNumber(argv[0], &d) || d < 0) {
-    goto err;
+/* Template for the row function and the numeric kernel of a date function.
+ * On runtime error (not a number, negative timestamp) we just set the result to null */
+#define DATE_FUNCTION(f)                                                                 \
+  static int func_##f(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {     \
+    double d = 0.0;                                                                      \
+    if (!RSValue_ToNumber(argv[0], &d) || d < 0) {                                       \
+      RSValue_MakeReference(result, RSValue_NullStatic());                               \
+      return EXPR_EVAL_OK;                                                               \
+    }                                                                                    \
+    RSValue_SetNumber(result, date_##f(d));                                              \
+    return EXPR_EVAL_OK;                                                                 \
+  }                                                                                      \
+  static void kernel_##f(double *vals, uint8_t *valid, size_t n) {                       \
+    for (size_t ii = 0; ii < n; ++ii) {                                                  \
+      if (vals[ii] < 0) {                                                                \
+        valid[ii] = 0;                                                                   \
+      } else {                                                                           \
+        vals[ii] = date_##f(vals[ii]);                                                   \
+      }                                                                                  \
+    }                                                                                    \
   }
-  ts = (time_t)d;
-  gmtime_r(&ts, &tmm);
-  RSValue_SetNumber(result, (double)tmm.tm_mon);
-  return EXPR_EVAL_OK;
-err:
-  // on runtime error (bad formatting, etc) we just set the result to null
 
-  RSValue_MakeReference(result, RSValue_NullStatic());
-  return EXPR_EVAL_OK;
-}
+DATE_FUNCTION(hour);
+DATE_FUNCTION(minute);
+DATE_FUNCTION(day);
+DATE_FUNCTION(dayofmonth);
+DATE_FUNCTION(dayofweek);
+DATE_FUNCTION(dayofyear);
+DATE_FUNCTION(year);
+DATE_FUNCTION(month);
+DATE_FUNCTION(monthofyear);
 
 static int parseTime(ExprEval *ctx, RSValue **argv, size_t argc, RSValue *result) {
   const char *val;
@@ -299,14 +218,14 @@ err:
 void RegisterDateFunctions() {
   RSFunctionRegistry_RegisterFunction("timefmt", timeFormat, RSValueType_String, 1, 2);
   RSFunctionRegistry_RegisterFunction("parsetime", parseTime, RSValueType_Number, 2, 2);
-  RSFunctionRegistry_RegisterFunction("hour", func_hour, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("minute", func_minute, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("day", func_day, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("month", func_month, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("monthofyear", func_monthofyear, RSValueType_Number, 1, 1);
-
-  RSFunctionRegistry_RegisterFunction("year", func_year, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("dayofmonth", func_dayofmonth, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("dayofweek", func_dayofweek, RSValueType_Number, 1, 1);
-  RSFunctionRegistry_RegisterFunction("dayofyear", func_dayofyear, RSValueType_Number, 1, 1);
+  RSFunctionRegistry_RegisterNumericFunction("hour", func_hour, kernel_hour);
+  RSFunctionRegistry_RegisterNumericFunction("minute", func_minute, kernel_minute);
+  RSFunctionRegistry_RegisterNumericFunction("day", func_day, kernel_day);
+  RSFunctionRegistry_RegisterNumericFunction("month", func_month, kernel_month);
+  RSFunctionRegistry_RegisterNumericFunction("monthofyear", func_monthofyear, kernel_monthofyear);
+
+  RSFunctionRegistry_RegisterNumericFunction("year", func_year, kernel_year);
+  RSFunctionRegistry_RegisterNumericFunction("dayofmonth", func_dayofmonth, kernel_dayofmonth);
+  RSFunctionRegistry_RegisterNumericFunction("dayofweek", func_dayofweek, kernel_dayofweek);
+  RSFunctionRegistry_RegisterNumericFunction("dayofyear", func_dayofyear, kernel_dayofyear);
 }
@@ -34,6 +34,7 @@ int RSFunctionRegistry_RegisterFunction(const char *name, RSFunction f, RSValueT
     functions_g.funcs = rm_realloc(functions_g.funcs, functions_g.cap * sizeof(*functions_g.funcs));
   }
   functions_g.funcs[functions_g.len].f = f;
+  functions_g.funcs[functions_g.len].numeric = NULL;
   functions_g.funcs[functions_g.len].name = name;
   functions_g.funcs[functions_g.len].retType = retType;
   functions_g.funcs[functions_g.len].minArgs = minArgs;
@@ -42,6 +43,12 @@ int RSFunctionRegistry_RegisterFunction(const char *name, RSFunction f, RSValueT
   return 1;
 }
 
+int RSFunctionRegistry_RegisterNumericFunction(const char *name, RSFunction f, RSNumericFunction numeric) {
+  RSFunctionRegistry_RegisterFunction(name, f, RSValueType_Number, 1, 1);
+  functions_g.funcs[functions_g.len - 1].numeric = numeric;
+  return 1;
+}
+
 void RegisterAllFunctions() {
   RegisterMathFunctions();
   RegisterDateFunctions();
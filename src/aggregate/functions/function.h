@@ -55,8 +55,17 @@ struct ExprEval;
  */
 typedef int (*RSFunction)(struct ExprEval *e, RSValue **args, size_t nargs, RSValue *result);
 
+/**
+ * Numeric kernel of a function of a single number, used by the batch evaluator.
+ * Replaces each of the `n` values of the column by the result of the function, and clears the
+ * `valid` flag of the values for which the function does not return a number. The row function
+ * is then called for those values.
+ */
+typedef void (*RSNumericFunction)(double *vals, uint8_t *valid, size_t n);
+
 typedef struct RSFunctionInfo {
   RSFunction f;
+  RSNumericFunction numeric;  // Optional
   const char *name;
   RSValueType retType;
   uint8_t minArgs;
@@ -75,6 +84,9 @@ RSFunctionInfo *RSFunctionRegistry_Get(const char *name, size_t len);
 
 int RSFunctionRegistry_RegisterFunction(const char *name, RSFunction f, RSValueType retType, uint8_t minArgs, uint16_t maxArgs);
 
+/* Register a function of a single number returning a number, with its numeric kernel */
+int RSFunctionRegistry_RegisterNumericFunction(const char *name, RSFunction f, RSNumericFunction numeric);
+
 void RegisterMathFunctions();
 void RegisterStringFunctions();
 void RegisterDateFunctions();
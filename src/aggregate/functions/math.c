@@ -9,6 +9,7 @@
 #include <aggregate/expr/expression.h>
 #include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "function.h"
 #include "rlookup_ffi.h"
@@ -24,6 +25,11 @@
     }                                                                                            \
     RSValue_SetNumber(result, f(d));                                                             \
     return EXPR_EVAL_OK;                                                                         \
+  }                                                                                              \
+  static void mathkernel_##f(double *vals, uint8_t *valid, size_t n) {                           \
+    for (size_t ii = 0; ii < n; ++ii) {                                                          \
+      vals[ii] = f(vals[ii]);                                                                    \
+    }                                                                                            \
   }
 
 NUMERIC_SIMPLE_FUNCTION(log);
@@ -35,7 +41,7 @@ NUMERIC_SIMPLE_FUNCTION(log2);
 NUMERIC_SIMPLE_FUNCTION(exp);
 
 #define REGISTER_MATHFUNC(name, f) \
-  RSFunctionRegistry_RegisterFunction(name, mathfunc_##f, RSValueType_Number, 1, 1);
+  RSFunctionRegistry_RegisterNumericFunction(name, mathfunc_##f, mathkernel_##f);
 
 void RegisterMathFunctions() {
   REGISTER_MATHFUNC("log", log);
@@ -9,6 +9,8 @@
 #include <result_processor.h>
 #include <util/block_alloc.h>
 #include <util/khash.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -24,6 +26,7 @@
 #include "rqe_core.h"
 #include "search_result.h"
 #include "util/arr/arr.h"
+#include "util/workers.h"
 
 /**
  * A group represents the allocated context of all reducers in a group, and the
@@ -55,21 +58,61 @@ typedef struct {
 static const int khid = 33;
 KHASH_MAP_INIT_INT64(khid, Group *);
 
-#define GROUPER_NREDUCERS(g) (array_len((g)->reducers))
+#define GROUPER_NREDUCERS(g) (array_len((g)->partitions[0].reducers))
 #define GROUP_BYTESIZE(parent) (sizeof(Group) + (sizeof(void *) * GROUPER_NREDUCERS(parent)))
 #define GROUPS_PER_BLOCK 1024
 #define GROUPER_NSRCKEYS(g) ((g)->nkeys)
 
-typedef struct Grouper {
-  // Result processor base, for use in row processing
-  ResultProcessor base;
+// Rows read from upstream before being grouped on the worker threads, when grouping in parallel
+#define GROUPER_WAVE_SIZE 4096
+// Passed to extractGroups to group a row right away, rather than bucketing it in its partitions
+#define GROUPER_NO_WAVE_ROW SIZE_MAX
 
+// A row of the wave, bucketed in the partition of one of its groups
+typedef struct {
+  size_t row;
+  uint64_t hval;
+} WaveRow;
+
+/**
+ * The groups whose key hashes to a partition. A partition is only ever accessed by one thread at
+ * a time, so every partition has its own instances of the reducers: their allocators are not
+ * thread-safe.
+ */
+typedef struct {
   // Map of group_name => `Group` structure
   khash_t(khid) * groups;
 
   // Backing store for the groups themselves
   BlkAlloc groupsAlloc;
 
+  // array of reducers
+  Reducer **reducers;
+
+  // The rows of the wave to group in this partition, hashed by the query thread, and the
+  // `nkeys` group values of each. A row is bucketed once per group it falls in
+  arrayof(WaveRow) waveRows;
+  arrayof(const RSValue *) waveVals;
+
+  // Result of grouping the rows of the last wave in this partition
+  int rc;
+} GroupPartition;
+
+typedef struct Grouper {
+  // Result processor base, for use in row processing
+  ResultProcessor base;
+
+  // Groups by partition of their key. There is a single partition unless grouping in parallel
+  GroupPartition *partitions;
+  size_t numPartitions;
+
+  // Number of groups in all the partitions
+  atomic_size_t numGroups;
+
+  // Rows read from upstream and not grouped yet, when grouping in parallel
+  SearchResult *rows;
+  size_t nrows;
+
   /**
    * Keys to group by. Both srckeys and dstkeys are used because different lookups
    * are employed. The srckeys are the lookup keys for the properties as they
@@ -80,12 +123,10 @@ typedef struct Grouper {
   const RLookupKey **dstkeys;
   size_t nkeys;
 
-  // array of reducers
-  Reducer **reducers;
-
   GroupByLimits groupByLimits;
 
   // Used for maintaining state when yielding groups
+  size_t iterPartition;
   khiter_t iter;
 } Grouper;
 
@@ -103,15 +144,16 @@ static void setAggregateGroupLimitError(const Grouper *g) {
  *
  * These will be placed in the output row.
  */
-static Group *createGroup(Grouper *g, const RSValue **groupvals, size_t ngrpvals) {
-  size_t numReducers = array_len(g->reducers);
+static Group *createGroup(Grouper *g, GroupPartition *part, const RSValue **groupvals,
+                          size_t ngrpvals) {
+  size_t numReducers = array_len(part->reducers);
   size_t elemSize = GROUP_BYTESIZE(g);
-  Group *group = BlkAlloc_Alloc(&g->groupsAlloc, elemSize, GROUPS_PER_BLOCK * elemSize);
+  Group *group = BlkAlloc_Alloc(&part->groupsAlloc, elemSize, GROUPS_PER_BLOCK * elemSize);
   memset(group, 0, elemSize);
   group->rowdata = RLookupRow_New();
 
   for (size_t ii = 0; ii < numReducers; ++ii) {
-    group->accumdata[ii] = g->reducers[ii]->NewInstance(g->reducers[ii]);
+    group->accumdata[ii] = part->reducers[ii]->NewInstance(part->reducers[ii]);
   }
 
   /** Initialize the row data! */
@@ -135,16 +177,22 @@ static void writeGroupValues(const Grouper *g, const Group *gr, SearchResult *r)
 static int Grouper_rpYield(ResultProcessor *base, SearchResult *r) {
   Grouper *g = (Grouper *)base;
 
-  while (g->iter != kh_end(g->groups)) {
-    if (!kh_exist(g->groups, g->iter)) {
+  while (g->iterPartition < g->numPartitions) {
+    GroupPartition *part = &g->partitions[g->iterPartition];
+    if (g->iter == kh_end(part->groups)) {
+      g->iterPartition++;
+      g->iter = kh_begin(khid);
+      continue;
+    }
+    if (!kh_exist(part->groups, g->iter)) {
       g->iter++;
       continue;
     }
 
-    Group *gr = kh_value(g->groups, g->iter);
+    Group *gr = kh_value(part->groups, g->iter);
     writeGroupValues(g, gr, r);
     for (size_t ii = 0; ii < GROUPER_NREDUCERS(g); ++ii) {
-      Reducer *rd = g->reducers[ii];
+      Reducer *rd = part->reducers[ii];
       RSValue *v = rd->Finalize(rd, gr->accumdata[ii]);
       RLookup_WriteOwnKey(rd->dstkey, SearchResult_GetRowDataMut(r), v);
     }
@@ -155,10 +203,10 @@ static int Grouper_rpYield(ResultProcessor *base, SearchResult *r) {
   return RS_RESULT_EOF;
 }
 
-static void invokeReducers(Grouper *g, Group *gr, RLookupRow *srcrow, t_docId docId) {
-  size_t nreducers = GROUPER_NREDUCERS(g);
+static void invokeReducers(GroupPartition *part, Group *gr, RLookupRow *srcrow, t_docId docId) {
+  size_t nreducers = array_len(part->reducers);
   for (size_t ii = 0; ii < nreducers; ii++) {
-    Reducer *r = g->reducers[ii];
+    Reducer *r = part->reducers[ii];
     if (r->AddWithDocId) {
       r->AddWithDocId(r, gr->accumdata[ii], srcrow, docId);
     } else {
@@ -167,11 +215,37 @@ static void invokeReducers(Grouper *g, Group *gr, RLookupRow *srcrow, t_docId do
   }
 }
 
+/* Send the row to its group in the partition, created if new. Fails if the groups limit is
+ * exceeded */
+static int addToGroup(Grouper *g, GroupPartition *part, uint64_t hval, const RSValue **groupvals,
+                      RLookupRow *res, t_docId docId) {
+  Group *group = NULL;
+
+  // Get or create the group
+  khiter_t k = kh_get(khid, part->groups, hval);  // first have to get ieter
+  if (k == kh_end(part->groups)) {                // k will be equal to kh_end if key not present
+    if (atomic_fetch_add_explicit(&g->numGroups, 1, memory_order_relaxed) >=
+        g->groupByLimits.maxGroups) {
+      return RS_RESULT_ERROR;
+    }
+    group = createGroup(g, part, groupvals, GROUPER_NSRCKEYS(g));
+    kh_set(khid, part->groups, hval, group);
+  } else {
+    group = kh_value(part->groups, k);
+  }
+
+  // send the result to the group and its reducers
+  invokeReducers(part, group, res, docId);
+  return RS_RESULT_OK;
+}
+
 /**
  * This function recursively descends into each value within a group and invokes
  * Add() for each cartesian product of the current row.
  *
  * @param g the grouper
+ * @param row the index of the row in the wave, to bucket it in the partitions of its groups
+ *  rather than adding it to them, or GROUPER_NO_WAVE_ROW
  * @param xarr the array of 'x' values - i.e. the raw results received from the
  *  upstream result processor. The number of results can be found via
  *  the `GROUPER_NSRCKEYS(g)` macro
@@ -181,28 +255,22 @@ static void invokeReducers(Grouper *g, Group *gr, RLookupRow *srcrow, t_docId do
  *  are not hashed together.
  * @param res the row is passed to each reducer
  * @param rowExpansion the cartesian product size accumulated for the current row
+ * @return RS_RESULT_ERROR if the groups limit is exceeded
  */
-static int extractGroups(Grouper *g, const RSValue **xarr, size_t xpos, size_t xlen,
-                         uint64_t hval, RLookupRow *res, size_t rowExpansion, t_docId docId) {
+static int extractGroups(Grouper *g, size_t row, const RSValue **xarr, size_t xpos,
+                         size_t xlen, uint64_t hval, RLookupRow *res, size_t rowExpansion,
+                         t_docId docId) {
   // end of the line - create/add to group
   if (xpos == xlen) {
-    Group *group = NULL;
-
-    // Get or create the group
-    khiter_t k = kh_get(khid, g->groups, hval);  // first have to get ieter
-    if (k == kh_end(g->groups)) {                // k will be equal to kh_end if key not present
-      if (kh_size(g->groups) >= g->groupByLimits.maxGroups) {
-        setAggregateGroupLimitError(g);
-        return RS_RESULT_ERROR;
-      }
-      group = createGroup(g, xarr, xlen);
-      kh_set(khid, g->groups, hval, group);
-    } else {
-      group = kh_value(g->groups, k);
+    // The high bits of the hash, as khash buckets the groups by the low ones
+    size_t idx = g->numPartitions == 1 ? 0 : (hval >> 32) % g->numPartitions;
+    GroupPartition *part = &g->partitions[idx];
+    if (row == GROUPER_NO_WAVE_ROW) {
+      return addToGroup(g, part, hval, xarr, res, docId);
     }
-
-    // send the result to the group and its reducers
-    invokeReducers(g, group, res, docId);
+    WaveRow waveRow = {.row = row, .hval = hval};
+    array_append(part->waveRows, waveRow);
+    part->waveVals = array_ensure_append_n(part->waveVals, xarr, xlen);
     return RS_RESULT_OK;
   }
 
@@ -211,13 +279,13 @@ static int extractGroups(Grouper *g, const RSValue **xarr, size_t xpos, size_t x
   // regular value - just move one step -- increment XPOS
   if (!RSValue_IsArray(v)) {
     hval = RSValue_Hash(v, hval);
-    return extractGroups(g, xarr, xpos + 1, xlen, hval, res, rowExpansion, docId);
+    return extractGroups(g, row, xarr, xpos + 1, xlen, hval, res, rowExpansion, docId);
   } else if (RSValue_ArrayLen(v) == 0) {
     // Empty array - hash as null
     hval = RSValue_Hash(RSValue_NullStatic(), hval);
     const RSValue *array = xarr[xpos];
     xarr[xpos] = RSValue_NullStatic();
-    int rc = extractGroups(g, xarr, xpos + 1, xlen, hval, res, rowExpansion, docId);
+    int rc = extractGroups(g, row, xarr, xpos + 1, xlen, hval, res, rowExpansion, docId);
     xarr[xpos] = array;
     return rc;
   } else {
@@ -227,7 +295,6 @@ static int extractGroups(Grouper *g, const RSValue **xarr, size_t xpos, size_t x
     size_t len = RSValue_ArrayLen(v);
     if (len > 1) {
       if (rowExpansion > g->groupByLimits.maxGroups / len) {
-        setAggregateGroupLimitError(g);
         return RS_RESULT_ERROR;
       }
       rowExpansion *= len;
@@ -237,7 +304,7 @@ static int extractGroups(Grouper *g, const RSValue **xarr, size_t xpos, size_t x
       // hash the element, even if it's an array
       uint64_t hh = RSValue_Hash(elem, hval);
       xarr[xpos] = elem;
-      int rc = extractGroups(g, xarr, xpos + 1, xlen, hh, res, rowExpansion, docId);
+      int rc = extractGroups(g, row, xarr, xpos + 1, xlen, hh, res, rowExpansion, docId);
       if (rc != RS_RESULT_OK) {
         xarr[xpos] = array;
         return rc;
@@ -248,7 +315,7 @@ static int extractGroups(Grouper *g, const RSValue **xarr, size_t xpos, size_t x
   }
 }
 
-static int invokeGroupReducers(Grouper *g, RLookupRow *srcrow, t_docId docId) {
+static int invokeGroupReducers(Grouper *g, size_t row, RLookupRow *srcrow, t_docId docId) {
   uint64_t hval = 0;
   size_t nkeys = GROUPER_NSRCKEYS(g);
   const RSValue *groupvals[nkeys];
@@ -261,7 +328,20 @@ static int invokeGroupReducers(Grouper *g, RLookupRow *srcrow, t_docId docId) {
     }
     groupvals[ii] = v;
   }
-  return extractGroups(g, groupvals, 0, nkeys, hval, srcrow, 1, docId);
+  return extractGroups(g, row, groupvals, 0, nkeys, hval, srcrow, 1, docId);
+}
+
+/* Called once all the rows were accumulated: yield the groups from now on */
+static int Grouper_StartYield(Grouper *g, SearchResult *res) {
+  ResultProcessor *base = &g->base;
+  base->Next = Grouper_rpYield;
+  base->parent->totalResults = atomic_load_explicit(&g->numGroups, memory_order_relaxed);
+  // Group count doesn't include rows the loader dropped upstream; clear the skip
+  // correction so it isn't subtracted from it at reply time.
+  base->parent->skippedResults = 0;
+  g->iterPartition = 0;
+  g->iter = kh_begin(khid);
+  return Grouper_rpYield(base, res);
 }
 
 static int Grouper_rpAccum(ResultProcessor *base, SearchResult *res) {
@@ -271,21 +351,188 @@ static int Grouper_rpAccum(ResultProcessor *base, SearchResult *res) {
   int rc;
 
   while ((rc = base->upstream->Next(base->upstream, res)) == RS_RESULT_OK) {
-    rc = invokeGroupReducers(g, SearchResult_GetRowDataMut(res), SearchResult_GetDocId(res));
+    rc = invokeGroupReducers(g, GROUPER_NO_WAVE_ROW, SearchResult_GetRowDataMut(res),
+                             SearchResult_GetDocId(res));
     SearchResult_Clear(res);
     if (rc != RS_RESULT_OK) {
+      setAggregateGroupLimitError(g);
       break;
     }
   }
   base->parent->resultLimit = chunkLimit; // restore the limit
   if (rc == RS_RESULT_EOF) {
-    base->Next = Grouper_rpYield;
-    base->parent->totalResults = kh_size(g->groups);
-    // Group count doesn't include rows the loader dropped upstream; clear the skip
-    // correction so it isn't subtracted from it at reply time.
-    base->parent->skippedResults = 0;
-    g->iter = kh_begin(khid);
-    return Grouper_rpYield(base, res);
+    return Grouper_StartYield(g, res);
+  } else {
+    return rc;
+  }
+}
+
+/* Group the buffered rows right away, or bucket them in the partitions of their groups */
+static int extractRows(Grouper *g, bool bucket) {
+  for (size_t ii = 0; ii < g->nrows; ++ii) {
+    SearchResult *row = &g->rows[ii];
+    int rc = invokeGroupReducers(g, bucket ? ii : GROUPER_NO_WAVE_ROW,
+                                 SearchResult_GetRowDataMut(row), SearchResult_GetDocId(row));
+    if (rc != RS_RESULT_OK) {
+      return rc;
+    }
+  }
+  return RS_RESULT_OK;
+}
+
+/* Group the buffered rows bucketed in the partition */
+static int groupRows(Grouper *g, size_t partition) {
+  GroupPartition *part = &g->partitions[partition];
+  const size_t nkeys = GROUPER_NSRCKEYS(g);
+  for (size_t ii = 0; ii < array_len(part->waveRows); ++ii) {
+    SearchResult *row = &g->rows[part->waveRows[ii].row];
+    int rc = addToGroup(g, part, part->waveRows[ii].hval, part->waveVals + ii * nkeys,
+                        SearchResult_GetRowDataMut(row), SearchResult_GetDocId(row));
+    if (rc != RS_RESULT_OK) {
+      return rc;
+    }
+  }
+  return RS_RESULT_OK;
+}
+
+typedef struct GroupWave GroupWave;
+
+typedef struct {
+  GroupWave *wave;
+  Grouper *grouper;
+  size_t partition;
+  atomic_bool claimed;  // Set by the thread grouping the partition
+} GroupJob;
+
+/* The partitions but the first grouping the buffered rows, posted to the workers. The query thread
+ * groups the first partition, then the ones no worker claimed yet, and waits for the others. Held
+ * by the query thread and by every posted job, as a worker may only pick a job up after the wave
+ * is over. */
+struct GroupWave {
+  atomic_size_t refcount;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  size_t numDone;  // Partitions grouped by workers
+  GroupJob jobs[];
+};
+
+static void groupWave_Release(GroupWave *wave) {
+  if (atomic_fetch_sub(&wave->refcount, 1) == 1) {
+    pthread_cond_destroy(&wave->cond);
+    pthread_mutex_destroy(&wave->lock);
+    rm_free(wave);
+  }
+}
+
+static void groupJob_Run(void *arg) {
+  GroupJob *job = arg;
+  GroupWave *wave = job->wave;
+  if (!atomic_exchange(&job->claimed, true)) {
+    Grouper *g = job->grouper;
+    g->partitions[job->partition].rc = groupRows(g, job->partition);
+    pthread_mutex_lock(&wave->lock);
+    wave->numDone++;
+    pthread_cond_signal(&wave->cond);
+    pthread_mutex_unlock(&wave->lock);
+  }
+  groupWave_Release(wave);
+}
+
+/* Group the buffered rows in every partition, in parallel */
+static void groupWave_Run(Grouper *g) {
+  const size_t numJobs = g->numPartitions - 1;
+  GroupWave *wave = rm_calloc(1, sizeof(*wave) + numJobs * sizeof(*wave->jobs));
+  atomic_init(&wave->refcount, 1);
+  pthread_mutex_init(&wave->lock, NULL);
+  pthread_cond_init(&wave->cond, NULL);
+  for (size_t ii = 0; ii < numJobs; ++ii) {
+    GroupJob *job = &wave->jobs[ii];
+    job->wave = wave;
+    job->grouper = g;
+    job->partition = ii + 1;
+    atomic_init(&job->claimed, false);
+    atomic_fetch_add(&wave->refcount, 1);
+    if (workersThreadPool_AddWork(groupJob_Run, job) != 0) {
+      atomic_fetch_sub(&wave->refcount, 1);
+    }
+  }
+
+  g->partitions[0].rc = groupRows(g, 0);
+  size_t numOnWorkers = numJobs;
+  for (size_t ii = 0; ii < numJobs; ++ii) {
+    GroupJob *job = &wave->jobs[ii];
+    if (!atomic_exchange(&job->claimed, true)) {
+      g->partitions[job->partition].rc = groupRows(g, job->partition);
+      numOnWorkers--;
+    }
+  }
+  pthread_mutex_lock(&wave->lock);
+  while (wave->numDone < numOnWorkers) {
+    pthread_cond_wait(&wave->cond, &wave->lock);
+  }
+  pthread_mutex_unlock(&wave->lock);
+  groupWave_Release(wave);
+}
+
+/* Group the buffered rows and release them. A full wave is hashed once on the query thread and
+ * grouped on the worker threads, each partition reducing its own rows. A smaller one - the only one
+ * of a small query, or the last one - is not worth the hand-off. */
+static int flushRows(Grouper *g) {
+  int rc;
+  if (g->nrows == GROUPER_WAVE_SIZE) {
+    rc = extractRows(g, true);
+    if (rc == RS_RESULT_OK) {
+      groupWave_Run(g);
+    }
+    for (size_t ii = 0; ii < g->numPartitions; ++ii) {
+      GroupPartition *part = &g->partitions[ii];
+      if (rc == RS_RESULT_OK && part->rc != RS_RESULT_OK) {
+        rc = part->rc;
+      }
+      array_clear(part->waveRows);
+      array_clear(part->waveVals);
+    }
+  } else {
+    rc = extractRows(g, false);
+  }
+  for (size_t ii = 0; ii < g->nrows; ++ii) {
+    SearchResult_Clear(&g->rows[ii]);
+  }
+  g->nrows = 0;
+  if (rc != RS_RESULT_OK) {
+    setAggregateGroupLimitError(g);
+  }
+  return rc;
+}
+
+/* Next implementation when grouping in parallel: the rows are read in waves, and the groups of
+ * each partition of the group keys are updated by a different thread */
+static int Grouper_rpAccumParallel(ResultProcessor *base, SearchResult *res) {
+  Grouper *g = (Grouper *)base;
+  ResultProcessor *upstream = base->upstream;
+  uint32_t chunkLimit = base->parent->resultLimit;
+  base->parent->resultLimit = UINT32_MAX; // we want to accumulate all the results
+  int rc = RS_RESULT_OK;
+
+  while (rc == RS_RESULT_OK) {
+    while (g->nrows < GROUPER_WAVE_SIZE &&
+           (rc = upstream->Next(upstream, &g->rows[g->nrows])) == RS_RESULT_OK) {
+      // The row outlives the next read of upstream
+      SearchResult_BufferIndexResult(base, &g->rows[g->nrows]);
+      g->nrows++;
+    }
+    if (g->nrows < GROUPER_WAVE_SIZE) {
+      SearchResult_Clear(&g->rows[g->nrows]);
+    }
+    // The rows read before a timeout or a pause are grouped too, as by Grouper_rpAccum
+    int flushrc = flushRows(g);
+    if (flushrc != RS_RESULT_OK) {
+      rc = flushrc;
+    }
+  }
+  base->parent->resultLimit = chunkLimit; // restore the limit
+  if (rc == RS_RESULT_EOF) {
+    return Grouper_StartYield(g, res);
   } else {
     return rc;
   }
@@ -293,33 +540,48 @@ static int Grouper_rpAccum(ResultProcessor *base, SearchResult *res) {
 
 static void cleanCallback(void *ptr, void *arg) {
   Group *group = ptr;
-  Grouper *parent = arg;
+  GroupPartition *part = arg;
   // Call the reducer's FreeInstance
-  for (size_t ii = 0; ii < GROUPER_NREDUCERS(parent); ++ii) {
-    Reducer *rr = parent->reducers[ii];
+  for (size_t ii = 0; ii < array_len(part->reducers); ++ii) {
+    Reducer *rr = part->reducers[ii];
     if (rr->FreeInstance) {
       rr->FreeInstance(rr, group->accumdata[ii]);
     }
   }
 }
 
-static void Grouper_rpFree(ResultProcessor *grrp) {
-  Grouper *g = (Grouper *)grrp;
-  for (khiter_t it = kh_begin(g->groups); it != kh_end(g->groups); ++it) {
-    if (!kh_exist(g->groups, it)) {
+static void groupPartition_Free(Grouper *g, GroupPartition *part) {
+  for (khiter_t it = kh_begin(part->groups); it != kh_end(part->groups); ++it) {
+    if (!kh_exist(part->groups, it)) {
       continue;
     }
-    Group *gr = kh_value(g->groups, it);
+    Group *gr = kh_value(part->groups, it);
     RLookupRow_Reset(&gr->rowdata);
   }
-  kh_destroy(khid, g->groups);
-  BlkAlloc_FreeAll(&g->groupsAlloc, cleanCallback, g, GROUP_BYTESIZE(g));
+  kh_destroy(khid, part->groups);
+  BlkAlloc_FreeAll(&part->groupsAlloc, cleanCallback, part, GROUP_BYTESIZE(g));
 
-  for (size_t i = 0; i < GROUPER_NREDUCERS(g); i++) {
-    g->reducers[i]->Free(g->reducers[i]);
+  for (size_t i = 0; i < array_len(part->reducers); i++) {
+    part->reducers[i]->Free(part->reducers[i]);
   }
-  if (g->reducers) {
-    array_free(g->reducers);
+  if (part->reducers) {
+    array_free(part->reducers);
+  }
+  array_free(part->waveRows);
+  array_free(part->waveVals);
+}
+
+static void Grouper_rpFree(ResultProcessor *grrp) {
+  Grouper *g = (Grouper *)grrp;
+  for (size_t ii = 0; ii < g->numPartitions; ++ii) {
+    groupPartition_Free(g, &g->partitions[ii]);
+  }
+  rm_free(g->partitions);
+  if (g->rows) {
+    for (size_t ii = 0; ii < GROUPER_WAVE_SIZE; ++ii) {
+      SearchResult_Destroy(&g->rows[ii]);
+    }
+    rm_free(g->rows);
   }
   rm_free(g->srckeys);
   rm_free(g->dstkeys);
@@ -333,8 +595,11 @@ void Grouper_Free(Grouper *g) {
 Grouper *Grouper_New(const RLookupKey **srckeys, const RLookupKey **dstkeys, size_t nkeys,
                      GroupByLimits groupByLimits) {
   Grouper *g = rm_calloc(1, sizeof(*g));
-  BlkAlloc_Init(&g->groupsAlloc);
-  g->groups = kh_init(khid);
+  g->numPartitions = 1;
+  g->partitions = rm_calloc(1, sizeof(*g->partitions));
+  BlkAlloc_Init(&g->partitions[0].groupsAlloc);
+  g->partitions[0].groups = kh_init(khid);
+  atomic_init(&g->numGroups, 0);
 
   g->nkeys = nkeys;
   g->groupByLimits = groupByLimits;
@@ -352,11 +617,47 @@ Grouper *Grouper_New(const RLookupKey **srckeys, const RLookupKey **dstkeys, siz
 }
 
 void Grouper_AddReducer(Grouper *g, Reducer *r, RLookupKey *dstkey) {
-  Reducer **rpp = array_ensure_tail(&g->reducers, Reducer *);
+  Reducer **rpp = array_ensure_tail(&g->partitions[0].reducers, Reducer *);
   *rpp = r;
   r->dstkey = dstkey;
 }
 
+void Grouper_SetPartitions(Grouper *g, size_t num) {
+  RS_ASSERT(g->numPartitions == 1 && num > 1);
+  g->partitions = rm_realloc(g->partitions, num * sizeof(*g->partitions));
+  memset(g->partitions + 1, 0, (num - 1) * sizeof(*g->partitions));
+  for (size_t ii = 1; ii < num; ++ii) {
+    BlkAlloc_Init(&g->partitions[ii].groupsAlloc);
+    g->partitions[ii].groups = kh_init(khid);
+  }
+  for (size_t ii = 0; ii < num; ++ii) {
+    g->partitions[ii].waveRows = array_new(WaveRow, GROUPER_WAVE_SIZE / num);
+    g->partitions[ii].waveVals = array_new(const RSValue *, 1);
+  }
+  g->numPartitions = num;
+
+  g->rows = rm_malloc(GROUPER_WAVE_SIZE * sizeof(*g->rows));
+  for (size_t ii = 0; ii < GROUPER_WAVE_SIZE; ++ii) {
+    g->rows[ii] = SearchResult_New();
+  }
+  g->base.Next = Grouper_rpAccumParallel;
+}
+
+void Grouper_AddPartitionReducer(Grouper *g, size_t partition, Reducer *r) {
+  RS_ASSERT(partition > 0 && partition < g->numPartitions);
+  Reducer ***reducers = &g->partitions[partition].reducers;
+  size_t idx = array_len(*reducers);
+  RS_ASSERT(idx < GROUPER_NREDUCERS(g));
+  Reducer **rpp = array_ensure_tail(reducers, Reducer *);
+  *rpp = r;
+  r->dstkey = g->partitions[0].reducers[idx]->dstkey;
+}
+
+size_t Grouper_NumPartitions(const ResultProcessor *rp) {
+  RS_ASSERT(rp->type == RP_GROUP);
+  return ((const Grouper *)rp)->numPartitions;
+}
+
 ResultProcessor *Grouper_GetRP(Grouper *g) {
   return &g->base;
 }
@@ -37,10 +37,16 @@ static const FuncEntry globalRegistry[] = {
   {"RANDOM_SAMPLE", RDCRRandomSample_New},
   {"HLL", RDCRHLL_New},
   {"HLL_SUM", RDCRHLLSum_New},
-  {"COLLECT", RDCRCollect_New}
+  {"COLLECT", RDCRCollect_New},
+  {"QUANTILE_SKETCH", RDCRQuantileSketch_New},
+  {"QUANTILE_MERGE", RDCRQuantileMerge_New},
+  {"STDDEV_PARTIAL", RDCRStdDevPartial_New},
+  {"STDDEV_MERGE", RDCRStdDevMerge_New},
+  {"COUNT_DISTINCT_SET", RDCRDistinctSet_New},
+  {"COUNT_DISTINCT_MERGE", RDCRDistinctMerge_New}
 };
 
-#define REGISTRY_SIZE 15
+#define REGISTRY_SIZE 21
 static_assert(sizeof(globalRegistry) == sizeof(FuncEntry) * REGISTRY_SIZE);
 
 ReducerFactory RDCR_GetFactory(const char *name) {
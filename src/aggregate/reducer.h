@@ -32,6 +32,12 @@ typedef enum {
   REDUCER_T_HLL,
   REDUCER_T_HLLSUM,
   REDUCER_T_SAMPLE,
+  REDUCER_T_QUANTILE_SKETCH,
+  REDUCER_T_QUANTILE_MERGE,
+  REDUCER_T_STDDEV_PARTIAL,
+  REDUCER_T_STDDEV_MERGE,
+  REDUCER_T_DISTINCT_SET,
+  REDUCER_T_DISTINCT_MERGE,
 
   /** Not a reducer, but a marker of the end of the list */
   REDUCER_T__END
@@ -220,6 +226,12 @@ Reducer *RDCRFirstValue_New(const ReducerOptions *);
 Reducer *RDCRRandomSample_New(const ReducerOptions *);
 Reducer *RDCRHLL_New(const ReducerOptions *);
 Reducer *RDCRHLLSum_New(const ReducerOptions *);
+Reducer *RDCRQuantileSketch_New(const ReducerOptions *);
+Reducer *RDCRQuantileMerge_New(const ReducerOptions *);
+Reducer *RDCRStdDevPartial_New(const ReducerOptions *);
+Reducer *RDCRStdDevMerge_New(const ReducerOptions *);
+Reducer *RDCRDistinctSet_New(const ReducerOptions *);
+Reducer *RDCRDistinctMerge_New(const ReducerOptions *);
 Reducer *RDCRCollect_New(const ReducerOptions *);
 
 typedef Reducer *(*ReducerFactory)(const ReducerOptions *);
@@ -6,8 +6,11 @@
  * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
  * GNU Affero General Public License v3 (AGPLv3).
 */
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdlib.h>
+#include <sys/param.h>
 
 #include "aggregate/reducer.h"
 #include "value_ffi.h"
@@ -43,6 +46,14 @@ static void *distinctNewInstance(Reducer *r) {
   return ctr;
 }
 
+static void distinctAddHash(distinctCounter *ctr, uint64_t hval) {
+  int ret;
+  kh_put(khid, ctr->dedup, hval, &ret);
+  if (ret > 0) {
+    ctr->count++;
+  }
+}
+
 static int distinctAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
   distinctCounter *ctr = ctx;
   const RSValue *val = RLookupRow_Get(r->srckey, srcrow);
@@ -50,14 +61,20 @@ static int distinctAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
     return 1;
   }
 
-  uint64_t hval = RSValue_Hash(val, 0);
+  distinctAddHash(ctr, RSValue_Hash(val, 0));
+  return 1;
+}
 
-  khiter_t k = kh_get(khid, ctr->dedup, hval);  // first have to get ieter
-  if (k == kh_end(ctr->dedup)) {
-    ctr->count++;
-    int ret;
-    kh_put(khid, ctr->dedup, hval, &ret);
+static int distinctSetAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
+  distinctCounter *ctr = ctx;
+  const RSValue *val = RLookupRow_Get(r->srckey, srcrow);
+  if (!val || val == RSValue_NullStatic()) {
+    return 1;
   }
+
+  // The sets of all the shards are merged by COUNT_DISTINCT_MERGE, so every shard must hash a
+  // value the same way
+  distinctAddHash(ctr, RSValue_HashStable(val, STABLE_SEED));
   return 1;
 }
 
@@ -73,7 +90,106 @@ static void distinctFreeInstance(Reducer *r, void *p) {
   kh_destroy(khid, ctr->dedup);
 }
 
-Reducer *RDCRCountDistinct_New(const ReducerOptions *options) {
+/** Serialized set format, followed by the deltas between the sorted hashes, as LEB128 varints */
+typedef struct __attribute__((packed)) {
+  uint32_t flags;  // Currently unused
+  uint32_t count;
+} DistinctSetSerializedHeader;
+
+#define VARINT64_MAX_LEN 10
+
+static int hashCmp(const void *a, const void *b) {
+  uint64_t ha = *(const uint64_t *)a, hb = *(const uint64_t *)b;
+  return ha < hb ? -1 : ha > hb;
+}
+
+static RSValue *distinctSetFinalize(Reducer *parent, void *ctx) {
+  distinctCounter *ctr = ctx;
+  uint64_t *hashes = rm_malloc(MAX(ctr->count, 1) * sizeof(*hashes));
+  size_t n = 0;
+  for (khiter_t k = kh_begin(ctr->dedup); k != kh_end(ctr->dedup); ++k) {
+    if (kh_exist(ctr->dedup, k)) {
+      hashes[n++] = kh_key(ctr->dedup, k);
+    }
+  }
+  qsort(hashes, n, sizeof(*hashes), hashCmp);
+
+  DistinctSetSerializedHeader hdr = {.flags = 0, .count = n};
+  char *str = rm_malloc(sizeof(hdr) + n * VARINT64_MAX_LEN + 1);
+  memcpy(str, &hdr, sizeof(hdr));
+  size_t len = sizeof(hdr);
+  uint64_t prev = 0;
+  for (size_t ii = 0; ii < n; ++ii) {
+    uint64_t delta = hashes[ii] - prev;
+    prev = hashes[ii];
+    while (delta >= 0x80) {
+      str[len++] = (char)(delta | 0x80);
+      delta >>= 7;
+    }
+    str[len++] = (char)delta;
+  }
+  str[len] = 0;  // Null termination
+  rm_free(hashes);
+  return RSValue_NewString(rm_realloc(str, len + 1), len);
+}
+
+static bool readVarint64(const unsigned char **pos, const unsigned char *end, uint64_t *out) {
+  uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (*pos == end) {
+      return false;
+    }
+    unsigned char byte = *(*pos)++;
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *out = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+static int distinctMergeAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
+  distinctCounter *ctr = ctx;
+  const RSValue *val = RLookupRow_Get(r->srckey, srcrow);
+  if (val == NULL || !RSValue_IsString(val)) {
+    return 0;
+  }
+  size_t len;
+  const unsigned char *buf = (const unsigned char *)RSValue_StringPtrLen(val, &len);
+  DistinctSetSerializedHeader hdr;
+  if (len < sizeof(hdr)) {
+    return 0;
+  }
+  memcpy(&hdr, buf, sizeof(hdr));
+  // Every hash takes at least a byte
+  if (hdr.count > len - sizeof(hdr)) {
+    return 0;
+  }
+
+  // Validate the whole set before counting any of it
+  const unsigned char *hashes = buf + sizeof(hdr), *end = buf + len, *pos = hashes;
+  uint64_t delta;
+  for (uint32_t ii = 0; ii < hdr.count; ++ii) {
+    if (!readVarint64(&pos, end, &delta)) {
+      return 0;
+    }
+  }
+  if (pos != end) {
+    return 0;
+  }
+
+  pos = hashes;
+  uint64_t hval = 0;
+  for (uint32_t ii = 0; ii < hdr.count; ++ii) {
+    readVarint64(&pos, end, &delta);
+    hval += delta;
+    distinctAddHash(ctr, hval);
+  }
+  return 1;
+}
+
+static Reducer *newDistinctCommon(const ReducerOptions *options, ReducerType type) {
   Reducer *r = rm_calloc(1, sizeof(*r));
   if (!ReducerOpts_GetKey(options, &r->srckey)) {
     rm_free(r);
@@ -84,7 +200,28 @@ Reducer *RDCRCountDistinct_New(const ReducerOptions *options) {
   r->Free = Reducer_GenericFree;
   r->FreeInstance = distinctFreeInstance;
   r->NewInstance = distinctNewInstance;
-  r->reducerId = REDUCER_T_DISTINCT;
+  r->reducerId = type;
+  return r;
+}
+
+Reducer *RDCRCountDistinct_New(const ReducerOptions *options) {
+  return newDistinctCommon(options, REDUCER_T_DISTINCT);
+}
+
+Reducer *RDCRDistinctSet_New(const ReducerOptions *options) {
+  Reducer *r = newDistinctCommon(options, REDUCER_T_DISTINCT_SET);
+  if (r) {
+    r->Add = distinctSetAdd;
+    r->Finalize = distinctSetFinalize;
+  }
+  return r;
+}
+
+Reducer *RDCRDistinctMerge_New(const ReducerOptions *options) {
+  Reducer *r = newDistinctCommon(options, REDUCER_T_DISTINCT_MERGE);
+  if (r) {
+    r->Add = distinctMergeAdd;
+  }
   return r;
 }
 
@@ -74,7 +74,48 @@ static RSValue *stddevFinalize(Reducer *parent, void *instance) {
   return RSValue_NewNumber(stddev);
 }
 
-Reducer *RDCRStdDev_New(const ReducerOptions *options) {
+/** Serialized partial deviation format, merged by STDDEV_MERGE */
+typedef struct __attribute__((packed)) {
+  uint64_t n;
+  double M, S;
+} devPartial;
+
+static RSValue *stddevPartialFinalize(Reducer *parent, void *instance) {
+  devCtx *dctx = instance;
+  devPartial partial = {.n = dctx->n, .M = dctx->M, .S = dctx->S};
+  char *str = rm_malloc(sizeof(partial) + 1);
+  memcpy(str, &partial, sizeof(partial));
+  str[sizeof(partial)] = 0; // Null termination
+  return RSValue_NewString(str, sizeof(partial));
+}
+
+static int stddevMergeAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
+  devCtx *dctx = ctx;
+  const RSValue *v = RLookupRow_Get(r->srckey, srcrow);
+  if (v == NULL || !RSValue_IsString(v)) {
+    return 0;
+  }
+  size_t len;
+  const char *buf = RSValue_StringPtrLen(v, &len);
+  devPartial partial;
+  if (len != sizeof(partial)) {
+    return 0;
+  }
+  memcpy(&partial, buf, sizeof(partial));
+  if (!partial.n) {
+    return 1;
+  }
+
+  // Chan et al. parallel algorithm
+  size_t n = dctx->n + partial.n;
+  double delta = partial.M - dctx->M;
+  dctx->M += delta * partial.n / n;
+  dctx->S += partial.S + delta * delta * ((double)dctx->n * partial.n / n);
+  dctx->n = n;
+  return 1;
+}
+
+static Reducer *newStddevCommon(const ReducerOptions *options, ReducerType type) {
   Reducer *r = rm_calloc(1, sizeof(*r));
   if (!ReducerOptions_GetKey(options, &r->srckey)) {
     rm_free(r);
@@ -84,6 +125,26 @@ Reducer *RDCRStdDev_New(const ReducerOptions *options) {
   r->Finalize = stddevFinalize;
   r->Free = Reducer_GenericFree;
   r->NewInstance = stddevNewInstance;
-  r->reducerId = REDUCER_T_STDDEV;
+  r->reducerId = type;
+  return r;
+}
+
+Reducer *RDCRStdDev_New(const ReducerOptions *options) {
+  return newStddevCommon(options, REDUCER_T_STDDEV);
+}
+
+Reducer *RDCRStdDevPartial_New(const ReducerOptions *options) {
+  Reducer *r = newStddevCommon(options, REDUCER_T_STDDEV_PARTIAL);
+  if (r) {
+    r->Finalize = stddevPartialFinalize;
+  }
+  return r;
+}
+
+Reducer *RDCRStdDevMerge_New(const ReducerOptions *options) {
+  Reducer *r = newStddevCommon(options, REDUCER_T_STDDEV_MERGE);
+  if (r) {
+    r->Add = stddevMergeAdd;
+  }
   return r;
 }
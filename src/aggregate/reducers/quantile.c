@@ -19,6 +19,9 @@
 #include "rmalloc.h"
 #include "rmutil/args.h"
 
+// The values of a group are exact up to this many values
+#define QUANTILE_DEFAULT_RESOLUTION 500
+
 typedef struct {
   Reducer base;
   double pct;
@@ -27,12 +30,11 @@ typedef struct {
 
 static void *quantileNewInstance(Reducer *parent) {
   QTLReducer *qt = (QTLReducer *)parent;
-  return NewQuantileStream(NULL, 0, qt->resolution);
+  return NewQuantileStream(qt->resolution);
 }
 
 static int quantileAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
   double d;
-  QTLReducer *qt = (QTLReducer *)rbase;
   QuantStream *qs = ctx;
   RSValue *v = RLookupRow_Get(rbase->srckey, row);
   if (!v) {
@@ -65,23 +67,58 @@ static void quantileFreeInstance(Reducer *unused, void *p) {
   QS_Free(p);
 }
 
-Reducer *RDCRQuantile_New(const ReducerOptions *options) {
-  QTLReducer *r = rm_calloc(1, sizeof(*r));
-  r->resolution = 500;  // Fixed, i guess?
-
-  if (!ReducerOptions_GetKey(options, &r->base.srckey)) {
-    goto error;
+static int quantileMergeAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
+  const RSValue *v = RLookupRow_Get(rbase->srckey, row);
+  if (v == NULL || !RSValue_IsString(v)) {
+    return 0;
   }
+  size_t len;
+  const char *buf = RSValue_StringPtrLen(v, &len);
+  return QS_MergeSerialized(ctx, buf, len);
+}
+
+static RSValue *quantileSketchFinalize(Reducer *r, void *ctx) {
+  size_t len;
+  char *buf = QS_Serialize(ctx, &len);
+  return RSValue_NewString(buf, len);
+}
+
+static int parsePct(const ReducerOptions *options, QTLReducer *r) {
   int rv;
   if ((rv = AC_GetDouble(options->args, &r->pct, 0)) != AC_OK) {
     QERR_MKBADARGS_AC(options->status, options->name, rv);
-    goto error;
+    return 0;
   }
   if (!(r->pct >= 0 && r->pct <= 1.0)) {
     QueryError_SetError(options->status, QUERY_ERROR_CODE_PARSE_ARGS, "Percentage must be between 0.0 and 1.0");
+    return 0;
+  }
+  return 1;
+}
+
+static QTLReducer *newQuantileCommon(void) {
+  QTLReducer *r = rm_calloc(1, sizeof(*r));
+  r->resolution = QUANTILE_DEFAULT_RESOLUTION;
+  r->base.NewInstance = quantileNewInstance;
+  r->base.Add = quantileAdd;
+  r->base.Free = Reducer_GenericFree;
+  r->base.FreeInstance = quantileFreeInstance;
+  r->base.Finalize = quantileFinalize;
+  return r;
+}
+
+Reducer *RDCRQuantile_New(const ReducerOptions *options) {
+  QTLReducer *r = newQuantileCommon();
+  r->base.reducerId = REDUCER_T_QUANTILE;
+
+  if (!ReducerOptions_GetKey(options, &r->base.srckey)) {
+    goto error;
+  }
+  if (!parsePct(options, r)) {
     goto error;
   }
 
+  int rv;
   if (!AC_IsAtEnd(options->args)) {
     // TODO: why do we need this hidden option? why isn't it available in cluster mode?
     if ((rv = AC_GetUnsigned(options->args, &r->resolution, 0)) != AC_OK) {
@@ -97,15 +134,32 @@ Reducer *RDCRQuantile_New(const ReducerOptions *options) {
   if (!ReducerOpts_EnsureArgsConsumed(options)) {
     goto error;
   }
-
-  r->base.NewInstance = quantileNewInstance;
-  r->base.Add = quantileAdd;
-  r->base.Free = Reducer_GenericFree;
-  r->base.FreeInstance = quantileFreeInstance;
-  r->base.Finalize = quantileFinalize;
   return &r->base;
 
 error:
   rm_free(r);
   return NULL;
 }
+
+Reducer *RDCRQuantileSketch_New(const ReducerOptions *options) {
+  QTLReducer *r = newQuantileCommon();
+  if (!ReducerOptions_GetKey(options, &r->base.srckey)) {
+    rm_free(r);
+    return NULL;
+  }
+  r->base.reducerId = REDUCER_T_QUANTILE_SKETCH;
+  r->base.Finalize = quantileSketchFinalize;
+  return &r->base;
+}
+
+Reducer *RDCRQuantileMerge_New(const ReducerOptions *options) {
+  QTLReducer *r = newQuantileCommon();
+  if (!ReducerOptions_GetKey(options, &r->base.srckey) || !parsePct(options, r) ||
+      !ReducerOpts_EnsureArgsConsumed(options)) {
+    rm_free(r);
+    return NULL;
+  }
+  r->base.reducerId = REDUCER_T_QUANTILE_MERGE;
+  r->base.Add = quantileMergeAdd;
+  return &r->base;
+}
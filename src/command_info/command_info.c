@@ -262,6 +262,12 @@ int SetFtCreateInfo(RedisModuleCommand *cmd) {
             .type = REDISMODULE_ARG_TYPE_PURE_TOKEN,
             .flags = REDISMODULE_CMD_ARG_OPTIONAL,
           },
+          {
+            .name = "withngrams",
+            .token = "WITHNGRAMS",
+            .type = REDISMODULE_ARG_TYPE_PURE_TOKEN,
+            .flags = REDISMODULE_CMD_ARG_OPTIONAL,
+          },
           {
             .name = "INDEXEMPTY",
             .token = "INDEXEMPTY",
@@ -1065,6 +1071,13 @@ int SetFtSearchInfo(RedisModuleCommand *cmd) {
         .type = REDISMODULE_ARG_TYPE_PURE_TOKEN,
         .flags = REDISMODULE_CMD_ARG_OPTIONAL,
       },
+      {
+        .name = "nocache",
+        .token = "NOCACHE",
+        .summary = "Bypasses the query result cache.",
+        .type = REDISMODULE_ARG_TYPE_PURE_TOKEN,
+        .flags = REDISMODULE_CMD_ARG_OPTIONAL,
+      },
       {
         .name = "withscores",
         .token = "WITHSCORES",
@@ -1509,6 +1522,13 @@ int SetFtAggregateInfo(RedisModuleCommand *cmd) {
         .type = REDISMODULE_ARG_TYPE_PURE_TOKEN,
         .flags = REDISMODULE_CMD_ARG_OPTIONAL,
       },
+      {
+        .name = "nocache",
+        .token = "NOCACHE",
+        .summary = "Bypasses the query result cache.",
+        .type = REDISMODULE_ARG_TYPE_PURE_TOKEN,
+        .flags = REDISMODULE_CMD_ARG_OPTIONAL,
+      },
       {
         .name = "load",
         .type = REDISMODULE_ARG_TYPE_BLOCK,
@@ -105,7 +105,18 @@ configPair_t __configPairs[] = {
   {"ON_TIMEOUT",                      "search-on-timeout"},
   {"MULTI_TEXT_SLOP",                 "search-multi-text-slop"},
   {"PARTIAL_INDEXED_DOCS",            "search-partial-indexed-docs"},
+  {"QUERY_CACHE_MAX_MEMORY",          "search-query-cache-max-memory"},
+  {"FILTER_CACHE_MAX_MEMORY",         "search-filter-cache-max-memory"},
+  {"QUERY_MAX_PARALLELISM",           "search-query-max-parallelism"},
+  {"QUERY_PARALLEL_MIN_DOCS",         "search-query-parallel-min-docs"},
+  {"ASYNC_INDEXING_MAX_PENDING",      "search-async-indexing-max-pending"},
+  {"ASYNC_INDEXING_READ_YOUR_WRITES", "search-async-indexing-read-your-writes"},
+  {"BG_INDEX_MAX_PENDING",            "search-bg-index-max-pending"},
+  {"PERSIST_INDEX_CONTENTS",          "search-persist-index-contents"},
+  {"STEM_CACHE_MAX_MEMORY",           "search-stem-cache-max-memory"},
   {"RAW_DOCID_ENCODING",              "search-raw-docid-encoding"},
+  {"PACKED_DOCID_ENCODING",           "search-packed-docid-encoding"},
+  {"BITMAP_DOCID_ENCODING",           "search-bitmap-docid-encoding"},
   {"SEARCH_THREADS",                  "search-threads"},
   {"TIERED_HNSW_BUFFER_LIMIT",        "search-tiered-hnsw-buffer-limit"},
   {"TIMEOUT",                         "search-timeout"},
@@ -892,6 +903,98 @@ CONFIG_GETTER(getTieredIndexBufferLimit) {
   return sdscatprintf(ss, "%lu", config->tieredVecSimIndexBufferLimit);
 }
 
+// QUERY_CACHE_MAX_MEMORY
+CONFIG_SETTER(setQueryCacheMaxMemory) {
+  int acrc = AC_GetSize(ac, &config->queryCacheMaxMemory, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getQueryCacheMaxMemory) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->queryCacheMaxMemory);
+}
+
+// FILTER_CACHE_MAX_MEMORY
+CONFIG_SETTER(setFilterCacheMaxMemory) {
+  int acrc = AC_GetSize(ac, &config->filterCacheMaxMemory, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getFilterCacheMaxMemory) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->filterCacheMaxMemory);
+}
+
+// QUERY_MAX_PARALLELISM
+CONFIG_SETTER(setQueryMaxParallelism) {
+  size_t val;
+  int acrc = AC_GetSize(ac, &val, AC_F_GE1);
+  CHECK_RETURN_PARSE_ERROR(acrc);
+  if (val > MAX_WORKER_THREADS) {
+    QueryError_SetWithoutUserDataFmt(status, QUERY_ERROR_CODE_LIMIT, "Query parallelism cannot exceed %d", MAX_WORKER_THREADS);
+    return REDISMODULE_ERR;
+  }
+  config->queryMaxParallelism = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getQueryMaxParallelism) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->queryMaxParallelism);
+}
+
+// QUERY_PARALLEL_MIN_DOCS
+CONFIG_SETTER(setQueryParallelMinDocs) {
+  int acrc = AC_GetSize(ac, &config->queryParallelMinDocs, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getQueryParallelMinDocs) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->queryParallelMinDocs);
+}
+
+// ASYNC_INDEXING_MAX_PENDING
+CONFIG_SETTER(setAsyncIndexingMaxPending) {
+  int acrc = AC_GetSize(ac, &config->asyncIndexingMaxPending, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getAsyncIndexingMaxPending) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->asyncIndexingMaxPending);
+}
+
+// ASYNC_INDEXING_READ_YOUR_WRITES
+CONFIG_BOOLEAN_SETTER(set_AsyncIndexingReadYourWrites, asyncIndexingReadYourWrites)
+CONFIG_BOOLEAN_GETTER(get_AsyncIndexingReadYourWrites, asyncIndexingReadYourWrites, 0)
+
+// BG_INDEX_MAX_PENDING
+CONFIG_SETTER(setBgIndexMaxPending) {
+  int acrc = AC_GetSize(ac, &config->bgIndexMaxPending, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getBgIndexMaxPending) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->bgIndexMaxPending);
+}
+
+// PERSIST_INDEX_CONTENTS
+CONFIG_BOOLEAN_SETTER(set_PersistIndexContents, persistIndexContents)
+CONFIG_BOOLEAN_GETTER(get_PersistIndexContents, persistIndexContents, 0)
+
+// STEM_CACHE_MAX_MEMORY
+CONFIG_SETTER(setStemCacheMaxMemory) {
+  int acrc = AC_GetSize(ac, &config->stemCacheMaxMemory, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getStemCacheMaxMemory) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->stemCacheMaxMemory);
+}
+
 // WORKERS_PRIORITY_BIAS_THRESHOLD
 CONFIG_SETTER(setHighPriorityBiasNum) {
   int acrc = AC_GetSize(ac, &config->highPriorityBiasNum, AC_F_GE0);
@@ -1132,6 +1235,14 @@ CONFIG_BOOLEAN_GETTER(getPrintProfileClock, requestConfigParams.printProfileCloc
 CONFIG_BOOLEAN_SETTER(setRawDocIDEncoding, invertedIndexRawDocidEncoding)
 CONFIG_BOOLEAN_GETTER(getRawDocIDEncoding, invertedIndexRawDocidEncoding, 0)
 
+// PACKED_DOCID_ENCODING
+CONFIG_BOOLEAN_SETTER(setPackedDocIDEncoding, invertedIndexPackedDocidEncoding)
+CONFIG_BOOLEAN_GETTER(getPackedDocIDEncoding, invertedIndexPackedDocidEncoding, 0)
+
+// BITMAP_DOCID_ENCODING
+CONFIG_BOOLEAN_SETTER(setBitmapDocIDEncoding, invertedIndexBitmapDocidEncoding)
+CONFIG_BOOLEAN_GETTER(getBitmapDocIDEncoding, invertedIndexBitmapDocidEncoding, 0)
+
 // _NUMERIC_RANGES_PARENTS
 CONFIG_SETTER(setNumericTreeMaxDepthRange) {
   size_t maxDepthRange;
@@ -1756,6 +1867,60 @@ RSConfigOptions RSGlobalConfigOptions = {
          .setValue = setFilterCommand,
          .getValue = getFilterCommand,
          .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "QUERY_CACHE_MAX_MEMORY",
+         .helpText = "Memory cap, in bytes, of the query result cache of each index. "
+                     "Repeated queries are replied from the cache until the index is written to. "
+                     "0 (default) disables the cache.",
+         .setValue = setQueryCacheMaxMemory,
+         .getValue = getQueryCacheMaxMemory},
+        {.name = "FILTER_CACHE_MAX_MEMORY",
+         .helpText = "Memory cap, in bytes, of the filter cache of each index. "
+                     "The documents matching repeated tag, numeric and geo filters are cached "
+                     "until the filtered field is written to. Filters contributing to the "
+                     "scores are not cached. 0 (default) disables the cache.",
+         .setValue = setFilterCacheMaxMemory,
+         .getValue = getFilterCacheMaxMemory},
+        {.name = "QUERY_MAX_PARALLELISM",
+         .helpText = "Maximum number of worker threads scanning the index or grouping the "
+                     "results for a single query. 1 (default) scans and groups serially.",
+         .setValue = setQueryMaxParallelism,
+         .getValue = getQueryMaxParallelism},
+        {.name = "QUERY_PARALLEL_MIN_DOCS",
+         .helpText = "Minimum estimated number of matching documents for a query to be scanned "
+                     "and grouped in parallel, see QUERY_MAX_PARALLELISM.",
+         .setValue = setQueryParallelMinDocs,
+         .getValue = getQueryParallelMinDocs},
+        {.name = "ASYNC_INDEXING_MAX_PENDING",
+         .helpText = "Maximum number of written documents of each index waiting to be indexed. "
+                     "When above 0 and WORKERS is set, the documents are tokenized on the worker "
+                     "threads and written to the index in batches. 0 (default) indexes them "
+                     "synchronously.",
+         .setValue = setAsyncIndexingMaxPending,
+         .getValue = getAsyncIndexingMaxPending},
+        {.name = "ASYNC_INDEXING_READ_YOUR_WRITES",
+         .helpText = "If set (default), a query first indexes the documents of its index that "
+                     "are waiting to be indexed, see ASYNC_INDEXING_MAX_PENDING. Otherwise "
+                     "queries may miss the most recent writes.",
+         .setValue = set_AsyncIndexingReadYourWrites,
+         .getValue = get_AsyncIndexingReadYourWrites},
+        {.name = "BG_INDEX_MAX_PENDING",
+         .helpText = "Maximum number of documents found by the background scan of an index "
+                     "waiting to be indexed. When above 0 (default 1024) and WORKERS is set, "
+                     "the scanned documents are tokenized on the worker threads and written to "
+                     "the index in batches. 0 indexes them on the scanning thread.",
+         .setValue = setBgIndexMaxPending,
+         .getValue = getBgIndexMaxPending},
+        {.name = "PERSIST_INDEX_CONTENTS",
+         .helpText = "If set, the contents of the in-memory indexes are saved to the RDB along "
+                     "with their schema, so that loading it restores them instead of indexing "
+                     "the keyspace again.",
+         .setValue = set_PersistIndexContents,
+         .getValue = get_PersistIndexContents},
+        {.name = "STEM_CACHE_MAX_MEMORY",
+         .helpText = "Memory cap, in bytes, of the cache of word stems shared by the indexing "
+                     "and the query expansion of all the indexes. 0 disables the cache.",
+         .setValue = setStemCacheMaxMemory,
+         .getValue = getStemCacheMaxMemory},
         {.name = "UPGRADE_INDEX",
          .helpText =
              "Relevant only when loading an v1.x rdb, specify argument for upgrading the index.",
@@ -1779,6 +1944,21 @@ RSConfigOptions RSGlobalConfigOptions = {
          .setValue = setRawDocIDEncoding,
          .getValue = getRawDocIDEncoding,
          .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "PACKED_DOCID_ENCODING",
+         .helpText = "Bit-pack DocID inverted indexes in groups of 128 entries. "
+                     "Smaller than the default encoding and faster to scan. "
+                     "Takes precedence over RAW_DOCID_ENCODING.",
+         .setValue = setPackedDocIDEncoding,
+         .getValue = getPackedDocIDEncoding,
+         .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "BITMAP_DOCID_ENCODING",
+         .helpText = "Store the dense blocks of DocID inverted indexes as bitmaps or "
+                     "runs of consecutive DocIDs. Speeds up negation and ismissing() "
+                     "queries. Takes precedence over PACKED_DOCID_ENCODING and "
+                     "RAW_DOCID_ENCODING.",
+         .setValue = setBitmapDocIDEncoding,
+         .getValue = getBitmapDocIDEncoding,
+         .flags = RSCONFIGVAR_F_IMMUTABLE},
         {.name = "_NUMERIC_RANGES_PARENTS",
          .helpText = "Keep numeric ranges in numeric tree parent nodes of leafs "
                      "for `x` generations.",
@@ -2583,6 +2763,87 @@ int RegisterModuleConfig_Local(RedisModuleCtx *ctx) {
     )
   )
 
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-query-cache-max-memory", DEFAULT_QUERY_CACHE_MAX_MEMORY,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.queryCacheMaxMemory)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-filter-cache-max-memory", DEFAULT_FILTER_CACHE_MAX_MEMORY,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.filterCacheMaxMemory)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-query-max-parallelism", DEFAULT_QUERY_MAX_PARALLELISM,
+      REDISMODULE_CONFIG_UNPREFIXED, 1,
+      MAX_WORKER_THREADS, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.queryMaxParallelism)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-query-parallel-min-docs", DEFAULT_QUERY_PARALLEL_MIN_DOCS,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.queryParallelMinDocs)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-async-indexing-max-pending", DEFAULT_ASYNC_INDEXING_MAX_PENDING,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.asyncIndexingMaxPending)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterBoolConfig(
+      ctx, "search-async-indexing-read-your-writes", 1,
+      REDISMODULE_CONFIG_UNPREFIXED,
+      get_bool_config, set_bool_config, NULL,
+      (void *)&(RSGlobalConfig.asyncIndexingReadYourWrites)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-bg-index-max-pending", DEFAULT_BG_INDEX_MAX_PENDING,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.bgIndexMaxPending)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterBoolConfig(
+      ctx, "search-persist-index-contents", 0,
+      REDISMODULE_CONFIG_UNPREFIXED,
+      get_bool_config, set_bool_config, NULL,
+      (void *)&(RSGlobalConfig.persistIndexContents)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-stem-cache-max-memory", DEFAULT_STEM_CACHE_MAX_MEMORY,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.stemCacheMaxMemory)
+    )
+  )
+
   RM_TRY(
     RedisModule_RegisterBoolConfig(
       ctx, "search-raw-docid-encoding", 0,
@@ -2592,6 +2853,24 @@ int RegisterModuleConfig_Local(RedisModuleCtx *ctx) {
     )
   )
 
+  RM_TRY(
+    RedisModule_RegisterBoolConfig(
+      ctx, "search-packed-docid-encoding", 0,
+      REDISMODULE_CONFIG_IMMUTABLE | REDISMODULE_CONFIG_UNPREFIXED,
+      get_bool_config, set_bool_config, NULL,
+      (void *)&(RSGlobalConfig.invertedIndexPackedDocidEncoding)
+    )
+  )
+
+  RM_TRY(
+    RedisModule_RegisterBoolConfig(
+      ctx, "search-bitmap-docid-encoding", 0,
+      REDISMODULE_CONFIG_IMMUTABLE | REDISMODULE_CONFIG_UNPREFIXED,
+      get_bool_config, set_bool_config, NULL,
+      (void *)&(RSGlobalConfig.invertedIndexBitmapDocidEncoding)
+    )
+  )
+
   RM_TRY(
     RedisModule_RegisterBoolConfig(
       ctx, "search-enable-unstable-features", DEFAULT_UNSTABLE_FEATURES_ENABLE,
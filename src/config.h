@@ -149,6 +149,27 @@ typedef struct {
   size_t tieredVecSimIndexBufferLimit;
   size_t highPriorityBiasNum;
 
+  // Memory cap, in bytes, of the query result cache of each index. 0 disables the cache.
+  size_t queryCacheMaxMemory;
+  // Memory cap, in bytes, of the filter cache of each index. 0 disables the cache.
+  size_t filterCacheMaxMemory;
+  // Maximum number of partitions of the document id space scanned concurrently by a query
+  size_t queryMaxParallelism;
+  // Minimum estimated number of results of a query for its scan to be partitioned
+  size_t queryParallelMinDocs;
+  // Maximum number of documents of an index waiting in the asynchronous indexing pipeline.
+  // 0 indexes the documents synchronously
+  size_t asyncIndexingMaxPending;
+  // If set, a query first indexes the pending documents of its index
+  bool asyncIndexingReadYourWrites;
+  // Maximum number of documents loaded by the background scan of an index waiting in its
+  // indexing pipeline. 0 indexes them on the scanning thread
+  size_t bgIndexMaxPending;
+  // If set, the contents of the in-memory indexes are saved to the RDB
+  bool persistIndexContents;
+  // Memory cap, in bytes, of the shared cache of word stems. 0 disables the cache.
+  size_t stemCacheMaxMemory;
+
   size_t minPhoneticTermLen;
 
   GCConfig gcConfigParams;
@@ -168,6 +189,10 @@ typedef struct {
   size_t numericTreeMaxDepthRange;
   // disable compression for inverted index DocIdsOnly
   bool invertedIndexRawDocidEncoding;
+  // bit-pack inverted index DocIdsOnly in groups of 128 entries
+  bool invertedIndexPackedDocidEncoding;
+  // store dense blocks of inverted index DocIdsOnly as bitmaps or runs
+  bool invertedIndexBitmapDocidEncoding;
 
   // sets the memory limit for vector indexes to resize by (in bytes).
   // 0 indicates no limit. Default value is 0.
@@ -388,6 +413,13 @@ long long getRedisConfigNumeric(RedisModuleCtx *ctx, const char *confName, long
 #define MIN_OPERATION_WORKERS 4
 #define DEFAULT_INDEXING_MEMORY_LIMIT 100
 #define DEFAULT_BM25STD_TANH_FACTOR 4
+#define DEFAULT_QUERY_CACHE_MAX_MEMORY 0
+#define DEFAULT_FILTER_CACHE_MAX_MEMORY 0
+#define DEFAULT_QUERY_MAX_PARALLELISM 1
+#define DEFAULT_QUERY_PARALLEL_MIN_DOCS 100000
+#define DEFAULT_ASYNC_INDEXING_MAX_PENDING 0
+#define DEFAULT_BG_INDEX_MAX_PENDING 1024
+#define DEFAULT_STEM_CACHE_MAX_MEMORY (16 * 1024 * 1024)
 #define BM25STD_TANH_FACTOR_MAX 10000
 #define BM25STD_TANH_FACTOR_MIN 1
 #define DEFAULT_BG_OOM_PAUSE_TIME_BEFOR_RETRY 5
@@ -425,6 +457,15 @@ long long getRedisConfigNumeric(RedisModuleCtx *ctx, const char *confName, long
     .minOperationWorkers = MIN_OPERATION_WORKERS,                              \
     .tieredVecSimIndexBufferLimit = DEFAULT_BLOCK_SIZE,                        \
     .highPriorityBiasNum = DEFAULT_HIGH_PRIORITY_BIAS_THRESHOLD,               \
+    .queryCacheMaxMemory = DEFAULT_QUERY_CACHE_MAX_MEMORY,                     \
+    .filterCacheMaxMemory = DEFAULT_FILTER_CACHE_MAX_MEMORY,                   \
+    .queryMaxParallelism = DEFAULT_QUERY_MAX_PARALLELISM,                      \
+    .queryParallelMinDocs = DEFAULT_QUERY_PARALLEL_MIN_DOCS,                   \
+    .asyncIndexingMaxPending = DEFAULT_ASYNC_INDEXING_MAX_PENDING,             \
+    .asyncIndexingReadYourWrites = true,                                       \
+    .bgIndexMaxPending = DEFAULT_BG_INDEX_MAX_PENDING,                         \
+    .persistIndexContents = false,                                             \
+    .stemCacheMaxMemory = DEFAULT_STEM_CACHE_MAX_MEMORY,                       \
     .gcConfigParams.gcScanSize = DEFAULT_GC_SCANSIZE,                          \
     .minPhoneticTermLen = DEFAULT_MIN_PHONETIC_TERM_LEN,                       \
     .gcConfigParams.gcPolicy = GCPolicy_Fork,                                  \
@@ -442,6 +483,8 @@ long long getRedisConfigNumeric(RedisModuleCtx *ctx, const char *confName, long
     .numericTreeMaxDepthRange = 0,                                             \
     .requestConfigParams.printProfileClock = 1,                                \
     .invertedIndexRawDocidEncoding = false,                                    \
+    .invertedIndexPackedDocidEncoding = false,                                 \
+    .invertedIndexBitmapDocidEncoding = false,                                 \
     .gcConfigParams.gcSettings.forkGCCleanNumericEmptyNodes = true,            \
     .freeResourcesThread = true,                                               \
     .requestConfigParams.dialectVersion = DEFAULT_DIALECT_VERSION,             \
@@ -284,38 +284,33 @@ static int distributeSingleArgSelf(ReducerDistCtx *rdctx, QueryError *status) {
   return REDISMODULE_OK;
 }
 
-#define RANDOM_SAMPLE_SIZE 500
-
-#define RANDOM_SAMPLE_SIZE_STR STRINGIFY(RANDOM_SAMPLE_SIZE)
-
-/* Distribute QUANTILE into remote RANDOM_SAMPLE and local QUANTILE */
+/* Distribute QUANTILE into remote QUANTILE_SKETCH and local QUANTILE_MERGE. Quantiles of the same
+ * field share a sketch */
 static int distributeQuantile(ReducerDistCtx *rdctx, QueryError *status) {
   PLN_Reducer *src = rdctx->srcReducer;
   CHECK_ARG_COUNT(2);
   const char *alias = NULL;
 
-  if (!rdctx->addRemote("RANDOM_SAMPLE", &alias, status, "2", rdctx->srcarg(0),
-                        RANDOM_SAMPLE_SIZE_STR)) {
+  if (!rdctx->addRemote("QUANTILE_SKETCH", &alias, status, "1", rdctx->srcarg(0))) {
     return REDISMODULE_ERR;
   }
 
-  if (!rdctx->addLocal("QUANTILE", status, "2", alias, rdctx->srcarg(1), "AS", src->alias)) {
+  if (!rdctx->addLocal("QUANTILE_MERGE", status, "2", alias, rdctx->srcarg(1), "AS", src->alias)) {
     return REDISMODULE_ERR;
   }
 
   return REDISMODULE_OK;
 }
 
-/* Distribute STDDEV into remote RANDOM_SAMPLE and local STDDEV */
+/* Distribute STDDEV into remote STDDEV_PARTIAL and local STDDEV_MERGE */
 static int distributeStdDev(ReducerDistCtx *rdctx, QueryError *status) {
   PLN_Reducer *src = rdctx->srcReducer;
   const char *alias = NULL;
   CHECK_ARG_COUNT(1);
-  if (!rdctx->addRemote("RANDOM_SAMPLE", &alias, status, "2", rdctx->srcarg(0),
-                        RANDOM_SAMPLE_SIZE_STR)) {
+  if (!rdctx->addRemote("STDDEV_PARTIAL", &alias, status, "1", rdctx->srcarg(0))) {
     return REDISMODULE_ERR;
   }
-  if (!rdctx->addLocal("STDDEV", status, "1", alias, "AS", src->alias)) {
+  if (!rdctx->addLocal("STDDEV_MERGE", status, "1", alias, "AS", src->alias)) {
     return REDISMODULE_ERR;
   }
   return REDISMODULE_OK;
@@ -335,6 +330,20 @@ static int distributeCountDistinctish(ReducerDistCtx *rdctx, QueryError *status)
   return REDISMODULE_OK;
 }
 
+/* Distribute COUNT_DISTINCT into COUNT_DISTINCT_SET and COUNT_DISTINCT_MERGE */
+static int distributeCountDistinct(ReducerDistCtx *rdctx, QueryError *status) {
+  PLN_Reducer *src = rdctx->srcReducer;
+  CHECK_ARG_COUNT(1);
+  const char *alias;
+  if (!rdctx->addRemote("COUNT_DISTINCT_SET", &alias, status, "1", rdctx->srcarg(0))) {
+    return REDISMODULE_ERR;
+  }
+  if (!rdctx->addLocal("COUNT_DISTINCT_MERGE", status, "1", alias, "AS", src->alias)) {
+    return REDISMODULE_ERR;
+  }
+  return REDISMODULE_OK;
+}
+
 static int distributeAvg(ReducerDistCtx *rdctx, QueryError *status) {
   PLN_Reducer *src = rdctx->srcReducer;
   PLN_GroupStep *local = rdctx->localGroup, *remote = rdctx->remoteGroup;
@@ -493,6 +502,7 @@ static struct {
     {"AVG", distributeAvg},
     {"TOLIST", distributeSingleArgSelf},
     {"STDDEV", distributeStdDev},
+    {"COUNT_DISTINCT", distributeCountDistinct},
     {"COUNT_DISTINCTISH", distributeCountDistinctish},
     {"QUANTILE", distributeQuantile},
     {"COLLECT", distributeCollect},
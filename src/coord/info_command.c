@@ -74,7 +74,8 @@ static InfoFieldSpec gcSpecs[] = {
     {.name = "average_cycle_time_ms", .type = InfoField_DoubleAverage},
     {.name = "last_run_time_ms", .type = InfoField_Max},
     {.name = "gc_numeric_trees_missed", .type = InfoField_WholeSum},
-    {.name = "gc_blocks_denied", .type = InfoField_WholeSum}};
+    {.name = "gc_blocks_denied", .type = InfoField_WholeSum},
+    {.name = "gc_blocks_merged", .type = InfoField_WholeSum}};
 
 static InfoFieldSpec cursorSpecs[] = {
     {.name = "global_idle", .type = InfoField_WholeSum},
@@ -84,6 +85,24 @@ static InfoFieldSpec cursorSpecs[] = {
     {.name = "index_total_internal", .type = InfoField_WholeSum},
 };
 
+static InfoFieldSpec queryCacheSpecs[] = {
+    {.name = "hits", .type = InfoField_WholeSum},
+    {.name = "misses", .type = InfoField_WholeSum},
+    {.name = "evictions", .type = InfoField_WholeSum},
+    {.name = "invalidations", .type = InfoField_WholeSum},
+    {.name = "entries", .type = InfoField_WholeSum},
+    {.name = "memory", .type = InfoField_WholeSum},
+};
+
+static InfoFieldSpec filterCacheSpecs[] = {
+    {.name = "hits", .type = InfoField_WholeSum},
+    {.name = "misses", .type = InfoField_WholeSum},
+    {.name = "evictions", .type = InfoField_WholeSum},
+    {.name = "invalidations", .type = InfoField_WholeSum},
+    {.name = "entries", .type = InfoField_WholeSum},
+    {.name = "memory", .type = InfoField_WholeSum},
+};
+
 static InfoFieldSpec dialectSpecs[] = {
     {.name = "dialect_1", .type = InfoField_Max},
     {.name = "dialect_2", .type = InfoField_Max},
@@ -95,6 +114,8 @@ static InfoFieldSpec dialectSpecs[] = {
 #define NUM_FIELDS_SPEC (ARRAY_SIZE(toplevelSpecs_g))
 #define NUM_GC_FIELDS_SPEC (ARRAY_SIZE(gcSpecs))
 #define NUM_CURSOR_FIELDS_SPEC (ARRAY_SIZE(cursorSpecs))
+#define NUM_QUERY_CACHE_FIELDS_SPEC (ARRAY_SIZE(queryCacheSpecs))
+#define NUM_FILTER_CACHE_FIELDS_SPEC (ARRAY_SIZE(filterCacheSpecs))
 #define NUM_DIALECT_FIELDS_SPEC (ARRAY_SIZE(dialectSpecs))
 
 // Variant value type
@@ -126,6 +147,8 @@ typedef struct {
   IndexError indexError;
   InfoValue gcValues[NUM_GC_FIELDS_SPEC];
   InfoValue cursorValues[NUM_CURSOR_FIELDS_SPEC];
+  InfoValue queryCacheValues[NUM_QUERY_CACHE_FIELDS_SPEC];
+  InfoValue filterCacheValues[NUM_FILTER_CACHE_FIELDS_SPEC];
   MRReply *stopWordList;
   InfoValue dialectValues[NUM_DIALECT_FIELDS_SPEC];
 } InfoFields;
@@ -280,6 +303,10 @@ static void handleSpecialField(InfoFields *fields, const char *name, MRReply *va
     recomputeAverageCycleTimeMs(fields->gcValues, gcSpecs, NUM_GC_FIELDS_SPEC);
   } else if (!strcmp(name, "cursor_stats")) {
     processKvArray(fields, value, fields->cursorValues, cursorSpecs, NUM_CURSOR_FIELDS_SPEC, 1, error);
+  } else if (!strcmp(name, "query_cache_stats")) {
+    processKvArray(fields, value, fields->queryCacheValues, queryCacheSpecs, NUM_QUERY_CACHE_FIELDS_SPEC, 1, error);
+  } else if (!strcmp(name, "filter_cache_stats")) {
+    processKvArray(fields, value, fields->filterCacheValues, filterCacheSpecs, NUM_FILTER_CACHE_FIELDS_SPEC, 1, error);
   } else if (!strcmp(name, "dialect_stats")) {
     processKvArray(fields, value, fields->dialectValues, dialectSpecs, NUM_DIALECT_FIELDS_SPEC, 1, error);
   } else if (!strcmp(name, "field statistics")) {
@@ -382,6 +409,14 @@ static void generateFieldsReply(InfoFields *fields, RedisModule_Reply *reply, bo
   replyKvArray(reply, fields, fields->cursorValues, cursorSpecs, NUM_CURSOR_FIELDS_SPEC);
   RedisModule_Reply_MapEnd(reply);
 
+  RedisModule_ReplyKV_Map(reply, "query_cache_stats");
+  replyKvArray(reply, fields, fields->queryCacheValues, queryCacheSpecs, NUM_QUERY_CACHE_FIELDS_SPEC);
+  RedisModule_Reply_MapEnd(reply);
+
+  RedisModule_ReplyKV_Map(reply, "filter_cache_stats");
+  replyKvArray(reply, fields, fields->filterCacheValues, filterCacheSpecs, NUM_FILTER_CACHE_FIELDS_SPEC);
+  RedisModule_Reply_MapEnd(reply);
+
   if (fields->stopWordList) {
     RedisModule_ReplyKV_MRReply(reply, "stopwords_list", fields->stopWordList);
   }
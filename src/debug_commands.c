@@ -31,6 +31,7 @@
 #include "geometry_index.h"
 #include "phonetic_manager.h"
 #include "gc.h"
+#include "index_snapshot.h"
 #include "module.h"
 #include "trie/trie.h"
 #include "triemap_ffi.h"
@@ -3665,6 +3666,37 @@ DEBUG_COMMAND(SetMaxIndexes) {
   return RedisModule_ReplyWithSimpleString(ctx, "OK");
 }
 
+/**
+ * FT.DEBUG CORRUPT_INDEX_CONTENTS <NONE|VERSION|FINGERPRINT|CHECKSUM|CONTENTS>
+ * Corrupt the index contents of the following RDB saves (for testing only),
+ * so that the load discards them and indexes the keys instead.
+ */
+DEBUG_COMMAND(CorruptIndexContents) {
+  if (!debugCommandsEnabled(ctx)) {
+    return RedisModule_ReplyWithError(ctx, NODEBUG_ERR);
+  }
+  if (argc != 3) {
+    return RedisModule_WrongArity(ctx);
+  }
+  const char *op = RedisModule_StringPtrLen(argv[2], NULL);
+  IndexSnapshotCorruption corruption;
+  if (!strcasecmp(op, "NONE")) {
+    corruption = IndexSnapshotCorrupt_None;
+  } else if (!strcasecmp(op, "VERSION")) {
+    corruption = IndexSnapshotCorrupt_Version;
+  } else if (!strcasecmp(op, "FINGERPRINT")) {
+    corruption = IndexSnapshotCorrupt_Fingerprint;
+  } else if (!strcasecmp(op, "CHECKSUM")) {
+    corruption = IndexSnapshotCorrupt_Checksum;
+  } else if (!strcasecmp(op, "CONTENTS")) {
+    corruption = IndexSnapshotCorrupt_Contents;
+  } else {
+    return RedisModule_ReplyWithError(ctx, "Invalid argument for 'CORRUPT_INDEX_CONTENTS'");
+  }
+  IndexSnapshot_SetDebugCorruption(corruption);
+  return RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
 DebugCommandType commands[] = {{"DUMP_INVIDX", DumpInvertedIndex}, // Print all the inverted index entries.
                                {"DUMP_NUMIDX", DumpNumericIndex}, // Print all the headers (optional) + entries of the numeric tree.
                                {"DUMP_NUMIDXTREE", DumpNumericIndexTree}, // Print tree general info, all leaves + nodes + stats
@@ -3716,6 +3748,7 @@ DebugCommandType commands[] = {{"DUMP_INVIDX", DumpInvertedIndex}, // Print all
                                {"DISK_IO_CONTROL", DiskIOControl},
                                {"REGISTER_TEST_SCORERS", RegisterTestScorers},
                                {"SET_MAX_INDEXES", SetMaxIndexes},
+                               {"CORRUPT_INDEX_CONTENTS", CorruptIndexContents},
                                /**
                                 * The following commands are for debugging distributed search/aggregation.
                                 */
@@ -39,6 +39,49 @@ DocTable NewDocTable(size_t cap, size_t max_size) {
   return ret;
 }
 
+// Mark `dmd` live in the columns, allocating its page if needed
+static void DocTable_ColumnsAdd(DocTable *t, const RSDocumentMetadata *dmd) {
+  DocTableColumns *c = &t->columns;
+  const size_t pageIndex = dmd->id / DOCTABLE_COLUMNS_PAGE_SIZE;
+  if (pageIndex >= c->numPages) {
+    size_t numPages = c->numPages ? c->numPages : 1;
+    while (numPages <= pageIndex) {
+      numPages *= 2;
+    }
+    c->pages = rm_realloc(c->pages, numPages * sizeof(*c->pages));
+    memset(c->pages + c->numPages, 0, (numPages - c->numPages) * sizeof(*c->pages));
+    c->memsize += (numPages - c->numPages) * sizeof(*c->pages);
+    c->numPages = numPages;
+  }
+  if (!c->pages[pageIndex]) {
+    c->pages[pageIndex] = rm_calloc(1, sizeof(DocTableColumnsPage));
+    c->memsize += sizeof(DocTableColumnsPage);
+  }
+  DocTableColumnsPage *page = c->pages[pageIndex];
+  const size_t slot = dmd->id % DOCTABLE_COLUMNS_PAGE_SIZE;
+  page->live[slot / 64] |= 1ULL << (slot % 64);
+  page->expirationTimeNs[slot] = dmd->expirationTimeNs;
+  page->numDocs++;
+}
+
+// Mark `docId` as not in the table, freeing its page once none of its documents is
+static void DocTable_ColumnsRemove(DocTable *t, t_docId docId) {
+  DocTableColumns *c = &t->columns;
+  const size_t pageIndex = docId / DOCTABLE_COLUMNS_PAGE_SIZE;
+  DocTableColumnsPage *page = pageIndex < c->numPages ? c->pages[pageIndex] : NULL;
+  if (!page) {
+    return;
+  }
+  const size_t slot = docId % DOCTABLE_COLUMNS_PAGE_SIZE;
+  page->live[slot / 64] &= ~(1ULL << (slot % 64));
+  page->expirationTimeNs[slot] = 0;
+  if (!--page->numDocs) {
+    rm_free(page);
+    c->pages[pageIndex] = NULL;
+    c->memsize -= sizeof(DocTableColumnsPage);
+  }
+}
+
 static inline uint32_t DocTable_GetBucket(const DocTable *t, t_docId docId) {
   return docId < t->maxSize ? docId : docId % t->maxSize;
 }
@@ -98,23 +141,12 @@ const RSDocumentMetadata *DocTable_Borrow(const DocTable *t, t_docId docId) {
 }
 
 bool DocTable_Exists(const DocTable *t, t_docId docId) {
-  if (!docId || docId > t->maxDocId) {
-    return false;
-  }
-  uint32_t ix = DocTable_GetBucket(t, docId);
-  if (ix >= t->cap) {
+  const size_t pageIndex = docId / DOCTABLE_COLUMNS_PAGE_SIZE;
+  if (pageIndex >= t->columns.numPages || !t->columns.pages[pageIndex]) {
     return false;
   }
-  const DMDChain *chain = t->buckets + ix;
-  if (chain == NULL) {
-    return false;
-  }
-  for (const RSDocumentMetadata *md = chain->root; md != NULL; md = md->nextInChain) {
-    if (md->id == docId) {
-      return !(md->flags & Document_Deleted);
-    }
-  }
-  return false;
+  const size_t slot = docId % DOCTABLE_COLUMNS_PAGE_SIZE;
+  return t->columns.pages[pageIndex]->live[slot / 64] & (1ULL << (slot % 64));
 }
 
 const RSDocumentMetadata *DocTable_BorrowByKeyR(const DocTable *t, RedisModuleString *s) {
@@ -159,6 +191,7 @@ static inline void DocTable_Set(DocTable *t, t_docId docId, RSDocumentMetadata *
   // Adding the dmd to the chain
   dmd->nextInChain = chain->root;
   chain->root = dmd;
+  DocTable_ColumnsAdd(t, dmd);
 }
 
 /** Get the docId of a key if it exists in the table, or 0 if it doesn't */
@@ -247,8 +280,14 @@ static inline int64_t expirationTimePointToNs(t_expirationTimePoint t) {
   return (int64_t)t.tv_sec * 1000000000LL + (int64_t)t.tv_nsec;
 }
 
-void DocTable_SetDocExpiration(RSDocumentMetadata *dmd, t_expirationTimePoint ttl) {
-  __atomic_store_n(&dmd->expirationTimeNs, expirationTimePointToNs(ttl), __ATOMIC_RELAXED);
+void DocTable_SetDocExpiration(DocTable *t, RSDocumentMetadata *dmd, t_expirationTimePoint ttl) {
+  const int64_t exp = expirationTimePointToNs(ttl);
+  __atomic_store_n(&dmd->expirationTimeNs, exp, __ATOMIC_RELAXED);
+  DocTableColumnsPage *page = t->columns.pages[dmd->id / DOCTABLE_COLUMNS_PAGE_SIZE];
+  __atomic_store_n(&page->expirationTimeNs[dmd->id % DOCTABLE_COLUMNS_PAGE_SIZE], exp, __ATOMIC_RELAXED);
+  if (exp) {
+    __atomic_store_n(&t->hasDocExpiration, true, __ATOMIC_RELAXED);
+  }
 }
 
 // Sets the doc-level TTL on the DMD and delegates the per-field entry to
@@ -257,7 +296,7 @@ void DocTable_SetDocExpiration(RSDocumentMetadata *dmd, t_expirationTimePoint tt
 // strictly an HFE store, which lets iterators use `t->ttl == NULL` as their
 // per-spec gate. Takes ownership of `sortedFieldWithExpiration`.
 void DocTable_UpdateExpiration(DocTable *t, RSDocumentMetadata* dmd, t_expirationTimePoint ttl, FieldExpirations sortedFieldWithExpiration) {
-  DocTable_SetDocExpiration(dmd, ttl);
+  DocTable_SetDocExpiration(t, dmd, ttl);
   DocTable_UpdateFieldExpiration(t, dmd, sortedFieldWithExpiration);
 }
 
@@ -298,7 +337,14 @@ void DocTable_ClearExpirationData(DocTable *t) {
   // simplest correct path. Caller holds the write lock (see header), but use
   // the relaxed atomic store to match the access pattern everywhere else.
   DOCTABLE_FOREACH(t, __atomic_store_n(&dmd->expirationTimeNs, 0, __ATOMIC_RELAXED));
+  for (size_t i = 0; i < t->columns.numPages; ++i) {
+    DocTableColumnsPage *page = t->columns.pages[i];
+    for (size_t slot = 0; page && slot < DOCTABLE_COLUMNS_PAGE_SIZE; ++slot) {
+      __atomic_store_n(&page->expirationTimeNs[slot], 0, __ATOMIC_RELAXED);
+    }
+  }
   TimeToLiveTable_Destroy(&t->ttl);
+  __atomic_store_n(&t->hasDocExpiration, false, __ATOMIC_RELAXED);
 }
 
 /* Put a new document into the table, assign it an incremental id and store the metadata in the
@@ -408,6 +454,10 @@ void DocTable_Free(DocTable *t) {
     }
   }
   rm_free(t->buckets);
+  for (size_t i = 0; i < t->columns.numPages; ++i) {
+    rm_free(t->columns.pages[i]);
+  }
+  rm_free(t->columns.pages);
   TimeToLiveTable_Destroy(&t->ttl);
   DocIdMap_Free(&t->dim);
 }
@@ -434,6 +484,7 @@ RSDocumentMetadata *DocTable_Pop(DocTable *t, const char *s, size_t n) {
     // Assuming we already locked the spec for write, and we don't have multiple writers,
     // all the next operations don't need to be atomic
     md->flags |= Document_Deleted;
+    DocTable_ColumnsRemove(t, docId);
 
     t->memsize -= sdsAllocSize(md->keyPtr);
     if (!hasPayload(md->flags)) {
@@ -66,6 +66,28 @@ typedef struct {
   RSDocumentMetadata *root;
 } DMDChain;
 
+// Number of consecutive document ids per page of the doc table columns
+#define DOCTABLE_COLUMNS_PAGE_SIZE 1024
+
+/* The state read to tell whether a document is live, for a page of consecutive document ids, one
+ * array per field. Lets the result processors skip deleted and expired documents without looking
+ * up their metadata in the hash chains. */
+typedef struct {
+  // Document-level expiration time in nanoseconds since the epoch (0 = none), as in the DMD
+  int64_t expirationTimeNs[DOCTABLE_COLUMNS_PAGE_SIZE];
+  // Bit `i % 64` of `live[i / 64]` is set if the i-th document of the page is in the table
+  uint64_t live[DOCTABLE_COLUMNS_PAGE_SIZE / 64];
+  uint32_t numDocs;  // Documents of the page in the table
+} DocTableColumnsPage;
+
+/* Pages of the doc table columns, indexed by document id. A page is only allocated while some of
+ * its documents are in the table. */
+typedef struct {
+  DocTableColumnsPage **pages;
+  size_t numPages;
+  size_t memsize;  // total memory size occupied by the pages
+} DocTableColumns;
+
 typedef struct {
   size_t size;
   t_docId maxSize;          // the maximum size this table is allowed to grow to
@@ -75,12 +97,16 @@ typedef struct {
   size_t sortablesSize;     // total memory size occupied by the sortables
 
   DMDChain *buckets;
+  DocTableColumns columns;  // Liveness of the documents, by id
   DocIdMap dim;             // Mapping between document name to internal id
   // Holds field-level expirations only; created lazily on the first HEXPIRE
   // and destroyed when the last entry is removed. Iterators use a NULL check
   // on this pointer as their HFE gate, so a NULL `ttl` means no doc in this
   // index has ever had (or still has) a field-level expiration.
   TimeToLiveTable* ttl;
+  // Set once a document of this index gets a document-level expiration, and
+  // cleared with the expiration data. Written and read with relaxed atomics.
+  bool hasDocExpiration;
 } DocTable;
 
 #define DOCTABLE_FOREACH(dt, code)                                           \
@@ -105,6 +131,23 @@ const RSDocumentMetadata *DocTable_Borrow(const DocTable *t, t_docId docId);
 
 const RSDocumentMetadata *DocTable_BorrowByKeyR(const DocTable *r, RedisModuleString *s);
 
+/* Is the document `docId` in the table, and not expired at `now`? Reads the columns only, so it is
+ * cheaper than borrowing the metadata to check it. Must be called with the index lock held */
+static inline bool DocTable_IsLive(const DocTable *t, t_docId docId, const struct timespec *now) {
+  const size_t pageIndex = docId / DOCTABLE_COLUMNS_PAGE_SIZE;
+  if (pageIndex >= t->columns.numPages || !t->columns.pages[pageIndex]) {
+    return false;
+  }
+  const DocTableColumnsPage *page = t->columns.pages[pageIndex];
+  const size_t slot = docId % DOCTABLE_COLUMNS_PAGE_SIZE;
+  if (!(page->live[slot / 64] & (1ULL << (slot % 64)))) {
+    return false;
+  }
+  // Relaxed atomic load, paired with the store in DocTable_SetDocExpiration
+  const int64_t exp = __atomic_load_n(&page->expirationTimeNs[slot], __ATOMIC_RELAXED);
+  return !exp || exp > (int64_t)now->tv_sec * 1000000000LL + (int64_t)now->tv_nsec;
+}
+
 /* Put a new document into the table, assign it an incremental id and store the metadata in the
  * table.
  *
@@ -137,13 +180,13 @@ void DocTable_SetByteOffsets(RSDocumentMetadata *dmd, RSByteOffsets *offsets);
 
 void DocTable_UpdateExpiration(DocTable *t, RSDocumentMetadata* dmd, t_expirationTimePoint ttl, FieldExpirations allFieldSorted);
 
-// Sets only the doc-level TTL on `dmd` (relaxed atomic store on
-// `expirationTimeNs`) without touching the per-field TTL table. Safe to call
-// under the spec read lock: the only mutation is the atomic store, paired
-// with the relaxed atomic load in DocTable_IsDocExpired. Used by the
-// EXPIRE/PERSIST keyspace-notification fast path, which must leave HFE
-// state intact.
-void DocTable_SetDocExpiration(RSDocumentMetadata *dmd, t_expirationTimePoint ttl);
+// Sets only the doc-level TTL on `dmd` and in the columns (relaxed atomic
+// stores on `expirationTimeNs`) without touching the per-field TTL table. Safe
+// to call under the spec read lock: the only mutations are the atomic stores,
+// paired with the relaxed atomic loads in DocTable_IsDocExpired and
+// DocTable_IsLive. Used by the EXPIRE/PERSIST keyspace-notification fast path,
+// which must leave HFE state intact.
+void DocTable_SetDocExpiration(DocTable *t, RSDocumentMetadata *dmd, t_expirationTimePoint ttl);
 
 // Replaces the per-field expiration entry for `dmd` without touching
 // `dmd->expirationTimeNs`. Takes ownership of `sortedFieldWithExpiration`:
@@ -165,7 +208,7 @@ static inline FieldExpirations DocTable_TakeFieldExpirations(FieldExpirations *s
 bool DocTable_IsDocExpired(DocTable* t, const RSDocumentMetadata* dmd, struct timespec* expirationPoint);
 
 // Clear all expiration data from this doc table.
-// Resets `expirationTimeNs` on every DMD and destroys the TTL table.
+// Resets `expirationTimeNs` on every DMD and in the columns, and destroys the TTL table.
 // Must be called with the index write lock held.
 void DocTable_ClearExpirationData(DocTable *t);
 
@@ -33,6 +33,7 @@
 #include "VecSim/vec_sim.h"
 #include "config.h"
 #include "doc_table.h"
+#include "filter_cache.h"
 #include "geo_ffi.h"
 #include "geo_index.h"
 #include "geometry/geometry_types.h"
@@ -58,6 +59,7 @@ static void *allocDocumentContext(void) {
   RSAddDocumentCtx *aCtx = rm_calloc(1, sizeof(*aCtx));
   aCtx->sv = RSSortingVector_Empty();
   aCtx->disk.openKey = NULL;
+  BlkAlloc_Init(&aCtx->arena);
   return aCtx;
 }
 
@@ -69,6 +71,7 @@ static void freeDocumentContext(void *p) {
 
   rm_free(aCtx->fspecs);
   rm_free(aCtx->fdatas);
+  BlkAlloc_FreeAll(&aCtx->arena, NULL, NULL, 0);
   if (aCtx->specName) {
     HiddenString_Free(aCtx->specName, true);
   }
@@ -335,7 +338,8 @@ void AddDocumentCtx_Free(RSAddDocumentCtx *aCtx) {
   for (size_t ii = 0; ii < aCtx->doc->numFields; ++ii) {
     if (FIELD_IS_VALID(aCtx, ii)) {
       if (FIELD_IS(aCtx->fspecs + ii, INDEXFLD_T_TAG) && aCtx->fdatas[ii].tags) {
-        TagIndex_FreePreprocessedData(aCtx->fdatas[ii].tags);
+        // The tags themselves live in the arena
+        array_free(aCtx->fdatas[ii].tags);
         aCtx->fdatas[ii].tags = NULL;
       } else if (FIELD_IS(aCtx->fspecs + ii, INDEXFLD_T_GEO) && aCtx->fdatas[ii].isMulti &&
                  aCtx->fdatas[ii].arrNumeric && !FIELD_IS_NULL(aCtx, ii)) {
@@ -376,6 +380,7 @@ void AddDocumentCtx_Free(RSAddDocumentCtx *aCtx) {
   SearchDisk_FreeWriteBatch(aCtx->disk.batch);
   aCtx->disk.batch = NULL;
 
+  BlkAlloc_Clear(&aCtx->arena, NULL, NULL, 0);
   mempool_release(actxPool_g, aCtx);
 }
 
@@ -817,7 +822,7 @@ FIELD_PREPROCESSOR(geoPreprocessor) {
 }
 
 FIELD_PREPROCESSOR(tagPreprocessor) {
-  if (TagIndex_Preprocess(fs, field, fdata)) {
+  if (TagIndex_PreprocessInArena(fs, field, fdata, &aCtx->arena)) {
     if (FieldSpec_IsSortable(fs)) {
       if (field->unionType != FLD_VAR_T_ARRAY) {
         size_t fl;
@@ -975,11 +980,16 @@ void IndexerBulkApply(RSAddDocumentCtx *aCtx, const DocumentField *field,
       case IXFLDPOS_FULLTEXT: break;
     }
   }
+  if (aCtx->spec->filterCache &&
+      (field->indexAs & (INDEXFLD_T_TAG | INDEXFLD_T_NUMERIC | INDEXFLD_T_GEO))) {
+    // The cached filters over the field may now miss the document
+    FilterCache_InvalidateField(aCtx->spec->filterCache, fs->index);
+  }
 }
 
-int Document_AddToIndexes(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx) {
+int AddDocumentCtx_Preprocess(RSAddDocumentCtx *aCtx, const FieldSpec **failedField) {
   Document *doc = aCtx->doc;
-  int ourRv = REDISMODULE_OK;
+  *failedField = NULL;
 
   for (size_t i = 0; i < doc->numFields; i++) {
     const FieldSpec *fs = aCtx->fspecs + i;
@@ -992,11 +1002,9 @@ int Document_AddToIndexes(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx) {
       }
 
       PreprocessorFunc pp = preprocessorMap[ii];
-      if (pp(aCtx, sctx, ff, fs, fdata, &aCtx->status) != 0) {
-        IndexError_AddQueryError(&aCtx->spec->stats.indexError, &aCtx->status, doc->docKey);
-        FieldSpec_AddQueryError(&aCtx->spec->fields[fs->index], &aCtx->status, doc->docKey);
-        ourRv = REDISMODULE_ERR;
-        goto cleanup;
+      if (pp(aCtx, NULL, ff, fs, fdata, &aCtx->status) != 0) {
+        *failedField = fs;
+        return REDISMODULE_ERR;
       }
       if (!(fs->options & FieldSpec_Dynamic)) {
         // Non-dynamic fields are only indexed as a single type.
@@ -1005,6 +1013,21 @@ int Document_AddToIndexes(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx) {
       }
     }
   }
+  return REDISMODULE_OK;
+}
+
+int AddDocumentCtx_ApplyPreprocessed(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx,
+                                     const FieldSpec *failedField) {
+  Document *doc = aCtx->doc;
+  int ourRv = REDISMODULE_OK;
+  aCtx->sctx = sctx;
+
+  if (failedField) {
+    IndexError_AddQueryError(&aCtx->spec->stats.indexError, &aCtx->status, doc->docKey);
+    FieldSpec_AddQueryError(&aCtx->spec->fields[failedField->index], &aCtx->status, doc->docKey);
+    ourRv = REDISMODULE_ERR;
+    goto cleanup;
+  }
 
   if (IndexDocument(aCtx) != 0) {
     ourRv = REDISMODULE_ERR;
@@ -1025,6 +1048,12 @@ cleanup:
   return ourRv;
 }
 
+int Document_AddToIndexes(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx) {
+  const FieldSpec *failedField;
+  AddDocumentCtx_Preprocess(aCtx, &failedField);
+  return AddDocumentCtx_ApplyPreprocessed(aCtx, sctx, failedField);
+}
+
 /* Evaluate an IF expression (e.g. IF "@foo == 'bar'") against a document, by getting the properties
  * from the sorting table or from the hash representation of the document.
  *
@@ -18,6 +18,7 @@
 #include "rmutil/args.h"
 #include "json.h"
 #include "ttl_table.h"
+#include "util/block_alloc.h"
 
 // Forward declaration of the C-side write-batch wrapper (defined in search_disk.h).
 // Forward-declared here to avoid pulling the entire disk-API surface into document.h.
@@ -319,6 +320,10 @@ typedef struct RSAddDocumentCtx {
 
   // Scratch space used by per-type field preprocessors (see the source)
   struct FieldIndexerData *fdatas;
+  // Bump allocator of the document's transient data (e.g. the preprocessed tags).
+  // Cleared at once when the context is freed, keeping its blocks for the next
+  // document indexed with this pooled context.
+  BlkAlloc arena;
   QueryError status;     // Error message is placed here if there is an error during processing
   uint32_t totalTokens;  // Number of tokens, used for offset vector
   uint32_t specFlags;    // Cached index flags
@@ -379,6 +384,23 @@ void AddDocumentCtx_Finish(RSAddDocumentCtx *aCtx);
  */
 int Document_AddToIndexes(RSAddDocumentCtx *ctx, RedisSearchCtx *sctx);
 
+/**
+ * The first half of Document_AddToIndexes: run the field preprocessors - tokenization,
+ * tag splitting, numeric and geo parsing - without touching the index. Safe to call
+ * without the GIL and without the spec lock, once the document owns its strings.
+ *
+ * On failure, sets the context status and `*failedField`, and returns REDISMODULE_ERR.
+ */
+int AddDocumentCtx_Preprocess(RSAddDocumentCtx *aCtx, const FieldSpec **failedField);
+
+/**
+ * The second half of Document_AddToIndexes: write a document preprocessed by
+ * AddDocumentCtx_Preprocess to the index, or report its preprocessing failure on
+ * `failedField`. Called with the GIL and the spec write lock held.
+ */
+int AddDocumentCtx_ApplyPreprocessed(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx,
+                                     const FieldSpec *failedField);
+
 /**
  * Free the AddDocumentCtx. Should be done once AddToIndexes() completes; or
  * when the client is unblocked.
@@ -23,6 +23,7 @@
 #include "tokenize.h"
 #include "rmutil/vector.h"
 #include "stemmer.h"
+#include "stem_cache.h"
 #include "phonetic_manager.h"
 #include "score_explain.h"
 #include "ext/default.h"
@@ -569,16 +570,14 @@ int StemmerExpander(RSQueryExpanderCtx *ctx, RSToken *token) {
     return REDISMODULE_OK;
   }
 
-  const sb_symbol *b = (const sb_symbol *)token->str;
-  const sb_symbol *stemmed = sb_stemmer_stem(sb, b, token->len);
+  // The stem is written after the + prefix given to stems
+  char *dup = NULL;
+  size_t cap = 0;
+  ssize_t sl = StemCache_Stem(sb, ctx->language, token->str, token->len, &dup, &cap, 1);
 
-  if (stemmed) {
-    int sl = sb_stemmer_length(sb);
-
-    // Make a copy of the stemmed buffer with the + prefix given to stems
-    char *dup = rm_malloc(sl + 2);
+  if (sl >= 0) {
     dup[0] = STEM_PREFIX;
-    memcpy(dup + 1, stemmed, sl + 1);
+    const char *stemmed = dup + 1;
 
     // Get fieldMask which includes only expandable fields
     QueryNode *qn = *ctx->currentNode;
@@ -613,9 +612,14 @@ int StemmerExpander(RSQueryExpanderCtx *ctx, RSToken *token) {
     // Add expanded nodes with corresponding field mask
     qn = *ctx->currentNode;
     qn->opts.fieldMask = expandable_fm;
+    // The expansion owns the prefixed stem
+    char *unprefixed = NULL;
+    if ((size_t)sl != token->len || strncmp(stemmed, token->str, token->len)) {
+      unprefixed = rm_strndup(stemmed, sl);
+    }
     ctx->ExpandToken(ctx, dup, sl + 1, 0x0);  // TODO: Set proper flags here
-    if (sl != token->len || strncmp((const char *)stemmed, token->str, token->len)) {
-      ctx->ExpandToken(ctx, rm_strndup((const char *)stemmed, sl), sl, 0x0);
+    if (unprefixed) {
+      ctx->ExpandToken(ctx, unprefixed, sl, 0x0);
     }
     // Restore field mask of UNION node
     qn->opts.fieldMask = orig_fm;
@@ -73,6 +73,7 @@ typedef enum {
   FieldSpec_UndefinedOrder = 0x80,
   FieldSpec_IndexEmpty = 0x100,       // Index empty values (i.e., empty strings)
   FieldSpec_IndexMissing = 0x200,     // Index missing values (non-existing field)
+  FieldSpec_WithNgrams = 0x400,       // Index the trigrams of the terms (TEXT)
 } FieldSpecOptions;
 
 RS_ENUM_BITWISE_HELPER(FieldSpecOptions)
@@ -158,6 +159,7 @@ typedef struct FieldSpec {
 #define FieldSpec_IsIndexable(fs) (0 == ((fs)->options & FieldSpec_NotIndexable))
 #define FieldSpec_IsIndexableText(fs) (FIELD_IS((fs), INDEXFLD_T_FULLTEXT) && FieldSpec_IsIndexable(fs))
 #define FieldSpec_HasSuffixTrie(fs) ((fs)->options & FieldSpec_WithSuffixTrie)
+#define FieldSpec_HasNgrams(fs) ((fs)->options & FieldSpec_WithNgrams)
 #define FieldSpec_IsUndefinedOrder(fs) ((fs)->options & FieldSpec_UndefinedOrder)
 #define FieldSpec_IndexesEmpty(fs) ((fs)->options & FieldSpec_IndexEmpty)
 #define FieldSpec_IndexesMissing(fs) ((fs)->options & FieldSpec_IndexMissing)
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "filter_cache.h"
+
+#include <pthread.h>
+
+#include "rmalloc.h"
+#include "fnv_ffi.h"
+#include "varint_ffi.h"
+#include "buffer/buffer.h"
+#include "util/arr/arr.h"
+#include "util/khash.h"
+#include "util/dllist.h"
+
+// Maximum number of distinct filters counted while waiting for admission.
+// The counts are reset when it is reached, so that one-off filters cannot grow them forever
+#define FILTER_CACHE_MAX_CANDIDATES 4096
+
+typedef struct {
+  DLLIST_node llnode;  // position in the LRU list, most recently used first
+  uint64_t hash;
+  sds key;
+  t_fieldIndex field;
+  uint64_t generation; // generation of `field` when the entry was filled
+  Buffer ids;          // deltas between the sorted document ids, as varints
+  size_t numIds;
+  size_t memory;
+} FilterCacheEntry;
+
+KHASH_MAP_INIT_INT64(filterCache, FilterCacheEntry *);
+KHASH_MAP_INIT_INT64(filterCandidates, uint32_t);
+
+struct FilterCache {
+  pthread_mutex_t lock;
+  khash_t(filterCache) *entries;
+  // Number of lookups of the filters that are not cached yet, by key hash
+  khash_t(filterCandidates) *candidates;
+  // Write generation of each field, by field index
+  arrayof(uint64_t) generations;
+  DLLIST lru;
+  size_t memory;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+  size_t invalidations;
+};
+
+static inline uint64_t keyHash(const sds key) {
+  return fnv_64a_buf(key, sdslen(key), 0);
+}
+
+// Called with the lock held
+static inline uint64_t fieldGeneration(const FilterCache *fc, t_fieldIndex field) {
+  return field < array_len(fc->generations) ? fc->generations[field] : 0;
+}
+
+static void entryFree(FilterCacheEntry *e) {
+  sdsfree(e->key);
+  Buffer_Free(&e->ids);
+  rm_free(e);
+}
+
+// Unlink the entry at `it` and free it. Called with the lock held
+static void removeEntry(FilterCache *fc, khiter_t it) {
+  FilterCacheEntry *e = kh_val(fc->entries, it);
+  kh_del(filterCache, fc->entries, it);
+  dllist_delete(&e->llnode);
+  fc->memory -= e->memory;
+  entryFree(e);
+}
+
+FilterCache *FilterCache_New(void) {
+  FilterCache *fc = rm_calloc(1, sizeof(*fc));
+  pthread_mutex_init(&fc->lock, NULL);
+  fc->entries = kh_init(filterCache);
+  fc->candidates = kh_init(filterCandidates);
+  fc->generations = array_new(uint64_t, 0);
+  dllist_init(&fc->lru);
+  return fc;
+}
+
+void FilterCache_Clear(FilterCache *fc) {
+  pthread_mutex_lock(&fc->lock);
+  FilterCacheEntry *e;
+  kh_foreach_value(fc->entries, e, entryFree(e));
+  kh_clear(filterCache, fc->entries);
+  kh_clear(filterCandidates, fc->candidates);
+  dllist_init(&fc->lru);
+  fc->memory = 0;
+  pthread_mutex_unlock(&fc->lock);
+}
+
+void FilterCache_Free(FilterCache *fc) {
+  FilterCache_Clear(fc);
+  kh_destroy(filterCache, fc->entries);
+  kh_destroy(filterCandidates, fc->candidates);
+  array_free(fc->generations);
+  pthread_mutex_destroy(&fc->lock);
+  rm_free(fc);
+}
+
+static t_docId *decodeIds(const FilterCacheEntry *e) {
+  if (!e->numIds) {
+    return NULL;
+  }
+  t_docId *ids = rm_malloc(e->numIds * sizeof(*ids));
+  BufferReader br = NewBufferReader((Buffer *)&e->ids);
+  t_docId id = 0;
+  for (size_t ii = 0; ii < e->numIds; ++ii) {
+    id += ReadVarint(&br);
+    ids[ii] = id;
+  }
+  return ids;
+}
+
+// Count a lookup of a filter that is not cached. Called with the lock held
+static FilterCacheLookup countCandidate(FilterCache *fc, uint64_t hash) {
+  if (kh_size(fc->candidates) >= FILTER_CACHE_MAX_CANDIDATES) {
+    kh_clear(filterCandidates, fc->candidates);
+  }
+  int absent;
+  khiter_t it = kh_put(filterCandidates, fc->candidates, hash, &absent);
+  if (absent) {
+    kh_val(fc->candidates, it) = 0;
+  }
+  if (++kh_val(fc->candidates, it) < FILTER_CACHE_ADMIT_AFTER) {
+    return FilterCache_Miss;
+  }
+  kh_del(filterCandidates, fc->candidates, it);
+  return FilterCache_Admit;
+}
+
+FilterCacheLookup FilterCache_Get(FilterCache *fc, const sds key, t_fieldIndex field,
+                                  t_docId **ids, size_t *len) {
+  const uint64_t hash = keyHash(key);
+  FilterCacheLookup rc = FilterCache_Miss;
+
+  pthread_mutex_lock(&fc->lock);
+  khiter_t it = kh_get(filterCache, fc->entries, hash);
+  if (it != kh_end(fc->entries)) {
+    FilterCacheEntry *e = kh_val(fc->entries, it);
+    if (e->generation != fieldGeneration(fc, e->field)) {
+      // The field was written to since the entry was filled
+      removeEntry(fc, it);
+      fc->invalidations++;
+    } else if (e->field == field && sdslen(e->key) == sdslen(key) &&
+               !memcmp(e->key, key, sdslen(key))) {
+      dllist_delete(&e->llnode);
+      dllist_prepend(&fc->lru, &e->llnode);
+      *ids = decodeIds(e);
+      *len = e->numIds;
+      rc = FilterCache_Hit;
+    }
+  }
+  if (rc == FilterCache_Hit) {
+    fc->hits++;
+  } else {
+    fc->misses++;
+    rc = countCandidate(fc, hash);
+  }
+  pthread_mutex_unlock(&fc->lock);
+  return rc;
+}
+
+void FilterCache_Put(FilterCache *fc, sds key, t_fieldIndex field, const t_docId *ids, size_t len,
+                     size_t maxMemory) {
+  FilterCacheEntry *e = rm_malloc(sizeof(*e));
+  e->hash = keyHash(key);
+  e->key = key;
+  e->field = field;
+  e->numIds = len;
+  Buffer_Init(&e->ids, len ? len : 1);
+
+  BufferWriter bw = NewBufferWriter(&e->ids);
+  t_docId last = 0;
+  for (size_t ii = 0; ii < len; ++ii) {
+    const t_docId delta = ids[ii] - last;
+    if (delta > UINT32_MAX) {
+      // Not representable as a varint delta, which a real index never comes close to
+      entryFree(e);
+      return;
+    }
+    WriteVarint(delta, &bw);
+    last = ids[ii];
+  }
+  if (e->ids.offset && e->ids.offset < e->ids.cap) {
+    e->ids.data = rm_realloc(e->ids.data, e->ids.offset);
+    e->ids.cap = e->ids.offset;
+  }
+  e->memory = sizeof(*e) + sdsAllocSize(key) + e->ids.cap;
+
+  if (e->memory > maxMemory) {
+    entryFree(e);
+    return;
+  }
+
+  pthread_mutex_lock(&fc->lock);
+  e->generation = fieldGeneration(fc, field);
+  khiter_t it = kh_get(filterCache, fc->entries, e->hash);
+  if (it != kh_end(fc->entries)) {
+    removeEntry(fc, it);
+  }
+
+  while (fc->memory + e->memory > maxMemory) {
+    FilterCacheEntry *lru = DLLIST_ITEM(fc->lru.prev, FilterCacheEntry, llnode);
+    removeEntry(fc, kh_get(filterCache, fc->entries, lru->hash));
+    fc->evictions++;
+  }
+
+  int absent;
+  it = kh_put(filterCache, fc->entries, e->hash, &absent);
+  kh_val(fc->entries, it) = e;
+  dllist_prepend(&fc->lru, &e->llnode);
+  fc->memory += e->memory;
+  pthread_mutex_unlock(&fc->lock);
+}
+
+void FilterCache_InvalidateField(FilterCache *fc, t_fieldIndex field) {
+  pthread_mutex_lock(&fc->lock);
+  while (array_len(fc->generations) <= field) {
+    array_append(fc->generations, 0);
+  }
+  fc->generations[field]++;
+  pthread_mutex_unlock(&fc->lock);
+}
+
+FilterCacheStats FilterCache_GetStats(FilterCache *fc) {
+  pthread_mutex_lock(&fc->lock);
+  FilterCacheStats stats = {
+    .hits = fc->hits,
+    .misses = fc->misses,
+    .evictions = fc->evictions,
+    .invalidations = fc->invalidations,
+    .entries = kh_size(fc->entries),
+    .memory = fc->memory,
+  };
+  pthread_mutex_unlock(&fc->lock);
+  return stats;
+}
+
+void FilterCache_RenderStats(FilterCache *fc, RedisModule_Reply *reply) {
+  FilterCacheStats stats = {0};
+  if (fc) {
+    stats = FilterCache_GetStats(fc);
+  }
+
+  RedisModule_ReplyKV_Map(reply, "filter_cache_stats");
+
+    RedisModule_ReplyKV_LongLong(reply, "hits", stats.hits);
+    RedisModule_ReplyKV_LongLong(reply, "misses", stats.misses);
+    RedisModule_ReplyKV_LongLong(reply, "evictions", stats.evictions);
+    RedisModule_ReplyKV_LongLong(reply, "invalidations", stats.invalidations);
+    RedisModule_ReplyKV_LongLong(reply, "entries", stats.entries);
+    RedisModule_ReplyKV_LongLong(reply, "memory", stats.memory);
+
+  RedisModule_Reply_MapEnd(reply);
+}
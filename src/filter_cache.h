@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "redisearch.h"
+#include "reply.h"
+#include "hiredis/sds.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Per-index cache of the documents matching tag, numeric and geo filter clauses.
+ *
+ * Entries are keyed by a canonical form of the filter query node, and hold the
+ * sorted ids of its matching documents, delta encoded as varints. A filter is
+ * only materialized once it was seen FILTER_CACHE_ADMIT_AFTER times, so that
+ * one-off filters never pay for it.
+ *
+ * Each entry is tagged with the generation of the field it filters on. The
+ * indexer bumps the generation of every field it writes to, invalidating only
+ * the entries built from that field. Deleted documents are not invalidated:
+ * like with the inverted indexes, they are skipped when the results are loaded.
+ *
+ * The least recently used entries are evicted to keep the cache under its
+ * memory cap. Safe to use from any thread.
+ */
+typedef struct FilterCache FilterCache;
+
+// Number of times a filter is looked up before its matching documents are cached
+#define FILTER_CACHE_ADMIT_AFTER 2
+
+typedef struct {
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+  size_t invalidations;
+  size_t entries;
+  size_t memory;
+} FilterCacheStats;
+
+typedef enum {
+  // `ids` is set to the cached documents of the filter
+  FilterCache_Hit,
+  // The filter is not cached
+  FilterCache_Miss,
+  // The filter is not cached, but was seen often enough to be: call FilterCache_Put
+  FilterCache_Admit,
+} FilterCacheLookup;
+
+FilterCache *FilterCache_New(void);
+void FilterCache_Free(FilterCache *fc);
+
+/**
+ * Look up the documents of the filter `key` over the field `field`. On a hit,
+ * `*ids` is set to a newly allocated, sorted array of `*len` document ids,
+ * owned by the caller. Counts a hit or a miss.
+ * Must be called with the index read lock held.
+ */
+FilterCacheLookup FilterCache_Get(FilterCache *fc, const sds key, t_fieldIndex field,
+                                  t_docId **ids, size_t *len);
+
+/**
+ * Cache the `len` sorted document ids `ids` matching the filter `key` over the
+ * field `field`, evicting the least recently used entries until the cache holds
+ * at most `maxMemory` bytes. Takes ownership of `key`, `ids` is copied.
+ * Must be called with the index read lock held since the documents were read.
+ */
+void FilterCache_Put(FilterCache *fc, sds key, t_fieldIndex field, const t_docId *ids, size_t len,
+                     size_t maxMemory);
+
+/** Invalidate the entries filtering on `field`. Called by the indexer when it writes to the field */
+void FilterCache_InvalidateField(FilterCache *fc, t_fieldIndex field);
+
+/** Drop all the entries */
+void FilterCache_Clear(FilterCache *fc);
+
+FilterCacheStats FilterCache_GetStats(FilterCache *fc);
+
+/** Reply with the cache statistics, as the `filter_cache_stats` map of FT.INFO. `fc` may be NULL */
+void FilterCache_RenderStats(FilterCache *fc, RedisModule_Reply *reply);
+
+#ifdef __cplusplus
+}
+#endif
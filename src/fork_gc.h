@@ -37,6 +37,8 @@ typedef struct {
 
   uint64_t gcNumericNodesMissed;
   uint64_t gcBlocksDenied;
+  // number of sparse inverted index blocks merged into their neighbours
+  uint64_t gcBlocksMerged;
 } ForkGCStats;
 
 // Optional hook for tests. beforeApply is called in the parent after fork(),
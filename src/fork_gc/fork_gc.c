@@ -350,6 +350,7 @@ static void statsCb(RedisModule_Reply *reply, void *gcCtx) {
   REPLY_KVNUM("last_run_time_ms", (double)gc->stats.lastRunTimeMs);
   REPLY_KVNUM("gc_numeric_trees_missed", (double)gc->stats.gcNumericNodesMissed);
   REPLY_KVNUM("gc_blocks_denied", (double)gc->stats.gcBlocksDenied);
+  REPLY_KVNUM("gc_blocks_merged", (double)gc->stats.gcBlocksMerged);
 }
 
 static void statsForInfoCb(RedisModuleInfoCtx *ctx, void *gcCtx) {
@@ -362,6 +363,7 @@ static void statsForInfoCb(RedisModuleInfoCtx *ctx, void *gcCtx) {
   RedisModule_InfoAddFieldDouble(ctx, "last_run_time_ms", (double)gc->stats.lastRunTimeMs);
   RedisModule_InfoAddFieldDouble(ctx, "gc_numeric_trees_missed", (double)gc->stats.gcNumericNodesMissed);
   RedisModule_InfoAddFieldDouble(ctx, "gc_blocks_denied", (double)gc->stats.gcBlocksDenied);
+  RedisModule_InfoAddFieldDouble(ctx, "gc_blocks_merged", (double)gc->stats.gcBlocksMerged);
   RedisModule_InfoEndDictField(ctx);
 }
 
@@ -14,13 +14,14 @@
 // Assumes the spec is locked.
 void FGC_updateStats(ForkGC *gc, RedisSearchCtx *sctx,
                      size_t recordsRemoved, size_t bytesCollected,
-                     size_t bytesAdded, bool ignoredLastBlock) {
+                     size_t bytesAdded, size_t blocksMerged, bool ignoredLastBlock) {
   sctx->spec->stats.numRecords -= recordsRemoved;
   sctx->spec->stats.invertedSize += bytesAdded;
   sctx->spec->stats.invertedSize -= bytesCollected;
   gc->stats.totalCollected += bytesCollected;
   gc->stats.totalCollected -= bytesAdded;
   gc->stats.gcBlocksDenied += ignoredLastBlock ? 1 : 0;
+  gc->stats.gcBlocksMerged += blocksMerged;
 }
 
 // glue to use process pipe as writer for II GC delta info
@@ -57,7 +57,7 @@ void sendHeaderString(void *ptrCtx);
 // Update index and GC stats after applying a delta.
 void FGC_updateStats(ForkGC *gc, RedisSearchCtx *sctx,
                      size_t recordsRemoved, size_t bytesCollected,
-                     size_t bytesAdded, bool ignoredLastBlock);
+                     size_t bytesAdded, size_t blocksMerged, bool ignoredLastBlock);
 
 //------------------------------------------------------------------------------
 // Per-index-kind child collectors and parent handlers
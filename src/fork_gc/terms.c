@@ -138,9 +138,13 @@ FGCError FGC_parentHandleTerms(ForkGC *gc) {
     if (sctx->spec->suffix && len) {
       deleteSuffixTrie(sctx->spec->suffix, term, len);
     }
+    if (sctx->spec->ngrams && len) {
+      NgramIndex_Delete(sctx->spec->ngrams, term, len);
+    }
   }
 
-  FGC_updateStats(gc, sctx, info.entries_removed, info.bytes_freed, info.bytes_allocated, info.ignored_last_block);
+  FGC_updateStats(gc, sctx, info.entries_removed, info.bytes_freed, info.bytes_allocated,
+                  info.blocks_merged, info.ignored_last_block);
 
 cleanup:
 
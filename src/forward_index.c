@@ -202,6 +202,7 @@ static void ForwardIndex_HandleToken(ForwardIndex *idx, const char *tok, size_t
 
     h->len = tokLen;
     h->freq = 0;
+    h->docLen = 0;
     h->staged = false;
 
     if (hasOffsets(idx)) {
@@ -310,7 +311,7 @@ AddRecordOutcome InvertedIndex_WriteForwardIndexEntry(InvertedIndex *idx, Forwar
     rec.data.term.borrowed.offsets.data = (uint8_t *)VVW_GetByteData(ent->vw);
     rec.data.term.borrowed.offsets.len = VVW_GetByteLength(ent->vw);
   }
-  return InvertedIndex_WriteEntryGeneric(idx, &rec);
+  return InvertedIndex_WriteScoredEntry(idx, &rec, ent->docLen);
 }
 
 ForwardIndexEntry *ForwardIndex_Find(ForwardIndex *i, const char *s, size_t n, uint32_t hash) {
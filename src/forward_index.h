@@ -27,6 +27,8 @@ typedef struct ForwardIndexEntry {
   t_docId docId;
 
   uint32_t freq;
+  // Length of the document, in terms, set together with `docId`.
+  uint32_t docLen;
   t_fieldMask fieldMask;
 
   const char *term;
@@ -0,0 +1,980 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "index_snapshot.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "spec.h"
+#include "config.h"
+#include "doc_table.h"
+#include "byte_offsets.h"
+#include "tag_index.h"
+#include "suffix.h"
+#include "stemmer.h"
+#include "phonetic_manager.h"
+#include "synonym_map.h"
+#include "numeric_filter.h"
+#include "redis_index.h"
+#include "search_ctx.h"
+#include "indexing_pipeline.h"
+#include "rdb.h"
+#include "rmalloc.h"
+#include "fnv_ffi.h"
+#include "iterators_ffi.h"
+#include "numeric_range_tree_ffi.h"
+#include "inverted_index_ffi.h"
+#include "types_ffi.h"
+#include "sorting_vector_ffi.h"
+#include "value_ffi.h"
+#include "triemap_ffi.h"
+#include "metrics_ffi.h"
+#include "trie/trie.h"
+#include "trie/rune_util.h"
+#include "buffer/buffer.h"
+#include "util/arr.h"
+#include "rmutil/rm_assert.h"
+
+// Bumped on any change to the layout below. Contents of another version are discarded
+#define SNAPSHOT_FORMAT_VERSION 1
+
+#define SNAPSHOT_NONE 0
+#define SNAPSHOT_CONTENTS 1
+
+#define SNAPSHOT_OK 0
+#define SNAPSHOT_ABORTED 1
+
+// The contents are saved in string chunks of about this size
+#define SNAPSHOT_CHUNK_SIZE (1 << 20)
+
+#define SNAPSHOT_FIELD_TYPES \
+  (INDEXFLD_T_FULLTEXT | INDEXFLD_T_NUMERIC | INDEXFLD_T_GEO | INDEXFLD_T_TAG)
+
+struct IndexSnapshotRestore {
+  // The highest restored document id
+  t_docId maxDocId;
+  // Restored documents whose keys were loaded, by id
+  uint64_t *loaded;
+};
+
+/******************************************************************************
+ * Encoding
+ ******************************************************************************/
+
+typedef struct {
+  RedisModuleIO *rdb;
+  Buffer buf;
+  uint64_t checksum;
+  bool aborted;
+} SnapshotWriter;
+
+static void writer_Flush(SnapshotWriter *w) {
+  if (w->buf.offset) {
+    w->checksum = fnv_64a_buf(w->buf.data, w->buf.offset, w->checksum);
+    RedisModule_SaveStringBuffer(w->rdb, w->buf.data, w->buf.offset);
+    w->buf.offset = 0;
+  }
+}
+
+static void writer_Bytes(SnapshotWriter *w, const void *data, size_t len) {
+  BufferWriter bw = NewBufferWriter(&w->buf);
+  Buffer_Write(&bw, data, len);
+  if (w->buf.offset >= SNAPSHOT_CHUNK_SIZE) {
+    writer_Flush(w);
+  }
+}
+
+static void writer_Varint(SnapshotWriter *w, uint64_t v) {
+  uint8_t out[10];
+  size_t n = 0;
+  do {
+    out[n] = v & 0x7f;
+    v >>= 7;
+    out[n++] |= v ? 0x80 : 0;
+  } while (v);
+  writer_Bytes(w, out, n);
+}
+
+static void writer_FieldMask(SnapshotWriter *w, t_fieldMask mask) {
+  writer_Varint(w, (uint64_t)mask);
+#if UINTPTR_MAX == UINT64_MAX
+  writer_Varint(w, (uint64_t)(mask >> 64));
+#endif
+}
+
+static void writer_Double(SnapshotWriter *w, double d) {
+  writer_Bytes(w, &d, sizeof(d));
+}
+
+static void writer_String(SnapshotWriter *w, const char *s, size_t len) {
+  writer_Varint(w, len);
+  writer_Bytes(w, s, len);
+}
+
+typedef struct {
+  const char *pos;
+  const char *end;
+  bool error;
+} SnapshotReader;
+
+static bool reader_Bytes(SnapshotReader *r, void *data, size_t len) {
+  if (r->error || (size_t)(r->end - r->pos) < len) {
+    r->error = true;
+    return false;
+  }
+  memcpy(data, r->pos, len);
+  r->pos += len;
+  return true;
+}
+
+static uint64_t reader_Varint(SnapshotReader *r) {
+  uint64_t v = 0;
+  for (unsigned shift = 0; shift < 64 && !r->error; shift += 7) {
+    if (r->pos == r->end) {
+      break;
+    }
+    uint8_t b = *r->pos++;
+    v |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      return v;
+    }
+  }
+  r->error = true;
+  return 0;
+}
+
+static t_fieldMask reader_FieldMask(SnapshotReader *r) {
+  t_fieldMask mask = reader_Varint(r);
+#if UINTPTR_MAX == UINT64_MAX
+  mask |= (t_fieldMask)reader_Varint(r) << 64;
+#endif
+  return mask;
+}
+
+static double reader_Double(SnapshotReader *r) {
+  double d = 0;
+  reader_Bytes(r, &d, sizeof(d));
+  return d;
+}
+
+// Returns a pointer into the snapshot, valid while it is loaded
+static const char *reader_String(SnapshotReader *r, size_t *len) {
+  *len = reader_Varint(r);
+  if (r->error || (size_t)(r->end - r->pos) < *len) {
+    r->error = true;
+    *len = 0;
+    return NULL;
+  }
+  const char *s = r->pos;
+  r->pos += *len;
+  return s;
+}
+
+// A count of entries, each taking at least one byte
+static size_t reader_Count(SnapshotReader *r) {
+  uint64_t n = reader_Varint(r);
+  if (n > (uint64_t)(r->end - r->pos)) {
+    r->error = true;
+    return 0;
+  }
+  return n;
+}
+
+/******************************************************************************
+ * Schema guard
+ ******************************************************************************/
+
+static bool specSupportsSnapshot(const IndexSpec *sp) {
+  if (!RSGlobalConfig.persistIndexContents || sp->diskSpec || sp->docs.ttl ||
+      IndexingPipeline_HasPending(sp)) {
+    return false;
+  }
+  for (size_t i = 0; i < sp->numFields; ++i) {
+    if (sp->fields[i].types & ~SNAPSHOT_FIELD_TYPES) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#define FINGERPRINT(h, v)              \
+  ({                                     \
+    __typeof__(v) v_ = (v);              \
+    h = fnv_64a_buf(&v_, sizeof(v_), h); \
+  })
+
+// Everything the layout of the contents depends on
+static uint64_t schemaFingerprint(const IndexSpec *sp) {
+  uint64_t h = 0;
+  FINGERPRINT(h, (uint64_t)sp->flags);
+  FINGERPRINT(h, (uint64_t)sizeof(t_fieldMask));
+  FINGERPRINT(h, (uint64_t)sp->numFields);
+  for (size_t i = 0; i < sp->numFields; ++i) {
+    const FieldSpec *fs = sp->fields + i;
+    size_t len = 0;
+    const char *name = HiddenString_GetUnsafe(fs->fieldName, &len);
+    h = fnv_64a_buf(name, len, h);
+    FINGERPRINT(h, (uint32_t)fs->types);
+    FINGERPRINT(h, (uint32_t)fs->options);
+    FINGERPRINT(h, (int32_t)fs->sortIdx);
+    FINGERPRINT(h, (uint32_t)fs->ftId);
+    if (FIELD_IS(fs, INDEXFLD_T_TAG)) {
+      FINGERPRINT(h, (uint32_t)fs->tagOpts.tagFlags);
+    }
+  }
+  return h;
+}
+
+/******************************************************************************
+ * Save
+ ******************************************************************************/
+
+// Runs `code` for each entry `res` of `idx`
+#define FOREACH_INDEX_RESULT(idx, res, code)                                                 \
+  do {                                                                                       \
+    IndexDecoderCtx decoderCtx_ = {.fieldmask_tag = IndexDecoderCtx_FieldMask,              \
+                                   .fieldmask = RS_FIELDMASK_ALL};                          \
+    IndexReader *reader_ = NewIndexReader((idx), decoderCtx_);                               \
+    RSIndexResult *res = NewTokenRecord(NULL, 1);                                            \
+    while (IndexReader_Next(reader_, res)) {                                                 \
+      code;                                                                                  \
+    }                                                                                        \
+    IndexResult_Free(res);                                                                   \
+    IndexReader_Free(reader_);                                                               \
+  } while (0)
+
+// Lists of entries by document are written by increasing id, as deltas ended by a zero.
+// The entries of deleted documents the GC did not remove yet are skipped
+static void saveDocIds(SnapshotWriter *w, const IndexSpec *sp, const InvertedIndex *idx) {
+  t_docId last = 0;
+  if (idx) {
+    FOREACH_INDEX_RESULT(idx, res, {
+      if (DocTable_Exists(&sp->docs, res->docId)) {
+        writer_Varint(w, res->docId - last);
+        last = res->docId;
+      }
+    });
+  }
+  writer_Varint(w, 0);
+}
+
+static void saveSortingVector(SnapshotWriter *w, const RSSortingVector *sv) {
+  const size_t len = RSSortingVector_Length(sv);
+  writer_Varint(w, len);
+  for (size_t i = 0; i < len; ++i) {
+    const RSValue *v = RSSortingVector_Get(sv, i);
+    RSValueType t = v ? RSValue_Type(v) : RSValueType_Null;
+    switch (t) {
+      case RSValueType_Number:
+        writer_Varint(w, t);
+        writer_Double(w, RSValue_Number_Get(v));
+        break;
+      case RSValueType_String: {
+        size_t slen = 0;
+        const char *s = RSValue_StringPtrLen(v, &slen);
+        // Loaded back as a C string
+        if (memchr(s, '\0', slen)) {
+          w->aborted = true;
+        }
+        writer_Varint(w, t);
+        writer_String(w, s, slen);
+        break;
+      }
+      case RSValueType_Null:
+        writer_Varint(w, RSValueType_Null);
+        break;
+      default:
+        // Multi-value sortables are loaded from the documents again
+        w->aborted = true;
+        writer_Varint(w, RSValueType_Null);
+        break;
+    }
+  }
+}
+
+static void saveDocs(SnapshotWriter *w, IndexSpec *sp) {
+  DocTable *t = &sp->docs;
+  writer_Varint(w, t->maxDocId);
+  writer_Varint(w, t->size);
+  t_docId last = 0;
+  size_t count = 0;
+  for (t_docId id = 1; id <= t->maxDocId; ++id) {
+    const RSDocumentMetadata *dmd = DocTable_Borrow(t, id);
+    if (!dmd) {
+      continue;
+    }
+    size_t keyLen = 0;
+    const char *key = DMD_KeyPtrLen(dmd, &keyLen);
+    writer_Varint(w, id - last);
+    last = id;
+    writer_String(w, key, keyLen);
+    writer_Double(w, dmd->score);
+    writer_Varint(w, dmd->flags);
+    writer_Varint(w, dmd->maxTermFreq);
+    writer_Varint(w, dmd->docLen);
+    writer_Varint(w, dmd->type);
+    writer_Varint(w, (uint64_t)dmd->expirationTimeNs);
+    if (hasPayload(dmd->flags) && dmd->payload) {
+      writer_String(w, dmd->payload->data, dmd->payload->len);
+    } else {
+      writer_Varint(w, 0);
+    }
+    if (dmd->flags & Document_HasSortVector) {
+      saveSortingVector(w, &dmd->sortVector);
+    } else {
+      writer_Varint(w, 0);
+    }
+    if ((dmd->flags & Document_HasOffsetVector) && dmd->byteOffsets) {
+      Buffer b;
+      Buffer_Init(&b, 16);
+      RSByteOffsets_Serialize(dmd->byteOffsets, &b);
+      writer_String(w, b.data, b.offset);
+      Buffer_Free(&b);
+    } else {
+      writer_Varint(w, 0);
+    }
+    DMD_Return(dmd);
+    ++count;
+  }
+  // The table size was read under the same lock, so they match
+  RS_ASSERT(count == t->size);
+}
+
+// Lists of named entries are written as a one before each entry, ended by a zero
+static void saveTerms(SnapshotWriter *w, IndexSpec *sp) {
+  TrieIterator *it = Trie_IterateAll(sp->terms);
+  rune *rstr = NULL;
+  t_len slen = 0;
+  float score = 0;
+  size_t numDocs = 0;
+  RSPayload payload = {.data = NULL, .len = 0};
+  while (TrieIterator_Next(it, &rstr, &slen, &payload, &score, &numDocs, NULL)) {
+    size_t len = 0;
+    char *s = runesToStr(rstr, slen, &len);
+    writer_Varint(w, 1);
+    writer_String(w, s, len);
+    writer_Double(w, score);
+    writer_Varint(w, numDocs);
+    rm_free(s);
+  }
+  TrieIterator_Free(it);
+  writer_Varint(w, 0);
+}
+
+static void saveTermIndexes(SnapshotWriter *w, IndexSpec *sp) {
+  dictIterator *iter = dictGetIterator(sp->keysDict);
+  dictEntry *entry;
+  while ((entry = dictNext(iter))) {
+    const CharBuf *term = dictGetKey(entry);
+    const InvertedIndex *idx = dictGetVal(entry);
+    writer_Varint(w, 1);
+    writer_String(w, term->buf, term->len);
+    t_docId last = 0;
+    FOREACH_INDEX_RESULT(idx, res, {
+      if (DocTable_Exists(&sp->docs, res->docId)) {
+        uint32_t offsetsLen = 0;
+        const char *offsets =
+            RSOffsetVector_GetData(IndexResult_TermOffsetsRef(res), &offsetsLen);
+        writer_Varint(w, res->docId - last);
+        last = res->docId;
+        writer_Varint(w, res->freq);
+        writer_FieldMask(w, res->fieldMask);
+        writer_String(w, offsets, offsetsLen);
+      }
+    });
+    writer_Varint(w, 0);
+  }
+  dictReleaseIterator(iter);
+  writer_Varint(w, 0);
+}
+
+static void saveTagIndex(SnapshotWriter *w, const IndexSpec *sp, const FieldSpec *fs) {
+  const TagIndex *idx = fs->tagOpts.tagIndex;
+  if (idx) {
+    TrieMapIterator *iter = TagIndex_IterateValues(idx);
+    char *tag;
+    tm_len_t len;
+    InvertedIndex *iv;
+    while (TrieMapIterator_Next(iter, &tag, &len, (void **)&iv)) {
+      writer_Varint(w, 1);
+      writer_String(w, tag, len);
+      saveDocIds(w, sp, iv);
+    }
+    TrieMapIterator_Free(iter);
+  }
+  writer_Varint(w, 0);
+}
+
+typedef struct {
+  t_docId docId;
+  double value;
+} NumericEntry;
+
+static int cmpNumericEntries(const void *a, const void *b) {
+  const NumericEntry *x = a, *y = b;
+  if (x->docId != y->docId) {
+    return x->docId < y->docId ? -1 : 1;
+  }
+  return x->value < y->value ? -1 : x->value > y->value;
+}
+
+static void saveNumericIndex(SnapshotWriter *w, IndexSpec *sp, FieldSpec *fs) {
+  arrayof(NumericEntry) entries = array_new(NumericEntry, 16);
+  NumericRangeTree *rt = openNumericOrGeoIndex(sp, fs, DONT_CREATE_INDEX);
+  if (rt) {
+    NumericFilter *nf = NewNumericFilter(-INFINITY, INFINITY, true, true, true, fs, NULL);
+    NumericRangeTreeFindResult ranges = NumericRangeTree_Find(rt, nf);
+    RSIndexResult *res = NewNumericResult();
+    for (size_t i = 0; i < ranges.len; ++i) {
+      IndexReader *reader = NumericRange_NewIndexReader(ranges.ranges[i], NULL);
+      while (IndexReader_Next(reader, res)) {
+        if (DocTable_Exists(&sp->docs, res->docId)) {
+          NumericEntry e = {.docId = res->docId, .value = IndexResult_NumValue(res)};
+          array_append(entries, e);
+        }
+      }
+      IndexReader_Free(reader);
+    }
+    IndexResult_Free(res);
+    NumericRangeTreeFindResult_Free(ranges);
+    NumericFilter_Free(nf);
+  }
+  qsort(entries, array_len(entries), sizeof(*entries), cmpNumericEntries);
+
+  writer_Varint(w, array_len(entries));
+  t_docId last = 0;
+  for (size_t i = 0; i < array_len(entries); ++i) {
+    writer_Varint(w, entries[i].docId - last);
+    last = entries[i].docId;
+    writer_Double(w, entries[i].value);
+  }
+  array_free(entries);
+}
+
+static void saveContents(SnapshotWriter *w, IndexSpec *sp) {
+  writer_Varint(w, sp->stats.scoring.numDocuments);
+  writer_Varint(w, sp->stats.scoring.totalDocsLen);
+  writer_Varint(w, sp->stats.offsetVecsSize);
+  writer_Varint(w, sp->stats.offsetVecRecords);
+
+  saveDocs(w, sp);
+  saveTerms(w, sp);
+  saveTermIndexes(w, sp);
+  for (size_t i = 0; i < sp->numFields; ++i) {
+    FieldSpec *fs = sp->fields + i;
+    if (FIELD_IS(fs, INDEXFLD_T_TAG)) {
+      saveTagIndex(w, sp, fs);
+    }
+    if (FIELD_IS(fs, INDEXFLD_T_NUMERIC | INDEXFLD_T_GEO)) {
+      saveNumericIndex(w, sp, fs);
+    }
+    if (FieldSpec_IndexesMissing(fs)) {
+      saveDocIds(w, sp, dictFetchValue(sp->missingFieldDict, fs->fieldName));
+    }
+  }
+}
+
+static IndexSnapshotCorruption debugCorruption = IndexSnapshotCorrupt_None;
+
+void IndexSnapshot_SetDebugCorruption(IndexSnapshotCorruption corruption) {
+  debugCorruption = corruption;
+}
+
+void IndexSnapshot_RdbSave(RedisModuleIO *rdb, IndexSpec *sp, int contextFlags) {
+  if (!specSupportsSnapshot(sp)) {
+    RedisModule_SaveUnsigned(rdb, SNAPSHOT_NONE);
+    return;
+  }
+  // In a forked child the memory is a snapshot and no lock is needed
+  const bool needLock = !(contextFlags & REDISMODULE_CTX_FLAGS_IS_CHILD);
+  RedisSearchCtx sctx = SEARCH_CTX_STATIC(RedisModule_GetContextFromIO(rdb), sp);
+  if (needLock) {
+    RedisSearchCtx_LockSpecRead(&sctx);
+  }
+
+  const IndexSnapshotCorruption corruption = debugCorruption;
+  RedisModule_SaveUnsigned(rdb, SNAPSHOT_CONTENTS);
+  RedisModule_SaveUnsigned(rdb, SNAPSHOT_FORMAT_VERSION +
+                                    (corruption == IndexSnapshotCorrupt_Version));
+  RedisModule_SaveUnsigned(rdb, schemaFingerprint(sp) +
+                                    (corruption == IndexSnapshotCorrupt_Fingerprint));
+
+  SnapshotWriter w = {.rdb = rdb};
+  Buffer_Init(&w.buf, SNAPSHOT_CHUNK_SIZE + 4096);
+  saveContents(&w, sp);
+  if (corruption == IndexSnapshotCorrupt_Contents) {
+    writer_Varint(&w, 0);
+  }
+  writer_Flush(&w);
+  Buffer_Free(&w.buf);
+  RedisModule_SaveStringBuffer(rdb, "", 0);
+  RedisModule_SaveUnsigned(rdb, w.aborted ? SNAPSHOT_ABORTED : SNAPSHOT_OK);
+  RedisModule_SaveUnsigned(rdb, w.checksum + (corruption == IndexSnapshotCorrupt_Checksum));
+
+  if (needLock) {
+    RedisSearchCtx_UnlockSpec(&sctx);
+  }
+}
+
+/******************************************************************************
+ * Load
+ ******************************************************************************/
+
+static void restoreSortingVector(SnapshotReader *r, DocTable *t, RSDocumentMetadata *dmd) {
+  const size_t len = reader_Varint(r);
+  if (!len) {
+    return;
+  }
+  if (len > RS_SORTABLES_MAX) {
+    r->error = true;
+    return;
+  }
+  RSSortingVector sv = RSSortingVector_New(len);
+  for (size_t i = 0; i < len && !r->error; ++i) {
+    switch (reader_Varint(r)) {
+      case RSValueType_Number:
+        RSSortingVector_PutNum(&sv, i, reader_Double(r));
+        break;
+      case RSValueType_String: {
+        size_t slen = 0;
+        const char *s = reader_String(r, &slen);
+        char *cs = rm_strndup(s ? s : "", slen);
+        RSSortingVector_PutStr(&sv, i, cs);
+        rm_free(cs);
+        break;
+      }
+      default:
+        RSSortingVector_PutNull(&sv, i);
+        break;
+    }
+  }
+  DocTable_SetSortingVector(t, dmd, sv);
+}
+
+static void restoreDocs(SnapshotReader *r, IndexSpec *sp, IndexSnapshotRestore *restore) {
+  DocTable *t = &sp->docs;
+  const t_docId maxDocId = reader_Varint(r);
+  const size_t count = reader_Count(r);
+  t_docId id = 0;
+  for (size_t i = 0; i < count && !r->error; ++i) {
+    id += reader_Varint(r);
+    size_t keyLen = 0;
+    const char *key = reader_String(r, &keyLen);
+    const double score = reader_Double(r);
+    const RSDocumentFlags flags = reader_Varint(r);
+    const uint32_t maxTermFreq = reader_Varint(r);
+    const uint32_t docLen = reader_Varint(r);
+    const DocumentType type = reader_Varint(r);
+    const int64_t expirationTimeNs = reader_Varint(r);
+    size_t payloadLen = 0;
+    const char *payload = reader_String(r, &payloadLen);
+    if (r->error || !id || id > maxDocId) {
+      r->error = true;
+      return;
+    }
+
+    // Put assigns the next id
+    t->maxDocId = id - 1;
+    RSDocumentMetadata *dmd =
+        DocTable_Put(t, key, keyLen, score,
+                     flags & ~(Document_HasPayload | Document_HasSortVector | Document_HasOffsetVector),
+                     payload, payloadLen, type);
+    if (dmd->id != id) {
+      // A duplicate key
+      DMD_Return(dmd);
+      r->error = true;
+      return;
+    }
+    dmd->maxTermFreq = maxTermFreq;
+    dmd->docLen = docLen;
+    if (expirationTimeNs) {
+      t_expirationTimePoint ttl = {.tv_sec = expirationTimeNs / 1000000000LL,
+                                   .tv_nsec = expirationTimeNs % 1000000000LL};
+      DocTable_SetDocExpiration(t, dmd, ttl);
+    }
+    restoreSortingVector(r, t, dmd);
+
+    size_t offsetsLen = 0;
+    const char *offsets = reader_String(r, &offsetsLen);
+    if (offsetsLen) {
+      Buffer b = {.data = (char *)offsets, .cap = offsetsLen, .offset = offsetsLen};
+      DocTable_SetByteOffsets(dmd, LoadByteOffsets(&b));
+    }
+    DMD_Return(dmd);
+  }
+  t->maxDocId = maxDocId;
+  restore->maxDocId = maxDocId;
+}
+
+static void restoreTerms(SnapshotReader *r, IndexSpec *sp) {
+  while (reader_Varint(r) && !r->error) {
+    size_t len = 0;
+    const char *term = reader_String(r, &len);
+    const double score = reader_Double(r);
+    const size_t numDocs = reader_Varint(r);
+    if (r->error) {
+      return;
+    }
+    if (Trie_InsertStringBuffer(sp->terms, term, len, score, 0, NULL, numDocs) == TRIE_OK_NEW) {
+      sp->stats.scoring.numTerms++;
+      sp->stats.termsSize += len;
+    }
+  }
+}
+
+static bool termIsIndexedWord(const char *term, size_t len) {
+  return len && term[0] != STEM_PREFIX && term[0] != PHONETIC_PREFIX &&
+         term[0] != SYNONYM_PREFIX_CHAR;
+}
+
+static void restoreTermIndexes(SnapshotReader *r, IndexSpec *sp) {
+  while (reader_Varint(r) && !r->error) {
+    size_t len = 0;
+    const char *term = reader_String(r, &len);
+    InvertedIndex *idx = NULL;
+    t_fieldMask termMask = 0;
+    t_docId docId = 0;
+    for (uint64_t delta; (delta = reader_Varint(r)) && !r->error;) {
+      docId += delta;
+      const uint32_t freq = reader_Varint(r);
+      const t_fieldMask fieldMask = reader_FieldMask(r);
+      size_t offsetsLen = 0;
+      const char *offsets = reader_String(r, &offsetsLen);
+      const RSDocumentMetadata *dmd = DocTable_Borrow(&sp->docs, docId);
+      if (r->error || !dmd) {
+        r->error = true;
+        return;
+      }
+      if (!idx) {
+        // Terms whose documents are all deleted are not restored
+        idx = Redis_OpenInvertedIndex(sp, term, len, CREATE_INDEX, NULL);
+      }
+      RSIndexResult rec = {.data.term_tag = RSResultData_Term,
+                           .data.term.borrowed.tag = RSTermRecord_Borrowed,
+                           .docId = docId,
+                           .freq = freq,
+                           .fieldMask = fieldMask,
+                           .metrics = MetricsVec_New()};
+      if (offsetsLen) {
+        rec.data.term.borrowed.offsets.data = (uint8_t *)offsets;
+        rec.data.term.borrowed.offsets.len = offsetsLen;
+      }
+      AddRecordOutcome o = InvertedIndex_WriteScoredEntry(idx, &rec, dmd->docLen);
+      DMD_Return(dmd);
+      sp->stats.invertedSize += o.mem_growth;
+      sp->stats.invertedSize -= o.mem_released;
+      IndexStats_BlockCountAdd(&sp->stats, o.blocks_added);
+      sp->stats.numRecords++;
+      termMask |= rec.fieldMask;
+    }
+    if ((sp->suffixMask & termMask) && termIsIndexedWord(term, len)) {
+      addSuffixTrie(sp->suffix, term, len);
+    }
+    if ((sp->ngramMask & termMask) && termIsIndexedWord(term, len)) {
+      NgramIndex_Add(sp->ngrams, term, len);
+    }
+  }
+}
+
+static arrayof(t_docId) readDocIds(SnapshotReader *r, const IndexSpec *sp) {
+  arrayof(t_docId) ids = array_new(t_docId, 16);
+  t_docId docId = 0;
+  for (uint64_t delta; (delta = reader_Varint(r)) && !r->error;) {
+    docId += delta;
+    if (!DocTable_Exists(&sp->docs, docId)) {
+      r->error = true;
+      break;
+    }
+    array_append(ids, docId);
+  }
+  return ids;
+}
+
+// Writes the documents of a doc ids only index
+static void restoreDocIds(IndexSpec *sp, InvertedIndex *idx, arrayof(t_docId) ids) {
+  for (size_t i = 0; i < array_len(ids); ++i) {
+    const t_docId docId = ids[i];
+    RSIndexResult rec = {.data.tag = RSResultData_Virtual, .docId = docId, .freq = 0,
+                         .metrics = MetricsVec_New()};
+    AddRecordOutcome o = InvertedIndex_WriteEntryGeneric(idx, &rec);
+    sp->stats.invertedSize += o.mem_growth;
+    sp->stats.invertedSize -= o.mem_released;
+    IndexStats_BlockCountAdd(&sp->stats, o.blocks_added);
+  }
+}
+
+static void restoreTagIndex(SnapshotReader *r, IndexSpec *sp, FieldSpec *fs) {
+  while (reader_Varint(r) && !r->error) {
+    size_t len = 0;
+    const char *value = reader_String(r, &len);
+    arrayof(t_docId) ids = readDocIds(r, sp);
+    if (!r->error && array_len(ids)) {
+      TagIndex *tidx = TagIndex_Ensure(fs, NULL, FieldSpec_HasSuffixTrie(fs));
+      size_t sz = 0;
+      InvertedIndex *iv = TagIndex_OpenIndex(tidx, value, len, CREATE_INDEX, &sz);
+      sp->stats.invertedSize += sz;
+      restoreDocIds(sp, iv, ids);
+      sp->stats.numRecords += array_len(ids);
+      // Adds the value to the suffix trie
+      char *tok = rm_strndup(value, len);
+      TagIndex_Commit(tidx, (const char **)&tok, 1, &sp->stats);
+      rm_free(tok);
+    }
+    array_free(ids);
+  }
+}
+
+static void restoreNumericIndex(SnapshotReader *r, IndexSpec *sp, FieldSpec *fs) {
+  const size_t count = reader_Count(r);
+  if (!count) {
+    return;
+  }
+  NumericEntry *entries = rm_malloc(count * sizeof(*entries));
+  t_docId docId = 0;
+  for (size_t i = 0; i < count; ++i) {
+    docId += reader_Varint(r);
+    entries[i].docId = docId;
+    entries[i].value = reader_Double(r);
+  }
+  NumericRangeTree *rt = openNumericOrGeoIndex(sp, fs, CREATE_INDEX);
+  for (size_t i = 0; i < count && !r->error; ++i) {
+    if (!DocTable_Exists(&sp->docs, entries[i].docId)) {
+      r->error = true;
+      break;
+    }
+    // The entries are sorted by document
+    const bool isMulti = (i > 0 && entries[i - 1].docId == entries[i].docId) ||
+                         (i + 1 < count && entries[i + 1].docId == entries[i].docId);
+    AddResult rv = _NumericRangeTree_Add(rt, entries[i].docId, entries[i].value, false, isMulti,
+                                         RSGlobalConfig.numericTreeMaxDepthRange);
+    sp->stats.invertedSize += rv.size_delta;
+    sp->stats.numRecords += rv.num_records_delta;
+    IndexStats_BlockCountAdd(&sp->stats, rv.block_count_delta);
+  }
+  rm_free(entries);
+}
+
+static void restoreMissingIndex(SnapshotReader *r, IndexSpec *sp, FieldSpec *fs) {
+  arrayof(t_docId) ids = readDocIds(r, sp);
+  if (!r->error && array_len(ids)) {
+    size_t index_size;
+    InvertedIndex *idx = NewInvertedIndex(Index_DocIdsOnly, &index_size);
+    sp->stats.invertedSize += index_size;
+    dictAdd(sp->missingFieldDict, (void *)fs->fieldName, idx);
+    restoreDocIds(sp, idx, ids);
+  }
+  array_free(ids);
+}
+
+// The existing documents index holds every document, so it is not saved
+static void restoreExistingDocs(IndexSpec *sp) {
+  if (!sp->rule || !sp->rule->index_all || !sp->docs.size) {
+    return;
+  }
+  size_t index_size;
+  sp->existingDocs = NewInvertedIndex(Index_DocIdsOnly, &index_size);
+  sp->stats.invertedSize += index_size;
+  for (t_docId id = 1; id <= sp->docs.maxDocId; ++id) {
+    if (DocTable_Exists(&sp->docs, id)) {
+      RSIndexResult rec = {.data.tag = RSResultData_Virtual, .docId = id, .freq = 0,
+                           .metrics = MetricsVec_New()};
+      AddRecordOutcome o = InvertedIndex_WriteEntryGeneric(sp->existingDocs, &rec);
+      sp->stats.invertedSize += o.mem_growth;
+      sp->stats.invertedSize -= o.mem_released;
+      IndexStats_BlockCountAdd(&sp->stats, o.blocks_added);
+    }
+  }
+}
+
+static bool restoreContents(SnapshotReader *r, IndexSpec *sp, IndexSnapshotRestore *restore) {
+  sp->stats.scoring.numDocuments = reader_Varint(r);
+  sp->stats.scoring.totalDocsLen = reader_Varint(r);
+  sp->stats.offsetVecsSize = reader_Varint(r);
+  sp->stats.offsetVecRecords = reader_Varint(r);
+
+  restoreDocs(r, sp, restore);
+  restoreTerms(r, sp);
+  restoreTermIndexes(r, sp);
+  for (size_t i = 0; i < sp->numFields && !r->error; ++i) {
+    FieldSpec *fs = sp->fields + i;
+    if (FIELD_IS(fs, INDEXFLD_T_TAG)) {
+      restoreTagIndex(r, sp, fs);
+    }
+    if (FIELD_IS(fs, INDEXFLD_T_NUMERIC | INDEXFLD_T_GEO)) {
+      restoreNumericIndex(r, sp, fs);
+    }
+    if (FieldSpec_IndexesMissing(fs)) {
+      restoreMissingIndex(r, sp, fs);
+    }
+  }
+  if (!r->error) {
+    restoreExistingDocs(sp);
+  }
+  return !r->error && r->pos == r->end;
+}
+
+// Drops whatever a failed restore left behind, for the keys to be indexed from scratch
+static void resetContents(IndexSpec *sp) {
+  DocTable_Free(&sp->docs);
+  sp->docs = DocTable_New(INITIAL_DOC_TABLE_SIZE);
+  TrieType_Free(sp->terms);
+  sp->terms = NewTrie(NULL, Trie_Sort_Lex);
+  dictEmpty(sp->keysDict, NULL);
+  dictEmpty(sp->missingFieldDict, NULL);
+  if (sp->existingDocs) {
+    InvertedIndex_Free(sp->existingDocs);
+    sp->existingDocs = NULL;
+  }
+  if (sp->suffix) {
+    TrieType_Free(sp->suffix);
+    sp->suffix = NewTrie(suffixTrie_freeCallback, Trie_Sort_Lex);
+  }
+  if (sp->ngrams) {
+    NgramIndex_Free(sp->ngrams);
+    sp->ngrams = NewNgramIndex();
+  }
+  for (size_t i = 0; i < sp->numFields; ++i) {
+    FieldSpec *fs = sp->fields + i;
+    if (FIELD_IS(fs, INDEXFLD_T_TAG) && fs->tagOpts.tagIndex) {
+      TagIndex_Free(fs->tagOpts.tagIndex);
+      fs->tagOpts.tagIndex = NULL;
+    }
+    if (FIELD_IS(fs, INDEXFLD_T_NUMERIC | INDEXFLD_T_GEO) && fs->tree) {
+      NumericRangeTree_Free(fs->tree);
+      fs->tree = NULL;
+    }
+  }
+  IndexError indexError = sp->stats.indexError;
+  memset(&sp->stats, 0, sizeof(sp->stats));
+  sp->stats.indexError = indexError;
+}
+
+int IndexSnapshot_RdbLoad(RedisModuleIO *rdb, IndexSpec *sp, QueryError *status) {
+  if (LoadUnsigned_IOError(rdb, goto ioerror) == SNAPSHOT_NONE) {
+    return REDISMODULE_OK;
+  }
+  const uint64_t version = LoadUnsigned_IOError(rdb, goto ioerror);
+  const uint64_t fingerprint = LoadUnsigned_IOError(rdb, goto ioerror);
+
+  // The contents are always read, so that the rest of the RDB can be loaded even
+  // when they are discarded
+  Buffer contents;
+  Buffer_Init(&contents, SNAPSHOT_CHUNK_SIZE);
+  uint64_t checksum = 0;
+  while (true) {
+    size_t len = 0;
+    char *chunk = LoadStringBuffer_IOError(rdb, &len, goto ioerror_free);
+    if (!len) {
+      RedisModule_Free(chunk);
+      break;
+    }
+    checksum = fnv_64a_buf(chunk, len, checksum);
+    BufferWriter bw = NewBufferWriter(&contents);
+    Buffer_Write(&bw, chunk, len);
+    RedisModule_Free(chunk);
+  }
+  const uint64_t saveStatus = LoadUnsigned_IOError(rdb, goto ioerror_free);
+  const uint64_t savedChecksum = LoadUnsigned_IOError(rdb, goto ioerror_free);
+
+  const char *discard = NULL;
+  if (saveStatus != SNAPSHOT_OK) {
+    discard = "it could not be fully saved";
+  } else if (version != SNAPSHOT_FORMAT_VERSION) {
+    discard = "its format version does not match";
+  } else if (fingerprint != schemaFingerprint(sp)) {
+    discard = "it does not match the schema";
+  } else if (checksum != savedChecksum) {
+    discard = "its checksum does not match";
+  } else if (sp->diskSpec) {
+    discard = "the index is on disk";
+  }
+  if (sp->isDuplicate || discard) {
+    if (discard) {
+      RedisModule_Log(RSDummyContext, "warning",
+                      "Discarding the saved contents of index %s since %s, indexing its keys",
+                      IndexSpec_FormatName(sp, RSGlobalConfig.hideUserDataFromLog), discard);
+    }
+    Buffer_Free(&contents);
+    return REDISMODULE_OK;
+  }
+
+  IndexSnapshotRestore *restore = rm_calloc(1, sizeof(*restore));
+  SnapshotReader r = {.pos = contents.data, .end = contents.data + contents.offset};
+  const bool ok = restoreContents(&r, sp, restore);
+  Buffer_Free(&contents);
+  if (!ok) {
+    // The RDB itself was read fine, so only the index falls back to its keys
+    IndexSnapshot_FreeRestore(restore);
+    resetContents(sp);
+    RedisModule_Log(RSDummyContext, "warning",
+                    "Discarding the saved contents of index %s since they could not be restored, "
+                    "indexing its keys",
+                    IndexSpec_FormatName(sp, RSGlobalConfig.hideUserDataFromLog));
+    return REDISMODULE_OK;
+  }
+  restore->loaded = rm_calloc(restore->maxDocId / 64 + 1, sizeof(*restore->loaded));
+  sp->snapshotRestore = restore;
+  RedisModule_Log(RSDummyContext, "notice", "Restored %zu documents of index %s from the RDB",
+                  sp->docs.size, IndexSpec_FormatName(sp, RSGlobalConfig.hideUserDataFromLog));
+  return REDISMODULE_OK;
+
+ioerror_free:
+  Buffer_Free(&contents);
+ioerror:
+  QueryError_SetError(status, QUERY_ERROR_CODE_PARSE_ARGS, "while reading the index contents");
+  return REDISMODULE_ERR;
+}
+
+bool IndexSnapshot_ClaimLoadedKey(IndexSpec *sp, RedisModuleString *key) {
+  IndexSnapshotRestore *restore = sp->snapshotRestore;
+  if (!restore) {
+    return false;
+  }
+  const t_docId id = DocTable_GetIdR(&sp->docs, key);
+  if (!id || id > restore->maxDocId) {
+    return false;
+  }
+  restore->loaded[id / 64] |= 1ULL << (id % 64);
+  return true;
+}
+
+void IndexSnapshot_FinishRestore(RedisModuleCtx *ctx, IndexSpec *sp) {
+  IndexSnapshotRestore *restore = sp->snapshotRestore;
+  if (!restore) {
+    return;
+  }
+  sp->snapshotRestore = NULL;
+  size_t deleted = 0;
+  for (t_docId id = 1; id <= restore->maxDocId; ++id) {
+    if (restore->loaded[id / 64] & (1ULL << (id % 64))) {
+      continue;
+    }
+    // Not loaded, e.g. expired, unless written since and reindexed with a new id
+    const RSDocumentMetadata *dmd = DocTable_Borrow(&sp->docs, id);
+    if (!dmd) {
+      continue;
+    }
+    RedisModuleString *key = DMD_CreateKeyString(dmd, ctx);
+    DMD_Return(dmd);
+    IndexSpec_DeleteDoc(sp, ctx, key, NULL);
+    RedisModule_FreeString(ctx, key);
+    ++deleted;
+  }
+  if (deleted) {
+    RedisModule_Log(RSDummyContext, "notice",
+                    "Deleted %zu restored documents of index %s whose keys were not loaded",
+                    deleted, IndexSpec_FormatName(sp, RSGlobalConfig.hideUserDataFromLog));
+  }
+  IndexSnapshot_FreeRestore(restore);
+}
+
+void IndexSnapshot_FreeRestore(IndexSnapshotRestore *restore) {
+  rm_free(restore->loaded);
+  rm_free(restore);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stdbool.h>
+#include "redismodule.h"
+#include "query_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct IndexSpec;
+
+/**
+ * Persisted contents of an in-memory index.
+ *
+ * With PERSIST_INDEX_CONTENTS, the document table, the terms trie, the term,
+ * tag, missing-field inverted indexes and the numeric and geo range trees of
+ * each index are saved to the RDB after its schema. Loading the RDB restores
+ * them, and the loaded keys whose documents are restored are not indexed again.
+ * The restored documents whose keys were not loaded are deleted once the load ends.
+ *
+ * The contents are guarded by a format version, a fingerprint of the schema and
+ * a checksum. On any mismatch they are discarded and the keys are indexed as usual.
+ * Indexes with vector or geometry fields, field expirations or documents still
+ * waiting to be indexed are saved without their contents.
+ */
+typedef struct IndexSnapshotRestore IndexSnapshotRestore;
+
+/** Save the contents of `sp` after its schema, or an empty marker. */
+void IndexSnapshot_RdbSave(RedisModuleIO *rdb, struct IndexSpec *sp, int contextFlags);
+
+/**
+ * Load the contents saved by IndexSnapshot_RdbSave into `sp`, whose schema was just
+ * loaded. Contents that cannot be restored are discarded, for the keys to be indexed.
+ * Returns REDISMODULE_ERR on an I/O error only.
+ */
+int IndexSnapshot_RdbLoad(RedisModuleIO *rdb, struct IndexSpec *sp, QueryError *status);
+
+/**
+ * Whether the loaded `key` is indexed in `sp` by its restored contents already,
+ * in which case it must not be indexed again.
+ */
+bool IndexSnapshot_ClaimLoadedKey(struct IndexSpec *sp, RedisModuleString *key);
+
+/** Delete the restored documents of `sp` whose keys were not loaded. Called when the load ends */
+void IndexSnapshot_FinishRestore(RedisModuleCtx *ctx, struct IndexSpec *sp);
+
+void IndexSnapshot_FreeRestore(IndexSnapshotRestore *restore);
+
+/** Ways to corrupt the saved contents, for testing their validation on load */
+typedef enum {
+  IndexSnapshotCorrupt_None,
+  IndexSnapshotCorrupt_Version,
+  IndexSnapshotCorrupt_Fingerprint,
+  IndexSnapshotCorrupt_Checksum,
+  // Trailing data covered by the checksum, so the restore fails once done
+  IndexSnapshotCorrupt_Contents,
+} IndexSnapshotCorruption;
+
+/** Corrupt the contents of every following save. Used by FT.DEBUG */
+void IndexSnapshot_SetDebugCorruption(IndexSnapshotCorruption corruption);
+
+#ifdef __cplusplus
+}
+#endif
@@ -66,6 +66,7 @@ static void writeIndexEntry(IndexSpec *spec, InvertedIndex *idx, ForwardIndexEnt
 
   // Number of additional bytes
   spec->stats.invertedSize += r.mem_growth;
+  spec->stats.invertedSize -= r.mem_released;
   IndexStats_BlockCountAdd(&spec->stats, r.blocks_added);
   // Number of records
   spec->stats.numRecords++;
@@ -163,6 +164,7 @@ static void indexText(RSAddDocumentCtx *aCtx, RedisSearchCtx *ctx) {
     if (invidx) {
       entry->docId = aCtx->doc->docId;
       RS_LOG_ASSERT(entry->docId, "docId should not be 0");
+      entry->docLen = aCtx->fwIdx->totalFreq;
       writeIndexEntry(spec, invidx, entry, (entry->fieldMask & expiringTextFields) != 0);
     }
     if (isNew && strlen(entry->term) != 0) {
@@ -171,6 +173,9 @@ static void indexText(RSAddDocumentCtx *aCtx, RedisSearchCtx *ctx) {
     if (entryWantsSuffixTrie(spec, entry)) {
       addSuffixTrie(spec->suffix, entry->term, entry->len);
     }
+    if (entryWantsNgrams(spec, entry)) {
+      NgramIndex_Add(spec->ngrams, entry->term, entry->len);
+    }
   }
   FieldsGlobalStats_UpdateFieldDocsIndexed(INDEXFLD_T_FULLTEXT, spec->stats.scoring.numTerms - prevNumTerms);
 }
@@ -401,6 +406,7 @@ static void writeMissingFieldDocs(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx,
                          .metrics = MetricsVec_New()};
     AddRecordOutcome r = InvertedIndex_WriteEntryGeneric(iiMissingDocs, &rec);
     aCtx->spec->stats.invertedSize += r.mem_growth;
+    aCtx->spec->stats.invertedSize -= r.mem_released;
     IndexStats_BlockCountAdd(&aCtx->spec->stats, r.blocks_added);
   }
   dictReleaseIterator(iter);
@@ -424,6 +430,7 @@ static void writeExistingDocs(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx) {
                        .metrics = MetricsVec_New()};
   AddRecordOutcome r = InvertedIndex_WriteEntryGeneric(sctx->spec->existingDocs, &rec);
   aCtx->spec->stats.invertedSize += r.mem_growth;
+  aCtx->spec->stats.invertedSize -= r.mem_released;
   IndexStats_BlockCountAdd(&aCtx->spec->stats, r.blocks_added);
 }
 
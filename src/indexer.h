@@ -62,7 +62,8 @@ int IndexDocument(RSAddDocumentCtx *aCtx);
  * The `fdata` field is used to contain the result of the processing, which is then
  * actually written to the index at a later point in time.
  *
- * This function is called with the GIL released.
+ * This function may be called with the GIL released, on a worker thread, and
+ * without the spec lock (see indexing_pipeline.h). `sctx` is NULL.
  */
 typedef int (*PreprocessorFunc)(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx, DocumentField *field,
                                 const FieldSpec *fs, FieldIndexerData *fdata, QueryError *status);
@@ -70,6 +70,15 @@ static inline bool entryWantsSuffixTrie(const IndexSpec *spec, const ForwardInde
       && strlen(entry->term) != 0;
 }
 
+// Returns true on terms that should be indexed in the trigram index.
+static inline bool entryWantsNgrams(const IndexSpec *spec, const ForwardIndexEntry *entry) {
+  return (spec->ngramMask & entry->fieldMask)
+      && entry->term[0] != STEM_PREFIX
+      && entry->term[0] != PHONETIC_PREFIX
+      && entry->term[0] != SYNONYM_PREFIX_CHAR
+      && strlen(entry->term) != 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,8 @@
 #include "config.h"
 #include "cursor.h"
 #include "indexer.h"
+#include "indexing_pipeline.h"
+#include "index_snapshot.h"
 #include "alias.h"
 #include "rules.h"
 #include "doc_types.h"
@@ -310,6 +312,12 @@ int Indexes_RdbLoad(RedisModuleIO *rdb, int encver, int when) {
     // Load one spec (parse + duplicate detection + disk open), then publish it
     // into the registry.
     IndexSpec *sp = Indexes_LoadSpecFromRdb(rdb, encver, useSst, &status);
+    // The contents of the index, if saved, follow its schema
+    if (sp && encver >= INDEX_CONTENTS_VERSION &&
+        IndexSnapshot_RdbLoad(rdb, sp, &status) != REDISMODULE_OK) {
+      StrongRef_Release(sp->own_ref);
+      sp = NULL;
+    }
     if (Indexes_StoreSpecAfterRdbLoad(sp) != REDISMODULE_OK) {
       RedisModule_LogIOError(rdb, "warning", "RDB Load: %s", QueryError_GetDisplayableError(&status, RSGlobalConfig.hideUserDataFromLog));
       QueryError_ClearError(&status);
@@ -392,6 +400,7 @@ static void Indexes_RdbSave(RedisModuleIO *rdb, int when) {
     StrongRef spec_ref = dictGetRef(entry);
     IndexSpec *sp = StrongRef_Get(spec_ref);
     IndexSpec_RdbSave(rdb, sp, contextFlags);
+    IndexSnapshot_RdbSave(rdb, sp, contextFlags);
   }
 
   dictReleaseIterator(iter);
@@ -628,8 +637,9 @@ void Indexes_SpecOpsIndexingCtxFree(SpecOpIndexingCtx *specs) {
   rm_free(specs);
 }
 
-void Indexes_UpdateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type,
-                                           RedisModuleString **hashFields) {
+static void updateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleString *key,
+                                          DocumentType type, RedisModuleString **hashFields,
+                                          bool loaded) {
   if (type == DocumentType_Unsupported) {
     // COPY could overwrite a hash/json with other types so we must try and remove old doc.
     Indexes_DeleteMatchingWithSchemaRules(ctx, key, type, hashFields);
@@ -643,7 +653,9 @@ void Indexes_UpdateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleStrin
 
     if (hashFieldChanged(specOp->spec, hashFields)) {
       if (specOp->op == SpecOp_Add) {
-        IndexSpec_UpdateDoc(specOp->spec, ctx, key, type, NULL);
+        if (!loaded || !IndexSnapshot_ClaimLoadedKey(specOp->spec, key)) {
+          IndexSpec_UpdateDoc(specOp->spec, ctx, key, type, NULL);
+        }
       } else {
         // specOp->op is SpecOp_Del when the key matches the index prefix but
         // the filter expression fails (e.g. a field value changed so the filter
@@ -651,12 +663,26 @@ void Indexes_UpdateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleStrin
         // previously indexed, it must be removed now.
         IndexSpec_DeleteDoc(specOp->spec, ctx, key, NULL);
       }
+    } else {
+      // Fields outside the schema are still returned by queries loading the
+      // whole document, so their cached replies are stale
+      IndexSpec_BumpWriteEpoch(specOp->spec);
     }
   }
 
   Indexes_SpecOpsIndexingCtxFree(specs);
 }
 
+void Indexes_UpdateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type,
+                                           RedisModuleString **hashFields) {
+  updateMatchingWithSchemaRules(ctx, key, type, hashFields, false);
+}
+
+void Indexes_UpdateMatchingLoadedKey(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type) {
+  // A document restored with the contents of its index is indexed already
+  updateMatchingWithSchemaRules(ctx, key, type, NULL, true);
+}
+
 void Indexes_UpdateMatchingDocExpiration(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type) {
   if (type == DocumentType_Unsupported || !RSGlobalConfig.monitorExpiration) {
     return;
@@ -702,15 +728,19 @@ void Indexes_UpdateMatchingDocExpiration(RedisModuleCtx *ctx, RedisModuleString
       continue;
     }
     RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
-    // Read lock is sufficient: the only mutation is the relaxed atomic store on
-    // `dmd->expirationTimeNs` inside DocTable_SetDocExpiration (paired with a
-    // relaxed atomic load in DocTable_IsDocExpired). The DMD chain traversal
-    // and refcount manipulation in DocTable_BorrowByKeyR / DMD_Return are
+    // Read lock is sufficient: the only mutations are the relaxed atomic stores
+    // on `expirationTimeNs` inside DocTable_SetDocExpiration (paired with the
+    // relaxed atomic loads in DocTable_IsDocExpired and DocTable_IsLive). The
+    // DMD chain traversal and refcount manipulation in DocTable_BorrowByKeyR / DMD_Return are
     // explicitly documented as safe under either lock mode (doc_table.c, near
     // DocTable_GetOwn). Concurrent writers cannot race here because keyspace
     // notifications all dispatch on the Redis main thread, so this callback is
     // serialized against itself and against other notification-driven writers
     // by the event loop, not by the spec lock.
+    //
+    // The document may still be waiting to be indexed, e.g. for an EXPIRE right after the HSET,
+    // and applying it later does not read the TTL again.
+    IndexingPipeline_Flush(spec);
     RedisSearchCtx_LockSpecRead(&sctx);
     const RSDocumentMetadata *cdmd = DocTable_BorrowByKeyR(&spec->docs, key);
     if (cdmd) {
@@ -718,8 +748,9 @@ void Indexes_UpdateMatchingDocExpiration(RedisModuleCtx *ctx, RedisModuleString
       // HEXPIRE state, and the per-field TTL table must be left untouched —
       // mutating it would also require the spec write lock, which we do not
       // hold on this fast path.
-      DocTable_SetDocExpiration((RSDocumentMetadata *)cdmd, ttl);
+      DocTable_SetDocExpiration(&spec->docs, (RSDocumentMetadata *)cdmd, ttl);
       DMD_Return(cdmd);
+      IndexSpec_BumpWriteEpoch(spec);
     }
     RedisSearchCtx_UnlockSpec(&sctx);
   }
@@ -736,6 +767,9 @@ void Indexes_DeleteMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleStrin
     SpecOpCtx *specOp = specs->specsOps + i;
     if (hashFieldChanged(specOp->spec, hashFields)) {
       IndexSpec_DeleteDoc(specOp->spec, ctx, key, NULL);
+    } else {
+      // HDEL of a field outside the schema, see Indexes_UpdateMatchingWithSchemaRules
+      IndexSpec_BumpWriteEpoch(specOp->spec);
     }
   }
 
@@ -875,6 +909,8 @@ void Indexes_UpdateMatchingHashFieldExpiration(RedisModuleCtx *ctx, RedisModuleS
     }
 
     RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
+    // The document may still be waiting to be indexed
+    IndexingPipeline_Flush(spec);
     RedisSearchCtx_LockSpecWrite(&sctx);
 
     const RSDocumentMetadata *cdmd = DocTable_BorrowByKeyR(&spec->docs, key);
@@ -904,6 +940,7 @@ void Indexes_UpdateMatchingHashFieldExpiration(RedisModuleCtx *ctx, RedisModuleS
       DocTable_UpdateFieldExpiration(&spec->docs, (RSDocumentMetadata *)cdmd,
                                      DocTable_TakeFieldExpirations(&sorted));
       DMD_Return(cdmd);
+      IndexSpec_BumpWriteEpoch(spec);
     }
 
     RedisSearchCtx_UnlockSpec(&sctx);
@@ -943,6 +980,7 @@ void Indexes_ReplaceMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleStri
     if (entry) {
       // The document should be indexed by the new key as well, so we need to update the key name in the index.
       RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
+      IndexingPipeline_Flush(spec);
       RedisSearchCtx_LockSpecWrite(&sctx);
 
       // Perform the rename
@@ -1033,6 +1071,15 @@ void Indexes_EndRDBLoadingEvent(RedisModuleCtx *ctx) {
 
   LegacySchemaRulesArgs_Free(ctx);
 
+  // Delete the restored documents whose keys were not loaded
+  dictIterator *iter = dictGetIterator(specDict_g);
+  dictEntry *entry = NULL;
+  while ((entry = dictNext(iter))) {
+    IndexSpec *sp = StrongRef_Get(dictGetRef(entry));
+    IndexSnapshot_FinishRestore(ctx, sp);
+  }
+  dictReleaseIterator(iter);
+
   if (hasLegacyIndexes) {
     Indexes_ScanAndReindex();
   }
@@ -80,6 +80,9 @@ void Indexes_SetTempSpecsTimers(TimerOp op);
 
 void Indexes_UpdateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type,
                                            RedisModuleString **hashFields);
+// Index a key loaded from the RDB, unless its document was restored with the
+// contents of its index already (see index_snapshot.h)
+void Indexes_UpdateMatchingLoadedKey(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type);
 // Refresh the per-field TTL entries on every spec that indexes `key`: reads
 // the hash's current per-field expiration timestamps and writes them onto
 // the matching specs' TTL tables, without re-tokenizing the document or
@@ -25,6 +25,7 @@
 #include "indexes_scanner.h"
 #include "indexes_scan.h"
 #include "indexes_asyncscan.h"
+#include "indexing_pipeline.h"
 #include "search_disk.h"
 #include "document.h"
 #include "util/logging.h"
@@ -184,7 +185,12 @@ static void IndexScanner_DrainPendingScanKeys(RedisModuleCtx *ctx, ScanProcCtx *
         // This check is performed without locking the spec, but it's ok since we locked the GIL
         // So the main thread is not running and the GC is not touching the relevant data
         if (SchemaRule_ShouldIndex(sp, keyname, type, NULL)) {
-          IndexSpec_UpdateDoc(sp, ctx, keyname, type, NULL);
+          // The debug scanner pauses with the keys scanned so far indexed
+          if (scanner->isDebug) {
+            IndexSpec_UpdateDoc(sp, ctx, keyname, type, NULL);
+          } else {
+            IndexSpec_UpdateScannedDoc(sp, ctx, keyname, type);
+          }
         }
         IndexSpecRef_Release(curr_run_ref);
       } else {
@@ -371,6 +377,16 @@ static void Indexes_ScanAndReindexTask(IndexesScanner *scanner) {
     dScanner->status = DEBUG_INDEX_SCANNER_CODE_DONE;
   }
 
+  if (!scanner->global) {
+    // The scan is reported done once all the scanned documents are indexed
+    StrongRef curr_run_ref = IndexSpecRef_Promote(scanner->spec_ref);
+    IndexSpec *sp = StrongRef_Get(curr_run_ref);
+    if (sp) {
+      IndexingPipeline_Flush(sp);
+      IndexSpecRef_Release(curr_run_ref);
+    }
+  }
+
   if (scanner->global) {
     RedisModule_Log(ctx, "notice", "Scanning indexes in background: done (scanned=%zu)",
                     scanner->scannedKeys);
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "indexing_pipeline.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "spec.h"
+#include "config.h"
+#include "indexer.h"
+#include "search_ctx.h"
+#include "redis_index.h"
+#include "rmalloc.h"
+#include "rs_wall_clock.h"
+#include "util/arr/arr.h"
+#include "util/workers.h"
+#include "rmutil/rm_assert.h"
+
+typedef enum {
+  PendingDoc_Queued,
+  PendingDoc_Claimed,  // being preprocessed
+  PendingDoc_Done,
+} PendingDocState;
+
+typedef struct {
+  Document doc;
+  RSAddDocumentCtx *aCtx;
+  IndexingPipeline *pipeline;
+  const FieldSpec *failedField;  // set by the preprocessing on failure
+  rs_wall_clock_ns_t preprocessTime;
+  uint8_t state;     // PendingDocState, claimed atomically and set to done under the pipeline lock
+  uint8_t refcount;  // held by the queue and by the worker job
+} PendingDoc;
+
+struct IndexingPipeline {
+  struct IndexSpec *spec;
+  pthread_mutex_t lock;
+  // Signaled when a worker is done preprocessing a document
+  pthread_cond_t done;
+  // Pending documents in submission order. Only accessed with the GIL held
+  arrayof(PendingDoc *) queue;
+  // An apply of the preprocessed documents is scheduled on the main thread
+  bool applyScheduled;
+};
+
+static void pendingDoc_Release(PendingDoc *pd) {
+  if (__atomic_sub_fetch(&pd->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+    rm_free(pd);
+  }
+}
+
+static bool pendingDoc_Claim(PendingDoc *pd) {
+  uint8_t expected = PendingDoc_Queued;
+  return __atomic_compare_exchange_n(&pd->state, &expected, PendingDoc_Claimed, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static void pendingDoc_Preprocess(PendingDoc *pd) {
+  rs_wall_clock start;
+  rs_wall_clock_init(&start);
+  AddDocumentCtx_Preprocess(pd->aCtx, &pd->failedField);
+  pd->preprocessTime = rs_wall_clock_elapsed_ns(&start);
+}
+
+static void applyPreprocessed(IndexingPipeline *pl, bool wait);
+
+static void applyOnMainThread(void *arg) {
+  StrongRef *ref = arg;
+  IndexSpec *sp = StrongRef_Get(*ref);
+  if (sp) {
+    IndexingPipeline *pl = sp->indexingPipeline;
+    pthread_mutex_lock(&pl->lock);
+    pl->applyScheduled = false;
+    pthread_mutex_unlock(&pl->lock);
+    applyPreprocessed(pl, false);
+  }
+  StrongRef_Release(*ref);
+  rm_free(ref);
+}
+
+static void preprocessJob(PendingDoc *pd) {
+  if (pendingDoc_Claim(pd)) {
+    pendingDoc_Preprocess(pd);
+
+    IndexingPipeline *pl = pd->pipeline;
+    pthread_mutex_lock(&pl->lock);
+    __atomic_store_n(&pd->state, PendingDoc_Done, __ATOMIC_RELEASE);
+    if (!pl->applyScheduled) {
+      // The spec cannot be unlinked yet: that flushes the pipeline first, which waits
+      // for this document under the lock
+      StrongRef *ref = rm_malloc(sizeof(*ref));
+      *ref = StrongRef_Clone(pl->spec->own_ref);
+      pl->applyScheduled = true;
+      RedisModule_EventLoopAddOneShot(applyOnMainThread, ref);
+    }
+    pthread_cond_broadcast(&pl->done);
+    pthread_mutex_unlock(&pl->lock);
+  }
+  pendingDoc_Release(pd);
+}
+
+/* Write the preprocessed documents at the head of the queue to the index, in a single
+ * write lock section. With `wait`, write all of them, preprocessing the ones no worker
+ * picked yet and waiting for the ones being preprocessed. Called with the GIL held */
+static void applyPreprocessed(IndexingPipeline *pl, bool wait) {
+  const size_t len = array_len(pl->queue);
+  size_t n = 0;
+  for (; n < len; ++n) {
+    PendingDoc *pd = pl->queue[n];
+    if (wait && pendingDoc_Claim(pd)) {
+      pendingDoc_Preprocess(pd);
+      __atomic_store_n(&pd->state, PendingDoc_Done, __ATOMIC_RELEASE);
+      continue;
+    }
+    if (__atomic_load_n(&pd->state, __ATOMIC_ACQUIRE) == PendingDoc_Done) {
+      continue;
+    }
+    if (!wait) {
+      // Applied by the one-shot its worker schedules
+      break;
+    }
+    pthread_mutex_lock(&pl->lock);
+    while (__atomic_load_n(&pd->state, __ATOMIC_ACQUIRE) != PendingDoc_Done) {
+      pthread_cond_wait(&pl->done, &pl->lock);
+    }
+    pthread_mutex_unlock(&pl->lock);
+  }
+  if (!n) {
+    return;
+  }
+
+  IndexSpec *sp = pl->spec;
+  RedisSearchCtx sctx = SEARCH_CTX_STATIC(RSDummyContext, sp);
+  rs_wall_clock start;
+  rs_wall_clock_init(&start);
+  rs_wall_clock_ns_t preprocessTime = 0;
+
+  RedisSearchCtx_LockSpecWrite(&sctx);
+  IndexSpec_IncrActiveWrites(sp);
+  for (size_t ii = 0; ii < n; ++ii) {
+    PendingDoc *pd = pl->queue[ii];
+    // Frees the context
+    AddDocumentCtx_ApplyPreprocessed(pd->aCtx, &sctx, pd->failedField);
+    preprocessTime += pd->preprocessTime;
+  }
+  IndexSpec_BumpWriteEpoch(sp);
+  sp->stats.totalIndexTime += rs_wall_clock_elapsed_ns(&start) + preprocessTime;
+  IndexSpec_DecrActiveWrites(sp);
+  RedisSearchCtx_UnlockSpec(&sctx);
+
+  for (size_t ii = 0; ii < n; ++ii) {
+    PendingDoc *pd = pl->queue[ii];
+    Document_Free(&pd->doc);
+    pendingDoc_Release(pd);
+  }
+  memmove(pl->queue, pl->queue + n, (len - n) * sizeof(*pl->queue));
+  array_set_len(pl->queue, len - n);
+}
+
+static size_t maxPending(bool scanned) {
+  return scanned ? RSGlobalConfig.bgIndexMaxPending : RSGlobalConfig.asyncIndexingMaxPending;
+}
+
+bool IndexingPipeline_Accepts(const IndexSpec *sp, RedisModuleKey *openKey, bool scanned) {
+  // A caller-provided key handle does not outlive the call, and the documents
+  // loaded while loading the RDB are indexed in bulk already
+  return maxPending(scanned) > 0 && RSGlobalConfig.numWorkerThreads > 0 &&
+         !sp->diskSpec && !openKey && !g_isLoading;
+}
+
+void IndexingPipeline_Submit(IndexSpec *sp, Document *doc, bool scanned) {
+  IndexingPipeline *pl = sp->indexingPipeline;
+  if (!pl) {
+    pl = rm_calloc(1, sizeof(*pl));
+    pl->spec = sp;
+    pthread_mutex_init(&pl->lock, NULL);
+    pthread_cond_init(&pl->done, NULL);
+    pl->queue = array_new(PendingDoc *, 16);
+    sp->indexingPipeline = pl;
+  } else if (array_len(pl->queue) >= maxPending(scanned)) {
+    applyPreprocessed(pl, true);
+  }
+
+  PendingDoc *pd = rm_calloc(1, sizeof(*pd));
+  pd->doc = *doc;
+  pd->pipeline = pl;
+
+  QueryError status = QueryError_Default();
+  RedisSearchCtx sctx = SEARCH_CTX_STATIC(RSDummyContext, sp);
+  RedisSearchCtx_LockSpecWrite(&sctx);
+  pd->aCtx = NewAddDocumentCtx(sp, &pd->doc, &status);
+  RedisSearchCtx_UnlockSpec(&sctx);
+  if (!pd->aCtx) {
+    QueryError_ClearError(&status);
+    Document_Free(&pd->doc);
+    rm_free(pd);
+    return;
+  }
+  pd->aCtx->stateFlags |= ACTX_F_NOFREEDOC;
+  pd->aCtx->options = DOCUMENT_ADD_REPLACE;
+  // The workers read the strings once we no longer hold the GIL
+  Document_MakeStringsOwner(&pd->doc);
+
+  pd->state = PendingDoc_Queued;
+  pd->refcount = 2;
+  array_append(pl->queue, pd);
+  workersThreadPool_AddWork((redisearch_thpool_proc)preprocessJob, pd);
+}
+
+void IndexingPipeline_Flush(IndexSpec *sp) {
+  if (sp->indexingPipeline) {
+    applyPreprocessed(sp->indexingPipeline, true);
+  }
+}
+
+void IndexingPipeline_FlushForQuery(IndexSpec *sp) {
+  if (RSGlobalConfig.asyncIndexingReadYourWrites) {
+    IndexingPipeline_Flush(sp);
+  }
+}
+
+bool IndexingPipeline_HasPending(const IndexSpec *sp) {
+  return sp->indexingPipeline && array_len(sp->indexingPipeline->queue);
+}
+
+void IndexingPipeline_Free(IndexingPipeline *pl) {
+  RS_ASSERT(!array_len(pl->queue));
+  array_free(pl->queue);
+  pthread_cond_destroy(&pl->done);
+  pthread_mutex_destroy(&pl->lock);
+  rm_free(pl);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stdbool.h>
+#include "redismodule.h"
+#include "document.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct IndexSpec;
+
+/**
+ * Per-index asynchronous indexing pipeline.
+ *
+ * A written document is loaded under the GIL as usual, then queued instead of
+ * being indexed right away. The worker threads run its field preprocessors
+ * (tokenization, stemming, tag splitting, numeric and geo parsing) in parallel
+ * with the main thread, and the preprocessed documents are written to the index
+ * in submission order, many at a time, in a single spec write lock section on
+ * the main thread.
+ *
+ * Any other write to the index first flushes its pending documents, so that the
+ * writes keep their order. Queries do so as well when ASYNC_INDEXING_READ_YOUR_WRITES
+ * is set. Enabled by ASYNC_INDEXING_MAX_PENDING, for in-memory indexes only.
+ *
+ * The documents loaded by the background scan of an index go through the pipeline
+ * as well, up to BG_INDEX_MAX_PENDING of them, so that indexing existing keys on
+ * FT.CREATE or FT.ALTER is spread over the worker threads.
+ */
+typedef struct IndexingPipeline IndexingPipeline;
+
+/**
+ * Whether a document loaded for `sp` may be queued, rather than indexed right away.
+ * `scanned` tells whether it was loaded by the background scan.
+ */
+bool IndexingPipeline_Accepts(const struct IndexSpec *sp, RedisModuleKey *openKey, bool scanned);
+
+/**
+ * Queue the loaded document `doc` for indexing in `sp`. Takes ownership of the
+ * document contents, like NewAddDocumentCtx. Waits for the pending documents to be
+ * indexed first if there are ASYNC_INDEXING_MAX_PENDING (BG_INDEX_MAX_PENDING when
+ * `scanned`) of them already. Called with the GIL held and without the spec lock.
+ */
+void IndexingPipeline_Submit(struct IndexSpec *sp, Document *doc, bool scanned);
+
+/**
+ * Index all the pending documents of `sp`, preprocessing on the calling thread the
+ * ones no worker picked yet. Called with the GIL held and without the spec lock.
+ */
+void IndexingPipeline_Flush(struct IndexSpec *sp);
+
+/** Flush the pending documents of `sp` if queries must read their own writes */
+void IndexingPipeline_FlushForQuery(struct IndexSpec *sp);
+
+/** Whether `sp` has documents waiting to be indexed */
+bool IndexingPipeline_HasPending(const struct IndexSpec *sp);
+
+/** Free an empty pipeline */
+void IndexingPipeline_Free(IndexingPipeline *pl);
+
+#ifdef __cplusplus
+}
+#endif
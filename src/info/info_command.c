@@ -18,6 +18,9 @@
 #include "indexes_scanner.h"
 #include "vector_index.h"
 #include "cursor.h"
+#include "query_cache.h"
+#include "filter_cache.h"
+#include "indexing_pipeline.h"
 #include "geometry/geometry_api.h"
 #include "geometry_index.h"
 #include "redismodule.h"
@@ -269,6 +272,9 @@ void fillReplyWithIndexInfo(RedisSearchCtx* sctx, RedisModule_Reply *reply, bool
     if (FieldSpec_HasSuffixTrie(fs)) {
       RedisModule_Reply_SimpleString(reply, SPEC_WITHSUFFIXTRIE_STR);
     }
+    if (FieldSpec_HasNgrams(fs)) {
+      RedisModule_Reply_SimpleString(reply, SPEC_WITHNGRAMS_STR);
+    }
     if (FieldSpec_IndexesEmpty(fs)) {
       RedisModule_Reply_SimpleString(reply, SPEC_INDEXEMPTY_STR);
     }
@@ -363,6 +369,8 @@ void fillReplyWithIndexInfo(RedisSearchCtx* sctx, RedisModule_Reply *reply, bool
   }
 
   Cursors_RenderStats(&g_CursorsList, &g_CursorsListCoord, sp, reply);
+  QueryCache_RenderStats(sp->queryCache, reply);
+  FilterCache_RenderStats(sp->filterCache, reply);
 
   // Unlock spec
   RedisSearchCtx_UnlockSpec(sctx);
@@ -409,6 +417,7 @@ int IndexInfoCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     return RedisModule_ReplyWithErrorFormat(ctx, "%s: %s", QueryError_Strerror(QUERY_ERROR_CODE_NO_INDEX), idx);
   }
   CurrentThread_SetIndexSpec(sp->own_ref);
+  IndexingPipeline_FlushForQuery(sp);
   const bool with_times = (argc > 2 && !strcmp(RedisModule_StringPtrLen(argv[2], NULL), WITH_INDEX_ERROR_TIME));
   RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, sp);
   RedisModule_Reply _reply = RedisModule_NewReply(ctx);
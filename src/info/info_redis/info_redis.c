@@ -32,6 +32,7 @@
 #include "info/info_redis/types/spec_info.h"
 #include "rmutil/rm_assert.h"
 #include "rs_wall_clock.h"
+#include "stem_cache.h"
 #include "util/dllist.h"
 #include "util/references.h"
 
@@ -47,7 +48,19 @@ static inline void AddToInfo_VectorIndex(RedisModuleInfoCtx *ctx, TotalIndexesIn
 static inline void AddToInfo_Cursors(RedisModuleInfoCtx *ctx);
 static inline void AddToInfo_GC(RedisModuleInfoCtx *ctx, TotalIndexesInfo *total_info);
 static inline void AddToInfo_Queries(RedisModuleInfoCtx *ctx, TotalIndexesInfo *total_info);
-static inline void AddToInfo_ErrorsAndWarnings(RedisModuleInfoCtx *ctx, TotalIndexesInfo *total_info);
+static inline void AddToInfo_StemCache(RedisModuleInfoCtx *ctx);
+static inline void AddToInfo_StemCache(RedisModuleInfoCtx *ctx) {
+  RedisModule_InfoAddSection(ctx, "stem_cache");
+  StemCacheStats stats = StemCache_GetStats();
+  RedisModule_InfoAddFieldULongLong(ctx, "stem_cache_hits", stats.hits);
+  RedisModule_InfoAddFieldULongLong(ctx, "stem_cache_misses", stats.misses);
+  double hitRate = stats.hits + stats.misses ? (double)stats.hits / (stats.hits + stats.misses) : 0;
+  RedisModule_InfoAddFieldDouble(ctx, "stem_cache_hit_rate", hitRate);
+  RedisModule_InfoAddFieldULongLong(ctx, "stem_cache_entries", stats.entries);
+  RedisModule_InfoAddFieldULongLong(ctx, "stem_cache_memory", stats.memory);
+}
+
+void AddToInfo_ErrorsAndWarnings(RedisModuleInfoCtx *ctx, TotalIndexesInfo *total_info);
 static inline void AddToInfo_MultiThreading(RedisModuleInfoCtx *ctx, TotalIndexesInfo *total_info);
 static inline void AddToInfo_Dialects(RedisModuleInfoCtx *ctx);
 static inline void AddToInfo_RSConfig(RedisModuleInfoCtx *ctx);
@@ -106,6 +119,9 @@ void RS_moduleInfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
   // Query statistics
   AddToInfo_Queries(ctx, &total_info);
 
+  // Stem cache statistics
+  AddToInfo_StemCache(ctx);
+
   // Errors statistics
   AddToInfo_ErrorsAndWarnings(ctx, &total_info);
 
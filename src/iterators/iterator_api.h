@@ -19,6 +19,7 @@ struct RLookupKey; // Forward declaration
 struct IndexSpec;
 typedef struct MapBuilder RsMapBuilder; // Opaque Rust type (redis_reply::MapBuilder)
 typedef struct ProfilePrintCtx RsProfilePrintCtx; // Opaque Rust type (rqe_iterators::profile_print::ProfilePrintCtx)
+typedef struct DocIdsBuffer RsDocIdsBuffer; // Opaque Rust type (Vec<t_docId>)
 
 typedef enum IteratorStatus {
   ITERATOR_OK,
@@ -40,6 +41,14 @@ typedef enum ValidateStatus {
                     // caller must surface it (`RS_RESULT_TIMEDOUT`) rather than end-of-results.
 } ValidateStatus;
 
+/* A caller-provided buffer filled by `ReadBatch` with the ids of the next results */
+typedef struct IteratorBatch {
+  t_docId *docIds;          // `capacity` entries
+  t_fieldMask *fieldMasks;  // NULL if not needed, `capacity` entries otherwise
+  size_t capacity;
+  size_t len;               // Entries filled so far. `ReadBatch` appends after them
+} IteratorBatch;
+
 /* An abstract interface used by readers / intersectors / uniones etc.
 Basically query execution creates a tree of iterators that activate each other
 recursively */
@@ -148,6 +157,30 @@ typedef struct QueryIterator {
    * Set by Rust iterators at construction time. C iterators set this to a
    * Rust-exported function. */
   void (*PrintProfile)(const struct QueryIterator *self, RsMapBuilder *map, RsProfilePrintCtx *ctx);
+
+  /* Decode into `out` the document IDs of the postings block holding the first entry at or after
+   * `docId`, without moving the iterator. Returns ITERATOR_OK, or ITERATOR_EOF if there is no such
+   * entry. See `RQEIterator::doc_ids_block` for the full contract.
+   * Set by Rust leaves reading an inverted index of document IDs only, NULL for every other
+   * iterator. */
+  IteratorStatus (*DocIdsBlock)(const struct QueryIterator *self, t_docId docId, RsDocIdsBuffer *out);
+
+  /* Read up to `batch->capacity - batch->len` entries, as that many calls to `Read` would, and append
+   * their ids (and field masks, if `batch->fieldMasks` is set) to `batch`. Afterwards the iterator
+   * stands where those reads would have left it: on the last entry appended, or at EOF if the
+   * batch was not filled.
+   * @returns ITERATOR_OK if at least one entry was appended, ITERATOR_EOF if the iterator is
+   * depleted, or ITERATOR_TIMEOUT - entries appended before the deadline are kept in `batch`.
+   * Set by Rust iterators, NULL for C iterators, for which callers fall back to `Read`. */
+  IteratorStatus (*ReadBatch)(struct QueryIterator *self, IteratorBatch *batch);
+
+  /* Set bit `i % 64` of `words[i / 64]` for every document `docId + i` the iterator yields at or
+   * after its current position, for `i < 64 * len`, without moving the iterator. Bits already set
+   * are kept. Returns ITERATOR_OK, or ITERATOR_TIMEOUT. See `RQEIterator::doc_ids_words` for the
+   * full contract.
+   * Set by Rust leaves reading an inverted index of document IDs only and by the wildcard
+   * iterators, NULL for every other iterator. */
+  IteratorStatus (*DocIdsWords)(const struct QueryIterator *self, t_docId docId, uint64_t *words, size_t len);
 } QueryIterator;
 
 static inline ValidateStatus Default_Revalidate(struct QueryIterator *base, struct IndexSpec *spec) {
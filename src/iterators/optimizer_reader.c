@@ -324,6 +324,9 @@ QueryIterator *NewOptimizerIterator(QOptimizer *qOpt, QueryIterator *root, Itera
   ri->Read = OPT_Read;
   ri->ProfileChildren = OPT_ProfileChildren;
   ri->PrintProfile = Optimus_PrintProfile;
+  ri->DocIdsBlock = NULL;
+  ri->ReadBatch = NULL;
+  ri->DocIdsWords = NULL;
   ri->current = NULL;
 
   return &oi->base;
@@ -33,6 +33,7 @@
 #include "spec.h"
 #include "indexes.h"
 #include "indexes_scan.h"
+#include "indexing_pipeline.h"
 #include "util/workers.h"
 #include "util/references.h"
 #include "config.h"
@@ -108,6 +109,7 @@
 #include "slots_tracker_ffi.h"
 #include "special_case_ctx.h"
 #include "stopwords.h"
+#include "stem_cache.h"
 #include "synonym_map.h"
 #include "trie/trie.h"
 #include "util/arr/arr.h"
@@ -882,6 +884,9 @@ int SynUpdateCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     IndexSpec_ScanAndReindex(ctx, ref);
   }
 
+  // Queries expanded with the previous synonyms are stale
+  IndexSpec_BumpWriteEpoch(sp);
+
   RedisSearchCtx_UnlockSpec(&sctx);
   CurrentThread_ClearIndexSpec();
 
@@ -1009,6 +1014,8 @@ static int AlterIndexInternalCommand(RedisModuleCtx *ctx, RedisModuleString **ar
       return RedisModule_ReplyWithSimpleString(ctx, "OK");
     }
   }
+  // The pending documents were loaded with the previous schema
+  IndexingPipeline_Flush(sp);
   RedisSearchCtx_LockSpecWrite(&sctx);
   int addFieldsOk = IndexSpec_AddFields(ref, sp, ctx, &ac, &status);
 
@@ -1951,6 +1958,7 @@ void RediSearch_CleanupModule(RedisModuleCtx *ctx) {
   // free global structures
   Extensions_Free();
   StopWordList_FreeGlobals();
+  StemCache_Free();
   FunctionRegistry_Free();
   mempool_free_global();
   IndexAlias_DestroyGlobal(&AliasTable_g);
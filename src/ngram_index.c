@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "ngram_index.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rmalloc.h"
+#include "redisearch.h"
+#include "util/arr.h"
+#include "util/khash.h"
+#include "util/timeout.h"
+#include "wildcard/wildcard.h"
+
+// The ids of the terms containing a trigram, sorted
+typedef struct {
+  uint32_t *ids;
+  uint32_t len;
+  uint32_t cap;
+} NgramPostings;
+
+KHASH_MAP_INIT_INT64(ngramPostings, NgramPostings);
+KHASH_MAP_INIT_STR(ngramTermIds, uint32_t);
+
+struct NgramIndex {
+  khash_t(ngramPostings) *postings;
+  // Id of each term. The keys are owned by `terms`
+  khash_t(ngramTermIds) *termIds;
+  // Term of each id, NULL for the ids in `freeIds`
+  arrayof(char *) terms;
+  arrayof(uint32_t) freeIds;
+  // Bytes of the terms and of the posting lists
+  size_t memory;
+};
+
+static inline uint64_t ngramKey(const rune *r) {
+  return ((uint64_t)r[0] << 32) | ((uint64_t)r[1] << 16) | r[2];
+}
+
+// Index of the first id >= `id` in `p`
+static inline uint32_t postingsLowerBound(const NgramPostings *p, uint32_t id) {
+  uint32_t lo = 0, hi = p->len;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (p->ids[mid] < id) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static void postingsResize(NgramIndex *idx, NgramPostings *p, uint32_t cap) {
+  p->ids = rm_realloc(p->ids, cap * sizeof(*p->ids));
+  idx->memory -= p->cap * sizeof(*p->ids);
+  idx->memory += cap * sizeof(*p->ids);
+  p->cap = cap;
+}
+
+static void postingsInsert(NgramIndex *idx, NgramPostings *p, uint32_t id) {
+  // Ids are mostly handed out in increasing order
+  const uint32_t pos = (p->len && p->ids[p->len - 1] >= id) ? postingsLowerBound(p, id) : p->len;
+  if (pos < p->len && p->ids[pos] == id) {
+    // A term holding the same trigram more than once
+    return;
+  }
+  if (p->len == p->cap) {
+    postingsResize(idx, p, p->cap ? p->cap * 2 : 2);
+  }
+  memmove(p->ids + pos + 1, p->ids + pos, (p->len - pos) * sizeof(*p->ids));
+  p->ids[pos] = id;
+  p->len++;
+}
+
+static void postingsRemove(NgramIndex *idx, NgramPostings *p, uint32_t id) {
+  const uint32_t pos = postingsLowerBound(p, id);
+  if (pos == p->len || p->ids[pos] != id) {
+    return;
+  }
+  memmove(p->ids + pos, p->ids + pos + 1, (p->len - pos - 1) * sizeof(*p->ids));
+  p->len--;
+  if (p->len && p->len <= p->cap / 4) {
+    postingsResize(idx, p, p->cap / 2);
+  }
+}
+
+NgramIndex *NewNgramIndex(void) {
+  NgramIndex *idx = rm_calloc(1, sizeof(*idx));
+  idx->postings = kh_init(ngramPostings);
+  idx->termIds = kh_init(ngramTermIds);
+  idx->terms = array_new(char *, 16);
+  idx->freeIds = array_new(uint32_t, 4);
+  return idx;
+}
+
+void NgramIndex_Free(NgramIndex *idx) {
+  if (!idx) {
+    return;
+  }
+  NgramPostings p;
+  kh_foreach_value(idx->postings, p, rm_free(p.ids));
+  kh_destroy(ngramPostings, idx->postings);
+  kh_destroy(ngramTermIds, idx->termIds);
+  array_free_ex(idx->terms, rm_free(*(char **)ptr));
+  array_free(idx->freeIds);
+  rm_free(idx);
+}
+
+void NgramIndex_Add(NgramIndex *idx, const char *term, size_t len) {
+  runeBuf buf;
+  size_t rlen;
+  rune *runes = runeBufFill(term, len, &buf, &rlen);
+  // Shorter terms cannot hold a pattern that has trigrams
+  if (rlen < NGRAM_LEN) {
+    goto done;
+  }
+
+  char *key = rm_strndup(term, len);
+  int absent;
+  khiter_t k = kh_put(ngramTermIds, idx->termIds, key, &absent);
+  if (!absent) {
+    rm_free(key);
+    goto done;
+  }
+  uint32_t id;
+  if (array_len(idx->freeIds)) {
+    id = array_pop(idx->freeIds);
+    idx->terms[id] = key;
+  } else {
+    id = array_len(idx->terms);
+    array_append(idx->terms, key);
+  }
+  kh_val(idx->termIds, k) = id;
+  idx->memory += len + 1;
+
+  for (size_t ii = 0; ii + NGRAM_LEN <= rlen; ++ii) {
+    khiter_t pk = kh_put(ngramPostings, idx->postings, ngramKey(runes + ii), &absent);
+    if (absent) {
+      kh_val(idx->postings, pk) = (NgramPostings){0};
+    }
+    postingsInsert(idx, &kh_val(idx->postings, pk), id);
+  }
+
+done:
+  runeBufFree(&buf);
+}
+
+void NgramIndex_Delete(NgramIndex *idx, const char *term, size_t len) {
+  char *key = rm_strndup(term, len);
+  khiter_t k = kh_get(ngramTermIds, idx->termIds, key);
+  rm_free(key);
+  if (k == kh_end(idx->termIds)) {
+    return;
+  }
+  const uint32_t id = kh_val(idx->termIds, k);
+  char *stored = (char *)kh_key(idx->termIds, k);
+  kh_del(ngramTermIds, idx->termIds, k);
+
+  runeBuf buf;
+  size_t rlen;
+  rune *runes = runeBufFill(stored, len, &buf, &rlen);
+  for (size_t ii = 0; ii + NGRAM_LEN <= rlen; ++ii) {
+    khiter_t pk = kh_get(ngramPostings, idx->postings, ngramKey(runes + ii));
+    if (pk == kh_end(idx->postings)) {
+      continue;
+    }
+    NgramPostings *p = &kh_val(idx->postings, pk);
+    postingsRemove(idx, p, id);
+    if (!p->len) {
+      idx->memory -= p->cap * sizeof(*p->ids);
+      rm_free(p->ids);
+      kh_del(ngramPostings, idx->postings, pk);
+    }
+  }
+  runeBufFree(&buf);
+
+  idx->terms[id] = NULL;
+  array_append(idx->freeIds, id);
+  idx->memory -= len + 1;
+  rm_free(stored);
+}
+
+size_t NgramIndex_NumTerms(const NgramIndex *idx) {
+  return kh_size(idx->termIds);
+}
+
+size_t NgramIndex_MemUsage(const NgramIndex *idx) {
+  return sizeof(*idx) + idx->memory +
+         kh_n_buckets(idx->postings) * (sizeof(uint64_t) + sizeof(NgramPostings)) +
+         kh_n_buckets(idx->termIds) * (sizeof(char *) + sizeof(uint32_t)) +
+         array_cap(idx->terms) * sizeof(char *) + array_cap(idx->freeIds) * sizeof(uint32_t);
+}
+
+/***********************************************************************************
+ *                                     Queries                                     *
+ ***********************************************************************************/
+
+typedef struct {
+  const NgramIndex *idx;
+  // Posting lists of the trigrams of the pattern, shortest first
+  arrayof(const NgramPostings *) lists;
+  // Whether a trigram of the pattern is in no term, so nothing can match
+  bool empty;
+} NgramQuery;
+
+// Add the trigrams of the `len` runes of `run` to the query
+static void ngramQuery_AddRun(NgramQuery *q, const rune *run, size_t len) {
+  for (size_t ii = 0; !q->empty && ii + NGRAM_LEN <= len; ++ii) {
+    khiter_t k = kh_get(ngramPostings, q->idx->postings, ngramKey(run + ii));
+    if (k == kh_end(q->idx->postings)) {
+      q->empty = true;
+    } else {
+      array_append(q->lists, &kh_val(q->idx->postings, k));
+    }
+  }
+}
+
+static int cmpListLen(const void *a, const void *b) {
+  const NgramPostings *la = *(const NgramPostings **)a, *lb = *(const NgramPostings **)b;
+  return la->len < lb->len ? -1 : la->len > lb->len;
+}
+
+// The ids of the terms holding all the trigrams of the query. The caller frees the array
+static arrayof(uint32_t) ngramQuery_Candidates(NgramQuery *q) {
+  if (q->empty || !array_len(q->lists)) {
+    return array_new(uint32_t, 0);
+  }
+  qsort(q->lists, array_len(q->lists), sizeof(*q->lists), cmpListLen);
+  const NgramPostings *shortest = q->lists[0];
+  arrayof(uint32_t) ids = array_newlen(uint32_t, shortest->len);
+  memcpy(ids, shortest->ids, shortest->len * sizeof(*ids));
+
+  for (uint32_t ii = 1; ii < array_len(q->lists) && array_len(ids); ++ii) {
+    const NgramPostings *p = q->lists[ii];
+    if (p == q->lists[ii - 1]) {
+      continue;  // a trigram repeated in the pattern
+    }
+    // Both lists are sorted, so the search resumes where the last one ended
+    uint32_t kept = 0, from = 0;
+    for (uint32_t jj = 0; jj < array_len(ids) && from < p->len; ++jj) {
+      NgramPostings rest = {.ids = p->ids + from, .len = p->len - from};
+      from += postingsLowerBound(&rest, ids[jj]);
+      if (from < p->len && p->ids[from] == ids[jj]) {
+        ids[kept++] = ids[jj];
+      }
+    }
+    array_set_len(ids, kept);
+  }
+  return ids;
+}
+
+static bool containsRunes(const rune *str, size_t len, const rune *pattern, size_t plen) {
+  for (size_t ii = 0; ii + plen <= len; ++ii) {
+    if (!memcmp(str + ii, pattern, plen * sizeof(*pattern))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int NgramIndex_IterateContains(const NgramIndex *idx, const rune *pattern, size_t len,
+                               SuffixType type, TrieSuffixCallback *callback, void *ctx) {
+  if (len < NGRAM_LEN) {
+    return 0;
+  }
+  NgramQuery q = {.idx = idx, .lists = array_new(const NgramPostings *, len)};
+  ngramQuery_AddRun(&q, pattern, len);
+  arrayof(uint32_t) ids = ngramQuery_Candidates(&q);
+  array_free(q.lists);
+
+  for (uint32_t ii = 0; ii < array_len(ids); ++ii) {
+    const char *term = idx->terms[ids[ii]];
+    const size_t termLen = strlen(term);
+    runeBuf buf;
+    size_t rlen;
+    const rune *runes = runeBufFill(term, termLen, &buf, &rlen);
+    const bool match = type == SUFFIX_TYPE_SUFFIX
+        ? rlen >= len && !memcmp(runes + rlen - len, pattern, len * sizeof(*pattern))
+        : containsRunes(runes, rlen, pattern, len);
+    runeBufFree(&buf);
+    if (match && callback(term, termLen, ctx, NULL) != REDISMODULE_OK) {
+      break;
+    }
+  }
+  array_free(ids);
+  return 1;
+}
+
+// True if the UTF-8 string contains a supplementary-plane codepoint, which the
+// 16-bit runes of the terms trie cannot represent
+static bool containsSupplementaryCodepoint(const char *str, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    if ((unsigned char)str[i] >= 0xF0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int NgramIndex_IterateWildcard(const NgramIndex *idx, const rune *pattern, size_t len,
+                               TrieSuffixCallback *callback, void *ctx,
+                               struct timespec *timeout, bool skipTimeoutChecks) {
+  NgramQuery q = {.idx = idx, .lists = array_new(const NgramPostings *, len)};
+  bool anchored = false;
+  for (size_t start = 0, end = 0; start < len; start = end + 1) {
+    end = start;
+    while (end < len && pattern[end] != (rune)'*' && pattern[end] != (rune)'?') {
+      ++end;
+    }
+    if (end - start >= NGRAM_LEN) {
+      anchored = true;
+      ngramQuery_AddRun(&q, pattern + start, end - start);
+    }
+  }
+  if (!anchored) {
+    array_free(q.lists);
+    return 0;
+  }
+  arrayof(uint32_t) ids = ngramQuery_Candidates(&q);
+  array_free(q.lists);
+
+  uint32_t timeoutCounter = 0;
+  for (uint32_t ii = 0; ii < array_len(ids); ++ii) {
+    if (!skipTimeoutChecks && TimedOut_WithCounter(timeout, &timeoutCounter)) {
+      break;
+    }
+    const char *term = idx->terms[ids[ii]];
+    const size_t termLen = strlen(term);
+    // Keep the results identical to the scan of the terms trie, as the suffix trie does
+    if (containsSupplementaryCodepoint(term, termLen)) {
+      continue;
+    }
+    runeBuf buf;
+    size_t rlen;
+    const rune *runes = runeBufFill(term, termLen, &buf, &rlen);
+    const match_t match = Wildcard_MatchRune(pattern, len, runes, rlen);
+    runeBufFree(&buf);
+    if (match == FULL_MATCH && callback(term, termLen, ctx, NULL) != REDISMODULE_OK) {
+      break;
+    }
+  }
+  array_free(ids);
+  return 1;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "suffix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct timespec;
+
+/**
+ * Trigram index of the TEXT terms of the fields created WITHNGRAMS.
+ *
+ * Each indexed term gets an id, and every NGRAM_LEN consecutive runes of a term
+ * map to the sorted list of the ids of the terms containing them. A suffix,
+ * contains or wildcard pattern is answered by intersecting the lists of its
+ * trigrams and matching the remaining candidates against the pattern.
+ *
+ * Unlike the suffix trie, which stores every suffix of every term, the index
+ * grows linearly with the length of the terms. Patterns without a literal run
+ * of NGRAM_LEN runes are not answered, and the caller scans the terms trie.
+ */
+#define NGRAM_LEN 3
+
+typedef struct NgramIndex NgramIndex;
+
+NgramIndex *NewNgramIndex(void);
+void NgramIndex_Free(NgramIndex *idx);
+
+/* Add the `len` bytes of `term`. Adding a term twice does nothing */
+void NgramIndex_Add(NgramIndex *idx, const char *term, size_t len);
+
+/* Remove the `len` bytes of `term`, if it was added */
+void NgramIndex_Delete(NgramIndex *idx, const char *term, size_t len);
+
+size_t NgramIndex_NumTerms(const NgramIndex *idx);
+size_t NgramIndex_MemUsage(const NgramIndex *idx);
+
+/**
+ * Call `callback` with each term ending with (SUFFIX_TYPE_SUFFIX) or containing
+ * (SUFFIX_TYPE_CONTAINS) the `len` runes of `pattern`, until it returns non-zero.
+ * Each term is reported once, in no particular order.
+ * Returns 0, without calling `callback`, if the pattern is shorter than NGRAM_LEN.
+ */
+int NgramIndex_IterateContains(const NgramIndex *idx, const rune *pattern, size_t len,
+                               SuffixType type, TrieSuffixCallback *callback, void *ctx);
+
+/**
+ * Call `callback` with each term matching the NUL-terminated wildcard `pattern` of
+ * `len` runes, until it returns non-zero or `timeout` is reached.
+ * Returns 0, without calling `callback`, if no run of the pattern between
+ * wildcards holds NGRAM_LEN runes.
+ */
+int NgramIndex_IterateWildcard(const NgramIndex *idx, const rune *pattern, size_t len,
+                               TrieSuffixCallback *callback, void *ctx,
+                               struct timespec *timeout, bool skipTimeoutChecks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -213,7 +213,7 @@ int HandleKeyspaceNotification(RedisModuleCtx *ctx, int type, enum RedisCmd redi
       // document we must copy it
       if (!IS_SST_RDB_LOADING(ctx)) {
         key = RedisModule_CreateStringFromString(ctx, key);
-        Indexes_UpdateMatchingWithSchemaRules(ctx, key, getDocTypeFromString(key), hashFields); //TODO: avoid getDocTypeFromString ?
+        Indexes_UpdateMatchingLoadedKey(ctx, key, getDocTypeFromString(key)); //TODO: avoid getDocTypeFromString ?
         RedisModule_FreeString(ctx, key);
       }
       break;
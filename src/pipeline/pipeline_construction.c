@@ -45,7 +45,7 @@ extern "C" {
 
 static ResultProcessor *buildGroupRP(PLN_GroupStep *gstp, RLookup *srclookup,
                                      const RLookupKey ***loadKeys, uint32_t reqflags,
-                                     GroupByLimits groupByLimits,
+                                     GroupByLimits groupByLimits, size_t numPartitions,
                                      QueryError *err) {
   arrayof(const char*) properties = PLNGroupStep_GetProperties(gstp);
   size_t nproperties = array_len(properties);
@@ -77,6 +77,7 @@ static ResultProcessor *buildGroupRP(PLN_GroupStep *gstp, RLookup *srclookup,
   Grouper *grp = Grouper_New(srckeys, dstkeys, nproperties, groupByLimits);
 
   size_t nreducers = array_len(gstp->reducers);
+  ArgsCursor reducerArgs[nreducers];  // To build more instances of the reducers
   for (size_t ii = 0; ii < nreducers; ++ii) {
     // Build the actual reducer
     PLN_Reducer *pr = gstp->reducers + ii;
@@ -94,6 +95,7 @@ static ResultProcessor *buildGroupRP(PLN_GroupStep *gstp, RLookup *srclookup,
     ReducerOptions options = REDUCEROPTS_INIT(pr->name, &pr->args, srclookup, loadKeys, err,
                                               gstp->strictPrefix, pr->isLocal, input_key,
                                               reqflags);
+    reducerArgs[ii] = pr->args;
     ReducerFactory ff = RDCR_GetFactory(pr->name);
     if (!ff) {
       // No such reducer!
@@ -119,6 +121,30 @@ static ResultProcessor *buildGroupRP(PLN_GroupStep *gstp, RLookup *srclookup,
     }
   }
 
+  // Group in parallel, with one more instance of every reducer for each extra partition. The
+  // reducers were built once already, so their keys are all readable: the extra instances are
+  // built without `loadKeys`, so that the fields to load are only registered once.
+  if (numPartitions > 1) {
+    Grouper_SetPartitions(grp, numPartitions);
+    for (size_t part = 1; part < numPartitions; ++part) {
+      for (size_t ii = 0; ii < nreducers; ++ii) {
+        PLN_Reducer *pr = gstp->reducers + ii;
+        ArgsCursor args = reducerArgs[ii];
+        const RLookupKey *input_key =
+            pr->inputAlias ? RLookup_GetKey_Read(srclookup, pr->inputAlias, RLOOKUP_F_HIDDEN) : NULL;
+        ReducerOptions options = REDUCEROPTS_INIT(pr->name, &args, srclookup, NULL, err,
+                                                  gstp->strictPrefix, pr->isLocal, input_key,
+                                                  reqflags);
+        Reducer *rr = RDCR_GetFactory(pr->name)(&options);
+        if (!rr) {
+          Grouper_Free(grp);
+          return NULL;
+        }
+        Grouper_AddPartitionReducer(grp, part, rr);
+      }
+    }
+  }
+
   return Grouper_GetRP(grp);
 }
 
@@ -163,9 +189,16 @@ static ResultProcessor *getGroupRP(Pipeline *pipeline, const AggregationPipeline
   RLookup *lookup = AGPLN_GetLookup(&pipeline->ap, &gstp->base, AGPLN_GETLOOKUP_PREV);
   RLookup *firstLk = AGPLN_GetLookup(&pipeline->ap, &gstp->base, AGPLN_GETLOOKUP_FIRST); // first lookup can load fields from redis
   const RLookupKey **loadKeys = NULL;
+  // Like the scan (see partitionScan), a query estimated to match fewer than
+  // QUERY_PARALLEL_MIN_DOCS documents is grouped serially
+  size_t numPartitions = MIN(RSGlobalConfig.queryMaxParallelism, RSGlobalConfig.numWorkerThreads);
+  QueryIterator *root = QITR_GetRootFilter(&pipeline->qctx);
+  if (root && root->NumEstimated(root) < RSGlobalConfig.queryParallelMinDocs) {
+    numPartitions = 1;
+  }
   ResultProcessor *groupRP = buildGroupRP(
       gstp, lookup, (firstLk == lookup && RLookup_HasIndexSpecCache(firstLk)) ? &loadKeys : NULL,
-      params->common.reqflags, params->groupByLimits, status);
+      params->common.reqflags, params->groupByLimits, numPartitions, status);
 
   if (!groupRP) {
     array_free(loadKeys);
@@ -705,6 +738,7 @@ int Pipeline_BuildAggregationPart(Pipeline *pipeline, const AggregationPipelineP
         if (ExprAST_GetLookupKeys(mstp->parsedExpr, curLookup, status) == EXPR_EVAL_ERR) {
           goto error;
         }
+        ExprAST_Compile(mstp->parsedExpr);
 
         if (stp->type == PLN_T_APPLY) {
           uint32_t flags = mstp->noOverride ? RLOOKUP_F_NOFLAGS : RLOOKUP_F_OVERRIDE;
@@ -87,6 +87,9 @@ static double _recursiveProfilePrint(RedisModule_Reply *reply, ResultProcessor *
       (rp->upstream->type == RP_LOADER || rp->upstream->type == RP_SAFE_LOADER)) {
     RPLoader_ReplyProfileFields(reply, rp->upstream);
   }
+  if (rp->upstream && rp->upstream->type == RP_GROUP && Grouper_NumPartitions(rp->upstream) > 1) {
+    RedisModule_ReplyKV_LongLong(reply, "Partitions", Grouper_NumPartitions(rp->upstream));
+  }
   RedisModule_Reply_MapEnd(reply); // end of recursive map
   return totalRPTime;
 }
@@ -50,6 +50,7 @@
 #include "geometry_index.h"
 #include "obfuscation/hidden.h"
 #include "param.h"
+#include "filter_cache.h"
 #include "query_flags.h"
 #include "query_param.h"
 #include "query_parser/tokenizer.h"
@@ -963,8 +964,10 @@ QueryIterator *Query_EvalNode(QueryEvalCtx *q, QueryNode *n, const EvalConfig *e
     case QN_FUZZY:
       // These node types have been ported to Rust.
       return Query_EvalNode_Rs(q, n, evalConfig);
-    case QN_TAG:
-      return Query_EvalTagNode(q, n);
+    case QN_TAG: {
+      QueryIterator *cached = Query_EvalCachedFilter(q, n, evalConfig);
+      return cached ? cached : Query_EvalTagNode(q, n);
+    }
     case QN_VECTOR:
       return Query_EvalVectorNode(q, n, evalConfig);
     case QN_MAX: // LCOV_EXCL_LINE — exhaustive switch: all valid QN types handled above
@@ -1580,6 +1583,243 @@ void QAST_Print(const QueryAST *ast, const IndexSpec *spec) {
   sdsfree(s);
 }
 
+// Append the raw bytes of `v` to the cache key `s`
+#define KEY_APPEND(s, v) sdscatlen((s), &(v), sizeof(v))
+
+static sds keyAppendStr(sds s, const char *str, size_t len) {
+  s = KEY_APPEND(s, len);
+  return len ? sdscatlen(s, str, len) : s;
+}
+
+static sds keyAppendToken(sds s, const RSToken *tok) {
+  const uint32_t bits = tok->expanded | ((uint32_t)tok->flags << 1);
+  s = KEY_APPEND(s, bits);
+  return keyAppendStr(s, tok->str, tok->len);
+}
+
+static sds keyAppendFieldIndex(sds s, const FieldSpec *fs) {
+  const t_fieldIndex index = fs ? fs->index : RS_INVALID_FIELD_INDEX;
+  return KEY_APPEND(s, index);
+}
+
+static sds QueryNode_CacheKey(sds s, const QueryNode *qs) {
+  const QueryNodeOptions *opts = &qs->opts;
+  s = KEY_APPEND(s, qs->type);
+  s = KEY_APPEND(s, opts->flags);
+  s = KEY_APPEND(s, opts->fieldMask);
+  s = KEY_APPEND(s, opts->fieldIndex);
+  s = KEY_APPEND(s, opts->maxSlop);
+  s = KEY_APPEND(s, opts->inOrder);
+  s = KEY_APPEND(s, opts->weight);
+  s = KEY_APPEND(s, opts->phonetic);
+  s = keyAppendStr(s, opts->distField, opts->distField ? strlen(opts->distField) : 0);
+
+  switch (qs->type) {
+    case QN_PHRASE:
+      s = KEY_APPEND(s, qs->pn.exact);
+      break;
+    case QN_TOKEN:
+      s = keyAppendToken(s, &qs->tn);
+      break;
+    case QN_PREFIX:
+      s = keyAppendToken(s, &qs->pfx.tok);
+      s = KEY_APPEND(s, qs->pfx.prefix);
+      s = KEY_APPEND(s, qs->pfx.suffix);
+      break;
+    case QN_FUZZY:
+      s = keyAppendToken(s, &qs->fz.tok);
+      s = KEY_APPEND(s, qs->fz.maxDist);
+      break;
+    case QN_WILDCARD_QUERY:
+      s = keyAppendToken(s, &qs->verb.tok);
+      break;
+    case QN_NUMERIC: {
+      const NumericFilter *f = qs->nn.nf;
+      s = keyAppendFieldIndex(s, f->fieldSpec);
+      s = KEY_APPEND(s, f->min);
+      s = KEY_APPEND(s, f->max);
+      s = KEY_APPEND(s, f->minInclusive);
+      s = KEY_APPEND(s, f->maxInclusive);
+      s = KEY_APPEND(s, f->ascending);
+      s = KEY_APPEND(s, f->limit);
+      s = KEY_APPEND(s, f->offset);
+    } break;
+    case QN_GEO: {
+      const GeoFilter *gf = qs->gn.gf;
+      s = keyAppendFieldIndex(s, gf->fieldSpec);
+      s = KEY_APPEND(s, gf->lat);
+      s = KEY_APPEND(s, gf->lon);
+      s = KEY_APPEND(s, gf->radius);
+      s = KEY_APPEND(s, gf->unitType);
+    } break;
+    case QN_GEOMETRY: {
+      const GeometryQuery *gq = qs->gmn.geomq;
+      s = keyAppendFieldIndex(s, gq->fs);
+      s = KEY_APPEND(s, gq->format);
+      s = KEY_APPEND(s, gq->query_type);
+      s = keyAppendStr(s, gq->str, gq->str_len);
+    } break;
+    case QN_IDS:
+      s = KEY_APPEND(s, qs->fn.len);
+      for (size_t i = 0; i < qs->fn.len; i++) {
+        if (qs->fn.docIds) {
+          s = KEY_APPEND(s, qs->fn.docIds[i]);
+        } else {
+          size_t len;
+          const char *key = RedisModule_StringPtrLen(qs->fn.keys[i], &len);
+          s = keyAppendStr(s, key, len);
+        }
+      }
+      break;
+    case QN_TAG:
+      s = keyAppendFieldIndex(s, qs->tag.fs);
+      break;
+    case QN_MISSING:
+      s = keyAppendFieldIndex(s, qs->miss.field);
+      break;
+    case QN_VECTOR: {
+      const VectorQuery *vq = qs->vn.vq;
+      s = keyAppendFieldIndex(s, vq->field);
+      s = keyAppendStr(s, vq->scoreField, vq->scoreField ? strlen(vq->scoreField) : 0);
+      s = KEY_APPEND(s, vq->type);
+      if (vq->type == VECSIM_QT_KNN) {
+        s = keyAppendStr(s, vq->knn.vector, vq->knn.vecLen);
+        s = KEY_APPEND(s, vq->knn.k);
+        s = KEY_APPEND(s, vq->knn.order);
+        s = KEY_APPEND(s, vq->knn.shardWindowRatio);
+      } else {
+        s = keyAppendStr(s, vq->range.vector, vq->range.vecLen);
+        s = KEY_APPEND(s, vq->range.radius);
+        s = KEY_APPEND(s, vq->range.order);
+      }
+      const size_t nparams = array_len(vq->params.params);
+      s = KEY_APPEND(s, nparams);
+      for (size_t i = 0; i < nparams; i++) {
+        const VecSimRawParam *param = &vq->params.params[i];
+        s = keyAppendStr(s, param->name, param->nameLen);
+        s = keyAppendStr(s, param->value, param->valLen);
+      }
+    } break;
+    case QN_NOT:
+    case QN_OPTIONAL:
+    case QN_UNION:
+    case QN_WILDCARD:
+    case QN_NULL:
+      break;
+    case QN_MAX: // LCOV_EXCL_LINE — exhaustive switch: all valid QN types handled above
+      RS_ABORT("Invalid query node type"); // LCOV_EXCL_LINE
+  }
+
+  const size_t nchildren = QueryNode_NumChildren(qs);
+  s = KEY_APPEND(s, nchildren);
+  for (size_t ii = 0; ii < nchildren; ++ii) {
+    s = QueryNode_CacheKey(s, qs->children[ii]);
+  }
+  return s;
+}
+
+// The field filtered on by a node the filter cache applies to, or NULL
+static const FieldSpec *cachedFilterField(const QueryNode *n) {
+  switch (n->type) {
+    case QN_TAG:
+      return n->tag.fs;
+    case QN_NUMERIC:
+      return n->nn.nf->fieldSpec;
+    case QN_GEO:
+      // The distance of each document is yielded along with it
+      return n->opts.distField ? NULL : n->gn.gf->fieldSpec;
+    default:
+      return NULL;
+  }
+}
+
+// Whether the results of the node may reach a scorer. A cached filter yields
+// virtual results, which do not carry the term, frequency and IDF the scorers
+// read from the results of the filter's own iterator.
+static bool filterMayScore(const QueryEvalCtx *q, const QueryNode *n) {
+  if (q->inNotSubTree || n->opts.weight == 0) {
+    return false;
+  }
+  const uint32_t flags = q->reqFlags;
+  if (flags & (QEXEC_F_SEND_SCORES | QEXEC_F_SEND_SCORES_AS_FIELD)) {
+    return true;
+  }
+  // Same as the pipeline, searches returning rows are scored unless sorted otherwise
+  return (flags & (QEXEC_F_IS_SEARCH | QEXEC_F_IS_HYBRID_SEARCH_SUBQUERY)) && !(flags & QEXEC_F_NOROWS);
+}
+
+QueryIterator *Query_EvalCachedFilter(QueryEvalCtx *q, QueryNode *n, const EvalConfig *evalConfig) {
+  const size_t maxMemory = RSGlobalConfig.filterCacheMaxMemory;
+  if (!maxMemory || q->inFilterCacheFill || !q->sctx || !q->sctx->spec) {
+    return NULL;
+  }
+  const IndexSpec *spec = q->sctx->spec;
+  FilterCache *fc = spec->filterCache;
+  const FieldSpec *fs = cachedFilterField(n);
+  // Expiring fields are only filtered out by the index readers
+  if (!fc || !fs || spec->diskSpec || spec->docs.ttl || (q->opts->flags & Search_NoCache) ||
+      filterMayScore(q, n)) {
+    return NULL;
+  }
+
+  sds key = QueryNode_CacheKey(sdsempty(), n);
+  t_docId *ids = NULL;
+  size_t len = 0;
+  switch (FilterCache_Get(fc, key, fs->index, &ids, &len)) {
+    case FilterCache_Hit:
+      sdsfree(key);
+      return len ? NewSortedIdListIterator(ids, len, n->opts.weight) : NewEmptyIterator();
+    case FilterCache_Miss:
+      sdsfree(key);
+      return NULL;
+    case FilterCache_Admit:
+      break;
+  }
+
+  q->inFilterCacheFill = true;
+  QueryIterator *it = n->type == QN_TAG ? Query_EvalTagNode(q, n) : Query_EvalNode_Rs(q, n, evalConfig);
+  q->inFilterCacheFill = false;
+  if (!it) {
+    FilterCache_Put(fc, key, fs->index, NULL, 0, maxMemory);
+    return NewEmptyIterator();
+  }
+
+  // Read all the documents of the filter. Give up once they could not fit in
+  // the cache even at a byte each, or if the query times out meanwhile
+  size_t cap = 64;
+  ids = rm_malloc(cap * sizeof(*ids));
+  IteratorStatus rc;
+  while ((rc = it->Read(it)) == ITERATOR_OK && len < maxMemory) {
+    if (len == cap) {
+      cap *= 2;
+      ids = rm_realloc(ids, cap * sizeof(*ids));
+    }
+    ids[len++] = it->lastDocId;
+  }
+  if (rc != ITERATOR_EOF) {
+    rm_free(ids);
+    sdsfree(key);
+    it->Rewind(it);
+    return it;
+  }
+  it->Free(it);
+
+  FilterCache_Put(fc, key, fs->index, ids, len, maxMemory);
+  if (!len) {
+    rm_free(ids);
+    return NewEmptyIterator();
+  }
+  return NewSortedIdListIterator(ids, len, n->opts.weight);
+}
+
+sds QAST_CacheKey(sds s, const QueryAST *q) {
+  RS_ASSERT(q && q->root);
+  s = KEY_APPEND(s, q->config);
+  s = keyAppendStr(s, q->udata, q->udata ? q->udatalen : 0);
+  return QueryNode_CacheKey(s, q->root);
+}
+#undef KEY_APPEND
+
 int QueryNode_ForEach(QueryNode *q, QueryNode_ForEachCallback callback, void *ctx, int reverse) {
 #define INITIAL_ARRAY_NODE_SIZE 5
   QueryNode **nodes = array_new(QueryNode *, INITIAL_ARRAY_NODE_SIZE);
@@ -78,6 +78,14 @@ typedef struct EvalConfig EvalConfig;
 
 QueryIterator *Query_EvalNode(QueryEvalCtx *q, QueryNode *n, const EvalConfig *evalConfig);
 
+/**
+ * Evaluate a tag, numeric or geo filter node from the filter cache of the index.
+ * A filter seen often enough is evaluated once more, and its documents cached.
+ * Returns NULL when the cache does not apply to the node, e.g. when its results
+ * may be scored, for the caller to evaluate it as usual.
+ */
+QueryIterator *Query_EvalCachedFilter(QueryEvalCtx *q, QueryNode *n, const EvalConfig *evalConfig);
+
 /**
  * Global filter options impact *all* query nodes. This structure can be used
  * to set global properties for the entire query
@@ -135,6 +143,15 @@ char *QAST_DumpExplain(const QueryAST *q, const IndexSpec *spec);
 /** Print a representation of the query to standard output */
 void QAST_Print(const QueryAST *ast, const IndexSpec *spec);
 
+/**
+ * Append to `s` a binary form of the parsed query that tells apart any two
+ * queries which may match differently: node types and options, terms, filter
+ * values, and the iterator configuration. Field names are resolved to their
+ * schema indices, so the key is only meaningful for a given schema.
+ * Returns the (possibly reallocated) `s`.
+ */
+sds QAST_CacheKey(sds s, const QueryAST *q);
+
 /* Cleanup a query AST */
 void QAST_Destroy(QueryAST *q);
 
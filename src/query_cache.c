@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "query_cache.h"
+
+#include <pthread.h>
+
+#include "rmalloc.h"
+#include "fnv_ffi.h"
+#include "util/khash.h"
+#include "util/dllist.h"
+
+typedef struct {
+  DLLIST_node llnode;  // position in the LRU list, most recently used first
+  uint64_t hash;
+  sds key;
+  uint64_t epoch;      // index write epoch at which the query started
+  ReplyRecording *reply;
+  size_t memory;
+} QueryCacheEntry;
+
+KHASH_MAP_INIT_INT64(queryCache, QueryCacheEntry *);
+
+struct QueryCache {
+  pthread_mutex_t lock;
+  khash_t(queryCache) *entries;
+  DLLIST lru;
+  size_t memory;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+  size_t invalidations;
+};
+
+static inline uint64_t keyHash(const sds key) {
+  return fnv_64a_buf(key, sdslen(key), 0);
+}
+
+static void entryFree(QueryCacheEntry *e) {
+  sdsfree(e->key);
+  ReplyRecording_Free(e->reply);
+  rm_free(e);
+}
+
+// Unlink the entry at `it` and free it. Called with the lock held
+static void removeEntry(QueryCache *qc, khiter_t it) {
+  QueryCacheEntry *e = kh_val(qc->entries, it);
+  kh_del(queryCache, qc->entries, it);
+  dllist_delete(&e->llnode);
+  qc->memory -= e->memory;
+  entryFree(e);
+}
+
+QueryCache *QueryCache_New(void) {
+  QueryCache *qc = rm_calloc(1, sizeof(*qc));
+  pthread_mutex_init(&qc->lock, NULL);
+  qc->entries = kh_init(queryCache);
+  dllist_init(&qc->lru);
+  return qc;
+}
+
+void QueryCache_Clear(QueryCache *qc) {
+  pthread_mutex_lock(&qc->lock);
+  QueryCacheEntry *e;
+  kh_foreach_value(qc->entries, e, entryFree(e));
+  kh_clear(queryCache, qc->entries);
+  dllist_init(&qc->lru);
+  qc->memory = 0;
+  pthread_mutex_unlock(&qc->lock);
+}
+
+void QueryCache_Free(QueryCache *qc) {
+  QueryCache_Clear(qc);
+  kh_destroy(queryCache, qc->entries);
+  pthread_mutex_destroy(&qc->lock);
+  rm_free(qc);
+}
+
+bool QueryCache_Reply(QueryCache *qc, const sds key, uint64_t epoch, RedisModule_Reply *reply) {
+  const uint64_t hash = keyHash(key);
+  bool hit = false;
+
+  pthread_mutex_lock(&qc->lock);
+  khiter_t it = kh_get(queryCache, qc->entries, hash);
+  if (it != kh_end(qc->entries)) {
+    QueryCacheEntry *e = kh_val(qc->entries, it);
+    if (e->epoch != epoch) {
+      // The index was written to since the entry was filled
+      removeEntry(qc, it);
+      qc->invalidations++;
+    } else if (sdslen(e->key) == sdslen(key) && !memcmp(e->key, key, sdslen(key))) {
+      dllist_delete(&e->llnode);
+      dllist_prepend(&qc->lru, &e->llnode);
+      // Replay under the lock, so that the entry cannot be evicted meanwhile
+      RedisModule_Reply_Replay(reply, e->reply);
+      hit = true;
+    }
+  }
+  if (hit) {
+    qc->hits++;
+  } else {
+    qc->misses++;
+  }
+  pthread_mutex_unlock(&qc->lock);
+  return hit;
+}
+
+void QueryCache_Put(QueryCache *qc, sds key, uint64_t epoch, ReplyRecording *rec, size_t maxMemory) {
+  QueryCacheEntry *e = rm_malloc(sizeof(*e));
+  e->hash = keyHash(key);
+  e->key = key;
+  e->epoch = epoch;
+  e->reply = rec;
+  e->memory = sizeof(*e) + sdsAllocSize(key) + ReplyRecording_MemUsage(rec);
+
+  if (e->memory > maxMemory) {
+    entryFree(e);
+    return;
+  }
+
+  pthread_mutex_lock(&qc->lock);
+  khiter_t it = kh_get(queryCache, qc->entries, e->hash);
+  if (it != kh_end(qc->entries)) {
+    if (kh_val(qc->entries, it)->epoch > epoch) {
+      // Already filled by a query that started after a later write
+      pthread_mutex_unlock(&qc->lock);
+      entryFree(e);
+      return;
+    }
+    removeEntry(qc, it);
+  }
+
+  while (qc->memory + e->memory > maxMemory) {
+    QueryCacheEntry *lru = DLLIST_ITEM(qc->lru.prev, QueryCacheEntry, llnode);
+    removeEntry(qc, kh_get(queryCache, qc->entries, lru->hash));
+    qc->evictions++;
+  }
+
+  int absent;
+  it = kh_put(queryCache, qc->entries, e->hash, &absent);
+  kh_val(qc->entries, it) = e;
+  dllist_prepend(&qc->lru, &e->llnode);
+  qc->memory += e->memory;
+  pthread_mutex_unlock(&qc->lock);
+}
+
+QueryCacheStats QueryCache_GetStats(QueryCache *qc) {
+  pthread_mutex_lock(&qc->lock);
+  QueryCacheStats stats = {
+    .hits = qc->hits,
+    .misses = qc->misses,
+    .evictions = qc->evictions,
+    .invalidations = qc->invalidations,
+    .entries = kh_size(qc->entries),
+    .memory = qc->memory,
+  };
+  pthread_mutex_unlock(&qc->lock);
+  return stats;
+}
+
+void QueryCache_RenderStats(QueryCache *qc, RedisModule_Reply *reply) {
+  QueryCacheStats stats = {0};
+  if (qc) {
+    stats = QueryCache_GetStats(qc);
+  }
+
+  RedisModule_ReplyKV_Map(reply, "query_cache_stats");
+
+    RedisModule_ReplyKV_LongLong(reply, "hits", stats.hits);
+    RedisModule_ReplyKV_LongLong(reply, "misses", stats.misses);
+    RedisModule_ReplyKV_LongLong(reply, "evictions", stats.evictions);
+    RedisModule_ReplyKV_LongLong(reply, "invalidations", stats.invalidations);
+    RedisModule_ReplyKV_LongLong(reply, "entries", stats.entries);
+    RedisModule_ReplyKV_LongLong(reply, "memory", stats.memory);
+
+  RedisModule_Reply_MapEnd(reply);
+}
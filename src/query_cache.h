@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "reply.h"
+#include "hiredis/sds.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Per-index cache of query replies.
+ *
+ * Entries are keyed by a canonical form of the parsed query and of the
+ * arguments shaping its reply, and are tagged with the index write epoch at
+ * which the query started. An entry is only served while the index epoch is
+ * unchanged, so any write to the index invalidates every entry filled before it.
+ * The least recently used entries are evicted to keep the cache under its
+ * memory cap. Safe to use from any thread.
+ */
+typedef struct QueryCache QueryCache;
+
+typedef struct {
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+  size_t invalidations;
+  size_t entries;
+  size_t memory;
+} QueryCacheStats;
+
+QueryCache *QueryCache_New(void);
+void QueryCache_Free(QueryCache *qc);
+
+/**
+ * Replay the reply cached for `key` into `reply`, if there is one filled at
+ * `epoch`. Counts a hit or a miss. An entry filled at another epoch is dropped.
+ */
+bool QueryCache_Reply(QueryCache *qc, const sds key, uint64_t epoch, RedisModule_Reply *reply);
+
+/**
+ * Cache the reply recorded for `key` at `epoch`, evicting the least recently
+ * used entries until the cache holds at most `maxMemory` bytes.
+ * Takes ownership of `key` and `rec`.
+ */
+void QueryCache_Put(QueryCache *qc, sds key, uint64_t epoch, ReplyRecording *rec, size_t maxMemory);
+
+/** Drop all the entries */
+void QueryCache_Clear(QueryCache *qc);
+
+QueryCacheStats QueryCache_GetStats(QueryCache *qc);
+
+/** Reply with the cache statistics, as the `query_cache_stats` map of FT.INFO. `qc` may be NULL */
+void QueryCache_RenderStats(QueryCache *qc, RedisModule_Reply *reply);
+
+#ifdef __cplusplus
+}
+#endif
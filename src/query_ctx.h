@@ -35,4 +35,11 @@ typedef struct QueryEvalCtx {
   // C API, tests, or any request whose `skipTimeoutChecks` is false).
   // Set via `AREQ_TimeoutAreqOrNull` in `QAST_Iterate`.
   struct AREQ *bcTimeoutAreq;
+  // Score a document has to beat to make it into the request's top results,
+  // raised by the sorter as results are drawn. Non-NULL only when iterators may
+  // skip documents that cannot reach it; see `QOptimizer_ScoreThreshold`.
+  const double *scoreThreshold;
+  // True while a filter node is evaluated to fill the filter cache, so that its
+  // evaluation does not consult the cache again.
+  bool inFilterCacheFill;
 } QueryEvalCtx;
@@ -324,6 +324,25 @@ void QOptimizer_UpdateTotalResults(AREQ *req) {
     }
 }
 
+const double *QOptimizer_ScoreThreshold(AREQ *req) {
+  QOptimizer *opt = req->optimizer;
+  if (!opt || !IsSearch(req) || !IsOptimized(req)) {
+    return NULL;
+  }
+  // The sorter only tracks the lowest score in its heap when it ranks by score.
+  PLN_ArrangeStep *arng = AGPLN_GetArrangeStep(AREQ_AGGPlan(req));
+  if (opt->field || opt->scorerType != SCORER_TYPE_TERM || (arng && array_len(arng->sortKeys))) {
+    return NULL;
+  }
+  // Score bounds assume document scores of at most 1, which a score field does
+  // not guarantee, and are only tracked by in-memory inverted indexes.
+  const IndexSpec *spec = AREQ_SearchCtx(req)->spec;
+  if (spec->diskSpec || (spec->rule && spec->rule->score_field)) {
+    return NULL;
+  }
+  return &AREQ_QueryProcessingCtx(req)->minScore;
+}
+
 const char *QOptimizer_PrintType(QOptimizer *opt) {
   switch (opt->type) {
     case Q_OPT_NONE:
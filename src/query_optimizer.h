@@ -113,6 +113,11 @@ void QOptimizer_UpdateTotalResults(AREQ *req);
 /* print type of optimizer */
 const char *QOptimizer_PrintType(QOptimizer *opt);
 
+/* return the score threshold of the request's top-k sorter, or NULL when
+ * documents scoring below it may not be dropped: only an optimized FT.SEARCH
+ * ranking by score reports totals loosely enough to skip them. */
+const double *QOptimizer_ScoreThreshold(AREQ *req);
+
 #ifdef __cplusplus
 }
 #endif
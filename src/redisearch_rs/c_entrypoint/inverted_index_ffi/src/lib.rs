@@ -28,6 +28,7 @@ use inverted_index::{
     AddRecordOutcome, EntriesTrackingIndex, FieldMaskTrackingIndex, FilterGeoReader,
     FilterMaskReader, FilterNumericReader, GcApplyInfo, GcScanDelta, IndexBlock, IndexReader as _,
     NumericFilter, ReadFilter,
+    bitmap_doc_ids_only::BitmapDocIdsOnly,
     debug::{BlockSummary, Summary},
     doc_ids_only::DocIdsOnly,
     fields_offsets::{FieldsOffsets, FieldsOffsetsWide},
@@ -39,6 +40,7 @@ use inverted_index::{
     ii_dispatch,
     numeric::{Numeric, NumericFloatCompression},
     offsets_only::OffsetsOnly,
+    packed_doc_ids_only::PackedDocIdsOnly,
     raw_doc_ids_only::RawDocIdsOnly,
 };
 use serde::{Deserialize, Serialize};
@@ -81,8 +83,12 @@ const NUMERIC_MASK: IndexFlags = IndexFlags_Index_StoreNumeric;
 
 /// Create a new inverted index instance based on the provided flags and options. `raw_doc_encoding`
 /// controls whether document IDs only encoding should use raw encoding (true) or varint encoding
-/// (false). `compress_floats` controls whether numeric encoding should have its floating point
-/// numbers compressed (true) or not (false). Compressing floating point numbers saves memory
+/// (false). `packed_doc_id_encoding` makes document IDs only encoding bit-pack the deltas in groups
+/// of 128 entries instead, and takes precedence over `raw_doc_id_encoding`.
+/// `bitmap_doc_id_encoding` makes document IDs only encoding store dense blocks as bitmaps or runs
+/// of consecutive IDs, and takes precedence over both. `compress_floats` controls whether numeric
+/// encoding should have its floating point numbers compressed (true) or not (false). Compressing
+/// floating point numbers saves memory
 /// but lowers precision.
 ///
 /// The output parameter `mem_size` will be set to the memory usage of the created index. The
@@ -105,6 +111,8 @@ const NUMERIC_MASK: IndexFlags = IndexFlags_Index_StoreNumeric;
 pub extern "C" fn NewInvertedIndex_Ex(
     flags: IndexFlags,
     raw_doc_id_encoding: bool,
+    packed_doc_id_encoding: bool,
+    bitmap_doc_id_encoding: bool,
     compress_floats: bool,
     mem_size: &mut usize,
 ) -> *mut InvertedIndex {
@@ -144,6 +152,12 @@ pub extern "C" fn NewInvertedIndex_Ex(
         (FREQS_OFFSETS_MASK, _, _) => {
             InvertedIndex::FreqsOffsets(inverted_index::InvertedIndex::<FreqsOffsets>::new(flags))
         }
+        (DOC_IDS_ONLY_MASK, _, _) if bitmap_doc_id_encoding => InvertedIndex::BitmapDocIdsOnly(
+            inverted_index::InvertedIndex::<BitmapDocIdsOnly>::new(flags),
+        ),
+        (DOC_IDS_ONLY_MASK, _, _) if packed_doc_id_encoding => InvertedIndex::PackedDocIdsOnly(
+            inverted_index::InvertedIndex::<PackedDocIdsOnly>::new(flags),
+        ),
         (DOC_IDS_ONLY_MASK, false, _) => {
             InvertedIndex::DocIdsOnly(inverted_index::InvertedIndex::<DocIdsOnly>::new(flags))
         }
@@ -241,6 +255,31 @@ pub unsafe extern "C" fn InvertedIndex_WriteEntryGeneric(
     ii_dispatch!(ii, add_record, record).unwrap()
 }
 
+/// Write a new term entry to the inverted index, like [`InvertedIndex_WriteEntryGeneric`],
+/// also recording the length of the document it belongs to. The block's score bounds use it
+/// to let top-k queries skip blocks which cannot reach their threshold.
+///
+/// # Safety
+/// - `ii` must be a valid pointer to an `InvertedIndex` instance and cannot be NULL.
+/// - `record` must be a valid pointer to an `RSIndexResult` instance and cannot be NULL.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn InvertedIndex_WriteScoredEntry(
+    ii: *mut InvertedIndex,
+    record: *const RSIndexResult,
+    doc_len: u32,
+) -> AddRecordOutcome {
+    debug_assert!(!ii.is_null(), "ii must not be null");
+    debug_assert!(!record.is_null(), "record must not be null");
+
+    // SAFETY: The caller must ensure that `ii` is a valid pointer to an `InvertedIndex`
+    let ii = unsafe { &mut *ii };
+
+    // SAFETY: The caller must ensure that `record` is a valid pointer to an `RSIndexResult`
+    let record = unsafe { &*record };
+
+    ii_dispatch!(ii, add_record_with_doc_len, record, doc_len).unwrap()
+}
+
 /// Return the number of blocks in the inverted index.
 ///
 /// # Safety
@@ -373,6 +412,8 @@ pub unsafe extern "C" fn InvertedIndex_FieldMask(ii: *const InvertedIndex) -> Fi
         | InvertedIndex::FreqsOffsets(_)
         | InvertedIndex::DocIdsOnly(_)
         | InvertedIndex::RawDocIdsOnly(_)
+        | InvertedIndex::PackedDocIdsOnly(_)
+        | InvertedIndex::BitmapDocIdsOnly(_)
         | InvertedIndex::Numeric(_)
         | InvertedIndex::NumericFloatCompression(_) => 0,
     }
@@ -406,7 +447,9 @@ pub unsafe extern "C" fn InvertedIndex_NumEntries(ii: *const InvertedIndex) -> u
         | InvertedIndex::OffsetsOnly(_)
         | InvertedIndex::FreqsOffsets(_)
         | InvertedIndex::DocIdsOnly(_)
-        | InvertedIndex::RawDocIdsOnly(_) => 0,
+        | InvertedIndex::RawDocIdsOnly(_)
+        | InvertedIndex::PackedDocIdsOnly(_)
+        | InvertedIndex::BitmapDocIdsOnly(_) => 0,
     }
 }
 
@@ -712,6 +755,8 @@ pub enum IndexReader<'index> {
     FreqsOffsets(inverted_index::IndexReaderCore<'index, FreqsOffsets>),
     DocIdsOnly(inverted_index::IndexReaderCore<'index, DocIdsOnly>),
     RawDocIdsOnly(inverted_index::IndexReaderCore<'index, RawDocIdsOnly>),
+    PackedDocIdsOnly(inverted_index::IndexReaderCore<'index, PackedDocIdsOnly>),
+    BitmapDocIdsOnly(inverted_index::IndexReaderCore<'index, BitmapDocIdsOnly>),
     Numeric(inverted_index::IndexReaderCore<'index, Numeric>),
     NumericFiltered(FilterNumericReader<inverted_index::IndexReaderCore<'index, Numeric>>),
     NumericGeoFiltered(FilterGeoReader<inverted_index::IndexReaderCore<'index, Numeric>>),
@@ -741,6 +786,8 @@ macro_rules! ir_dispatch {
             IndexReader::FreqsOffsets(ii) => ii.$method($($args),*),
             IndexReader::DocIdsOnly(ii) => ii.$method($($args),*),
             IndexReader::RawDocIdsOnly(ii) => ii.$method($($args),*),
+            IndexReader::PackedDocIdsOnly(ii) => ii.$method($($args),*),
+            IndexReader::BitmapDocIdsOnly(ii) => ii.$method($($args),*),
             IndexReader::Numeric(ii) => ii.$method($($args),*),
             IndexReader::NumericFiltered(ii) => ii.$method($($args),*),
             IndexReader::NumericGeoFiltered(ii) => ii.$method($($args),*),
@@ -803,6 +850,14 @@ impl<'index> IndexReader<'index> {
                 let mut ii = ii;
                 ir.swap_index(&mut ii)
             }
+            (IndexReader::PackedDocIdsOnly(ir), InvertedIndex::PackedDocIdsOnly(ii)) => {
+                let mut ii = ii;
+                ir.swap_index(&mut ii)
+            }
+            (IndexReader::BitmapDocIdsOnly(ir), InvertedIndex::BitmapDocIdsOnly(ii)) => {
+                let mut ii = ii;
+                ir.swap_index(&mut ii)
+            }
             (IndexReader::Numeric(ir), InvertedIndex::Numeric(ii)) => {
                 ir.swap_index(&mut ii.inner())
             }
@@ -879,6 +934,8 @@ pub unsafe extern "C" fn NewIndexReader(
         (InvertedIndex::FreqsOffsets(ii), _) => IndexReader::FreqsOffsets(ii.reader()),
         (InvertedIndex::DocIdsOnly(ii), _) => IndexReader::DocIdsOnly(ii.reader()),
         (InvertedIndex::RawDocIdsOnly(ii), _) => IndexReader::RawDocIdsOnly(ii.reader()),
+        (InvertedIndex::PackedDocIdsOnly(ii), _) => IndexReader::PackedDocIdsOnly(ii.reader()),
+        (InvertedIndex::BitmapDocIdsOnly(ii), _) => IndexReader::BitmapDocIdsOnly(ii.reader()),
         (InvertedIndex::Numeric(ii), ReadFilter::None) => IndexReader::Numeric(ii.reader()),
         (InvertedIndex::Numeric(ii), ReadFilter::Numeric(filter)) if filter.is_numeric_filter() => {
             IndexReader::NumericFiltered(FilterNumericReader::new(*filter, ii.reader()))
@@ -1007,6 +1064,12 @@ pub unsafe extern "C" fn IndexReader_IsIndex(
         (IndexReader::FreqsOffsets(ir), InvertedIndex::FreqsOffsets(ii)) => ir.points_to_ii(ii),
         (IndexReader::DocIdsOnly(ir), InvertedIndex::DocIdsOnly(ii)) => ir.points_to_ii(ii),
         (IndexReader::RawDocIdsOnly(ir), InvertedIndex::RawDocIdsOnly(ii)) => ir.points_to_ii(ii),
+        (IndexReader::PackedDocIdsOnly(ir), InvertedIndex::PackedDocIdsOnly(ii)) => {
+            ir.points_to_ii(ii)
+        }
+        (IndexReader::BitmapDocIdsOnly(ir), InvertedIndex::BitmapDocIdsOnly(ii)) => {
+            ir.points_to_ii(ii)
+        }
         (IndexReader::Numeric(ir), InvertedIndex::Numeric(ii)) => ir.points_to_ii(ii.inner()),
         (IndexReader::NumericFiltered(ir), InvertedIndex::Numeric(ii)) => ir.is_index(ii.inner()),
         (IndexReader::NumericGeoFiltered(ir), InvertedIndex::Numeric(ii)) => {
@@ -1165,7 +1228,9 @@ pub unsafe extern "C" fn IndexReader_NumericFilter(ir: *const IndexReader) -> *c
         | IndexReader::OffsetsOnly(_)
         | IndexReader::FreqsOffsets(_)
         | IndexReader::DocIdsOnly(_)
-        | IndexReader::RawDocIdsOnly(_) => std::ptr::null(),
+        | IndexReader::RawDocIdsOnly(_)
+        | IndexReader::PackedDocIdsOnly(_)
+        | IndexReader::BitmapDocIdsOnly(_) => std::ptr::null(),
     }
 }
 
@@ -16,7 +16,8 @@ use rqe_iterators::{interop::RQEIteratorWrapper, inverted_index::new_missing_ite
 ///
 /// # Parameters
 ///
-/// * `idx` - Pointer to the missing-field inverted index (DocIdsOnly or RawDocIdsOnly encoded).
+/// * `idx` - Pointer to the missing-field inverted index (DocIdsOnly, RawDocIdsOnly,
+///   PackedDocIdsOnly or BitmapDocIdsOnly encoded).
 /// * `sctx` - Pointer to the Redis search context.
 /// * `field_index` - The index of the field in `spec.fields` whose missing documents are tracked.
 ///
@@ -12,7 +12,8 @@ use std::{fmt::Debug, ptr::NonNull};
 use field::{FieldExpirationPredicate, FieldFilterContext, FieldMaskOrIndex};
 use index_result::{RSIndexResult, RSQueryTerm};
 use inverted_index::{
-    IndexReader, doc_ids_only::DocIdsOnly, opaque::OpaqueEncoding, raw_doc_ids_only::RawDocIdsOnly,
+    IndexReader, bitmap_doc_ids_only::BitmapDocIdsOnly, doc_ids_only::DocIdsOnly,
+    opaque::OpaqueEncoding, packed_doc_ids_only::PackedDocIdsOnly, raw_doc_ids_only::RawDocIdsOnly,
 };
 use rqe_core::DocId;
 use rqe_iterators::{
@@ -25,11 +26,15 @@ use rqe_iterators::{
 /// Wrapper around different tag iterator encoding types to avoid generics in FFI code.
 ///
 /// Tag inverted indices are always created with `DocIdsOnly` flags, so only
-/// the standard variable-length encoding ([`DocIdsOnly`]) and the fixed 4-byte
-/// raw encoding ([`RawDocIdsOnly`]) are supported.
+/// the standard variable-length encoding ([`DocIdsOnly`]), the fixed 4-byte
+/// raw encoding ([`RawDocIdsOnly`]), the bit-packed encoding
+/// ([`PackedDocIdsOnly`]) and the bitmap encoding ([`BitmapDocIdsOnly`]) are
+/// supported.
 pub(super) enum TagIterator<'index> {
     Encoded(Tag<'index, DocIdsOnly, CTagIndexLookup, FieldExpirationChecker>),
     Raw(Tag<'index, RawDocIdsOnly, CTagIndexLookup, FieldExpirationChecker>),
+    Packed(Tag<'index, PackedDocIdsOnly, CTagIndexLookup, FieldExpirationChecker>),
+    Bitmap(Tag<'index, BitmapDocIdsOnly, CTagIndexLookup, FieldExpirationChecker>),
 }
 
 impl Debug for TagIterator<'_> {
@@ -37,6 +42,8 @@ impl Debug for TagIterator<'_> {
         let variant = match self {
             TagIterator::Encoded(_) => "Encoded",
             TagIterator::Raw(_) => "Raw",
+            TagIterator::Packed(_) => "Packed",
+            TagIterator::Bitmap(_) => "Bitmap",
         };
         write!(f, "TagIterator({variant})")
     }
@@ -48,6 +55,8 @@ macro_rules! tag_it_dispatch {
         match $self {
             TagIterator::Encoded(t) => t.$method($($arg),*),
             TagIterator::Raw(t) => t.$method($($arg),*),
+            TagIterator::Packed(t) => t.$method($($arg),*),
+            TagIterator::Bitmap(t) => t.$method($($arg),*),
         }
     };
 }
@@ -110,6 +119,30 @@ impl<'index> rqe_iterators::RQEIterator<'index> for TagIterator<'index> {
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    fn has_doc_ids_blocks(&self) -> bool {
+        true
+    }
+
+    fn doc_ids_block(
+        &self,
+        doc_id: DocId,
+        out: &mut Vec<DocId>,
+    ) -> Result<bool, rqe_iterators::RQEIteratorError> {
+        tag_it_dispatch!(self, doc_ids_block, doc_id, out)
+    }
+
+    fn has_doc_ids_words(&self) -> bool {
+        tag_it_dispatch!(self, has_doc_ids_words)
+    }
+
+    fn doc_ids_words(
+        &self,
+        base: DocId,
+        words: &mut [u64],
+    ) -> Result<(), rqe_iterators::RQEIteratorError> {
+        tag_it_dispatch!(self, doc_ids_words, base, words)
+    }
 }
 
 /// [`TagLookup`] over the C TagIndex's opaque `TrieMap` (`tag_index.values`).
@@ -159,7 +192,8 @@ where
 ///
 /// # Parameters
 ///
-/// * `idx` - Pointer to the tag's inverted index ([`DocIdsOnly`] or [`RawDocIdsOnly`] encoded).
+/// * `idx` - Pointer to the tag's inverted index ([`DocIdsOnly`], [`RawDocIdsOnly`],
+///   [`PackedDocIdsOnly`] or [`BitmapDocIdsOnly`] encoded).
 /// * `tag_idx` - Pointer to the [`TagIndex`](ffi::TagIndex) containing the `TrieMap` of tag values.
 /// * `sctx` - Pointer to the Redis search context.
 /// * `field_mask_or_index` - Field mask or field index to filter on.
@@ -177,8 +211,9 @@ where
 ///
 /// The following invariants must be upheld when calling this function:
 ///
-/// 1. `idx` must be a valid pointer to a [`DocIdsOnly`] or [`RawDocIdsOnly`]
-///    [`InvertedIndex`](ffi::InvertedIndex) and cannot be NULL.
+/// 1. `idx` must be a valid pointer to a [`DocIdsOnly`], [`RawDocIdsOnly`],
+///    [`PackedDocIdsOnly`] or [`BitmapDocIdsOnly`] [`InvertedIndex`](ffi::InvertedIndex)
+///    and cannot be NULL.
 /// 2. `idx` must remain valid between [`revalidate()`](rqe_iterators::RQEIterator::revalidate) calls, since the revalidation
 ///    mechanism detects when the index has been replaced via [`TagIndex`](ffi::TagIndex) `TrieMap` lookup.
 /// 3. `tag_idx` must be a valid pointer to a [`TagIndex`](ffi::TagIndex) and cannot be NULL.
@@ -211,7 +246,7 @@ pub unsafe extern "C" fn NewInvIndIterator_TagQuery(
     let tag_idx_nn = unsafe { NonNull::new_unchecked(tag_idx as *mut _) };
     // SAFETY: 3., 4. guarantee tag_idx and its TrieMap stay valid for the
     // lifetime of the iterator; the encoding match is enforced by the
-    // DocIdsOnly/RawDocIdsOnly dispatch below.
+    // DocIdsOnly/RawDocIdsOnly/PackedDocIdsOnly/BitmapDocIdsOnly dispatch below.
     let lookup = unsafe { CTagIndexLookup::new(tag_idx_nn) };
 
     // SAFETY: 5. guarantees sctx is valid and non-null
@@ -254,8 +289,32 @@ pub unsafe extern "C" fn NewInvIndIterator_TagQuery(
             // The RawDocIdsOnly match arm ensures the encoding variant matches.
             TagIterator::Raw(unsafe { Tag::new(reader, sctx_nn, lookup, term, weight, checker) })
         }
+        inverted_index_ffi::InvertedIndex::PackedDocIdsOnly(ii) => {
+            let reader = ii.reader();
+            // SAFETY: 5., 6. guarantee context/spec validity for the lifetime of the checker.
+            let checker =
+                unsafe { FieldExpirationChecker::new(sctx_nn, filter_ctx, reader.flags()) };
+            // SAFETY: 1., 2. guarantee idx validity and revalidation semantics.
+            // 3., 4. guarantee tag_index and TrieMap validity.
+            // 5., 6. guarantee context/spec validity.
+            // 7. guarantees term ownership transfer.
+            // The PackedDocIdsOnly match arm ensures the encoding variant matches.
+            TagIterator::Packed(unsafe { Tag::new(reader, sctx_nn, lookup, term, weight, checker) })
+        }
+        inverted_index_ffi::InvertedIndex::BitmapDocIdsOnly(ii) => {
+            let reader = ii.reader();
+            // SAFETY: 5., 6. guarantee context/spec validity for the lifetime of the checker.
+            let checker =
+                unsafe { FieldExpirationChecker::new(sctx_nn, filter_ctx, reader.flags()) };
+            // SAFETY: 1., 2. guarantee idx validity and revalidation semantics.
+            // 3., 4. guarantee tag_index and TrieMap validity.
+            // 5., 6. guarantee context/spec validity.
+            // 7. guarantees term ownership transfer.
+            // The BitmapDocIdsOnly match arm ensures the encoding variant matches.
+            TagIterator::Bitmap(unsafe { Tag::new(reader, sctx_nn, lookup, term, weight, checker) })
+        }
         _ => panic!(
-            "Tag iterator requires a DocIdsOnly or RawDocIdsOnly inverted index, got: {:?}",
+            "Tag iterator requires a DocIdsOnly, RawDocIdsOnly, PackedDocIdsOnly or BitmapDocIdsOnly inverted index, got: {:?}",
             std::mem::discriminant(ii_ref)
         ),
     };
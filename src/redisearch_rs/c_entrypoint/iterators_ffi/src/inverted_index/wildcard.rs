@@ -10,18 +10,24 @@
 use std::fmt::Debug;
 
 use index_result::RSIndexResult;
-use inverted_index::{DocId, doc_ids_only::DocIdsOnly, raw_doc_ids_only::RawDocIdsOnly};
+use inverted_index::{
+    DocId, bitmap_doc_ids_only::BitmapDocIdsOnly, doc_ids_only::DocIdsOnly,
+    packed_doc_ids_only::PackedDocIdsOnly, raw_doc_ids_only::RawDocIdsOnly,
+};
 use rqe_iterators::{
     IteratorType, interop::RQEIteratorWrapper, inverted_index::Wildcard, profile_print,
 };
 
 /// Wrapper around different II wildcard iterator encoding types to avoid generics in FFI code.
 ///
-/// Handles both the standard variable-length encoding ([`DocIdsOnly`]) and the
-/// fixed 4-byte raw encoding ([`RawDocIdsOnly`]).
+/// Handles the standard variable-length encoding ([`DocIdsOnly`]), the fixed
+/// 4-byte raw encoding ([`RawDocIdsOnly`]), the bit-packed encoding
+/// ([`PackedDocIdsOnly`]) and the bitmap encoding ([`BitmapDocIdsOnly`]).
 pub(super) enum WildcardIterator<'index> {
     Encoded(Wildcard<'index, DocIdsOnly>),
     Raw(Wildcard<'index, RawDocIdsOnly>),
+    Packed(Wildcard<'index, PackedDocIdsOnly>),
+    Bitmap(Wildcard<'index, BitmapDocIdsOnly>),
 }
 
 impl Debug for WildcardIterator<'_> {
@@ -29,6 +35,8 @@ impl Debug for WildcardIterator<'_> {
         let variant = match self {
             WildcardIterator::Encoded(_) => "Encoded",
             WildcardIterator::Raw(_) => "Raw",
+            WildcardIterator::Packed(_) => "Packed",
+            WildcardIterator::Bitmap(_) => "Bitmap",
         };
         write!(f, "WildcardIterator({variant})")
     }
@@ -40,6 +48,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.current(),
             WildcardIterator::Raw(w) => w.current(),
+            WildcardIterator::Packed(w) => w.current(),
+            WildcardIterator::Bitmap(w) => w.current(),
         }
     }
 
@@ -50,6 +60,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.read(),
             WildcardIterator::Raw(w) => w.read(),
+            WildcardIterator::Packed(w) => w.read(),
+            WildcardIterator::Bitmap(w) => w.read(),
         }
     }
 
@@ -62,6 +74,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.skip_to(doc_id),
             WildcardIterator::Raw(w) => w.skip_to(doc_id),
+            WildcardIterator::Packed(w) => w.skip_to(doc_id),
+            WildcardIterator::Bitmap(w) => w.skip_to(doc_id),
         }
     }
 
@@ -70,6 +84,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.rewind(),
             WildcardIterator::Raw(w) => w.rewind(),
+            WildcardIterator::Packed(w) => w.rewind(),
+            WildcardIterator::Bitmap(w) => w.rewind(),
         }
     }
 
@@ -78,6 +94,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.num_estimated(),
             WildcardIterator::Raw(w) => w.num_estimated(),
+            WildcardIterator::Packed(w) => w.num_estimated(),
+            WildcardIterator::Bitmap(w) => w.num_estimated(),
         }
     }
 
@@ -86,6 +104,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.last_doc_id(),
             WildcardIterator::Raw(w) => w.last_doc_id(),
+            WildcardIterator::Packed(w) => w.last_doc_id(),
+            WildcardIterator::Bitmap(w) => w.last_doc_id(),
         }
     }
 
@@ -94,6 +114,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.at_eof(),
             WildcardIterator::Raw(w) => w.at_eof(),
+            WildcardIterator::Packed(w) => w.at_eof(),
+            WildcardIterator::Bitmap(w) => w.at_eof(),
         }
     }
 
@@ -105,6 +127,8 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
         match self {
             WildcardIterator::Encoded(w) => w.revalidate(spec),
             WildcardIterator::Raw(w) => w.revalidate(spec),
+            WildcardIterator::Packed(w) => w.revalidate(spec),
+            WildcardIterator::Bitmap(w) => w.revalidate(spec),
         }
     }
 
@@ -116,6 +140,25 @@ impl<'index> rqe_iterators::RQEIterator<'index> for WildcardIterator<'index> {
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    #[inline(always)]
+    fn has_doc_ids_words(&self) -> bool {
+        true
+    }
+
+    #[inline(always)]
+    fn doc_ids_words(
+        &self,
+        base: DocId,
+        words: &mut [u64],
+    ) -> Result<(), rqe_iterators::RQEIteratorError> {
+        match self {
+            WildcardIterator::Encoded(w) => w.doc_ids_words(base, words),
+            WildcardIterator::Raw(w) => w.doc_ids_words(base, words),
+            WildcardIterator::Packed(w) => w.doc_ids_words(base, words),
+            WildcardIterator::Bitmap(w) => w.doc_ids_words(base, words),
+        }
+    }
 }
 
 impl profile_print::ProfilePrint for WildcardIterator<'_> {
@@ -127,6 +170,8 @@ impl profile_print::ProfilePrint for WildcardIterator<'_> {
         match self {
             WildcardIterator::Encoded(w) => w.print_profile(map, ctx),
             WildcardIterator::Raw(w) => w.print_profile(map, ctx),
+            WildcardIterator::Packed(w) => w.print_profile(map, ctx),
+            WildcardIterator::Bitmap(w) => w.print_profile(map, ctx),
         }
     }
 }
@@ -135,7 +180,8 @@ impl profile_print::ProfilePrint for WildcardIterator<'_> {
 ///
 /// # Parameters
 ///
-/// * `idx` - Pointer to the existingDocs inverted index (DocIdsOnly or RawDocIdsOnly encoded).
+/// * `idx` - Pointer to the existingDocs inverted index (DocIdsOnly, RawDocIdsOnly,
+///   PackedDocIdsOnly or BitmapDocIdsOnly encoded).
 /// * `sctx` - Pointer to the Redis search context.
 /// * `weight` - Weight to apply to all results.
 ///
@@ -176,8 +222,14 @@ pub unsafe extern "C" fn NewInvIndIterator_WildcardQuery(
         inverted_index_ffi::InvertedIndex::RawDocIdsOnly(ii) => {
             WildcardIterator::Raw(Wildcard::new(ii.reader(), weight))
         }
+        inverted_index_ffi::InvertedIndex::PackedDocIdsOnly(ii) => {
+            WildcardIterator::Packed(Wildcard::new(ii.reader(), weight))
+        }
+        inverted_index_ffi::InvertedIndex::BitmapDocIdsOnly(ii) => {
+            WildcardIterator::Bitmap(Wildcard::new(ii.reader(), weight))
+        }
         _ => panic!(
-            "Wildcard iterator requires a DocIdsOnly or RawDocIdsOnly inverted index, got: {:?}",
+            "Wildcard iterator requires a DocIdsOnly, RawDocIdsOnly, PackedDocIdsOnly or BitmapDocIdsOnly inverted index, got: {:?}",
             std::mem::discriminant(ii_ref)
         ),
     };
@@ -73,6 +73,17 @@ impl<'index> RQEIterator<'index> for NotIteratorEnum<'index> {
         }
     }
 
+    #[inline(always)]
+    fn read_batch(
+        &mut self,
+        batch: &mut rqe_iterators::DocIdBatch<'_>,
+    ) -> Result<(), rqe_iterators::RQEIteratorError> {
+        match self {
+            Self::Not(it) => it.read_batch(batch),
+            Self::NotOptimized(it) => it.read_batch(batch),
+        }
+    }
+
     #[inline(always)]
     fn skip_to(
         &mut self,
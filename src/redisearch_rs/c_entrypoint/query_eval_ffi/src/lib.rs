@@ -237,6 +237,16 @@ pub unsafe extern "C" fn QAST_Iterate(
         std::ptr::null_mut()
     };
 
+    // Let iterators prune on the top-k sorter's threshold when the request
+    // allows it.
+    let score_threshold = if areq.is_null() {
+        std::ptr::null()
+    } else {
+        // SAFETY: `areq` is non-null (checked above) and a valid `AREQ`
+        // (precondition 5).
+        unsafe { ffi::QOptimizer_ScoreThreshold(areq) }
+    };
+
     // Assemble the evaluation context for this query. `tokenId` starts at 0 and
     // is bumped as token iterators are created during evaluation.
     let mut qectx = QueryEvalCtx {
@@ -251,6 +261,8 @@ pub unsafe extern "C" fn QAST_Iterate(
         config: &raw mut qast.config,
         inNotSubTree: false,
         bcTimeoutAreq: bc_timeout_areq,
+        scoreThreshold: score_threshold,
+        inFilterCacheFill: false,
     };
 
     let root = NonNull::new(qast.root).expect("QAST_Iterate: qast root is null");
@@ -12,13 +12,16 @@
 //! This crate provides a safe Rust interface to the C Trie implementation, one
 //! module per trie kind: [`TermsTrie`] for the primary term index and
 //! [`SuffixTrie`] for the suffix index that answers queries which are not
-//! front-anchored. [`TrieTerm`] represents terms valid for trie operations,
+//! front-anchored. [`NgramIndex`] answers the same queries from the trigrams of
+//! the terms, for fields created `WITHNGRAMS`. [`TrieTerm`] represents terms valid for trie operations,
 //! while [`LoweredPattern`] carries the wildcard patterns they walk.
 
+mod ngram;
 mod suffix;
 mod terms;
 mod util;
 
+pub use ngram::NgramIndex;
 pub use suffix::{SuffixMode, SuffixTrie, SuffixWalk};
 pub use terms::{
     FuzzyWalk, InvalidFuzzyDistance, TermsTrie, TermsTrieAllIterator, TermsTrieDecrResult,
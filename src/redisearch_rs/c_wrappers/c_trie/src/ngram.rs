@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+//! The ngram index, which answers the queries of the suffix trie from the
+//! trigrams of the terms of the fields created `WITHNGRAMS`.
+
+use std::{marker::PhantomData, ops::ControlFlow, ptr};
+
+use crate::{LoweredPattern, SuffixMode, SuffixWalk, suffix::suffix_trampoline};
+
+/// A safe wrapper around a C [`ffi::NgramIndex`].
+///
+/// Only patterns holding a literal run of [`ffi::NGRAM_LEN`] runes can be
+/// answered; the walks report when they decline a pattern so the caller can
+/// fall back to the primary terms trie.
+#[derive(Debug)]
+#[repr(transparent)]
+pub struct NgramIndex {
+    inner: ffi::NgramIndex,
+    // As for `SuffixTrie`: the C index is mutated under the owning spec's lock,
+    // so the auto traits of the opaque ZST are removed.
+    _phantom: PhantomData<*mut ffi::NgramIndex>,
+}
+
+impl NgramIndex {
+    /// Borrow an existing C ngram index pointer as a shared reference.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must be a valid, non-null pointer to an [`ffi::NgramIndex`], must
+    /// remain live for `'a`, and must not be mutated for the duration.
+    pub const unsafe fn from_raw<'a>(ptr: *const ffi::NgramIndex) -> &'a Self {
+        debug_assert!(!ptr.is_null(), "C ngram index pointer cannot be null");
+        // SAFETY: guaranteed by caller
+        unsafe { &*ptr.cast::<Self>() }
+    }
+
+    /// Return a raw const pointer to the underlying [`ffi::NgramIndex`].
+    pub const fn as_ptr(&self) -> *const ffi::NgramIndex {
+        ptr::from_ref(self).cast::<ffi::NgramIndex>()
+    }
+
+    /// Visit every term ending with or containing `pattern`, as selected by
+    /// `mode`, like [`crate::SuffixTrie::iterate_contains`]. Each term is
+    /// delivered once.
+    ///
+    /// Returns `false`, without visiting anything, if `pattern` is shorter than
+    /// [`ffi::NGRAM_LEN`] runes.
+    pub fn iterate_contains<F>(
+        &self,
+        pattern: &[ffi::rune],
+        mode: SuffixMode,
+        mut callback: F,
+    ) -> bool
+    where
+        F: FnMut(&[u8]) -> ControlFlow<()>,
+    {
+        // SAFETY: `self` borrows a valid `ffi::NgramIndex`, the pattern
+        // pointer/len describe a live rune slice, and the callback closure
+        // outlives the call.
+        let used = unsafe {
+            ffi::NgramIndex_IterateContains(
+                self.as_ptr(),
+                pattern.as_ptr(),
+                pattern.len(),
+                mode.into(),
+                Some(suffix_trampoline::<F>),
+                ptr::from_mut(&mut callback).cast(),
+            )
+        };
+        used != 0
+    }
+
+    /// Visit every term matching a wildcard `pattern`, like
+    /// [`crate::SuffixTrie::iterate_wildcard`]. Each term is delivered once.
+    ///
+    /// When no literal run of the pattern holds [`ffi::NGRAM_LEN`] runes,
+    /// nothing is visited and the pattern is handed back as
+    /// [`SuffixWalk::NoAnchor`].
+    pub fn iterate_wildcard<F>(
+        &self,
+        pattern: LoweredPattern,
+        mut timeout: Option<ffi::timespec>,
+        mut callback: F,
+    ) -> SuffixWalk
+    where
+        F: FnMut(&[u8]) -> ControlFlow<()>,
+    {
+        let (timeout_ptr, skip_timeout_checks) = match &mut timeout {
+            Some(timeout) => (ptr::from_mut(timeout), false),
+            None => (ptr::null_mut(), true),
+        };
+        // SAFETY: `self` borrows a valid `ffi::NgramIndex`, the rune pointer
+        // describes a live pattern followed by its sentinel (`LoweredPattern`
+        // invariant), the callback closure outlives the call, and `timeout` is
+        // null or points to a valid `timeout` argument.
+        let used = unsafe {
+            ffi::NgramIndex_IterateWildcard(
+                self.as_ptr(),
+                pattern.runes.as_ptr(),
+                pattern.len(),
+                Some(suffix_trampoline::<F>),
+                ptr::from_mut(&mut callback).cast(),
+                timeout_ptr,
+                skip_timeout_checks,
+            )
+        };
+        if used == 0 {
+            SuffixWalk::NoAnchor(pattern)
+        } else {
+            SuffixWalk::Walked
+        }
+    }
+}
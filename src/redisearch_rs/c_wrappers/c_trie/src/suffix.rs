@@ -57,8 +57,9 @@ impl From<SuffixMode> for SuffixType {
 ///
 /// Both hold when the suffix trie invokes this through the function pointer
 /// installed by [`SuffixTrie::iterate_contains`] or
-/// [`SuffixTrie::iterate_wildcard`].
-unsafe extern "C" fn suffix_trampoline<F>(
+/// [`SuffixTrie::iterate_wildcard`], and when the ngram index invokes it through
+/// the one installed by [`crate::NgramIndex`].
+pub(crate) unsafe extern "C" fn suffix_trampoline<F>(
     s: *const c_char,
     len: usize,
     ctx: *mut c_void,
@@ -34,6 +34,7 @@ pub enum FieldSpecOption {
     UndefinedOrder = 0x80,
     IndexEmpty = 0x100,   // Index empty values (i.e., empty strings)
     IndexMissing = 0x200, // Index missing values (non-existing field)
+    WithNgrams = 0x400,   // Index the trigrams of the terms (TEXT)
 }
 pub type FieldSpecOptions = BitFlags<FieldSpecOption>;
 
@@ -10,6 +10,7 @@
 //! Safe wrapper around [`ffi::QueryEvalCtx`].
 
 use std::{
+    cell::Cell,
     ffi::{CStr, c_char},
     ptr::NonNull,
 };
@@ -107,6 +108,9 @@ impl QueryEvalContext {
     ///    context, but for the lifetime of every timeout context and iterator
     ///    derived from it (e.g. via
     ///    [`build_timeout_context`](QueryEvalContext::build_timeout_context)).
+    ///    `scoreThreshold` may be null; when non-null it must point to a valid
+    ///    `double`, written only by the thread running the query, that likewise
+    ///    outlives every iterator derived from the context.
     ///    The `opts.scorerName` pointer may be null (no scorer requested); when
     ///    non-null it must point to a valid NUL-terminated C string that stays
     ///    valid for at least the lifetime of the returned context (read by
@@ -539,6 +543,29 @@ impl QueryEvalContext {
         prev
     }
 
+    /// The score threshold of the request's top-k sorter, or `None` when
+    /// iterators may not skip documents scoring below it.
+    ///
+    /// The sorter keeps raising the threshold while results are drawn, so it is
+    /// handed out as a [`Cell`] to be re-read on every use.
+    ///
+    /// # Safety
+    ///
+    /// Like [`build_timeout_context`](Self::build_timeout_context), the returned
+    /// reference is not tied to the context: the caller must not use it after
+    /// the request owning the threshold is freed. For a [`QueryEvalContext`]
+    /// built through [`new`](Self::new), invariant (2) guarantees that for any
+    /// iterator built during the current query.
+    pub unsafe fn score_threshold<'a>(&self) -> Option<&'a Cell<f64>> {
+        let ptr = NonNull::new(self.as_ref().scoreThreshold.cast_mut())?;
+        // SAFETY: invariant (2) of `new` guarantees a non-null `scoreThreshold`
+        // points to a valid `double` only written by the query's own thread, and
+        // `Cell<f64>` has the same in-memory representation as `f64`; being an
+        // `UnsafeCell`, it tolerates the sorter's writes through its own pointer.
+        // The caller bounds `'a` by the lifetime of the request.
+        Some(unsafe { ptr.cast::<Cell<f64>>().as_ref() })
+    }
+
     /// Build the [`AnyTimeoutContext`] a query iterator should use for this
     /// evaluation.
     ///
@@ -216,6 +216,12 @@ const HEADERS: &[HeaderAllowlist] = &[
         types: &[],
         vars: &["RedisJSONAPI_MIN_API_VER", "japi", "japi_ver"],
     },
+    HeaderAllowlist {
+        path: "src/ngram_index.h",
+        fns: &["NgramIndex_IterateContains", "NgramIndex_IterateWildcard"],
+        types: &["NgramIndex"],
+        vars: &["NGRAM_LEN"],
+    },
     HeaderAllowlist {
         path: "src/numeric_filter.h",
         fns: &["NewNumericFilter", "NumericFilter_Free"],
@@ -241,7 +247,7 @@ const HEADERS: &[HeaderAllowlist] = &[
     },
     HeaderAllowlist {
         path: "src/query.h",
-        fns: &["Query_EvalNode", "tag_strtolower"],
+        fns: &["Query_EvalCachedFilter", "Query_EvalNode", "tag_strtolower"],
         types: &["QueryAST", "QueryEvalCtx"],
         vars: &[],
     },
@@ -266,6 +272,12 @@ const HEADERS: &[HeaderAllowlist] = &[
         ],
         vars: &[],
     },
+    HeaderAllowlist {
+        path: "src/query_optimizer.h",
+        fns: &["QOptimizer_ScoreThreshold"],
+        types: &[],
+        vars: &[],
+    },
     HeaderAllowlist {
         path: "src/redis_index.h",
         fns: &["Redis_OpenInvertedIndex", "Redis_OpenReaderIndex"],
@@ -121,11 +121,13 @@ impl ForkGC {
         bytes_allocated: usize,
         blocks_denied: u64,
         numeric_nodes_missed: u64,
+        blocks_merged: u64,
     ) {
         self.0.stats.totalCollected += bytes_collected as isize;
         self.0.stats.totalCollected -= bytes_allocated as isize;
         self.0.stats.gcBlocksDenied += blocks_denied;
         self.0.stats.gcNumericNodesMissed += numeric_nodes_missed;
+        self.0.stats.gcBlocksMerged += blocks_merged;
     }
 }
 
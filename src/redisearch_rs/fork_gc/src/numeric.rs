@@ -295,6 +295,7 @@ fn apply_numeric_node(tree: &mut NumericRangeTree, node: NumericNodeDelta) -> Op
         block_count_delta: info.block_count_delta,
         blocks_denied: info.ignored_last_block as u64,
         numeric_nodes_missed: 0,
+        blocks_merged: info.blocks_merged as u64,
     })
 }
 
@@ -34,6 +34,9 @@ pub struct GcApplyStats {
     /// Numeric tree nodes that had vanished by the time the parent tried to
     /// apply their delta. Increments the GC's `gcNumericNodesMissed`.
     pub numeric_nodes_missed: u64,
+    /// Sparse blocks merged into a neighbouring block. Increments the GC's
+    /// `gcBlocksMerged`.
+    pub blocks_merged: u64,
 }
 
 impl GcApplyStats {
@@ -48,6 +51,7 @@ impl GcApplyStats {
         self.block_count_delta += other.block_count_delta;
         self.blocks_denied += other.blocks_denied;
         self.numeric_nodes_missed += other.numeric_nodes_missed;
+        self.blocks_merged += other.blocks_merged;
     }
 
     /// Apply this delta to both the spec-level and GC-level statistics.
@@ -66,6 +70,7 @@ impl GcApplyStats {
             self.bytes_allocated,
             self.blocks_denied,
             self.numeric_nodes_missed,
+            self.blocks_merged,
         );
     }
 }
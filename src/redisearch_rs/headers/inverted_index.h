@@ -49,6 +49,12 @@ typedef struct AddRecordOutcome {
    * Number of new index blocks this write created.
    */
   uint32_t blocks_added;
+  /**
+   * Number of bytes released by sealing the block this write moved on from, see
+   * [`IndexBlock::seal`]. To be subtracted from the index's memory usage along with
+   * adding [`Self::mem_growth`].
+   */
+  uint32_t mem_released;
 } AddRecordOutcome;
 
 /**
@@ -95,6 +101,10 @@ typedef struct II_GCScanStats {
    * Callers maintaining per-spec totals should add this signed value to their counter.
    */
   int64_t block_count_delta;
+  /**
+   * The number of sparse blocks whose entries were merged into a neighbouring block.
+   */
+  size_t blocks_merged;
   /**
    * Whether or not we ignored the last block in the index, since it changed
    * compared to the time we performed the scan
@@ -462,6 +462,17 @@ struct IISummary InvertedIndex_Summary(const struct InvertedIndex *ii);
  */
 struct AddRecordOutcome InvertedIndex_WriteEntryGeneric(struct InvertedIndex *ii, const RSIndexResult *record);
 
+/**
+ * Write a new term entry to the inverted index, like [`InvertedIndex_WriteEntryGeneric`],
+ * also recording the length of the document it belongs to. The block's score bounds use it
+ * to let top-k queries skip blocks which cannot reach their threshold.
+ *
+ * # Safety
+ * - `ii` must be a valid pointer to an `InvertedIndex` instance and cannot be NULL.
+ * - `record` must be a valid pointer to an `RSIndexResult` instance and cannot be NULL.
+ */
+struct AddRecordOutcome InvertedIndex_WriteScoredEntry(struct InvertedIndex *ii, const RSIndexResult *record, uint32_t doc_len);
+
 /**
  * Write a new numeric entry to the inverted index. This is only valid for numeric indexes
  * created with the `StoreNumeric` flag. Returns an [`AddRecordOutcome`] reporting the memory
@@ -489,8 +500,12 @@ struct IndexReader *NewIndexReader(const struct InvertedIndex *ii, union IndexDe
 /**
  * Create a new inverted index instance based on the provided flags and options. `raw_doc_encoding`
  * controls whether document IDs only encoding should use raw encoding (true) or varint encoding
- * (false). `compress_floats` controls whether numeric encoding should have its floating point
- * numbers compressed (true) or not (false). Compressing floating point numbers saves memory
+ * (false). `packed_doc_id_encoding` makes document IDs only encoding bit-pack the deltas in groups
+ * of 128 entries instead, and takes precedence over `raw_doc_id_encoding`.
+ * `bitmap_doc_id_encoding` makes document IDs only encoding store dense blocks as bitmaps or runs
+ * of consecutive IDs, and takes precedence over both. `compress_floats` controls whether numeric
+ * encoding should have its floating point numbers compressed (true) or not (false). Compressing
+ * floating point numbers saves memory
  * but lowers precision.
  *
  * The output parameter `mem_size` will be set to the memory usage of the created index. The
@@ -510,7 +525,7 @@ struct IndexReader *NewIndexReader(const struct InvertedIndex *ii, union IndexDe
  * - `StoreNumeric`
  * - `DocIdsOnly`
  */
-struct InvertedIndex *NewInvertedIndex_Ex(IndexFlags flags, bool raw_doc_id_encoding, bool compress_floats, size_t *mem_size);
+struct InvertedIndex *NewInvertedIndex_Ex(IndexFlags flags, bool raw_doc_id_encoding, bool packed_doc_id_encoding, bool bitmap_doc_id_encoding, bool compress_floats, size_t *mem_size);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -521,6 +536,6 @@ struct InvertedIndex *NewInvertedIndex_Ex(IndexFlags flags, bool raw_doc_id_enco
 //
 // The inverted index should be freed using [`InvertedIndex_Free`] when no longer needed.
 inline static struct InvertedIndex *NewInvertedIndex(IndexFlags flags, size_t *memsize) {
-  return NewInvertedIndex_Ex(flags, RSGlobalConfig.invertedIndexRawDocidEncoding, RSGlobalConfig.numericCompress, memsize);
+  return NewInvertedIndex_Ex(flags, RSGlobalConfig.invertedIndexRawDocidEncoding, RSGlobalConfig.invertedIndexPackedDocidEncoding, RSGlobalConfig.invertedIndexBitmapDocidEncoding, RSGlobalConfig.numericCompress, memsize);
 }
 
@@ -77,7 +77,11 @@ enum IteratorType
    * Used only in tests.
    */
   IteratorType_Mock = 23,
-  IteratorType_Max = 24,
+  /**
+   * Top-k union of term iterators skipping blocks that cannot reach the score threshold.
+   */
+  IteratorType_BlockMaxWand = 24,
+  IteratorType_Max = 25,
 };
 #ifndef __cplusplus
 typedef uint32_t IteratorType;
@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+//! Document ID postings stored in roaring-style containers, picked per block from its density.
+//!
+//! Every block encoded with [`BitmapDocIdsOnly`] is laid out as one of three [`Container`]s:
+//!
+//! - [`Container::Varint`]: one varint delta per entry, exactly like
+//!   [`DocIdsOnly`](crate::doc_ids_only::DocIdsOnly). Every block starts out this way.
+//! - [`Container::Bitmap`]: one bit per document ID from the block's first entry to its last.
+//! - [`Container::Runs`]: the ranges of consecutive document IDs of the block.
+//!
+//! The first entry of a block is written with a zero delta, so a varint container always starts
+//! with a `0` byte. The two dense containers start with a non-zero tag and share a header:
+//!
+//! ```text
+//! +---------+-------------------+---------------------------------------------------------+
+//! | tag: u8 | first_doc_id: u64 | Bitmap: span / 64 little-endian u64 words               |
+//! |         | (little-endian)   | Runs:   (start: u16, last: u16) little-endian offsets   |
+//! +---------+-------------------+---------------------------------------------------------+
+//! ```
+//!
+//! Bits and run offsets are relative to `first_doc_id`, so a dense block covers at most
+//! [`MAX_DENSE_SPAN`] document IDs and the next document past that starts a new block.
+//!
+//! A varint block is checked whenever its number of entries reaches a power of two, from
+//! [`PROBE_MIN_ENTRIES`] on. If a dense container would take less room, the block is converted
+//! and may then grow to [`MAX_DENSE_ENTRIES`] entries instead of
+//! [`RECOMMENDED_BLOCK_ENTRIES`](Encoder::RECOMMENDED_BLOCK_ENTRIES). A run container turns into
+//! a bitmap once its runs take more room than the bitmap would. Sparse postings thus stay as
+//! compact as with `DocIdsOnly`, while the postings of every existing document or of a very
+//! common tag shrink to a few bytes per thousand documents and can be combined a 64-bit word at
+//! a time (see [`DocIdsDecoder::decode_block_doc_ids_words`]).
+//!
+//! Entries of a dense container are not byte-addressable: the decoder finds the entry following
+//! the one at `base`, and the cursor only reaches the end of the buffer once the last entry is
+//! decoded.
+
+use std::io::{Cursor, Seek, Write};
+
+use rqe_core::DocId;
+
+use crate::{Decoder, DocIdsDecoder, Encoder, IndexBlock, TermDecoder, doc_ids_only::DocIdsOnly};
+use index_result::RSIndexResult;
+
+/// The number of document IDs a bitmap or run container can cover.
+pub const MAX_DENSE_SPAN: DocId = 1 << u16::BITS;
+
+/// The number of entries after which a bitmap or run container is closed.
+pub const MAX_DENSE_ENTRIES: u16 = u16::MAX - 1;
+
+/// The number of entries from which a varint container is checked for conversion.
+pub const PROBE_MIN_ENTRIES: u16 = 64;
+
+const TAG_BITMAP: u8 = 1;
+const TAG_RUNS: u8 = 2;
+
+/// The size of the header of the dense containers: the tag followed by the first document ID.
+const HEADER_LEN: usize = 1 + size_of::<u64>();
+const WORD_LEN: usize = size_of::<u64>();
+const RUN_LEN: usize = 2 * size_of::<u16>();
+
+/// Encode and decode only the document ID of a record, in whichever of the varint, bitmap or run
+/// containers is the most compact for each block. See the [module documentation](self) for the
+/// layouts.
+#[derive(Debug)]
+pub struct BitmapDocIdsOnly;
+
+/// The layout of a block encoded with [`BitmapDocIdsOnly`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Container {
+    /// A varint delta per entry.
+    Varint,
+    /// A bit per document ID of the block's span.
+    Bitmap,
+    /// A pair of offsets per range of consecutive document IDs.
+    Runs,
+}
+
+fn unexpected_eof() -> std::io::Error {
+    std::io::Error::new(
+        std::io::ErrorKind::UnexpectedEof,
+        "bitmap doc ids container is truncated",
+    )
+}
+
+fn invalid_data() -> std::io::Error {
+    std::io::Error::new(
+        std::io::ErrorKind::InvalidData,
+        "invalid bitmap doc ids container",
+    )
+}
+
+/// Read the first document ID from the header of a dense container.
+fn dense_first(buf: &[u8]) -> std::io::Result<DocId> {
+    let header = buf.get(1..HEADER_LEN).ok_or_else(unexpected_eof)?;
+    Ok(u64::from_le_bytes(
+        header.try_into().expect("the header holds a u64"),
+    ))
+}
+
+/// Write the header of a dense container.
+fn dense_header(tag: u8, first: DocId) -> [u8; HEADER_LEN] {
+    let mut header = [0; HEADER_LEN];
+    header[0] = tag;
+    header[1..].copy_from_slice(&first.to_le_bytes());
+    header
+}
+
+/// The words of a bitmap container, addressed by index.
+struct Bitmap<'a>(&'a [u8]);
+
+impl<'a> Bitmap<'a> {
+    fn new(buf: &'a [u8]) -> std::io::Result<Self> {
+        let words = buf.get(HEADER_LEN..).ok_or_else(unexpected_eof)?;
+        if words.is_empty() || !words.len().is_multiple_of(WORD_LEN) {
+            return Err(invalid_data());
+        }
+        Ok(Self(words))
+    }
+
+    const fn len(&self) -> usize {
+        self.0.len() / WORD_LEN
+    }
+
+    #[inline(always)]
+    fn word(&self, idx: usize) -> u64 {
+        let start = idx * WORD_LEN;
+        u64::from_le_bytes(
+            self.0[start..start + WORD_LEN]
+                .try_into()
+                .expect("words are 8 bytes"),
+        )
+    }
+
+    /// The 64 bits starting at bit `start`, which may be negative. Bits outside the bitmap are
+    /// zero.
+    #[inline(always)]
+    fn bits_at(&self, start: i64) -> u64 {
+        let word = |idx: i64| {
+            if idx < 0 || idx as usize >= self.len() {
+                0
+            } else {
+                self.word(idx as usize)
+            }
+        };
+        let (idx, shift) = (start.div_euclid(64), start.rem_euclid(64) as u32);
+        if shift == 0 {
+            word(idx)
+        } else {
+            (word(idx) >> shift) | (word(idx + 1) << (64 - shift))
+        }
+    }
+
+    /// The offset of the last set bit. The last word is never zero.
+    fn last(&self) -> u64 {
+        let idx = self.len() - 1;
+        (idx * 64) as u64 + 63 - self.word(idx).leading_zeros() as u64
+    }
+
+    /// The offset of the first set bit at or after `from`, if any.
+    fn next(&self, from: u64) -> Option<u64> {
+        let mut idx = (from / 64) as usize;
+        if idx >= self.len() {
+            return None;
+        }
+        let mut word = self.word(idx) & (!0u64 << (from % 64));
+        loop {
+            if word != 0 {
+                return Some((idx * 64) as u64 + word.trailing_zeros() as u64);
+            }
+            idx += 1;
+            if idx >= self.len() {
+                return None;
+            }
+            word = self.word(idx);
+        }
+    }
+
+    /// The number of set bits in `[from, to)`.
+    fn count(&self, from: u64, to: u64) -> u64 {
+        if to <= from {
+            return 0;
+        }
+        let (first, last) = ((from / 64) as usize, ((to - 1) / 64) as usize);
+        let mut count = 0;
+        for idx in first..=last.min(self.len() - 1) {
+            let mut word = self.word(idx);
+            if idx == first {
+                word &= !0u64 << (from % 64);
+            }
+            if idx == last && !to.is_multiple_of(64) {
+                word &= (1u64 << (to % 64)) - 1;
+            }
+            count += word.count_ones() as u64;
+        }
+        count
+    }
+}
+
+/// The runs of a run container, addressed by their byte position in the block buffer.
+struct Runs<'a>(&'a [u8]);
+
+impl Runs<'_> {
+    /// Read the `(start, last)` offsets of the run at `pos`.
+    #[inline(always)]
+    fn at(&self, pos: usize) -> std::io::Result<(u64, u64)> {
+        let run = self.0.get(pos..pos + RUN_LEN).ok_or_else(unexpected_eof)?;
+        let start = u16::from_le_bytes([run[0], run[1]]) as u64;
+        let last = u16::from_le_bytes([run[2], run[3]]) as u64;
+        if last < start {
+            return Err(invalid_data());
+        }
+        Ok((start, last))
+    }
+
+    /// Iterate over the `(start, last)` offsets of every run.
+    fn iter(&self) -> impl Iterator<Item = std::io::Result<(u64, u64)>> + '_ {
+        (HEADER_LEN..self.0.len())
+            .step_by(RUN_LEN)
+            .map(|pos| self.at(pos))
+    }
+}
+
+/// Set the bits `[from, to]` of `words`. Both must be in bounds.
+fn set_bit_range(words: &mut [u64], from: usize, to: usize) {
+    let (first, last) = (from / 64, to / 64);
+    for (idx, word) in words.iter_mut().enumerate().take(last + 1).skip(first) {
+        let mut mask = !0u64;
+        if idx == first {
+            mask &= !0u64 << (from % 64);
+        }
+        if idx == last {
+            mask &= !0u64 >> (63 - to % 64);
+        }
+        *word |= mask;
+    }
+}
+
+impl BitmapDocIdsOnly {
+    /// Returns the container `buf`, the buffer of a block, is laid out as.
+    pub fn container(buf: &[u8]) -> std::io::Result<Container> {
+        match buf.first() {
+            None => Err(unexpected_eof()),
+            Some(0) => Ok(Container::Varint),
+            Some(&TAG_BITMAP) => Ok(Container::Bitmap),
+            Some(&TAG_RUNS) => Ok(Container::Runs),
+            Some(_) => Err(invalid_data()),
+        }
+    }
+
+    /// Decode the offsets of every entry of a varint container, relative to `first`.
+    fn varint_offsets(buf: &[u8], first: DocId) -> std::io::Result<Vec<u64>> {
+        let mut cursor = Cursor::new(buf);
+        let mut result = Self::base_result();
+        let mut offsets = Vec::new();
+        let mut base = first;
+        while (cursor.position() as usize) < buf.len() {
+            DocIdsOnly::decode(&mut cursor, base, &mut result)?;
+            offsets.push(result.doc_id - first);
+            base = result.doc_id;
+        }
+        Ok(offsets)
+    }
+
+    /// Re-encode a varint block whose last entry is `doc_id` as a bitmap or run container, if
+    /// either would be smaller.
+    fn try_densify(block: &mut IndexBlock, doc_id: DocId) -> std::io::Result<()> {
+        let first = block.first_doc_id;
+        if doc_id - first >= MAX_DENSE_SPAN {
+            return Ok(());
+        }
+        let offsets = Self::varint_offsets(&block.buffer, first)?;
+        let num_runs = 1 + offsets.windows(2).filter(|w| w[1] != w[0] + 1).count();
+        let bitmap_len = ((doc_id - first) / 64 + 1) as usize * WORD_LEN;
+        let runs_len = num_runs * RUN_LEN;
+        if HEADER_LEN + bitmap_len.min(runs_len) >= block.buffer.len() {
+            return Ok(());
+        }
+
+        // Clearing the buffer keeps its allocation, which the dense container grows into.
+        block.buffer.clear();
+        let mut writer = block.writer();
+        if runs_len <= bitmap_len {
+            writer.write_all(&dense_header(TAG_RUNS, first))?;
+            let mut start = offsets[0];
+            for (idx, &off) in offsets.iter().enumerate() {
+                let run_ends = offsets.get(idx + 1).is_none_or(|&next| next != off + 1);
+                if run_ends {
+                    writer.write_all(&(start as u16).to_le_bytes())?;
+                    writer.write_all(&(off as u16).to_le_bytes())?;
+                    start = offsets.get(idx + 1).copied().unwrap_or_default();
+                }
+            }
+        } else {
+            let mut words = vec![0u64; bitmap_len / WORD_LEN];
+            for off in offsets {
+                words[off as usize / 64] |= 1 << (off % 64);
+            }
+            writer.write_all(&dense_header(TAG_BITMAP, first))?;
+            for word in words {
+                writer.write_all(&word.to_le_bytes())?;
+            }
+        }
+        Ok(())
+    }
+
+    /// Set the bit at `off` in the bitmap container of `block`, growing it as needed.
+    fn bitmap_insert(block: &mut IndexBlock, off: u64) -> std::io::Result<()> {
+        let words = (block.buffer.len() - HEADER_LEN) / WORD_LEN;
+        let needed = off as usize / 64 + 1;
+        if needed > words {
+            let mut writer = block.writer();
+            for _ in words..needed {
+                writer.write_all(&[0; WORD_LEN])?;
+            }
+        }
+        // Words are little-endian, so the bit can be set in its byte directly.
+        block.buffer[HEADER_LEN + off as usize / 8] |= 1 << (off % 8);
+        Ok(())
+    }
+
+    /// Add `off` to the run container of `block`, turning it into a bitmap if the runs would
+    /// then take more room.
+    fn runs_insert(block: &mut IndexBlock, off: u64) -> std::io::Result<()> {
+        let last_run = block.buffer.len() - RUN_LEN;
+        let (_, last) = Runs(&block.buffer).at(last_run)?;
+        if off == last + 1 {
+            block.buffer[last_run + 2..last_run + RUN_LEN]
+                .copy_from_slice(&(off as u16).to_le_bytes());
+            return Ok(());
+        }
+
+        let runs_len = block.buffer.len() - HEADER_LEN + RUN_LEN;
+        let bitmap_len = (off as usize / 64 + 1) * WORD_LEN;
+        if runs_len <= bitmap_len {
+            let mut writer = block.writer();
+            writer.write_all(&(off as u16).to_le_bytes())?;
+            writer.write_all(&(off as u16).to_le_bytes())?;
+            return Ok(());
+        }
+
+        let mut words = vec![0u64; bitmap_len / WORD_LEN];
+        for run in Runs(&block.buffer).iter() {
+            let (start, last) = run?;
+            set_bit_range(&mut words, start as usize, last as usize);
+        }
+        words[off as usize / 64] |= 1 << (off % 64);
+
+        let first = block.first_doc_id;
+        block.buffer.clear();
+        let mut writer = block.writer();
+        writer.write_all(&dense_header(TAG_BITMAP, first))?;
+        for word in words {
+            writer.write_all(&word.to_le_bytes())?;
+        }
+        Ok(())
+    }
+}
+
+impl Encoder for BitmapDocIdsOnly {
+    type Delta = u32;
+    const RECOMMENDED_BLOCK_ENTRIES: u16 = 1000;
+
+    /// Write the record as a varint delta, the way the varint container stores it.
+    ///
+    /// The inverted index goes through [`Encoder::encode_into`] instead, which also maintains the
+    /// dense containers.
+    fn encode<W: Write + Seek>(
+        writer: W,
+        delta: Self::Delta,
+        record: &RSIndexResult,
+    ) -> std::io::Result<usize> {
+        DocIdsOnly::encode(writer, delta, record)
+    }
+
+    fn encode_into(
+        block: &mut IndexBlock,
+        delta: Self::Delta,
+        record: &RSIndexResult,
+    ) -> std::io::Result<usize> {
+        if block.num_entries == 0 {
+            return Self::encode(block.writer(), delta, record);
+        }
+
+        let old_len = block.buffer.len();
+        let doc_id = block.last_doc_id + delta as DocId;
+        match Self::container(&block.buffer)? {
+            Container::Varint => {
+                Self::encode(block.writer(), delta, record)?;
+                let num_entries = block.num_entries + 1;
+                if num_entries >= PROBE_MIN_ENTRIES && num_entries.is_power_of_two() {
+                    Self::try_densify(block, doc_id)?;
+                }
+            }
+            Container::Bitmap => Self::bitmap_insert(block, doc_id - block.first_doc_id)?,
+            Container::Runs => Self::runs_insert(block, doc_id - block.first_doc_id)?,
+        }
+
+        Ok(block.buffer.len().saturating_sub(old_len))
+    }
+
+    fn is_block_full(block: &IndexBlock, doc_id: DocId) -> bool {
+        match Self::container(&block.buffer) {
+            Ok(Container::Bitmap | Container::Runs) => {
+                block.num_entries >= MAX_DENSE_ENTRIES
+                    || doc_id - block.first_doc_id >= MAX_DENSE_SPAN
+            }
+            _ => block.num_entries >= Self::RECOMMENDED_BLOCK_ENTRIES,
+        }
+    }
+}
+
+impl Decoder for BitmapDocIdsOnly {
+    /// Decode the first entry of the block at the cursor position.
+    ///
+    /// The inverted index reader goes through [`Decoder::decode_entry`] instead, which can
+    /// address every entry of a dense container.
+    #[inline(always)]
+    fn decode<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<()> {
+        Self::decode_entry(cursor, base, 0, result)
+    }
+
+    #[inline(always)]
+    fn decode_entry<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        ordinal: u16,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<()> {
+        let buf = *cursor.get_ref();
+        match Self::container(buf)? {
+            Container::Varint => DocIdsOnly::decode(cursor, base, result),
+            Container::Bitmap => {
+                let first = dense_first(buf)?;
+                let bitmap = Bitmap::new(buf)?;
+                let from = if ordinal == 0 { 0 } else { base - first + 1 };
+                let off = bitmap.next(from).ok_or_else(unexpected_eof)?;
+
+                result.doc_id = first + off;
+                cursor.set_position(if off == bitmap.last() {
+                    buf.len() as u64
+                } else {
+                    (HEADER_LEN + off as usize / 64 * WORD_LEN) as u64
+                });
+                Ok(())
+            }
+            Container::Runs => {
+                let first = dense_first(buf)?;
+                // The cursor stays on the run holding the next entry.
+                let pos = (cursor.position() as usize).max(HEADER_LEN);
+                let (start, last) = Runs(buf).at(pos)?;
+                let prev = base - first;
+                let off = if ordinal == 0 || prev < start {
+                    start
+                } else {
+                    prev + 1
+                };
+                if off > last {
+                    return Err(invalid_data());
+                }
+
+                result.doc_id = first + off;
+                cursor.set_position(if off == last { pos + RUN_LEN } else { pos } as u64);
+                Ok(())
+            }
+        }
+    }
+
+    fn seek<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        target: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<Option<u16>> {
+        Self::seek_entry(cursor, base, 0, target, result)
+    }
+
+    fn seek_entry<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        ordinal: u16,
+        target: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<Option<u16>> {
+        let buf = *cursor.get_ref();
+        let container = Self::container(buf)?;
+        if container == Container::Varint {
+            return DocIdsOnly::seek(cursor, base, target, result);
+        }
+
+        let first = dense_first(buf)?;
+        // The offset of the next entry's lowest possible document ID.
+        let from = if ordinal == 0 { 0 } else { base - first + 1 };
+        let target = target.saturating_sub(first).max(from);
+
+        if container == Container::Bitmap {
+            let bitmap = Bitmap::new(buf)?;
+            let Some(off) = bitmap.next(target) else {
+                cursor.set_position(buf.len() as u64);
+                return Ok(None);
+            };
+            result.doc_id = first + off;
+            cursor.set_position(if off == bitmap.last() {
+                buf.len() as u64
+            } else {
+                (HEADER_LEN + off as usize / 64 * WORD_LEN) as u64
+            });
+            return Ok(Some(bitmap.count(from, off) as u16));
+        }
+
+        let runs = Runs(buf);
+        let mut pos = (cursor.position() as usize).max(HEADER_LEN);
+        let mut skipped = 0;
+        while pos < buf.len() {
+            let (start, last) = runs.at(pos)?;
+            let start = start.max(from);
+            if last < target {
+                skipped += last + 1 - start;
+                pos += RUN_LEN;
+                continue;
+            }
+            let off = start.max(target);
+            result.doc_id = first + off;
+            cursor.set_position(if off == last { pos + RUN_LEN } else { pos } as u64);
+            return Ok(Some((skipped + off - start) as u16));
+        }
+        cursor.set_position(buf.len() as u64);
+        Ok(None)
+    }
+
+    fn base_result<'index>() -> RSIndexResult<'index> {
+        RSIndexResult::build_term().build()
+    }
+}
+
+impl TermDecoder for BitmapDocIdsOnly {}
+impl DocIdsDecoder for BitmapDocIdsOnly {
+    fn decode_block_doc_ids(block: &IndexBlock, out: &mut Vec<DocId>) -> std::io::Result<()> {
+        let buf = block.buffer.as_slice();
+        match Self::container(buf)? {
+            Container::Varint => DocIdsOnly::decode_block_doc_ids(block, out),
+            Container::Bitmap => {
+                let first = dense_first(buf)?;
+                let bitmap = Bitmap::new(buf)?;
+                out.reserve(block.num_entries as usize);
+                for idx in 0..bitmap.len() {
+                    let mut word = bitmap.word(idx);
+                    while word != 0 {
+                        out.push(first + (idx * 64) as DocId + word.trailing_zeros() as DocId);
+                        word &= word - 1;
+                    }
+                }
+                Ok(())
+            }
+            Container::Runs => {
+                let first = dense_first(buf)?;
+                out.reserve(block.num_entries as usize);
+                for run in Runs(buf).iter() {
+                    let (start, last) = run?;
+                    out.extend(first + start..=first + last);
+                }
+                Ok(())
+            }
+        }
+    }
+
+    fn decode_block_doc_ids_words(
+        block: &IndexBlock,
+        base: DocId,
+        words: &mut [u64],
+    ) -> std::io::Result<()> {
+        let buf = block.buffer.as_slice();
+        let container = Self::container(buf)?;
+        if container == Container::Varint {
+            return DocIdsOnly::decode_block_doc_ids_words(block, base, words);
+        }
+
+        let first = dense_first(buf)?;
+        let end = base.saturating_add((words.len() * 64) as DocId);
+        if container == Container::Bitmap {
+            let bitmap = Bitmap::new(buf)?;
+            let span_end = first + bitmap.len() as DocId * 64;
+            // Only the words of the window which overlap the bitmap need to be looked at.
+            let from = (first.saturating_sub(base) / 64) as usize;
+            let to = (span_end.min(end).saturating_sub(base)).div_ceil(64) as usize;
+            for (idx, word) in words.iter_mut().enumerate().take(to).skip(from) {
+                let start = (base + (idx * 64) as DocId).wrapping_sub(first) as i64;
+                *word |= bitmap.bits_at(start);
+            }
+            return Ok(());
+        }
+
+        for run in Runs(buf).iter() {
+            let (start, last) = run?;
+            let (start, last) = (first + start, first + last);
+            if last < base {
+                continue;
+            }
+            if start >= end {
+                break;
+            }
+            let from = start.max(base) - base;
+            let to = last.min(end - 1) - base;
+            set_bit_range(words, from as usize, to as usize);
+        }
+        Ok(())
+    }
+}
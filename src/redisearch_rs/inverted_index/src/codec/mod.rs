@@ -7,6 +7,7 @@
  * GNU Affero General Public License v3 (AGPLv3).
 */
 
+pub mod bitmap_doc_ids_only;
 pub mod doc_ids_only;
 pub mod fields_offsets;
 pub mod fields_only;
@@ -16,6 +17,7 @@ pub mod freqs_only;
 pub mod full;
 pub mod numeric;
 pub mod offsets_only;
+pub mod packed_doc_ids_only;
 pub mod raw_doc_ids_only;
 
 use std::io::{Cursor, Seek, Write};
@@ -77,10 +79,34 @@ pub trait Encoder {
         record: &RSIndexResult,
     ) -> std::io::Result<usize>;
 
+    /// Append the record to the end of `block` and return the number of bytes written.
+    ///
+    /// The default writes the output of [`Encoder::encode`] after the block's existing data.
+    /// Encoders which pack several entries together (see
+    /// [`crate::packed_doc_ids_only::PackedDocIdsOnly`]) override it to re-layout the tail of
+    /// the block in place. `block.num_entries` still counts the entries written before this one.
+    fn encode_into(
+        block: &mut IndexBlock,
+        delta: Self::Delta,
+        record: &RSIndexResult,
+    ) -> std::io::Result<usize> {
+        Self::encode(block.writer(), delta, record)
+    }
+
     /// Returns the base value that should be used for any delta calculations
     fn delta_base(block: &IndexBlock) -> DocId {
         block.last_doc_id
     }
+
+    /// Returns `true` if the entry for `doc_id` must go to a new block instead of `block`, the
+    /// last block of the index.
+    ///
+    /// The default closes blocks at [`Encoder::RECOMMENDED_BLOCK_ENTRIES`]. Encoders whose block
+    /// capacity depends on the layout of the block (see
+    /// [`crate::bitmap_doc_ids_only::BitmapDocIdsOnly`]) override it.
+    fn is_block_full(block: &IndexBlock, _doc_id: DocId) -> bool {
+        block.num_entries >= Self::RECOMMENDED_BLOCK_ENTRIES
+    }
 }
 
 /// Trait to model that an encoder can be decoded by a decoder.
@@ -148,6 +174,35 @@ pub trait Decoder {
         }
     }
 
+    /// Like [`Decoder::decode`], for the entry at `ordinal` (its 0-based position within the
+    /// block).
+    ///
+    /// Readers always decode through this method. Decoders whose entries are not
+    /// byte-addressable on their own (see [`crate::packed_doc_ids_only::PackedDocIdsOnly`])
+    /// override it to locate the entry; the default ignores the ordinal.
+    #[inline(always)]
+    fn decode_entry<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        _ordinal: u16,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<()> {
+        Self::decode(cursor, base, result)
+    }
+
+    /// Like [`Decoder::seek`], starting from the entry at `ordinal` (its 0-based position within
+    /// the block). See [`Decoder::decode_entry`] for when this needs to be overridden.
+    #[inline(always)]
+    fn seek_entry<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        _ordinal: u16,
+        target: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<Option<u16>> {
+        Self::seek(cursor, base, target, result)
+    }
+
     /// Returns the base value to use for any delta calculations
     fn base_id(_block: &IndexBlock, last_doc_id: DocId) -> DocId {
         last_doc_id
@@ -158,8 +213,62 @@ pub trait Decoder {
 pub trait NumericDecoder: Decoder {}
 /// Marker trait for decoders producing term results.
 pub trait TermDecoder: Decoder {}
-/// Marker trait for decoders producing only document IDs.
-pub trait DocIdsDecoder: Decoder {}
+/// Trait for decoders producing only document IDs.
+pub trait DocIdsDecoder: Decoder {
+    /// Decode the document IDs of every entry in `block`, appending them to `out` in order.
+    ///
+    /// This lets readers hand out a whole block at once, e.g. to intersect postings a block at a
+    /// time. Decoders can override the default implementation, which decodes one entry at a time,
+    /// with a faster bulk one.
+    fn decode_block_doc_ids(block: &IndexBlock, out: &mut Vec<DocId>) -> std::io::Result<()> {
+        let mut cursor = Cursor::new(block.buffer.as_slice());
+        let mut result = Self::base_result();
+        let mut last_doc_id = block.first_doc_id;
+
+        out.reserve(block.num_entries as usize);
+        for ordinal in 0..block.num_entries {
+            let base = Self::base_id(block, last_doc_id);
+            Self::decode_entry(&mut cursor, base, ordinal, &mut result)?;
+            out.push(result.doc_id);
+            last_doc_id = result.doc_id;
+        }
+
+        Ok(())
+    }
+
+    /// Set the bit of every entry of `block` with a document ID in the window of
+    /// `64 * words.len()` IDs starting at `base`: bit `i % 64` of `words[i / 64]` stands for
+    /// document `base + i`. Bits already set are kept, so the windows of several blocks can be
+    /// collected into the same words.
+    ///
+    /// The default decodes one entry at a time. Decoders storing dense postings as bitmaps (see
+    /// [`crate::bitmap_doc_ids_only::BitmapDocIdsOnly`]) override it with word copies.
+    fn decode_block_doc_ids_words(
+        block: &IndexBlock,
+        base: DocId,
+        words: &mut [u64],
+    ) -> std::io::Result<()> {
+        let end = base.saturating_add((words.len() * 64) as DocId);
+        let mut cursor = Cursor::new(block.buffer.as_slice());
+        let mut result = Self::base_result();
+        let mut last_doc_id = block.first_doc_id;
+
+        for ordinal in 0..block.num_entries {
+            let base_id = Self::base_id(block, last_doc_id);
+            Self::decode_entry(&mut cursor, base_id, ordinal, &mut result)?;
+            if result.doc_id >= end {
+                break;
+            }
+            if result.doc_id >= base {
+                let bit = (result.doc_id - base) as usize;
+                words[bit / 64] |= 1 << (bit % 64);
+            }
+            last_doc_id = result.doc_id;
+        }
+
+        Ok(())
+    }
+}
 
 /// The capacity of the block vector used by [`crate::InvertedIndex`].
 pub type BlockCapacity = u32;
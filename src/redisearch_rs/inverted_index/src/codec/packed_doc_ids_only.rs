@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+//! Bit-packed document ID deltas, stored in groups of [`GROUP_LEN`] entries.
+//!
+//! A block encoded with [`PackedDocIdsOnly`] is a sequence of groups. Every group but the last
+//! one in a block holds exactly [`GROUP_LEN`] entries. Each group is laid out as:
+//!
+//! ```text
+//! +-----------+---------+------------------------------------------+
+//! | width: u8 | len: u8 | len * width bits, little-endian, padded  |
+//! +-----------+---------+------------------------------------------+
+//! ```
+//!
+//! where `width` is the number of bits needed by the largest delta of the group. A full group
+//! therefore takes `2 + 16 * width` bytes, and a group of very dense postings (deltas of 1) takes
+//! 18 bytes for 128 documents.
+//!
+//! Entries are not byte-addressable, so the decoder needs the entry's ordinal within the block to
+//! find it (see [`Decoder::decode_entry`]). While an entry of a group is being read the cursor
+//! stays on that group's header, and it only moves past the group once its last entry is decoded.
+//! Seeking unpacks a whole group at a time with [`PackedDocIdsOnly::decode_group`].
+
+use std::io::{Cursor, Seek, Write};
+
+use rqe_core::DocId;
+
+use crate::{Decoder, DocIdsDecoder, Encoder, IndexBlock, TermDecoder};
+use index_result::RSIndexResult;
+
+/// The number of entries in a full group.
+pub const GROUP_LEN: usize = 128;
+
+/// The size of a group header: the bit width followed by the number of entries.
+const HEADER_LEN: usize = 2;
+
+/// Encode and decode only the delta document ID of a record, bit-packing the deltas of
+/// [`GROUP_LEN`] consecutive records at the width of the largest one. See the
+/// [module documentation](self) for the layout.
+#[derive(Debug)]
+pub struct PackedDocIdsOnly;
+
+/// The number of bits needed to represent `value`.
+const fn bit_width(value: u32) -> u8 {
+    (u32::BITS - value.leading_zeros()) as u8
+}
+
+/// The number of bytes needed to pack `len` values of `width` bits each.
+const fn packed_len(width: u8, len: usize) -> usize {
+    (len * width as usize).div_ceil(8)
+}
+
+fn unexpected_eof() -> std::io::Error {
+    std::io::Error::new(
+        std::io::ErrorKind::UnexpectedEof,
+        "packed doc ids group is truncated",
+    )
+}
+
+/// A group header read from a block buffer, together with the group's packed payload.
+struct Group<'a> {
+    width: u8,
+    len: usize,
+    data: &'a [u8],
+}
+
+impl<'a> Group<'a> {
+    /// Read the group starting at `start` in `buf`.
+    #[inline(always)]
+    fn read(buf: &'a [u8], start: usize) -> std::io::Result<Self> {
+        let header = buf
+            .get(start..start + HEADER_LEN)
+            .ok_or_else(unexpected_eof)?;
+        let (width, len) = (header[0], header[1] as usize);
+        if width > u32::BITS as u8 || len == 0 || len > GROUP_LEN {
+            return Err(std::io::Error::new(
+                std::io::ErrorKind::InvalidData,
+                "invalid packed doc ids group header",
+            ));
+        }
+        let data_start = start + HEADER_LEN;
+        let data = buf
+            .get(data_start..data_start + packed_len(width, len))
+            .ok_or_else(unexpected_eof)?;
+
+        Ok(Self { width, len, data })
+    }
+
+    /// The offset just past this group, given the offset it starts at.
+    const fn end(&self, start: usize) -> usize {
+        start + HEADER_LEN + self.data.len()
+    }
+
+    /// The offset of the group header this cursor should be left on after reading entry `idx`.
+    const fn next_position(&self, start: usize, idx: usize) -> usize {
+        if idx + 1 == self.len {
+            self.end(start)
+        } else {
+            start
+        }
+    }
+}
+
+/// Read the `idx`-th `width`-bit value from `data`.
+#[inline(always)]
+fn extract(data: &[u8], idx: usize, width: u8) -> u32 {
+    if width == 0 {
+        return 0;
+    }
+    let bit = idx * width as usize;
+    let byte = bit / 8;
+    // A value is at most 32 bits wide and starts at most 7 bits into its first byte, so it is
+    // fully contained in the 8 bytes starting at `byte`.
+    let mut word = [0u8; 8];
+    let available = (data.len() - byte).min(word.len());
+    word[..available].copy_from_slice(&data[byte..byte + available]);
+    let word = u64::from_le_bytes(word) >> (bit % 8);
+
+    (word & ((1u64 << width) - 1)) as u32
+}
+
+/// OR `value` into the `idx`-th `width`-bit slot of `data`. The slot must be zeroed.
+fn deposit(data: &mut [u8], idx: usize, width: u8, value: u32) {
+    let bit = idx * width as usize;
+    let mut value = (value as u64) << (bit % 8);
+    for byte in &mut data[bit / 8..] {
+        if value == 0 {
+            break;
+        }
+        *byte |= value as u8;
+        value >>= 8;
+    }
+}
+
+/// Unpack the first `len` values of a group into `out`, reading every value at the same width.
+///
+/// `WIDTH` is a compile-time constant so that the shifts and masks below are constants, which
+/// lets the compiler turn the loop into SIMD shuffles and shifts for each width.
+#[inline(always)]
+fn unpack_fixed<const WIDTH: u8>(data: &[u8], len: usize, out: &mut [u32; GROUP_LEN]) {
+    let full = if WIDTH == 0 {
+        len
+    } else {
+        // Entries whose 8-byte window fits in `data` can be read without bounds juggling.
+        (data.len().saturating_sub(7) * 8 / WIDTH as usize).min(len)
+    };
+    for (idx, slot) in out.iter_mut().enumerate().take(full) {
+        if WIDTH == 0 {
+            *slot = 0;
+            continue;
+        }
+        let bit = idx * WIDTH as usize;
+        let byte = bit / 8;
+        let word = u64::from_le_bytes(
+            data[byte..byte + 8]
+                .try_into()
+                .expect("the window is in bounds"),
+        );
+        *slot = ((word >> (bit % 8)) & ((1u64 << WIDTH) - 1)) as u32;
+    }
+    for (idx, slot) in out.iter_mut().enumerate().take(len).skip(full) {
+        *slot = extract(data, idx, WIDTH);
+    }
+}
+
+/// Dispatch [`unpack_fixed`] to the monomorphized kernel for `width`.
+#[inline(always)]
+fn unpack(data: &[u8], width: u8, len: usize, out: &mut [u32; GROUP_LEN]) {
+    macro_rules! dispatch {
+        ($($w:literal)*) => {
+            match width {
+                $($w => unpack_fixed::<$w>(data, len, out),)*
+                _ => unreachable!("group widths are validated when reading the header"),
+            }
+        };
+    }
+    dispatch!(0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32)
+}
+
+#[cfg(target_arch = "x86_64")]
+mod x86 {
+    use super::{GROUP_LEN, unpack};
+
+    /// [`unpack`] compiled with AVX2 enabled, so the per-width kernels use 256-bit vectors.
+    ///
+    /// # Safety
+    ///
+    /// The CPU must support AVX2.
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn unpack_avx2(
+        data: &[u8],
+        width: u8,
+        len: usize,
+        out: &mut [u32; GROUP_LEN],
+    ) {
+        unpack(data, width, len, out)
+    }
+}
+
+/// Unpack a group into `out`, using the widest vector instructions the CPU supports.
+fn unpack_group(data: &[u8], width: u8, len: usize, out: &mut [u32; GROUP_LEN]) {
+    #[cfg(target_arch = "x86_64")]
+    if std::arch::is_x86_feature_detected!("avx2") {
+        // SAFETY: we just checked that the CPU supports AVX2.
+        return unsafe { x86::unpack_avx2(data, width, len, out) };
+    }
+    unpack(data, width, len, out)
+}
+
+impl PackedDocIdsOnly {
+    /// Decode the whole group starting at the cursor position into `out`, turning the deltas into
+    /// document IDs relative to `base`. Returns the number of entries written to `out` and leaves
+    /// the cursor on the next group.
+    ///
+    /// This is the fast path for readers consuming a block in bulk: a whole group is unpacked at
+    /// once instead of one entry per call.
+    pub fn decode_group(
+        cursor: &mut Cursor<&[u8]>,
+        base: DocId,
+        out: &mut [DocId; GROUP_LEN],
+    ) -> std::io::Result<usize> {
+        let start = cursor.position() as usize;
+        let group = Group::read(cursor.get_ref(), start)?;
+        let mut deltas = [0u32; GROUP_LEN];
+        unpack_group(group.data, group.width, group.len, &mut deltas);
+
+        let mut doc_id = base;
+        for (delta, out) in deltas[..group.len].iter().zip(out.iter_mut()) {
+            doc_id += *delta as DocId;
+            *out = doc_id;
+        }
+        cursor.set_position(group.end(start) as u64);
+
+        Ok(group.len)
+    }
+
+    /// Find the offset of the group the next entry must be added to, or `None` if the block has no
+    /// partially filled group.
+    fn open_group(buffer: &[u8], num_entries: u16) -> std::io::Result<Option<usize>> {
+        let num_entries = num_entries as usize;
+        if num_entries.is_multiple_of(GROUP_LEN) {
+            return Ok(None);
+        }
+        let mut start = 0;
+        for _ in 0..num_entries / GROUP_LEN {
+            start = Group::read(buffer, start)?.end(start);
+        }
+        Ok(Some(start))
+    }
+}
+
+impl Encoder for PackedDocIdsOnly {
+    type Delta = u32;
+    const RECOMMENDED_BLOCK_ENTRIES: u16 = 8 * GROUP_LEN as u16;
+
+    /// Write the record as a group of its own.
+    ///
+    /// The inverted index goes through [`Encoder::encode_into`] instead, which adds the record to
+    /// the open group of the block.
+    fn encode<W: Write + Seek>(
+        mut writer: W,
+        delta: Self::Delta,
+        _record: &RSIndexResult,
+    ) -> std::io::Result<usize> {
+        let width = bit_width(delta);
+        let mut group = [0u8; HEADER_LEN + 4];
+        group[0] = width;
+        group[1] = 1;
+        deposit(&mut group[HEADER_LEN..], 0, width, delta);
+
+        let len = HEADER_LEN + packed_len(width, 1);
+        writer.write_all(&group[..len])?;
+        Ok(len)
+    }
+
+    fn encode_into(
+        block: &mut IndexBlock,
+        delta: Self::Delta,
+        record: &RSIndexResult,
+    ) -> std::io::Result<usize> {
+        let Some(start) = Self::open_group(&block.buffer, block.num_entries)? else {
+            return Self::encode(block.writer(), delta, record);
+        };
+
+        let old_len = block.buffer.len();
+        let group = Group::read(&block.buffer, start)?;
+        let (width, len) = (group.width, group.len);
+
+        if bit_width(delta) <= width {
+            // The delta fits at the current width: grow the payload if the new slot spills into
+            // a new byte and fill the slot in place.
+            let grow_by = packed_len(width, len + 1) - packed_len(width, len);
+            block.writer().write_all(&[0u8; 4][..grow_by])?;
+            deposit(&mut block.buffer[start + HEADER_LEN..], len, width, delta);
+            block.buffer[start + 1] = (len + 1) as u8;
+        } else {
+            // The delta needs more bits than the rest of the group: re-pack the whole group at
+            // the new width. Widths only grow, so this happens at most 32 times per group.
+            let mut deltas = [0u32; GROUP_LEN];
+            unpack_group(group.data, width, len, &mut deltas);
+            deltas[len] = delta;
+
+            let width = bit_width(delta);
+            let mut packed = [0u8; HEADER_LEN + 4 * GROUP_LEN];
+            packed[0] = width;
+            packed[1] = (len + 1) as u8;
+            for (idx, delta) in deltas[..=len].iter().enumerate() {
+                deposit(&mut packed[HEADER_LEN..], idx, width, *delta);
+            }
+
+            block.buffer.truncate(start);
+            block
+                .writer()
+                .write_all(&packed[..HEADER_LEN + packed_len(width, len + 1)])?;
+        }
+
+        Ok(block.buffer.len() - old_len)
+    }
+}
+
+impl Decoder for PackedDocIdsOnly {
+    /// Decode the first entry of the group at the cursor position.
+    ///
+    /// The inverted index reader goes through [`Decoder::decode_entry`] instead, which can
+    /// address every entry of a group.
+    #[inline(always)]
+    fn decode<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<()> {
+        Self::decode_entry(cursor, base, 0, result)
+    }
+
+    #[inline(always)]
+    fn decode_entry<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        ordinal: u16,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<()> {
+        let start = cursor.position() as usize;
+        let group = Group::read(cursor.get_ref(), start)?;
+        let idx = ordinal as usize % GROUP_LEN;
+        if idx >= group.len {
+            return Err(unexpected_eof());
+        }
+
+        result.doc_id = base + extract(group.data, idx, group.width) as DocId;
+        cursor.set_position(group.next_position(start, idx) as u64);
+        Ok(())
+    }
+
+    fn seek<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        base: DocId,
+        target: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<Option<u16>> {
+        Self::seek_entry(cursor, base, 0, target, result)
+    }
+
+    fn seek_entry<'index>(
+        cursor: &mut Cursor<&'index [u8]>,
+        mut base: DocId,
+        ordinal: u16,
+        target: DocId,
+        result: &mut RSIndexResult<'index>,
+    ) -> std::io::Result<Option<u16>> {
+        let buf = *cursor.get_ref();
+        let mut idx = ordinal as usize % GROUP_LEN;
+        let mut skipped: u16 = 0;
+        let mut deltas = [0u32; GROUP_LEN];
+
+        loop {
+            let start = cursor.position() as usize;
+            if start >= buf.len() {
+                return Ok(None);
+            }
+            let group = Group::read(buf, start)?;
+            if idx >= group.len {
+                return Err(unexpected_eof());
+            }
+            unpack_group(group.data, group.width, group.len, &mut deltas);
+            let remaining = &deltas[idx..group.len];
+
+            // Skip the rest of the group in one go if even its last document is below the target.
+            let group_last = base + remaining.iter().map(|d| *d as DocId).sum::<DocId>();
+            if group_last < target {
+                skipped += remaining.len() as u16;
+                base = group_last;
+                cursor.set_position(group.end(start) as u64);
+                idx = 0;
+                continue;
+            }
+
+            for (offset, delta) in remaining.iter().enumerate() {
+                base += *delta as DocId;
+                if base >= target {
+                    result.doc_id = base;
+                    cursor.set_position(group.next_position(start, idx + offset) as u64);
+                    return Ok(Some(skipped));
+                }
+                skipped += 1;
+            }
+            unreachable!("the group's last document is at or past the target");
+        }
+    }
+
+    fn base_result<'index>() -> RSIndexResult<'index> {
+        RSIndexResult::build_term().build()
+    }
+}
+
+impl TermDecoder for PackedDocIdsOnly {}
+impl DocIdsDecoder for PackedDocIdsOnly {
+    fn decode_block_doc_ids(block: &IndexBlock, out: &mut Vec<DocId>) -> std::io::Result<()> {
+        let mut cursor = Cursor::new(block.buffer.as_slice());
+        let mut group = [0; GROUP_LEN];
+        let mut base = block.first_doc_id;
+        let mut remaining = block.num_entries as usize;
+
+        out.reserve(remaining);
+        while remaining > 0 {
+            let len = Self::decode_group(&mut cursor, base, &mut group)?;
+            if len == 0 {
+                return Err(unexpected_eof());
+            }
+            out.extend_from_slice(&group[..len]);
+            base = group[len - 1];
+            remaining = remaining.saturating_sub(len);
+        }
+
+        Ok(())
+    }
+}
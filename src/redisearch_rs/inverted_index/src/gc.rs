@@ -8,7 +8,7 @@
 */
 
 use serde::{Deserialize, Serialize};
-use std::marker::PhantomData;
+use std::{marker::PhantomData, ops::Range};
 
 use crate::{BlockCapacity, DecodedBy, Decoder, Encoder, IndexBlock, InvertedIndex};
 use ffi::IndexFlags_Index_DocIdsOnly;
@@ -50,6 +50,13 @@ pub(crate) enum RepairType {
         /// How many unique documents were removed from the block being replaced.
         n_unique_docs_removed: u32,
     },
+
+    /// The surviving entries of this block were merged into the `Replace` blocks of a preceding
+    /// block, so this block can be deleted.
+    Merged {
+        /// Number of unique records the scan removed from this block
+        n_unique_docs_removed: u32,
+    },
 }
 
 /// Result of scanning the index for garbage collection
@@ -122,6 +129,9 @@ pub struct GcApplyInfo {
     /// Callers maintaining per-spec totals should add this signed value to their counter.
     pub block_count_delta: i64,
 
+    /// The number of sparse blocks whose entries were merged into a neighbouring block.
+    pub blocks_merged: usize,
+
     /// Whether or not we ignored the last block in the index, since it changed
     /// compared to the time we performed the scan
     pub ignored_last_block: bool,
@@ -160,7 +170,7 @@ impl IndexBlock {
 
         while self.buffer.len() as u64 > cursor.position() {
             let base = D::base_id(self, last_read_doc_id.unwrap_or(self.first_doc_id));
-            D::decode(&mut cursor, base, &mut result)?;
+            D::decode_entry(&mut cursor, base, ordinal, &mut result)?;
             result.has_field_expiration = self.expiration_bit(ordinal);
             ordinal += 1;
 
@@ -194,14 +204,44 @@ impl IndexBlock {
                 n_unique_docs_removed: unique_read,
             }))
         } else if block_changed {
+            // The survivors are a subset of this block's entries, so its score bounds still hold
+            // for them. Keeping them also preserves document lengths the encoding does not store.
+            let blocks = tmp_inverted_index.blocks.into_iter().map(|mut block| {
+                block.max_freq = self.max_freq;
+                block.min_doc_len = self.min_doc_len;
+                block
+            });
             Ok(Some(RepairType::Replace {
-                blocks: SmallVec::from_iter(tmp_inverted_index.blocks),
+                blocks: SmallVec::from_iter(blocks),
                 n_unique_docs_removed: unique_read - unique_write,
             }))
         } else {
             Ok(None)
         }
     }
+
+    /// Decode all the entries of this block and add them to `target`.
+    fn reencode_into<E: Encoder + DecodedBy<Decoder = D>, D: Decoder>(
+        &self,
+        target: &mut InvertedIndex<E>,
+    ) -> std::io::Result<()> {
+        let mut cursor: std::io::Cursor<&[u8]> = std::io::Cursor::new(&self.buffer);
+        let mut last_read_doc_id = None;
+        let mut result = D::base_result();
+        let mut ordinal: u16 = 0;
+
+        while self.buffer.len() as u64 > cursor.position() {
+            let base = D::base_id(self, last_read_doc_id.unwrap_or(self.first_doc_id));
+            D::decode_entry(&mut cursor, base, ordinal, &mut result)?;
+            result.has_field_expiration = self.expiration_bit(ordinal);
+            ordinal += 1;
+
+            target.add_record(&result)?;
+            last_read_doc_id = Some(result.doc_id);
+        }
+
+        Ok(())
+    }
 }
 
 impl<E: Encoder + DecodedBy> InvertedIndex<E> {
@@ -245,6 +285,141 @@ impl<E: Encoder + DecodedBy> InvertedIndex<E> {
         }
     }
 
+    /// Extend the result of [`Self::scan_gc`] so that runs of adjacent sparse blocks, holding
+    /// at most half of [`Encoder::RECOMMENDED_BLOCK_ENTRIES`] entries once repaired, are
+    /// re-encoded densely into as few blocks as possible. The first block of a run is replaced
+    /// by the merged blocks, and the others are marked as [`RepairType::Merged`].
+    ///
+    /// The last block is never merged, since it may be written to before the delta is applied.
+    /// Returns a delta if GC is needed, or `None` if no GC is needed.
+    pub fn coalesce_gc(&self, delta: Option<GcScanDelta>) -> std::io::Result<Option<GcScanDelta>> {
+        let Some(last_block_idx) = self.blocks.len().checked_sub(1) else {
+            return Ok(delta);
+        };
+
+        // The repair of each block but the last, by block index
+        let mut repairs: Vec<Option<RepairType>> = std::iter::repeat_with(|| None)
+            .take(last_block_idx)
+            .collect();
+        let mut last_block_delta = None;
+        for delta in delta.map(|d| d.deltas).unwrap_or_default() {
+            if delta.index < last_block_idx {
+                repairs[delta.index] = Some(delta.repair);
+            } else {
+                last_block_delta = Some(delta);
+            }
+        }
+
+        let mut start = 0;
+        while start < last_block_idx {
+            if !self.is_sparse_after_gc(start, &repairs[start]) {
+                start += 1;
+                continue;
+            }
+            let mut end = start + 1;
+            while end < last_block_idx && self.is_sparse_after_gc(end, &repairs[end]) {
+                end += 1;
+            }
+
+            if let Some(blocks) = self.merge_blocks_after_gc(start..end, &repairs)? {
+                let mut blocks = Some(blocks);
+                for repair in &mut repairs[start..end] {
+                    let n_unique_docs_removed = match repair {
+                        None => 0,
+                        // Deleted blocks have nothing to merge
+                        Some(RepairType::Delete { .. }) => continue,
+                        Some(
+                            RepairType::Replace {
+                                n_unique_docs_removed,
+                                ..
+                            }
+                            | RepairType::Merged {
+                                n_unique_docs_removed,
+                            },
+                        ) => *n_unique_docs_removed,
+                    };
+                    *repair = Some(match blocks.take() {
+                        Some(blocks) => RepairType::Replace {
+                            blocks,
+                            n_unique_docs_removed,
+                        },
+                        None => RepairType::Merged {
+                            n_unique_docs_removed,
+                        },
+                    });
+                }
+            }
+            start = end;
+        }
+
+        let deltas: Vec<_> = repairs
+            .into_iter()
+            .enumerate()
+            .filter_map(|(index, repair)| repair.map(|repair| BlockGcScanResult { index, repair }))
+            .chain(last_block_delta)
+            .collect();
+
+        if deltas.is_empty() {
+            Ok(None)
+        } else {
+            Ok(Some(GcScanDelta {
+                last_block_idx,
+                last_block_num_entries: self.blocks[last_block_idx].num_entries,
+                deltas,
+            }))
+        }
+    }
+
+    /// The blocks the block at `index` is left with once `repair` is applied.
+    fn blocks_after_gc<'a>(&'a self, index: usize, repair: &'a Option<RepairType>) -> &'a [IndexBlock] {
+        match repair {
+            None => std::slice::from_ref(&self.blocks[index]),
+            Some(RepairType::Replace { blocks, .. }) => blocks,
+            Some(RepairType::Delete { .. } | RepairType::Merged { .. }) => &[],
+        }
+    }
+
+    fn is_sparse_after_gc(&self, index: usize, repair: &Option<RepairType>) -> bool {
+        self.blocks_after_gc(index, repair)
+            .iter()
+            .all(|block| block.num_entries <= E::RECOMMENDED_BLOCK_ENTRIES / 2)
+    }
+
+    /// Re-encode the blocks left by `repairs` in the `run` of block indexes into new blocks.
+    /// Returns `None` when that would not lower the number of blocks.
+    fn merge_blocks_after_gc(
+        &self,
+        run: Range<usize>,
+        repairs: &[Option<RepairType>],
+    ) -> std::io::Result<Option<SmallVec<[IndexBlock; 3]>>> {
+        let sources = run.flat_map(|index| self.blocks_after_gc(index, &repairs[index]));
+        let num_sources = sources.clone().count();
+        if num_sources < 2 {
+            return Ok(None);
+        }
+
+        let mut merged = InvertedIndex::<E>::new(IndexFlags_Index_DocIdsOnly);
+        let mut max_freq = 0;
+        let mut min_doc_len = u32::MAX;
+        for block in sources {
+            block.reencode_into(&mut merged)?;
+            max_freq = max_freq.max(block.max_freq);
+            min_doc_len = min_doc_len.min(block.min_doc_len);
+        }
+
+        if merged.blocks.len() >= num_sources {
+            return Ok(None);
+        }
+        // The merged entries keep the widest score bounds of the blocks they come from
+        let blocks = merged.blocks.into_iter().map(|mut block| {
+            block.seal();
+            block.max_freq = max_freq;
+            block.min_doc_len = min_doc_len;
+            block
+        });
+        Ok(Some(SmallVec::from_iter(blocks)))
+    }
+
     /// Apply the deltas of a garbage collection scan to the index. This will modify the index
     /// by deleting or repairing blocks as needed.
     pub fn apply_gc(&mut self, delta: GcScanDelta) -> GcApplyInfo {
@@ -259,6 +434,7 @@ impl<E: Encoder + DecodedBy> InvertedIndex<E> {
             bytes_allocated: 0,
             entries_removed: 0,
             block_count_delta: 0,
+            blocks_merged: 0,
             ignored_last_block: false,
         };
 
@@ -291,6 +467,9 @@ impl<E: Encoder + DecodedBy> InvertedIndex<E> {
         std::mem::swap(&mut self.blocks, &mut tmp_blocks);
 
         let mut deltas = deltas.into_iter().peekable();
+        // The entries of the replacement blocks. Those may include the entries of the following
+        // merged blocks, so they are only subtracted once every block is counted.
+        let mut entries_added = 0;
 
         for (block_index, block) in tmp_blocks.into_iter().enumerate() {
             match deltas.peek() {
@@ -310,6 +489,15 @@ impl<E: Encoder + DecodedBy> InvertedIndex<E> {
                             info.bytes_freed += block.mem_usage();
                             self.n_unique_docs -= n_unique_docs_removed;
                         }
+                        RepairType::Merged {
+                            n_unique_docs_removed,
+                        } => {
+                            // The entries are added back by the blocks replacing a preceding block
+                            info.entries_removed += block.num_entries as usize;
+                            info.bytes_freed += block.mem_usage();
+                            info.blocks_merged += 1;
+                            self.n_unique_docs -= n_unique_docs_removed;
+                        }
                         RepairType::Replace {
                             blocks,
                             n_unique_docs_removed,
@@ -319,7 +507,7 @@ impl<E: Encoder + DecodedBy> InvertedIndex<E> {
                             self.n_unique_docs -= n_unique_docs_removed;
 
                             for block in blocks {
-                                info.entries_removed -= block.num_entries as usize;
+                                entries_added += block.num_entries as usize;
                                 info.bytes_allocated += block.mem_usage();
                                 self.blocks.push(block);
                             }
@@ -333,6 +521,8 @@ impl<E: Encoder + DecodedBy> InvertedIndex<E> {
             }
         }
 
+        info.entries_removed -= entries_added;
+
         // Remove excess capacity from the blocks vector.
         {
             let had_allocated = self.blocks.has_allocated();
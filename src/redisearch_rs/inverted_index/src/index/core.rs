@@ -65,13 +65,17 @@ pub struct AddRecordOutcome {
     pub mem_growth: u32,
     /// Number of new index blocks this write created.
     pub blocks_added: u32,
+    /// Number of bytes released by sealing the block this write moved on from, see
+    /// [`IndexBlock::seal`]. To be subtracted from the index's memory usage along with
+    /// adding [`Self::mem_growth`].
+    pub mem_released: u32,
 }
 
 /// Each `IndexBlock` contains a set of entries for a specific range of document IDs. The entries
 /// are ordered by document ID, so the first entry in the block has the lowest document ID, and the
 /// last entry has the highest document ID. The block also contains a buffer that is used to
 /// store the encoded entries. The buffer is dynamically resized as needed when new entries are
-/// added to the block.
+/// added to the block, and is trimmed to its exact size once the index moves on to a new block.
 #[derive(Debug, Eq, PartialEq, Serialize, Deserialize)]
 pub struct IndexBlock {
     /// The first document ID in this block. This is used to determine the range of document IDs
@@ -91,6 +95,59 @@ pub struct IndexBlock {
     /// The entries in this block that belong to a field with a field-level expiration, see
     /// [`ExpirationBits`]. Empty — and unallocated — while no entry in the block does.
     pub(crate) expiration_bits: ExpirationBits,
+
+    /// The highest term frequency written to this block. Saturates at `u16::MAX`, which stands
+    /// for any frequency. Together with [`Self::min_doc_len`] this bounds the score any entry of
+    /// the block can contribute, letting top-k queries skip blocks without decoding them.
+    #[serde(default)]
+    pub(crate) max_freq: u16,
+
+    /// The shortest length of a document written to this block, or 0 when some entry was
+    /// written without one.
+    #[serde(default)]
+    pub(crate) min_doc_len: u32,
+}
+
+/// Upper bounds on the score contribution of a run of postings, as tracked by
+/// [`IndexBlock`]: either a single block or, merged together, a whole index.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct ScoreBounds {
+    /// The last document ID the bounds cover.
+    pub last_doc_id: DocId,
+    /// The highest term frequency of any covered entry, `u32::MAX` when unbounded.
+    pub max_freq: u32,
+    /// The shortest length of any covered document, 0 when unknown.
+    pub min_doc_len: u32,
+}
+
+impl ScoreBounds {
+    /// Bounds which hold for any entry, for postings whose bounds are not known.
+    pub const UNBOUNDED: Self = Self {
+        last_doc_id: DocId::MAX,
+        max_freq: u32::MAX,
+        min_doc_len: 0,
+    };
+
+    /// Widen these bounds so they also cover `other`.
+    pub const fn merge(self, other: Self) -> Self {
+        Self {
+            last_doc_id: if self.last_doc_id > other.last_doc_id {
+                self.last_doc_id
+            } else {
+                other.last_doc_id
+            },
+            max_freq: if self.max_freq > other.max_freq {
+                self.max_freq
+            } else {
+                other.max_freq
+            },
+            min_doc_len: if self.min_doc_len < other.min_doc_len {
+                self.min_doc_len
+            } else {
+                other.min_doc_len
+            },
+        }
+    }
 }
 
 impl IndexBlock {
@@ -105,6 +162,8 @@ impl IndexBlock {
             num_entries: 0,
             buffer: Vec::new(),
             expiration_bits: ExpirationBits::new(),
+            max_freq: 0,
+            min_doc_len: u32::MAX,
         }
     }
 
@@ -150,6 +209,43 @@ impl IndexBlock {
         &self.buffer
     }
 
+    /// Get the score bounds of the entries in this block.
+    pub const fn score_bounds(&self) -> ScoreBounds {
+        ScoreBounds {
+            last_doc_id: self.last_doc_id,
+            max_freq: if self.max_freq == u16::MAX {
+                u32::MAX
+            } else {
+                self.max_freq as u32
+            },
+            min_doc_len: self.min_doc_len,
+        }
+    }
+
+    /// Widen the score bounds of this block to cover an entry with the given frequency and
+    /// document length.
+    const fn track_score_bounds(&mut self, freq: u32, doc_len: u32) {
+        let freq = if freq >= u16::MAX as u32 {
+            u16::MAX
+        } else {
+            freq as u16
+        };
+        if freq > self.max_freq {
+            self.max_freq = freq;
+        }
+        if doc_len < self.min_doc_len {
+            self.min_doc_len = doc_len;
+        }
+    }
+
+    /// Seal this block once no more entries will be written to it, releasing the spare
+    /// capacity its buffer grew with. Returns the number of bytes released.
+    pub(crate) fn seal(&mut self) -> usize {
+        let cap = self.buffer.capacity();
+        self.buffer.shrink_to_fit();
+        cap - self.buffer.capacity()
+    }
+
     pub(crate) const fn writer(&mut self) -> ControlledCursor<'_> {
         ControlledCursor::new(&mut self.buffer)
     }
@@ -215,31 +311,46 @@ impl<E: Encoder> InvertedIndex<E> {
     /// the index's memory usage grew by and how many new index blocks the write created (0 in
     /// the common case, up to 2 when a new block was needed for the encoded delta and/or the
     /// previous block was full). Callers that maintain a per-spec block counter should add
-    /// `outcome.blocks_added` to it.
+    /// `outcome.blocks_added` to it. When a new block is started, the previous one is sealed and
+    /// `outcome.mem_released` reports the bytes it gave back.
     ///
     /// It is expected that the document ID of the record is greater than or equal to the last
     /// document ID in the index.
     pub fn add_record(&mut self, record: &RSIndexResult) -> std::io::Result<AddRecordOutcome> {
+        self.add_record_with_doc_len(record, 0)
+    }
+
+    /// Add a new record to the index, like [`Self::add_record`], also recording the length of
+    /// the document it belongs to so the block's [`ScoreBounds`] can account for it. A length
+    /// of 0 means unknown.
+    pub fn add_record_with_doc_len(
+        &mut self,
+        record: &RSIndexResult,
+        doc_len: u32,
+    ) -> std::io::Result<AddRecordOutcome> {
         self.add_entry(
             record.doc_id,
             record.has_field_expiration,
-            |writer, delta| E::encode(writer, delta, record),
+            (record.freq, doc_len),
+            |block, delta| E::encode_into(block, delta, record),
         )
     }
 
     /// Add an entry for `doc_id`, letting `encode` write the payload.
     ///
     /// Everything an add does apart from writing the payload depends only on the
-    /// document ID and field-expiration bit, so callers holding something other than
-    /// an [`RSIndexResult`] — see [`Self::add_prepared_record`] — reuse all of it.
+    /// document ID, field-expiration bit and the `(freq, doc_len)` pair feeding the
+    /// block's [`ScoreBounds`], so callers holding something other than an
+    /// [`RSIndexResult`] — see [`Self::add_prepared_record`] — reuse all of it.
     fn add_entry<F>(
         &mut self,
         doc_id: DocId,
         has_field_expiration: bool,
+        (freq, doc_len): (u32, u32),
         encode: F,
     ) -> std::io::Result<AddRecordOutcome>
     where
-        F: FnOnce(ControlledCursor<'_>, E::Delta) -> std::io::Result<usize>,
+        F: FnOnce(&mut IndexBlock, E::Delta) -> std::io::Result<usize>,
     {
         let same_doc = match (
             E::ALLOW_DUPLICATES,
@@ -259,7 +370,7 @@ impl<E: Encoder> InvertedIndex<E> {
 
         // We take ownership of the block since we are going to keep using self. So we can't have a
         // mutable reference to the block we are working with at the same time.
-        let mut block = self.take_block(doc_id, same_doc);
+        let (mut block, mut mem_released) = self.take_block(doc_id, same_doc);
         let mut mem_growth = 0;
 
         let delta_base = E::delta_base(&block);
@@ -276,7 +387,8 @@ impl<E: Encoder> InvertedIndex<E> {
                 // Since the new block is empty, we'll start with `delta` equal to 0.
                 let new_block = IndexBlock::new(doc_id);
 
-                // We won't use the block so make sure to put it back
+                // We won't use the block anymore so seal it and make sure to put it back
+                mem_released += block.seal();
                 mem_growth += self.add_block(block);
                 block = new_block;
 
@@ -285,8 +397,7 @@ impl<E: Encoder> InvertedIndex<E> {
         };
 
         let buf_cap = block.buffer.capacity();
-        let writer = block.writer();
-        let _bytes_written = encode(writer, delta)?;
+        let _bytes_written = encode(&mut block, delta)?;
 
         // We don't use `_bytes_written` returned by the encoder to determine by how much memory
         // grew because the buffer might have had enough capacity for the bytes in the encoding.
@@ -307,6 +418,7 @@ impl<E: Encoder> InvertedIndex<E> {
         debug_assert!(block.num_entries.saturating_add(1) < u16::MAX);
         block.num_entries += 1;
         block.last_doc_id = doc_id;
+        block.track_score_bounds(freq, doc_len);
 
         // We took ownership of the block so put it back
         mem_growth += self.add_block(block);
@@ -327,6 +439,8 @@ impl<E: Encoder> InvertedIndex<E> {
         Ok(AddRecordOutcome {
             mem_growth: total_mem_growth as u32,
             blocks_added: (self.blocks.len() - blocks_before) as u32,
+            // A sealed block gives back at most a fraction of its buffer.
+            mem_released: mem_released as u32,
         })
     }
 
@@ -335,25 +449,21 @@ impl<E: Encoder> InvertedIndex<E> {
         self.blocks.last().map(|b| b.last_doc_id)
     }
 
-    /// Take a block that can be written to.
-    fn take_block(&mut self, doc_id: DocId, same_doc: bool) -> IndexBlock {
-        if self.blocks.is_empty()
-            || (
-                // If the block is full
-                !same_doc
-                    && self
-                        .blocks
-                        .last()
-                        .expect("we just confirmed there are blocks")
-                        .num_entries
-                        >= E::RECOMMENDED_BLOCK_ENTRIES
-            )
-        {
-            IndexBlock::new(doc_id)
-        } else {
-            self.blocks
-                .pop()
-                .expect("to get the last block since we know there is one")
+    /// Take a block that can be written to. When the last block is full, it is sealed and a new
+    /// block is returned, along with the number of bytes sealing released.
+    fn take_block(&mut self, doc_id: DocId, same_doc: bool) -> (IndexBlock, usize) {
+        match self.blocks.last_mut() {
+            None => (IndexBlock::new(doc_id), 0),
+            // If the block is full
+            Some(last) if !same_doc && E::is_block_full(last, doc_id) => {
+                (IndexBlock::new(doc_id), last.seal())
+            }
+            Some(_) => (
+                self.blocks
+                    .pop()
+                    .expect("to get the last block since we know there is one"),
+                0,
+            ),
         }
     }
 
@@ -422,6 +532,14 @@ impl<E: Encoder> InvertedIndex<E> {
         self.blocks.len()
     }
 
+    /// Get the score bounds covering every entry of the index, or `None` when it is empty.
+    pub fn score_bounds(&self) -> Option<ScoreBounds> {
+        self.blocks
+            .iter()
+            .map(IndexBlock::score_bounds)
+            .reduce(ScoreBounds::merge)
+    }
+
     /// Get a reference to the block at the given index, if it exists. This is only used by some C tests.
     pub fn block_ref(&self, index: usize) -> Option<&IndexBlock> {
         self.blocks.get(index)
@@ -459,8 +577,9 @@ impl<E: NumericEncoder> InvertedIndex<E> {
         prepared: PreparedValue,
         has_field_expiration: bool,
     ) -> std::io::Result<AddRecordOutcome> {
-        self.add_entry(doc_id, has_field_expiration, |writer, delta| {
-            E::encode_prepared(writer, delta, prepared)
+        // A numeric record always carries a frequency of one.
+        self.add_entry(doc_id, has_field_expiration, (1, 0), |block, delta| {
+            E::encode_prepared(block.writer(), delta, prepared)
         })
     }
 }
@@ -16,6 +16,7 @@ use rqe_core::DocId;
 use crate::ii_dispatch;
 use crate::{
     EntriesTrackingIndex, FieldMaskTrackingIndex, InvertedIndex as InvertedIndexInner,
+    bitmap_doc_ids_only::BitmapDocIdsOnly,
     doc_ids_only::DocIdsOnly,
     fields_offsets::{FieldsOffsets, FieldsOffsetsWide},
     fields_only::{FieldsOnly, FieldsOnlyWide},
@@ -25,6 +26,7 @@ use crate::{
     full::{Full, FullWide},
     numeric::{Numeric, NumericFloatCompression},
     offsets_only::OffsetsOnly,
+    packed_doc_ids_only::PackedDocIdsOnly,
     raw_doc_ids_only::RawDocIdsOnly,
 };
 
@@ -98,6 +100,8 @@ impl_opaque_encoding!(OffsetsOnly, InvertedIndexInner<OffsetsOnly>);
 impl_opaque_encoding!(FreqsOffsets, InvertedIndexInner<FreqsOffsets>);
 impl_opaque_encoding!(DocIdsOnly, InvertedIndexInner<DocIdsOnly>);
 impl_opaque_encoding!(RawDocIdsOnly, InvertedIndexInner<RawDocIdsOnly>);
+impl_opaque_encoding!(PackedDocIdsOnly, InvertedIndexInner<PackedDocIdsOnly>);
+impl_opaque_encoding!(BitmapDocIdsOnly, InvertedIndexInner<BitmapDocIdsOnly>);
 impl_opaque_encoding!(Numeric, EntriesTrackingIndex<Numeric>);
 impl_opaque_encoding!(
     NumericFloatCompression,
@@ -130,25 +134,30 @@ pub enum InvertedIndex {
     FreqsOffsets(InvertedIndexInner<FreqsOffsets>),
     DocIdsOnly(InvertedIndexInner<DocIdsOnly>),
     RawDocIdsOnly(InvertedIndexInner<RawDocIdsOnly>),
+    PackedDocIdsOnly(InvertedIndexInner<PackedDocIdsOnly>),
+    BitmapDocIdsOnly(InvertedIndexInner<BitmapDocIdsOnly>),
     // Needs to track the entries count because it has the `StoreNumeric` flag set
     Numeric(EntriesTrackingIndex<Numeric>),
     NumericFloatCompression(EntriesTrackingIndex<NumericFloatCompression>),
 }
 
 impl InvertedIndex {
-    /// Scan the index for blocks that can be garbage collected.
+    /// Scan the index for blocks that can be garbage collected, and for sparse blocks which can
+    /// be merged once they are.
     ///
-    /// This is a dispatch wrapper around the typed [`InvertedIndex::scan_gc`].
+    /// This is a dispatch wrapper around the typed [`InvertedIndex::scan_gc`] and
+    /// [`InvertedIndex::coalesce_gc`].
     pub fn scan_gc(
         &self,
         doc_exist: impl Fn(DocId) -> bool,
     ) -> std::io::Result<Option<crate::GcScanDelta>> {
-        ii_dispatch!(
+        let delta = ii_dispatch!(
             self,
             scan_gc,
             doc_exist,
             None::<fn(&index_result::RSIndexResult, &crate::RepairContext<'_>)>
-        )
+        )?;
+        ii_dispatch!(self, coalesce_gc, delta)
     }
 
     /// Apply the deltas of a garbage collection scan to the index.
@@ -196,6 +205,8 @@ impl Debug for InvertedIndex {
             Self::FreqsOffsets(ii) => f.debug_tuple("FreqsOffsets").field(ii).finish(),
             Self::DocIdsOnly(ii) => f.debug_tuple("DocIdsOnly").field(ii).finish(),
             Self::RawDocIdsOnly(ii) => f.debug_tuple("RawDocIdsOnly").field(ii).finish(),
+            Self::PackedDocIdsOnly(ii) => f.debug_tuple("PackedDocIdsOnly").field(ii).finish(),
+            Self::BitmapDocIdsOnly(ii) => f.debug_tuple("BitmapDocIdsOnly").field(ii).finish(),
             Self::Numeric(ii) => f.debug_tuple("Numeric").field(ii).finish(),
             Self::NumericFloatCompression(ii) => {
                 f.debug_tuple("NumericFloatCompression").field(ii).finish()
@@ -229,6 +240,8 @@ macro_rules! ii_dispatch {
             $crate::opaque::InvertedIndex::FreqsOffsets(ii) => ii.$method($($args),*),
             $crate::opaque::InvertedIndex::DocIdsOnly(ii) => ii.$method($($args),*),
             $crate::opaque::InvertedIndex::RawDocIdsOnly(ii) => ii.$method($($args),*),
+            $crate::opaque::InvertedIndex::PackedDocIdsOnly(ii) => ii.$method($($args),*),
+            $crate::opaque::InvertedIndex::BitmapDocIdsOnly(ii) => ii.$method($($args),*),
             $crate::opaque::InvertedIndex::Numeric(ii) => ii.$method($($args),*),
             $crate::opaque::InvertedIndex::NumericFloatCompression(ii) => ii.$method($($args),*),
         }
@@ -9,6 +9,7 @@
 
 use crate::{
     AddRecordOutcome, DecodedBy, Encoder, GcApplyInfo, GcScanDelta, IndexBlock, InvertedIndex,
+    ScoreBounds,
     debug::{BlockSummary, Summary},
     numeric::{NumericEncoder, PreparedValue},
     reader::IndexReaderCore,
@@ -43,13 +44,28 @@ impl<E: Encoder> EntriesTrackingIndex<E> {
     ///
     /// The total number of entries in the index is incremented by one.
     pub fn add_record(&mut self, record: &RSIndexResult) -> std::io::Result<AddRecordOutcome> {
-        let result = self.index.add_record(record)?;
+        self.add_record_with_doc_len(record, 0)
+    }
+
+    /// Add a new record to the index together with the length of its document. See
+    /// [`InvertedIndex::add_record_with_doc_len`].
+    pub fn add_record_with_doc_len(
+        &mut self,
+        record: &RSIndexResult,
+        doc_len: u32,
+    ) -> std::io::Result<AddRecordOutcome> {
+        let result = self.index.add_record_with_doc_len(record, doc_len)?;
 
         self.number_of_entries += 1;
 
         Ok(result)
     }
 
+    /// The score bounds covering every entry of the index. See [`InvertedIndex::score_bounds`].
+    pub fn score_bounds(&self) -> Option<ScoreBounds> {
+        self.index.score_bounds()
+    }
+
     /// The memory size of the index in bytes.
     pub fn memory_usage(&self) -> usize {
         self.index.memory_usage() + std::mem::size_of::<usize>()
@@ -149,6 +165,12 @@ impl<E: Encoder + DecodedBy> EntriesTrackingIndex<E> {
         self.index.scan_gc(doc_exist, repair)
     }
 
+    /// Merge the sparse blocks left by a garbage collection scan, see
+    /// [`InvertedIndex::coalesce_gc`].
+    pub fn coalesce_gc(&self, delta: Option<GcScanDelta>) -> std::io::Result<Option<GcScanDelta>> {
+        self.index.coalesce_gc(delta)
+    }
+
     /// Apply the deltas of a garbage collection scan to the index. This will modify the index
     /// by deleting or repairing blocks as needed.
     pub fn apply_gc(&mut self, delta: GcScanDelta) -> GcApplyInfo {
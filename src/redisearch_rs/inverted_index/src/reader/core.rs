@@ -16,8 +16,9 @@ use super::{
     SuspendableReader, TermReader,
 };
 use crate::{
-    DecodedBy, Decoder, Encoder, HasInnerIndex, InvertedIndex, NumericDecoder, TermDecoder,
-    index::unique_id::IndexUniqueId, opaque::OpaqueEncoding,
+    DecodedBy, Decoder, DocIdsDecoder, Encoder, HasInnerIndex, IndexBlock, InvertedIndex,
+    NumericDecoder, ScoreBounds, TermDecoder, index::unique_id::IndexUniqueId,
+    opaque::OpaqueEncoding,
 };
 use ffi::{IndexFlags, IndexFlags_Index_HasMultiValue};
 use index_result::RSIndexResult;
@@ -262,7 +263,7 @@ impl<'index, E: DecodedBy<Decoder = D> + 'index, D: Decoder> IndexReader<'index>
         let base = D::base_id(block, self.last_doc_id);
         let mut cursor = Cursor::new(self.buf.get());
         cursor.set_position(self.buf_pos);
-        D::decode(&mut cursor, base, result)?;
+        D::decode_entry(&mut cursor, base, self.entry_in_block, result)?;
         self.buf_pos = cursor.position();
 
         // The codec does not carry the field-expiration flag; it lives in the
@@ -289,7 +290,7 @@ impl<'index, E: DecodedBy<Decoder = D> + 'index, D: Decoder> IndexReader<'index>
         let base = D::base_id(&ii.blocks[self.current_block_idx], self.last_doc_id);
         let mut cursor = Cursor::new(self.buf.get());
         cursor.set_position(self.buf_pos);
-        let skipped = D::seek(&mut cursor, base, doc_id, result)?;
+        let skipped = D::seek_entry(&mut cursor, base, self.entry_in_block, doc_id, result)?;
         self.buf_pos = cursor.position();
 
         match skipped {
@@ -381,6 +382,20 @@ impl<'index, E: DecodedBy<Decoder = D> + 'index, D: Decoder> IndexReader<'index>
             self.buf = SharedPtr::from_ref(current_block.buffer.as_slice());
         }
     }
+
+    fn block_score_bounds(&self, doc_id: DocId) -> Option<ScoreBounds> {
+        let blocks = &self.ii.get().blocks;
+        let search_start = self.current_block_idx.min(blocks.len());
+        let relative_idx = blocks[search_start..].partition_point(|b| b.last_doc_id < doc_id);
+
+        blocks
+            .get(search_start + relative_idx)
+            .map(IndexBlock::score_bounds)
+    }
+
+    fn index_score_bounds(&self) -> Option<ScoreBounds> {
+        self.ii.get().score_bounds()
+    }
 }
 
 impl<'index, E: DecodedBy<Decoder = D> + 'index, D: Decoder> RawIndexReaderCore<Active<'index>, E> {
@@ -440,6 +455,48 @@ impl<'index, E: DecodedBy<Decoder = D> + 'index, D: Decoder> RawIndexReaderCore<
     }
 }
 
+impl<'index, E: DecodedBy<Decoder = D> + 'index, D: DocIdsDecoder> IndexReaderCore<'index, E> {
+    /// Decode the document IDs of the block holding the first entry at or after `doc_id` into
+    /// `out`, replacing its content. Returns `false`, leaving `out` empty, if there is no such
+    /// entry.
+    ///
+    /// The reader itself does not move, and only looks at blocks from its current one onwards.
+    /// `out` receives every entry of the block, including the ones before `doc_id`.
+    pub fn block_doc_ids(&self, doc_id: DocId, out: &mut Vec<DocId>) -> std::io::Result<bool> {
+        out.clear();
+
+        let blocks = &self.ii.get().blocks;
+        let search_start = self.current_block_idx.min(blocks.len());
+        let relative_idx = blocks[search_start..].partition_point(|b| b.last_doc_id < doc_id);
+        let Some(block) = blocks.get(search_start + relative_idx) else {
+            return Ok(false);
+        };
+
+        D::decode_block_doc_ids(block, out)?;
+        Ok(true)
+    }
+
+    /// Set the bit of every entry with a document ID in the window of `64 * words.len()` IDs
+    /// starting at `base`, see [`DocIdsDecoder::decode_block_doc_ids_words`].
+    ///
+    /// Like [`Self::block_doc_ids`], the reader does not move and only looks at blocks from its
+    /// current one onwards, so entries of the current block before its position are set too.
+    pub fn block_doc_ids_words(&self, base: DocId, words: &mut [u64]) -> std::io::Result<()> {
+        let end = base.saturating_add((words.len() * 64) as DocId);
+        let blocks = &self.ii.get().blocks;
+        let search_start = self.current_block_idx.min(blocks.len());
+        let relative_idx = blocks[search_start..].partition_point(|b| b.last_doc_id < base);
+
+        for block in &blocks[search_start + relative_idx..] {
+            if block.first_doc_id >= end {
+                break;
+            }
+            D::decode_block_doc_ids_words(block, base, words)?;
+        }
+        Ok(())
+    }
+}
+
 impl<E: Encoder + DecodedBy> InvertedIndex<E> {
     /// Create a new [`IndexReader`] for this inverted index.
     pub fn reader(&self) -> IndexReaderCore<'_, E> {
@@ -12,7 +12,8 @@ use super::{
     SuspendableReader, TermReader,
 };
 use crate::{
-    DecodedBy, Decoder, HasInnerIndex, InvertedIndex, TermDecoder, opaque::OpaqueEncoding,
+    DecodedBy, Decoder, HasInnerIndex, InvertedIndex, ScoreBounds, TermDecoder,
+    opaque::OpaqueEncoding,
 };
 use ffi::IndexFlags;
 use index_result::RSIndexResult;
@@ -152,6 +153,14 @@ impl<'index, IR: IndexReader<'index>> IndexReader<'index> for FilterMaskReader<I
     fn refresh_buffer_pointers(&mut self) {
         self.inner.refresh_buffer_pointers();
     }
+
+    fn block_score_bounds(&self, doc_id: DocId) -> Option<ScoreBounds> {
+        self.inner.block_score_bounds(doc_id)
+    }
+
+    fn index_score_bounds(&self) -> Option<ScoreBounds> {
+        self.inner.index_score_bounds()
+    }
 }
 
 impl<'index, E: DecodedBy<Decoder = D>, D: Decoder> FilterMaskReader<IndexReaderCore<'index, E>> {
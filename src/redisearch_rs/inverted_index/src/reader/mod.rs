@@ -16,6 +16,8 @@ use ffi::IndexFlags;
 use index_result::RSIndexResult;
 use rqe_core::{DocId, FieldMask};
 
+use crate::ScoreBounds;
+
 pub use self::core::{IndexReaderCore, RawIndexReaderCore};
 pub use field_mask::FilterMaskReader;
 pub use geo::FilterGeoReader;
@@ -81,6 +83,19 @@ pub trait IndexReader<'index> {
 
     /// Refresh buffer pointers in case blocks were reallocated without GC changes
     fn refresh_buffer_pointers(&mut self);
+
+    /// Get the score bounds of the block which [`Self::skip_to`] would move to for `doc_id`,
+    /// without moving the reader. Returns `None` past the end of the index, or when the reader
+    /// does not know the bounds of its blocks.
+    fn block_score_bounds(&self, _doc_id: DocId) -> Option<ScoreBounds> {
+        None
+    }
+
+    /// Get the score bounds covering the whole underlying index, or `None` when the index is
+    /// empty or the reader does not know them.
+    fn index_score_bounds(&self) -> Option<ScoreBounds> {
+        None
+    }
 }
 
 /// Type-level mapping from an Active reader to its Suspended counterpart.
@@ -34,6 +34,8 @@ fn index_block_repair_delete() {
         first_doc_id: 10,
         last_doc_id: 11,
         expiration_bits: Default::default(),
+        max_freq: 0,
+        min_doc_len: 0,
     };
 
     fn cb(doc_id: DocId) -> bool {
@@ -66,6 +68,8 @@ fn index_block_repair_unchanged() {
         first_doc_id: 10,
         last_doc_id: 11,
         expiration_bits: Default::default(),
+        max_freq: 0,
+        min_doc_len: 0,
     };
 
     fn cb(_doc_id: DocId) -> bool {
@@ -93,6 +97,8 @@ fn index_block_repair_some_deletions() {
         first_doc_id: 10,
         last_doc_id: 12,
         expiration_bits: Default::default(),
+        max_freq: 0,
+        min_doc_len: 0,
     };
 
     fn cb(doc_id: DocId) -> bool {
@@ -117,6 +123,52 @@ fn index_block_repair_some_deletions() {
                 num_entries: 1,
                 buffer: encode_ids!(Dummy, 11),
                 expiration_bits: Default::default(),
+                max_freq: 0,
+                min_doc_len: 0,
+            }],
+            n_unique_docs_removed: 2
+        })
+    );
+}
+
+#[test]
+fn index_block_repair_keeps_score_bounds() {
+    // The surviving entry does not store its document length, so the bounds of the
+    // original block have to carry over to its replacement.
+    let block = IndexBlock {
+        buffer: encode_ids!(Dummy, 10, 11, 12),
+        num_entries: 3,
+        first_doc_id: 10,
+        last_doc_id: 12,
+        expiration_bits: Default::default(),
+        max_freq: 7,
+        min_doc_len: 3,
+    };
+
+    fn cb(doc_id: DocId) -> bool {
+        doc_id == 12
+    }
+
+    let repair_status = block
+        .repair(
+            0,
+            cb,
+            None::<fn(&RSIndexResult, &crate::RepairContext<'_>)>,
+            PhantomData::<Dummy>,
+        )
+        .unwrap();
+
+    assert_eq!(
+        repair_status,
+        Some(RepairType::Replace {
+            blocks: smallvec![IndexBlock {
+                first_doc_id: 12,
+                last_doc_id: 12,
+                num_entries: 1,
+                buffer: encode_ids!(Dummy, 12),
+                expiration_bits: Default::default(),
+                max_freq: 7,
+                min_doc_len: 3,
             }],
             n_unique_docs_removed: 2
         })
@@ -205,6 +257,8 @@ fn index_block_repair_delta_too_big() {
         first_doc_id: 10,
         last_doc_id: 42,
         expiration_bits: Default::default(),
+        max_freq: 0,
+        min_doc_len: 0,
     };
 
     fn cb(doc_id: DocId) -> bool {
@@ -240,6 +294,8 @@ fn index_block_repair_delta_too_big() {
                     first_doc_id: 10,
                     last_doc_id: 10,
                     expiration_bits: Default::default(),
+                    max_freq: 0,
+                    min_doc_len: 0,
                 },
                 IndexBlock {
                     buffer: {
@@ -257,6 +313,8 @@ fn index_block_repair_delta_too_big() {
                     first_doc_id: 42,
                     last_doc_id: 42,
                     expiration_bits: Default::default(),
+                    max_freq: 0,
+                    min_doc_len: 0,
                 }
             ],
             n_unique_docs_removed: 1
@@ -278,6 +336,8 @@ fn ii_scan_gc() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 20, 21, 22),
@@ -285,6 +345,8 @@ fn ii_scan_gc() {
             first_doc_id: 20,
             last_doc_id: 22,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 30),
@@ -292,6 +354,8 @@ fn ii_scan_gc() {
             first_doc_id: 30,
             last_doc_id: 30,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 40),
@@ -299,6 +363,8 @@ fn ii_scan_gc() {
             first_doc_id: 40,
             last_doc_id: 40,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
 
@@ -334,6 +400,8 @@ fn ii_scan_gc() {
                             first_doc_id: 21,
                             last_doc_id: 22,
                             expiration_bits: Default::default(),
+                            max_freq: 0,
+                            min_doc_len: 0,
                         }],
                         n_unique_docs_removed: 1
                     },
@@ -353,6 +421,8 @@ fn ii_scan_gc_no_change() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 30),
@@ -360,6 +430,8 @@ fn ii_scan_gc_no_change() {
             first_doc_id: 30,
             last_doc_id: 30,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -390,6 +462,8 @@ fn ii_apply_gc() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 20, 21, 22),
@@ -397,6 +471,8 @@ fn ii_apply_gc() {
             first_doc_id: 20,
             last_doc_id: 22,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 30),
@@ -404,6 +480,8 @@ fn ii_apply_gc() {
             first_doc_id: 30,
             last_doc_id: 30,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 40, 71, 72),
@@ -411,6 +489,8 @@ fn ii_apply_gc() {
             first_doc_id: 40,
             last_doc_id: 72,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let mut ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -442,6 +522,8 @@ fn ii_apply_gc() {
                     first_doc_id: 21,
                     last_doc_id: 21,
                     expiration_bits: Default::default(),
+                    max_freq: 0,
+                    min_doc_len: 0,
                 }],
                 n_unique_docs_removed: 2,
             },
@@ -456,6 +538,8 @@ fn ii_apply_gc() {
                         first_doc_id: 40,
                         last_doc_id: 40,
                         expiration_bits: Default::default(),
+                        max_freq: 0,
+                        min_doc_len: 0,
                     },
                     IndexBlock {
                         buffer: encode_ids!(Dummy, 72),
@@ -463,6 +547,8 @@ fn ii_apply_gc() {
                         first_doc_id: 72,
                         last_doc_id: 72,
                         expiration_bits: Default::default(),
+                        max_freq: 0,
+                        min_doc_len: 0,
                     },
                 ],
                 n_unique_docs_removed: 1,
@@ -503,6 +589,8 @@ fn ii_apply_gc() {
                 first_doc_id: 21,
                 last_doc_id: 21,
                 expiration_bits: Default::default(),
+                max_freq: 0,
+                min_doc_len: 0,
             },
             IndexBlock {
                 buffer: encode_ids!(Dummy, 30),
@@ -510,6 +598,8 @@ fn ii_apply_gc() {
                 first_doc_id: 30,
                 last_doc_id: 30,
                 expiration_bits: Default::default(),
+                max_freq: 0,
+                min_doc_len: 0,
             },
             IndexBlock {
                 buffer: encode_ids!(Dummy, 40),
@@ -517,6 +607,8 @@ fn ii_apply_gc() {
                 first_doc_id: 40,
                 last_doc_id: 40,
                 expiration_bits: Default::default(),
+                max_freq: 0,
+                min_doc_len: 0,
             },
             IndexBlock {
                 buffer: encode_ids!(Dummy, 72),
@@ -524,6 +616,8 @@ fn ii_apply_gc() {
                 first_doc_id: 72,
                 last_doc_id: 72,
                 expiration_bits: Default::default(),
+                max_freq: 0,
+                min_doc_len: 0,
             },
         ]
     );
@@ -537,6 +631,7 @@ fn ii_apply_gc() {
             entries_removed: 5,
             // Removed 3, added back (split blocks) — see `apply_gc` for the exact net delta
             block_count_delta: 0,
+            blocks_merged: 0,
             ignored_last_block: false,
         }
     );
@@ -552,6 +647,8 @@ fn ii_apply_gc_last_block_updated() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 20, 21, 22),
@@ -559,6 +656,8 @@ fn ii_apply_gc_last_block_updated() {
             first_doc_id: 20,
             last_doc_id: 22,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
 
@@ -589,6 +688,8 @@ fn ii_apply_gc_last_block_updated() {
                     first_doc_id: 21,
                     last_doc_id: 21,
                     expiration_bits: Default::default(),
+                    max_freq: 0,
+                    min_doc_len: 0,
                 }],
                 n_unique_docs_removed: 2,
             },
@@ -626,6 +727,8 @@ fn ii_apply_gc_last_block_updated() {
             first_doc_id: 20,
             last_doc_id: 22,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },]
     );
     assert_eq!(
@@ -638,6 +741,7 @@ fn ii_apply_gc_last_block_updated() {
             entries_removed: 2,
             // Removed one block
             block_count_delta: -1,
+            blocks_merged: 0,
             // Ignored the last block
             ignored_last_block: true,
         }
@@ -658,6 +762,8 @@ fn ii_apply_gc_last_block_updated_no_delta() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: encode_ids!(Dummy, 20, 21, 22),
@@ -665,6 +771,8 @@ fn ii_apply_gc_last_block_updated_no_delta() {
             first_doc_id: 20,
             last_doc_id: 22,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
 
@@ -694,6 +802,7 @@ fn ii_apply_gc_last_block_updated_no_delta() {
             bytes_allocated: 0,
             entries_removed: 2,
             block_count_delta: -1,
+            blocks_merged: 0,
             // The key assertion: ignored_last_block must be true even without
             // a delta for the last block.
             ignored_last_block: true,
@@ -709,6 +818,8 @@ fn ii_apply_gc_last_block_updated_no_delta() {
             first_doc_id: 20,
             last_doc_id: 22,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         }]
     );
 }
@@ -786,6 +897,8 @@ fn ii_apply_gc_entries_tracking_index() {
                     first_doc_id: 15,
                     last_doc_id: 15,
                     expiration_bits: Default::default(),
+                    max_freq: 0,
+                    min_doc_len: 0,
                 }],
                 n_unique_docs_removed: 1,
             },
@@ -820,6 +933,8 @@ fn ii_apply_gc_entries_tracking_index() {
             first_doc_id: 15,
             last_doc_id: 15,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },]
     );
     assert_eq!(
@@ -829,6 +944,7 @@ fn ii_apply_gc_entries_tracking_index() {
             bytes_allocated: 64,
             entries_removed: 2,
             block_count_delta: 0,
+            blocks_merged: 0,
             ignored_last_block: false,
         }
     );
@@ -888,3 +1004,125 @@ fn test_refresh_buffer_pointers_after_reallocation() {
     assert_eq!(doc_count, 990);
     assert_eq!(expected_doc_id, 1000);
 }
+
+#[test]
+fn ii_coalesce_gc_merges_sparse_blocks() {
+    /// Dummy encoder which only allows 4 entries per block for testing
+    #[derive(Clone)]
+    struct SmallBlocksDummy;
+
+    impl Encoder for SmallBlocksDummy {
+        type Delta = u32;
+
+        const RECOMMENDED_BLOCK_ENTRIES: u16 = 4;
+
+        fn encode<W: std::io::Write + std::io::Seek>(
+            writer: W,
+            delta: Self::Delta,
+            record: &RSIndexResult,
+        ) -> std::io::Result<usize> {
+            Dummy::encode(writer, delta, record)
+        }
+    }
+
+    impl Decoder for SmallBlocksDummy {
+        fn decode<'index>(
+            cursor: &mut Cursor<&'index [u8]>,
+            prev_doc_id: u64,
+            result: &mut RSIndexResult<'index>,
+        ) -> std::io::Result<()> {
+            Dummy::decode(cursor, prev_doc_id, result)
+        }
+
+        fn base_result<'index>() -> RSIndexResult<'index> {
+            Dummy::base_result()
+        }
+    }
+
+    let block = |ids: &[DocId]| IndexBlock {
+        buffer: ids
+            .iter()
+            .scan(ids[0], |last, &id| {
+                let delta = (id - *last) as u32;
+                *last = id;
+                Some(delta.to_be_bytes())
+            })
+            .flatten()
+            .collect(),
+        num_entries: ids.len() as u16,
+        first_doc_id: ids[0],
+        last_doc_id: *ids.last().unwrap(),
+        expiration_bits: Default::default(),
+        max_freq: 0,
+        min_doc_len: 0,
+    };
+
+    let blocks = medium_thin_vec![
+        block(&[10, 11, 12, 13]),
+        block(&[20, 21, 22, 23]),
+        block(&[30, 31]),
+        block(&[40]),
+    ];
+    let mut ii = InvertedIndex::<SmallBlocksDummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
+
+    // Nothing to collect and no sparse blocks to merge but the last one
+    let delta = ii
+        .scan_gc(
+            |_| true,
+            None::<fn(&RSIndexResult, &crate::RepairContext<'_>)>,
+        )
+        .unwrap();
+    assert_eq!(ii.coalesce_gc(delta).unwrap(), None);
+
+    let doc_exist = |id| ![11, 12, 13, 21, 22].contains(&id);
+    let delta = ii
+        .scan_gc(doc_exist, None::<fn(&RSIndexResult, &crate::RepairContext<'_>)>)
+        .unwrap();
+    let delta = ii.coalesce_gc(delta).unwrap().unwrap();
+
+    // The 5 entries left in the first 3 blocks fit in 2 blocks. The last block is left as is.
+    assert_eq!(
+        delta,
+        GcScanDelta {
+            last_block_idx: 3,
+            last_block_num_entries: 1,
+            deltas: vec![
+                BlockGcScanResult {
+                    index: 0,
+                    repair: RepairType::Replace {
+                        blocks: smallvec![block(&[10, 20, 23, 30]), block(&[31])],
+                        n_unique_docs_removed: 3,
+                    },
+                },
+                BlockGcScanResult {
+                    index: 1,
+                    repair: RepairType::Merged {
+                        n_unique_docs_removed: 2,
+                    },
+                },
+                BlockGcScanResult {
+                    index: 2,
+                    repair: RepairType::Merged {
+                        n_unique_docs_removed: 0,
+                    },
+                },
+            ],
+        }
+    );
+
+    let memory_before = ii.memory_usage();
+    let apply_info = ii.apply_gc(delta);
+
+    assert_eq!(
+        ii.blocks,
+        vec![block(&[10, 20, 23, 30]), block(&[31]), block(&[40])]
+    );
+    assert_eq!(ii.unique_docs(), 6);
+    assert_eq!(apply_info.entries_removed, 5);
+    assert_eq!(apply_info.blocks_merged, 2);
+    assert_eq!(apply_info.block_count_delta, -1);
+    assert_eq!(
+        ii.memory_usage(),
+        memory_before + apply_info.bytes_allocated - apply_info.bytes_freed
+    );
+}
@@ -11,7 +11,7 @@ use std::io::Cursor;
 
 use crate::{
     Decoder, Encoder, EntriesTrackingIndex, FieldMaskTrackingIndex, GcScanDelta, IdDelta,
-    IndexBlock, IndexReader as _, InvertedIndex,
+    IndexBlock, IndexReader as _, InvertedIndex, ScoreBounds,
     debug::{BlockSummary, Summary},
     gc::BlockGcScanResult,
     gc::RepairType,
@@ -233,6 +233,60 @@ fn adding_creates_new_blocks_when_entries_is_reached() {
     );
 }
 
+#[test]
+fn full_blocks_are_sealed() {
+    /// Dummy encoder which writes 2 bytes per entry and allows 3 entries per block
+    #[derive(Clone)]
+    struct TwoBytesDummy;
+
+    impl Encoder for TwoBytesDummy {
+        type Delta = u32;
+
+        const RECOMMENDED_BLOCK_ENTRIES: u16 = 3;
+
+        fn encode<W: std::io::Write + std::io::Seek>(
+            mut writer: W,
+            _delta: Self::Delta,
+            _record: &RSIndexResult,
+        ) -> std::io::Result<usize> {
+            writer.write_all(&[1, 2])?;
+
+            Ok(2)
+        }
+    }
+
+    let mut ii = InvertedIndex::<TwoBytesDummy>::new(IndexFlags_Index_DocIdsOnly);
+    let empty_size = ii.memory_usage();
+    let mut tracked = empty_size;
+
+    for doc_id in 10..13 {
+        let outcome = ii
+            .add_record(&RSIndexResult::build_virt().doc_id(doc_id).build())
+            .unwrap();
+        assert_eq!(outcome.mem_released, 0, "the block is not full yet");
+        tracked += outcome.mem_growth as usize;
+    }
+    assert_eq!(ii.blocks[0].buffer.len(), 6);
+    assert_eq!(
+        ii.blocks[0].buffer.capacity(),
+        7,
+        "the buffer grows with some spare capacity"
+    );
+
+    // The 4th entry starts a new block and seals the full one
+    let outcome = ii
+        .add_record(&RSIndexResult::build_virt().doc_id(13).build())
+        .unwrap();
+    assert_eq!(outcome.blocks_added, 1);
+    assert_eq!(outcome.mem_released, 1);
+    tracked += outcome.mem_growth as usize;
+    tracked -= outcome.mem_released as usize;
+
+    assert_eq!(ii.blocks.len(), 2);
+    assert_eq!(ii.blocks[0].buffer.capacity(), 6, "sealed blocks are exact");
+    assert_eq!(ii.memory_usage(), tracked);
+}
+
 #[test]
 fn adding_big_delta_makes_new_block() {
     let mut ii = InvertedIndex::<Dummy>::new(IndexFlags_Index_DocIdsOnly);
@@ -398,6 +452,75 @@ fn adding_tracks_entries() {
     assert_eq!(ii.number_of_entries(), 2);
 }
 
+#[test]
+fn adding_tracks_score_bounds() {
+    let mut ii = InvertedIndex::<Dummy>::new(IndexFlags_Index_DocIdsOnly);
+    assert_eq!(ii.score_bounds(), None);
+
+    let record = RSIndexResult::build_virt().doc_id(10).frequency(3).build();
+    ii.add_record_with_doc_len(&record, 20).unwrap();
+    let record = RSIndexResult::build_virt().doc_id(11).frequency(1).build();
+    ii.add_record_with_doc_len(&record, 5).unwrap();
+
+    assert_eq!(
+        ii.blocks[0].score_bounds(),
+        ScoreBounds {
+            last_doc_id: 11,
+            max_freq: 3,
+            min_doc_len: 5,
+        }
+    );
+
+    // A delta too big for the encoder starts a new block, with bounds of its own. Frequencies
+    // which do not fit the block saturate, and a record without a length makes it unknown.
+    let doc_id = (u32::MAX as u64) + 20;
+    let record = RSIndexResult::build_virt()
+        .doc_id(doc_id)
+        .frequency(100_000)
+        .build();
+    ii.add_record_with_doc_len(&record, 8).unwrap();
+    let record = RSIndexResult::build_virt().doc_id(doc_id + 1).build();
+    ii.add_record(&record).unwrap();
+
+    assert_eq!(ii.blocks.len(), 2);
+    assert_eq!(
+        ii.blocks[1].score_bounds(),
+        ScoreBounds {
+            last_doc_id: doc_id + 1,
+            max_freq: u32::MAX,
+            min_doc_len: 0,
+        }
+    );
+    assert_eq!(
+        ii.score_bounds(),
+        Some(ScoreBounds {
+            last_doc_id: doc_id + 1,
+            max_freq: u32::MAX,
+            min_doc_len: 0,
+        })
+    );
+
+    // Readers report the block a skip would land in, without moving.
+    let mut reader = ii.reader();
+    assert_eq!(
+        reader.block_score_bounds(11).map(|b| b.last_doc_id),
+        Some(11)
+    );
+    assert_eq!(
+        reader.block_score_bounds(12).map(|b| b.last_doc_id),
+        Some(doc_id + 1)
+    );
+    assert_eq!(reader.block_score_bounds(doc_id + 2), None);
+
+    assert!(reader.skip_to(doc_id));
+    assert_eq!(
+        reader.block_score_bounds(10).map(|b| b.last_doc_id),
+        Some(doc_id + 1),
+        "blocks behind the reader are not looked at"
+    );
+    assert_eq!(reader.index_score_bounds(), ii.score_bounds());
+}
+
 #[test]
 fn adding_track_field_mask() {
     let mut ii = FieldMaskTrackingIndex::<Dummy>::new(IndexFlags_Index_StoreFieldFlags);
@@ -31,6 +31,8 @@ fn seeking_records() {
             first_doc_id: 10,
             last_doc_id: 12,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 5],
@@ -38,6 +40,8 @@ fn seeking_records() {
             first_doc_id: 100,
             last_doc_id: 108,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
 
@@ -89,6 +93,8 @@ fn index_reader_skip_to() {
             first_doc_id: 10,
             last_doc_id: 15,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0, 0, 0, 0, 1],
@@ -96,6 +102,8 @@ fn index_reader_skip_to() {
             first_doc_id: 16,
             last_doc_id: 17,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0, 0, 0, 0, 4],
@@ -103,6 +111,8 @@ fn index_reader_skip_to() {
             first_doc_id: 20,
             last_doc_id: 24,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -110,6 +120,8 @@ fn index_reader_skip_to() {
             first_doc_id: 30,
             last_doc_id: 30,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -117,6 +129,8 @@ fn index_reader_skip_to() {
             first_doc_id: 40,
             last_doc_id: 40,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -124,6 +138,8 @@ fn index_reader_skip_to() {
             first_doc_id: 50,
             last_doc_id: 50,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -178,6 +194,8 @@ fn reader_reset() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -185,6 +203,8 @@ fn reader_reset() {
             first_doc_id: 100,
             last_doc_id: 100,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -240,6 +260,8 @@ fn reader_unique_docs() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -247,6 +269,8 @@ fn reader_unique_docs() {
             first_doc_id: 100,
             last_doc_id: 100,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -344,6 +368,8 @@ fn reading_records() {
             first_doc_id: 10,
             last_doc_id: 11,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -351,6 +377,8 @@ fn reading_records() {
             first_doc_id: 100,
             last_doc_id: 100,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -392,6 +420,8 @@ fn reading_over_empty_blocks() {
             first_doc_id: 10,
             last_doc_id: 10,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
         IndexBlock {
             buffer: vec![0, 0, 0, 0],
@@ -399,6 +429,8 @@ fn reading_over_empty_blocks() {
             first_doc_id: 30,
             last_doc_id: 30,
             expiration_bits: Default::default(),
+            max_freq: 0,
+            min_doc_len: 0,
         },
     ];
     let ii = InvertedIndex::<Dummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
@@ -473,6 +505,8 @@ fn read_using_the_first_block_id_as_the_base() {
         first_doc_id: 10,
         last_doc_id: 12,
         expiration_bits: Default::default(),
+        max_freq: 0,
+        min_doc_len: 0,
     }];
     let ii = InvertedIndex::<FirstBlockIdDummy>::from_blocks(IndexFlags_Index_DocIdsOnly, blocks);
     let mut ir = ii.reader();
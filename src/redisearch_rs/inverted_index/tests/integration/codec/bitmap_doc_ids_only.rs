@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+use ffi::IndexFlags_Index_DocIdsOnly;
+use index_result::RSIndexResult;
+use inverted_index::{
+    IndexReader, InvertedIndex,
+    bitmap_doc_ids_only::{BitmapDocIdsOnly, Container, MAX_DENSE_SPAN},
+};
+use rqe_core::DocId;
+
+fn build_index(ids: &[DocId]) -> InvertedIndex<BitmapDocIdsOnly> {
+    let mut ii = InvertedIndex::<BitmapDocIdsOnly>::new(IndexFlags_Index_DocIdsOnly);
+    for id in ids {
+        ii.add_record(&RSIndexResult::build_virt().doc_id(*id).build())
+            .unwrap();
+    }
+    ii
+}
+
+fn containers(ii: &InvertedIndex<BitmapDocIdsOnly>) -> Vec<Container> {
+    (0..ii.number_of_blocks())
+        .map(|idx| {
+            let block = ii.block_ref(idx).expect("the index to have the block");
+            BitmapDocIdsOnly::container(block.data()).expect("a valid container tag")
+        })
+        .collect()
+}
+
+fn assert_reads(ii: &InvertedIndex<BitmapDocIdsOnly>, ids: &[DocId]) {
+    let mut reader = ii.reader();
+    let mut result = RSIndexResult::build_virt().build();
+
+    for expected_id in ids {
+        let found = reader.next_record(&mut result).unwrap();
+        assert!(found, "expected to find doc_id {}", expected_id);
+        assert_eq!(result.doc_id, *expected_id);
+    }
+
+    assert!(!reader.next_record(&mut result).unwrap(), "no more records");
+}
+
+#[test]
+fn test_bitmap_doc_ids_only_container_choice() {
+    // Consecutive IDs are stored as runs.
+    let ids: Vec<DocId> = (1..=200).collect();
+    let ii = build_index(&ids);
+    assert_eq!(containers(&ii), [Container::Runs]);
+    assert_reads(&ii, &ids);
+
+    // Dense IDs with holes are stored as a bitmap.
+    let ids: Vec<DocId> = (1..=200).map(|i| i * 2).collect();
+    let ii = build_index(&ids);
+    assert_eq!(containers(&ii), [Container::Bitmap]);
+    assert_reads(&ii, &ids);
+
+    // Sparse IDs keep the varint deltas.
+    let ids: Vec<DocId> = (1..=200).map(|i| i * 300).collect();
+    let ii = build_index(&ids);
+    assert_eq!(containers(&ii), [Container::Varint]);
+    assert_reads(&ii, &ids);
+}
+
+#[test]
+fn test_bitmap_doc_ids_only_runs_become_bitmap() {
+    // A run followed by every other ID: the runs outgrow the bitmap of the same span.
+    let ids: Vec<DocId> = (1..=100).chain((1..=300).map(|i| 100 + 2 * i)).collect();
+    let ii = build_index(&ids);
+    assert_eq!(containers(&ii), [Container::Bitmap]);
+    assert_reads(&ii, &ids);
+}
+
+#[test]
+fn test_bitmap_doc_ids_only_span_limit() {
+    // A dense block is closed once its span is covered, even if it holds few entries.
+    let ids: Vec<DocId> = (1..=128)
+        .chain([MAX_DENSE_SPAN + 1, MAX_DENSE_SPAN + 2])
+        .collect();
+    let ii = build_index(&ids);
+    assert_eq!(ii.number_of_blocks(), 2);
+    assert_eq!(containers(&ii)[0], Container::Runs);
+    assert_reads(&ii, &ids);
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_seek_bitmap_doc_ids_only() {
+    let ids: Vec<DocId> = (1..=20_000)
+        .filter(|i| i % 5 != 0 && i % 7 != 3)
+        .chain(100_000..101_000)
+        .collect();
+    let ii = build_index(&ids);
+    assert!(containers(&ii).contains(&Container::Bitmap));
+    assert!(containers(&ii).contains(&Container::Runs));
+
+    // Every other document can be reached.
+    {
+        let mut reader = ii.reader();
+        let mut result = RSIndexResult::build_virt().build();
+
+        for expected_id in ids.iter().step_by(2) {
+            let found = reader.seek_record(*expected_id, &mut result).unwrap();
+            assert!(found, "expected to find doc_id {}", expected_id);
+            assert_eq!(result.doc_id, *expected_id);
+        }
+    }
+
+    // Seeking a missing document lands on the next one, and reading goes on from there.
+    {
+        let mut reader = ii.reader();
+        let mut result = RSIndexResult::build_virt().build();
+
+        assert!(reader.seek_record(10, &mut result).unwrap());
+        assert_eq!(result.doc_id, 11);
+        assert!(reader.seek_record(20_001, &mut result).unwrap());
+        assert_eq!(result.doc_id, 100_000);
+        assert!(reader.next_record(&mut result).unwrap());
+        assert_eq!(result.doc_id, 100_001);
+        assert!(!reader.seek_record(101_000, &mut result).unwrap());
+    }
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_block_doc_ids_words_bitmap_doc_ids_only() {
+    // Varint, bitmap and run blocks, each dense range starting past the span of the previous one.
+    let ids: Vec<DocId> = (1..=50)
+        .map(|i| i * 1_000)
+        .chain((1..=2_000).map(|i| 200_000 + 3 * i))
+        .chain(400_000..402_000)
+        .collect();
+    let ii = build_index(&ids);
+    let found = containers(&ii);
+    for container in [Container::Varint, Container::Bitmap, Container::Runs] {
+        assert!(found.contains(&container), "{container:?} in {found:?}");
+    }
+
+    let reader = ii.reader();
+    for base in [0, 40_000, 200_000, 202_500, 205_990, 399_999, 401_990] {
+        let mut words = [0u64; 64];
+        reader.block_doc_ids_words(base, &mut words).unwrap();
+
+        let end = base + 64 * words.len() as DocId;
+        let expected: Vec<DocId> = ids
+            .iter()
+            .copied()
+            .filter(|id| (base..end).contains(id))
+            .collect();
+        let decoded: Vec<DocId> = (base..end)
+            .filter(|id| {
+                let off = (id - base) as usize;
+                words[off / 64] & (1 << (off % 64)) != 0
+            })
+            .collect();
+        assert_eq!(decoded, expected, "window at {base}");
+    }
+}
+
+/// GC keeps the containers, and the entry ordinals of the readers, in sync with the entries left.
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_inverted_index_bitmap_doc_ids_gc() {
+    let ids: Vec<DocId> = (1..=3_000)
+        .map(|i| i * 2)
+        .chain(10_000..12_000)
+        .chain((1..=500).map(|i| 20_000 + 997 * i))
+        .collect();
+    let mut ii = build_index(&ids);
+    assert_reads(&ii, &ids);
+
+    // Test GC: Remove every third document
+    let delta = ii
+        .scan_gc(
+            |doc_id| ids.binary_search(&doc_id).unwrap() % 3 != 0,
+            None::<fn(&RSIndexResult, &inverted_index::RepairContext<'_>)>,
+        )
+        .expect("scan_gc should not fail for valid index")
+        .expect("scan_gc should return Some delta when entries are removed");
+    let apply_info = ii.apply_gc(delta);
+
+    let remaining: Vec<DocId> = ids
+        .iter()
+        .enumerate()
+        .filter(|(i, _)| i % 3 != 0)
+        .map(|(_, id)| *id)
+        .collect();
+    assert_eq!(apply_info.entries_removed, ids.len() - remaining.len());
+    assert_eq!(ii.unique_docs() as usize, remaining.len());
+    assert_reads(&ii, &remaining);
+
+    // Test GC: Remove all remaining records
+    let delta = ii
+        .scan_gc(
+            |_| false,
+            None::<fn(&RSIndexResult, &inverted_index::RepairContext<'_>)>,
+        )
+        .expect("scan_gc should not fail for valid index")
+        .expect("scan_gc should return Some delta when entries are removed");
+    let apply_info = ii.apply_gc(delta);
+
+    assert_eq!(apply_info.entries_removed, remaining.len());
+    assert_eq!(ii.unique_docs(), 0);
+    assert_eq!(ii.number_of_blocks(), 0);
+}
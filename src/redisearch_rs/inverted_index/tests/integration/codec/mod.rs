@@ -7,6 +7,7 @@
  * GNU Affero General Public License v3 (AGPLv3).
 */
 
+mod bitmap_doc_ids_only;
 mod doc_ids_only;
 mod fields_offsets;
 mod fields_only;
@@ -16,4 +17,5 @@ mod freqs_only;
 mod full;
 mod numeric;
 mod offsets_only;
+mod packed_doc_ids_only;
 mod raw_doc_ids_only;
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+use std::io::Cursor;
+
+use ffi::IndexFlags_Index_DocIdsOnly;
+use index_result::RSIndexResult;
+use inverted_index::{
+    Decoder, Encoder, IndexReader, InvertedIndex,
+    packed_doc_ids_only::{GROUP_LEN, PackedDocIdsOnly},
+};
+use rqe_core::DocId;
+
+#[test]
+fn test_encode_packed_doc_ids_only() {
+    // Test cases for a standalone record, which is written as a group of its own.
+    let tests = [
+        // (delta, expected encoding - width, len, packed bits)
+        (0, vec![0, 1]),
+        (1, vec![1, 1, 1]),
+        (10, vec![4, 1, 10]),
+        (256, vec![9, 1, 0, 1]),
+        (65536, vec![17, 1, 0, 0, 1]),
+        (u32::MAX, vec![32, 1, 255, 255, 255, 255]),
+    ];
+    let doc_id = 4294967296;
+
+    for (delta, expected_encoding) in tests {
+        let mut buf = Cursor::new(Vec::new());
+        let record = RSIndexResult::build_term().doc_id(doc_id).build();
+
+        let bytes_written = PackedDocIdsOnly::encode(&mut buf, delta, &record)
+            .expect("to encode packed doc ids only record");
+
+        assert_eq!(bytes_written, expected_encoding.len());
+        assert_eq!(buf.get_ref(), &expected_encoding);
+
+        // decode
+        let prev_doc_id = doc_id - (delta as u64);
+        let buf = buf.into_inner();
+        let mut buf = Cursor::new(buf.as_ref());
+
+        let record_decoded = PackedDocIdsOnly::decode_new(&mut buf, prev_doc_id)
+            .expect("to decode packed doc ids only record");
+
+        assert_eq!(record_decoded, record);
+    }
+}
+
+#[test]
+fn test_decode_packed_doc_ids_only_input_too_small() {
+    // The header announces one 9 bits entry but only one payload byte follows.
+    let buf = vec![9, 1, 0];
+    let mut cursor = Cursor::new(buf.as_ref());
+
+    let res = PackedDocIdsOnly::decode_new(&mut cursor, 100);
+    assert!(res.is_err());
+    let kind = res.unwrap_err().kind();
+    assert_eq!(kind, std::io::ErrorKind::UnexpectedEof);
+}
+
+#[test]
+fn test_decode_packed_doc_ids_only_empty_input() {
+    // Try decoding an empty buffer.
+    let buf = vec![];
+    let mut cursor = Cursor::new(buf.as_ref());
+
+    let res = PackedDocIdsOnly::decode_new(&mut cursor, 100);
+    assert!(res.is_err());
+    let kind = res.unwrap_err().kind();
+    assert_eq!(kind, std::io::ErrorKind::UnexpectedEof);
+}
+
+#[test]
+fn test_decode_entry_packed_doc_ids_only() {
+    // A single group of 4 bits deltas: 0, 5, 6, 8, 12, 13.
+    let buf = vec![4, 6, 0x50, 0x86, 0xdc];
+
+    let mut cursor = Cursor::new(buf.as_ref());
+    let mut record_decoded = RSIndexResult::build_term().build();
+    let mut base = 10;
+
+    for (ordinal, expected) in [10, 15, 21, 29, 41, 54].into_iter().enumerate() {
+        PackedDocIdsOnly::decode_entry(&mut cursor, base, ordinal as u16, &mut record_decoded)
+            .expect("to decode packed doc ids only record");
+        assert_eq!(record_decoded.doc_id, expected);
+        base = record_decoded.doc_id;
+    }
+
+    // The cursor only moves past the group once its last entry is read.
+    assert_eq!(cursor.position() as usize, buf.len());
+}
+
+#[test]
+fn test_seek_packed_doc_ids_only() {
+    // Same group as above: deltas 0, 5, 6, 8, 12, 13.
+    let buf = vec![4, 6, 0x50, 0x86, 0xdc];
+    let mut buf = Cursor::new(buf.as_ref());
+
+    let mut record_decoded = RSIndexResult::build_term().build();
+
+    let found = PackedDocIdsOnly::seek_entry(&mut buf, 10, 0, 16, &mut record_decoded)
+        .expect("to decode packed docs ids only record");
+
+    assert_eq!(found, Some(2));
+    assert_eq!(
+        record_decoded,
+        RSIndexResult::build_term().doc_id(21).build()
+    );
+
+    let found = PackedDocIdsOnly::seek_entry(&mut buf, 21, 3, 40, &mut record_decoded)
+        .expect("to decode packed docs ids only record");
+
+    assert_eq!(found, Some(1));
+    assert_eq!(
+        record_decoded,
+        RSIndexResult::build_term().doc_id(41).build()
+    );
+
+    let found = PackedDocIdsOnly::seek_entry(&mut buf, 41, 5, 100, &mut record_decoded)
+        .expect("to decode packed docs ids only record");
+
+    assert!(found.is_none());
+}
+
+#[test]
+fn test_packed_doc_ids_only_block_layout() {
+    let mut ii = InvertedIndex::<PackedDocIdsOnly>::new(IndexFlags_Index_DocIdsOnly);
+
+    // Dense postings need a single bit per entry once the first delta is written.
+    for id in 1..=(GROUP_LEN as DocId * 2 + 3) {
+        ii.add_record(&RSIndexResult::build_virt().doc_id(id).build())
+            .unwrap();
+    }
+
+    assert_eq!(ii.number_of_blocks(), 1);
+    let block = ii.block_ref(0).expect("the index to have a block");
+    // Two full groups of 1 bit deltas and an open group of 3 entries.
+    assert_eq!(block.data().len(), 2 * (2 + 16) + (2 + 1));
+
+    let mut cursor = Cursor::new(block.data());
+    let mut group = [0; GROUP_LEN];
+    let mut base = block.first_block_id();
+    let mut expected_id = 1;
+
+    while (cursor.position() as usize) < block.data().len() {
+        let len = PackedDocIdsOnly::decode_group(&mut cursor, base, &mut group)
+            .expect("to decode a packed group");
+        for doc_id in &group[..len] {
+            assert_eq!(*doc_id, expected_id);
+            expected_id += 1;
+        }
+        base = group[len - 1];
+    }
+    assert_eq!(expected_id, GROUP_LEN as DocId * 2 + 4);
+}
+
+/// Readers and GC both need the entry ordinals to stay in sync with the groups of a block.
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_inverted_index_packed_doc_ids_gc() {
+    let mut ii = InvertedIndex::<PackedDocIdsOnly>::new(IndexFlags_Index_DocIdsOnly);
+
+    // Mix small and large gaps so groups get re-packed at wider widths as they fill up.
+    let ids: Vec<DocId> = (0..3_200)
+        .scan(0, |id, i| {
+            *id += if i % 97 == 0 { 1 << 20 } else { 1 + i % 7 };
+            Some(*id)
+        })
+        .collect();
+    for id in &ids {
+        ii.add_record(&RSIndexResult::build_virt().doc_id(*id).build())
+            .unwrap();
+    }
+
+    assert_eq!(ii.unique_docs(), 3_200);
+
+    // Verify all documents can be read
+    {
+        let mut reader = ii.reader();
+        let mut result = RSIndexResult::build_virt().build();
+
+        for expected_id in &ids {
+            let found = reader.next_record(&mut result).unwrap();
+            assert!(found, "expected to find doc_id {}", expected_id);
+            assert_eq!(result.doc_id, *expected_id);
+        }
+
+        assert!(!reader.next_record(&mut result).unwrap(), "no more records");
+    }
+
+    // Verify every other document can be reached with seek
+    {
+        let mut reader = ii.reader();
+        let mut result = RSIndexResult::build_virt().build();
+
+        for expected_id in ids.iter().step_by(2) {
+            let found = reader.seek_record(*expected_id, &mut result).unwrap();
+            assert!(found, "expected to find doc_id {}", expected_id);
+            assert_eq!(result.doc_id, *expected_id);
+        }
+    }
+
+    // Test GC: Remove every third document
+    let delta = ii
+        .scan_gc(
+            |doc_id| ids.binary_search(&doc_id).unwrap() % 3 != 0,
+            None::<fn(&RSIndexResult, &inverted_index::RepairContext<'_>)>,
+        )
+        .expect("scan_gc should not fail for valid index")
+        .expect("scan_gc should return Some delta when entries are removed");
+    let apply_info = ii.apply_gc(delta);
+
+    let remaining: Vec<DocId> = ids
+        .iter()
+        .enumerate()
+        .filter(|(i, _)| i % 3 != 0)
+        .map(|(_, id)| *id)
+        .collect();
+    assert_eq!(apply_info.entries_removed, ids.len() - remaining.len());
+    assert_eq!(ii.unique_docs() as usize, remaining.len());
+
+    // Verify remaining documents can be read
+    {
+        let mut reader = ii.reader();
+        let mut result = RSIndexResult::build_virt().build();
+
+        for expected_id in &remaining {
+            let found = reader.next_record(&mut result).unwrap();
+            assert!(found, "expected to find doc_id {}", expected_id);
+            assert_eq!(result.doc_id, *expected_id);
+        }
+
+        assert!(!reader.next_record(&mut result).unwrap(), "no more records");
+    }
+
+    // Test GC: Remove all remaining records
+    let delta = ii
+        .scan_gc(
+            |_| false,
+            None::<fn(&RSIndexResult, &inverted_index::RepairContext<'_>)>,
+        )
+        .expect("scan_gc should not fail for valid index")
+        .expect("scan_gc should return Some delta when entries are removed");
+    let apply_info = ii.apply_gc(delta);
+
+    assert_eq!(apply_info.entries_removed, remaining.len());
+    assert_eq!(ii.unique_docs(), 0);
+    assert_eq!(ii.number_of_blocks(), 0);
+}
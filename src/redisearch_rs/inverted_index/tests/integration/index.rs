@@ -9,7 +9,11 @@
 
 use ffi::IndexFlags_Index_DocIdsOnly;
 use index_result::RSIndexResult;
-use inverted_index::{IndexReader, InvertedIndex, doc_ids_only::DocIdsOnly};
+use inverted_index::{
+    Decoder, DocIdsDecoder, Encoder, IndexReader, InvertedIndex,
+    bitmap_doc_ids_only::BitmapDocIdsOnly, doc_ids_only::DocIdsOnly,
+    packed_doc_ids_only::PackedDocIdsOnly, raw_doc_ids_only::RawDocIdsOnly,
+};
 use rqe_core::DocId;
 
 #[test]
@@ -169,3 +173,66 @@ fn test_inverted_index_usage() {
         assert!(!reader.next_record(&mut result).unwrap(), "no more records");
     }
 }
+
+fn check_block_doc_ids<E: Encoder + Decoder + DocIdsDecoder>() {
+    let mut ii = InvertedIndex::<E>::new(IndexFlags_Index_DocIdsOnly);
+    let ids: Vec<DocId> = (1..=5_000).map(|i| i * 3).collect();
+    for id in &ids {
+        ii.add_record(&RSIndexResult::build_virt().doc_id(*id).build())
+            .unwrap();
+    }
+    assert!(ii.number_of_blocks() > 1);
+
+    let mut reader = ii.reader();
+    let mut block = Vec::new();
+
+    // Walking the blocks yields every document, in order.
+    let mut decoded = Vec::new();
+    let mut next = 0;
+    while reader.block_doc_ids(next, &mut block).unwrap() {
+        assert!(block.last().is_some_and(|last| *last >= next));
+        decoded.extend_from_slice(&block);
+        next = block.last().unwrap() + 1;
+    }
+    assert_eq!(decoded, ids);
+    assert!(block.is_empty());
+
+    // A document without a posting gives the block of the next one.
+    assert!(reader.block_doc_ids(ids[1_500] + 1, &mut block).unwrap());
+    assert!(block.contains(&ids[1_501]));
+
+    // The reader does not move.
+    let mut result = RSIndexResult::build_virt().build();
+    assert!(reader.next_record(&mut result).unwrap());
+    assert_eq!(result.doc_id, ids[0]);
+
+    // Blocks behind the reader are not looked at.
+    reader.skip_to(ids[4_000]);
+    assert!(reader.block_doc_ids(0, &mut block).unwrap());
+    assert!(block.contains(&ids[4_000]));
+    assert!(!block.contains(&ids[0]));
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_block_doc_ids_doc_ids_only() {
+    check_block_doc_ids::<DocIdsOnly>();
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_block_doc_ids_raw_doc_ids_only() {
+    check_block_doc_ids::<RawDocIdsOnly>();
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_block_doc_ids_packed_doc_ids_only() {
+    check_block_doc_ids::<PackedDocIdsOnly>();
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn test_block_doc_ids_bitmap_doc_ids_only() {
+    check_block_doc_ids::<BitmapDocIdsOnly>();
+}
@@ -60,6 +60,12 @@ fn benchmark_raw_doc_ids_only(c: &mut Criterion) {
     bencher.decoding(c);
 }
 
+fn benchmark_packed_doc_ids_only(c: &mut Criterion) {
+    let bencher = benchers::packed_doc_ids_only::Bencher::default();
+    bencher.encoding(c);
+    bencher.decoding(c);
+}
+
 fn benchmark_full(c: &mut Criterion) {
     let bencher = benchers::full::Bencher::default();
     bencher.encoding(c);
@@ -101,6 +107,7 @@ criterion_group!(
         benchmark_fields_only,
         benchmark_doc_ids_only,
         benchmark_raw_doc_ids_only,
+        benchmark_packed_doc_ids_only,
         benchmark_full,
         benchmark_fields_offsets,
         benchmark_offsets_only,
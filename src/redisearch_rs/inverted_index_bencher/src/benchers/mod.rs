@@ -16,4 +16,5 @@ pub mod freqs_only;
 pub mod full;
 pub mod numeric;
 pub mod offsets_only;
+pub mod packed_doc_ids_only;
 pub mod raw_doc_ids_only;
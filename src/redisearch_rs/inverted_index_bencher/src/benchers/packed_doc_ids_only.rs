@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+use std::{hint::black_box, io::Cursor};
+
+use criterion::{BatchSize, Criterion};
+use ffi::IndexFlags_Index_DocIdsOnly;
+use index_result::RSIndexResult;
+use inverted_index::{
+    Decoder, Encoder, InvertedIndex,
+    packed_doc_ids_only::{GROUP_LEN, PackedDocIdsOnly},
+};
+use rqe_core::DocId;
+
+pub struct Bencher {
+    doc_ids: Vec<DocId>,
+    first_doc_id: DocId,
+    encoded: Vec<u8>,
+}
+
+impl Default for Bencher {
+    fn default() -> Self {
+        Bencher::new()
+    }
+}
+
+impl Bencher {
+    fn new() -> Self {
+        // A full block of postings with small gaps and the occasional large one.
+        let doc_ids: Vec<DocId> = (0..PackedDocIdsOnly::RECOMMENDED_BLOCK_ENTRIES as DocId)
+            .scan(100, |id, i| {
+                *id += if i % 100 == 99 { 70_000 } else { 1 + i % 5 };
+                Some(*id)
+            })
+            .collect();
+
+        let mut ii = InvertedIndex::<PackedDocIdsOnly>::new(IndexFlags_Index_DocIdsOnly);
+        for doc_id in &doc_ids {
+            ii.add_record(&RSIndexResult::build_term().doc_id(*doc_id).build())
+                .unwrap();
+        }
+        let block = ii.block_ref(0).unwrap();
+
+        Self {
+            first_doc_id: block.first_block_id(),
+            encoded: block.data().to_vec(),
+            doc_ids,
+        }
+    }
+
+    pub fn encoding(&self, c: &mut Criterion) {
+        c.bench_function("Encode PackedDocIdsOnly", |b| {
+            b.iter_batched_ref(
+                || InvertedIndex::<PackedDocIdsOnly>::new(IndexFlags_Index_DocIdsOnly),
+                |ii| {
+                    for doc_id in &self.doc_ids {
+                        let record = RSIndexResult::build_term().doc_id(*doc_id).build();
+                        let outcome = ii.add_record(&record).unwrap();
+
+                        black_box(outcome);
+                    }
+                },
+                BatchSize::SmallInput,
+            );
+        });
+    }
+
+    pub fn decoding(&self, c: &mut Criterion) {
+        c.bench_function("Decode PackedDocIdsOnly", |b| {
+            b.iter_batched_ref(
+                || {
+                    (
+                        Cursor::new(self.encoded.as_ref()),
+                        RSIndexResult::build_term().build(),
+                    )
+                },
+                |(cursor, result)| {
+                    let mut base = self.first_doc_id;
+                    for ordinal in 0..self.doc_ids.len() {
+                        PackedDocIdsOnly::decode_entry(cursor, base, ordinal as u16, result)
+                            .unwrap();
+                        base = result.doc_id;
+                    }
+
+                    black_box(base);
+                },
+                BatchSize::SmallInput,
+            );
+        });
+
+        c.bench_function("Decode PackedDocIdsOnly groups", |b| {
+            b.iter_batched_ref(
+                || (Cursor::new(self.encoded.as_ref()), [0; GROUP_LEN]),
+                |(cursor, group)| {
+                    let mut base = self.first_doc_id;
+                    while (cursor.position() as usize) < self.encoded.len() {
+                        let len = PackedDocIdsOnly::decode_group(cursor, base, group).unwrap();
+                        base = group[len - 1];
+                    }
+
+                    black_box(base);
+                },
+                BatchSize::SmallInput,
+            );
+        });
+    }
+}
@@ -217,7 +217,7 @@ impl NumericRangeTree {
                 {
                     let outcome =
                         range.add_without_cardinality(doc_id, value, has_field_expiration);
-                    rv.size_delta += outcome.mem_growth as i64;
+                    rv.size_delta += outcome.mem_growth as i64 - outcome.mem_released as i64;
                     rv.block_count_delta += outcome.blocks_added as i32;
                     rv.num_records_delta += 1;
                 }
@@ -255,7 +255,7 @@ impl NumericRangeTree {
 
                 let outcome = leaf.range.add(doc_id, value, has_field_expiration);
                 let mut rv = AddResult {
-                    size_delta: outcome.mem_growth as i64,
+                    size_delta: outcome.mem_growth as i64 - outcome.mem_released as i64,
                     num_records_delta: 1,
                     changed: false,
                     num_ranges_delta: 0,
@@ -368,7 +368,7 @@ impl NumericRangeTree {
                 // Preserve the decoded entry's field-expiration bit across the split.
                 let outcome =
                     target_range.add(result.doc_id, entry_value, result.has_field_expiration);
-                rv.size_delta += outcome.mem_growth as i64;
+                rv.size_delta += outcome.mem_growth as i64 - outcome.mem_released as i64;
                 rv.block_count_delta += outcome.blocks_added as i32;
             }
             rv.num_records_delta += 1;
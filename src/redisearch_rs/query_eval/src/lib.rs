@@ -12,7 +12,7 @@
 //!
 //! [`eval_node`] converts a parsed query AST node into an executable iterator
 //! tree by dispatching on the
-//! [`QueryNodeType`](query_types::QueryNodeType) discriminant. Each node type is
+//! [`QueryNodeType`] discriminant. Each node type is
 //! evaluated by its own module — [`token`] for `QN_TOKEN`, [`union`] for
 //! `QN_UNION`, and so on — mirroring the per-node-type layout of this crate's
 //! integration tests. This module keeps what they share: the evaluator
@@ -23,7 +23,7 @@
 
 use std::ptr::NonNull;
 
-use query_types::{QueryNodeOptions, scorers::slop_forces_offsets};
+use query_types::{QueryNodeOptions, QueryNodeType, scorers::slop_forces_offsets};
 use rqe_iterators::{
     Empty, RQEIteratorPrintable, c2rust::CRQEIterator, interop::RQEIteratorWrapper,
 };
@@ -160,11 +160,18 @@ impl<'index> Evaluated<'index> {
 ///
 /// The `root` node is evaluated via [`eval_node`]. When evaluation yields no
 /// iterator (`None`), an [`Empty`] iterator is returned.
+///
+/// A root union of terms in a top-k query is the one exception: it is
+/// evaluated by [`union::eval_block_max_wand`], as only the root knows that its
+/// score is all the sorter ranks by.
 pub fn qast_iterate<'index>(
     ctx: &'index mut QueryEvalContext,
     root: QueryNodeMut<'_>,
     config: Config,
 ) -> Evaluated<'index> {
+    if union::block_max_wand_applies(ctx, &root, config) {
+        return union::eval_block_max_wand(ctx, root);
+    }
     eval_node(ctx, root, config).unwrap_or_else(|| Evaluated::RustLeaf(Box::new(Empty)))
 }
 
@@ -184,6 +191,13 @@ pub fn eval_node<'index>(
     node: QueryNodeMut<'_>,
     config: Config,
 ) -> Option<Evaluated<'index>> {
+    if matches!(
+        node.node_type(),
+        QueryNodeType::Numeric | QueryNodeType::Geo
+    ) && let Some(it) = eval_cached_filter(ctx, &node, config)
+    {
+        return Some(Evaluated::C(it));
+    }
     match node.as_enum() {
         QueryNode::Null => Some(null::eval()),
         QueryNode::Wildcard => Some(wildcard::eval(ctx, &node)),
@@ -234,6 +248,29 @@ fn eval_node_c<'index>(
     NonNull::new(it).map(Evaluated::C)
 }
 
+/// Serve a filter node from the index filter cache via the C
+/// [`ffi::Query_EvalCachedFilter`], returning its owning C iterator.
+///
+/// Returns `None` when the cache does not apply to the node, for the caller to
+/// evaluate it as usual. When the cache evaluates the node itself to fill an
+/// entry, it calls back into [`eval_node`], which then gets `None` here.
+fn eval_cached_filter(
+    ctx: &mut QueryEvalContext,
+    node: &QueryNodeMut<'_>,
+    config: Config,
+) -> Option<NonNull<ffi::QueryIterator>> {
+    let q = ctx.as_non_null().as_ptr();
+    let n = node.as_non_null().as_ptr();
+    let config = (&raw const config).cast::<ffi::EvalConfig>();
+    // SAFETY: `q` comes from a live `QueryEvalContext` (a valid `QueryEvalCtx`
+    // with exclusive access, since `ctx` is `&mut`) and `n` from a live
+    // `QueryNodeMut`. Numeric and geo filter nodes are only read by the cache,
+    // and by their own evaluation when it fills an entry. `config` points to a
+    // live `Config` valid for the duration of the call.
+    let it = unsafe { ffi::Query_EvalCachedFilter(q, n, config) };
+    NonNull::new(it)
+}
+
 /// Evaluate a child node into an owning [`CRQEIterator`] for use as a child of
 /// a Rust compound iterator.
 ///
@@ -50,7 +50,8 @@ pub(crate) fn eval<'index>(
     // 3. `spec.missingFieldDict` is a non-null, valid dict — initialised by
     //    `IndexSpec_MakeKeyless` for every queryable spec; it is also the dict
     //    we just fetched `ii_ptr` from above.
-    // 4. `ii_ref` uses `DocIdsOnly`/`RawDocIdsOnly` encoding: the indexer only
-    //    ever stores doc-ids-only inverted indexes in `missingFieldDict`.
+    // 4. `ii_ref` uses `DocIdsOnly`/`RawDocIdsOnly`/`PackedDocIdsOnly`/`BitmapDocIdsOnly` encoding:
+    //    the indexer only ever stores doc-ids-only inverted indexes in
+    //    `missingFieldDict`.
     Some(unsafe { new_missing_iterator(ii_ref, sctx_nn, fs.index) })
 }
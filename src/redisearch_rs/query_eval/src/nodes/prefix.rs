@@ -11,7 +11,7 @@
 
 use std::ops::ControlFlow;
 
-use c_trie::{SuffixMode, SuffixTrie, TermsTrie};
+use c_trie::{NgramIndex, SuffixMode, SuffixTrie, TermsTrie};
 use query::WildcardMode;
 use query_error::QueryErrorCode;
 use query_types::QueryNodeType;
@@ -91,8 +91,10 @@ pub(crate) fn eval<'index>(
 
     let suffix_trie = ctx.spec().suffix;
     let suffix_mask = ctx.spec().suffixMask;
+    let ngrams = ctx.spec().ngrams;
+    let ngram_mask = ctx.spec().ngramMask;
     // SAFETY: the reference is confined to this evaluation — whichever of the
-    // two walks below answers the pattern — which the query, and so the spec
+    // walks below answers the pattern — which the query, and so the spec
     // owning the trie, outlives.
     let terms = unsafe { ctx.terms_trie() };
     // Enforce the search deadline unless timeout checks are disabled for this
@@ -111,23 +113,27 @@ pub(crate) fn eval<'index>(
         max_expansions: config.max_prefix_expansions,
     };
 
-    let children = if match_suffix && !suffix_trie.is_null() {
-        // The spec maintains a suffix trie for this pattern's fields: expand
-        // through it.
+    // A suffix or contains pattern is answered by the suffix trie, else by the
+    // ngram index, whichever covers every queried field.
+    let covers = |mask: FieldMask| {
+        node_field_mask == rqe_core::RS_FIELDMASK_ALL || (mask & node_field_mask) == node_field_mask
+    };
+
+    let children = if !match_suffix || (suffix_trie.is_null() && ngrams.is_null()) {
+        // Brute-force expansion over the primary terms trie.
+        expansion.expand_via_terms_trie(terms, &pattern, match_prefix, match_suffix, timeout)
+    } else if !suffix_trie.is_null() && covers(suffix_mask) {
         // SAFETY: `suffix_trie` is non-null (checked above) and is the spec's
         // suffix `Trie`, valid for and unmutated during the query.
         let suffix = unsafe { SuffixTrie::from_raw(suffix_trie) };
-        expansion.expand_via_suffix_trie(
-            suffix,
-            terms,
-            &pattern,
-            match_prefix,
-            node_field_mask,
-            suffix_mask,
-        )
+        expansion.expand_via_suffix_trie(suffix, terms, &pattern, match_prefix)
+    } else if !ngrams.is_null() && covers(ngram_mask) {
+        // SAFETY: `ngrams` is non-null (checked above) and is the spec's ngram
+        // index, valid for and unmutated during the query.
+        let ngrams = unsafe { NgramIndex::from_raw(ngrams) };
+        expansion.expand_via_ngram_index(ngrams, terms, &pattern, match_prefix, timeout)
     } else {
-        // Brute-force expansion over the primary terms trie.
-        expansion.expand_via_terms_trie(terms, &pattern, match_prefix, match_suffix, timeout)
+        expansion.unsupported_fields(suffix_trie.is_null())
     };
 
     // Prefix unions always take the quick-exit path — they only need the
@@ -165,29 +171,14 @@ impl Expansion<'_> {
     ///
     /// `suffix` wraps the spec's suffix trie and `terms` its primary terms trie.
     /// `contains` selects a contains (both-anchored) walk over a suffix
-    /// (end-anchored) one. When the queried fields are not all covered by the
-    /// suffix trie, a `Generic` error is set and no reader is returned.
+    /// (end-anchored) one.
     fn expand_via_suffix_trie(
         mut self,
         suffix: &SuffixTrie,
         terms: &TermsTrie,
         pattern: &[ffi::rune],
         contains: bool,
-        node_field_mask: FieldMask,
-        suffix_mask: FieldMask,
     ) -> Vec<CRQEIterator> {
-        // Use the suffix trie only when every queried field is covered by it,
-        // otherwise the contains query is unsupported.
-        let fields_supported = node_field_mask == rqe_core::RS_FIELDMASK_ALL
-            || (suffix_mask & node_field_mask) == node_field_mask;
-        if !fields_supported {
-            self.ctx.status().set_error(
-                QueryErrorCode::Generic,
-                "Contains query on fields without WITHSUFFIXTRIE support",
-            );
-            return self.children;
-        }
-
         let suffix_mode = if contains {
             SuffixMode::Contains
         } else {
@@ -214,6 +205,54 @@ impl Expansion<'_> {
         self.children
     }
 
+    /// Expand `pattern` through the spec's ngram index, returning one reader per
+    /// matching term.
+    ///
+    /// Arguments are as for [`expand_via_suffix_trie`](Self::expand_via_suffix_trie).
+    /// A pattern shorter than a trigram is declined by the index and expanded
+    /// over the primary terms trie instead, bounded by `timeout`.
+    fn expand_via_ngram_index(
+        mut self,
+        ngrams: &NgramIndex,
+        terms: &TermsTrie,
+        pattern: &[ffi::rune],
+        contains: bool,
+        timeout: Option<ffi::timespec>,
+    ) -> Vec<CRQEIterator> {
+        let suffix_mode = if contains {
+            SuffixMode::Contains
+        } else {
+            SuffixMode::Suffix
+        };
+
+        // As for the suffix trie, terms come back as key bytes without a count.
+        let on_term = |term_bytes: &[u8]| {
+            let num_docs = if self.is_disk {
+                terms.num_docs(term_bytes)
+            } else {
+                0
+            };
+            self.push_child(num_docs, term_bytes)
+        };
+        if ngrams.iterate_contains(pattern, suffix_mode, on_term) {
+            self.children
+        } else {
+            self.expand_via_terms_trie(terms, pattern, contains, true, timeout)
+        }
+    }
+
+    /// Report a suffix or contains pattern on fields that neither the suffix
+    /// trie nor the ngram index covers. No reader is returned.
+    fn unsupported_fields(mut self, ngrams_only: bool) -> Vec<CRQEIterator> {
+        let msg = if ngrams_only {
+            "Contains query on fields without WITHNGRAMS support"
+        } else {
+            "Contains query on fields without WITHSUFFIXTRIE support"
+        };
+        self.ctx.status().set_error(QueryErrorCode::Generic, msg);
+        self.children
+    }
+
     /// Brute-force expand `pattern` over the primary terms trie, returning one
     /// reader per matching term.
     ///
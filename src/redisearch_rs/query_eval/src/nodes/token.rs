@@ -15,7 +15,7 @@ use field::FieldMaskOrIndex;
 use query_term::RSQueryTerm;
 use query_types::QueryNodeOptions;
 use rqe_core::FieldMask;
-use rqe_iterators::build_term_iterator;
+use rqe_iterators::{FieldExpirationChecker, Term, TermIndexReader, build_term_iterator};
 use rs_token::RSTokenRef;
 use search_disk::SearchDiskHandle;
 
@@ -38,11 +38,7 @@ pub(crate) fn eval<'index>(
     let weight = opts.weight;
     // the node's field mask narrowed to the query's.
     let effective_field_mask = opts.field_mask & ctx.opts().fieldmask;
-    let token_id = ctx.next_token_id() as i32;
-    let term_bytes = tok.as_bytes();
-    // A `QN_TOKEN` node always carries a non-null term string.
-    debug_assert!(term_bytes.is_some(), "token string should not be null");
-    let term = RSQueryTerm::new_bytes(term_bytes.unwrap_or_default(), token_id, tok.flags());
+    let term = new_query_term(ctx, tok);
 
     // SAFETY: `ctx.spec().diskSpec` is either null or a valid
     // `RedisSearchDiskIndexSpec` that stays valid for `'index` (`QueryEvalContext`
@@ -60,23 +56,61 @@ pub(crate) fn eval<'index>(
             config,
         )
     } else {
-        open_term_reader(ctx, tok, term, weight, effective_field_mask)
+        open_term(ctx, tok, term, weight, effective_field_mask)
+            .map(|iter| Evaluated::RustLeaf(Box::new(iter)))
     }
 }
 
+/// Open the in-memory term iterator of a `QN_TOKEN` node as a concrete [`Term`],
+/// for callers that combine term iterators directly rather than through
+/// [`Evaluated`] children.
+///
+/// Allocates the node's token id exactly like [`eval`], so the two can be used
+/// interchangeably on a query's tokens. Returns `None` when the term has no
+/// matching inverted index.
+///
+/// The spec must not be on disk, and the iterator must not outlive the query
+/// `ctx` evaluates.
+pub(crate) fn eval_term<'index>(
+    ctx: &mut QueryEvalContext,
+    node: &QueryNodeRef,
+    tok: RSTokenRef,
+) -> Option<Term<'index, TermIndexReader<'index>, FieldExpirationChecker>> {
+    debug_assert!(
+        ctx.spec().diskSpec.is_null(),
+        "disk specs have no in-memory term index"
+    );
+    let opts = node.opts();
+    let effective_field_mask = opts.field_mask & ctx.opts().fieldmask;
+    let term = new_query_term(ctx, tok);
+    open_term(ctx, tok, term, opts.weight, effective_field_mask)
+}
+
+/// Allocate the next token id of the query and build the query term of `tok` with it.
+fn new_query_term(ctx: &mut QueryEvalContext, tok: RSTokenRef) -> Box<RSQueryTerm> {
+    let token_id = ctx.next_token_id() as i32;
+    let term_bytes = tok.as_bytes();
+    // A `QN_TOKEN` node always carries a non-null term string.
+    debug_assert!(term_bytes.is_some(), "token string should not be null");
+    RSQueryTerm::new_bytes(term_bytes.unwrap_or_default(), token_id, tok.flags())
+}
+
 /// Open an in-memory term reader for a `QN_TOKEN` node.
 ///
 /// Opens and validates the term's inverted index and, on success, wraps it in a
 /// term iterator that takes ownership of `term`. Returns `None` when the term
 /// has no matching inverted index (absent, empty, or no results in the queried
 /// field(s)), dropping `term`.
-fn open_term_reader<'index>(
-    ctx: &'index mut QueryEvalContext,
+///
+/// The iterator must not outlive the query `ctx` evaluates, which is what keeps
+/// the index it reads alive.
+fn open_term<'index>(
+    ctx: &mut QueryEvalContext,
     tok: RSTokenRef,
     term: Box<RSQueryTerm>,
     weight: f64,
     effective_field_mask: FieldMask,
-) -> Option<Evaluated<'index>> {
+) -> Option<Term<'index, TermIndexReader<'index>, FieldExpirationChecker>> {
     debug_assert!(!ctx.sctx_ptr().is_null(), "sctx must not be null");
 
     // Open and validate the term's inverted index. A null result means the term
@@ -92,8 +126,9 @@ fn open_term_reader<'index>(
     // SAFETY: `ctx.sctx_ptr()` is non-null (`QueryEvalContext` invariant 2).
     let sctx = unsafe { NonNull::new_unchecked(ctx.sctx_ptr().cast_mut()) };
     // SAFETY: `idx` is the term's inverted index just opened for this spec and
-    // stays valid for `'index` (`QueryEvalContext` invariants 1/2); `sctx` and its
-    // spec are valid for `'index` (invariant 2); `term` is a freshly
+    // stays valid for the query (`QueryEvalContext` invariants 1/2), which our
+    // caller keeps `'index` within; `sctx` and its spec are valid for as long
+    // (invariant 2); `term` is a freshly
     // heap-allocated query term whose ownership transfers to the iterator.
     let iter = unsafe {
         build_term_iterator(
@@ -105,7 +140,7 @@ fn open_term_reader<'index>(
         )
     };
 
-    Some(Evaluated::RustLeaf(Box::new(iter)))
+    Some(iter)
 }
 
 /// Search-on-disk evaluation of a `QN_TOKEN` node.
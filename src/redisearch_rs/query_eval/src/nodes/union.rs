@@ -9,9 +9,15 @@
 
 //! Evaluation of `QN_UNION` query nodes.
 
-use rqe_iterators::{c2rust::CRQEIterator, union_opaque::build_union};
+use query_types::QueryNodeType;
+use rqe_iterators::{BlockMaxWand, c2rust::CRQEIterator, union_opaque::build_union};
 
-use crate::{Config, Evaluated, QueryEvalContext, QueryNodeMut, eval_child_iterator};
+use super::token;
+use crate::{
+    Config, Evaluated, QueryEvalContext, QueryNode, QueryNodeMut, QueryNodeRef,
+    eval_child_iterator,
+    scorers::{BuiltInScorer, RequestedScorer},
+};
 
 /// `QN_UNION` — a logical OR over its children (matches any document matched by
 /// at least one child).
@@ -56,3 +62,78 @@ pub(crate) fn eval<'index>(
 
     Evaluated::RustCompound(iter)
 }
+
+/// Whether `node`, the root of the query, may be evaluated with
+/// [`eval_block_max_wand`].
+///
+/// That takes a union of plain terms whose score matters, ranked by `BM25STD`
+/// in a request whose sorter exposes its score threshold (see
+/// [`QueryEvalContext::score_threshold`]).
+pub(crate) fn block_max_wand_applies(
+    ctx: &QueryEvalContext,
+    node: &QueryNodeRef,
+    config: Config,
+) -> bool {
+    let scorer = match ctx.scorer() {
+        RequestedScorer::Unset => config.default_scorer,
+        RequestedScorer::Custom(_) => None,
+        RequestedScorer::BuiltIn(scorer) => Some(scorer),
+    };
+    node.node_type() == QueryNodeType::Union
+        && scorer == Some(BuiltInScorer::Bm25Std)
+        && !ctx.in_not_sub_tree()
+        && node.opts().weight > 0.0
+        && ctx.spec().diskSpec.is_null()
+        && node
+            .children()
+            .all(|child| child.node_type() == QueryNodeType::Token)
+        // SAFETY: the threshold is only checked for, not read.
+        && unsafe { ctx.score_threshold() }.is_some()
+}
+
+/// `QN_UNION` at the root of a top-k query — a logical OR over term children
+/// which skips the documents that cannot make it into the results.
+///
+/// Each child is opened as a term iterator, after intersecting its field mask
+/// with the union node's own as [`eval`] does, and combined with a
+/// [`BlockMaxWand`] iterator. Only valid when [`block_max_wand_applies`].
+pub(crate) fn eval_block_max_wand<'index>(
+    ctx: &'index mut QueryEvalContext,
+    mut node: QueryNodeMut<'_>,
+) -> Evaluated<'index> {
+    // SAFETY: the threshold belongs to the request running the query, which
+    // outlives every iterator built for it.
+    let threshold = unsafe { ctx.score_threshold() }
+        .expect("block-max WAND is only used with a score threshold");
+    // The same average the scorer computes from the spec's stats.
+    let scoring = &ctx.spec().stats.scoring;
+    let avg_doc_len = if scoring.numDocuments > 0 {
+        scoring.totalDocsLen as f64 / scoring.numDocuments as f64
+    } else {
+        0.0
+    };
+
+    let num_children = node.num_children();
+    let node_mask = node.opts().field_mask;
+    let weight = node.opts().weight;
+
+    // A term without an inverted index matches nothing, so it is left out, just
+    // like the union drops its empty children.
+    let children = (0..num_children)
+        .filter_map(|i| {
+            let mut child = node.child_mut(i);
+            child.and_field_mask(node_mask);
+            let QueryNode::Token { tok } = child.as_enum() else {
+                unreachable!("block-max WAND children are all tokens");
+            };
+            token::eval_term(ctx, &child, tok)
+        })
+        .collect();
+
+    Evaluated::RustLeaf(Box::new(BlockMaxWand::new(
+        children,
+        weight,
+        avg_doc_len,
+        threshold,
+    )))
+}
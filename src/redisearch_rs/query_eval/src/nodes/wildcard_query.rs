@@ -11,7 +11,7 @@
 
 use std::ops::ControlFlow;
 
-use c_trie::{LoweredPattern, SuffixTrie, SuffixWalk, TermsTrie};
+use c_trie::{LoweredPattern, NgramIndex, SuffixTrie, SuffixWalk, TermsTrie};
 use query_error::QueryErrorCode;
 use query_types::QueryNodeType;
 use rqe_iterators::union_opaque::build_union_with_q_str;
@@ -80,6 +80,8 @@ pub(crate) fn eval<'index>(
 
     let suffix_trie = ctx.spec().suffix;
     let suffix_mask = ctx.spec().suffixMask;
+    let ngrams = ctx.spec().ngrams;
+    let ngram_mask = ctx.spec().ngramMask;
     // SAFETY: the reference is confined to this evaluation — the suffix-trie
     // walk and the terms-trie fallback below — which the query, and so the spec
     // owning the trie, outlives.
@@ -98,19 +100,29 @@ pub(crate) fn eval<'index>(
         max_expansions: config.max_prefix_expansions,
     };
 
-    // A spec with a suffix trie may only answer a pattern when every queried field
-    // is covered by it. An unsupported field set is an error that does *not* fall
-    // back to a walk — it yields an empty union — and it is reported for any
-    // pattern, so it is decided before the empty-pattern case below.
-    let fields_unsupported = !suffix_trie.is_null()
-        && node_field_mask != rqe_core::RS_FIELDMASK_ALL
-        && (suffix_mask & node_field_mask) != node_field_mask;
+    // A spec with a suffix trie or an ngram index may only answer a pattern when
+    // every queried field is covered by one of them, the suffix trie first. An
+    // unsupported field set is an error that does *not* fall back to a walk — it
+    // yields an empty union — and it is reported for any pattern, so it is
+    // decided before the empty-pattern case below.
+    let covers = |mask| {
+        node_field_mask == rqe_core::RS_FIELDMASK_ALL || (mask & node_field_mask) == node_field_mask
+    };
+    let use_suffix_trie = !suffix_trie.is_null() && covers(suffix_mask);
+    let use_ngrams = !use_suffix_trie && !ngrams.is_null() && covers(ngram_mask);
+    let fields_unsupported =
+        (!suffix_trie.is_null() || !ngrams.is_null()) && !use_suffix_trie && !use_ngrams;
 
     if fields_unsupported {
-        expansion.ctx.status().set_error(
-            QueryErrorCode::Generic,
-            "Contains query on fields without WITHSUFFIXTRIE support",
-        );
+        let msg = if suffix_trie.is_null() {
+            "Contains query on fields without WITHNGRAMS support"
+        } else {
+            "Contains query on fields without WITHSUFFIXTRIE support"
+        };
+        expansion
+            .ctx
+            .status()
+            .set_error(QueryErrorCode::Generic, msg);
     } else if pattern.is_empty() {
         // A pattern that lowercases to nothing wildcard-matches exactly the empty
         // term, which neither walk below can find: a zero-length key is refused on
@@ -123,15 +135,14 @@ pub(crate) fn eval<'index>(
         // scored as one never seen whatever its inverted index holds.
         let _ = expansion.push_child(0, b"");
     } else if let Some(pattern) = LoweredPattern::new(&pattern) {
-        // The suffix trie is preferred whenever the spec has one; the brute-force
-        // terms-trie scan is the fallback for a pattern it has no literal run to
-        // anchor on.
+        // The suffix trie, else the ngram index, is preferred whenever the spec
+        // has one; the brute-force terms-trie scan is the fallback for a pattern
+        // it has no literal run to anchor on.
         //
         // Carries the pattern while it is still un-walked; `None` once a walk has
         // consumed it.
         let mut brute_force = Some(pattern);
-        if !suffix_trie.is_null() {
-            // Reached only with the fields supported, ruled on above.
+        if use_suffix_trie {
             let pattern = brute_force
                 .take()
                 .expect("the pattern is un-walked on the first walk");
@@ -148,6 +159,18 @@ pub(crate) fn eval<'index>(
                     // brute-force scan below has to answer it instead.
                     SuffixWalk::NoAnchor(pattern) => Some(pattern),
                 };
+        } else if use_ngrams {
+            let pattern = brute_force
+                .take()
+                .expect("the pattern is un-walked on the first walk");
+            // SAFETY: `ngrams` is non-null (checked above) and is the spec's ngram
+            // index, valid for and unmutated during the query.
+            let ngrams = unsafe { NgramIndex::from_raw(ngrams) };
+            brute_force =
+                match expansion.expand_wildcard_via_ngram_index(ngrams, terms, pattern, timeout) {
+                    SuffixWalk::Walked => None,
+                    SuffixWalk::NoAnchor(pattern) => Some(pattern),
+                };
         }
         if let Some(pattern) = brute_force {
             expansion.expand_wildcard_via_terms_trie(terms, &pattern, timeout);
@@ -229,6 +252,30 @@ impl Expansion<'_> {
         suffix.iterate_wildcard(pattern, timeout, on_term)
     }
 
+    /// Expand a wildcard `pattern` through the spec's ngram index, accumulating one
+    /// reader per matching term.
+    ///
+    /// As [`expand_wildcard_via_suffix_trie`](Self::expand_wildcard_via_suffix_trie),
+    /// except that each term is visited once, and that a pattern without a literal
+    /// run of a trigram is handed back.
+    fn expand_wildcard_via_ngram_index(
+        &mut self,
+        ngrams: &NgramIndex,
+        terms: &TermsTrie,
+        pattern: LoweredPattern,
+        timeout: Option<ffi::timespec>,
+    ) -> SuffixWalk {
+        let on_term = |term_bytes: &[u8]| {
+            let num_docs = if self.is_disk {
+                terms.num_docs(term_bytes)
+            } else {
+                0
+            };
+            self.push_child(num_docs, term_bytes)
+        };
+        ngrams.iterate_wildcard(pattern, timeout, on_term)
+    }
+
     /// Brute-force expand a wildcard `pattern` over the primary terms trie,
     /// accumulating one reader per matching term.
     ///
@@ -62,7 +62,9 @@ pub enum IteratorType {
     MetricLazySortedByScore = 22,
     /// Used only in tests.
     Mock = 23,
-    Max = 24,
+    /// Top-k union of term iterators skipping blocks that cannot reach the score threshold.
+    BlockMaxWand = 24,
+    Max = 25,
 }
 
 impl IteratorType {
@@ -87,7 +89,10 @@ impl IteratorType {
             | Self::MetricLazySortedByScore
             | Self::Profile
             | Self::GeoShape
-            | Self::Mock => true,
+            | Self::Mock
+            // Holds its term children by value and profiles them in place, so
+            // there is no `ProfileChildren` callback to reach them through.
+            | Self::BlockMaxWand => true,
 
             Self::Hybrid
             | Self::Union
@@ -129,6 +134,7 @@ impl IteratorType {
             Self::Optimus => "OPTIMUS",
             Self::GeoShape => "GEO_SHAPE",
             Self::Mock => "MOCK",
+            Self::BlockMaxWand => "BLOCK_MAX_WAND",
             Self::Max => "MAX",
         }
     }
@@ -169,7 +175,8 @@ impl TryFrom<u32> for IteratorType {
             21 => Ok(Self::MetricLazySortedById),
             22 => Ok(Self::MetricLazySortedByScore),
             23 => Ok(Self::Mock),
-            24 => Ok(Self::Max),
+            24 => Ok(Self::BlockMaxWand),
+            25 => Ok(Self::Max),
             other => Err(other),
         }
     }
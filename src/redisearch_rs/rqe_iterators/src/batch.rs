@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+//! Supporting types for [`RQEIterator::read_batch`].
+
+use ::inverted_index::FieldMask;
+use rqe_core::DocId;
+
+use crate::{RQEIterator, RQEIteratorError};
+
+/// A caller-provided buffer, filled by [`RQEIterator::read_batch`] with the document IDs of the
+/// next results and, if the caller asked for them, their field masks.
+///
+/// The Rust face of the C `IteratorBatch`.
+pub struct DocIdBatch<'a> {
+    doc_ids: &'a mut [DocId],
+    /// Same length as `doc_ids` when present.
+    field_masks: Option<&'a mut [FieldMask]>,
+    len: usize,
+}
+
+impl<'a> DocIdBatch<'a> {
+    /// Create an empty batch with room for `doc_ids.len()` entries.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `field_masks` is given with a different length than `doc_ids`.
+    pub fn new(doc_ids: &'a mut [DocId], field_masks: Option<&'a mut [FieldMask]>) -> Self {
+        if let Some(field_masks) = &field_masks {
+            assert_eq!(
+                field_masks.len(),
+                doc_ids.len(),
+                "a batch needs a field mask slot per document ID slot"
+            );
+        }
+        Self {
+            doc_ids,
+            field_masks,
+            len: 0,
+        }
+    }
+
+    /// Returns the number of entries appended so far.
+    pub const fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns `true` if no entry was appended yet.
+    pub const fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Returns the number of entries that can still be appended.
+    pub const fn remaining(&self) -> usize {
+        self.doc_ids.len() - self.len
+    }
+
+    /// Returns `true` if no more entries can be appended.
+    pub const fn is_full(&self) -> bool {
+        self.remaining() == 0
+    }
+
+    /// Returns `true` if the caller asked for the field mask of every entry.
+    pub const fn wants_field_masks(&self) -> bool {
+        self.field_masks.is_some()
+    }
+
+    /// Append an entry. `field_mask` is dropped unless the caller
+    /// [asked for it](Self::wants_field_masks).
+    ///
+    /// # Panics
+    ///
+    /// Panics if the batch [is full](Self::is_full).
+    #[inline(always)]
+    pub fn push(&mut self, doc_id: DocId, field_mask: FieldMask) {
+        self.doc_ids[self.len] = doc_id;
+        if let Some(field_masks) = &mut self.field_masks {
+            field_masks[self.len] = field_mask;
+        }
+        self.len += 1;
+    }
+
+    /// Append, in order and until the batch is full, `base + i` for every bit `i % 64` set in
+    /// `words[i / 64]`, stopping at the first ID above `max_doc_id`. Returns the last ID
+    /// appended, if any.
+    pub(crate) fn push_words(
+        &mut self,
+        base: DocId,
+        words: &[u64],
+        max_doc_id: DocId,
+        field_mask: FieldMask,
+    ) -> Option<DocId> {
+        let mut last = None;
+        for (i, &word) in words.iter().enumerate() {
+            let mut word = word;
+            while word != 0 {
+                if self.is_full() {
+                    return last;
+                }
+                let doc_id = base + (64 * i) as DocId + DocId::from(word.trailing_zeros());
+                if doc_id > max_doc_id {
+                    return last;
+                }
+                self.push(doc_id, field_mask);
+                last = Some(doc_id);
+                word &= word - 1;
+            }
+        }
+        last
+    }
+
+    /// Returns the document IDs appended so far.
+    pub fn doc_ids(&self) -> &[DocId] {
+        &self.doc_ids[..self.len]
+    }
+
+    /// Returns the field masks appended so far, if the caller asked for them.
+    pub fn field_masks(&self) -> Option<&[FieldMask]> {
+        self.field_masks.as_deref().map(|masks| &masks[..self.len])
+    }
+
+    /// Returns the unfilled part of the buffers, to be filled by a callee outside Rust.
+    pub(crate) fn unfilled_mut(&mut self) -> (&mut [DocId], Option<&mut [FieldMask]>) {
+        let len = self.len;
+        (
+            &mut self.doc_ids[len..],
+            self.field_masks
+                .as_deref_mut()
+                .map(|masks| &mut masks[len..]),
+        )
+    }
+
+    /// Mark the first `n` unfilled entries as appended.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `n` exceeds the [remaining](Self::remaining) room.
+    pub(crate) fn advance(&mut self, n: usize) {
+        assert!(n <= self.remaining(), "advanced past the end of the batch");
+        self.len += n;
+    }
+}
+
+/// Number of 64-bit words the iterators combining [`RQEIterator::doc_ids_words`] fill at a time,
+/// i.e. a window of 4096 document IDs.
+pub(crate) const WINDOW_WORDS: usize = 64;
+
+/// Fill `batch` one [`read`](RQEIterator::read) at a time.
+///
+/// The default [`RQEIterator::read_batch`], exposed for implementations that only have a
+/// faster path in some configurations.
+pub fn read_batch_by_reads<'index, I>(
+    it: &mut I,
+    batch: &mut DocIdBatch<'_>,
+) -> Result<(), RQEIteratorError>
+where
+    I: RQEIterator<'index> + ?Sized,
+{
+    while !batch.is_full() {
+        let Some(result) = it.read()? else {
+            break;
+        };
+        batch.push(result.doc_id, result.field_mask);
+    }
+    Ok(())
+}
@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+//! Block-max WAND union iterator for top-k scored queries.
+//!
+//! # Background
+//!
+//! A plain union yields every document matched by any of its children, and the
+//! sorter scores each one only to throw most of them away once its top-k heap
+//! is full. When the query ranks by `BM25STD`, the score a term can add to a
+//! document is bounded by the highest frequency and the shortest document
+//! length among the postings it is read from — both of which every
+//! [`IndexBlock`](inverted_index::IndexBlock) tracks as its [`ScoreBounds`].
+//!
+//! [`BlockMaxWand`] uses those bounds the way WAND and block-max WAND do:
+//!
+//! 1. Children are kept ordered by their current document. Walking them in that
+//!    order while summing each child's bound over its *whole* index finds the
+//!    *pivot*: the first document whose bound can reach the threshold. Every
+//!    document before it is matched only by children whose bounds together fall
+//!    short, so it is skipped.
+//! 2. The bounds of the *blocks* holding the pivot are then summed. When even
+//!    those fall short, every child up to the pivot is moved past the nearest
+//!    block end without decoding the documents in between.
+//!
+//! The threshold is the score of the worst result in the sorter's heap, read
+//! again before every decision, so pruning sharpens as better results come in.
+//! Documents tied with it are kept.
+//!
+//! # Scope
+//!
+//! Only the root union of a query may prune: a union below an intersection or
+//! any other compound iterator cannot tell how much its parent adds to a
+//! document's score. The bounds also assume a document score of at most 1, which
+//! holds unless the index takes scores from a `SCORE_FIELD`.
+
+use std::cell::Cell;
+
+use index_result::RSIndexResult;
+use index_spec::IndexSpecReadGuard;
+use inverted_index::{IndexReader, ScoreBounds, TermReader};
+use rqe_core::DocId;
+
+use crate::{
+    ExpirationChecker, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus,
+    SkipToOutcome, Term,
+    profile_print::{ProfilePrint, ProfilePrintCtx},
+};
+
+/// The `k1` term frequency saturation parameter of the `BM25STD` scorer.
+const BM25_K1: f64 = 1.2;
+/// The `b` document length normalization parameter of the `BM25STD` scorer.
+const BM25_B: f64 = 0.75;
+/// Relative slack added to every bound before comparing it to the threshold.
+/// The scorer mixes single and double precision, so a score can land slightly
+/// above the bound computed here.
+const BOUND_SLACK: f64 = 1e-5;
+
+/// An iterator whose results are scored as a single `BM25STD` term, and which
+/// can tell how high that score can get over the postings ahead of it.
+pub trait ScoreBoundedIterator<'index>: RQEIterator<'index> + ProfilePrint {
+    /// The factor every score of this iterator is scaled by: its weight times the
+    /// BM25 IDF of its term.
+    fn term_weight(&self) -> f64;
+
+    /// The bounds of the block holding the first posting at or after `doc_id`.
+    fn block_score_bounds(&self, doc_id: DocId) -> ScoreBounds;
+
+    /// The bounds covering every posting of the iterator.
+    fn index_score_bounds(&self) -> ScoreBounds;
+}
+
+impl<'index, R, E> ScoreBoundedIterator<'index> for Term<'index, R, E>
+where
+    R: TermReader<'index>,
+    E: ExpirationChecker,
+{
+    fn term_weight(&self) -> f64 {
+        self.weight() * self.query_term().bm25_idf()
+    }
+
+    fn block_score_bounds(&self, doc_id: DocId) -> ScoreBounds {
+        self.reader()
+            .block_score_bounds(doc_id)
+            .unwrap_or(ScoreBounds::UNBOUNDED)
+    }
+
+    fn index_score_bounds(&self) -> ScoreBounds {
+        self.reader()
+            .index_score_bounds()
+            .unwrap_or(ScoreBounds::UNBOUNDED)
+    }
+}
+
+/// The highest `BM25STD` term score, before weighting, of any posting covered by
+/// `bounds`.
+///
+/// The score grows with the frequency and shrinks with the document length, so
+/// it peaks at the highest frequency and shortest length of the postings.
+fn bm25_upper_bound(bounds: ScoreBounds, avg_doc_len: f64) -> f64 {
+    // As the frequency grows, the score tends to `k1 + 1` from below.
+    if bounds.max_freq == u32::MAX || avg_doc_len <= 0.0 {
+        return BM25_K1 + 1.0;
+    }
+    // Encodings without frequencies read every posting back with a frequency of one.
+    let f = bounds.max_freq.max(1) as f64;
+    let len_norm = 1.0 - BM25_B + BM25_B * bounds.min_doc_len as f64 / avg_doc_len;
+    f * (BM25_K1 + 1.0) / (f + BM25_K1 * len_norm)
+}
+
+/// Whether a document scoring up to `bound` can make it into the results.
+fn can_reach(bound: f64, threshold: f64) -> bool {
+    bound * (1.0 + BOUND_SLACK) >= threshold
+}
+
+/// A child of a [`BlockMaxWand`] with its scoring factor and whole-index bound.
+struct WandChild<I> {
+    /// Position of this child in the `children` vector passed to [`BlockMaxWand::new`].
+    original_index: usize,
+    /// The underlying child iterator.
+    it: I,
+    /// The child's [`ScoreBoundedIterator::term_weight`].
+    term_weight: f64,
+    /// The highest score the child can add to any document.
+    index_bound: f64,
+}
+
+/// Yields the documents of its children which can still make it into the
+/// top-k results, skipping the rest. See the [module documentation](self).
+///
+/// Every yielded document carries the same aggregate a full union would build
+/// for it, so scoring is unaffected.
+pub struct BlockMaxWand<'index, I> {
+    /// Child iterators. Active children are in `children[..num_active]`,
+    /// exhausted children are moved to the end and kept so the iterator can be rewound.
+    children: Vec<WandChild<I>>,
+    /// Number of active (non-EOF) children.
+    num_active: usize,
+    /// Sum of all children's estimated counts (upper bound).
+    num_estimated: usize,
+    /// Average document length of the index, as the scorer sees it.
+    avg_doc_len: f64,
+    /// The score a document has to reach, raised by the sorter as it fills up.
+    threshold: &'index Cell<f64>,
+    /// Whether the iterator has reached EOF (all children exhausted or pruned).
+    is_eof: bool,
+    /// Aggregate result combining children's results, reused to avoid allocations.
+    result: RSIndexResult<'index>,
+}
+
+impl<'index, I> BlockMaxWand<'index, I>
+where
+    I: ScoreBoundedIterator<'index>,
+{
+    /// Creates a new block-max WAND iterator over `children`, whose aggregate
+    /// results carry `weight`.
+    ///
+    /// `avg_doc_len` must be the average document length the scorer uses, and
+    /// `threshold` the score of the worst result the sorter currently keeps, or 0
+    /// until it keeps enough.
+    #[must_use]
+    pub fn new(
+        children: Vec<I>,
+        weight: f64,
+        avg_doc_len: f64,
+        threshold: &'index Cell<f64>,
+    ) -> Self {
+        let num_estimated = children.iter().map(|c| c.num_estimated()).sum();
+        let num_children = children.len();
+        let children = children
+            .into_iter()
+            .enumerate()
+            .map(|(original_index, it)| {
+                let term_weight = it.term_weight();
+                let index_bound =
+                    term_weight * bm25_upper_bound(it.index_score_bounds(), avg_doc_len);
+                WandChild {
+                    original_index,
+                    it,
+                    term_weight,
+                    index_bound,
+                }
+            })
+            .collect();
+
+        Self {
+            children,
+            num_active: num_children,
+            num_estimated,
+            avg_doc_len,
+            threshold,
+            is_eof: num_children == 0,
+            result: RSIndexResult::build_union(num_children)
+                .weight(weight)
+                .build(),
+        }
+    }
+
+    /// Returns the total number of children (including exhausted ones).
+    pub const fn num_children_total(&self) -> usize {
+        self.children.len()
+    }
+
+    /// Returns a shared reference to the child originally at insertion index `idx`,
+    /// or `None` if it was dropped during revalidation.
+    pub fn child_at(&self, idx: usize) -> Option<&I> {
+        self.children
+            .iter()
+            .find(|c| c.original_index == idx)
+            .map(|c| &c.it)
+    }
+
+    /// Moves exhausted children out of the active region.
+    fn drop_exhausted_children(&mut self) {
+        let mut i = 0;
+        while i < self.num_active {
+            if self.children[i].it.at_eof() {
+                self.num_active -= 1;
+                self.children.swap(i, self.num_active);
+            } else {
+                i += 1;
+            }
+        }
+    }
+
+    /// Moves every active child positioned before `doc_id` to its first document
+    /// at or after it.
+    fn skip_children_to(&mut self, doc_id: DocId) -> Result<(), RQEIteratorError> {
+        for child in &mut self.children[..self.num_active] {
+            if child.it.last_doc_id() < doc_id {
+                child.it.skip_to(doc_id)?;
+            }
+        }
+        self.drop_exhausted_children();
+        Ok(())
+    }
+
+    /// Finds the first document, at or after every child's current position,
+    /// which can reach the threshold. Returns `None` when no document left can.
+    ///
+    /// Every active child must already be positioned on a document.
+    fn next_candidate(&mut self) -> Result<Option<DocId>, RQEIteratorError> {
+        loop {
+            let threshold = self.threshold.get();
+            let weight = self.result.weight;
+            let active = &mut self.children[..self.num_active];
+            active.sort_unstable_by_key(|c| c.it.last_doc_id());
+
+            // The first child at which the children so far can reach the threshold.
+            let mut prefix_bound = 0.0;
+            let Some(mut pivot) = active.iter().position(|c| {
+                prefix_bound += c.index_bound;
+                can_reach(weight * prefix_bound, threshold)
+            }) else {
+                return Ok(None);
+            };
+            let pivot_doc = active[pivot].it.last_doc_id();
+            while active
+                .get(pivot + 1)
+                .is_some_and(|c| c.it.last_doc_id() == pivot_doc)
+            {
+                pivot += 1;
+            }
+
+            // Only the children up to the pivot can match documents before the
+            // next child's, so their blocks bound every document until then.
+            let mut block_bound = 0.0;
+            let mut next_doc = active
+                .get(pivot + 1)
+                .map_or(DocId::MAX, |c| c.it.last_doc_id());
+            for child in &active[..=pivot] {
+                let bounds = child.it.block_score_bounds(pivot_doc);
+                block_bound += child.term_weight * bm25_upper_bound(bounds, self.avg_doc_len);
+                next_doc = next_doc.min(bounds.last_doc_id.saturating_add(1));
+            }
+
+            if !can_reach(weight * block_bound, threshold) {
+                // Nothing before `next_doc` can make it, skip the blocks.
+                self.skip_children_to(next_doc)?;
+            } else if active[0].it.last_doc_id() == pivot_doc {
+                return Ok(Some(pivot_doc));
+            } else {
+                self.skip_children_to(pivot_doc)?;
+            }
+
+            if self.num_active == 0 {
+                return Ok(None);
+            }
+        }
+    }
+
+    /// Builds the result from active children whose `last_doc_id` equals `doc_id`.
+    fn build_aggregate_result(&mut self, doc_id: DocId) {
+        self.result.reset_aggregate();
+        self.result.doc_id = doc_id;
+
+        for child in &mut self.children[..self.num_active] {
+            if child.it.last_doc_id() == doc_id
+                && let Some(child_result) = child.it.current()
+            {
+                let drained_metrics = std::mem::take(&mut child_result.metrics);
+                let child_ptr: *const RSIndexResult<'index> = child_result;
+                // SAFETY: We need a raw pointer to decouple the borrow of the child's
+                // result from `&mut self.result`. This is sound because:
+                // 1. `self.children[i]` and `self.result` are disjoint fields — no aliasing.
+                // 2. The child is owned by `self`, so the 'index data remains valid.
+                let child_ref = unsafe { &*child_ptr };
+                self.result.push_borrowed(child_ref, drained_metrics);
+            }
+        }
+    }
+
+    /// Moves to the next candidate and publishes it, or marks the iterator at EOF.
+    fn advance(&mut self) -> Result<Option<DocId>, RQEIteratorError> {
+        match self.next_candidate()? {
+            Some(doc_id) => {
+                self.build_aggregate_result(doc_id);
+                Ok(Some(doc_id))
+            }
+            None => {
+                self.is_eof = true;
+                Ok(None)
+            }
+        }
+    }
+}
+
+impl<'index, I> RQEIterator<'index> for BlockMaxWand<'index, I>
+where
+    I: ScoreBoundedIterator<'index>,
+{
+    #[inline]
+    fn current(&mut self) -> Option<&mut RSIndexResult<'index>> {
+        (!self.is_eof).then_some(&mut self.result)
+    }
+
+    fn read(&mut self) -> Result<Option<&mut RSIndexResult<'index>>, RQEIteratorError> {
+        if self.is_eof {
+            return Ok(None);
+        }
+
+        // Move on from the document just returned. Before the first read that
+        // positions every child, as none is on a document yet.
+        let previous_id = self.last_doc_id();
+        for child in &mut self.children[..self.num_active] {
+            if child.it.last_doc_id() == previous_id && !child.it.at_eof() {
+                child.it.read()?;
+            }
+        }
+        self.drop_exhausted_children();
+
+        Ok(self.advance()?.map(|_| &mut self.result))
+    }
+
+    fn skip_to(
+        &mut self,
+        doc_id: DocId,
+    ) -> Result<Option<SkipToOutcome<'_, 'index>>, RQEIteratorError> {
+        if self.is_eof {
+            return Ok(None);
+        }
+
+        debug_assert!(self.last_doc_id() < doc_id);
+
+        self.skip_children_to(doc_id)?;
+        Ok(match self.advance()? {
+            Some(found) if found == doc_id => Some(SkipToOutcome::Found(&mut self.result)),
+            Some(_) => Some(SkipToOutcome::NotFound(&mut self.result)),
+            None => None,
+        })
+    }
+
+    fn rewind(&mut self) {
+        // Restore children to their original insertion order.
+        self.children.sort_unstable_by_key(|c| c.original_index);
+
+        self.num_active = self.children.len();
+        self.is_eof = self.children.is_empty();
+        self.result.reset_aggregate();
+        self.children.iter_mut().for_each(|c| c.it.rewind());
+    }
+
+    #[inline(always)]
+    fn num_estimated(&self) -> usize {
+        self.num_estimated
+    }
+
+    #[inline(always)]
+    fn last_doc_id(&self) -> DocId {
+        self.result.doc_id
+    }
+
+    #[inline(always)]
+    fn at_eof(&self) -> bool {
+        self.is_eof
+    }
+
+    fn revalidate(
+        &mut self,
+        spec: &IndexSpecReadGuard,
+    ) -> Result<RQEValidateStatus<'_, 'index>, RQEIteratorError> {
+        if self.is_eof {
+            return Ok(RQEValidateStatus::Ok);
+        }
+
+        let original_last_doc_id = self.last_doc_id();
+        let mut any_change = false;
+
+        // Revalidate every child, including exhausted ones, and remove aborted ones.
+        let mut i = 0;
+        while i < self.children.len() {
+            match self.children[i].it.revalidate(spec)? {
+                RQEValidateStatus::Aborted => {
+                    self.children.swap_remove(i);
+                    any_change = true;
+                }
+                RQEValidateStatus::Moved { .. } => {
+                    any_change = true;
+                    i += 1;
+                }
+                RQEValidateStatus::Ok => {
+                    i += 1;
+                }
+            }
+        }
+
+        if self.children.is_empty() {
+            self.is_eof = true;
+            return Ok(RQEValidateStatus::Aborted);
+        }
+
+        // Writes while the lock was released may have raised the bounds.
+        for child in &mut self.children {
+            child.index_bound = child.term_weight
+                * bm25_upper_bound(child.it.index_score_bounds(), self.avg_doc_len);
+        }
+
+        if !any_change {
+            return Ok(RQEValidateStatus::Ok);
+        }
+
+        // Children only move forward, so the union stays on the smallest document
+        // any of them is now on. It may no longer reach the threshold, which only
+        // costs the sorter one more result to discard.
+        self.num_active = self.children.len();
+        self.drop_exhausted_children();
+        let Some(min_doc_id) = self.children[..self.num_active]
+            .iter()
+            .map(|c| c.it.last_doc_id())
+            .min()
+        else {
+            self.is_eof = true;
+            return Ok(RQEValidateStatus::Moved { current: None });
+        };
+
+        debug_assert!(
+            min_doc_id >= original_last_doc_id,
+            "a child moved behind the union's position: doc {min_doc_id} \
+             comes before doc {original_last_doc_id}",
+        );
+
+        self.build_aggregate_result(min_doc_id);
+        if min_doc_id == original_last_doc_id {
+            return Ok(RQEValidateStatus::Ok);
+        }
+
+        Ok(RQEValidateStatus::Moved {
+            current: Some(&mut self.result),
+        })
+    }
+
+    #[inline(always)]
+    fn type_(&self) -> IteratorType {
+        IteratorType::BlockMaxWand
+    }
+
+    fn intersection_sort_weight(&self, prioritize_union_children: bool) -> f64 {
+        if prioritize_union_children {
+            self.children.len().max(1) as f64
+        } else {
+            1.0
+        }
+    }
+}
+
+impl<'index, I> ProfilePrint for BlockMaxWand<'index, I>
+where
+    I: ScoreBoundedIterator<'index>,
+{
+    fn print_profile(&self, map: &mut redis_reply::MapBuilder<'_>, ctx: &mut ProfilePrintCtx<'_>) {
+        map.kv_simple_string(c"Type", c"UNION");
+        map.kv_simple_string(c"Query type", c"BLOCK_MAX_WAND");
+        ctx.print_optional_counters(map);
+
+        let mut arr = map.kv_array(c"Child iterators");
+        for i in 0..self.num_children_total() {
+            if let Some(child) = self.child_at(i) {
+                let mut child_map = arr.map();
+                let mut child_ctx = ctx.child_ctx();
+                child.print_profile(&mut child_map, &mut child_ctx);
+            }
+        }
+    }
+}
@@ -57,8 +57,8 @@ use index_result::RSIndexResult;
 use index_spec::IndexSpecReadGuard;
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, ResumeOutcome, SkipToOutcome,
-    c2rust,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, ResumeOutcome,
+    SkipToOutcome, c2rust,
 };
 
 /// Concrete-typed active iterator trait — the new shape of
@@ -498,6 +498,11 @@ impl<'index> RQEIterator<'index> for TypeErasedRQEIterator<'index> {
         self.0.read()
     }
 
+    #[inline(always)]
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        self.0.read_batch(batch)
+    }
+
     #[inline(always)]
     fn skip_to(
         &mut self,
@@ -548,6 +553,16 @@ impl<'index> RQEIterator<'index> for TypeErasedRQEIterator<'index> {
     fn intersection_sort_weight(&self, prioritize_union_children: bool) -> f64 {
         self.0.intersection_sort_weight(prioritize_union_children)
     }
+
+    #[inline(always)]
+    fn has_doc_ids_words(&self) -> bool {
+        self.0.has_doc_ids_words()
+    }
+
+    #[inline(always)]
+    fn doc_ids_words(&self, base: t_docId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        self.0.doc_ids_words(base, words)
+    }
 }
 
 /// Forwarding [`RQEIteratorBoxed`] impl so [`TypeErasedRQEIterator`] also
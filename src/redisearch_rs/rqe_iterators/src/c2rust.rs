@@ -17,7 +17,7 @@ use ffi::{
 use rqe_core::DocId;
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
     interop::RQEIteratorWrapper, intersection::Intersection, profile_print,
     profile_print::ProfilePrint,
 };
@@ -61,7 +61,8 @@ pub struct CRQEIterator {
     /// 2. [`Self::header`] is an owning pointer, in the same way `Box` owns the
     ///    allocated heap data.
     /// 3. All callbacks are defined (i.e. the function pointers are not NULL),
-    ///    with the exception of `SkipTo` and `ProfileChildren`, which are optional.
+    ///    with the exception of `SkipTo`, `ProfileChildren`, `DocIdsBlock`, `ReadBatch` and
+    ///    `DocIdsWords`, which are optional.
     /// 4. All callbacks can be safely called, when the right aliasing conditions are
     ///    in place
     header: NonNull<QueryIterator>,
@@ -138,7 +139,8 @@ impl CRQEIterator {
     /// 2. `header` is an owning pointer, in the same way `Box` owns the
     ///    allocated heap data.
     /// 3. All callbacks are defined (i.e. the function pointers are not NULL),
-    ///    with the exception of `SkipTo` and `ProfileChildren`, which are optional.
+    ///    with the exception of `SkipTo`, `ProfileChildren`, `DocIdsBlock`, `ReadBatch` and
+    ///    `DocIdsWords`, which are optional.
     /// 4. All callbacks can be safely called, when the right aliasing conditions are
     ///    in place
     pub unsafe fn new(header: NonNull<QueryIterator>) -> Self {
@@ -240,6 +242,39 @@ impl<'index> RQEIterator<'index> for CRQEIterator {
         }
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        let Some(callback) = self.ReadBatch else {
+            return crate::batch::read_batch_by_reads(self, batch);
+        };
+        if batch.is_full() {
+            return Ok(());
+        }
+
+        let (doc_ids, field_masks) = batch.unfilled_mut();
+        let mut c_batch = ffi::IteratorBatch {
+            docIds: doc_ids.as_mut_ptr(),
+            fieldMasks: field_masks.map_or(std::ptr::null_mut(), |masks| masks.as_mut_ptr()),
+            capacity: doc_ids.len(),
+            len: 0,
+        };
+        // SAFETY:
+        // - We have a unique handle over this iterator.
+        // - The C code must guarantee, by constructor, that callbacks
+        //   can be called on types that implement its C iterator API.
+        // - `c_batch` points into the unfilled part of `batch`, which has room for `capacity`
+        //   document IDs (and field masks, when requested).
+        let status = unsafe { callback(self.header.as_ptr(), &mut c_batch) };
+        batch.advance(c_batch.len);
+        #[expect(non_upper_case_globals)]
+        match status {
+            IteratorStatus_ITERATOR_OK | IteratorStatus_ITERATOR_EOF => Ok(()),
+            IteratorStatus_ITERATOR_TIMEOUT => Err(RQEIteratorError::TimedOut),
+            _ => {
+                unreachable!("`ReadBatch` returned an unexpected iterator status, {status}")
+            }
+        }
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -321,6 +356,55 @@ impl<'index> RQEIterator<'index> for CRQEIterator {
         Ok(status)
     }
 
+    fn has_doc_ids_blocks(&self) -> bool {
+        self.DocIdsBlock.is_some()
+    }
+
+    fn doc_ids_block(&self, doc_id: DocId, out: &mut Vec<DocId>) -> Result<bool, RQEIteratorError> {
+        let callback = self
+            .DocIdsBlock
+            .expect("The `DocIdsBlock` callback is a NULL function pointer");
+        // SAFETY:
+        // - The C code must guarantee, by constructor, that callbacks
+        //   can be called on types that implement its C iterator API.
+        // - `DocIdsBlock` interprets the opaque buffer as the `Vec<DocId>` we pass in.
+        let status =
+            unsafe { callback(self.header.as_ptr(), doc_id, std::ptr::from_mut(out).cast()) };
+        #[expect(non_upper_case_globals)]
+        match status {
+            IteratorStatus_ITERATOR_OK => Ok(true),
+            IteratorStatus_ITERATOR_EOF => Ok(false),
+            IteratorStatus_ITERATOR_TIMEOUT => Err(RQEIteratorError::TimedOut),
+            _ => {
+                unreachable!("`DocIdsBlock` returned an unexpected iterator status, {status}")
+            }
+        }
+    }
+
+    fn has_doc_ids_words(&self) -> bool {
+        self.DocIdsWords.is_some()
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        let callback = self
+            .DocIdsWords
+            .expect("The `DocIdsWords` callback is a NULL function pointer");
+        // SAFETY:
+        // - The C code must guarantee, by constructor, that callbacks
+        //   can be called on types that implement its C iterator API.
+        // - `words` is a unique slice of `words.len()` writable words.
+        let status =
+            unsafe { callback(self.header.as_ptr(), base, words.as_mut_ptr(), words.len()) };
+        #[expect(non_upper_case_globals)]
+        match status {
+            IteratorStatus_ITERATOR_OK => Ok(()),
+            IteratorStatus_ITERATOR_TIMEOUT => Err(RQEIteratorError::TimedOut),
+            _ => {
+                unreachable!("`DocIdsWords` returned an unexpected iterator status, {status}")
+            }
+        }
+    }
+
     fn num_estimated(&self) -> usize {
         // SAFETY: Safe thanks to invariant 3. of [`CRQEIterator::header`].
         let callback = unsafe { self.NumEstimated.unwrap_unchecked() };
@@ -421,6 +505,7 @@ impl<'index> RQEIterator<'index> for CRQEIterator {
             IteratorType::Optimus => 1.0,
             IteratorType::GeoShape => 1.0,
             IteratorType::Mock => 1.0,
+            IteratorType::BlockMaxWand => 1.0,
             IteratorType::Max => 1.0,
         }
     }
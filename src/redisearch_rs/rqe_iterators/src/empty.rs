@@ -83,6 +83,15 @@ impl<'index> RQEIterator<'index> for Empty {
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    fn has_doc_ids_words(&self) -> bool {
+        true
+    }
+
+    fn doc_ids_words(&self, _base: DocId, _words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        // Yields nothing, so there is no bit to set.
+        Ok(())
+    }
 }
 
 impl ProfilePrint for Empty {
@@ -18,7 +18,8 @@ use rqe_core::DocId;
 use std::sync::atomic::{AtomicBool, Ordering};
 
 use crate::{
-    RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome, profile_print::ProfilePrint,
+    DocIdBatch, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
+    profile_print::ProfilePrint,
 };
 
 #[repr(C)]
@@ -62,6 +63,13 @@ where
                 Rewind: Some(rewind::<I>),
                 ProfileChildren: profile_children,
                 PrintProfile: Some(print_profile::<I>),
+                DocIdsBlock: inner
+                    .has_doc_ids_blocks()
+                    .then_some(doc_ids_block::<I> as unsafe extern "C" fn(_, _, _) -> _),
+                ReadBatch: Some(read_batch::<I>),
+                DocIdsWords: inner
+                    .has_doc_ids_words()
+                    .then_some(doc_ids_words::<I> as unsafe extern "C" fn(_, _, _, _) -> _),
             },
             inner,
         });
@@ -253,6 +261,57 @@ extern "C" fn read<'index, I: RQEIterator<'index> + 'index>(
     }
 }
 
+/// `ReadBatch` vtable callback.
+///
+/// # Safety
+///
+/// - `base` must be a valid pointer to a [`QueryIterator`] created by
+///   [`RQEIteratorWrapper::boxed_new`] or [`RQEIteratorWrapper::boxed_new_compound`]
+///   with inner type `I`.
+/// - `batch` must be a valid pointer to an [`ffi::IteratorBatch`] with `len < capacity`, whose
+///   `docIds` (and `fieldMasks`, unless NULL) point to `capacity` writable entries, none of them
+///   aliased.
+unsafe extern "C" fn read_batch<'index, I: RQEIterator<'index> + 'index>(
+    base: *mut QueryIterator,
+    batch: *mut ffi::IteratorBatch,
+) -> IteratorStatus {
+    debug_assert!(!base.is_null());
+    debug_assert!(!batch.is_null());
+    // SAFETY: Guaranteed by invariant 1. in [`RQEIteratorWrapper`].
+    let wrapper = unsafe { RQEIteratorWrapper::<I>::mut_ref_from_header_ptr(base) };
+    // SAFETY: batch is valid and unaliased per precondition.
+    let batch = unsafe { &mut *batch };
+    debug_assert!(batch.len < batch.capacity);
+    let room = batch.capacity - batch.len;
+    // SAFETY: `docIds` points to `capacity` entries per precondition, so the `room` entries
+    // after the first `len` are in bounds.
+    let doc_ids = unsafe { std::slice::from_raw_parts_mut(batch.docIds.add(batch.len), room) };
+    let field_masks = (!batch.fieldMasks.is_null()).then(|| {
+        // SAFETY: A non-NULL `fieldMasks` points to `capacity` entries per precondition.
+        unsafe { std::slice::from_raw_parts_mut(batch.fieldMasks.add(batch.len), room) }
+    });
+
+    let mut out = DocIdBatch::new(doc_ids, field_masks);
+    let outcome = wrapper.inner.read_batch(&mut out);
+    let appended = out.len();
+    batch.len += appended;
+
+    wrapper.header.lastDocId = wrapper.inner.last_doc_id();
+    wrapper.header.atEOF = wrapper.inner.at_eof();
+    wrapper.sync_current();
+
+    match outcome {
+        Ok(()) if appended > 0 => IteratorStatus_ITERATOR_OK,
+        Ok(()) => IteratorStatus_ITERATOR_EOF,
+        Err(RQEIteratorError::TimedOut) => IteratorStatus_ITERATOR_TIMEOUT,
+        Err(RQEIteratorError::IoError(_)) => {
+            unreachable!(
+                "None of the current iterators can fail due to an I/O error, since everything is read from memory"
+            )
+        }
+    }
+}
+
 extern "C" fn skip_to<'index, I: RQEIterator<'index> + 'index>(
     base: *mut QueryIterator,
     doc_id: DocId,
@@ -382,6 +441,70 @@ extern "C" fn num_estimated<'index, I: RQEIterator<'index> + 'index>(
     wrapper.inner.num_estimated()
 }
 
+/// `DocIdsBlock` vtable callback, only set for iterators which
+/// [have doc ID blocks](RQEIterator::has_doc_ids_blocks).
+///
+/// # Safety
+///
+/// - `base` must be a valid pointer to a [`QueryIterator`] created by
+///   [`RQEIteratorWrapper::boxed_new`] or [`RQEIteratorWrapper::boxed_new_compound`]
+///   with inner type `I`.
+/// - `out` must be a valid pointer to a `Vec<DocId>`, not aliased.
+unsafe extern "C" fn doc_ids_block<'index, I: RQEIterator<'index> + 'index>(
+    base: *const QueryIterator,
+    doc_id: DocId,
+    out: *mut ffi::RsDocIdsBuffer,
+) -> IteratorStatus {
+    debug_assert!(!base.is_null());
+    debug_assert!(!out.is_null());
+    // SAFETY: Guaranteed by invariant 1. in [`RQEIteratorWrapper`].
+    let wrapper = unsafe { RQEIteratorWrapper::<I>::ref_from_header_ptr(base) };
+    // SAFETY: out is a valid, unaliased &mut Vec<DocId> per precondition.
+    let out = unsafe { &mut *(out as *mut Vec<DocId>) };
+    match wrapper.inner.doc_ids_block(doc_id, out) {
+        Ok(true) => IteratorStatus_ITERATOR_OK,
+        Ok(false) => IteratorStatus_ITERATOR_EOF,
+        Err(RQEIteratorError::TimedOut) => IteratorStatus_ITERATOR_TIMEOUT,
+        Err(RQEIteratorError::IoError(_)) => {
+            unreachable!(
+                "None of the current iterators can fail due to an I/O error, since everything is read from memory"
+            )
+        }
+    }
+}
+
+/// `DocIdsWords` vtable callback, only set for iterators which
+/// [have doc ID words](RQEIterator::has_doc_ids_words).
+///
+/// # Safety
+///
+/// - `base` must be a valid pointer to a [`QueryIterator`] created by
+///   [`RQEIteratorWrapper::boxed_new`] or [`RQEIteratorWrapper::boxed_new_compound`]
+///   with inner type `I`.
+/// - `words` must point to `len` writable words, none of them aliased.
+unsafe extern "C" fn doc_ids_words<'index, I: RQEIterator<'index> + 'index>(
+    base: *const QueryIterator,
+    doc_id: DocId,
+    words: *mut u64,
+    len: usize,
+) -> IteratorStatus {
+    debug_assert!(!base.is_null());
+    debug_assert!(!words.is_null());
+    // SAFETY: Guaranteed by invariant 1. in [`RQEIteratorWrapper`].
+    let wrapper = unsafe { RQEIteratorWrapper::<I>::ref_from_header_ptr(base) };
+    // SAFETY: words points to `len` writable, unaliased words per precondition.
+    let words = unsafe { std::slice::from_raw_parts_mut(words, len) };
+    match wrapper.inner.doc_ids_words(doc_id, words) {
+        Ok(()) => IteratorStatus_ITERATOR_OK,
+        Err(RQEIteratorError::TimedOut) => IteratorStatus_ITERATOR_TIMEOUT,
+        Err(RQEIteratorError::IoError(_)) => {
+            unreachable!(
+                "None of the current iterators can fail due to an I/O error, since everything is read from memory"
+            )
+        }
+    }
+}
+
 /// [`ProfileChildren`] callback for composite Rust iterators wrapped in
 /// [`RQEIteratorWrapper`].
 ///
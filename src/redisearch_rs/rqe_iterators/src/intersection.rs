@@ -12,10 +12,16 @@
 //! The intersection iterator supports proximity constraints via two parameters:
 //! - `max_slop`: Maximum allowed slop between term positions (`None` = no constraint)
 //! - `in_order`: Require terms to appear in order
+//!
+//! When there are no proximity constraints and every child can decode its postings a
+//! block at a time (see [`RQEIterator::has_doc_ids_blocks`]), candidates are found by
+//! intersecting whole blocks of document IDs, driven by the rarest child, rather than by
+//! stepping the children one document at a time.
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
     profile_print::{ProfilePrint, ProfilePrintCtx},
+    utils::intersect_sorted,
 };
 
 use index_result::{RSIndexResult, RawIndexResult};
@@ -53,6 +59,40 @@ pub struct RawIntersection<'query, Rf: Ref, I> {
     in_order: bool,
     /// Aggregate result combining children's results, reused to avoid allocations.
     result: RawIndexResult<'query, Rf>,
+    /// Candidates found by intersecting the children's postings blocks, when
+    /// [`uses_blocks`](Intersection::uses_blocks).
+    blocks: BlockCandidates,
+}
+
+/// Documents present in the postings blocks of every child, gathered a block of the
+/// rarest child at a time.
+///
+/// Candidates are a superset of the intersection over the range they cover: a child's
+/// blocks may hold documents it would not yield, e.g. because their field expired.
+/// Each candidate is therefore still confirmed by moving the children onto it.
+#[derive(Default)]
+struct BlockCandidates {
+    /// Sorted, deduplicated candidates.
+    ids: Vec<DocId>,
+    /// Position of the first candidate in `ids` not skipped yet.
+    next: usize,
+    /// Last document of the range covered by `ids`, `0` if nothing was gathered yet.
+    covered_to: DocId,
+    /// Buffer a block is decoded into.
+    block: Vec<DocId>,
+    /// Documents of the child being intersected, over the range covered by `ids`.
+    child_ids: Vec<DocId>,
+    /// Buffer the intersection is written into, swapped with `ids` afterwards.
+    out: Vec<DocId>,
+}
+
+impl BlockCandidates {
+    /// Forget every candidate, e.g. after the children were rewound.
+    fn clear(&mut self) {
+        self.ids.clear();
+        self.next = 0;
+        self.covered_to = 0;
+    }
 }
 
 /// Alias for an [`Active`] [`RawIntersection`] — the only instantiation
@@ -152,6 +192,7 @@ where
                 max_slop,
                 in_order,
                 result: RSIndexResult::build_intersect(0).weight(weight).build(),
+                blocks: BlockCandidates::default(),
             };
         };
         let num_children = children.len();
@@ -165,6 +206,7 @@ where
             result: RSIndexResult::build_intersect(num_children)
                 .weight(weight)
                 .build(),
+            blocks: BlockCandidates::default(),
         }
     }
 
@@ -241,6 +283,125 @@ where
         }
     }
 
+    /// Returns `true` if candidates are gathered by intersecting the children's postings
+    /// blocks.
+    ///
+    /// This requires no proximity constraints, since blocks only hold document IDs, and at
+    /// least two children, all of which [have doc ID blocks](RQEIterator::has_doc_ids_blocks).
+    /// Checked on every call, since children may be replaced through
+    /// [`children_mut`](Self::children_mut).
+    fn uses_blocks(&self) -> bool {
+        !self.needs_relevancy_check()
+            && self.children.len() >= 2
+            && self.children.iter().all(|c| c.has_doc_ids_blocks())
+    }
+
+    /// Returns the first block candidate at or after `target`, gathering more candidates as
+    /// needed, or `None` once the blocks of some child are exhausted.
+    fn next_block_candidate(&mut self, target: DocId) -> Result<Option<DocId>, RQEIteratorError> {
+        loop {
+            let blocks = &mut self.blocks;
+            blocks.next += blocks.ids[blocks.next..].partition_point(|&id| id < target);
+            if let Some(&id) = blocks.ids.get(blocks.next) {
+                return Ok(Some(id));
+            }
+            if !self.gather_block_candidates(target)? {
+                return Ok(None);
+            }
+        }
+    }
+
+    /// Replace the candidates with the documents at or after `target` that are present in the
+    /// next block of the rarest child and in the overlapping blocks of every other child.
+    ///
+    /// Returns `false` if no document past the covered range can be in every child.
+    fn gather_block_candidates(&mut self, target: DocId) -> Result<bool, RQEIteratorError> {
+        let blocks = &mut self.blocks;
+        let from = target.max(blocks.covered_to.saturating_add(1));
+        blocks.ids.clear();
+        blocks.next = 0;
+
+        // The rarest child has the fewest blocks, each spanning the widest range of documents.
+        let Some((driver, _)) = self
+            .children
+            .iter()
+            .enumerate()
+            .min_by_key(|(_, c)| c.num_estimated())
+        else {
+            return Ok(false);
+        };
+        if !self.children[driver].doc_ids_block(from, &mut blocks.block)? {
+            return Ok(false);
+        }
+        let to = *blocks.block.last().expect("a found block is not empty");
+        blocks.covered_to = to;
+        let start = blocks.block.partition_point(|&id| id < from);
+        blocks.ids.extend_from_slice(&blocks.block[start..]);
+        blocks.ids.dedup();
+
+        for (i, child) in self.children.iter().enumerate() {
+            if i == driver {
+                continue;
+            }
+            if blocks.ids.is_empty() {
+                break;
+            }
+
+            // Collect the child's documents in `from..=to`, which may span several of its blocks.
+            blocks.child_ids.clear();
+            let mut next = from;
+            while next <= to {
+                if !child.doc_ids_block(next, &mut blocks.block)? {
+                    if next == from {
+                        // Nothing left in this child, so nothing left in the intersection.
+                        return Ok(false);
+                    }
+                    break;
+                }
+                let block_last = *blocks.block.last().expect("a found block is not empty");
+                debug_assert!(
+                    block_last >= next,
+                    "a block must reach the requested document"
+                );
+                let start = blocks.block.partition_point(|&id| id < next);
+                let end = blocks.block.partition_point(|&id| id <= to);
+                blocks
+                    .child_ids
+                    .extend_from_slice(&blocks.block[start..end]);
+                next = block_last.saturating_add(1);
+            }
+
+            blocks.out.clear();
+            intersect_sorted(&blocks.ids, &blocks.child_ids, &mut blocks.out);
+            std::mem::swap(&mut blocks.ids, &mut blocks.out);
+        }
+        // A child may list a document more than once, see `intersect_sorted`.
+        blocks.ids.dedup();
+        Ok(true)
+    }
+
+    /// Move every child onto the first document matching all of them at or after the first
+    /// block candidate at or after `target`.
+    fn find_block_consensus(&mut self, target: DocId) -> Result<Option<DocId>, RQEIteratorError> {
+        let Some(candidate) = self.next_block_candidate(target)? else {
+            self.is_eof = true;
+            return Ok(None);
+        };
+        self.find_consensus(candidate)
+    }
+
+    /// Move every child onto the next document matching all of them, without checking
+    /// proximity constraints.
+    fn next_consensus(&mut self) -> Result<Option<DocId>, RQEIteratorError> {
+        if self.uses_blocks() {
+            return self.find_block_consensus(self.last_doc_id + 1);
+        }
+        match self.read_from_first_child()? {
+            Some(target) => self.find_consensus(target),
+            None => Ok(None),
+        }
+    }
+
     /// Reads from the first child. Returns the doc_id or None if EOF.
     fn read_from_first_child(&mut self) -> Result<Option<DocId>, RQEIteratorError> {
         match self.children[0].read()? {
@@ -430,17 +591,17 @@ where
             return Ok(None);
         }
 
-        let Some(target) = self.read_from_first_child()? else {
-            return Ok(None);
-        };
         // FIXME: consider using function pointers to remove runtime checks for each reads.
         if self.needs_relevancy_check() {
+            let Some(target) = self.read_from_first_child()? else {
+                return Ok(None);
+            };
             match self.find_consensus_with_relevancy_check(target)? {
                 Some(_) => Ok(Some(&mut self.result)),
                 None => Ok(None),
             }
         } else {
-            match self.find_consensus(target)? {
+            match self.next_consensus()? {
                 Some(doc_id) => {
                     self.build_aggregate_result(doc_id);
                     self.last_doc_id = doc_id;
@@ -451,6 +612,46 @@ where
         }
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        if self.is_eof {
+            return Ok(());
+        }
+        // The proximity check needs the aggregate result of every candidate.
+        if self.needs_relevancy_check() {
+            return crate::batch::read_batch_by_reads(self, batch);
+        }
+
+        let start_id = self.last_doc_id;
+        let mut outcome = Ok(());
+        while !batch.is_full() {
+            let doc_id = match self.next_consensus() {
+                Ok(Some(doc_id)) => doc_id,
+                Ok(None) => break,
+                Err(e) => {
+                    outcome = Err(e);
+                    break;
+                }
+            };
+
+            let mut field_mask = 0;
+            if batch.wants_field_masks() {
+                for child in &mut self.children {
+                    if let Some(child_result) = child.current() {
+                        field_mask |= child_result.field_mask;
+                    }
+                }
+            }
+            batch.push(doc_id, field_mask);
+            self.last_doc_id = doc_id;
+        }
+
+        // Leave the iterator on the last document appended, as `read` would have.
+        if self.last_doc_id != start_id {
+            self.build_aggregate_result(self.last_doc_id);
+        }
+        outcome
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -490,7 +691,12 @@ where
                 None => Ok(None),
             }
         } else {
-            match self.find_consensus(doc_id)? {
+            let found = if self.uses_blocks() {
+                self.find_block_consensus(doc_id)?
+            } else {
+                self.find_consensus(doc_id)?
+            };
+            match found {
                 Some(found_id) => {
                     self.build_aggregate_result(found_id);
                     self.last_doc_id = found_id;
@@ -512,6 +718,7 @@ where
         if let Some(agg) = self.result.as_aggregate_mut() {
             agg.reset();
         }
+        self.blocks.clear();
         self.children.iter_mut().for_each(|c| c.rewind());
     }
 
@@ -537,6 +744,8 @@ where
         let mut any_child_moved = false;
         let mut max_child_doc_id: DocId = 0;
         let mut moved_to_eof = false;
+        // The children's blocks may have been rewritten by the garbage collector.
+        self.blocks.clear();
 
         for child in &mut self.children {
             match child.revalidate(spec)? {
@@ -598,6 +807,8 @@ impl<'index> crate::interop::ProfileChildren<'index>
             max_slop: self.max_slop,
             in_order: self.in_order,
             result: self.result,
+            // Profiled children do not expose their blocks.
+            blocks: BlockCandidates::default(),
         }
     }
 }
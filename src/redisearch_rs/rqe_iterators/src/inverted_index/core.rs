@@ -233,6 +233,12 @@ where
         self.result.as_term()?.query_term()?.as_bytes()
     }
 
+    /// Returns `true` if the iterator skips postings of expired documents, in which case the
+    /// postings of its reader are a superset of the documents it yields.
+    pub(super) fn checks_expiration(&self) -> bool {
+        self.expiration_checker.has_expiration()
+    }
+
     /// Default read implementation, without any additional filtering.
     fn read_default(&mut self) -> Result<Option<&mut RSIndexResult<'index>>, RQEIteratorError> {
         if self.at_eos {
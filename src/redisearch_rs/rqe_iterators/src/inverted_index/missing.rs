@@ -278,6 +278,16 @@ where
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    fn has_doc_ids_words(&self) -> bool {
+        // The words must be exact, so they can't come from the postings when some of them are
+        // skipped because their field expired.
+        !self.it.checks_expiration()
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        Ok(self.it.reader.block_doc_ids_words(base, words)?)
+    }
 }
 
 impl<'index, E, C> ProfilePrint for Missing<'index, E, C>
@@ -306,9 +316,11 @@ where
 ///    non-null and valid.
 /// 2. `field_index` must be a valid index into `sctx.spec.fields`.
 /// 3. `sctx.spec.missingFieldDict` must be a non-null, valid dict pointer.
-/// 4. The opaque inverted index must use either
-///    [`DocIdsOnly`](inverted_index::doc_ids_only::DocIdsOnly) or
-///    [`RawDocIdsOnly`](inverted_index::raw_doc_ids_only::RawDocIdsOnly)
+/// 4. The opaque inverted index must use
+///    [`DocIdsOnly`](inverted_index::doc_ids_only::DocIdsOnly),
+///    [`RawDocIdsOnly`](inverted_index::raw_doc_ids_only::RawDocIdsOnly),
+///    [`PackedDocIdsOnly`](inverted_index::packed_doc_ids_only::PackedDocIdsOnly) or
+///    [`BitmapDocIdsOnly`](inverted_index::bitmap_doc_ids_only::BitmapDocIdsOnly)
 ///    encoding.
 pub unsafe fn new_missing_iterator<'index>(
     ii: &'index inverted_index::opaque::InvertedIndex,
@@ -337,8 +349,24 @@ pub unsafe fn new_missing_iterator<'index>(
             // missingFieldDict validity (1-3).
             Box::new(unsafe { Missing::new(reader, sctx, field_index, checker) })
         }
+        inverted_index::opaque::InvertedIndex::PackedDocIdsOnly(ii) => {
+            let reader = ii.reader();
+            // SAFETY: caller guarantees sctx and spec validity (1-3).
+            let checker = unsafe { FieldExpirationChecker::new(sctx, filter_ctx, reader.flags()) };
+            // SAFETY: caller guarantees sctx, spec, field_index, and
+            // missingFieldDict validity (1-3).
+            Box::new(unsafe { Missing::new(reader, sctx, field_index, checker) })
+        }
+        inverted_index::opaque::InvertedIndex::BitmapDocIdsOnly(ii) => {
+            let reader = ii.reader();
+            // SAFETY: caller guarantees sctx and spec validity (1-3).
+            let checker = unsafe { FieldExpirationChecker::new(sctx, filter_ctx, reader.flags()) };
+            // SAFETY: caller guarantees sctx, spec, field_index, and
+            // missingFieldDict validity (1-3).
+            Box::new(unsafe { Missing::new(reader, sctx, field_index, checker) })
+        }
         _ => panic!(
-            "Missing iterator requires a DocIdsOnly or RawDocIdsOnly inverted index, got: {:?}",
+            "Missing iterator requires a DocIdsOnly, RawDocIdsOnly, PackedDocIdsOnly or BitmapDocIdsOnly inverted index, got: {:?}",
             std::mem::discriminant(ii)
         ),
     }
@@ -246,6 +246,24 @@ where
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    fn has_doc_ids_blocks(&self) -> bool {
+        true
+    }
+
+    fn doc_ids_block(&self, doc_id: DocId, out: &mut Vec<DocId>) -> Result<bool, RQEIteratorError> {
+        Ok(self.it.reader.block_doc_ids(doc_id, out)?)
+    }
+
+    fn has_doc_ids_words(&self) -> bool {
+        // The words must be exact, so they can't come from the postings when some of them are
+        // skipped because their field expired.
+        !self.it.checks_expiration()
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        Ok(self.it.reader.block_doc_ids_words(base, words)?)
+    }
 }
 
 impl<'index, E, L, C> ProfilePrint for Tag<'index, E, L, C>
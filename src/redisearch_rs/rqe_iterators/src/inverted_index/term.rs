@@ -15,9 +15,10 @@ use index_result::{RSIndexResult, RSOffsetSlice};
 use index_spec::IndexSpecReadGuard;
 use inverted_index::{
     FilterMaskReader, IndexReader, PointsToOpaqueIndex, RawIndexReaderCore, RefreshOutcome,
-    ResumableReader, SuspendableReader, TermReader, doc_ids_only::DocIdsOnly, fields_offsets,
-    fields_only, freqs_fields, freqs_offsets, freqs_only, full, offsets_only,
-    opaque::InvertedIndex, raw_doc_ids_only::RawDocIdsOnly,
+    ResumableReader, ScoreBounds, SuspendableReader, TermReader,
+    bitmap_doc_ids_only::BitmapDocIdsOnly, doc_ids_only::DocIdsOnly, fields_offsets, fields_only,
+    freqs_fields, freqs_offsets, freqs_only, full, offsets_only, opaque::InvertedIndex,
+    packed_doc_ids_only::PackedDocIdsOnly, raw_doc_ids_only::RawDocIdsOnly,
 };
 use query_term::RSQueryTerm;
 use ref_mode::{Active, Ref, Suspended};
@@ -104,6 +105,21 @@ where
     pub const fn reader(&self) -> &R {
         &self.it.reader
     }
+
+    /// Get the query term this iterator reads, with its IDF scores.
+    pub fn query_term(&self) -> &RSQueryTerm {
+        self.it
+            .result
+            .as_term()
+            .expect("Term iterator should always have a term result")
+            .query_term()
+            .expect("Term iterator should always have a query term")
+    }
+
+    /// Get the scoring weight applied to the results of this iterator.
+    pub const fn weight(&self) -> f64 {
+        self.it.result.weight
+    }
 }
 
 impl<'query, Rf: Ref, R, E, RA> RawTerm<'query, Rf, R, E, RA>
@@ -290,6 +306,8 @@ pub enum RawTermIndexReader<Rf: Ref> {
     FreqsOffsets(RawIndexReaderCore<Rf, freqs_offsets::FreqsOffsets>),
     DocIdsOnly(RawIndexReaderCore<Rf, DocIdsOnly>),
     RawDocIdsOnly(RawIndexReaderCore<Rf, RawDocIdsOnly>),
+    PackedDocIdsOnly(RawIndexReaderCore<Rf, PackedDocIdsOnly>),
+    BitmapDocIdsOnly(RawIndexReaderCore<Rf, BitmapDocIdsOnly>),
 }
 
 /// Active-form alias of [`RawTermIndexReader`] — the live term reader.
@@ -325,6 +343,8 @@ macro_rules! term_ir_dispatch {
             RawTermIndexReader::FreqsOffsets(r) => r.$method($($args),*),
             RawTermIndexReader::DocIdsOnly(r) => r.$method($($args),*),
             RawTermIndexReader::RawDocIdsOnly(r) => r.$method($($args),*),
+            RawTermIndexReader::PackedDocIdsOnly(r) => r.$method($($args),*),
+            RawTermIndexReader::BitmapDocIdsOnly(r) => r.$method($($args),*),
         }
     };
 }
@@ -378,6 +398,16 @@ impl<'index> IndexReader<'index> for TermIndexReader<'index> {
     fn refresh_buffer_pointers(&mut self) {
         term_ir_dispatch!(self, refresh_buffer_pointers)
     }
+
+    #[inline(always)]
+    fn block_score_bounds(&self, doc_id: DocId) -> Option<ScoreBounds> {
+        term_ir_dispatch!(self, block_score_bounds, doc_id)
+    }
+
+    #[inline(always)]
+    fn index_score_bounds(&self) -> Option<ScoreBounds> {
+        term_ir_dispatch!(self, index_score_bounds)
+    }
 }
 
 /// Resolve an opaque index and compare it against the current variant's reader.
@@ -475,6 +505,8 @@ pub unsafe fn build_term_iterator<'index>(
         InvertedIndex::FreqsOffsets(ii) => TermIndexReader::FreqsOffsets(ii.reader()),
         InvertedIndex::DocIdsOnly(ii) => TermIndexReader::DocIdsOnly(ii.reader()),
         InvertedIndex::RawDocIdsOnly(ii) => TermIndexReader::RawDocIdsOnly(ii.reader()),
+        InvertedIndex::PackedDocIdsOnly(ii) => TermIndexReader::PackedDocIdsOnly(ii.reader()),
+        InvertedIndex::BitmapDocIdsOnly(ii) => TermIndexReader::BitmapDocIdsOnly(ii.reader()),
         InvertedIndex::Numeric(_) | InvertedIndex::NumericFloatCompression(_) => {
             panic!("numeric inverted indices have no term reader")
         }
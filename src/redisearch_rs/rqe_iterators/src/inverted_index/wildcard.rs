@@ -180,6 +180,14 @@ where
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    fn has_doc_ids_words(&self) -> bool {
+        true
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        Ok(self.it.reader.block_doc_ids_words(base, words)?)
+    }
 }
 
 impl<E: DecodedBy> ProfilePrint for Wildcard<'_, E> {
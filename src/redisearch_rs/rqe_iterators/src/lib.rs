@@ -30,6 +30,8 @@ use index_result::{RSIndexResult, RawIndexResult};
 pub use query_error::QueryError;
 use query_term::RSQueryTerm;
 
+pub mod batch;
+pub mod block_max_wand;
 pub mod boxed;
 pub mod c2rust;
 pub mod config;
@@ -63,6 +65,8 @@ mod union_trimmed;
 pub mod utils;
 pub mod wildcard;
 
+pub use batch::DocIdBatch;
+pub use block_max_wand::{BlockMaxWand, ScoreBoundedIterator};
 pub use boxed::{
     RQEDynIterator, RQEDynSuspendedIterator, RQEIteratorBoxed, RQESuspendedIterator,
     TypeErasedRQEIterator, TypeErasedRQESuspendedIterator,
@@ -193,6 +197,21 @@ pub trait RQEIterator<'index> {
     /// The function will return Err(RQEIteratorError) for any error.
     fn read(&mut self) -> Result<Option<&mut RSIndexResult<'index>>, RQEIteratorError>;
 
+    /// Read entries until `batch` is full or the iterator is depleted, appending their document
+    /// IDs (and field masks, if asked for) to `batch`.
+    ///
+    /// Equivalent to calling [`read`](Self::read) as many times, which is what the default
+    /// implementation does: afterwards the iterator stands where those reads would have left it.
+    /// If `batch` was filled, that is on the last entry appended, which
+    /// [`current`](Self::current) returns; fewer entries than there was room for means the
+    /// iterator is depleted. Iterators override this when they can skip the per-entry work a
+    /// caller of `read` needs but a batch does not, e.g. building aggregate results.
+    ///
+    /// On error, the entries appended before it stay in `batch`.
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        batch::read_batch_by_reads(self, batch)
+    }
+
     /// Skip to the next record in the iterator with an ID greater or equal to the given `docId`.
     ///
     /// It is assumed that when [`skip_to`](Self::skip_to) is called, `self.last_doc_id() < doc_id`.
@@ -326,6 +345,62 @@ pub trait RQEIterator<'index> {
     /// - [`Union`]: `num_children` when `prioritize_union_children`, else `1.0`.
     /// - Everything else: `1.0` — neutral, no influence.
     fn intersection_sort_weight(&self, prioritize_union_children: bool) -> f64;
+
+    /// Returns `true` if this iterator can hand out its postings a block at a time through
+    /// [`doc_ids_block`](Self::doc_ids_block).
+    ///
+    /// Only leaves reading an inverted index which stores nothing but document IDs can, which
+    /// lets [`Intersection`] intersect whole blocks of them before touching the iterators.
+    fn has_doc_ids_blocks(&self) -> bool {
+        false
+    }
+
+    /// Decode into `out`, replacing its content, the document IDs of the postings block holding
+    /// the first posting at or after `doc_id`. Returns `Ok(false)`, leaving `out` empty, if there
+    /// is no such posting.
+    ///
+    /// The iterator does not move. `out` is sorted, and holds every document the iterator would
+    /// yield between `doc_id` and its last entry — possibly along with documents it would skip,
+    /// e.g. because their field expired, and with documents before `doc_id`.
+    ///
+    /// # Panics
+    ///
+    /// Only iterators for which [`has_doc_ids_blocks`](Self::has_doc_ids_blocks) returns `true`
+    /// implement this method.
+    fn doc_ids_block(
+        &self,
+        _doc_id: DocId,
+        _out: &mut Vec<DocId>,
+    ) -> Result<bool, RQEIteratorError> {
+        unreachable!("{:?} iterators do not support doc ID blocks", self.type_())
+    }
+
+    /// Returns `true` if this iterator can tell which documents it yields a 64-bit word at a
+    /// time through [`doc_ids_words`](Self::doc_ids_words).
+    ///
+    /// Wildcard iterators and leaves reading an inverted index which stores nothing but document
+    /// IDs can, as long as they yield every posting. [`Not`](not::Not) and
+    /// [`Optional`](optional::Optional) then combine them
+    /// with `AND`/`AND NOT` word operations instead of stepping through every document.
+    fn has_doc_ids_words(&self) -> bool {
+        false
+    }
+
+    /// Set bit `i % 64` of `words[i / 64]` for every document `base + i` the iterator yields from
+    /// its [current one](Self::last_doc_id) on, for `i < 64 * words.len()`. Bits already set
+    /// are kept, and documents the iterator yields more than once set their bit once.
+    ///
+    /// The iterator does not move. Unlike [`doc_ids_block`](Self::doc_ids_block) the bits are
+    /// exact from the current document onwards, but documents the iterator has already moved
+    /// past may be set too.
+    ///
+    /// # Panics
+    ///
+    /// Only iterators for which [`has_doc_ids_words`](Self::has_doc_ids_words) returns `true`
+    /// implement this method.
+    fn doc_ids_words(&self, _base: DocId, _words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        unreachable!("{:?} iterators do not support doc ID words", self.type_())
+    }
 }
 
 /// [`RQEIterator`] impl for boxed iterators, including type-erased `dyn` variants.
@@ -340,6 +415,10 @@ impl<'index, I: RQEIterator<'index> + ?Sized + 'index> RQEIterator<'index> for B
         (**self).read()
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        (**self).read_batch(batch)
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -382,6 +461,22 @@ impl<'index, I: RQEIterator<'index> + ?Sized + 'index> RQEIterator<'index> for B
     fn intersection_sort_weight(&self, prioritize_union_children: bool) -> f64 {
         (**self).intersection_sort_weight(prioritize_union_children)
     }
+
+    fn has_doc_ids_blocks(&self) -> bool {
+        (**self).has_doc_ids_blocks()
+    }
+
+    fn doc_ids_block(&self, doc_id: DocId, out: &mut Vec<DocId>) -> Result<bool, RQEIteratorError> {
+        (**self).doc_ids_block(doc_id, out)
+    }
+
+    fn has_doc_ids_words(&self) -> bool {
+        (**self).has_doc_ids_words()
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        (**self).doc_ids_words(base, words)
+    }
 }
 
 /// Combined trait for iterators that implement both [`RQEIterator`] and
@@ -208,6 +208,22 @@ where
             MaybeEmptyOption::Some(it) => it.intersection_sort_weight(prioritize_union_children),
         }
     }
+
+    #[inline(always)]
+    fn has_doc_ids_words(&self) -> bool {
+        match &self.0 {
+            MaybeEmptyOption::None(empty) => empty.has_doc_ids_words(),
+            MaybeEmptyOption::Some(it) => it.has_doc_ids_words(),
+        }
+    }
+
+    #[inline(always)]
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        match &self.0 {
+            MaybeEmptyOption::None(empty) => empty.doc_ids_words(base, words),
+            MaybeEmptyOption::Some(it) => it.doc_ids_words(base, words),
+        }
+    }
 }
 
 impl<'index, I> RQEIteratorBoxed<'index> for MaybeEmpty<I>
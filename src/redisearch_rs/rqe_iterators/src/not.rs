@@ -13,8 +13,9 @@ use index_result::{RSIndexResult, RSResultKind, RawIndexResult};
 use ref_mode::{Active, Ref, Suspended};
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator,
-    RQEValidateStatus, ResumeOutcome, SkipToOutcome,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorBoxed, RQEIteratorError,
+    RQESuspendedIterator, RQEValidateStatus, ResumeOutcome, SkipToOutcome,
+    batch::{WINDOW_WORDS, read_batch_by_reads},
     boxed::{ResumeSlotOutcome, resume_child_slot_in_place, suspend_child_slot_in_place},
     maybe_empty::MaybeEmpty,
     profile_print::{ProfilePrint, ProfilePrintCtx},
@@ -208,6 +209,46 @@ where
         Ok(None)
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        if self.past_end || !self.has_next() || !self.child.has_doc_ids_words() {
+            return read_batch_by_reads(self, batch);
+        }
+
+        // Walk the complement a window at a time: every ID is a candidate, and an
+        // `AND NOT` with the child's words drops the ones it holds.
+        let mut last = None;
+        let mut base = self.result.doc_id + 1;
+        while !batch.is_full() && base <= self.max_doc_id {
+            self.check_timeout()?;
+            let mut words = [0; WINDOW_WORDS];
+            self.child.doc_ids_words(base, &mut words)?;
+            for word in &mut words {
+                *word = !*word;
+            }
+            last = batch
+                .push_words(base, &words, self.max_doc_id, self.result.field_mask)
+                .or(last);
+            base += (64 * WINDOW_WORDS) as DocId;
+        }
+
+        if batch.is_full() {
+            // Leave the iterator on the last document appended, as `read` would have.
+            if let Some(last) = last {
+                let found = matches!(self.skip_to(last)?, Some(SkipToOutcome::Found(_)));
+                debug_assert!(found, "the child holds a document its words left out");
+            }
+        } else {
+            // The complement ran out: end where the reads would have, with the
+            // child caught up to `max_doc_id`.
+            self.result.doc_id = self.max_doc_id;
+            if !self.child.at_eof() && self.child.last_doc_id() < self.max_doc_id {
+                self.child.skip_to(self.max_doc_id)?;
+            }
+            self.past_end = true;
+        }
+        Ok(())
+    }
+
     #[inline(always)]
     fn skip_to(
         &mut self,
@@ -13,8 +13,9 @@ use index_result::{RSIndexResult, RSResultKind, RawIndexResult};
 use ref_mode::{Active, Ref, Suspended};
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator,
-    RQEValidateStatus, ResumeOutcome, SkipToOutcome, WildcardIterator,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorBoxed, RQEIteratorError,
+    RQESuspendedIterator, RQEValidateStatus, ResumeOutcome, SkipToOutcome, WildcardIterator,
+    batch::{WINDOW_WORDS, read_batch_by_reads},
     boxed::suspend_child_slot_in_place,
     maybe_empty::MaybeEmpty,
     profile_print::{ProfilePrint, ProfilePrintCtx},
@@ -281,6 +282,47 @@ where
         }
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        // The wildcard's words are only exact from its own position on, so it has to
+        // sit on this iterator's.
+        if !self.has_next()
+            || !self.wcii.has_doc_ids_words()
+            || !self.child.has_doc_ids_words()
+            || self.wcii.last_doc_id() != self.result.doc_id
+        {
+            return read_batch_by_reads(self, batch);
+        }
+
+        // Combine both a window at a time: the existing documents `AND NOT` the
+        // child's.
+        let mut last = None;
+        let mut base = self.result.doc_id + 1;
+        while !batch.is_full() && base <= self.max_doc_id {
+            self.check_timeout()?;
+            let mut words = [0; WINDOW_WORDS];
+            let mut child_words = [0; WINDOW_WORDS];
+            self.wcii.doc_ids_words(base, &mut words)?;
+            self.child.doc_ids_words(base, &mut child_words)?;
+            for (word, child_word) in words.iter_mut().zip(child_words) {
+                *word &= !child_word;
+            }
+            last = batch
+                .push_words(base, &words, self.max_doc_id, self.result.field_mask)
+                .or(last);
+            base += (64 * WINDOW_WORDS) as DocId;
+        }
+
+        // Leave the iterator on the last document appended, as `read` would have.
+        if let Some(last) = last {
+            let found = matches!(self.skip_to(last)?, Some(SkipToOutcome::Found(_)));
+            debug_assert!(found, "the words disagree with the iterators");
+        }
+        if !batch.is_full() {
+            self.past_end = true;
+        }
+        Ok(())
+    }
+
     #[inline(always)]
     fn skip_to(
         &mut self,
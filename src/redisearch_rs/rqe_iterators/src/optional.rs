@@ -14,8 +14,9 @@ use ref_mode::{Active, Ref, Suspended};
 use std::cmp;
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator,
-    RQEValidateStatus, ResumeOutcome, SkipToOutcome,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorBoxed, RQEIteratorError,
+    RQESuspendedIterator, RQEValidateStatus, ResumeOutcome, SkipToOutcome,
+    batch::read_batch_by_reads,
     boxed::{ResumeSlotOutcome, resume_child_slot_in_place, suspend_child_slot_in_place},
     profile_print::{ProfilePrint, ProfilePrintCtx},
 };
@@ -265,6 +266,32 @@ where
         Ok(Some(&mut self.result))
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        // Field masks tell real results from virtual ones, which only the child knows.
+        if batch.wants_field_masks() {
+            return read_batch_by_reads(self, batch);
+        }
+        if batch.is_full() || self.exhausted() {
+            return Ok(());
+        }
+
+        // Otherwise every ID up to `max_doc_id` is a result, whatever the child holds.
+        let room = batch.remaining();
+        let n = ((self.max_doc_id - self.result.doc_id) as usize).min(room);
+        for doc_id in self.result.doc_id + 1..=self.result.doc_id + n as DocId {
+            batch.push(doc_id, RS_FIELDMASK_ALL);
+        }
+        if n > 0 {
+            // Leave the iterator, and the child, on the last document appended.
+            self.skip_to(self.result.doc_id + n as DocId)?;
+        }
+        if n < room {
+            // The read that would have filled the rest found nothing.
+            self.past_end = true;
+        }
+        Ok(())
+    }
+
     /// Skip to a specific docId. If the child has a hit on this docId, return it.
     /// Otherwise, return a virtual hit.
     fn skip_to(
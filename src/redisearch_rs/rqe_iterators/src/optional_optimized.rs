@@ -18,8 +18,9 @@ use index_result::{RSIndexResult, RSResultKind, RawIndexResult};
 use ref_mode::{Active, Ref, Suspended};
 
 use crate::{
-    RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator, RQEValidateStatus,
-    ResumeOutcome, SkipToOutcome,
+    DocIdBatch, RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator,
+    RQEValidateStatus, ResumeOutcome, SkipToOutcome,
+    batch::{WINDOW_WORDS, read_batch_by_reads},
     boxed::suspend_child_slot_in_place,
     maybe_empty::MaybeEmpty,
     profile_print::{ProfilePrint, ProfilePrintCtx},
@@ -308,6 +309,41 @@ where
         Ok(Some(self.settled_result(is_real)))
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        // Field masks tell real results from virtual ones, which only the child knows.
+        // Without them the batch is the existing documents, read off the wildcard's
+        // words, which are only exact from its own position on.
+        if batch.wants_field_masks()
+            || self.past_end
+            || !self.has_next()
+            || !self.wcii.has_doc_ids_words()
+            || self.wcii.last_doc_id() != self.last_doc_id
+        {
+            return read_batch_by_reads(self, batch);
+        }
+
+        let mut last = None;
+        let mut base = self.last_doc_id + 1;
+        while !batch.is_full() && base <= self.max_doc_id {
+            let mut words = [0; WINDOW_WORDS];
+            self.wcii.doc_ids_words(base, &mut words)?;
+            last = batch
+                .push_words(base, &words, self.max_doc_id, RS_FIELDMASK_ALL)
+                .or(last);
+            base += (64 * WINDOW_WORDS) as DocId;
+        }
+
+        // Leave the iterator, and the child, on the last document appended.
+        if let Some(last) = last {
+            let found = matches!(self.skip_to(last)?, Some(SkipToOutcome::Found(_)));
+            debug_assert!(found, "the wildcard's words disagree with its skips");
+        }
+        if !batch.is_full() {
+            self.past_end = true;
+        }
+        Ok(())
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -13,7 +13,9 @@ use index_result::{RSIndexResult, RawIndexResult};
 use ref_mode::{Active, Ref};
 use rqe_core::DocId;
 
-use crate::{IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome};
+use crate::{
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
+};
 use index_spec::IndexSpecReadGuard;
 
 /// A child iterator paired with its original insertion index.
@@ -347,6 +349,55 @@ where
         Ok(Some(&mut self.result))
     }
 
+    /// Full mode batch read - the same steps as [`read_full`](Self::read_full), but the
+    /// aggregate result is only built for the last document appended.
+    fn read_batch_full(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        if QUICK_EXIT {
+            panic!("a quick union reads through read_quick");
+        }
+
+        let start_id = self.last_doc_id();
+        let mut previous_id = start_id;
+        let mut outcome = Ok(());
+        while !batch.is_full() {
+            let next = if previous_id == 0 {
+                self.initialize_children()
+            } else {
+                self.advance_and_find_min(previous_id)
+            };
+            let min_id = match next {
+                Ok(min_id) => min_id,
+                Err(e) => {
+                    outcome = Err(e);
+                    break;
+                }
+            };
+            if min_id == DocId::MAX {
+                self.is_eof = true;
+                break;
+            }
+
+            let mut field_mask = 0;
+            if batch.wants_field_masks() {
+                for child in &mut self.children[..self.num_active] {
+                    if child.last_doc_id() == min_id
+                        && let Some(child_result) = child.current()
+                    {
+                        field_mask |= child_result.field_mask;
+                    }
+                }
+            }
+            batch.push(min_id, field_mask);
+            previous_id = min_id;
+        }
+
+        // Leave the iterator on the last document appended, as `read_full` would have.
+        if previous_id != start_id {
+            self.build_aggregate_result(previous_id);
+        }
+        outcome
+    }
+
     /// Full mode skip_to - scans all active children and aggregates all matches.
     /// Removes exhausted children via swap-remove.
     ///
@@ -549,6 +600,19 @@ where
         }
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        if self.is_eof {
+            return Ok(());
+        }
+
+        if QUICK_EXIT {
+            // A quick union only ever reports a single child, there is no aggregate to save.
+            crate::batch::read_batch_by_reads(self, batch)
+        } else {
+            self.read_batch_full(batch)
+        }
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -31,7 +31,8 @@ use ref_mode::{Active, Ref, SharedPtr};
 use rqe_core::DocId;
 
 use crate::{
-    IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome, UnionFullFlat,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
+    UnionFullFlat,
     c2rust::CRQEIterator,
     interop::RQEIteratorWrapper,
     profile_print::{ProfilePrint, ProfilePrintCtx},
@@ -183,6 +184,11 @@ impl<'index, I: RQEIterator<'index>> RQEIterator<'index> for UnionOpaque<'index,
         delegate_variant_ref_mut!(self, read)
     }
 
+    #[inline(always)]
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        delegate_variant_ref_mut!(self, read_batch, batch)
+    }
+
     #[inline(always)]
     fn skip_to(
         &mut self,
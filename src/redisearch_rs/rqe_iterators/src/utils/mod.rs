@@ -11,12 +11,14 @@
 
 mod min_heap;
 mod owned_slice;
+mod sorted_intersect;
 mod timeout;
 mod timespec;
 
 #[doc(inline)]
 pub use self::owned_slice::OwnedSlice;
 pub use min_heap::{DocIdMinHeap, HeapEntry};
+pub use sorted_intersect::intersect_sorted;
 pub use timeout::{
     AnyTimeoutContext, DeadlineTimeoutChecker, NoTimeoutChecker, TimeoutCheckResult,
     TimeoutChecker, TimeoutContext, TimeoutContextBlockedClient, TimeoutContextDeadline,
@@ -13,14 +13,17 @@ use std::ptr::NonNull;
 
 use index_result::{RSIndexResult, RawIndexResult};
 use index_spec::IndexSpecReadGuard;
-use inverted_index::codec::{doc_ids_only::DocIdsOnly, raw_doc_ids_only::RawDocIdsOnly};
+use inverted_index::codec::{
+    bitmap_doc_ids_only::BitmapDocIdsOnly, doc_ids_only::DocIdsOnly,
+    packed_doc_ids_only::PackedDocIdsOnly, raw_doc_ids_only::RawDocIdsOnly,
+};
 use inverted_index::{DocIdsDecoder, opaque};
 use ref_mode::{Active, Ref, Suspended};
 
 use rqe_core::{DocId, RS_FIELDMASK_ALL};
 
 use crate::{
-    Empty, RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator,
+    DocIdBatch, Empty, RQEIterator, RQEIteratorBoxed, RQEIteratorError, RQESuspendedIterator,
     RQEValidateStatus, ResumeOutcome, SEARCH_ENTERPRISE_ITERATORS, SkipToOutcome,
     profile_print::{ProfilePrint, ProfilePrintCtx},
 };
@@ -131,6 +134,25 @@ impl<'index> RQEIterator<'index> for Wildcard<'index> {
         Ok(Some(&mut self.result))
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        if batch.is_full() || self.exhausted() {
+            return Ok(());
+        }
+
+        // Every ID up to `top_id` is a result, so there is nothing to read.
+        let room = batch.remaining();
+        let n = ((self.top_id - self.result.doc_id) as usize).min(room);
+        for _ in 0..n {
+            self.result.doc_id += 1;
+            batch.push(self.result.doc_id, self.result.field_mask);
+        }
+        if n < room {
+            // The read that would have filled the rest found nothing.
+            self.past_end = true;
+        }
+        Ok(())
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -185,6 +207,24 @@ impl<'index> RQEIterator<'index> for Wildcard<'index> {
     fn intersection_sort_weight(&self, _prioritize_union_children: bool) -> f64 {
         1.0
     }
+
+    fn has_doc_ids_words(&self) -> bool {
+        true
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        // Every ID in `[1, top_id]` is a result, so each word is a mask over that range.
+        for (i, word) in words.iter_mut().enumerate() {
+            let lo = base.saturating_add(64 * i as DocId).max(1);
+            let hi = base.saturating_add(64 * i as DocId + 63).min(self.top_id);
+            if lo > hi {
+                continue;
+            }
+            let (from, to) = ((lo - base) % 64, (hi - base) % 64);
+            *word |= (!0u64 << from) & (!0u64 >> (63 - to));
+        }
+        Ok(())
+    }
 }
 
 impl<'index> RQEIteratorBoxed<'index> for Wildcard<'index> {
@@ -296,11 +336,21 @@ type DocIdsOnlyArm<'query, Rf> = crate::inverted_index::RawWildcard<'query, Rf,
 /// the [`RawDocIdsOnly`] encoding instead.
 type RawDocIdsOnlyArm<'query, Rf> = crate::inverted_index::RawWildcard<'query, Rf, RawDocIdsOnly>;
 
+/// Payload of [`RawOptimizedWildcard::PackedDocIdsOnly`] — [`DocIdsOnlyArm`]
+/// over the [`PackedDocIdsOnly`] encoding instead.
+type PackedDocIdsOnlyArm<'query, Rf> =
+    crate::inverted_index::RawWildcard<'query, Rf, PackedDocIdsOnly>;
+
+/// Payload of [`RawOptimizedWildcard::BitmapDocIdsOnly`] — [`DocIdsOnlyArm`]
+/// over the [`BitmapDocIdsOnly`] encoding instead.
+type BitmapDocIdsOnlyArm<'query, Rf> =
+    crate::inverted_index::RawWildcard<'query, Rf, BitmapDocIdsOnly>;
+
 /// An optimized wildcard iterator over the `existingDocs` inverted index,
 /// parameterised over a [`Ref`] mode.
 ///
-/// The encoding may be either [`DocIdsOnly`] or [`RawDocIdsOnly`], depending on
-/// the index configuration.
+/// The encoding may be [`DocIdsOnly`], [`RawDocIdsOnly`], [`PackedDocIdsOnly`] or
+/// [`BitmapDocIdsOnly`], depending on the index configuration.
 ///
 /// See [`OptimizedWildcard`] for the [`Active`] instantiation that implements
 /// [`RQEIterator`], and [`OptimizedWildcardSuspended`] for its passive carrier
@@ -328,6 +378,10 @@ pub enum RawOptimizedWildcard<'query, Rf: Ref> {
     DocIdsOnly(DocIdsOnlyArm<'query, Rf>),
     /// Optimized wildcard with [`RawDocIdsOnly`] encoding.
     RawDocIdsOnly(RawDocIdsOnlyArm<'query, Rf>),
+    /// Optimized wildcard with [`PackedDocIdsOnly`] encoding.
+    PackedDocIdsOnly(PackedDocIdsOnlyArm<'query, Rf>),
+    /// Optimized wildcard with [`BitmapDocIdsOnly`] encoding.
+    BitmapDocIdsOnly(BitmapDocIdsOnlyArm<'query, Rf>),
 }
 
 /// Alias for an [`Active`] [`RawOptimizedWildcard`] — the only instantiation
@@ -345,6 +399,8 @@ macro_rules! delegate_rqe_iterator {
         match $self {
             Self::DocIdsOnly(it) => it.$method($($arg),*),
             Self::RawDocIdsOnly(it) => it.$method($($arg),*),
+            Self::PackedDocIdsOnly(it) => it.$method($($arg),*),
+            Self::BitmapDocIdsOnly(it) => it.$method($($arg),*),
         }
     };
 }
@@ -359,6 +415,10 @@ impl<'index> RQEIterator<'index> for OptimizedWildcard<'index> {
         delegate_rqe_iterator!(self, read)
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        delegate_rqe_iterator!(self, read_batch, batch)
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -397,6 +457,14 @@ impl<'index> RQEIterator<'index> for OptimizedWildcard<'index> {
     fn intersection_sort_weight(&self, prioritize_union_children: bool) -> f64 {
         delegate_rqe_iterator!(self, intersection_sort_weight, prioritize_union_children)
     }
+
+    fn has_doc_ids_words(&self) -> bool {
+        delegate_rqe_iterator!(self, has_doc_ids_words)
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        delegate_rqe_iterator!(self, doc_ids_words, base, words)
+    }
 }
 
 impl<'index> WildcardIterator<'index> for OptimizedWildcard<'index> {}
@@ -410,6 +478,8 @@ impl crate::profile_print::ProfilePrint for OptimizedWildcard<'_> {
         match self {
             Self::DocIdsOnly(it) => it.print_profile(map, ctx),
             Self::RawDocIdsOnly(it) => it.print_profile(map, ctx),
+            Self::PackedDocIdsOnly(it) => it.print_profile(map, ctx),
+            Self::BitmapDocIdsOnly(it) => it.print_profile(map, ctx),
         }
     }
 }
@@ -466,6 +536,14 @@ const _: () = {
         RawDocIdsOnlyArm<'static, Active<'static>>,
         RawDocIdsOnlyArm<'static, Suspended>,
     >();
+    assert_suspends_to::<
+        PackedDocIdsOnlyArm<'static, Active<'static>>,
+        PackedDocIdsOnlyArm<'static, Suspended>,
+    >();
+    assert_suspends_to::<
+        BitmapDocIdsOnlyArm<'static, Active<'static>>,
+        BitmapDocIdsOnlyArm<'static, Suspended>,
+    >();
 
     // (b)
     assert!(
@@ -484,6 +562,22 @@ const _: () = {
         align_of::<RawDocIdsOnlyArm<'static, Active<'static>>>()
             == align_of::<RawDocIdsOnlyArm<'static, Suspended>>()
     );
+    assert!(
+        size_of::<PackedDocIdsOnlyArm<'static, Active<'static>>>()
+            == size_of::<PackedDocIdsOnlyArm<'static, Suspended>>()
+    );
+    assert!(
+        align_of::<PackedDocIdsOnlyArm<'static, Active<'static>>>()
+            == align_of::<PackedDocIdsOnlyArm<'static, Suspended>>()
+    );
+    assert!(
+        size_of::<BitmapDocIdsOnlyArm<'static, Active<'static>>>()
+            == size_of::<BitmapDocIdsOnlyArm<'static, Suspended>>()
+    );
+    assert!(
+        align_of::<BitmapDocIdsOnlyArm<'static, Active<'static>>>()
+            == align_of::<BitmapDocIdsOnlyArm<'static, Suspended>>()
+    );
 
     // (c)
     assert!(
@@ -520,6 +614,14 @@ impl<'index> RQEIteratorBoxed<'index> for OptimizedWildcard<'index> {
                 // SAFETY: as above.
                 unsafe { crate::boxed::suspend_child_slot_in_place(it as *mut _) }
             }
+            RawOptimizedWildcard::PackedDocIdsOnly(it) => {
+                // SAFETY: as above.
+                unsafe { crate::boxed::suspend_child_slot_in_place(it as *mut _) }
+            }
+            RawOptimizedWildcard::BitmapDocIdsOnly(it) => {
+                // SAFETY: as above.
+                unsafe { crate::boxed::suspend_child_slot_in_place(it as *mut _) }
+            }
         }
         // SAFETY: the payload now holds its `Suspended` form at the same offset,
         // and the tag encodes the same variant in both enums. `Box::from_raw`
@@ -565,6 +667,14 @@ impl<'query> RQESuspendedIterator<'query> for OptimizedWildcardSuspended<'query>
                 // SAFETY: as above.
                 unsafe { crate::boxed::resume_child_slot_in_place(it as *mut _, spec) }
             }
+            RawOptimizedWildcard::PackedDocIdsOnly(it) => {
+                // SAFETY: as above.
+                unsafe { crate::boxed::resume_child_slot_in_place(it as *mut _, spec) }
+            }
+            RawOptimizedWildcard::BitmapDocIdsOnly(it) => {
+                // SAFETY: as above.
+                unsafe { crate::boxed::resume_child_slot_in_place(it as *mut _, spec) }
+            }
         };
 
         match outcome {
@@ -614,6 +724,8 @@ impl<'query> RQESuspendedIterator<'query> for OptimizedWildcardSuspended<'query>
         match self {
             RawOptimizedWildcard::DocIdsOnly(it) => RQESuspendedIterator::last_doc_id(it),
             RawOptimizedWildcard::RawDocIdsOnly(it) => RQESuspendedIterator::last_doc_id(it),
+            RawOptimizedWildcard::PackedDocIdsOnly(it) => RQESuspendedIterator::last_doc_id(it),
+            RawOptimizedWildcard::BitmapDocIdsOnly(it) => RQESuspendedIterator::last_doc_id(it),
         }
     }
 
@@ -621,6 +733,8 @@ impl<'query> RQESuspendedIterator<'query> for OptimizedWildcardSuspended<'query>
         match self {
             RawOptimizedWildcard::DocIdsOnly(it) => RQESuspendedIterator::num_estimated(it),
             RawOptimizedWildcard::RawDocIdsOnly(it) => RQESuspendedIterator::num_estimated(it),
+            RawOptimizedWildcard::PackedDocIdsOnly(it) => RQESuspendedIterator::num_estimated(it),
+            RawOptimizedWildcard::BitmapDocIdsOnly(it) => RQESuspendedIterator::num_estimated(it),
         }
     }
 }
@@ -647,6 +761,10 @@ impl<'index> RQEIterator<'index> for NewWildcardIterator<'index> {
         delegate_wildcard_iterator!(self, read)
     }
 
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        delegate_wildcard_iterator!(self, read_batch, batch)
+    }
+
     fn skip_to(
         &mut self,
         doc_id: DocId,
@@ -699,6 +817,14 @@ impl<'index> RQEIterator<'index> for NewWildcardIterator<'index> {
     fn intersection_sort_weight(&self, prioritize_union_children: bool) -> f64 {
         delegate_wildcard_iterator!(self, intersection_sort_weight, prioritize_union_children)
     }
+
+    fn has_doc_ids_words(&self) -> bool {
+        delegate_wildcard_iterator!(self, has_doc_ids_words)
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        delegate_wildcard_iterator!(self, doc_ids_words, base, words)
+    }
 }
 
 impl<'index> WildcardIterator<'index> for NewWildcardIterator<'index> {}
@@ -707,9 +833,8 @@ impl<'index> WildcardIterator<'index> for NewWildcardIterator<'index> {}
 /// [`SchemaRule`](ffi::SchemaRule)`.index_all` set.
 ///
 /// When [`spec.existingDocs`](ffi::IndexSpec::existingDocs) is non-null, the returned iterator
-/// reads from the existing-documents inverted index (either
-/// [`DocIdsOnly`] or [`RawDocIdsOnly`]
-/// encoding). When it is null (no documents indexed yet), an [`Empty`] iterator
+/// reads from the existing-documents inverted index ([`DocIdsOnly`],
+/// [`RawDocIdsOnly`], [`PackedDocIdsOnly`] or [`BitmapDocIdsOnly`] encoding). When it is null (no documents indexed yet), an [`Empty`] iterator
 /// is returned instead.
 ///
 /// # Safety
@@ -721,9 +846,8 @@ impl<'index> WildcardIterator<'index> for NewWildcardIterator<'index> {}
 /// 3. `sctx.spec.rule` must be a non-null pointer to a valid [`SchemaRule`](ffi::SchemaRule) with
 ///    [`index_all`](ffi::SchemaRule::index_all) set to `true`.
 /// 4. `sctx.spec.existingDocs`, when non-null, must point to a valid
-///    [`opaque::InvertedIndex`] with either
-///    [`DocIdsOnly`] or [`RawDocIdsOnly`]
-///    encoding.
+///    [`opaque::InvertedIndex`] with [`DocIdsOnly`], [`RawDocIdsOnly`],
+///    [`PackedDocIdsOnly`] or [`BitmapDocIdsOnly`] encoding.
 pub unsafe fn new_wildcard_iterator_optimized<'index>(
     sctx: NonNull<ffi::RedisSearchCtx>,
     weight: f64,
@@ -742,8 +866,8 @@ pub unsafe fn new_wildcard_iterator_optimized<'index>(
         Some(existing_docs) => {
             let ii = existing_docs.cast::<opaque::InvertedIndex>();
             // SAFETY: Caller guarantees `existingDocs` points to a valid
-            // `opaque::InvertedIndex` with `DocIdsOnly` or `RawDocIdsOnly`
-            // encoding (4).
+            // `opaque::InvertedIndex` with `DocIdsOnly`, `RawDocIdsOnly`,
+            // `PackedDocIdsOnly` or `BitmapDocIdsOnly` encoding (4).
             let ii_ref = unsafe { ii.as_ref() };
             let optimized = match ii_ref {
                 opaque::InvertedIndex::DocIdsOnly(ii) => OptimizedWildcard::DocIdsOnly(
@@ -752,6 +876,12 @@ pub unsafe fn new_wildcard_iterator_optimized<'index>(
                 opaque::InvertedIndex::RawDocIdsOnly(ii) => OptimizedWildcard::RawDocIdsOnly(
                     crate::inverted_index::Wildcard::new(ii.reader(), weight),
                 ),
+                opaque::InvertedIndex::PackedDocIdsOnly(ii) => OptimizedWildcard::PackedDocIdsOnly(
+                    crate::inverted_index::Wildcard::new(ii.reader(), weight),
+                ),
+                opaque::InvertedIndex::BitmapDocIdsOnly(ii) => OptimizedWildcard::BitmapDocIdsOnly(
+                    crate::inverted_index::Wildcard::new(ii.reader(), weight),
+                ),
                 _ => panic!("spec.existingDocs has the wrong inverted index type: {ii_ref:?}"),
             };
             NewWildcardIterator::Optimized(optimized)
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+use std::{cell::Cell, collections::BTreeSet};
+
+use ffi::IndexFlags_Index_StoreFreqs;
+use index_result::RSIndexResult;
+use inverted_index::{IndexReaderCore, InvertedIndex, freqs_only::FreqsOnly};
+use query_term::RSQueryTerm;
+use rqe_core::DocId;
+use rqe_iterators::{
+    BlockMaxWand, IteratorType, NoOpChecker, RQEIterator, ScoreBoundedIterator, SkipToOutcome,
+    inverted_index::Term,
+};
+use rqe_iterators_test_utils::MockContext;
+
+const NUM_DOCS: DocId = 3_000;
+
+type TermIt<'index> = Term<'index, IndexReaderCore<'index, FreqsOnly>, NoOpChecker>;
+
+fn doc_len(doc_id: DocId) -> u32 {
+    5 + (doc_id * 7_919 % 50) as u32
+}
+
+fn avg_doc_len() -> f64 {
+    (1..=NUM_DOCS).map(|d| doc_len(d) as f64).sum::<f64>() / NUM_DOCS as f64
+}
+
+/// The postings of each term, as `(doc_id, freq)` pairs. The second term is frequent in
+/// a narrow range of documents only, so the blocks around it have low bounds.
+fn postings() -> Vec<Vec<(DocId, u32)>> {
+    vec![
+        (1..=NUM_DOCS)
+            .filter(|d| d % 2 == 0)
+            .map(|d| (d, 1 + (d % 3) as u32))
+            .collect(),
+        (1..=NUM_DOCS)
+            .filter(|d| d % 3 == 0)
+            .map(|d| (d, if (1_200..1_300).contains(&d) { 20 } else { 1 }))
+            .collect(),
+        (1..=NUM_DOCS)
+            .filter(|d| d % 7 == 0)
+            .map(|d| (d, 1 + (d % 5) as u32))
+            .collect(),
+    ]
+}
+
+struct WandTest {
+    indexes: Vec<InvertedIndex<FreqsOnly>>,
+    mock_ctx: MockContext,
+    threshold: Cell<f64>,
+}
+
+impl WandTest {
+    fn new() -> Self {
+        let indexes = postings()
+            .into_iter()
+            .map(|postings| {
+                let mut ii = InvertedIndex::<FreqsOnly>::new(IndexFlags_Index_StoreFreqs);
+                for (doc_id, freq) in postings {
+                    let record = RSIndexResult::build_term()
+                        .doc_id(doc_id)
+                        .frequency(freq)
+                        .build();
+                    ii.add_record_with_doc_len(&record, doc_len(doc_id))
+                        .unwrap();
+                }
+                ii
+            })
+            .collect();
+
+        Self {
+            indexes,
+            mock_ctx: MockContext::new(NUM_DOCS, NUM_DOCS as usize),
+            threshold: Cell::new(0.0),
+        }
+    }
+
+    fn terms(&self) -> Vec<TermIt<'_>> {
+        self.indexes
+            .iter()
+            .enumerate()
+            .map(|(i, ii)| unsafe {
+                Term::new(
+                    ii.reader(),
+                    self.mock_ctx.sctx(),
+                    RSQueryTerm::new(&format!("term{i}"), i as i32 + 1, 0),
+                    1.0,
+                    NoOpChecker,
+                )
+            })
+            .collect()
+    }
+
+    fn create_iterator(&self) -> BlockMaxWand<'_, TermIt<'_>> {
+        BlockMaxWand::new(self.terms(), 1.0, avg_doc_len(), &self.threshold)
+    }
+
+    /// The `BM25STD` score of every matching document, computed from the postings.
+    fn expected_scores(&self) -> Vec<(DocId, f64)> {
+        let idfs: Vec<f64> = self.terms().iter().map(|t| t.term_weight()).collect();
+        let mut scores = vec![0.0; NUM_DOCS as usize + 1];
+        let mut matched = BTreeSet::new();
+        for (postings, idf) in postings().iter().zip(&idfs) {
+            for (doc_id, freq) in postings {
+                scores[*doc_id as usize] += idf * bm25(*freq, doc_len(*doc_id));
+                matched.insert(*doc_id);
+            }
+        }
+        matched
+            .into_iter()
+            .map(|d| (d, scores[d as usize]))
+            .collect()
+    }
+}
+
+fn bm25(freq: u32, doc_len: u32) -> f64 {
+    let f = freq as f64;
+    f * 2.2 / (f + 1.2 * (0.25 + 0.75 * doc_len as f64 / avg_doc_len()))
+}
+
+/// Score a union result from its children, the way the `BM25STD` scorer does.
+fn score(result: &RSIndexResult<'_>) -> f64 {
+    result
+        .as_aggregate()
+        .expect("Expected aggregate result")
+        .iter()
+        .map(|child| {
+            let term = child.as_term().unwrap().query_term().unwrap();
+            child.weight * term.bm25_idf() * bm25(child.freq, doc_len(result.doc_id))
+        })
+        .sum::<f64>()
+        * result.weight
+}
+
+#[test]
+fn block_max_wand_type() {
+    let test = WandTest::new();
+    let it = test.create_iterator();
+    assert_eq!(it.type_(), IteratorType::BlockMaxWand);
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn block_max_wand_without_threshold_reads_the_union() {
+    let test = WandTest::new();
+    let expected = test.expected_scores();
+    let mut it = test.create_iterator();
+
+    for (doc_id, expected_score) in &expected {
+        let result = it.read().unwrap().expect("the union has more documents");
+        assert_eq!(result.doc_id, *doc_id);
+        approx::assert_relative_eq!(score(result), *expected_score, max_relative = 1e-9);
+    }
+    assert!(it.read().unwrap().is_none());
+    assert!(it.at_eof());
+
+    // Rewinding starts over from the first document.
+    it.rewind();
+    assert_eq!(it.read().unwrap().map(|r| r.doc_id), Some(expected[0].0));
+}
+
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn block_max_wand_skip_to() {
+    let test = WandTest::new();
+    let mut it = test.create_iterator();
+
+    // 14 is matched by the first and third terms.
+    match it.skip_to(14).unwrap() {
+        Some(SkipToOutcome::Found(result)) => {
+            assert_eq!(result.doc_id, 14);
+            assert_eq!(result.as_aggregate().unwrap().len(), 2);
+        }
+        other => panic!("expected to find doc 14, got {other:?}"),
+    }
+
+    // 1_001 is matched by no term, 1_002 by the first two.
+    match it.skip_to(1_001).unwrap() {
+        Some(SkipToOutcome::NotFound(result)) => assert_eq!(result.doc_id, 1_002),
+        other => panic!("expected to land on doc 1002, got {other:?}"),
+    }
+
+    assert!(it.skip_to(NUM_DOCS + 1).unwrap().is_none());
+    assert!(it.at_eof());
+}
+
+/// Drive the iterator the way the sorter does: keep the `k` best scores and raise the
+/// threshold to the worst of them once there are `k`. The top results must match the ones
+/// found by scoring every document, while fewer documents are read.
+#[test]
+#[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+fn block_max_wand_keeps_the_top_k() {
+    const K: usize = 10;
+
+    let test = WandTest::new();
+    let expected = test.expected_scores();
+    let mut it = test.create_iterator();
+
+    let mut top: Vec<f64> = Vec::with_capacity(K + 1);
+    let mut num_read = 0;
+    while let Some(result) = it.read().unwrap() {
+        num_read += 1;
+        top.push(score(result));
+        top.sort_by(|a, b| b.total_cmp(a));
+        top.truncate(K);
+        if top.len() == K {
+            test.threshold.set(top[K - 1]);
+        }
+    }
+
+    let mut expected_top: Vec<f64> = expected.iter().map(|(_, s)| *s).collect();
+    expected_top.sort_by(|a, b| b.total_cmp(a));
+    expected_top.truncate(K);
+
+    assert_eq!(top.len(), K);
+    for (actual, expected) in top.iter().zip(&expected_top) {
+        approx::assert_relative_eq!(actual, expected, max_relative = 1e-9);
+    }
+    assert!(
+        num_read < expected.len(),
+        "read all {num_read} documents without skipping any"
+    );
+}
@@ -11,7 +11,7 @@
 
 use rqe_core::DocId;
 use rqe_iterators::{
-    IteratorType, RQEIterator, RQEValidateStatus, SkipToOutcome, id_list::IdListSorted,
+    DocIdBatch, IteratorType, RQEIterator, RQEValidateStatus, SkipToOutcome, id_list::IdListSorted,
     intersection::Intersection, profile::Profile,
 };
 
@@ -146,6 +146,44 @@ fn read_test_case(num_children: usize, result_set: &[DocId]) {
     );
 }
 
+#[test]
+#[cfg_attr(miri, ignore = "Too slow under miri")]
+fn read_batch_all_combinations() {
+    for &num_children in NUM_CHILDREN_CASES {
+        for &result_set in RESULT_SET_CASES {
+            read_batch_test_case(num_children, result_set);
+        }
+    }
+}
+
+/// Reading in batches yields what reading one at a time does, and leaves the
+/// iterator where the reads would have.
+fn read_batch_test_case(num_children: usize, result_set: &[DocId]) {
+    let mut ii = ContractChecker::new(Intersection::new(
+        create_children(num_children, result_set),
+        1.0,
+        false,
+    ));
+    let mut doc_ids = [0; 4];
+    let mut masks = [0; 4];
+
+    let mut read = Vec::new();
+    loop {
+        let mut batch = DocIdBatch::new(&mut doc_ids, Some(&mut masks));
+        ii.read_batch(&mut batch).unwrap();
+        read.extend_from_slice(batch.doc_ids());
+        if !batch.is_full() {
+            break;
+        }
+        // Standing on the last entry, with the aggregate a read would have built.
+        let current = ii.current().unwrap();
+        assert_eq!(current.doc_id, *batch.doc_ids().last().unwrap());
+        assert_eq!(current.as_aggregate().unwrap().len(), num_children);
+    }
+    assert_eq!(read, result_set, "num_children={num_children}");
+    assert!(ii.at_eof());
+}
+
 #[test]
 #[cfg_attr(miri, ignore = "Takes too long with Miri")]
 fn skip_to_all_combinations() {
@@ -1538,3 +1576,139 @@ fn intersection_upholds_current_contract() {
     assert_eq!(assert_current_contract(&mut it), [2, 3]);
     assert_current_contract_via_skip_to(&mut it, 10);
 }
+
+/// Intersections of tag iterators, which gather candidates a postings block at a time.
+mod doc_ids_blocks {
+    use ffi::IndexFlags_Index_DocIdsOnly;
+    use index_result::RSIndexResult;
+    use inverted_index::{InvertedIndex, doc_ids_only::DocIdsOnly};
+    use iterators_ffi::inverted_index::CTagIndexLookup;
+    use query_term::RSQueryTerm;
+    use rqe_core::{DocId, RS_FIELDMASK_ALL};
+    use rqe_iterators::{
+        NoOpChecker, RQEIterator, SkipToOutcome, intersection::Intersection, inverted_index::Tag,
+    };
+    use rqe_iterators_test_utils::{ContractChecker, MockContext};
+
+    const NUM_DOCS: DocId = 20_000;
+
+    type TagIt<'index> = ContractChecker<Tag<'index, DocIdsOnly, CTagIndexLookup, NoOpChecker>>;
+
+    /// Every tag spans many blocks; the last one is rare, so its blocks span wide ranges.
+    fn postings() -> Vec<Vec<DocId>> {
+        [2, 3, 7, 101]
+            .into_iter()
+            .map(|step| (1..=NUM_DOCS).filter(|d| d % step == 0).collect())
+            .collect()
+    }
+
+    fn expected() -> Vec<DocId> {
+        (1..=NUM_DOCS)
+            .filter(|d| d % (2 * 3 * 7 * 101) == 0)
+            .collect()
+    }
+
+    struct BlocksTest {
+        indexes: Vec<InvertedIndex<DocIdsOnly>>,
+        mock_ctx: MockContext,
+    }
+
+    impl BlocksTest {
+        fn new() -> Self {
+            let indexes = postings()
+                .into_iter()
+                .map(|doc_ids| {
+                    let mut ii = InvertedIndex::<DocIdsOnly>::new(IndexFlags_Index_DocIdsOnly);
+                    for doc_id in doc_ids {
+                        let record = RSIndexResult::build_term()
+                            .doc_id(doc_id)
+                            .field_mask(RS_FIELDMASK_ALL)
+                            .build();
+                        ii.add_record(&record).unwrap();
+                    }
+                    ii
+                })
+                .collect();
+            Self {
+                indexes,
+                mock_ctx: MockContext::new(0, 0),
+            }
+        }
+
+        fn create_iterator(&self) -> Intersection<'_, TagIt<'_>> {
+            let children = self
+                .indexes
+                .iter()
+                .map(|ii| {
+                    // SAFETY: `mock_ctx` provides a valid `RedisSearchCtx` that outlives the
+                    // iterator, and `NoOpChecker` never triggers tag index lookups.
+                    let tag = unsafe {
+                        Tag::new(
+                            ii.reader(),
+                            self.mock_ctx.sctx(),
+                            CTagIndexLookup::new(self.mock_ctx.tag_index()),
+                            RSQueryTerm::new("tag", 0, 0),
+                            1.0,
+                            NoOpChecker,
+                        )
+                    };
+                    ContractChecker::new(tag)
+                })
+                .collect();
+            Intersection::new(children, 1.0, false)
+        }
+    }
+
+    #[test]
+    fn children_have_blocks() {
+        let test = BlocksTest::new();
+        let it = test.create_iterator();
+        for i in 0..it.num_children() {
+            assert!(it.child_at(i).has_doc_ids_blocks());
+        }
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+    fn read() {
+        let test = BlocksTest::new();
+        let mut it = ContractChecker::new(test.create_iterator());
+
+        for doc_id in expected() {
+            let result = it
+                .read()
+                .unwrap()
+                .expect("the intersection has more documents");
+            assert_eq!(result.doc_id, doc_id);
+            assert_eq!(result.as_aggregate().unwrap().len(), 4);
+        }
+        assert!(it.read().unwrap().is_none());
+        assert!(it.at_eof());
+
+        it.rewind();
+        assert_eq!(it.read().unwrap().map(|r| r.doc_id), Some(expected()[0]));
+    }
+
+    #[test]
+    #[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+    fn skip_to() {
+        let test = BlocksTest::new();
+        let mut it = ContractChecker::new(test.create_iterator());
+        let expected = expected();
+
+        // Land exactly on a match, then between matches, crossing several blocks each time.
+        match it.skip_to(expected[3]).unwrap() {
+            Some(SkipToOutcome::Found(result)) => assert_eq!(result.doc_id, expected[3]),
+            other => panic!("expected to find doc {}, got {other:?}", expected[3]),
+        }
+        match it.skip_to(expected[7] - 1).unwrap() {
+            Some(SkipToOutcome::NotFound(result)) => assert_eq!(result.doc_id, expected[7]),
+            other => panic!("expected to land on doc {}, got {other:?}", expected[7]),
+        }
+        // Reading goes on from there.
+        assert_eq!(it.read().unwrap().map(|r| r.doc_id), Some(expected[8]));
+
+        assert!(it.skip_to(expected.last().unwrap() + 1).unwrap().is_none());
+        assert!(it.at_eof());
+    }
+}
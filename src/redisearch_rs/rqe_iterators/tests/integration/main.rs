@@ -32,6 +32,7 @@ use rstest_reuse::template;
 ])]
 fn id_cases(#[case] case: &[u64]) {}
 
+mod block_max_wand;
 mod c2rust;
 mod contract_checker;
 mod deferred;
@@ -56,6 +57,7 @@ mod profilable;
 mod profile;
 #[cfg(not(miri))]
 mod profile_print;
+mod sorted_intersect;
 mod timeout_context;
 #[macro_use]
 mod union_common;
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+//! Tests for the sorted document ID intersection kernels.
+
+use std::collections::BTreeSet;
+
+use proptest::prelude::*;
+use rqe_core::DocId;
+use rqe_iterators::utils::intersect_sorted;
+
+fn intersect(a: &[DocId], b: &[DocId]) -> Vec<DocId> {
+    let mut out = Vec::new();
+    intersect_sorted(a, b, &mut out);
+    out
+}
+
+#[test]
+fn empty_inputs() {
+    assert!(intersect(&[], &[]).is_empty());
+    assert!(intersect(&[1, 2, 3], &[]).is_empty());
+    assert!(intersect(&[], &[1, 2, 3]).is_empty());
+}
+
+#[test]
+fn appends_to_the_output() {
+    let mut out = vec![1];
+    intersect_sorted(&[2, 4, 6], &[4, 5, 6], &mut out);
+    assert_eq!(out, [1, 4, 6]);
+}
+
+#[test]
+fn scan_covers_full_chunks_and_the_tail() {
+    // 20 IDs: two full chunks of the scanning kernel and a tail of 4.
+    let large: Vec<DocId> = (1..=20).map(|i| i * 3).collect();
+    let small = [3, 4, 24, 25, 48, 57, 60, 61];
+    assert_eq!(intersect(&small, &large), [3, 24, 48, 57, 60]);
+    assert_eq!(intersect(&large, &small), [3, 24, 48, 57, 60]);
+}
+
+#[test]
+fn gallops_over_a_much_longer_side() {
+    let large: Vec<DocId> = (1..=10_000).collect();
+    let small = [1, 777, 5_000, 9_999, 10_000, 10_001];
+    assert_eq!(intersect(&small, &large), [1, 777, 5_000, 9_999, 10_000]);
+}
+
+proptest! {
+    #[test]
+    #[cfg_attr(miri, ignore = "Too slow to be run under miri.")]
+    fn matches_a_naive_intersection(
+        a in proptest::collection::btree_set(1..5_000 as DocId, 0..600),
+        b in proptest::collection::btree_set(1..5_000 as DocId, 0..40),
+    ) {
+        let a: Vec<DocId> = a.into_iter().collect();
+        let b: Vec<DocId> = b.into_iter().collect();
+        let expected: Vec<DocId> = a
+            .iter()
+            .collect::<BTreeSet<_>>()
+            .intersection(&b.iter().collect())
+            .map(|&&id| id)
+            .collect();
+        prop_assert_eq!(&intersect(&a, &b), &expected);
+        prop_assert_eq!(&intersect(&b, &a), &expected);
+    }
+}
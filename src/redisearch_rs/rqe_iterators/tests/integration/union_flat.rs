@@ -20,7 +20,7 @@ mod common {
 }
 
 use crate::utils::{Mock, MockRevalidateResult, create_mock_2, create_mock_3};
-use rqe_iterators::{RQEIterator, UnionFullFlat, UnionQuickFlat};
+use rqe_iterators::{DocIdBatch, RQEIterator, UnionFullFlat, UnionQuickFlat};
 use rqe_iterators_test_utils::ContractChecker;
 
 // =============================================================================
@@ -148,6 +148,34 @@ fn union_full_flat_upholds_current_contract() {
     assert_current_contract_via_skip_to(&mut it, 5);
 }
 
+#[test]
+fn read_batch_full_flat() {
+    let children: Vec<Box<dyn RQEIterator<'static>>> = vec![
+        Box::new(Mock::new([1u64, 3, 5, 7])),
+        Box::new(Mock::new([2u64, 3, 6, 7, 8])),
+    ];
+    let mut it = ContractChecker::new(UnionFullFlat::new(children));
+    let mut doc_ids = [0; 3];
+    let mut masks = [0; 3];
+
+    let mut batch = DocIdBatch::new(&mut doc_ids, Some(&mut masks));
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [1, 2, 3]);
+    // The union stands on doc 3 with both children in its aggregate, as after a read.
+    let current = it.current().unwrap();
+    assert_eq!(current.doc_id, 3);
+    assert_eq!(current.as_aggregate().unwrap().len(), 2);
+
+    let mut batch = DocIdBatch::new(&mut doc_ids, None);
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [5, 6, 7]);
+
+    let mut batch = DocIdBatch::new(&mut doc_ids, None);
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [8]);
+    assert!(it.at_eof());
+}
+
 /// `skip_to_quick` returns on the first exact match, so a later sibling can still
 /// be unread after many reads. A revalidation must not read that child's
 /// `last_doc_id() == 0` as a position: doc 0 sorts ahead of every real id, so the
@@ -7,7 +7,8 @@
  * GNU Affero General Public License v3 (AGPLv3).
 */
 
-use rqe_iterators::{IteratorType, RQEIterator, SkipToOutcome, wildcard::Wildcard};
+use rqe_core::RS_FIELDMASK_ALL;
+use rqe_iterators::{DocIdBatch, IteratorType, RQEIterator, SkipToOutcome, wildcard::Wildcard};
 use rqe_iterators_test_utils::ContractChecker;
 
 /// Helper macro to assert skip_to result with expected doc_id
@@ -290,6 +291,42 @@ fn skip_to_same_position() {
     let _ = it.skip_to(5);
 }
 
+#[test]
+fn read_batch() {
+    let mut it = ContractChecker::new(Wildcard::new(10, 1.0));
+    let mut doc_ids = [0; 4];
+
+    // A full batch leaves the iterator on its last entry.
+    let mut batch = DocIdBatch::new(&mut doc_ids, None);
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [1, 2, 3, 4]);
+    assert_eq!(it.current().unwrap().doc_id, 4);
+
+    // Reads and batches can be mixed.
+    assert_eq!(it.read().unwrap().unwrap().doc_id, 5);
+
+    let mut masks = [0; 4];
+    let mut batch = DocIdBatch::new(&mut doc_ids, Some(&mut masks));
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [6, 7, 8, 9]);
+    assert_eq!(batch.field_masks().unwrap(), [RS_FIELDMASK_ALL; 4]);
+
+    // A partial batch means the iterator is depleted.
+    let mut batch = DocIdBatch::new(&mut doc_ids, None);
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [10]);
+    assert!(it.at_eof());
+
+    let mut batch = DocIdBatch::new(&mut doc_ids, None);
+    it.read_batch(&mut batch).unwrap();
+    assert!(batch.is_empty());
+
+    it.rewind();
+    let mut batch = DocIdBatch::new(&mut doc_ids, None);
+    it.read_batch(&mut batch).unwrap();
+    assert_eq!(batch.doc_ids(), [1, 2, 3, 4]);
+}
+
 #[test]
 fn wildcard_upholds_current_contract() {
     use rqe_iterators_test_utils::{assert_current_contract, assert_current_contract_via_skip_to};
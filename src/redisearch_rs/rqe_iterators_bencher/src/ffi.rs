@@ -221,7 +221,14 @@ impl InvertedIndex {
     #[inline(always)]
     pub fn new(flags: ffi::IndexFlags) -> Self {
         let mut memsize = 0;
-        let ptr = inverted_index_ffi::NewInvertedIndex_Ex(flags, false, false, &mut memsize);
+        let ptr = inverted_index_ffi::NewInvertedIndex_Ex(
+            flags,
+            false,
+            false,
+            false,
+            false,
+            &mut memsize,
+        );
         Self {
             ii: ptr.cast(),
             sctx: new_search_ctx(),
@@ -20,7 +20,8 @@ use index_result::RSIndexResult;
 use index_spec::IndexSpecReadGuard;
 use rqe_core::DocId;
 use rqe_iterators::{
-    IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome, c2rust,
+    DocIdBatch, IteratorType, RQEIterator, RQEIteratorError, RQEValidateStatus, SkipToOutcome,
+    c2rust,
 };
 
 /// Where the checker believes the wrapped iterator stands, updated on every
@@ -311,6 +312,26 @@ impl<'index, I: RQEIterator<'index>> ContractChecker<I> {
         }
     }
 
+    /// Panic if `id`, yielded after `previous_id` with no rewind in between,
+    /// breaks the [`Ordering`] the iterator was wrapped with.
+    #[track_caller]
+    fn assert_follows(&self, op: &str, previous_id: DocId, id: DocId) {
+        match self.ordering {
+            Ordering::Strict => assert!(
+                id > previous_id,
+                "{op}: doc ids must strictly ascend between rewinds, but {id} follows \
+                 {previous_id} — wrap an iterator that repeats a doc id with \
+                 `ContractChecker::new_with_duplicates`, or a deliberately unordered one with \
+                 `new_unordered`",
+            ),
+            Ordering::NonDecreasing => assert!(
+                id >= previous_id,
+                "{op}: doc ids must not descend between rewinds, but {id} follows {previous_id}",
+            ),
+            Ordering::Unordered => {}
+        }
+    }
+
     /// Re-check that every accessor still answers as the tracked
     /// [`Position`] says, for an operation that promised not to move the
     /// iterator.
@@ -456,27 +477,67 @@ impl<'index, I: RQEIterator<'index>> RQEIterator<'index> for ContractChecker<I>
                 );
                 self.assert_may_yield_while_unread("read", previous, id);
                 if let Position::On(previous_id) = previous {
-                    match self.ordering {
-                        Ordering::Strict => assert!(
-                            id > previous_id,
-                            "read: doc ids must strictly ascend between rewinds, but {id} follows \
-                             {previous_id} — wrap an iterator that repeats a doc id with \
-                             `ContractChecker::new_with_duplicates`, or a deliberately unordered \
-                             one with `new_unordered`",
-                        ),
-                        Ordering::NonDecreasing => assert!(
-                            id >= previous_id,
-                            "read: doc ids must not descend between rewinds, but {id} follows \
-                             {previous_id}",
-                        ),
-                        Ordering::Unordered => {}
-                    }
+                    self.assert_follows("read", previous_id, id);
                 }
                 Ok(Some(self.after_yield("read", id, yielded)))
             }
         }
     }
 
+    /// Checked as the equivalent sequence of [`read`](RQEIterator::read)s:
+    /// the ids appended follow the position and each other in order, and the
+    /// iterator ends up on the last of them if the batch was filled, or
+    /// exhausted otherwise.
+    #[track_caller]
+    fn read_batch(&mut self, batch: &mut DocIdBatch<'_>) -> Result<(), RQEIteratorError> {
+        self.assert_usable("read_batch");
+        let previous = self.position;
+        let start = batch.len();
+        let room = batch.remaining();
+        let outcome = self.inner.read_batch(batch);
+
+        let appended = &batch.doc_ids()[start..];
+        if let Some(&first) = appended.first() {
+            assert_ne!(
+                previous,
+                Position::PastEnd,
+                "read_batch: an exhausted iterator must keep returning nothing, but it appended \
+                 doc {first}",
+            );
+            self.assert_may_yield_while_unread("read_batch", previous, first);
+        }
+        let mut last = match previous {
+            Position::On(id) => Some(id),
+            Position::Unread | Position::PastEnd => None,
+        };
+        for &id in appended {
+            if let Some(previous_id) = last {
+                self.assert_follows("read_batch", previous_id, id);
+            }
+            last = Some(id);
+        }
+        let last_appended = appended.last().copied();
+        let appended = appended.len();
+        self.yielded += appended;
+        self.assert_estimate_bounds_yields("read_batch");
+
+        if let Err(error) = outcome {
+            // Like a failed read, the error says nothing about the position
+            // beyond the entries handed out before it.
+            if let Some(id) = last_appended {
+                self.position = Position::On(id);
+            }
+            return Err(error);
+        }
+        if appended < room {
+            self.after_exhaustion("read_batch");
+        } else if let Some(id) = last_appended {
+            self.position = Position::On(id);
+            self.assert_position_unchanged("read_batch");
+        }
+        Ok(())
+    }
+
     #[track_caller]
     fn skip_to(
         &mut self,
@@ -708,4 +769,43 @@ impl<'index, I: RQEIterator<'index>> RQEIterator<'index> for ContractChecker<I>
         self.inner
             .intersection_sort_weight(prioritize_union_children)
     }
+
+    fn has_doc_ids_blocks(&self) -> bool {
+        self.inner.has_doc_ids_blocks()
+    }
+
+    fn doc_ids_block(&self, doc_id: DocId, out: &mut Vec<DocId>) -> Result<bool, RQEIteratorError> {
+        let last_doc_id = self.inner.last_doc_id();
+        let found = self.inner.doc_ids_block(doc_id, out)?;
+        assert_eq!(
+            self.inner.last_doc_id(),
+            last_doc_id,
+            "doc_ids_block moved the iterator"
+        );
+        assert!(
+            out.is_sorted(),
+            "doc_ids_block returned unsorted doc ids: {out:?}"
+        );
+        assert_eq!(
+            found,
+            !out.is_empty(),
+            "doc_ids_block outcome and buffer disagree"
+        );
+        Ok(found)
+    }
+
+    fn has_doc_ids_words(&self) -> bool {
+        self.inner.has_doc_ids_words()
+    }
+
+    fn doc_ids_words(&self, base: DocId, words: &mut [u64]) -> Result<(), RQEIteratorError> {
+        let last_doc_id = self.inner.last_doc_id();
+        self.inner.doc_ids_words(base, words)?;
+        assert_eq!(
+            self.inner.last_doc_id(),
+            last_doc_id,
+            "doc_ids_words moved the iterator"
+        );
+        Ok(())
+    }
 }
@@ -669,6 +669,8 @@ impl TestContext {
             ffi::IndexFlags_Index_DocIdsOnly,
             false,
             false,
+            false,
+            false,
             &mut memsize,
         );
         let ii = ptr::NonNull::new(ii_ptr.cast()).expect("Failed to create InvertedIndex");
@@ -734,6 +736,8 @@ impl TestContext {
             ffi::IndexFlags_Index_DocIdsOnly,
             false,
             false,
+            false,
+            false,
             &mut memsize,
         );
         let ii = ptr::NonNull::new(ii_ptr.cast()).expect("Failed to create InvertedIndex");
@@ -876,7 +880,7 @@ impl TestContext {
             next: ptr::null_mut(),
             docId: record.doc_id,
             freq: record.freq,
-            __bindgen_padding_0: 0,
+            docLen: 0,
             fieldMask: record.field_mask,
             term: term.as_ptr(),
             len: term.to_bytes().len() as u32,
@@ -17,6 +17,7 @@
 #include "value_ffi.h"
 #include "rmutil/rm_assert.h"
 #include "rmalloc.h"
+#include "buffer.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -115,13 +116,105 @@ static inline void json_add_close(RedisModule_Reply *reply, const char *s) {}
 
 //---------------------------------------------------------------------------------------------
 
+typedef enum {
+  ReplyOp_LongLong,
+  ReplyOp_Double,
+  ReplyOp_SimpleString,
+  ReplyOp_StringBuffer,
+  ReplyOp_Null,
+  ReplyOp_Error,
+  ReplyOp_Map,
+  ReplyOp_MapEnd,
+  ReplyOp_Array,
+  ReplyOp_ArrayEnd,
+  ReplyOp_Set,
+  ReplyOp_SetEnd,
+  ReplyOp_EmptyArray,
+  ReplyOp_EmptyMap,
+} ReplyOpType;
+
+typedef struct {
+  ReplyOpType type;
+  union {
+    long long ll;
+    double d;
+    // string payload, as an offset into the recording's `strings`
+    struct {
+      size_t offset;
+      size_t len;
+    } str;
+  };
+} ReplyOp;
+
+struct ReplyRecording {
+  arrayof(ReplyOp) ops;
+  // NUL-terminated payloads of the string elements
+  Buffer strings;
+};
+
+ReplyRecording *ReplyRecording_New(void) {
+  ReplyRecording *rec = rm_malloc(sizeof(*rec));
+  rec->ops = array_new(ReplyOp, 16);
+  Buffer_Init(&rec->strings, 256);
+  return rec;
+}
+
+void ReplyRecording_Free(ReplyRecording *rec) {
+  array_free(rec->ops);
+  Buffer_Free(&rec->strings);
+  rm_free(rec);
+}
+
+size_t ReplyRecording_MemUsage(const ReplyRecording *rec) {
+  return sizeof(*rec) + array_cap(rec->ops) * sizeof(ReplyOp) + Buffer_Capacity(&rec->strings);
+}
+
+static inline void record_op(RedisModule_Reply *reply, ReplyOpType type) {
+  if (reply->recording) {
+    ReplyOp op = {.type = type};
+    array_append(reply->recording->ops, op);
+  }
+}
+
+static inline void record_ll(RedisModule_Reply *reply, long long val) {
+  if (reply->recording) {
+    ReplyOp op = {.type = ReplyOp_LongLong, .ll = val};
+    array_append(reply->recording->ops, op);
+  }
+}
+
+static inline void record_double(RedisModule_Reply *reply, double val) {
+  if (reply->recording) {
+    ReplyOp op = {.type = ReplyOp_Double, .d = val};
+    array_append(reply->recording->ops, op);
+  }
+}
+
+static inline void record_str(RedisModule_Reply *reply, ReplyOpType type, const char *val, size_t len) {
+  if (reply->recording) {
+    ReplyRecording *rec = reply->recording;
+    ReplyOp op = {.type = type, .str = {.offset = Buffer_Offset(&rec->strings), .len = len}};
+    array_append(rec->ops, op);
+    // Simple strings and errors are replayed as C strings
+    BufferWriter bw = {.buf = &rec->strings, .pos = Buffer_Offset(&rec->strings)};
+    Buffer_Write(&bw, val, len);
+    Buffer_Write(&bw, "", 1);
+  }
+}
+
+static inline void record_key(RedisModule_Reply *reply, const char *key) {
+  record_str(reply, ReplyOp_SimpleString, key, strlen(key));
+}
+
+//---------------------------------------------------------------------------------------------
+
 RedisModule_Reply RedisModule_NewReply(RedisModuleCtx *ctx) {
 #ifdef REDISMODULE_REPLY_DEBUG
-  RedisModule_Reply reply = { ctx, is_resp3(ctx), 0, NULL, NULL };
+  RedisModule_Reply reply = { ctx, is_resp3(ctx), 0, NULL, NULL, NULL };
   reply.json = array_new(char, 1);
   *reply.json = '\0';
 #else
-  RedisModule_Reply reply = { ctx, is_resp3(ctx), 0, NULL };
+  RedisModule_Reply reply = { ctx, is_resp3(ctx), 0, NULL, NULL };
 #endif
   return reply;
 }
@@ -183,6 +276,7 @@ static int _RedisModule_Reply_Pop(RedisModule_Reply *reply) {
 int RedisModule_Reply_LongLong(RedisModule_Reply *reply, long long val) {
   RedisModule_ReplyWithLongLong(reply->ctx, val);
   json_add(reply, false, "%ld", val);
+  record_ll(reply, val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -190,6 +284,7 @@ int RedisModule_Reply_LongLong(RedisModule_Reply *reply, long long val) {
 int RedisModule_Reply_Double(RedisModule_Reply *reply, double val) {
   RedisModule_ReplyWithDouble(reply->ctx, val);
   json_add(reply, false, "%f", val);
+  record_double(reply, val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -197,6 +292,7 @@ int RedisModule_Reply_Double(RedisModule_Reply *reply, double val) {
 int RedisModule_Reply_SimpleString(RedisModule_Reply *reply, const char *val) {
   RedisModule_ReplyWithSimpleString(reply->ctx, val);
   json_add(reply, false, "\"%s\"", val);
+  record_str(reply, ReplyOp_SimpleString, val, strlen(val));
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -204,6 +300,7 @@ int RedisModule_Reply_SimpleString(RedisModule_Reply *reply, const char *val) {
 int RedisModule_Reply_StringBuffer(RedisModule_Reply *reply, const char *val, size_t len) {
   RedisModule_ReplyWithStringBuffer(reply->ctx, val, len);
   json_add(reply, false, "\"%.*s\"", len, val);
+  record_str(reply, ReplyOp_StringBuffer, val, len);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -211,6 +308,7 @@ int RedisModule_Reply_StringBuffer(RedisModule_Reply *reply, const char *val, si
 int RedisModule_Reply_CString(RedisModule_Reply *reply, const char *val) {
   RedisModule_ReplyWithCString(reply->ctx, val);
   json_add(reply, false, "\"%s\"", val);
+  record_str(reply, ReplyOp_StringBuffer, val, strlen(val));
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -222,6 +320,7 @@ int RedisModule_Reply_SimpleStringf(RedisModule_Reply *reply, const char *fmt, .
   rm_vasprintf(&p, fmt, args);
   RedisModule_ReplyWithSimpleString(reply->ctx, p);
   json_add(reply, false, "\"%s\"", p);
+  record_str(reply, ReplyOp_SimpleString, p, strlen(p));
   rm_free(p);
   _RedisModule_Reply_Next(reply);
   va_end(args);
@@ -235,6 +334,7 @@ int RedisModule_Reply_Stringf(RedisModule_Reply *reply, const char *fmt, ...) {
   size_t len = rm_vasprintf(&p, fmt, args);
   RedisModule_ReplyWithStringBuffer(reply->ctx, p, len);
   json_add(reply, false, "\"%.*s\"", len, p);
+  record_str(reply, ReplyOp_StringBuffer, p, len);
   rm_free(p);
   _RedisModule_Reply_Next(reply);
   va_end(args);
@@ -243,11 +343,10 @@ int RedisModule_Reply_Stringf(RedisModule_Reply *reply, const char *fmt, ...) {
 
 int RedisModule_Reply_String(RedisModule_Reply *reply, const RedisModuleString *val) {
   RedisModule_ReplyWithString(reply->ctx, (RedisModuleString*)val);
-#ifdef REDISMODULE_REPLY_DEBUG
   size_t n;
   const char *p = RedisModule_StringPtrLen(val, &n);
   json_add(reply, false, "\"%.*s\"", n, p);
-#endif
+  record_str(reply, ReplyOp_StringBuffer, p, n);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -255,6 +354,7 @@ int RedisModule_Reply_String(RedisModule_Reply *reply, const RedisModuleString *
 int RedisModule_Reply_Null(RedisModule_Reply *reply) {
   RedisModule_ReplyWithNull(reply->ctx);
   json_add(reply, false, "null");
+  record_op(reply, ReplyOp_Null);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -262,6 +362,7 @@ int RedisModule_Reply_Null(RedisModule_Reply *reply) {
 int RedisModule_Reply_Error(RedisModule_Reply *reply, const char *error) {
   RedisModule_ReplyWithError(reply->ctx, error);
   json_add(reply, false, "\"ERR: %s\"", error);
+  record_str(reply, ReplyOp_Error, error, strlen(error));
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -283,6 +384,7 @@ int RedisModule_Reply_Map(RedisModule_Reply *reply) {
     json_add(reply, true, "[ ");
     type = REDISMODULE_REPLY_ARRAY;
   }
+  record_op(reply, ReplyOp_Map);
   _RedisModule_Reply_Next(reply);
   _RedisModule_Reply_Push(reply, type);
   return REDISMODULE_OK;
@@ -294,6 +396,7 @@ int RedisModule_Reply_MapEnd(RedisModule_Reply *reply) {
   } else {
     json_add_close(reply, " ]");
   }
+  record_op(reply, ReplyOp_MapEnd);
   int count = _RedisModule_Reply_Pop(reply);
   if (reply->resp3) {
     RedisModule_ReplySetMapLength(reply->ctx, count / 2);
@@ -308,6 +411,7 @@ int RedisModule_Reply_Array(RedisModule_Reply *reply) {
 
   RedisModule_ReplyWithArray(reply->ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
   json_add(reply, true, "[ ");
+  record_op(reply, ReplyOp_Array);
   _RedisModule_Reply_Next(reply);
   _RedisModule_Reply_Push(reply, REDISMODULE_REPLY_ARRAY);
   return REDISMODULE_OK;
@@ -315,6 +419,7 @@ int RedisModule_Reply_Array(RedisModule_Reply *reply) {
 
 int RedisModule_Reply_ArrayEnd(RedisModule_Reply *reply) {
   json_add_close(reply, " ]");
+  record_op(reply, ReplyOp_ArrayEnd);
   int count = _RedisModule_Reply_Pop(reply);
   RedisModule_ReplySetArrayLength(reply->ctx, count);
   return REDISMODULE_OK;
@@ -323,6 +428,7 @@ int RedisModule_Reply_ArrayEnd(RedisModule_Reply *reply) {
 int RedisModule_Reply_EmptyArray(RedisModule_Reply *reply) {
   json_add(reply, false, "[]");
   RedisModule_ReplyWithArray(reply->ctx, 0);
+  record_op(reply, ReplyOp_EmptyArray);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -335,6 +441,7 @@ int RedisModule_Reply_EmptyMap(RedisModule_Reply *reply) {
     json_add(reply, false, "[]");
     RedisModule_ReplyWithArray(reply->ctx, 0);
   }
+  record_op(reply, ReplyOp_EmptyMap);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -350,6 +457,7 @@ int RedisModule_Reply_Set(RedisModule_Reply *reply) {
     json_add(reply, true, "[ ");
     type = REDISMODULE_REPLY_ARRAY;
   }
+  record_op(reply, ReplyOp_Set);
   _RedisModule_Reply_Next(reply);
   _RedisModule_Reply_Push(reply, type);
   return REDISMODULE_OK;
@@ -361,6 +469,7 @@ int RedisModule_Reply_SetEnd(RedisModule_Reply *reply) {
   } else {
     json_add_close(reply, " ]");
   }
+  record_op(reply, ReplyOp_SetEnd);
   int count = _RedisModule_Reply_Pop(reply);
   if (reply->resp3) {
     RedisModule_ReplySetSetLength(reply->ctx, count);
@@ -374,17 +483,21 @@ int RedisModule_Reply_SetEnd(RedisModule_Reply *reply) {
 
 int RedisModule_ReplyKV_LongLong(RedisModule_Reply *reply, const char *key, long long val) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   RedisModule_ReplyWithLongLong(reply->ctx, val);
   json_add(reply, false, "%ld", val);
+  record_ll(reply, val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_ReplyKV_Double(RedisModule_Reply *reply, const char *key, double val) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   RedisModule_ReplyWithDouble(reply->ctx, val);
+  record_double(reply, val);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   json_add(reply, false, "%f", val);
@@ -394,17 +507,21 @@ int RedisModule_ReplyKV_Double(RedisModule_Reply *reply, const char *key, double
 
 int RedisModule_ReplyKV_SimpleString(RedisModule_Reply *reply, const char *key, const char *val) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   RedisModule_ReplyWithSimpleString(reply->ctx, val);
   json_add(reply, false, "\"%s\"", val);
+  record_str(reply, ReplyOp_SimpleString, val, strlen(val));
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_ReplyKV_StringBuffer(RedisModule_Reply *reply, const char *key, const char *val, size_t len) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   RedisModule_ReplyWithStringBuffer(reply->ctx, val, len);
+  record_str(reply, ReplyOp_StringBuffer, val, len);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   json_add(reply, false, "\"%.*s\"", len, val);
@@ -414,15 +531,15 @@ int RedisModule_ReplyKV_StringBuffer(RedisModule_Reply *reply, const char *key,
 
 int RedisModule_ReplyKV_String(RedisModule_Reply *reply, const char *key, const RedisModuleString *val) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   RedisModule_ReplyWithString(reply->ctx, (RedisModuleString *)val);
   _RedisModule_Reply_Next(reply);
 
-#ifdef REDISMODULE_REPLY_DEBUG
   size_t n;
   const char *p = RedisModule_StringPtrLen(val, &n);
   json_add(reply, false, "\"%.*s\"", n, p);
-#endif
+  record_str(reply, ReplyOp_StringBuffer, p, n);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -435,6 +552,7 @@ int RedisModule_ReplyKV_SimpleStringf(RedisModule_Reply *reply, const char *key,
   rm_vasprintf(&p, fmt, args);
   RedisModule_ReplyWithSimpleString(reply->ctx, p);
   json_add(reply, false, "\"%s\"", p);
+  record_str(reply, ReplyOp_SimpleString, p, strlen(p));
   rm_free(p);
   _RedisModule_Reply_Next(reply);
   va_end(args);
@@ -443,16 +561,19 @@ int RedisModule_ReplyKV_SimpleStringf(RedisModule_Reply *reply, const char *key,
 
 int RedisModule_ReplyKV_Null(RedisModule_Reply *reply, const char *key) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   RedisModule_ReplyWithNull(reply->ctx);
   json_add(reply, false, "null");
+  record_op(reply, ReplyOp_Null);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_ReplyKV_Array(RedisModule_Reply *reply, const char *key) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
 
@@ -464,6 +585,7 @@ int RedisModule_ReplyKV_Array(RedisModule_Reply *reply, const char *key) {
 
 int RedisModule_ReplyKV_Map(RedisModule_Reply *reply, const char *key) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
 
@@ -474,6 +596,7 @@ int RedisModule_ReplyKV_Map(RedisModule_Reply *reply, const char *key) {
 
 int RedisModule_ReplyKV_Set(RedisModule_Reply *reply, const char *key) {
   RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  record_key(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
 
@@ -483,6 +606,59 @@ int RedisModule_ReplyKV_Set(RedisModule_Reply *reply, const char *key) {
 
 //---------------------------------------------------------------------------------------------
 
+void RedisModule_Reply_Replay(RedisModule_Reply *reply, const ReplyRecording *rec) {
+  const char *strings = rec->strings.data;
+  for (uint32_t i = 0; i < array_len(rec->ops); ++i) {
+    const ReplyOp *op = &rec->ops[i];
+    switch (op->type) {
+      case ReplyOp_LongLong:
+        RedisModule_Reply_LongLong(reply, op->ll);
+        break;
+      case ReplyOp_Double:
+        RedisModule_Reply_Double(reply, op->d);
+        break;
+      case ReplyOp_SimpleString:
+        RedisModule_Reply_SimpleString(reply, strings + op->str.offset);
+        break;
+      case ReplyOp_StringBuffer:
+        RedisModule_Reply_StringBuffer(reply, strings + op->str.offset, op->str.len);
+        break;
+      case ReplyOp_Null:
+        RedisModule_Reply_Null(reply);
+        break;
+      case ReplyOp_Error:
+        RedisModule_Reply_Error(reply, strings + op->str.offset);
+        break;
+      case ReplyOp_Map:
+        RedisModule_Reply_Map(reply);
+        break;
+      case ReplyOp_MapEnd:
+        RedisModule_Reply_MapEnd(reply);
+        break;
+      case ReplyOp_Array:
+        RedisModule_Reply_Array(reply);
+        break;
+      case ReplyOp_ArrayEnd:
+        RedisModule_Reply_ArrayEnd(reply);
+        break;
+      case ReplyOp_Set:
+        RedisModule_Reply_Set(reply);
+        break;
+      case ReplyOp_SetEnd:
+        RedisModule_Reply_SetEnd(reply);
+        break;
+      case ReplyOp_EmptyArray:
+        RedisModule_Reply_EmptyArray(reply);
+        break;
+      case ReplyOp_EmptyMap:
+        RedisModule_Reply_EmptyMap(reply);
+        break;
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------------
+
 char *escapeSimpleString(const char *str) {
   size_t len = strlen(str);
   // This is a short lived string, so we can afford to allocate twice the size
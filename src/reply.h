@@ -30,6 +30,9 @@ struct RedisModule_Reply_StackEntry {
     int type; // REDISMODULE_REPLY_ARRAY|MAP|SET
 };
 
+// A copy of the elements written through a reply, which can be replayed into another one
+typedef struct ReplyRecording ReplyRecording;
+
 typedef struct RedisModule_Reply {
   RedisModuleCtx *ctx;
   bool resp3;
@@ -38,6 +41,8 @@ typedef struct RedisModule_Reply {
 #ifdef REDISMODULE_REPLY_DEBUG
   arrayof(char) json;
 #endif
+  // When set, every element written through the wrapper is also appended here
+  ReplyRecording *recording;
 } RedisModule_Reply;
 
 typedef enum {
@@ -91,6 +96,13 @@ int RedisModule_ReplyKV_Null(RedisModule_Reply *reply, const char *key);
 int RedisModule_ReplyKV_Array(RedisModule_Reply *reply, const char *key);
 int RedisModule_ReplyKV_Map(RedisModule_Reply *reply, const char *key);
 
+ReplyRecording *ReplyRecording_New(void);
+void ReplyRecording_Free(ReplyRecording *rec);
+// Memory held by the recording, in bytes
+size_t ReplyRecording_MemUsage(const ReplyRecording *rec);
+// Write the recorded elements into `reply`, as they were written when recording
+void RedisModule_Reply_Replay(RedisModule_Reply *reply, const ReplyRecording *rec);
+
 /*
  * This function is a workaround helper for replying with a string that may contain
  * newlines or other characters that are not safe for RESP Simple Strings.
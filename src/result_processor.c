@@ -61,6 +61,7 @@
 #include "spec.h"
 #include "util/dict/dict.h"
 #include "util/dllist.h"
+#include "util/workers.h"
 
 // Maximum number of concurrent async disk reads
 #define MAX_ONGOING_READ_SIZE 16
@@ -77,6 +78,12 @@
 // only bounds an idle wait before looping back to re-check the query timeout.
 #define ASYNC_POLL_TIMEOUT_SATURATED_MS 2
 
+// Document ids read from the iterator at once by rpQueryItNext_Batched
+#define ITERATOR_READ_BATCH_SIZE 256
+
+// Width, in document ids, of the slices of the id space read by the partitions of a parallel scan
+#define PARALLEL_SCAN_SLICE_SIZE 16384
+
 /*******************************************************************************************************************
  *  Base Result Processor - this processor is the topmost processor of every processing chain.
  *
@@ -89,6 +96,17 @@ static int UnlockSpec_and_ReturnRPResult(RedisSearchCtx *sctx, int result_status
   return result_status;
 }
 
+/* A partition of a parallel scan, reading its own copy of the query's iterator tree. The document
+ * id space is cut in slices of PARALLEL_SCAN_SLICE_SIZE ids, dealt round robin to the partitions:
+ * every partition only collects the matches of its own slices, so each moves forward only. */
+typedef struct {
+  QueryIterator *iterator;
+  arrayof(t_docId) ids;  // Matches of the slice read last
+  t_docId pending;       // A match the iterator stands on that was not collected yet, 0 if none
+  bool eof;
+  bool timedOut;         // The slice read last timed out
+} ScanPartition;
+
 typedef struct {
   ResultProcessor base;
   QueryIterator *iterator;
@@ -99,6 +117,24 @@ typedef struct {
 
   // Async disk I/O state (only used when async disk I/O is enabled)
   IndexResultAsyncReadState async;
+
+  // Read-ahead state (only used by rpQueryItNext_Batched)
+  struct {
+    t_docId docIds[ITERATOR_READ_BATCH_SIZE];
+    IteratorBatch batch;   // Filled into `docIds`
+    size_t next;           // Position in `batch` of the next id to serve
+    bool pendingCurrent;   // A revalidation moved the iterator: serve its position after the batch
+  } readAhead;
+
+  // Parallel scan state (only used by rpQueryItNext_Parallel)
+  struct {
+    ScanPartition *partitions;  // The first one reads `iterator`, the others a copy of it
+    size_t numPartitions;
+    size_t nextSlice;           // Slice read by the first partition in the next wave
+    size_t serving;             // Partition whose matches are being served
+    size_t next;                // Position of the next match to serve in its `ids`
+    bool timedOut;
+  } parallel;
 #ifdef ENABLE_ASSERT
   bool firstRead;  // Debug only: tracks if this is the first read for sync point testing
 #endif
@@ -132,8 +168,10 @@ static bool getDocumentMetadata(IndexSpec* spec, DocTable* docs, RedisSearchCtx
   } else {
     if (it->current->dmd) {
       *dmd = it->current->dmd;
-    } else {
+    } else if (DocTable_IsLive(docs, it->lastDocId, &sctx->time.current)) {
       *dmd = DocTable_Borrow(docs, it->lastDocId);
+    } else {
+      return false;
     }
     if (!*dmd || (*dmd)->flags & Document_Deleted || DocTable_IsDocExpired(docs, *dmd, &sctx->time.current)) {
       DMD_Return(*dmd);
@@ -238,26 +276,6 @@ static void setSearchResult(ResultProcessor *base, SearchResult *res, RSIndexRes
   RLookupRow_SetSortingVector(SearchResult_GetRowDataMut(res), &dmd->sortVector);
 }
 
-/**
- * Prepare a result's borrowed RSIndexResult before a buffering RP stores the
- * result across an iterator advance.
- *
- * The borrow points into the source iterator's `it->current` slot, which the
- * next Read() overwrites. Unless the pipeline has opted into skipping the copy
- * (`qctx.skipIndexResultDeepCopy`, set only after request flags and parsed
- * APPLY/FILTER expressions show that preserving the index result is not
- * required), promote the borrow to an owned deep copy. Otherwise drop the borrow
- * so the buffered result never retains a dangling pointer, without paying for
- * the copy.
- */
-static inline void SearchResult_BufferIndexResult(ResultProcessor *rp, SearchResult *res) {
-  if (rp->parent->skipIndexResultDeepCopy) {
-    SearchResult_SetBorrowedIndexResult(res, NULL);
-  } else {
-    SearchResult_DeepCopyAndOwnIndexResult(res);
-  }
-}
-
 typedef enum {
   REVALIDATE_CONTINUE,         // Proceed with a normal read
   REVALIDATE_VALIDATE_CURRENT, // The iterator moved: use its current result before reading again
@@ -378,6 +396,405 @@ static int rpQueryItNext(ResultProcessor *base, SearchResult *res) {
   }
 }
 
+/* Fill `batch` through the iterator's `ReadBatch`, or one `Read` at a time if it has none.
+ * `batch` must have room for at least one entry. */
+static IteratorStatus QueryIterator_ReadBatch(QueryIterator *it, IteratorBatch *batch) {
+  if (it->ReadBatch) {
+    return it->ReadBatch(it, batch);
+  }
+  const size_t start = batch->len;
+  while (batch->len < batch->capacity) {
+    IteratorStatus rc = it->Read(it);
+    if (rc == ITERATOR_EOF) {
+      break;
+    } else if (rc != ITERATOR_OK) {
+      return rc;
+    }
+    batch->docIds[batch->len] = it->lastDocId;
+    if (batch->fieldMasks) {
+      batch->fieldMasks[batch->len] = it->current->fieldMask;
+    }
+    batch->len++;
+  }
+  return batch->len > start ? ITERATOR_OK : ITERATOR_EOF;
+}
+
+/* Next implementation for in-memory pipelines that need no index results downstream: the iterator
+ * fills a batch of document ids in one call, and results are served from the batch. */
+static int rpQueryItNext_Batched(ResultProcessor *base, SearchResult *res) {
+  RPQueryIterator *self = (RPQueryIterator *)base;
+  RedisSearchCtx *sctx = self->sctx;
+  DocTable *docs = &sctx->spec->docs;
+
+  QueryIterator *previousIterator = self->iterator;
+  RevalidateOutcome revalidateOutcome = handleSpecLockAndRevalidate(self);
+  if (self->iterator != previousIterator) {
+    // Aborted: drop what was read ahead, as the iterator would have yielded nothing more
+    self->readAhead.batch.len = self->readAhead.next = 0;
+    self->readAhead.pendingCurrent = false;
+  }
+  if (revalidateOutcome == REVALIDATE_TIMEDOUT) {
+    return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_TIMEDOUT);
+  }
+  if (revalidateOutcome == REVALIDATE_VALIDATE_CURRENT) {
+    // The ids read ahead all precede the position the iterator moved to. A later move
+    // replaces this one, as it means the previous position is no longer a match.
+    self->readAhead.pendingCurrent = true;
+  }
+  QueryIterator *it = self->iterator;
+  IteratorBatch *batch = &self->readAhead.batch;
+
+#ifdef ENABLE_ASSERT
+  // See rpQueryItNext: same interruptible park for the batched variant.
+  if (self->firstRead) {
+    self->firstRead = false;
+    SyncPoint_WaitUntil(SYNC_POINT_BEFORE_FIRST_READ, SearchTime_IsTimedOut, &sctx->time);
+  }
+#endif
+
+  while (1) {
+    if ((TimedOut_WithCounter(&sctx->time.timeout, &self->timeoutLimiter) == TIMED_OUT) ||
+        SearchTime_IsTimedOut(&sctx->time)) {
+      return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_TIMEDOUT);
+    }
+
+    t_docId docId;
+    if (self->readAhead.next < batch->len) {
+      docId = batch->docIds[self->readAhead.next++];
+    } else if (self->readAhead.pendingCurrent) {
+      self->readAhead.pendingCurrent = false;
+      docId = it->lastDocId;
+    } else {
+      batch->len = self->readAhead.next = 0;
+      IteratorStatus rc = QueryIterator_ReadBatch(it, batch);
+      if (rc == ITERATOR_EOF) {
+        return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_EOF);
+      } else if (rc == ITERATOR_TIMEOUT && batch->len == 0) {
+        return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_TIMEDOUT);
+      }
+      // On a timeout with entries read, serve them first: the next refill reports it
+      continue;
+    }
+
+    // Deleted and expired documents are skipped without looking up their metadata
+    if (!DocTable_IsLive(docs, docId, &sctx->time.current)) {
+      continue;
+    }
+    const RSDocumentMetadata *dmd = DocTable_Borrow(docs, docId);
+    if (!dmd) {
+      continue;
+    }
+
+    if (!validateDmdSlot(self, dmd)) {
+      DMD_Return(dmd);
+      continue;
+    }
+
+    setSearchResult(base, res, NULL, dmd);
+    return RS_RESULT_OK;
+  }
+}
+
+/* Collect the matches of partition `p` within [start, end), leaving the first match past it pending */
+static void scanPartition_Read(ScanPartition *p, t_docId start, t_docId end) {
+  QueryIterator *it = p->iterator;
+  array_clear(p->ids);
+  p->timedOut = false;
+  while (!p->eof) {
+    if (!p->pending) {
+      IteratorStatus rc = it->lastDocId < start ? it->SkipTo(it, start) : it->Read(it);
+      if (rc == ITERATOR_EOF) {
+        p->eof = true;
+        break;
+      } else if (rc == ITERATOR_TIMEOUT) {
+        p->timedOut = true;
+        break;
+      }
+      p->pending = it->lastDocId;
+    }
+    if (p->pending >= end) {
+      break;
+    }
+    if (p->pending >= start) {
+      // Matches before `start` belong to the slices of other partitions
+      array_append(p->ids, p->pending);
+    }
+    p->pending = 0;
+  }
+}
+
+typedef struct ScanWave ScanWave;
+
+typedef struct {
+  ScanWave *wave;
+  ScanPartition *partition;
+  t_docId start;
+  t_docId end;
+  atomic_bool claimed;  // Set by the thread reading the slice
+} ScanJob;
+
+/* The slices of all the partitions but the first in a wave, posted to the workers. The query
+ * thread reads the first slice, then the ones no worker claimed yet, and waits for the others.
+ * Held by the query thread and by every posted job, as a worker may only pick a job up after the
+ * wave is over. */
+struct ScanWave {
+  atomic_size_t refcount;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  size_t numDone;  // Slices read by workers
+  ScanJob jobs[];
+};
+
+static void scanWave_Release(ScanWave *wave) {
+  if (atomic_fetch_sub(&wave->refcount, 1) == 1) {
+    pthread_cond_destroy(&wave->cond);
+    pthread_mutex_destroy(&wave->lock);
+    rm_free(wave);
+  }
+}
+
+static void scanJob_Run(void *arg) {
+  ScanJob *job = arg;
+  ScanWave *wave = job->wave;
+  if (!atomic_exchange(&job->claimed, true)) {
+    scanPartition_Read(job->partition, job->start, job->end);
+    pthread_mutex_lock(&wave->lock);
+    wave->numDone++;
+    pthread_cond_signal(&wave->cond);
+    pthread_mutex_unlock(&wave->lock);
+  }
+  scanWave_Release(wave);
+}
+
+static inline t_docId sliceStart(size_t slice) {
+  return (t_docId)slice * PARALLEL_SCAN_SLICE_SIZE;
+}
+
+/* Read the next slice of every partition. Called with the spec read lock held */
+static void parallelScan_ReadWave(RPQueryIterator *self) {
+  ScanPartition *partitions = self->parallel.partitions;
+  const size_t numPartitions = self->parallel.numPartitions;
+  const size_t first = self->parallel.nextSlice;
+  const size_t numJobs = numPartitions - 1;
+
+  ScanWave *wave = rm_calloc(1, sizeof(*wave) + numJobs * sizeof(*wave->jobs));
+  atomic_init(&wave->refcount, 1);
+  pthread_mutex_init(&wave->lock, NULL);
+  pthread_cond_init(&wave->cond, NULL);
+  for (size_t ii = 0; ii < numJobs; ++ii) {
+    ScanJob *job = &wave->jobs[ii];
+    job->wave = wave;
+    job->partition = &partitions[ii + 1];
+    job->start = sliceStart(first + ii + 1);
+    job->end = sliceStart(first + ii + 2);
+    atomic_init(&job->claimed, false);
+    atomic_fetch_add(&wave->refcount, 1);
+    if (workersThreadPool_AddWork(scanJob_Run, job) != 0) {
+      atomic_fetch_sub(&wave->refcount, 1);
+    }
+  }
+
+  scanPartition_Read(&partitions[0], sliceStart(first), sliceStart(first + 1));
+  size_t numOnWorkers = numJobs;
+  for (size_t ii = 0; ii < numJobs; ++ii) {
+    ScanJob *job = &wave->jobs[ii];
+    if (!atomic_exchange(&job->claimed, true)) {
+      scanPartition_Read(job->partition, job->start, job->end);
+      numOnWorkers--;
+    }
+  }
+  pthread_mutex_lock(&wave->lock);
+  while (wave->numDone < numOnWorkers) {
+    pthread_cond_wait(&wave->cond, &wave->lock);
+  }
+  pthread_mutex_unlock(&wave->lock);
+  scanWave_Release(wave);
+
+  // The last partition stands on the first match past the wave: skip the empty slices before it
+  const ScanPartition *last = &partitions[numPartitions - 1];
+  size_t next = first + numPartitions;
+  if (last->pending && last->pending / PARALLEL_SCAN_SLICE_SIZE > next) {
+    next = last->pending / PARALLEL_SCAN_SLICE_SIZE;
+  }
+  self->parallel.nextSlice = next;
+  for (size_t ii = 0; ii < numPartitions; ++ii) {
+    self->parallel.timedOut |= partitions[ii].timedOut;
+  }
+  self->parallel.serving = self->parallel.next = 0;
+}
+
+/* Revalidate the iterators of all the partitions once the spec lock is reacquired. An abort or a
+ * timeout of any of them ends the scan, as it would end a serial one. */
+static ValidateStatus parallelScan_Revalidate(RPQueryIterator *self) {
+  ScanPartition *partitions = self->parallel.partitions;
+  const size_t numPartitions = self->parallel.numPartitions;
+  ValidateStatus status = VALIDATE_OK;
+  for (size_t ii = 0; ii < numPartitions; ++ii) {
+    ScanPartition *p = &partitions[ii];
+    if (p->eof) {
+      continue;
+    }
+    ValidateStatus rc = p->iterator->Revalidate(p->iterator, self->sctx->spec);
+    if (rc == VALIDATE_ABORTED || rc == VALIDATE_TIMEOUT) {
+      status = rc;
+      break;
+    } else if (rc == VALIDATE_MOVED) {
+      // The matches collected already precede the position the iterator moved to
+      p->eof = p->iterator->atEOF;
+      p->pending = p->eof ? 0 : p->iterator->lastDocId;
+    }
+  }
+  if (status == VALIDATE_ABORTED || status == VALIDATE_TIMEOUT) {
+    // Drop what was read ahead, as the iterators would have yielded nothing more
+    for (size_t ii = 0; ii < numPartitions; ++ii) {
+      array_clear(partitions[ii].ids);
+      partitions[ii].eof = true;
+    }
+  }
+  return status;
+}
+
+/* Next implementation for in-memory pipelines reading ahead (see rpQueryItNext_Batched) from a
+ * large scan: the document id space is read in waves, in which every partition reads its next
+ * slice on a worker thread. The matches are served in the order of the slices, so that the results
+ * come in increasing document id order as from a serial scan. */
+static int rpQueryItNext_Parallel(ResultProcessor *base, SearchResult *res) {
+  RPQueryIterator *self = (RPQueryIterator *)base;
+  RedisSearchCtx *sctx = self->sctx;
+  DocTable *docs = &sctx->spec->docs;
+  ScanPartition *partitions = self->parallel.partitions;
+  const size_t numPartitions = self->parallel.numPartitions;
+
+  if (sctx->lock_state == SPEC_LOCK_UNSET) {
+    RedisSearchCtx_LockSpecRead(sctx);
+    if (parallelScan_Revalidate(self) == VALIDATE_TIMEOUT) {
+      return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_TIMEDOUT);
+    }
+  }
+
+#ifdef ENABLE_ASSERT
+  // See rpQueryItNext: same interruptible park for the parallel variant.
+  if (self->firstRead) {
+    self->firstRead = false;
+    SyncPoint_WaitUntil(SYNC_POINT_BEFORE_FIRST_READ, SearchTime_IsTimedOut, &sctx->time);
+  }
+#endif
+
+  while (1) {
+    if ((TimedOut_WithCounter(&sctx->time.timeout, &self->timeoutLimiter) == TIMED_OUT) ||
+        SearchTime_IsTimedOut(&sctx->time)) {
+      return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_TIMEDOUT);
+    }
+
+    const ScanPartition *serving = &partitions[self->parallel.serving];
+    if (self->parallel.next == array_len(serving->ids)) {
+      if (self->parallel.serving + 1 < numPartitions) {
+        self->parallel.serving++;
+        self->parallel.next = 0;
+      } else if (self->parallel.timedOut) {
+        // Reported once the matches read before the deadline were served
+        return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_TIMEDOUT);
+      } else if (partitions[numPartitions - 1].eof) {
+        // The last partition is past the end, so the others have no match left outside the wave
+        return UnlockSpec_and_ReturnRPResult(sctx, RS_RESULT_EOF);
+      } else {
+        parallelScan_ReadWave(self);
+      }
+      continue;
+    }
+    t_docId docId = serving->ids[self->parallel.next++];
+
+    // Deleted and expired documents are skipped without looking up their metadata
+    if (!DocTable_IsLive(docs, docId, &sctx->time.current)) {
+      continue;
+    }
+    const RSDocumentMetadata *dmd = DocTable_Borrow(docs, docId);
+    if (!dmd) {
+      continue;
+    }
+
+    if (!validateDmdSlot(self, dmd)) {
+      DMD_Return(dmd);
+      continue;
+    }
+
+    setSearchResult(base, res, NULL, dmd);
+    return RS_RESULT_OK;
+  }
+}
+
+/* Can the chain downstream of the root processor be fed by rpQueryItNext_Batched? Only if no
+ * processor needs the index results, and the chain depletes the root anyway (counting, sorting,
+ * grouping) - reading ahead of a pager that stops early would do wasted work. */
+static bool canReadAhead(const RPQueryIterator *self) {
+  const QueryProcessingCtx *qctx = self->base.parent;
+  if (self->sctx->spec->diskSpec || !qctx->skipIndexResultDeepCopy) {
+    return false;
+  }
+  // Walk from the end of the chain back to the root; the processor closest to the root decides
+  // whether everything it reads is consumed.
+  bool depletes = false;
+  for (const ResultProcessor *rp = qctx->endProc; rp != &self->base; rp = rp->upstream) {
+    if (!rp) {
+      return false;  // Not a plain chain down to this processor
+    }
+    switch (rp->type) {
+      case RP_COUNTER:
+      case RP_SORTER:
+      case RP_GROUP:
+      case RP_SAFE_DEPLETER:
+      case RP_DEPLETER:
+        depletes = true;
+        break;
+      case RP_PAGER_LIMITER:
+        depletes = false;
+        break;
+      case RP_SCORER:
+      case RP_METRICS:
+      case RP_HIGHLIGHTER:
+      case RP_MAX_SCORE_NORMALIZER:
+      case RP_VECTOR_NORMALIZER:
+      case RP_HYBRID_MERGER:
+        return false;  // Reads the index results
+      default:
+        if (rp->type >= RP_MAX) {
+          return false;  // Debug processors count reads
+        }
+        break;
+    }
+  }
+  return depletes;
+}
+
+/* First Next of an in-memory pipeline: the chain is complete by now, so pick how to read. */
+static int rpQueryItNext_Init(ResultProcessor *base, SearchResult *res) {
+  RPQueryIterator *self = (RPQueryIterator *)base;
+  if (!canReadAhead(self)) {
+    base->Next = rpQueryItNext;
+  } else if (self->parallel.numPartitions > 1) {
+    base->Next = rpQueryItNext_Parallel;
+  } else {
+    base->Next = rpQueryItNext_Batched;
+  }
+  return base->Next(base, res);
+}
+
+bool RPQueryIterator_CanReadAhead(const ResultProcessor *rp) {
+  return rp->type == RP_INDEX && canReadAhead((const RPQueryIterator *)rp);
+}
+
+void RPQueryIterator_SetPartitions(ResultProcessor *rp, QueryIterator **iterators, size_t num) {
+  RPQueryIterator *self = (RPQueryIterator *)rp;
+  RS_ASSERT(rp->type == RP_INDEX && !self->parallel.partitions);
+  self->parallel.numPartitions = num + 1;
+  self->parallel.partitions = rm_calloc(num + 1, sizeof(*self->parallel.partitions));
+  for (size_t ii = 0; ii <= num; ++ii) {
+    ScanPartition *p = &self->parallel.partitions[ii];
+    p->iterator = ii ? iterators[ii - 1] : self->iterator;
+    p->ids = array_new(t_docId, PARALLEL_SCAN_SLICE_SIZE / 16);
+  }
+}
+
 /* Next implementation for async disk flow with two-level buffering */
 static int rpQueryItNext_AsyncDisk(ResultProcessor *base, SearchResult *res) {
   RPQueryIterator *self = (RPQueryIterator *)base;
@@ -474,6 +891,15 @@ static int rpQueryItNext_AsyncDisk(ResultProcessor *base, SearchResult *res) {
 static void rpQueryItFree(ResultProcessor *iter) {
   RPQueryIterator *self = (RPQueryIterator *)iter;
   self->iterator->Free(self->iterator);
+  for (size_t ii = 0; ii < self->parallel.numPartitions; ++ii) {
+    ScanPartition *p = &self->parallel.partitions[ii];
+    if (ii) {
+      // The first partition reads `iterator`
+      p->iterator->Free(p->iterator);
+    }
+    array_free(p->ids);
+  }
+  rm_free(self->parallel.partitions);
   rm_free((void *)self->querySlots);
 
   // Free async disk I/O state
@@ -500,6 +926,10 @@ ResultProcessor *RPQueryIterator_New(QueryIterator *root, const RedisModuleSlotR
   // Initialize async read state
   IndexResultAsyncRead_Init(&ret->async, MAX_ONGOING_READ_SIZE, ITERATOR_BUFFER_SIZE);
 
+  // Initialize read-ahead state. Field masks are not needed: the results carry no index result
+  ret->readAhead.batch.docIds = ret->readAhead.docIds;
+  ret->readAhead.batch.capacity = ITERATOR_READ_BATCH_SIZE;
+
   // Determine which Next function to use based on disk configuration
   if (sctx->spec->diskSpec &&
       SearchDisk_IsAsyncIOSupported() &&
@@ -515,9 +945,12 @@ ResultProcessor *RPQueryIterator_New(QueryIterator *root, const RedisModuleSlotR
     } else {
       ret->base.Next = rpQueryItNext;
     }
-  } else {
-    // Sync disk or regular in-memory flow (both use getDocumentMetadata)
+  } else if (sctx->spec->diskSpec) {
+    // Sync disk flow
     ret->base.Next = rpQueryItNext;
+  } else {
+    // Regular in-memory flow, batched or not depending on the rest of the chain
+    ret->base.Next = rpQueryItNext_Init;
   }
 
   return &ret->base;
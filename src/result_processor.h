@@ -160,8 +160,37 @@ typedef struct ResultProcessor {
   void (*Free)(struct ResultProcessor *self);
 } ResultProcessor;
 
+/**
+ * Prepare a result's borrowed RSIndexResult before a buffering RP stores the
+ * result across an iterator advance.
+ *
+ * The borrow points into the source iterator's `it->current` slot, which the
+ * next Read() overwrites. Unless the pipeline has opted into skipping the copy
+ * (`qctx.skipIndexResultDeepCopy`, set only after request flags and parsed
+ * APPLY/FILTER expressions show that preserving the index result is not
+ * required), promote the borrow to an owned deep copy. Otherwise drop the borrow
+ * so the buffered result never retains a dangling pointer, without paying for
+ * the copy.
+ */
+static inline void SearchResult_BufferIndexResult(ResultProcessor *rp, SearchResult *res) {
+  if (rp->parent->skipIndexResultDeepCopy) {
+    SearchResult_SetBorrowedIndexResult(res, NULL);
+  } else {
+    SearchResult_DeepCopyAndOwnIndexResult(res);
+  }
+}
+
 ResultProcessor *RPQueryIterator_New(QueryIterator *itr, const RedisModuleSlotRangeArray *querySlots, uint32_t slotsVersion, RedisSearchCtx *sctx);
 
+/* Can the chain built downstream of the query iterator processor `rp` do without the index results,
+ * and does it consume everything read? Only such chains have their scan partitioned. */
+bool RPQueryIterator_CanReadAhead(const ResultProcessor *rp);
+
+/* Partition the scan of the query iterator processor `rp` across the worker threads, see
+ * QUERY_MAX_PARALLELISM. `iterators` are `num` more iterator trees of the same query, owned by the
+ * processor from now on. Only used if `RPQueryIterator_CanReadAhead` holds. */
+void RPQueryIterator_SetPartitions(ResultProcessor *rp, QueryIterator **iterators, size_t num);
+
 ResultProcessor *RPScorer_New(const ExtScoringFunctionCtx *funcs,
                               const ScoringFunctionArgs *fnargs,
                               const RLookupKey *rlk);
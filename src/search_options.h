@@ -84,6 +84,7 @@ typedef enum {
   Search_NoStopWords        = (1 << 1),
   Search_InOrder            = (1 << 2),
   Search_CanSkipRichResults = (1 << 3), // No need to bubble up full result structure (used by the scorer and highlighter)
+  Search_NoCache            = (1 << 4), // Bypass the query result and filter caches of the index
 } RSSearchFlags;
 
 #define RS_DEFAULT_QUERY_FLAGS 0x00
@@ -31,6 +31,10 @@
 #include "rmalloc.h"
 #include "config.h"
 #include "cursor.h"
+#include "query_cache.h"
+#include "filter_cache.h"
+#include "indexing_pipeline.h"
+#include "index_snapshot.h"
 #include "tag_index.h"
 #include "redis_index.h"
 #include "indexer.h"
@@ -407,6 +411,9 @@ size_t IndexSpec_collect_text_overhead(const IndexSpec *sp) {
     // TODO: Count the values' memory as well
     overhead += TrieType_MemUsage(sp->suffix);
   }
+  if (sp->ngrams) {
+    overhead += NgramIndex_MemUsage(sp->ngrams);
+  }
   return overhead;
 }
 
@@ -420,6 +427,7 @@ size_t IndexSpec_TotalMemUsage(IndexSpec *sp, size_t doctable_tm_size, size_t ta
   }
 
   res += sp->docs.memsize;
+  res += sp->docs.columns.memsize;
   res += sp->docs.sortablesSize;
   res += doctable_tm_size ? doctable_tm_size : TrieMap_MemUsage(sp->docs.dim.tm);
   res += text_overhead ? text_overhead :  IndexSpec_collect_text_overhead(sp);
@@ -1071,6 +1079,11 @@ static int parseTextField(FieldSpec *fs, ArgsCursor *ac, QueryError *status) {
         return 0;
       }
       fs->options |= FieldSpec_WithSuffixTrie;
+    } else if (AC_AdvanceIfMatch(ac, SPEC_WITHNGRAMS_STR)) {
+      if (!SearchDisk_MarkUnsupportedArgumentIfDiskEnabled(SPEC_WITHNGRAMS_STR, status)) {
+        return 0;
+      }
+      fs->options |= FieldSpec_WithNgrams;
     } else if (AC_AdvanceIfMatch(ac, SPEC_INDEXEMPTY_STR)) {
       fs->options |= FieldSpec_IndexEmpty;
     } else if (AC_AdvanceIfMatch(ac, SPEC_INDEXMISSING_STR)) {
@@ -1417,6 +1430,12 @@ static void IndexSpec_EnsureSuffixForField(IndexSpec *sp, const FieldSpec *fs) {
       sp->suffix = NewTrie(suffixTrie_freeCallback, Trie_Sort_Lex);
     }
   }
+  if (FieldSpec_IsIndexableText(fs) && FieldSpec_HasNgrams(fs)) {
+    sp->ngramMask |= FIELD_BIT(fs);
+    if (!sp->ngrams) {
+      sp->ngrams = NewNgramIndex();
+    }
+  }
 }
 
 /**
@@ -1436,6 +1455,8 @@ static int IndexSpec_AddFieldsInternal(IndexSpec *sp, StrongRef spec_ref, ArgsCu
   const IndexFlags prevFlags = sp->flags;
   Trie *prevSuffix = sp->suffix;
   const t_fieldMask prevSuffixMask = sp->suffixMask;
+  NgramIndex *prevNgrams = sp->ngrams;
+  const t_fieldMask prevNgramMask = sp->ngramMask;
 
   while (!AC_IsAtEnd(ac)) {
     if (sp->numFields == SPEC_MAX_FIELDS) {
@@ -1606,6 +1627,11 @@ reset:
   }
   sp->suffix = prevSuffix;
   sp->suffixMask = prevSuffixMask;
+  if (sp->ngrams != prevNgrams) {
+    NgramIndex_Free(sp->ngrams);
+  }
+  sp->ngrams = prevNgrams;
+  sp->ngramMask = prevNgramMask;
   sp->flags = prevFlags;
   return 0;
 }
@@ -1617,7 +1643,12 @@ int IndexSpec_AddFields(StrongRef spec_ref, IndexSpec *sp, RedisModuleCtx *ctx,
                         QueryError *status) {
   setMemoryInfo(ctx);
 
-  return IndexSpec_AddFieldsInternal(sp, spec_ref, ac, status, 0);
+  int rc = IndexSpec_AddFieldsInternal(sp, spec_ref, ac, status, 0);
+  if (rc) {
+    // New fields change the reply of queries loading or returning them
+    IndexSpec_BumpWriteEpoch(sp);
+  }
+  return rc;
 }
 
 bool IndexSpec_IsCoherent(IndexSpec *spec, RedisModuleString **prefixes, size_t n_prefixes) {
@@ -1987,6 +2018,19 @@ static void IndexSpec_FreeUnlinkedData(IndexSpec *spec) {
   if (spec->smap) {
     SynonymMap_Free(spec->smap);
   }
+  // Free cached query replies
+  if (spec->queryCache) {
+    QueryCache_Free(spec->queryCache);
+  }
+  if (spec->filterCache) {
+    FilterCache_Free(spec->filterCache);
+  }
+  if (spec->indexingPipeline) {
+    IndexingPipeline_Free(spec->indexingPipeline);
+  }
+  if (spec->snapshotRestore) {
+    IndexSnapshot_FreeRestore(spec->snapshotRestore);
+  }
   // Destroy spec rule
   if (spec->rule) {
     SchemaRule_Free(spec->rule);
@@ -2003,6 +2047,7 @@ static void IndexSpec_FreeUnlinkedData(IndexSpec *spec) {
   if (spec->suffix) {
     TrieType_Free(spec->suffix);
   }
+  NgramIndex_Free(spec->ngrams);
 
   // Free spec name
   HiddenString_Free(spec->specName, true);
@@ -2075,6 +2120,10 @@ void IndexSpec_Free(IndexSpec *spec) {
 void IndexSpec_Unlink(StrongRef spec_ref, bool removeActive) {
   IndexSpec *spec = StrongRef_Get(spec_ref);
 
+  // Index the pending documents while the spec is still valid, so that the
+  // dropped index (and FT.DROPINDEX DD) sees all of its documents
+  IndexingPipeline_Flush(spec);
+
   if (!spec->isDuplicate) {
     // Remove spec from global aliases list
     IndexSpec_ClearAliases(spec_ref);
@@ -2248,6 +2297,8 @@ static void initializeIndexSpec(IndexSpec *sp, const HiddenString *name, IndexFl
   sp->docs = DocTable_New(INITIAL_DOC_TABLE_SIZE);
   sp->suffix = NULL;
   sp->suffixMask = (t_fieldMask)0;
+  sp->ngrams = NULL;
+  sp->ngramMask = (t_fieldMask)0;
   sp->keysDict = NULL;
   sp->timeout = 0;
   sp->isTimerSet = false;
@@ -3445,8 +3496,8 @@ int CompareVersions(Version v1, Version v2) {
 }
 
 
-int IndexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
-                        DocumentType type, RedisModuleKey *openKey) {
+static int indexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
+                               DocumentType type, RedisModuleKey *openKey, bool scanned) {
   RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
 
   if (!spec->rule) {
@@ -3497,6 +3548,13 @@ int IndexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString
     return REDISMODULE_ERR;
   }
 
+  if (IndexingPipeline_Accepts(spec, openKey, scanned)) {
+    IndexingPipeline_Submit(spec, &doc, scanned);
+    return REDISMODULE_OK;
+  }
+  // Keep the order of the writes to the document
+  IndexingPipeline_Flush(spec);
+
   unsigned int numOps = doc.numFields != 0 ? doc.numFields: 1;
   IndexerYieldWhileLoading(ctx, numOps, REDISMODULE_YIELD_FLAG_CLIENTS);
   RedisSearchCtx_LockSpecWrite(&sctx);
@@ -3507,6 +3565,7 @@ int IndexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString
   // Reuse the caller's open key handle for the DocIdMeta update, if provided.
   aCtx->disk.openKey = openKey;
   AddDocumentCtx_Submit(aCtx, &sctx, DOCUMENT_ADD_REPLACE);
+  IndexSpec_BumpWriteEpoch(spec);
 
   Document_Free(&doc);
 
@@ -3516,6 +3575,16 @@ int IndexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString
   return REDISMODULE_OK;
 }
 
+int IndexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
+                        DocumentType type, RedisModuleKey *openKey) {
+  return indexSpec_UpdateDoc(spec, ctx, key, type, openKey, false);
+}
+
+int IndexSpec_UpdateScannedDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
+                               DocumentType type) {
+  return indexSpec_UpdateDoc(spec, ctx, key, type, NULL, true);
+}
+
 // Shared helper: update stats and clean up auxiliary indexes after a document deletion.
 // Caller must hold the spec write lock.
 static void indexSpec_OnDocDeleted(IndexSpec *spec, t_docId docId, uint32_t docLen) {
@@ -3608,12 +3677,15 @@ void IndexSpec_DeleteDoc_Unsafe(IndexSpec *spec, RedisModuleCtx *ctx, RedisModul
   }
 
   indexSpec_OnDocDeleted(spec, id, docLen);
+  IndexSpec_BumpWriteEpoch(spec);
 }
 
 int IndexSpec_DeleteDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
                         RedisModuleKey *openKey) {
   RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
 
+  // The document may still be waiting to be indexed
+  IndexingPipeline_Flush(spec);
   IndexSpec_IncrActiveWrites(spec);
   RedisSearchCtx_LockSpecWrite(&sctx);
   IndexSpec_DeleteDoc_Unsafe(spec, ctx, key, openKey);
@@ -3640,6 +3712,7 @@ void IndexSpec_DeleteDocById(IndexSpec *spec, t_docId docId) {
   }
 
   indexSpec_OnDocDeleted(spec, docId, docLen);
+  IndexSpec_BumpWriteEpoch(spec);
 
   IndexSpec_DecrActiveWrites(spec);
   pthread_rwlock_unlock(&spec->rwlock);
@@ -16,6 +16,7 @@
 #include "config.h"
 #include "doc_table.h"
 #include "trie/trie.h"
+#include "ngram_index.h"
 #include "sortable.h"
 #include "stopwords.h"
 #include "gc.h"
@@ -72,6 +73,7 @@ struct IndexesScanner;
 #define SPEC_ASYNC_STR "ASYNC"
 #define SPEC_SKIPINITIALSCAN_STR "SKIPINITIALSCAN"
 #define SPEC_WITHSUFFIXTRIE_STR "WITHSUFFIXTRIE"
+#define SPEC_WITHNGRAMS_STR "WITHNGRAMS"
 #define SPEC_INDEXEMPTY_STR "INDEXEMPTY"
 #define SPEC_INDEXMISSING_STR "INDEXMISSING"
 #define SPEC_INDEXALL_STR "INDEXALL"
@@ -222,7 +224,8 @@ typedef uint16_t FieldSpecDedupeArray[SPEC_MAX_FIELDS];
 #define INDEX_DEFAULT_FLAGS \
   Index_StoreFreqs | Index_StoreTermOffsets | Index_StoreFieldFlags | Index_StoreByteOffsets
 
-#define INDEX_CURRENT_VERSION 27
+#define INDEX_CURRENT_VERSION 28
+#define INDEX_CONTENTS_VERSION 28
 #define INDEX_VECTOR_RERANK_VERSION 27
 #define INDEX_DISK_VERSION 26
 #define INDEX_VECSIM_SVS_VAMANA_VERSION 25
@@ -308,6 +311,8 @@ typedef struct IndexSpec {
   Trie *terms;                    // Trie of all TEXT terms. Used for GC and fuzzy queries
   Trie *suffix;                   // Trie of TEXT suffix tokens of terms. Used for contains queries
   t_fieldMask suffixMask;         // Mask of all fields that support contains query
+  NgramIndex *ngrams;             // Trigrams of TEXT terms. Used for contains queries
+  t_fieldMask ngramMask;          // Mask of all fields that support contains query by trigrams
   dict *keysDict;                 // Inverted indexes dictionary of all TEXT terms
 
   DocTable docs;                  // Contains metadata of all documents
@@ -366,6 +371,21 @@ typedef struct IndexSpec {
   // Quick access to the spec's strong ref
   StrongRef own_ref;
 
+  // Bumped on every write that may change a query reply. Atomic, see IndexSpec_BumpWriteEpoch
+  uint64_t writeEpoch;
+  // Cached query replies, tagged by writeEpoch. Created on the main thread on
+  // the first cacheable query, NULL while the cache is disabled
+  struct QueryCache *queryCache;
+  // Cached documents of repeated tag, numeric and geo filters, invalidated per
+  // field by the indexer. Created on the main thread like queryCache
+  struct FilterCache *filterCache;
+  // Documents waiting to be indexed asynchronously, see indexing_pipeline.h.
+  // Created on the main thread on the first queued document
+  struct IndexingPipeline *indexingPipeline;
+  // Documents restored from the RDB, whose keys are being loaded, see index_snapshot.h.
+  // Set while the RDB is loading only
+  struct IndexSnapshotRestore *snapshotRestore;
+
   // Contains inverted indexes of missing fields
   dict *missingFieldDict;
   // Maps between field ftid and field index in the fields array
@@ -417,6 +437,13 @@ static inline uint32_t IndexSpec_GetActiveQueries(IndexSpec *sp) {
   return __atomic_load_n(&sp->stats.activeQueries, __ATOMIC_RELAXED);
 }
 
+static inline void IndexSpec_BumpWriteEpoch(IndexSpec *sp) {
+  __atomic_add_fetch(&sp->writeEpoch, 1, __ATOMIC_RELEASE);
+}
+static inline uint64_t IndexSpec_GetWriteEpoch(const IndexSpec *sp) {
+  return __atomic_load_n(&sp->writeEpoch, __ATOMIC_ACQUIRE);
+}
+
 static inline void IndexSpec_IncrActiveWrites(IndexSpec *sp) {
   __atomic_add_fetch(&sp->stats.activeWrites, 1, __ATOMIC_RELAXED);
 }
@@ -598,6 +625,11 @@ void IndexSpec_DeleteDocById(IndexSpec *spec, t_docId docId);
 int IndexSpec_UpdateDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
                         DocumentType type, RedisModuleKey *openKey);
 
+// Like IndexSpec_UpdateDoc, for a key found by the background scan of the spec.
+// The document may be preprocessed on the worker threads, see BG_INDEX_MAX_PENDING.
+int IndexSpec_UpdateScannedDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key,
+                               DocumentType type);
+
 // Format the legacy (separate-key) Redis key name for a numeric/tag/geo field.
 RedisModuleString *IndexSpec_LegacyGetFormattedKey(IndexSpec *sp, const FieldSpec *fs,
                                                    FieldType forType);
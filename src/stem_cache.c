@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "stem_cache.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "snowball/include/libstemmer.h"
+#include "config.h"
+#include "rmalloc.h"
+#include "fnv_ffi.h"
+
+#define STEM_CACHE_SHARDS 64
+#define STEM_CACHE_SHARD_SLOTS 1024
+
+typedef struct {
+  uint64_t hash;
+  uint8_t language;
+  uint8_t wordLen;
+  uint8_t stemLen;
+  char data[];  // the word, then the stem
+} StemCacheEntry;
+
+typedef struct {
+  pthread_rwlock_t lock;
+  StemCacheEntry **slots;  // allocated on the first insertion
+  size_t hits;
+  size_t misses;
+} __attribute__((aligned(64))) StemCacheShard;
+
+static StemCacheShard shards_g[STEM_CACHE_SHARDS];
+static pthread_once_t initOnce_g = PTHREAD_ONCE_INIT;
+// Updated atomically
+static size_t memory_g;
+static size_t entries_g;
+
+static void initShards(void) {
+  for (size_t ii = 0; ii < STEM_CACHE_SHARDS; ++ii) {
+    pthread_rwlock_init(&shards_g[ii].lock, NULL);
+  }
+}
+
+static inline size_t entrySize(size_t wordLen, size_t stemLen) {
+  return sizeof(StemCacheEntry) + wordLen + stemLen;
+}
+
+static inline void copyStem(const char *stem, size_t stemLen, char **buf, size_t *cap,
+                            size_t prefixLen) {
+  if (prefixLen + stemLen + 1 > *cap) {
+    *cap = prefixLen + stemLen + 1;
+    *buf = rm_realloc(*buf, *cap);
+  }
+  memcpy(*buf + prefixLen, stem, stemLen);
+  (*buf)[prefixLen + stemLen] = '\0';
+}
+
+// Called with the shard write lock held
+static void insert(StemCacheShard *shard, size_t slot, uint64_t hash, RSLanguage language,
+                   const char *word, size_t wordLen, const char *stem, size_t stemLen) {
+  if (!shard->slots) {
+    const size_t slotsSize = STEM_CACHE_SHARD_SLOTS * sizeof(*shard->slots);
+    if (__atomic_load_n(&memory_g, __ATOMIC_RELAXED) + slotsSize > RSGlobalConfig.stemCacheMaxMemory) {
+      return;
+    }
+    shard->slots = rm_calloc(STEM_CACHE_SHARD_SLOTS, sizeof(*shard->slots));
+    __atomic_add_fetch(&memory_g, slotsSize, __ATOMIC_RELAXED);
+  }
+
+  StemCacheEntry *old = shard->slots[slot];
+  const size_t oldSize = old ? entrySize(old->wordLen, old->stemLen) : 0;
+  const size_t size = entrySize(wordLen, stemLen);
+  if (__atomic_load_n(&memory_g, __ATOMIC_RELAXED) + size - oldSize > RSGlobalConfig.stemCacheMaxMemory) {
+    return;
+  }
+
+  StemCacheEntry *e = rm_malloc(size);
+  e->hash = hash;
+  e->language = language;
+  e->wordLen = wordLen;
+  e->stemLen = stemLen;
+  memcpy(e->data, word, wordLen);
+  memcpy(e->data + wordLen, stem, stemLen);
+  shard->slots[slot] = e;
+  rm_free(old);
+  __atomic_add_fetch(&memory_g, size - oldSize, __ATOMIC_RELAXED);
+  if (!old) {
+    __atomic_add_fetch(&entries_g, 1, __ATOMIC_RELAXED);
+  }
+}
+
+ssize_t StemCache_Stem(struct sb_stemmer *sb, RSLanguage language, const char *word, size_t len,
+                       char **buf, size_t *cap, size_t prefixLen) {
+  if (!RSGlobalConfig.stemCacheMaxMemory || len > STEM_CACHE_MAX_WORD_LEN) {
+    const sb_symbol *stemmed = sb_stemmer_stem(sb, (const sb_symbol *)word, (int)len);
+    if (!stemmed) {
+      return -1;
+    }
+    const size_t stemLen = sb_stemmer_length(sb);
+    copyStem((const char *)stemmed, stemLen, buf, cap, prefixLen);
+    return stemLen;
+  }
+
+  pthread_once(&initOnce_g, initShards);
+  const uint8_t lang = language;
+  const uint64_t hash = fnv_64a_buf(word, len, fnv_64a_buf(&lang, sizeof(lang), 0));
+  StemCacheShard *shard = &shards_g[hash % STEM_CACHE_SHARDS];
+  const size_t slot = (hash / STEM_CACHE_SHARDS) % STEM_CACHE_SHARD_SLOTS;
+
+  pthread_rwlock_rdlock(&shard->lock);
+  const StemCacheEntry *e = shard->slots ? shard->slots[slot] : NULL;
+  if (e && e->hash == hash && e->language == lang && e->wordLen == len &&
+      !memcmp(e->data, word, len)) {
+    const size_t stemLen = e->stemLen;
+    copyStem(e->data + len, stemLen, buf, cap, prefixLen);
+    pthread_rwlock_unlock(&shard->lock);
+    __atomic_add_fetch(&shard->hits, 1, __ATOMIC_RELAXED);
+    return stemLen;
+  }
+  pthread_rwlock_unlock(&shard->lock);
+  __atomic_add_fetch(&shard->misses, 1, __ATOMIC_RELAXED);
+
+  const sb_symbol *stemmed = sb_stemmer_stem(sb, (const sb_symbol *)word, (int)len);
+  if (!stemmed) {
+    return -1;
+  }
+  const size_t stemLen = sb_stemmer_length(sb);
+  copyStem((const char *)stemmed, stemLen, buf, cap, prefixLen);
+  if (stemLen <= UINT8_MAX) {
+    pthread_rwlock_wrlock(&shard->lock);
+    insert(shard, slot, hash, language, word, len, *buf + prefixLen, stemLen);
+    pthread_rwlock_unlock(&shard->lock);
+  }
+  return stemLen;
+}
+
+StemCacheStats StemCache_GetStats(void) {
+  StemCacheStats stats = {
+    .entries = __atomic_load_n(&entries_g, __ATOMIC_RELAXED),
+    .memory = __atomic_load_n(&memory_g, __ATOMIC_RELAXED),
+  };
+  for (size_t ii = 0; ii < STEM_CACHE_SHARDS; ++ii) {
+    stats.hits += __atomic_load_n(&shards_g[ii].hits, __ATOMIC_RELAXED);
+    stats.misses += __atomic_load_n(&shards_g[ii].misses, __ATOMIC_RELAXED);
+  }
+  return stats;
+}
+
+void StemCache_Free(void) {
+  for (size_t ii = 0; ii < STEM_CACHE_SHARDS; ++ii) {
+    StemCacheShard *shard = &shards_g[ii];
+    if (!shard->slots) {
+      continue;
+    }
+    for (size_t jj = 0; jj < STEM_CACHE_SHARD_SLOTS; ++jj) {
+      rm_free(shard->slots[jj]);
+    }
+    rm_free(shard->slots);
+    shard->slots = NULL;
+  }
+  memory_g = 0;
+  entries_g = 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stddef.h>
+#include <sys/types.h>
+#include "language.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sb_stemmer;
+
+/**
+ * Process-wide cache of the snowball stems of words, by language.
+ *
+ * Natural language vocabularies are very repetitive, so the tokenizer and the
+ * query expander look the stem of a word up here before running the stemmer.
+ * The cache is split in shards, each guarded by a read-write lock, so that the
+ * worker threads share it with little contention.
+ *
+ * Each shard is a direct-mapped table: a word replaces the entry whose slot it
+ * hashes to. New entries are not added while the cache holds STEM_CACHE_MAX_MEMORY
+ * bytes. 0 disables the cache.
+ */
+
+// Longer words are not cached
+#define STEM_CACHE_MAX_WORD_LEN 64
+
+typedef struct {
+  size_t hits;
+  size_t misses;
+  size_t entries;
+  size_t memory;
+} StemCacheStats;
+
+/**
+ * Stem the `len` bytes of `word`, in `language`, with `sb`, unless the stem is cached.
+ * The stem is written NUL-terminated to `*buf` after `prefixLen` reserved bytes,
+ * growing `*buf` (of `*cap` bytes) with rm_realloc as needed. Returns the length of
+ * the stem, or -1 if `sb` failed.
+ * Safe to call from any thread, `sb` must not be used concurrently.
+ */
+ssize_t StemCache_Stem(struct sb_stemmer *sb, RSLanguage language, const char *word, size_t len,
+                       char **buf, size_t *cap, size_t prefixLen);
+
+StemCacheStats StemCache_GetStats(void);
+
+/** Free all the entries. Called when the module is unloaded */
+void StemCache_Free(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,39 +15,30 @@
 #include "snowball/include/libstemmer.h"
 #include "rmalloc.h"
 #include "rmutil/rm_assert.h"
+#include "stem_cache.h"
 
 struct sbStemmerCtx {
   struct sb_stemmer *sb;
+  RSLanguage language;
   char *buf;
   size_t cap;
 };
 
 const char *__sbstemmer_Stem(void *ctx, const char *word, size_t len, size_t *outlen) {
-  const sb_symbol *b = (const sb_symbol *)word;
   struct sbStemmerCtx *stctx = ctx;
-  struct sb_stemmer *sb = stctx->sb;
 
-  const sb_symbol *stemmed = sb_stemmer_stem(sb, b, (int)len);
-  if (stemmed) {
-    *outlen = sb_stemmer_length(sb);
-
-    // if the stem and its origin are the same - don't do anything
-    if (*outlen == len && strncasecmp(word, (const char *)stemmed, len) == 0) {
-      return NULL;
-    }
-    // reserver one character for the '+' prefix
-    *outlen += 1;
-
-    // make sure the expansion plus the 1 char prefix fit in our static buffer
-    if (*outlen + 2 > stctx->cap) {
-      stctx->cap = *outlen + 2;
-      stctx->buf = rm_realloc(stctx->buf, stctx->cap);
-    }
-    // the first location is saved for the + prefix
-    memcpy(stctx->buf + 1, stemmed, *outlen + 1);
-    return (const char *)stctx->buf;
+  // the first location is saved for the + prefix
+  ssize_t stemLen = StemCache_Stem(stctx->sb, stctx->language, word, len, &stctx->buf, &stctx->cap, 1);
+  if (stemLen < 0) {
+    return NULL;
+  }
+  // if the stem and its origin are the same - don't do anything
+  if ((size_t)stemLen == len && strncasecmp(word, stctx->buf + 1, len) == 0) {
+    return NULL;
   }
-  return NULL;
+  // reserver one character for the '+' prefix
+  *outlen = stemLen + 1;
+  return (const char *)stctx->buf;
 }
 
 void __sbstemmer_Free(Stemmer *s) {
@@ -75,6 +66,7 @@ Stemmer *__newSnowballStemmer(RSLanguage language) {
 
   struct sbStemmerCtx *ctx = rm_malloc(sizeof(*ctx));
   ctx->sb = sb;
+  ctx->language = language;
   ctx->cap = 24;
   ctx->buf = rm_malloc(ctx->cap);
   ctx->buf[0] = STEM_PREFIX;
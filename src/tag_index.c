@@ -104,19 +104,45 @@ char *TagIndex_SepString(char sep, char **s, size_t *toklen, bool indexEmpty) {
   return start;
 }
 
-static int tokenizeTagString(const char *str, const FieldSpec *fs, char ***resArray) {
+#define TAG_ARENA_BLOCK_SIZE 4096
+
+// Copy `len` bytes of `s` as a NUL-terminated string, into `arena` if given.
+static char *tagStrndup(BlkAlloc *arena, const char *s, size_t len) {
+  if (!arena) {
+    return rm_strndup(s, len);
+  }
+  char *dst = BlkAlloc_Alloc(arena, len + 1, MAX(TAG_ARENA_BLOCK_SIZE, len + 1));
+  memcpy(dst, s, len);
+  dst[len] = '\0';
+  return dst;
+}
+
+// Take ownership of the heap-allocated `s`, moving it into `arena` if given.
+static char *tagAdopt(BlkAlloc *arena, char *s, size_t len) {
+  if (!arena) {
+    return s;
+  }
+  char *dst = tagStrndup(arena, s, len);
+  rm_free(s);
+  return dst;
+}
+
+static int tokenizeTagString(const char *str, const FieldSpec *fs, char ***resArray,
+                             BlkAlloc *arena) {
   char sep = fs->tagOpts.tagSep;
   TagFieldFlags flags = fs->tagOpts.tagFlags;
   bool indexEmpty = FieldSpec_IndexesEmpty(fs);
 
   if (sep == TAG_FIELD_DEFAULT_JSON_SEP) {
-    char *tok = rm_strdup(str);
+    size_t len = strlen(str);
+    char *tok = tagStrndup(arena, str, len);
     if (!(flags & TagField_CaseSensitive)) { // check case sensitive
-      size_t len = strlen(tok);
       char *dst = unicode_tolower(tok, &len);
       if (dst) {
-        rm_free(tok);
-        tok = dst;
+        if (!arena) {
+          rm_free(tok);
+        }
+        tok = tagAdopt(arena, dst, len);
       } else {
         // No memory allocation, just ensure null termination
         tok[len] = '\0';
@@ -141,12 +167,12 @@ static int tokenizeTagString(const char *str, const FieldSpec *fs, char ***resAr
       if (!(flags & TagField_CaseSensitive)) { // check case sensitive
         char *longer_dst = unicode_tolower(tok, &toklen);
         if (longer_dst) {
-          tok = longer_dst;
+          tok = tagAdopt(arena, longer_dst, toklen);
         } else {
-          tok = rm_strndup(tok, MIN(toklen, MAX_TAG_LEN));
+          tok = tagStrndup(arena, tok, MIN(toklen, MAX_TAG_LEN));
         }
       } else {
-        tok = rm_strndup(tok, MIN(toklen, MAX_TAG_LEN));
+        tok = tagStrndup(arena, tok, MIN(toklen, MAX_TAG_LEN));
       }
 
       array_append(*resArray, tok);
@@ -159,7 +185,7 @@ static int tokenizeTagString(const char *str, const FieldSpec *fs, char ***resAr
   // field that ends with a separator as well.
   if (indexEmpty) {
     if (p == pp || last_is_sep)
-    tok = rm_strdup("");
+    tok = tagStrndup(arena, "", 0);
     array_append(*resArray, tok);
   }
 
@@ -168,20 +194,25 @@ static int tokenizeTagString(const char *str, const FieldSpec *fs, char ***resAr
 }
 
 int TagIndex_Preprocess(const FieldSpec *fs, const DocumentField *data, FieldIndexerData *fdata) {
+  return TagIndex_PreprocessInArena(fs, data, fdata, NULL);
+}
+
+int TagIndex_PreprocessInArena(const FieldSpec *fs, const DocumentField *data,
+                               FieldIndexerData *fdata, BlkAlloc *arena) {
   arrayof(char*) arr = array_new(char *, 4);
   const char *str;
   int ret = 1;
   switch (data->unionType) {
   case FLD_VAR_T_RMS:
     str = (char *)RedisModule_StringPtrLen(data->text, NULL);
-    tokenizeTagString(str, fs, &arr);
+    tokenizeTagString(str, fs, &arr, arena);
     break;
   case FLD_VAR_T_CSTR:
-    tokenizeTagString(data->strval, fs, &arr);
+    tokenizeTagString(data->strval, fs, &arr, arena);
     break;
   case FLD_VAR_T_ARRAY:
     for (int i = 0; i < data->arrayLen; i++) {
-      tokenizeTagString(data->multiVal[i], fs, &arr);
+      tokenizeTagString(data->multiVal[i], fs, &arr, arena);
     }
     break;
   case FLD_VAR_T_NULL:
@@ -227,6 +258,7 @@ static inline size_t tagIndex_Put(TagIndex *idx, const char *value, size_t len,
     (*numRecords)++;
   }
   IndexStats_BlockCountAdd(stats, r.blocks_added);
+  stats->invertedSize -= r.mem_released;
   return r.mem_growth + sz;
 }
 
@@ -187,6 +187,11 @@ arrayof(char *)
  */
 int TagIndex_Preprocess(const FieldSpec *fs, const DocumentField *data, FieldIndexerData *fdata);
 
+/* Like TagIndex_Preprocess, but the tags are allocated from `arena` and are released with it.
+   Only the `tags` array itself must be freed, with array_free */
+int TagIndex_PreprocessInArena(const FieldSpec *fs, const DocumentField *data,
+                               FieldIndexerData *fdata, BlkAlloc *arena);
+
 static inline void TagIndex_FreePreprocessedData(char **s) {
   array_foreach(s, tmpv, { rm_free(tmpv); });
   array_free(s);
@@ -38,6 +38,43 @@ static void simpleTokenizer_Start(RSTokenizer *base, char *text, size_t len, uin
 // Normalization buffer
 #define MAX_NORMALIZE_SIZE 128
 
+static inline int isPlainAscii(uint8_t c) {
+  // Not a blank, a control character, a backslash or a non-ASCII byte
+  return c > ' ' && c < 0x7F && c != '\\';
+}
+
+/**
+ * Lower-case the `len` bytes of `s` into `dst` if they are all plain ASCII
+ * characters, the common case, which needs no other normalization. Returns 0
+ * otherwise, possibly having written a prefix of `dst`.
+ */
+static int asciiToLower(const char *s, char *dst, size_t len) {
+  size_t ii = 0;
+#ifdef TOKSEP_SSE2
+  for (; ii + 16 <= len; ii += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(s + ii));
+    // Blanks and control characters are below '!', non-ASCII bytes are negative
+    __m128i special = _mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8('!')),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)),
+                                                _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+    if (_mm_movemask_epi8(special)) {
+      return 0;
+    }
+    __m128i upper = toksep_inRange(v, 'A', 'Z');
+    v = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    _mm_storeu_si128((__m128i *)(dst + ii), v);
+  }
+#endif
+  for (; ii < len; ++ii) {
+    uint8_t c = s[ii];
+    if (!isPlainAscii(c)) {
+      return 0;
+    }
+    dst[ii] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+  }
+  return 1;
+}
+
 /**
  * Normalizes text.
  * - s contains the raw token
@@ -48,6 +85,11 @@ static void simpleTokenizer_Start(RSTokenizer *base, char *text, size_t len, uin
  */
 static char *DefaultNormalize(char *s, char *dst, size_t *len, int *allocated) {
   size_t origLen = *len;
+  if (asciiToLower(s, dst, origLen)) {
+    *allocated = 0;
+    return dst;
+  }
+
   char *realDest = s;
   size_t dstLen = 0;
 
@@ -19,16 +19,74 @@ static const char ToksepMap_g[256] = {
     ['+'] = 1, ['|'] = 1,  ['\''] = 1, ['`'] = 1, ['"'] = 1, ['<'] = 1, ['>'] = 1, ['?'] = 1,
 };
 
+// The separators are scanned 16 bytes at a time with SSE2, which every x86-64 CPU has.
+// Tokens are a few bytes long on average, so wider vectors would not pay off. The
+// aligned loads may read past the end of the string within its last 16-byte block,
+// which never crosses a page but trips the address sanitizer
+#if defined(__SSE2__) && !defined(__SANITIZE_ADDRESS__)
+#if defined(__has_feature)
+#if !__has_feature(address_sanitizer)
+#define TOKSEP_SSE2
+#endif
+#else
+#define TOKSEP_SSE2
+#endif
+#endif
+
+#ifdef TOKSEP_SSE2
+#include <emmintrin.h>
+
+static inline __m128i toksep_inRange(__m128i v, char lo, char hi) {
+  const __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+  return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(hi - lo)), d);
+}
+
+// Bit i is set if byte i may be a separator, a backslash or the terminating NUL,
+// that is any ASCII byte other than a letter or a digit. Over-approximates ToksepMap_g
+static inline unsigned toksep_candidateMask(__m128i v) {
+  const __m128i c = _mm_or_si128(
+      _mm_or_si128(toksep_inRange(v, 0x00, 0x2F), toksep_inRange(v, 0x3A, 0x40)),
+      _mm_or_si128(toksep_inRange(v, 0x5B, 0x60), toksep_inRange(v, 0x7B, 0x7F)));
+  return (unsigned)_mm_movemask_epi8(c);
+}
+#endif
+
+// Skip to the first byte of `pos` which may be a separator, a backslash or the NUL terminator
+static inline const uint8_t *toksep_skipWord(const uint8_t *pos) {
+#ifdef TOKSEP_SSE2
+  const uintptr_t misalign = (uintptr_t)pos & 15;
+  const __m128i *block = (const __m128i *)(pos - misalign);
+  unsigned mask = toksep_candidateMask(_mm_load_si128(block)) >> misalign;
+  if (mask) {
+    return pos + __builtin_ctz(mask);
+  }
+  for (;;) {
+    mask = toksep_candidateMask(_mm_load_si128(++block));
+    if (mask) {
+      return (const uint8_t *)block + __builtin_ctz(mask);
+    }
+  }
+#else
+  while (*pos && !ToksepMap_g[*pos] && *pos != '\\') {
+    ++pos;
+  }
+  return pos;
+#endif
+}
+
 /**
  * Function reads string pointed to by `s` and indicates the length of the next
  * token in `tokLen`. `s` is set to NULL if this is the last token.
  */
 static inline char *toksep(char **s, size_t *tokLen) {
-  uint8_t *pos = (uint8_t *)*s;
+  const uint8_t *pos = (const uint8_t *)*s;
   char *orig = *s;
-  int escaped = 0;
-  for (; *pos; ++pos) {
-    if (ToksepMap_g[*pos] && !escaped) {
+  for (;;) {
+    pos = toksep_skipWord(pos);
+    if (!*pos) {
+      break;
+    }
+    if (ToksepMap_g[*pos]) {
       *s = (char *)++pos;
       *tokLen = ((char *)pos - orig) - 1;
       if (!*pos) {
@@ -36,7 +94,11 @@ static inline char *toksep(char **s, size_t *tokLen) {
       }
       return orig;
     }
-    escaped = !escaped && *pos == '\\';
+    if (*pos == '\\' && pos[1]) {
+      // The escaped character is part of the token
+      ++pos;
+    }
+    ++pos;
   }
 
   // Didn't find a terminating token. Use a simpler length calculation
@@ -16,8 +16,12 @@
 #include "libnu/casemap.h"
 #include "trie/sparse_vector.h"
 #include "trie/trie_node.h"
+#include "util/khash.h"
 
 static rune runeLower(rune r) {
+  if (r < 0x80) {
+    return (r >= 'A' && r <= 'Z') ? r + ('a' - 'A') : r;
+  }
   uint32_t lowered = 0;
   const char *map = 0;
   map = nu_tolower((uint32_t)r);
@@ -115,23 +119,36 @@ void dfaNode_free(dfaNode *d) {
   rm_free(d);
 }
 
-dfaNode *dfaCache_get(Vector *cache, sparseVector *v) {
-  size_t n = Vector_Size(cache);
-  for (int i = 0; i < n; i++) {
-    dfaNode *dfn;
-    Vector_Get(cache, i, &dfn);
-
-    if (sv_equals(v, dfn->v)) {
-      return dfn;
-    }
+static inline khint_t sv_hash(const sparseVector *v) {
+  khint_t h = (khint_t)v->len;
+  for (size_t i = 0; i < v->len; i++) {
+    h = h * 31 + (khint_t)v->entries[i].idx;
+    h = h * 31 + (khint_t)v->entries[i].val;
   }
-  return NULL;
+  return h;
 }
 
+// The DFA states built so far, by state vector
+KHASH_INIT(dfaStates, sparseVector *, dfaNode *, 1, sv_hash, sv_equals)
+
 void dfaCache_put(Vector *cache, dfaNode *dfn) {
   Vector_Push(cache, dfn);
 }
 
+// Return the state of vector `v`, which is consumed, creating it if it was not built yet
+static dfaNode *dfaCache_getOrPut(khash_t(dfaStates) *states, Vector *cache, sparseVector *v) {
+  int absent;
+  khiter_t k = kh_put(dfaStates, states, v, &absent);
+  if (!absent) {
+    sparseVector_free(v);
+    return kh_value(states, k);
+  }
+  dfaNode *dfn = dfaNode_new(v->entries[v->len - 1].val, v);
+  kh_value(states, k) = dfn;
+  dfaCache_put(cache, dfn);
+  return dfn;
+}
+
 inline dfaNode *dfaNode_getEdge(dfaNode *n, rune r) {
   for (int i = 0; i < n->numEdges; i++) {
     if (n->edges[i].r == r) {
@@ -141,54 +158,71 @@ inline dfaNode *dfaNode_getEdge(dfaNode *n, rune r) {
   return NULL;
 }
 
-void dfaNode_addEdge(dfaNode *n, rune r, dfaNode *child) {
-  n->edges = rm_realloc(n->edges, sizeof(dfaEdge) * (n->numEdges + 1));
-  n->edges[n->numEdges++] = (dfaEdge){.r = r, .n = child};
-}
-
-void dfa_build(dfaNode *parent, SparseAutomaton *a, Vector *cache) {
-  parent->match = SparseAutomaton_IsMatch(a, parent->v);
-
-  for (int i = 0; i < parent->v->len; i++) {
-    if (parent->v->entries[i].idx < a->len) {
-      rune c = a->string[parent->v->entries[i].idx];
-      dfaNode *edge = dfaNode_getEdge(parent, c);
-      if (edge == NULL) {
-        sparseVector *nv = SparseAutomaton_Step(a, parent->v, c);
-
-        if (nv->len > 0) {
-          dfaNode *dfn = dfaCache_get(cache, nv);
-          if (dfn == NULL) {
-            int dist = nv->entries[nv->len - 1].val;
-            edge = dfaNode_new(dist, nv);
-            dfaNode_addEdge(parent, c, edge);
-            dfaCache_put(cache, edge);
-            dfa_build(edge, a, cache);
-            continue;
-          } else {
-            dfaNode_addEdge(parent, c, dfn);
-          }
-        }
+// Set the edges and the fallback of state `n`
+static void dfa_expand(dfaNode *n, SparseAutomaton *a, khash_t(dfaStates) *states, Vector *cache) {
+  n->match = SparseAutomaton_IsMatch(a, n->v);
+  // Only the runes of the query at the positions of the vector lead to other states,
+  // one edge at most per entry
+  n->edges = rm_malloc(n->v->len * sizeof(*n->edges));
+
+  for (int i = 0; i < n->v->len; i++) {
+    if (n->v->entries[i].idx < a->len) {
+      rune c = a->string[n->v->entries[i].idx];
+      if (dfaNode_getEdge(n, c)) {
+        continue;
+      }
+      sparseVector *nv = SparseAutomaton_Step(a, n->v, c);
+      if (nv->len > 0) {
+        n->edges[n->numEdges++] = (dfaEdge){.r = c, .n = dfaCache_getOrPut(states, cache, nv)};
+      } else {
         sparseVector_free(nv);
       }
     }
   }
 
-  // if (parent->distance < a->max) {
-  sparseVector *nv = SparseAutomaton_Step(a, parent->v, 1);
+  // Any other rune
+  sparseVector *nv = SparseAutomaton_Step(a, n->v, 1);
   if (nv->len > 0) {
-    dfaNode *dfn = dfaCache_get(cache, nv);
-    if (dfn) {
-      parent->fallback = dfn;
-    } else {
-      int dist = nv->entries[nv->len - 1].val;
-      parent->fallback = dfaNode_new(dist, nv);
-      dfaCache_put(cache, parent->fallback);
-      dfa_build(parent->fallback, a, cache);
-      return;
-    }
+    n->fallback = dfaCache_getOrPut(states, cache, nv);
+  } else {
+    sparseVector_free(nv);
   }
-  sparseVector_free(nv);
+}
+
+void dfa_build(SparseAutomaton *a, Vector *cache) {
+  khash_t(dfaStates) *states = kh_init(dfaStates);
+  for (size_t i = 0; i < Vector_Size(cache); i++) {
+    dfaNode *dfn;
+    Vector_Get(cache, i, &dfn);
+    int absent;
+    khiter_t k = kh_put(dfaStates, states, dfn->v, &absent);
+    kh_value(states, k) = dfn;
+  }
+
+  // The cache doubles as the work queue: every state is expanded once, after the states
+  // before it, which appends the states it leads to that were not seen yet
+  for (size_t i = 0; i < Vector_Size(cache); i++) {
+    dfaNode *dfn;
+    Vector_Get(cache, i, &dfn);
+    dfa_expand(dfn, a, states, cache);
+  }
+  kh_destroy(dfaStates, states);
+
+  // The vectors only tell the states apart while building
+  for (size_t i = 0; i < Vector_Size(cache); i++) {
+    dfaNode *dfn;
+    Vector_Get(cache, i, &dfn);
+    sparseVector_free(dfn->v);
+    dfn->v = NULL;
+  }
+}
+
+static inline void DFAFilter_Push(DFAFilter *fc, dfaNode *node, int minDist) {
+  if (fc->depth == fc->cap) {
+    fc->cap *= 2;
+    fc->stack = rm_realloc(fc->stack, fc->cap * sizeof(*fc->stack));
+  }
+  fc->stack[fc->depth++] = (dfaFrame){.node = node, .minDist = minDist};
 }
 
 DFAFilter *NewDFAFilter(rune *str, size_t len, int maxDist, TrieMatchMode mode) {
@@ -199,16 +233,16 @@ DFAFilter *NewDFAFilter(rune *str, size_t len, int maxDist, TrieMatchMode mode)
   sparseVector *v = SparseAutomaton_Start(&a);
   dfaNode *dr = dfaNode_new(0, v);
   dfaCache_put(cache, dr);
-  dfa_build(dr, &a, cache);
+  dfa_build(&a, cache);
 
   DFAFilter *ret = rm_malloc(sizeof(*ret));
   ret->cache = cache;
-  ret->stack = NewVector(dfaNode *, 8);
-  ret->distStack = NewVector(int, 8);
+  ret->cap = 16;
+  ret->stack = rm_malloc(ret->cap * sizeof(*ret->stack));
+  ret->depth = 0;
   ret->a = a;
   ret->mode = mode;
-  Vector_Push(ret->stack, dr);
-  Vector_Push(ret->distStack, (maxDist + 1));
+  DFAFilter_Push(ret, dr, maxDist + 1);
 
   return ret;
 }
@@ -222,14 +256,13 @@ void DFAFilter_Free(DFAFilter *fc) {
   }
 
   Vector_Free(fc->cache);
-  Vector_Free(fc->stack);
-  Vector_Free(fc->distStack);
+  rm_free(fc->stack);
 }
 
 // Emit the running minimum edit distance into the caller-supplied matchCtx
 // (an `int *`). On each rune step we track minDist = MIN over all accept-state
 // costs reached along the current DFA path, kept in parallel with the DFA
-// state stack via distStack. dn->distance is the cost stored at the last
+// state in each frame of the stack. dn->distance is the cost stored at the last
 // entry of the DFA state's sparse vector — when dn->match is true this is
 // min Levenshtein(query, input consumed so far) (see SparseAutomaton_IsMatch).
 // In prefix mode, once the prefix accepts, minDist is preserved across the
@@ -237,17 +270,14 @@ void DFAFilter_Free(DFAFilter *fc) {
 // up holding the cost recorded at the accept boundary.
 FilterCode FilterFunc(rune b, void *ctx, int *matched, void *matchCtx, runeTransform rTransform) {
   DFAFilter *fc = ctx;
-  dfaNode *dn;
-  int minDist;
-
-  Vector_Get(fc->stack, Vector_Size(fc->stack) - 1, &dn);
-  Vector_Get(fc->distStack, Vector_Size(fc->distStack) - 1, &minDist);
+  const dfaFrame *top = &fc->stack[fc->depth - 1];
+  dfaNode *dn = top->node;
+  int minDist = top->minDist;
 
   // a null node means we're in prefix mode, and we're done matching our prefix
   if (dn == NULL) {
     *matched = 1;
-    Vector_Push(fc->stack, NULL);
-    Vector_Push(fc->distStack, minDist);
+    DFAFilter_Push(fc, NULL, minDist);
     return F_CONTINUE;
   }
 
@@ -275,12 +305,10 @@ FilterCode FilterFunc(rune b, void *ctx, int *matched, void *matchCtx, runeTrans
         *pdist = MIN(next->distance, minDist);
       }
     }
-    Vector_Push(fc->stack, next);
-    Vector_Push(fc->distStack, MIN(next->distance, minDist));
+    DFAFilter_Push(fc, next, MIN(next->distance, minDist));
     return F_CONTINUE;
   } else if (fc->mode == TRIE_MATCH_PREFIX && *matched) {
-    Vector_Push(fc->stack, NULL);
-    Vector_Push(fc->distStack, minDist);
+    DFAFilter_Push(fc, NULL, minDist);
     return F_CONTINUE;
   }
 
@@ -299,9 +327,5 @@ FilterCode LoweringFilterFunc(rune b, void *ctx, int *matched, void *matchCtx) {
 
 void StackPop(void *ctx, int numLevels) {
   DFAFilter *fc = ctx;
-
-  for (int i = 0; i < numLevels; i++) {
-    Vector_Pop(fc->stack, NULL);
-    Vector_Pop(fc->distStack, NULL);
-  }
+  fc->depth = numLevels < fc->depth ? fc->depth - numLevels : 0;
 }
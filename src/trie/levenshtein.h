@@ -45,7 +45,8 @@
 * http://julesjacobs.github.io/2015/06/17/disqus-levenshtein-simple-and-fast.html
 *
 * We then convert the automaton to a simple DFA that is faster to evaluate during the query stage.
-* This DFA is used while traversing a Trie to decide where to stop.
+* The DFA is built once per query term, and each rune fed to it while traversing a Trie is a
+* single transition, whatever the length of the term.
 */
 typedef struct {
     const rune *string;
@@ -63,6 +64,7 @@ typedef struct dfaNode {
     int distance;
 
     int match;
+    // the state vector of the automaton, only kept while the DFA is built
     sparseVector *v;
     struct dfaEdge *edges;
     size_t numEdges;
@@ -81,8 +83,9 @@ dfaNode *dfaNode_getEdge(dfaNode *n, rune r);
 /* Create a new DFA node */
 dfaNode *dfaNode_new(int distance, sparseVector *state);
 
-/* Recursively build the DFA node and all its descendants */
-void dfa_build(dfaNode *parent, SparseAutomaton *a, Vector *cache);
+/* Build the DFA nodes reachable from the nodes of `cache`, which are appended to it. States are
+ * told apart by a hash of their vectors, which are freed once the DFA is built */
+void dfa_build(SparseAutomaton *a, Vector *cache);
 
 /* Create a new Sparse Levenshtein Automaton  for string s and length len, with a maximal edit
  * distance of maxEdits */
@@ -106,16 +109,24 @@ typedef enum {
     TRIE_MATCH_PREFIX        = 1,  // admit T iff PED(Q, T) <= maxDist (prefix mode)
 } TrieMatchMode;
 
+/* A frame of the DFAFilter stack, pushed for each rune fed to the filter */
+typedef struct {
+    // the DFA state, NULL in prefix mode once the prefix matched
+    dfaNode *node;
+    // The running minimum of accept-state distances along the path leading to
+    // `node`. Used to report the cost of the best prefix match seen so far via
+    // matchCtx in FilterFunc.
+    int minDist;
+} dfaFrame;
+
 /* DFAFilter is a constructed DFA used to filter the traversal on the trie */
 typedef struct {
     // a cache of the DFA states, allowing us to reuse the same state whenever we need it
     Vector *cache;
     // A stack of the states leading up to the current state
-    Vector *stack;
-    // A stack tracking, per DFA state on `stack`, the running minimum of
-    // accept-state distances along the path leading to it. Used to report the
-    // cost of the best prefix match seen so far via matchCtx in FilterFunc.
-    Vector *distStack;
+    dfaFrame *stack;
+    size_t depth;
+    size_t cap;
     // whether the filter matches full edit distance or prefix edit distance
     TrieMatchMode mode;
 
@@ -132,14 +143,13 @@ DFAFilter *NewDFAFilter(rune *str, size_t len, int maxDist, TrieMatchMode mode);
  * Computes prefix edit distance (see file header) for the yielded term and
  * writes it through `matchCtx` (typed `int *`). Mechanics:
  *
- *   - The DFAFilter keeps a `distStack` parallel to its DFA state stack,
- *     each entry holding the running minimum of accept-state costs along
- *     the current DFA path. Both stacks pop in sync on backtrack
- *     (`StackPop`).
+ *   - Each frame of the DFAFilter stack holds, next to its DFA state, the
+ *     running minimum of accept-state costs along the current DFA path.
+ *     Frames pop on backtrack (`StackPop`).
  *   - On each rune step that reaches an accept state, *matchCtx is set to
  *     `MIN(state->distance, running_min_so_far)`.
  *   - In prefix mode, once a prefix has accepted, the filter pushes NULL
- *     state-stack frames for the remaining runes; distStack carries the
+ *     state frames for the remaining runes, which carry the
  *     running minimum forward unchanged, so *matchCtx at yield time
  *     reflects the cost at the accept boundary.
  *
@@ -68,8 +68,11 @@ do {                                                      \
   }                                                       \
 } while(0)
 
+/* Node layout: the header, the node's runes, the first rune of each child, then
+ * the child pointers. Nothing is stored past the last rune of a leaf, so only the
+ * nodes with children pay for the padding that aligns the pointer array. */
 static inline size_t __trieNode_ChildKeyOffset(const TrieNode *n, t_len c) {
-  return sizeof(TrieNode) + ((size_t)n->len + 1 + c) * sizeof(rune);
+  return sizeof(TrieNode) + ((size_t)n->len + c) * sizeof(rune);
 }
 
 static inline size_t __trieNode_AlignUp(size_t value, size_t alignment) {
@@ -78,8 +81,8 @@ static inline size_t __trieNode_AlignUp(size_t value, size_t alignment) {
 }
 
 static inline size_t __trieNode_ChildrenOffset(t_len numChildren, t_len slen) {
-  size_t childKeysEnd = sizeof(TrieNode) + ((size_t)slen + 1 + numChildren) * sizeof(rune);
-  return __trieNode_AlignUp(childKeysEnd, _Alignof(TrieNode *));
+  size_t childKeysEnd = sizeof(TrieNode) + ((size_t)slen + numChildren) * sizeof(rune);
+  return numChildren ? __trieNode_AlignUp(childKeysEnd, _Alignof(TrieNode *)) : childKeysEnd;
 }
 
 static inline const void *__trieNode_ChildKey(const TrieNode *n, t_len c) {
@@ -106,8 +109,8 @@ static inline void __trieNode_StoreChildKey(TrieNode *n, t_len c, rune key) {
  * children */
 size_t __trieNode_Sizeof(t_len numChildren, t_len slen) {
   // Calculate:
-  // sizeof(TrieNode) + sizeof(rune) * (slen + 1) + numChildren * sizeof(rune)
-  // + padding to align the child-pointer array
+  // sizeof(TrieNode) + sizeof(rune) * slen + numChildren * sizeof(rune)
+  // + padding to align the child-pointer array, if numChildren > 0
   // + numChildren * sizeof(TrieNode *)
   //
   // Overflow analysis:
@@ -1046,8 +1049,8 @@ static void containsIterate(const TrieNode *n, t_len localOffset, t_len globalOf
     r->buf = array_ensure_append(r->buf, &n->str[localOffset], 1, rune);
   }
 
-  // next char matches
-  if (n->str[localOffset] == r->origStr[globalOffset]) {
+  // next char matches. The root has no string to compare
+  if (localOffset < n->len && n->str[localOffset] == r->origStr[globalOffset]) {
     /* full match found */
     if (globalOffset + 1 == r->lenOrigStr) {
       if (r->prefix) { // contains mode
@@ -7,266 +7,235 @@
  * GNU Affero General Public License v3 (AGPLv3).
 */
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
-#include <float.h>
-#include <stdio.h>
 
 #include "quantile.h"
 #include "rmalloc.h"
 #include "rmutil/rm_assert.h"
-
-typedef struct Sample {
-  // Variables are named per the paper
-  double v;  // Value represented
-  float g;   // Number of ranks
-  float d;   // Delta between ranks
-
-  struct Sample *prev;
-  struct Sample *next;
-} Sample;
-
+#include "util/arr/arr.h"
+
+// Capacity of a level relative to the one above it
+#define QS_LEVEL_RATIO (2.0 / 3.0)
+#define QS_MIN_LEVEL_CAPACITY 2
+#define QS_MAX_LEVELS 64
+
+/**
+ * The values are stored in levels, the values of level h standing for 2^h values each. New values
+ * go to the first level. A level over its capacity is compacted: it is sorted, and every other
+ * value is moved to the level above, which preserves the total weight. The top level has a
+ * capacity of `resolution`, and each level below has a fraction of the capacity of the one above.
+ */
 struct QuantStream {
-  double *buffer;
-  size_t bufferLength;
-  size_t bufferCap;
-
-  Sample *firstSample;
-  Sample *lastSample;
-  size_t n;              // Total number of values
-  size_t samplesLength;  // Number of samples currently in list
-
-  double *quantiles;
-  size_t numQuantiles;
-  Sample *pool;
+  arrayof(double) *levels;
+  size_t resolution;
+  size_t n;               // Total number of values
+  size_t firstCapacity;   // Capacity of the first level
+  uint64_t coins;         // Bit h: which half of level h the next compaction keeps
 };
 
-#define QUANT_EPSILON 0.01
+/** Serialized sketch format, followed by every level as its length and its values */
+typedef struct __attribute__((packed)) {
+  uint32_t flags;  // Currently unused
+  uint32_t numLevels;
+  uint64_t n;
+} QSSerializedHeader;
 
 static int dblCmp(const void *a, const void *b) {
   double da = *(const double *)a, db = *(const double *)b;
   return da < db ? -1 : da > db ? 1 : 0;
 }
 
-static double getMaxValUnknown(double r, double n) {
-  return QUANT_EPSILON * 2.0 * r;
-}
-
-static double getMaxValFromQuantiles(double r, double n, const double *quantiles,
-                                     size_t numQuantiles) {
-  double m = DBL_MAX;
-  double f;
-  for (size_t ii = 0; ii < numQuantiles; ++ii) {
-    double q = quantiles[ii];
-    if (q * n <= r) {
-      f = (2 * QUANT_EPSILON * r) / q;
-    } else {
-      f = (2 * QUANT_EPSILON * (n - r)) / (1.0 - q);
-    }
-    if (f < m) {
-      m = f;
-    }
-  }
-  return m;
+static size_t levelCapacity(const QuantStream *qs, size_t level) {
+  size_t depth = array_len(qs->levels) - 1 - level;
+  size_t cap = (size_t)ceil(qs->resolution * pow(QS_LEVEL_RATIO, depth));
+  return cap < QS_MIN_LEVEL_CAPACITY ? QS_MIN_LEVEL_CAPACITY : cap;
 }
 
-#define INSERT_BEFORE 0
-#define INSERT_AFTER 1
-static void QS_InsertSampleAt(QuantStream *stream, Sample *pos, Sample *sample) {
-  RS_ASSERT(pos);
-
-  sample->next = pos;
-  if (pos->prev) {
-    pos->prev->next = sample;
-    sample->prev = pos->prev;
-  } else {
-    // At head of the list
-    stream->firstSample = sample;
-  }
-
-  pos->prev = sample;
-  stream->samplesLength++;
+static void addLevel(QuantStream *qs) {
+  array_append(qs->levels, array_new(double, QS_MIN_LEVEL_CAPACITY));
 }
 
-static void QS_AppendSample(QuantStream *stream, Sample *sample) {
-  RS_ASSERT(sample->prev == NULL && sample->next == NULL);
-  if (stream->lastSample == NULL) {
-    RS_ASSERT(stream->samplesLength == 0);
-    stream->lastSample = stream->firstSample = sample;
-  } else {
-    sample->prev = stream->lastSample;
-    stream->lastSample->next = sample;
-    stream->lastSample = sample;
-    RS_ASSERT(stream->samplesLength > 0);
-  }
-
-  stream->samplesLength++;
-}
+static void compactLevel(QuantStream *qs, size_t level) {
+  double *values = qs->levels[level];
+  size_t len = array_len(values);
+  qsort(values, len, sizeof(*values), dblCmp);
 
-static void QS_RemoveSample(QuantStream *stream, Sample *sample) {
-  if (sample->prev) {
-    sample->prev->next = sample->next;
-  }
-  if (sample->next) {
-    sample->next->prev = sample->prev;
-  }
-  if (sample == stream->lastSample) {
-    stream->lastSample = sample->prev;
+  // Alternating the kept half, rather than picking it at random, keeps the results reproducible
+  size_t offset = (qs->coins >> level) & 1;
+  qs->coins ^= (uint64_t)1 << level;
+  // An odd value out stays, so that the compacted values weigh exactly as much as the kept ones
+  size_t odd = len % 2;
+  for (size_t ii = offset; ii < len - odd; ii += 2) {
+    array_append(qs->levels[level + 1], values[ii]);
   }
-  if (sample == stream->firstSample) {
-    stream->firstSample = sample->next;
+  if (odd) {
+    values[0] = values[len - 1];
   }
-
-  // Insert into pool
-  sample->next = stream->pool;
-  stream->pool = sample;
-  stream->samplesLength--;
+  array_trimm(values, odd);
 }
 
-static Sample *QS_NewSample(QuantStream *stream) {
-  if (stream->pool) {
-    Sample *ret = stream->pool;
-    stream->pool = ret->next;
-    memset(ret, 0, sizeof(*ret));
-    return ret;
-  } else {
-    return rm_calloc(1, sizeof(Sample));
+/* Compact the levels over their capacity, from the first one up */
+static void compress(QuantStream *qs) {
+  for (size_t level = 0; level < array_len(qs->levels); ++level) {
+    if (array_len(qs->levels[level]) < levelCapacity(qs, level)) {
+      continue;
+    }
+    if (level + 1 == array_len(qs->levels)) {
+      if (array_len(qs->levels) == QS_MAX_LEVELS) {
+        break;
+      }
+      addLevel(qs);
+    }
+    compactLevel(qs, level);
   }
+  qs->firstCapacity = levelCapacity(qs, 0);
 }
 
-static double QS_GetMaxVal(const QuantStream *stream, double r) {
-  if (stream->numQuantiles) {
-    return getMaxValFromQuantiles(r, stream->n, stream->quantiles, stream->numQuantiles);
-  } else {
-    return getMaxValUnknown(r, stream->n);
+void QS_Insert(QuantStream *qs, double val) {
+  array_append(qs->levels[0], val);
+  qs->n++;
+  if (array_len(qs->levels[0]) >= qs->firstCapacity) {
+    compress(qs);
   }
 }
 
-// Clear the buffer from pending samples
-static void QS_Flush(QuantStream *stream) {
-  qsort(stream->buffer, stream->bufferLength, sizeof(*stream->buffer), dblCmp);
-  double r = 0;
-
-  // Both the buffer and the samples are ordered. We use the first sample, and
-  // insert
-  Sample *pos = stream->firstSample;
-
-  for (size_t ii = 0; ii < stream->bufferLength; ++ii) {
-    double curBuf = stream->buffer[ii];
-    int inserted = 0;
-    Sample *newSample = QS_NewSample(stream);
-    newSample->v = curBuf;
-    newSample->g = 1;
+typedef struct {
+  double v;
+  uint64_t weight;
+} WeightedValue;
 
-    while (pos) {
-
-      if (pos->v > curBuf) {
-        newSample->d = floor(QS_GetMaxVal(stream, r)) - 1;
-        QS_InsertSampleAt(stream, pos, newSample);
-        inserted = 1;
-        break;
-      }
-      r += pos->g;
-      pos = pos->next;
-    }
-
-    if (!inserted) {
-      RS_ASSERT(pos == NULL);
-      newSample->d = 0;
-      QS_AppendSample(stream, newSample);
-    }
+static int weightedCmp(const void *a, const void *b) {
+  return dblCmp(&((const WeightedValue *)a)->v, &((const WeightedValue *)b)->v);
+}
 
-    stream->n++;
+double QS_Query(QuantStream *qs, double q) {
+  if (!qs->n) {
+    return NAN;
   }
+  // The value of rank ceil(q * n) in the sorted values
+  double rank = ceil(q * qs->n);
+  uint64_t target = rank < 1 ? 1 : rank > qs->n ? qs->n : (uint64_t)rank;
 
-  // Clear the buffer
-  stream->bufferLength = 0;
-}
-
-static void QS_Compress(QuantStream *stream) {
-  if (stream->samplesLength < 2) {
-    return;
+  if (array_len(qs->levels) == 1) {
+    // All the values are there
+    double *values = qs->levels[0];
+    qsort(values, array_len(values), sizeof(*values), dblCmp);
+    return values[target - 1];
   }
 
-  Sample *cur = stream->lastSample->prev;
-  double r = stream->n - 1 - stream->lastSample->g;
+  size_t total = 0;
+  for (size_t level = 0; level < array_len(qs->levels); ++level) {
+    total += array_len(qs->levels[level]);
+  }
+  WeightedValue *items = rm_malloc(total * sizeof(*items));
+  size_t nitems = 0;
+  for (size_t level = 0; level < array_len(qs->levels); ++level) {
+    for (size_t ii = 0; ii < array_len(qs->levels[level]); ++ii) {
+      items[nitems++] = (WeightedValue){.v = qs->levels[level][ii], .weight = (uint64_t)1 << level};
+    }
+  }
+  qsort(items, nitems, sizeof(*items), weightedCmp);
 
-  while (cur) {
-    Sample *nextCur = cur->prev;
-    Sample *parent = cur->next;
-    double gCur = cur->g;
-    if (cur->g + parent->g + parent->d <= QS_GetMaxVal(stream, r)) {
-      parent->g += gCur;
-      QS_RemoveSample(stream, cur);
+  double ret = items[nitems - 1].v;
+  uint64_t cumulated = 0;
+  for (size_t ii = 0; ii < nitems; ++ii) {
+    cumulated += items[ii].weight;
+    if (cumulated >= target) {
+      ret = items[ii].v;
+      break;
     }
-    r -= gCur;
-    cur = nextCur;
   }
+  rm_free(items);
+  return ret;
 }
 
-void QS_Insert(QuantStream *stream, double val) {
-  RS_ASSERT(stream->bufferLength != stream->bufferCap);
-  stream->buffer[stream->bufferLength] = val;
-  if (++stream->bufferLength == stream->bufferCap) {
-    QS_Flush(stream);
-    QS_Compress(stream);
-  }
+char *QS_Serialize(const QuantStream *qs, size_t *len) {
+  size_t numLevels = array_len(qs->levels);
+  size_t sz = sizeof(QSSerializedHeader);
+  for (size_t level = 0; level < numLevels; ++level) {
+    sz += sizeof(uint32_t) + array_len(qs->levels[level]) * sizeof(double);
+  }
+
+  char *buf = rm_malloc(sz + 1);
+  buf[sz] = 0;  // Null termination
+  QSSerializedHeader hdr = {.flags = 0, .numLevels = numLevels, .n = qs->n};
+  memcpy(buf, &hdr, sizeof(hdr));
+  char *pos = buf + sizeof(hdr);
+  for (size_t level = 0; level < numLevels; ++level) {
+    uint32_t levelLen = array_len(qs->levels[level]);
+    memcpy(pos, &levelLen, sizeof(levelLen));
+    pos += sizeof(levelLen);
+    memcpy(pos, qs->levels[level], levelLen * sizeof(double));
+    pos += levelLen * sizeof(double);
+  }
+  *len = sz;
+  return buf;
 }
 
-double QS_Query(QuantStream *stream, double q) {
-  if (stream->bufferLength) {
-    QS_Flush(stream);
+int QS_MergeSerialized(QuantStream *qs, const char *buf, size_t len) {
+  QSSerializedHeader hdr;
+  if (len < sizeof(hdr)) {
+    return 0;
+  }
+  memcpy(&hdr, buf, sizeof(hdr));
+  if (hdr.numLevels > QS_MAX_LEVELS) {
+    return 0;
   }
 
-  double t = ceil(q * stream->n);
-  t += floor(QS_GetMaxVal(stream, t) / 2.0);
-  const Sample *prev = stream->firstSample;
-  double r = 0;
-
-  if (!prev) {
-    return NAN;
+  // Validate the levels before changing anything: their weights must add up to the count
+  const char *levelsStart = buf + sizeof(hdr), *end = buf + len, *pos = levelsStart;
+  uint64_t weight = 0;
+  for (uint32_t level = 0; level < hdr.numLevels; ++level) {
+    uint32_t levelLen;
+    if (end - pos < sizeof(levelLen)) {
+      return 0;
+    }
+    memcpy(&levelLen, pos, sizeof(levelLen));
+    pos += sizeof(levelLen);
+    if ((size_t)(end - pos) / sizeof(double) < levelLen) {
+      return 0;
+    }
+    pos += levelLen * sizeof(double);
+    weight += (uint64_t)levelLen << level;
+  }
+  if (pos != end || weight != hdr.n) {
+    return 0;
   }
 
-  for (const Sample *cur = prev->next; cur; cur = cur->next) {
-    if (r + cur->g + cur->d >= t) {
-      break;
+  pos = levelsStart;
+  for (uint32_t level = 0; level < hdr.numLevels; ++level) {
+    uint32_t levelLen;
+    memcpy(&levelLen, pos, sizeof(levelLen));
+    pos += sizeof(levelLen);
+    while (array_len(qs->levels) <= level) {
+      addLevel(qs);
+    }
+    for (uint32_t ii = 0; ii < levelLen; ++ii) {
+      double d;
+      memcpy(&d, pos, sizeof(d));
+      array_append(qs->levels[level], d);
+      pos += sizeof(d);
     }
-    r += cur->g;
-    prev = cur;
   }
-  return prev->v;
+  qs->n += hdr.n;
+  compress(qs);
+  return 1;
 }
 
-QuantStream *NewQuantileStream(const double *quantiles, size_t numQuantiles, size_t bufferLength) {
+QuantStream *NewQuantileStream(size_t resolution) {
+  RS_ASSERT(resolution > 0);
   QuantStream *ret = rm_calloc(1, sizeof(QuantStream));
-  if ((ret->numQuantiles = numQuantiles)) {
-    ret->quantiles = rm_calloc(numQuantiles, sizeof(*quantiles));
-    memcpy(ret->quantiles, quantiles, sizeof(*quantiles) * numQuantiles);
-  }
-  ret->bufferCap = bufferLength;
-  ret->buffer = rm_malloc(bufferLength * sizeof(*ret->buffer));
+  ret->resolution = resolution;
+  ret->levels = array_new(double *, 1);
+  addLevel(ret);
+  ret->firstCapacity = levelCapacity(ret, 0);
   return ret;
 }
 
 void QS_Free(QuantStream *qs) {
-  rm_free(qs->quantiles);
-  rm_free(qs->buffer);
-
-  // Chain freeing the pools!
-
-  Sample *cur = qs->firstSample;
-  while (cur) {
-    Sample *next = cur->next;
-    rm_free(cur);
-    cur = next;
-  }
-
-  cur = qs->pool;
-  while (cur) {
-    Sample *next = cur->next;
-    rm_free(cur);
-    cur = next;
-  }
+  array_free_ex(qs->levels, array_free(*(double **)ptr));
   rm_free(qs);
 }
 
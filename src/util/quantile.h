@@ -12,12 +12,29 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+/**
+ * A mergeable quantile sketch (KLL). The values are kept exactly until there are more than
+ * `resolution` of them. From then on, the sketch keeps about 3 * resolution values, and the rank
+ * of the value returned for a quantile is within about 2 * n / resolution of the exact one.
+ */
 typedef struct QuantStream QuantStream;
 
-QuantStream *NewQuantileStream(const double *quantiles, size_t numQuantiles, size_t bufferLength);
+QuantStream *NewQuantileStream(size_t resolution);
 void QS_Insert(QuantStream *qs, double val);
 double QS_Query(QuantStream *qs, double val);
 void QS_Free(QuantStream *qs);
 size_t QS_GetCount(const QuantStream *stream);
 
+/**
+ * Serialize the sketch, to be merged into another one with QS_MergeSerialized. Returns a buffer
+ * allocated with rm_malloc, whose length is stored in `len`.
+ */
+char *QS_Serialize(const QuantStream *qs, size_t *len);
+
+/**
+ * Add the values of a serialized sketch to `qs`. Returns 0 if `buf` is not a valid serialized
+ * sketch, in which case `qs` is unchanged.
+ */
+int QS_MergeSerialized(QuantStream *qs, const char *buf, size_t len);
+
 #endif
@@ -52,6 +52,9 @@ private:
       base.SkipTo = MockIterator_SkipTo;
       base.Rewind = MockIterator_Rewind;
       base.Revalidate = MockIterator_Revalidate;
+      base.DocIdsBlock = nullptr;
+      base.ReadBatch = nullptr;
+      base.DocIdsWords = nullptr;
 
       std::sort(docIds.begin(), docIds.end());
       auto new_end = std::unique(docIds.begin(), docIds.end());
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+#include "benchmark/benchmark.h"
+#include "redismock/util.h"
+#include "aggregate/expr/expression.h"
+#include "aggregate/expr/exprast.h"
+#include "aggregate/functions/function.h"
+#include "rlookup_ffi.h"
+#include "value_ffi.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Per-row evaluation of APPLY/FILTER expressions over numeric properties, as done by the
+// evaluator result processor, with and without ExprAST_Compile.
+
+namespace {
+
+constexpr size_t kNumRows = 4096;
+
+const char *kExprs[] = {
+  "@foo * (60 * 60 * 24) + @bar / 2",
+  "@foo > 500 && @bar <= 250 || !@foo",
+  "floor(sqrt(@foo) * log(@bar + 1)) + hour(@foo * 3600)",
+};
+
+void RunExpr(benchmark::State &state, bool compile) {
+  RMCK::init();
+  static bool registered = false;
+  if (!registered) {
+    RegisterAllFunctions();
+    registered = true;
+  }
+
+  const char *exprstr = kExprs[state.range(0)];
+  QueryError status = QueryError_Default();
+  HiddenString *hidden = NewHiddenString(exprstr, strlen(exprstr), false);
+  RSExpr *root = ExprAST_Parse(hidden, &status);
+  HiddenString_Free(hidden, false);
+
+  RLookup lk = RLookup_New();
+  RLookupKey *kfoo = RLookup_GetKey_Write(&lk, "foo", RLOOKUP_F_NOFLAGS);
+  RLookupKey *kbar = RLookup_GetKey_Write(&lk, "bar", RLOOKUP_F_NOFLAGS);
+  ExprAST_GetLookupKeys(root, &lk, &status);
+  if (compile) {
+    ExprAST_Compile(root);
+  }
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(0, 1000);
+  std::vector<RLookupRow> rows(kNumRows);
+  for (auto &row : rows) {
+    row = RLookupRow_New();
+    RLookup_WriteOwnKey(kfoo, &row, RSValue_NewNumber(dist(rng)));
+    RLookup_WriteOwnKey(kbar, &row, RSValue_NewNumber(dist(rng)));
+  }
+
+  ExprEval eval = {0};
+  eval.err = &status;
+  eval.lookup = &lk;
+  eval.root = root;
+  RSValue *res = RSValue_NewUndefined();
+  for (auto _ : state) {
+    for (auto &row : rows) {
+      eval.srcrow = &row;
+      ExprEval_Eval(&eval, res);
+      benchmark::DoNotOptimize(res);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kNumRows);
+
+  RSValue_DecrRef(res);
+  for (auto &row : rows) {
+    RLookupRow_Reset(&row);
+  }
+  RLookup_Cleanup(&lk);
+  ExprAST_Free(root);
+  QueryError_ClearError(&status);
+}
+
+void BM_Expr_Interpreted(benchmark::State &state) { RunExpr(state, false); }
+void BM_Expr_Compiled(benchmark::State &state) { RunExpr(state, true); }
+
+}  // namespace
+
+BENCHMARK(BM_Expr_Interpreted)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Expr_Compiled)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+#include "benchmark/benchmark.h"
+#include "redismock/util.h"
+#include "tokenize.h"
+#include "stopwords.h"
+#include "rmalloc.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Text corpora for the simple tokenizer benchmark.
+//
+// Wikipedia-like documents are mostly mixed-case ASCII words separated by
+// spaces and punctuation. We synthesize equivalents here (deterministic PRNG):
+//   - ascii:   mixed-case ASCII words, separated by spaces and some punctuation
+//   - escaped: like ascii, with backslash-escaped separators inside some words
+//   - mixed:   like ascii, with one Latin-1 accented codepoint in some words
+//
+// The bench measures the cost of tokenizing a document, which covers the
+// separator scan and the normalization of each token. The text is re-copied
+// each iteration since the tokenizer normalizes it in place.
+
+namespace {
+
+constexpr size_t kNumWords = 8192;
+
+enum class Corpus { kAscii, kEscaped, kMixed };
+
+std::string MakeCorpus(Corpus c, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> len_dist(2, 12);
+  std::uniform_int_distribution<int> case_dist(0, 3);
+  std::uniform_int_distribution<int> letter_dist(0, 25);
+  std::uniform_int_distribution<int> pct_dist(0, 99);
+  static const char kPunct[] = ",.;:()-";
+  std::string out;
+  for (size_t i = 0; i < kNumWords; ++i) {
+    int n = len_dist(rng);
+    bool special = pct_dist(rng) < 10;
+    int special_pos = std::uniform_int_distribution<int>(0, n - 1)(rng);
+    for (int j = 0; j < n; ++j) {
+      if (special && j == special_pos && c == Corpus::kEscaped) {
+        out += "\\-";
+      } else if (special && j == special_pos && c == Corpus::kMixed) {
+        // U+00C9 É
+        out += "\xC3\x89";
+      } else {
+        out.push_back((case_dist(rng) ? 'a' : 'A') + letter_dist(rng));
+      }
+    }
+    if (pct_dist(rng) < 15) {
+      out.push_back(kPunct[pct_dist(rng) % (sizeof(kPunct) - 1)]);
+    }
+    out.push_back(' ');
+  }
+  return out;
+}
+
+const std::string& GetCorpus(Corpus c) {
+  static const std::string ascii = MakeCorpus(Corpus::kAscii, 0xA5C11A11);
+  static const std::string escaped = MakeCorpus(Corpus::kEscaped, 0xE5CA9ED1);
+  static const std::string mixed = MakeCorpus(Corpus::kMixed, 0x111E4ED1);
+  switch (c) {
+    case Corpus::kAscii: return ascii;
+    case Corpus::kEscaped: return escaped;
+    case Corpus::kMixed: return mixed;
+  }
+  return ascii;
+}
+
+void RunCorpus(benchmark::State& state, Corpus c) {
+  RMCK::init();
+  const std::string& text = GetCorpus(c);
+  std::vector<char> buf(text.size() + 1);
+  RSTokenizer *tk = GetSimpleTokenizer(NULL, DefaultStopWordList());
+  size_t numTokens = 0;
+
+  for (auto _ : state) {
+    std::memcpy(buf.data(), text.c_str(), text.size() + 1);
+    tk->Start(tk, buf.data(), text.size(), TOKENIZE_DEFAULT_OPTIONS | TOKENIZE_NOSTEM);
+    Token tok = {0};
+    numTokens = 0;
+    while (tk->Next(tk, &tok)) {
+      benchmark::DoNotOptimize(tok.tok);
+      if (tok.allocatedTok) {
+        rm_free(tok.allocatedTok);
+        tok.allocatedTok = NULL;
+      }
+      ++numTokens;
+    }
+  }
+  Tokenizer_Release(tk);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * text.size());
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * numTokens);
+}
+
+void BM_SimpleTokenizer_Ascii(benchmark::State& state) { RunCorpus(state, Corpus::kAscii); }
+void BM_SimpleTokenizer_Escaped(benchmark::State& state) { RunCorpus(state, Corpus::kEscaped); }
+void BM_SimpleTokenizer_Mixed(benchmark::State& state) { RunCorpus(state, Corpus::kMixed); }
+
+}  // namespace
+
+BENCHMARK(BM_SimpleTokenizer_Ascii)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SimpleTokenizer_Escaped)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SimpleTokenizer_Mixed)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -412,6 +412,84 @@ TEST_F(ExprTest, testPropertyFetch) {
   RLookup_Cleanup(&lk);
 }
 
+TEST_F(ExprTest, testCompile) {
+  // Numeric sub-expressions without properties are folded
+  TEvalCtx folded("sqrt(16) + !9");
+  ASSERT_TRUE(folded) << folded.error();
+  ExprAST_Compile((RSExpr *)folded.root);
+  ASSERT_EQ(RSExpr_Literal, folded.root->t);
+  ASSERT_EQ("4", folded.dump(false));
+
+  TEvalCtx partial("@foo * (2 + sqrt(16))");
+  ASSERT_TRUE(partial) << partial.error();
+  ExprAST_Compile((RSExpr *)partial.root);
+  ASSERT_EQ(RSExpr_Op, partial.root->t);
+  ASSERT_EQ(RSExpr_Property, partial.root->op.left->t);
+  ASSERT_EQ(RSExpr_Literal, partial.root->op.right->t);
+
+  // A function without a number for its argument is left to the evaluation
+  TEvalCtx invalid("hour(0 - 5)");
+  ASSERT_TRUE(invalid) << invalid.error();
+  ExprAST_Compile((RSExpr *)invalid.root);
+  ASSERT_EQ(RSExpr_Function, invalid.root->t);
+  ASSERT_EQ(EXPR_EVAL_OK, invalid.eval());
+  ASSERT_EQ(RSValueType_Null, RSValue_Type(RSValue_Dereference(invalid.result())));
+
+  // Compiled expressions evaluate as the generic ones, whatever the values of the properties
+  RLookup lk = RLookup_New();
+  RLookupKey *kfoo = RLookup_GetKey_Write(&lk, "foo", RLOOKUP_F_NOFLAGS);
+  RLookupKey *kbar = RLookup_GetKey_Write(&lk, "bar", RLOOKUP_F_NOFLAGS);
+  const char *exprs[] = {
+    "@foo * (60 * 60) + sqrt(16)",
+    "@foo / @bar - 2 ^ 3 % 5",
+    "@foo > 2 && (@bar <= 10 || !@foo)",
+    "@foo == @bar",
+    "abs(@foo - @bar) + hour(@foo)",
+  };
+  std::vector<std::pair<RSValue *, RSValue *>> rows = {
+    {RSValue_NewNumber(3), RSValue_NewNumber(10)},
+    {RSValue_NewNumber(0), RSValue_NewNumber(-4.5)},
+    {RSValue_NewNumber(-7200), RSValue_NewNumber(0)},
+    {RSValue_NewNumber(7), RSValue_NewCopiedString("10", 2)},
+    {RSValue_NewNumber(NAN), RSValue_NewNumber(1)},
+    {RSValue_NewNumber(5), NULL},
+  };
+  for (auto expr : exprs) {
+    TEvalCtx generic(expr), compiled(expr);
+    generic.lookup = compiled.lookup = &lk;
+    ASSERT_EQ(EXPR_EVAL_OK, generic.bindLookupKeys()) << expr;
+    ASSERT_EQ(EXPR_EVAL_OK, compiled.bindLookupKeys()) << expr;
+    ExprAST_Compile((RSExpr *)compiled.root);
+
+    for (auto [foo, bar] : rows) {
+      RLookupRow rr = RLookupRow_New();
+      RLookup_WriteKey(kfoo, &rr, foo);
+      if (bar) {
+        RLookup_WriteKey(kbar, &rr, bar);
+      }
+      generic.srcrow = compiled.srcrow = &rr;
+      int rc = generic.eval();
+      ASSERT_EQ(rc, compiled.eval()) << expr;
+      if (rc == EXPR_EVAL_OK) {
+        RSValue *expected = RSValue_Dereference(generic.result());
+        RSValue *actual = RSValue_Dereference(compiled.result());
+        ASSERT_EQ(RSValue_Type(expected), RSValue_Type(actual)) << expr;
+        if (RSValue_IsNumber(expected) && !std::isnan(RSValue_Number_Get(expected))) {
+          ASSERT_DOUBLE_EQ(RSValue_Number_Get(expected), RSValue_Number_Get(actual)) << expr;
+        }
+      }
+      RLookupRow_Reset(&rr);
+    }
+  }
+  for (auto [foo, bar] : rows) {
+    RSValue_DecrRef(foo);
+    if (bar) {
+      RSValue_DecrRef(bar);
+    }
+  }
+  RLookup_Cleanup(&lk);
+}
+
 // Macro for testing expression evaluation with expected numeric result
 #define ASSERT_EXPR_EVAL_NUMBER(ctx_var, expected_value)    \
   {                                                         \
@@ -1311,6 +1311,48 @@ TEST_F(IndexTest, testDocTable) {
   DocTable_Free(&dt);
 }
 
+TEST_F(IndexTest, testDocTableColumns) {
+  char buf[16];
+  DocTable dt = NewDocTable(10, 10);
+  struct timespec now = {1000, 0};
+  struct timespec later = {1001, 0};
+  // Spans a few pages of the columns
+  const int N = 3 * DOCTABLE_COLUMNS_PAGE_SIZE;
+  for (int i = 0; i < N; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+    DMD_Return(DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash));
+  }
+  ASSERT_FALSE(DocTable_IsLive(&dt, 0, &now));
+  ASSERT_TRUE(DocTable_IsLive(&dt, 1, &now));
+  ASSERT_TRUE(DocTable_IsLive(&dt, N, &now));
+  ASSERT_FALSE(DocTable_IsLive(&dt, N + 1, &now));
+  ASSERT_FALSE(DocTable_Exists(&dt, 100 * N));
+
+  // Expiration
+  RSDocumentMetadata *dmd = (RSDocumentMetadata *)DocTable_Borrow(&dt, 2);
+  DocTable_SetDocExpiration(&dt, dmd, later);
+  ASSERT_TRUE(DocTable_IsLive(&dt, 2, &now));
+  DocTable_SetDocExpiration(&dt, dmd, now);
+  ASSERT_FALSE(DocTable_IsLive(&dt, 2, &now));
+  ASSERT_TRUE(DocTable_Exists(&dt, 2));
+  DMD_Return(dmd);
+  DocTable_ClearExpirationData(&dt);
+  ASSERT_TRUE(DocTable_IsLive(&dt, 2, &now));
+
+  // Deleting every document of the second page releases it
+  const size_t memsize = dt.columns.memsize;
+  for (int i = DOCTABLE_COLUMNS_PAGE_SIZE - 1; i < 2 * DOCTABLE_COLUMNS_PAGE_SIZE - 1; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+    DMD_Return(DocTable_Pop(&dt, buf, nkey));
+    ASSERT_FALSE(DocTable_IsLive(&dt, i + 1, &now));
+    ASSERT_FALSE(DocTable_Exists(&dt, i + 1));
+  }
+  ASSERT_EQ(memsize - sizeof(DocTableColumnsPage), dt.columns.memsize);
+  ASSERT_TRUE(DocTable_IsLive(&dt, DOCTABLE_COLUMNS_PAGE_SIZE - 1, &now));
+  ASSERT_TRUE(DocTable_IsLive(&dt, 2 * DOCTABLE_COLUMNS_PAGE_SIZE, &now));
+  DocTable_Free(&dt);
+}
+
 TEST_F(IndexTest, testVarintFieldMask) {
   t_fieldMask x = 127;
   size_t expected[] = {0, 2, 1, 1, 2, 0, 2, 0, 2, 3, 0, 0, 3, 0, 0, 4};
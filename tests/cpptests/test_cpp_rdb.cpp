@@ -18,6 +18,7 @@
 extern "C" {
 #include "spec.h"
 #include "indexes.h"
+#include "index_snapshot.h"
 #include "query_error_ffi.h"
 #include "rules.h"
 #include "stopwords.h"
@@ -340,6 +341,7 @@ TEST_F(RdbMockTest, testDuplicateIndexRdbLoad) {
     // Then write the index 30 times
     for (int i = 0; i < 30; i++) {
         IndexSpec_RdbSave(io, spec, 0);
+        IndexSnapshot_RdbSave(io, spec, 0);
     }
     EXPECT_EQ(0, RMCK_IsIOError(io));
 
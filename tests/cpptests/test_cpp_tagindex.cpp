@@ -362,3 +362,31 @@ TEST_F(TagIndexTest, testCommitAndOverheadWithSuffix) {
   emptyFs.tagOpts.tagIndex = NULL;
   ASSERT_EQ(TagIndex_GetOverhead(&emptyFs), 0u);
 }
+
+TEST_F(TagIndexTest, testPreprocessInArena) {
+  BlkAlloc arena;
+  BlkAlloc_Init(&arena);
+  FieldSpec fs = makeTagFieldSpec(',', (TagFieldFlags)0, (FieldSpecOptions)0);
+  DocumentField df{};
+  df.unionType = FLD_VAR_T_ARRAY;
+  // 'Ⱥ' lower-cases to the longer 'ⱥ', which unicode_tolower allocates
+  std::string longTag(3000, 'X');
+  const char *vals[] = {"Red,GREEN", "\xc8\xba", longTag.c_str()};
+  df.multiVal = (char **)vals;
+  df.arrayLen = 3;
+  std::string longTagLower(3000, 'x');
+  const char *e[] = {"red", "green", "\xe2\xb1\xa5", longTagLower.c_str()};
+
+  // Recycling the arena gives the same tags
+  for (int round = 0; round < 2; round++) {
+    FieldIndexerData fdata{};
+    ASSERT_EQ(TagIndex_PreprocessInArena(&fs, &df, &fdata, &arena), 1);
+    ASSERT_EQ(array_len(fdata.tags), 4u);
+    for (size_t i = 0; i < 4; i++) {
+      EXPECT_STREQ(fdata.tags[i], e[i]);
+    }
+    array_free(fdata.tags);
+    BlkAlloc_Clear(&arena, NULL, NULL, 0);
+  }
+  BlkAlloc_FreeAll(&arena, NULL, NULL, 0);
+}
@@ -151,3 +151,29 @@ TEST_F(TokenizerTest, testEscapedSeparator) {
   free(txt);
   tk->Free(tk);
 }
+
+TEST_F(TokenizerTest, testLongTokens) {
+  // Tokens and separator runs longer than a vector, with escapes and non-ASCII
+  // characters at various offsets
+  auto tk = NewSimpleTokenizer(NULL, NULL, 0);
+  char *txt = strdup("SuperCaliFragilisticExpialiDocious ,,,,,,,,,,,,,,,,,,,,,,,,,, "
+                     "AbcdefghijklmnoP\\-QrstuvwxyZ0123456789 ÉcoleNormaleSupérieureDeParis_X "
+                     "end\\");
+  const char *expected[] = {"supercalifragilisticexpialidocious", "abcdefghijklmnop-qrstuvwxyz0123456789",
+                            "écolenormalesupérieuredeparis_x", "end"};
+  tk->Start(tk, txt, strlen(txt), 0);
+
+  Token tok = {0};
+  size_t i = 0;
+  while (tk->Next(tk, &tok)) {
+    ASSERT_LT(i, sizeof(expected) / sizeof(*expected));
+    std::string got(tok.tok, tok.tokLen);
+    ASSERT_STREQ(got.c_str(), expected[i]);
+    rm_free(tok.allocatedTok);
+    tok.allocatedTok = NULL;
+    i++;
+  }
+  ASSERT_EQ(i, sizeof(expected) / sizeof(*expected));
+  free(txt);
+  tk->Free(tk);
+}
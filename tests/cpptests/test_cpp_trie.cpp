@@ -15,6 +15,7 @@
 #include "redismock/redismock.h"
 #include "rmalloc.h"
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <functional>
@@ -89,7 +90,7 @@ static constexpr rune kPackedChildKeyPrefix = 0x41;
 static constexpr int kPackedChildKeyChildCount = 128;
 
 static uintptr_t trieNodeChildKeyAddress(const TrieNode *n) {
-  return reinterpret_cast<uintptr_t>(n) + sizeof(TrieNode) + (n->len + 1) * sizeof(rune);
+  return reinterpret_cast<uintptr_t>(n) + sizeof(TrieNode) + n->len * sizeof(rune);
 }
 
 static void buildPackedChildKeyScanTrie(Trie **tOut, TrieNode **prefixNodeOut) {
@@ -142,6 +143,42 @@ TEST_F(TrieTest, testDeleteScansPackedChildKeys) {
   TrieType_Free(t);
 }
 
+static std::vector<std::string> trieIterContains(Trie *t, const char *pattern, bool prefix,
+                                                  bool suffix) {
+  runeBuf buf;
+  size_t len = strlen(pattern);
+  rune *runes = runeBufFill(pattern, len, &buf, &len);
+
+  std::vector<std::string> terms;
+  Trie_IterateContains(t, runes, len, prefix, suffix, collectTermFunc, &terms, NULL, true);
+  runeBufFree(&buf);
+  std::sort(terms.begin(), terms.end());
+  return terms;
+}
+
+// Regression: the root has no string, so a single rune pattern must not be compared with the
+// storage right after it (the child keys)
+TEST_F(TrieTest, testContainsSingleRune) {
+  Trie *t = NewTrie(NULL, Trie_Sort_Lex);
+  EXPECT_TRUE(trieIterContains(t, "a", true, true).empty());
+  EXPECT_TRUE(trieIterContains(t, "a", false, true).empty());
+
+  for (const char *term : {"kiwi", "apple", "banana", "cherry"}) {
+    trieInsert(t, term);
+  }
+  using Terms = std::vector<std::string>;
+  EXPECT_EQ(trieIterContains(t, "a", true, true), Terms({"apple", "banana"}));
+  EXPECT_EQ(trieIterContains(t, "a", false, true), Terms({"banana"}));
+  EXPECT_EQ(trieIterContains(t, "b", true, true), Terms({"banana"}));
+  EXPECT_EQ(trieIterContains(t, "c", true, true), Terms({"cherry"}));
+  EXPECT_EQ(trieIterContains(t, "k", true, true), Terms({"kiwi"}));
+  EXPECT_TRUE(trieIterContains(t, "k", false, true).empty());
+  EXPECT_EQ(trieIterContains(t, "i", false, true), Terms({"kiwi"}));
+  EXPECT_TRUE(trieIterContains(t, "z", true, true).empty());
+
+  TrieType_Free(t);
+}
+
 /**
  * This test ensures that the stack isn't overflown from all the frames.
  * The maximum trie depth cannot be greater than the maximum length of the
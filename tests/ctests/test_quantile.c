@@ -10,20 +10,38 @@
 #include "util/quantile.h"
 #include "buffer/buffer.h"
 #include "rmutil/alloc.h"
+#include "rmalloc.h"
 #include "test_util.h"
 
 #include <stdint.h>
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 static FILE *fp;
 static Buffer buf;
 static double *input;
 static size_t numInput;
 
+static int dblCmp(const void *a, const void *b) {
+  double da = *(const double *)a, db = *(const double *)b;
+  return da < db ? -1 : da > db ? 1 : 0;
+}
+
+// Whether `val` is at rank `q` in the sorted input, within `eps`
+static int hasRank(const double *sorted, double val, double q, double eps) {
+  size_t lo = 0, hi;
+  while (lo < numInput && sorted[lo] < val) {
+    ++lo;
+  }
+  for (hi = lo; hi < numInput && sorted[hi] == val; ++hi) {
+  }
+  return (double)lo / numInput <= q + eps && (double)hi / numInput >= q - eps;
+}
+
 static int testBasic() {
-  double quantiles[] = {0.50, 0.90, 0.99};
-  QuantStream *stream = NewQuantileStream(quantiles, 3, 500);
+  QuantStream *stream = NewQuantileStream(500);
   for (size_t ii = 0; ii < numInput; ++ii) {
     QS_Insert(stream, input[ii]);
   }
@@ -38,6 +56,78 @@ static int testBasic() {
   return 0;
 }
 
+static int testExact() {
+  QuantStream *stream = NewQuantileStream(500);
+  for (int ii = 100; ii >= 0; --ii) {
+    QS_Insert(stream, ii);
+  }
+  ASSERT_EQUAL(101, QS_GetCount(stream));
+  ASSERT_EQUAL(0, QS_Query(stream, 0));
+  ASSERT_EQUAL(50, QS_Query(stream, 0.5));
+  ASSERT_EQUAL(95, QS_Query(stream, 0.95));
+  ASSERT_EQUAL(100, QS_Query(stream, 1));
+  QS_Free(stream);
+
+  stream = NewQuantileStream(500);
+  ASSERT(isnan(QS_Query(stream, 0.5)));
+  QS_Free(stream);
+  return 0;
+}
+
+static int testMerge() {
+  // Small sketches merge exactly
+  QuantStream *dst = NewQuantileStream(500);
+  for (int part = 0; part < 2; ++part) {
+    QuantStream *src = NewQuantileStream(500);
+    for (int ii = part; ii <= 100; ii += 2) {
+      QS_Insert(src, ii);
+    }
+    size_t len;
+    char *ser = QS_Serialize(src, &len);
+    ASSERT(QS_MergeSerialized(dst, ser, len));
+    rm_free(ser);
+    QS_Free(src);
+  }
+  ASSERT_EQUAL(101, QS_GetCount(dst));
+  ASSERT_EQUAL(50, QS_Query(dst, 0.5));
+  ASSERT_EQUAL(95, QS_Query(dst, 0.95));
+
+  // Invalid buffers are rejected
+  ASSERT(!QS_MergeSerialized(dst, "foo", 3));
+  size_t len;
+  char *ser = QS_Serialize(dst, &len);
+  ASSERT(!QS_MergeSerialized(dst, ser, len - 1));
+  rm_free(ser);
+  ASSERT_EQUAL(101, QS_GetCount(dst));
+  QS_Free(dst);
+
+  // Large sketches stay within the rank error
+  double *sorted = rm_malloc(numInput * sizeof(*sorted));
+  memcpy(sorted, input, numInput * sizeof(*sorted));
+  qsort(sorted, numInput, sizeof(*sorted), dblCmp);
+
+  dst = NewQuantileStream(500);
+  const size_t numParts = 4;
+  for (size_t part = 0; part < numParts; ++part) {
+    QuantStream *src = NewQuantileStream(500);
+    for (size_t ii = part; ii < numInput; ii += numParts) {
+      QS_Insert(src, input[ii]);
+    }
+    ser = QS_Serialize(src, &len);
+    ASSERT(QS_MergeSerialized(dst, ser, len));
+    rm_free(ser);
+    QS_Free(src);
+  }
+  ASSERT_EQUAL(numInput, QS_GetCount(dst));
+  double quantiles[] = {0.1, 0.5, 0.9, 0.99};
+  for (size_t ii = 0; ii < sizeof(quantiles) / sizeof(quantiles[0]); ++ii) {
+    ASSERT(hasRank(sorted, QS_Query(dst, quantiles[ii]), quantiles[ii], 0.02));
+  }
+  QS_Free(dst);
+  rm_free(sorted);
+  return 0;
+}
+
 TEST_MAIN({
   RMUTil_InitAlloc();
 
@@ -56,6 +146,8 @@ TEST_MAIN({
   input = (double *)buf.data;
 
   TESTFUNC(testBasic);
+  TESTFUNC(testExact);
+  TESTFUNC(testMerge);
 
   Buffer_Free(&buf);
 })
\ No newline at end of file
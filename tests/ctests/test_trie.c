@@ -42,7 +42,10 @@ static size_t alignUp(size_t value, size_t alignment) {
 }
 
 static size_t expectedTrieNodeSize(t_len numChildren, t_len slen) {
-  size_t childKeysEnd = sizeof(TrieNode) + ((size_t)slen + 1 + numChildren) * sizeof(rune);
+  size_t childKeysEnd = sizeof(TrieNode) + ((size_t)slen + numChildren) * sizeof(rune);
+  if (!numChildren) {
+    return childKeysEnd;
+  }
   return alignUp(childKeysEnd, _Alignof(TrieNode *)) + (size_t)numChildren * sizeof(TrieNode *);
 }
 
@@ -1179,6 +1182,9 @@ int testTrieNodeSizeof() {
   result = __trieNode_Sizeof(0, 0);
   ASSERT_EQUAL(result, expectedTrieNodeSize(0, 0));
 
+  // Leaves store no child pointers, so they are not padded
+  ASSERT_EQUAL(__trieNode_Sizeof(0, 3), sizeof(TrieNode) + 3 * sizeof(rune));
+
   return 0;
 }
 
@@ -1213,6 +1219,77 @@ int testDeleteRunesDeepSuffixTrieUsesDynamicStack() {
   return 0;
 }
 
+static int levenshtein(const char *a, size_t alen, const char *b, size_t blen) {
+  int row[64];
+  for (size_t j = 0; j <= blen; ++j) {
+    row[j] = j;
+  }
+  for (size_t i = 1; i <= alen; ++i) {
+    int diag = row[0];
+    row[0] = i;
+    for (size_t j = 1; j <= blen; ++j) {
+      int up = row[j];
+      row[j] = MIN(MIN(row[j] + 1, row[j - 1] + 1), diag + (a[i - 1] != b[j - 1]));
+      diag = up;
+    }
+  }
+  return row[blen];
+}
+
+int testFuzzyMatchesEditDistance() {
+  enum { numWords = 500, maxLen = 40 };
+  static char words[numWords][maxLen + 1];
+  Trie *t = NewTrie(NULL, Trie_Sort_Lex);
+  srand(1);
+  for (int i = 0; i < numWords; ++i) {
+    // a few long words, deeper than the initial filter stack
+    size_t len = i % 50 ? 1 + rand() % 8 : maxLen;
+    for (size_t j = 0; j < len; ++j) {
+      words[i][j] = "abcd"[rand() % 4];
+    }
+    words[i][len] = '\0';
+    Trie_InsertStringBuffer(t, words[i], len, 1, 1, NULL, 1);
+  }
+
+  for (int q = 0; q < numWords; q += 7) {
+    const char *query = words[q];
+    const size_t qlen = strlen(query);
+    for (int maxDist = 0; maxDist <= 3; ++maxDist) {
+      int expected = 0;
+      for (int i = 0; i < numWords; ++i) {
+        // duplicates are a single trie entry
+        int dup = 0;
+        for (int k = 0; k < i && !dup; ++k) {
+          dup = !strcmp(words[k], words[i]);
+        }
+        expected += !dup && levenshtein(query, qlen, words[i], strlen(words[i])) <= maxDist;
+      }
+
+      TrieIterator *it = Trie_IterateFuzzy(t, query, qlen, maxDist, TRIE_MATCH_EDIT_DISTANCE);
+      rune *s;
+      t_len len;
+      float score;
+      int dist = maxDist + 1;
+      int matches = 0;
+      while (TrieIterator_Next(it, &s, &len, NULL, &score, NULL, &dist)) {
+        char term[maxLen + 1];
+        for (t_len j = 0; j < len; ++j) {
+          term[j] = s[j];
+        }
+        // A term may also be reported when its prefix without the last rune is
+        // within the distance, so only count the exact matches
+        matches += levenshtein(query, qlen, term, len) <= maxDist;
+        ASSERT(dist <= maxDist);
+      }
+      ASSERT_EQUAL(expected, matches);
+      TrieIterator_Free(it);
+    }
+  }
+
+  TrieType_Free(t);
+  return 0;
+}
+
 TEST_MAIN({
   RMUTil_InitAlloc();
   TESTFUNC(testRuneUtil);
@@ -1227,4 +1304,5 @@ TEST_MAIN({
   TESTFUNC(testDecrementNumDocsNonTerminal);
   TESTFUNC(testTrieNodeSizeof);
   TESTFUNC(testDeleteRunesDeepSuffixTrieUsesDynamicStack);
+  TESTFUNC(testFuzzyMatchesEditDistance);
 });
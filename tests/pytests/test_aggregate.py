@@ -1222,6 +1222,30 @@ def testAggregateGroup0Field(env):
                   'REDUCE', 'QUANTILE', '2', 'num', '0.5', 'AS', 'q50')
     env.assertEqual(res, [1, ['q50', '758000']])
 
+def testAggregateExactQuantileAndStdDev(env):
+    # Per group values fitting the quantile sketch are exact, also when merged from several shards
+    conn = getConnectionByEnv(env)
+    env.cmd('ft.create', 'idx', 'ON', 'HASH', 'SCHEMA', 'num', 'NUMERIC', 'SORTABLE', 'g', 'TAG')
+    for i in range(400):
+        conn.execute_command('HSET', f'doc{i}', 'num', (i * 37) % 400, 'g', i % 2)
+
+    res = env.cmd('ft.aggregate', 'idx', '*', 'GROUPBY', 1, '@g',
+                  'REDUCE', 'QUANTILE', 2, '@num', 0, 'AS', 'q0',
+                  'REDUCE', 'QUANTILE', 2, '@num', 0.5, 'AS', 'q50',
+                  'REDUCE', 'QUANTILE', 2, '@num', 0.99, 'AS', 'q99',
+                  'REDUCE', 'STDDEV', 1, '@num', 'AS', 'sd',
+                  'SORTBY', 2, '@g', 'ASC')
+    env.assertEqual(res[0], 2)
+    for g, row in enumerate(res[1:]):
+        row = to_dict(row)
+        values = sorted((i * 37) % 400 for i in range(g, 400, 2))
+        env.assertEqual(row['q0'], str(values[0]))
+        env.assertEqual(row['q50'], str(values[99]))
+        env.assertEqual(row['q99'], str(values[197]))
+        mean = sum(values) / len(values)
+        stddev = math.sqrt(sum((v - mean) ** 2 for v in values) / (len(values) - 1))
+        env.assertAlmostEqual(float(row['sd']), stddev, delta=1e-6)
+
 @skip()
 def testResultCounter(env):
     # Issue 436
@@ -1637,6 +1661,42 @@ def testeAggregateBadApplyFunction(env):
     env.expect('FT.AGGREGATE', 'idx', '*', 'APPLY', '!!unexisting_function(@title)').error() \
         .contains("Unknown function name 'unexisting_function'")
 
+def testApplyFilterBatches(env):
+    """Tests that numeric APPLY and FILTER steps evaluated in batches (when a SORTBY reads all
+    the rows anyway) give the same rows as the row at a time evaluation"""
+    conn = getConnectionByEnv(env)
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'n', 'NUMERIC', 'SORTABLE', 't', 'TEXT', 'm', 'NUMERIC').ok()
+    n_docs = 2500
+    for i in range(n_docs):
+        # Every 10th document has no @m
+        fields = ['n', i, 't', str(i % 13)] + (['m', i % 7] if i % 10 else [])
+        conn.execute_command('HSET', f'doc{i}', *fields)
+
+    steps = [
+        # Text values and negative timestamps are not numbers for the batch evaluator
+        'LOAD', '2', '@n', '@t',
+        'APPLY', '(@n % 7) * 2 + sqrt(@n) ^ 2 - @t', 'AS', 'x',
+        'APPLY', 'hour(@n * 60 - 6000)', 'AS', 'h',
+        'APPLY', '!(@n % 3 == 0) || @t <= 4', 'AS', 'p',
+        'FILTER', '@x > 10 && @p != 0 && floor(@n / 100) != 7',
+    ]
+    rows = conn.execute_command('FT.AGGREGATE', 'idx', '*', *steps, 'LIMIT', '0', n_docs)[1:]
+    sorted_rows = conn.execute_command('FT.AGGREGATE', 'idx', '*', *steps,
+                                       'SORTBY', '2', '@n', 'ASC', 'MAX', n_docs)[1:]
+    key = lambda row: int(dict(zip(row[::2], row[1::2]))['n'])
+    env.assertEqual(sorted(rows, key=key), sorted_rows)
+    env.assertGreater(len(sorted_rows), n_docs // 2)
+    for row in sorted_rows:
+        row = dict(zip(row[::2], row[1::2]))
+        n, t = int(row['n']), int(row['t'])
+        env.assertAlmostEqual(float(row['x']), (n % 7) * 2 + n - t, delta=1e-6)
+        env.assertEqual(row['h'], None if n < 100 else str(((n * 60 - 6000) // 3600) * 3600))
+
+    # Rows missing a property still fail the query
+    env.expect('FT.AGGREGATE', 'idx', '*', 'LOAD', '1', '@m', 'APPLY', '@m * 2', 'AS', 'y',
+               'SORTBY', '2', '@n', 'ASC', 'MAX', n_docs).error() \
+        .contains('Could not find the value for a parameter name')
+
 
 # This is an existing bug, but it's not related to WITHCOUNT.
 # def testWithoutCountWithSortBy(env):
@@ -0,0 +1,135 @@
+from common import *
+
+NUM_DOCS = 2000
+
+def enableAsyncIndexing(env, max_pending=256, read_your_writes=True):
+    env.expect(config_cmd(), 'SET', 'ASYNC_INDEXING_MAX_PENDING', max_pending).ok()
+    env.expect(config_cmd(), 'SET', 'ASYNC_INDEXING_READ_YOUR_WRITES',
+               'true' if read_your_writes else 'false').ok()
+
+def loadDocs(env, num_docs=NUM_DOCS):
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline(transaction=False)
+    for i in range(num_docs):
+        pl.execute_command('HSET', f'doc{i}', 't', f'hello world{i % 5} running', 'tag', f'tag{i % 3}',
+                           'n', i, 'g', f'{i % 90},{i % 45}')
+    pl.execute()
+
+def runQueries(env):
+    return [env.cmd(*query) for query in (
+        ['FT.SEARCH', 'idx', 'run', 'SORTBY', 'n', 'LIMIT', 0, 5, 'NOCONTENT'],
+        ['FT.SEARCH', 'idx', '@tag:{tag1}', 'LIMIT', 0, 0],
+        ['FT.SEARCH', 'idx', 'world3 @n:[100 500]', 'LIMIT', 0, 0],
+        ['FT.AGGREGATE', 'idx', '*', 'GROUPBY', 1, '@tag', 'REDUCE', 'COUNT', 0, 'AS', 'c',
+         'SORTBY', 2, '@tag', 'ASC'],
+        ['FT.SEARCH', 'idx', '@g:[10 10 500 km]', 'LIMIT', 0, 0],
+    )]
+
+def createIndex(env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'tag', 'TAG', 'n', 'NUMERIC', 'SORTABLE',
+               'g', 'GEO').ok()
+
+@skip(cluster=True)
+def testAsyncIndexingMatchesSyncIndexing():
+    env = Env(moduleArgs='WORKERS 4')
+    createIndex(env)
+    loadDocs(env)
+    expected = runQueries(env)
+    env.expect('FLUSHALL').ok()
+
+    enableAsyncIndexing(env)
+    createIndex(env)
+    loadDocs(env)
+    # Queries read their own writes
+    env.assertEqual(runQueries(env), expected)
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS)
+
+    # A pending document never outlives a later write to it
+    conn = getConnectionByEnv(env)
+    for i in range(50):
+        conn.execute_command('HSET', f'doc{i}', 't', 'updated')
+        conn.execute_command('DEL', f'doc{i}')
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS - 50)
+    env.expect('FT.SEARCH', 'idx', 'updated').equal([0])
+
+@skip(cluster=True)
+def testAsyncIndexingEventualConsistency():
+    env = Env(moduleArgs='WORKERS 2')
+    enableAsyncIndexing(env, read_your_writes=False)
+    createIndex(env)
+    loadDocs(env)
+
+    # The documents are indexed in the background
+    with TimeLimit(30):
+        while int(index_info(env)['num_docs']) != NUM_DOCS:
+            time.sleep(0.1)
+    env.assertEqual(env.cmd('FT.SEARCH', 'idx', '@tag:{tag1}', 'LIMIT', 0, 0), [667])
+
+@skip(cluster=True)
+def testAsyncIndexingErrorsAndDrop():
+    env = Env(moduleArgs='WORKERS 2')
+    enableAsyncIndexing(env)
+    createIndex(env)
+    conn = getConnectionByEnv(env)
+    conn.execute_command('HSET', 'good', 'n', 1)
+    conn.execute_command('HSET', 'bad', 'n', 'not a number')
+
+    # The preprocessing failure is reported as with synchronous indexing
+    env.assertEqual(int(index_info(env)['num_docs']), 1)
+    env.assertEqual(int(index_errors(env)['indexing failures']), 1)
+
+    # Dropping the index with its documents deletes the pending ones as well
+    env.expect(config_cmd(), 'SET', 'ASYNC_INDEXING_READ_YOUR_WRITES', 'false').ok()
+    loadDocs(env, 100)
+    env.expect('FT.DROPINDEX', 'idx', 'DD').ok()
+    env.assertEqual(conn.execute_command('DBSIZE'), 1)
+
+@skip(cluster=True)
+def testBackgroundScanOnWorkers():
+    env = Env(moduleArgs='WORKERS 4')
+    loadDocs(env)
+    env.expect(config_cmd(), 'SET', 'BG_INDEX_MAX_PENDING', 0).ok()
+    createIndex(env)
+    waitForIndex(env)
+    expected = runQueries(env)
+    env.expect('FT.DROPINDEX', 'idx').ok()
+
+    # The scanned documents are preprocessed on the workers, and all of them are
+    # indexed once the scan is done
+    env.expect(config_cmd(), 'SET', 'BG_INDEX_MAX_PENDING', 64).ok()
+    env.expect(config_cmd(), 'SET', 'ASYNC_INDEXING_READ_YOUR_WRITES', 'false').ok()
+    createIndex(env)
+    waitForIndex(env)
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS)
+    env.assertEqual(runQueries(env), expected)
+
+    # Altering the index scans the keys again
+    env.expect('FT.ALTER', 'idx', 'SCHEMA', 'ADD', 't2', 'TEXT').ok()
+    waitForIndex(env)
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS)
+    env.assertEqual(runQueries(env), expected)
+
+@skip(cluster=True)
+def testAsyncIndexingExpireWhilePending():
+    env = Env(moduleArgs='WORKERS 2')
+    conn = getConnectionByEnv(env)
+    # Keep the expired keys in the keyspace, so that only their TTL in the index hides them
+    conn.execute_command('DEBUG', 'SET-ACTIVE-EXPIRE', '0')
+    enableAsyncIndexing(env)
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT').ok()
+    env.cmd(debug_cmd(), 'SET_MONITOR_EXPIRATION', 'idx', 'documents')
+
+    # The TTL is set while the documents may still be pending
+    pl = conn.pipeline(transaction=False)
+    for i in range(100):
+        pl.execute_command('HSET', f'doc{i}', 't', 'hello')
+        if i % 2:
+            pl.execute_command('PEXPIRE', f'doc{i}', 100)
+        else:
+            pl.execute_command('EXPIRE', f'doc{i}', 1)
+    pl.execute_command('HSET', 'kept', 't', 'hello')
+    pl.execute()
+
+    time.sleep(1.2)
+    env.expect('FT.SEARCH', 'idx', 'hello', 'NOCONTENT').equal([1, 'kept'])
+    conn.execute_command('DEBUG', 'SET-ACTIVE-EXPIRE', '1')
@@ -87,10 +87,20 @@ def testGetConfigOptions(env):
     check_config('FORK_GC_CLEAN_THRESHOLD')
     check_config('FORK_GC_RETRY_INTERVAL')
     check_config('PARTIAL_INDEXED_DOCS')
+    check_config('QUERY_CACHE_MAX_MEMORY')
+    check_config('FILTER_CACHE_MAX_MEMORY')
+    check_config('QUERY_MAX_PARALLELISM')
+    check_config('QUERY_PARALLEL_MIN_DOCS')
+    check_config('ASYNC_INDEXING_MAX_PENDING')
+    check_config('ASYNC_INDEXING_READ_YOUR_WRITES')
+    check_config('BG_INDEX_MAX_PENDING')
+    check_config('PERSIST_INDEX_CONTENTS')
+    check_config('STEM_CACHE_MAX_MEMORY')
     check_config('UNION_ITERATOR_HEAP')
     check_config('_NUMERIC_COMPRESS')
     check_config('_NUMERIC_RANGES_PARENTS')
     check_config('RAW_DOCID_ENCODING')
+    check_config('PACKED_DOCID_ENCODING')
     check_config('FORK_GC_CLEAN_NUMERIC_EMPTY_NODES')
     check_config('_FORK_GC_CLEAN_NUMERIC_EMPTY_NODES')
     check_config('_FREE_RESOURCE_ON_THREAD')
@@ -210,6 +220,15 @@ def testAllConfig(env):
     env.assertEqual(res_dict['CURSOR_MAX_IDLE'][0], '300000')
     env.assertEqual(res_dict['NO_MEM_POOLS'][0], 'false')
     env.assertEqual(res_dict['PARTIAL_INDEXED_DOCS'][0], 'false')
+    env.assertEqual(res_dict['QUERY_CACHE_MAX_MEMORY'][0], '0')
+    env.assertEqual(res_dict['FILTER_CACHE_MAX_MEMORY'][0], '0')
+    env.assertEqual(res_dict['QUERY_MAX_PARALLELISM'][0], '1')
+    env.assertEqual(res_dict['QUERY_PARALLEL_MIN_DOCS'][0], '100000')
+    env.assertEqual(res_dict['ASYNC_INDEXING_MAX_PENDING'][0], '0')
+    env.assertEqual(res_dict['ASYNC_INDEXING_READ_YOUR_WRITES'][0], 'true')
+    env.assertEqual(res_dict['BG_INDEX_MAX_PENDING'][0], '1024')
+    env.assertEqual(res_dict['PERSIST_INDEX_CONTENTS'][0], 'false')
+    env.assertEqual(res_dict['STEM_CACHE_MAX_MEMORY'][0], '16777216')
     env.assertEqual(res_dict['_NUMERIC_COMPRESS'][0], 'false')
     env.assertEqual(res_dict['_NUMERIC_RANGES_PARENTS'][0], '0')
     env.assertEqual(res_dict['FORK_GC_CLEAN_NUMERIC_EMPTY_NODES'][0], 'true')
@@ -278,6 +297,8 @@ def testInitConfig():
     _test_config_str('MAXAGGREGATERESULTS', '-1', 'unlimited')
     _test_config_str('RAW_DOCID_ENCODING', 'false', 'false')
     _test_config_str('RAW_DOCID_ENCODING', 'true', 'true')
+    _test_config_str('PACKED_DOCID_ENCODING', 'false', 'false')
+    _test_config_str('PACKED_DOCID_ENCODING', 'true', 'true')
     _test_config_str('_FORK_GC_CLEAN_NUMERIC_EMPTY_NODES', 'false', 'false')
     _test_config_str('_FORK_GC_CLEAN_NUMERIC_EMPTY_NODES', 'true', 'true')
     _test_config_str('_FREE_RESOURCE_ON_THREAD', 'false', 'false')
@@ -349,6 +370,7 @@ def testImmutable(env):
     env.expect(config_cmd(), 'set', 'PARTIAL_INDEXED_DOCS').error().contains(not_modifiable)
     env.expect(config_cmd(), 'set', 'UPGRADE_INDEX').error().contains(not_modifiable)
     env.expect(config_cmd(), 'set', 'RAW_DOCID_ENCODING').error().contains(not_modifiable)
+    env.expect(config_cmd(), 'set', 'PACKED_DOCID_ENCODING').error().contains(not_modifiable)
     env.expect(config_cmd(), 'set', 'BG_INDEX_SLEEP_GAP').error().contains(not_modifiable)
 
 
@@ -600,6 +622,13 @@ numericConfigs = [
     ('search-min-prefix', 'MINPREFIX', 2, 1, UINT32_MAX, False, False),
     ('search-min-stem-len', 'MINSTEMLEN', 4, 2, UINT32_MAX, False, False),
     ('search-multi-text-slop', 'MULTI_TEXT_SLOP', 100, 1, UINT32_MAX, True, False),
+    ('search-query-cache-max-memory', 'QUERY_CACHE_MAX_MEMORY', 0, 0, LLONG_MAX, False, False),
+    ('search-filter-cache-max-memory', 'FILTER_CACHE_MAX_MEMORY', 0, 0, LLONG_MAX, False, False),
+    ('search-query-max-parallelism', 'QUERY_MAX_PARALLELISM', 1, 1, MAX_WORKER_THREADS, False, False),
+    ('search-query-parallel-min-docs', 'QUERY_PARALLEL_MIN_DOCS', 100000, 0, LLONG_MAX, False, False),
+    ('search-async-indexing-max-pending', 'ASYNC_INDEXING_MAX_PENDING', 0, 0, LLONG_MAX, False, False),
+    ('search-bg-index-max-pending', 'BG_INDEX_MAX_PENDING', 1024, 0, LLONG_MAX, False, False),
+    ('search-stem-cache-max-memory', 'STEM_CACHE_MAX_MEMORY', 16777216, 0, LLONG_MAX, False, False),
     ('search-tiered-hnsw-buffer-limit', 'TIERED_HNSW_BUFFER_LIMIT', 1024, 0, LLONG_MAX, True, False),
     ('search-timeout', 'TIMEOUT', 500, 1, LLONG_MAX, False, False),
     ('search-union-iterator-heap', 'UNION_ITERATOR_HEAP', 20, 1, UINT32_MAX, False, False),
@@ -1613,7 +1642,10 @@ booleanConfigs = [
     ('search-partial-indexed-docs', 'PARTIAL_INDEXED_DOCS', 'no', True, False),
     ('search-_prioritize-intersect-union-children', '_PRIORITIZE_INTERSECT_UNION_CHILDREN', 'no', False, False),
     ('search-raw-docid-encoding', 'RAW_DOCID_ENCODING', 'no', True, False),
+    ('search-packed-docid-encoding', 'PACKED_DOCID_ENCODING', 'no', True, False),
     ('search-enable-unstable-features', 'ENABLE_UNSTABLE_FEATURES', 'no', False, False),
+    ('search-async-indexing-read-your-writes', 'ASYNC_INDEXING_READ_YOUR_WRITES', 'yes', False, False),
+    ('search-persist-index-contents', 'PERSIST_INDEX_CONTENTS', 'no', False, False),
 ]
 
 # CONFIG-only boolean parameters (no corresponding FT.CONFIG parameter / module argument)
@@ -749,3 +749,68 @@ def testSuffixTrieWildcardCaseSensitiveTag():
     conn.execute_command('HSET', 'doc:1', 't', 'Apple')
     env.expect('FT.SEARCH', 'idx', "@t:{w'A*'}", 'NOCONTENT').equal([1, 'doc:1'])
     env.expect('FT.SEARCH', 'idx', "@t:{w'a*'}", 'NOCONTENT').equal([0])
+
+def testWITHNGRAMSParamText(env):
+    env.expect('ft.create', 'idx', 'schema', 't', 'TEXT', 'SORTABLE', 'WITHNGRAMS').error()
+    env.expect('ft.create', 'idx_tag', 'schema', 't', 'TAG', 'WITHNGRAMS').error()
+
+    env.expect('ft.create', 'idx', 'schema', 't', 'TEXT', 'WITHNGRAMS').ok()
+    res_info = [['identifier', 't', 'attribute', 't', 'type', 'TEXT', 'WEIGHT', '1', 'WITHNGRAMS']]
+    assertInfoField(env, 'idx', 'attributes', res_info)
+
+    env.expect('ft.create', 'idx_sortable', 'schema', 't', 'TEXT', 'WITHNGRAMS', 'SORTABLE').ok()
+    res_info = [['identifier', 't', 'attribute', 't', 'type', 'TEXT', 'WEIGHT', '1', 'SORTABLE', 'WITHNGRAMS']]
+    assertInfoField(env, 'idx_sortable', 'attributes', res_info)
+
+@skip(cluster=True)
+def testNgramsSanity():
+    # The ngram index answers the same as a brute-force scan and the suffix trie,
+    # including the patterns too short to hold a trigram
+    env = Env(moduleArgs='DEFAULT_DIALECT 2')
+    env.expect(config_cmd(), 'set', 'MINPREFIX', 1).ok()
+    env.expect(config_cmd(), 'set', 'MAXEXPANSIONS', 10000000).ok()
+    item_qty = 1000
+
+    index_list = ['idx_bf', 'idx_suffix', 'idx_ngrams']
+    env.cmd('ft.create', 'idx_bf', 'SCHEMA', 't', 'TEXT')
+    env.cmd('ft.create', 'idx_suffix', 'SCHEMA', 't', 'TEXT', 'WITHSUFFIXTRIE')
+    env.cmd('ft.create', 'idx_ngrams', 'SCHEMA', 't', 'TEXT', 'WITHNGRAMS')
+
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline()
+    for i in range(item_qty):
+        pl.execute_command('HSET', 'doc%d' % i, 't', 'foo%d' % i)
+        pl.execute_command('HSET', 'doc%d' % (i + item_qty), 't', 'fooo%d' % i)
+        pl.execute_command('HSET', 'doc%d' % (i + item_qty * 2), 't', 'foofo%d' % i)
+        pl.execute()
+
+    queries = ['*oo*', '*55*', '*555*', '*o55*', '*oo234*', '*234', '*13', '*3',
+               "w'*oo?5*'", "w'f*55'", "w'?oo*'", "w'*o*1'", "w'foofo12?'"]
+    for q in queries:
+        expected = env.cmd('ft.search', index_list[0], q, 'LIMIT', 0, 0)
+        for idx in index_list[1:]:
+            env.assertEqual(env.cmd('ft.search', idx, q, 'LIMIT', 0, 0), expected, message=(idx, q))
+
+@skip(cluster=True)
+def testNgramsGC(env):
+    env.expect(config_cmd() + ' set FORK_GC_CLEAN_THRESHOLD 0').ok()
+    conn = getConnectionByEnv(env)
+    conn.execute_command('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'WITHNGRAMS')
+
+    conn.execute_command('HSET', 'doc1', 't', 'hello')
+    env.expect('ft.search', 'idx', '*ell*', 'NOCONTENT').equal([1, 'doc1'])
+    conn.execute_command('HSET', 'doc1', 't', 'world')
+    forceInvokeGC(env, 'idx')
+
+    env.expect('ft.search', 'idx', '*ell*', 'NOCONTENT').equal([0])
+    env.expect('ft.search', 'idx', '*orl*', 'NOCONTENT').equal([1, 'doc1'])
+
+@skip(cluster=True)
+def testContainsMixedWithNgrams(env):
+    conn = getConnectionByEnv(env)
+    conn.execute_command('FT.CREATE', 'idx', 'SCHEMA', 't1', 'TEXT', 'WITHNGRAMS', 't2', 'TEXT')
+    conn.execute_command('HSET', 'doc1', 't1', 'hello', 't2', 'hello')
+
+    env.expect('ft.search', 'idx', '@t1:*ell*', 'NOCONTENT').equal([1, 'doc1'])
+    env.expect('ft.search', 'idx', '@t2:*ell*', 'NOCONTENT').error()  \
+      .contains('Contains query on fields without WITHNGRAMS support')
@@ -50,11 +50,9 @@ def testCountDistinctishAcrossShards():
         for i in range(docs_per_value):
             conn.execute_command('HSET', f'doc:{j}:{i}', 'group', 'all', 'category', f'cat{j}')
 
-    # COUNT_DISTINCT (exact) has no entry in `reducerDistributors_g`, so a GROUPBY
-    # step containing it is never distributed (see `distributeGroupStep`): it runs
-    # entirely on the coordinator over raw rows gathered from all shards, and is
-    # therefore unaffected by per-shard hash seeds. Issued in its own query so it
-    # doesn't drag the COUNT_DISTINCTISH query (below) into the same fate.
+    # COUNT_DISTINCT (exact) is distributed as per-shard sets of stable hashes,
+    # merged on the coordinator by COUNT_DISTINCT_MERGE. Every value is on both
+    # shards, so it is only counted once if the shards hash it the same way.
     res = env.cmd('FT.AGGREGATE', 'idx', '*',
                    'GROUPBY', '1', '@group',
                    'REDUCE', 'COUNT_DISTINCT', '1', '@category', 'AS', 'exact')
@@ -74,6 +72,22 @@ def testCountDistinctishAcrossShards():
     approx_count = int(to_dict(res[1])['approx'])
     env.assertAlmostEqual(exact_count, approx_count, delta=exact_count * 0.20)
 
+@skip(cluster=False)
+def testCountDistinctAcrossShards():
+    # The per-shard sets of COUNT_DISTINCT are merged on the coordinator, with values missing from
+    # some of the shards
+    env = Env(shardsCount=2)
+    conn = getConnectionByEnv(env)
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'group', 'TAG', 'category', 'TAG').ok()
+    for i in range(200):
+        conn.execute_command('HSET', f'num:{i}', 'group', f'g{i % 3}', 'category', f'n{i % 7}{i % 11}')
+    res = env.cmd('FT.AGGREGATE', 'idx', '*',
+                  'GROUPBY', '1', '@group',
+                  'REDUCE', 'COUNT_DISTINCT', '1', '@category', 'AS', 'exact',
+                  'SORTBY', '2', '@group', 'ASC')
+    env.assertEqual([to_dict(row)['exact'] for row in res[1:]],
+                    [str(len({f'n{i % 7}{i % 11}' for i in range(g, 200, 3)})) for g in range(3)])
+
 @skip(cluster=True)
 def test_required_fields(env):
     # Testing coordinator<-> shard `_REQUIRED_FIELDS` protocol
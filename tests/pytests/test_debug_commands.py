@@ -83,6 +83,7 @@ class TestDebugCommands(object):
             'DISK_IO_CONTROL',
             'REGISTER_TEST_SCORERS',
             'SET_MAX_INDEXES',
+            'CORRUPT_INDEX_CONTENTS',
             'FT.AGGREGATE',
             '_FT.AGGREGATE',
             'FT.SEARCH',
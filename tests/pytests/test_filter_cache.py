@@ -0,0 +1,129 @@
+from common import *
+
+
+def getFilterCacheStats(env, idx='idx'):
+    return to_dict(index_info(env, idx)['filter_cache_stats'])
+
+def setupIndex(env, num_docs=10):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TAG', 'n', 'NUMERIC', 'g', 'GEO', 'body', 'TEXT').ok()
+    conn = getConnectionByEnv(env)
+    for i in range(num_docs):
+        conn.execute_command('HSET', f'doc{i}', 't', f'tag{i % 2}', 'n', i, 'g', f'{i},{i}', 'body', 'hello')
+
+# Filters of scored searches are not served from the cache, so aggregate over them
+def filterKeys(env, query, *args):
+    res = env.cmd('FT.AGGREGATE', 'idx', query, 'LOAD', 1, '@__key', *args)
+    return sorted(row[1] for row in res[1:])
+
+@skip(cluster=True)
+def testFilterCacheDisabledByDefault(env):
+    setupIndex(env)
+    for _ in range(3):
+        filterKeys(env, '@n:[2 5]')
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['hits'], 0)
+    env.assertEqual(stats['misses'], 0)
+    env.assertEqual(stats['entries'], 0)
+
+@skip(cluster=True)
+def testFilterCacheHit(env):
+    env.expect(config_cmd(), 'SET', 'FILTER_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+
+    for query, expected in (('@n:[2 5]', ['doc2', 'doc3', 'doc4', 'doc5']),
+                            ('@t:{tag1}', ['doc1', 'doc3', 'doc5', 'doc7', 'doc9']),
+                            ('@g:[0 0 200 km]', ['doc0', 'doc1']),
+                            ('hello @t:{tag0} @n:[0 4]', ['doc0', 'doc2', 'doc4'])):
+        for _ in range(3):
+            env.assertEqual(filterKeys(env, query), expected, message=query)
+
+    # Each filter is materialized on its second lookup, and served from the cache on the third
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['entries'], 5)
+    env.assertEqual(stats['misses'], 10)
+    env.assertEqual(stats['hits'], 5)
+    env.assertGreater(stats['memory'], 0)
+
+    # NOCACHE bypasses the cache
+    filterKeys(env, '@n:[2 5]', 'NOCACHE')
+    env.assertEqual(getFilterCacheStats(env)['hits'], 5)
+
+    # Disabling the cache drops its entries
+    env.expect(config_cmd(), 'SET', 'FILTER_CACHE_MAX_MEMORY', 0).ok()
+    filterKeys(env, '@n:[2 5]')
+    env.assertEqual(getFilterCacheStats(env)['entries'], 0)
+
+@skip(cluster=True)
+def testFilterCacheScores(env):
+    env.expect(config_cmd(), 'SET', 'FILTER_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+
+    # The filters of a scored search contribute to the scores, so they are not cached
+    for scorer in ('TFIDF', 'BM25STD', 'DISMAX'):
+        for query in ('hello @t:{tag0}', 'hello @n:[0 4]'):
+            cold = env.cmd('FT.SEARCH', 'idx', query, 'WITHSCORES', 'NOCONTENT', 'SCORER', scorer)
+            for _ in range(2):
+                env.assertEqual(env.cmd('FT.SEARCH', 'idx', query, 'WITHSCORES', 'NOCONTENT', 'SCORER', scorer),
+                                cold, message=(scorer, query))
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['entries'], 0)
+    env.assertEqual(stats['hits'], 0)
+
+    # Negated filters are not scored
+    for _ in range(3):
+        res = env.cmd('FT.SEARCH', 'idx', 'hello -@t:{tag1}', 'WITHSCORES', 'NOCONTENT')
+        env.assertEqual(sorted(res[1::2]), ['doc0', 'doc2', 'doc4', 'doc6', 'doc8'])
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['entries'], 1)
+    env.assertEqual(stats['hits'], 1)
+
+@skip(cluster=True)
+def testFilterCacheInvalidation(env):
+    env.expect(config_cmd(), 'SET', 'FILTER_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+    conn = getConnectionByEnv(env)
+    tag_query = '@t:{tag1}'
+    num_query = '@n:[2 5]'
+    for _ in range(2):
+        filterKeys(env, tag_query)
+        filterKeys(env, num_query)
+    env.assertEqual(getFilterCacheStats(env)['entries'], 2)
+
+    # Writing to the numeric field only invalidates the numeric filter
+    conn.execute_command('HSET', 'doc100', 'n', 3)
+    env.assertEqual(filterKeys(env, num_query), ['doc100', 'doc2', 'doc3', 'doc4', 'doc5'])
+    env.assertEqual(filterKeys(env, tag_query), ['doc1', 'doc3', 'doc5', 'doc7', 'doc9'])
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['invalidations'], 1)
+    env.assertEqual(stats['hits'], 1)
+
+    # Deleted documents are skipped without invalidating the entry
+    conn.execute_command('DEL', 'doc1')
+    env.assertEqual(filterKeys(env, tag_query), ['doc3', 'doc5', 'doc7', 'doc9'])
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['invalidations'], 1)
+    env.assertEqual(stats['hits'], 2)
+
+    # Updating a document writes its tag again
+    conn.execute_command('HSET', 'doc0', 't', 'tag1')
+    env.assertEqual(filterKeys(env, tag_query), ['doc0', 'doc3', 'doc5', 'doc7', 'doc9'])
+    env.assertEqual(getFilterCacheStats(env)['invalidations'], 2)
+
+@skip(cluster=True)
+def testFilterCacheEviction(env):
+    env.expect(config_cmd(), 'SET', 'FILTER_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+    for _ in range(2):
+        filterKeys(env, '@n:[0 3]')
+    entry_memory = getFilterCacheStats(env)['memory']
+    env.assertGreater(entry_memory, 0)
+
+    # Room for a single filter
+    cap = entry_memory * 3 // 2
+    env.expect(config_cmd(), 'SET', 'FILTER_CACHE_MAX_MEMORY', cap).ok()
+    for _ in range(2):
+        filterKeys(env, '@n:[4 7]')
+    stats = getFilterCacheStats(env)
+    env.assertEqual(stats['entries'], 1)
+    env.assertEqual(stats['evictions'], 1)
+    env.assertLessEqual(stats['memory'], cap)
@@ -0,0 +1,143 @@
+from common import *
+
+NUM_DOCS = 1000
+
+def persistIndexContents(env, enabled=True):
+    env.expect(config_cmd(), 'SET', 'PERSIST_INDEX_CONTENTS', 'true' if enabled else 'false').ok()
+
+def loadDocs(env, num_docs=NUM_DOCS):
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline(transaction=False)
+    for i in range(num_docs):
+        pl.execute_command('HSET', f'doc{i}', 't', f'hello world{i % 5} running', 'tag', f'tag{i % 3}',
+                           'n', i, 'g', f'{i % 90},{i % 45}')
+    pl.execute()
+
+def runQueries(env):
+    return [env.cmd(*query) for query in (
+        ['FT.SEARCH', 'idx', 'run', 'SORTBY', 'n', 'LIMIT', 0, 5, 'WITHSCORES'],
+        ['FT.SEARCH', 'idx', 'hello world3', 'LIMIT', 0, 5, 'WITHSCORES', 'NOCONTENT'],
+        ['FT.SEARCH', 'idx', '@tag:{tag1}', 'LIMIT', 0, 0],
+        ['FT.SEARCH', 'idx', '*wor*', 'LIMIT', 0, 0],
+        ['FT.SEARCH', 'idx', 'world3 @n:[100 500]', 'LIMIT', 0, 0],
+        ['FT.SEARCH', 'idx', 'ismissing(@m)', 'LIMIT', 0, 0],
+        ['FT.SEARCH', 'idx', '@g:[10 10 500 km]', 'LIMIT', 0, 0],
+        ['FT.AGGREGATE', 'idx', '*', 'GROUPBY', 1, '@tag', 'REDUCE', 'COUNT', 0, 'AS', 'c',
+         'SORTBY', 2, '@tag', 'ASC'],
+    )]
+
+def createIndex(env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'WITHSUFFIXTRIE', 'tag', 'TAG',
+               'n', 'NUMERIC', 'SORTABLE', 'g', 'GEO', 'm', 'TEXT', 'INDEXMISSING').ok()
+
+@skip(cluster=True)
+def testIndexContentsRestoredOnReload():
+    env = Env(moduleArgs='DEFAULT_DIALECT 2')
+    persistIndexContents(env)
+    createIndex(env)
+    loadDocs(env)
+    # Deleted documents are not restored
+    conn = getConnectionByEnv(env)
+    for i in range(0, NUM_DOCS, 10):
+        conn.execute_command('DEL', f'doc{i}')
+    expected = runQueries(env)
+
+    env.dumpAndReload()
+    waitForIndex(env)
+    env.assertEqual(runQueries(env), expected)
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS - NUM_DOCS // 10)
+
+    # The restored documents are updated and deleted as usual
+    conn.execute_command('HSET', 'doc1', 't', 'updated')
+    conn.execute_command('DEL', 'doc2')
+    env.expect('FT.SEARCH', 'idx', 'updated', 'NOCONTENT').equal([1, 'doc1'])
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS - NUM_DOCS // 10 - 1)
+
+@skip(cluster=True)
+def testIndexContentsMatchReindexing():
+    env = Env(moduleArgs='DEFAULT_DIALECT 2')
+    createIndex(env)
+    loadDocs(env)
+    env.dumpAndReload()
+    waitForIndex(env)
+    expected = runQueries(env)
+
+    persistIndexContents(env)
+    env.dumpAndReload()
+    waitForIndex(env)
+    env.assertEqual(runQueries(env), expected)
+
+@skip(cluster=True)
+def testIndexContentsNotSavedForVectorFields():
+    env = Env(moduleArgs='DEFAULT_DIALECT 2')
+    persistIndexContents(env)
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'v', 'VECTOR', 'FLAT', 6, 'TYPE', 'FLOAT32',
+               'DIM', 2, 'DISTANCE_METRIC', 'L2').ok()
+    conn = getConnectionByEnv(env)
+    for i in range(100):
+        conn.execute_command('HSET', f'doc{i}', 't', 'hello', 'v', np.array([i, i], dtype=np.float32).tobytes())
+
+    # The keys are indexed again
+    env.dumpAndReload()
+    waitForIndex(env)
+    env.assertEqual(int(index_info(env)['num_docs']), 100)
+    env.expect('FT.SEARCH', 'idx', 'hello', 'LIMIT', 0, 0).equal([100])
+
+def checkDiscardedContentsReindexed(corruption):
+    env = Env(moduleArgs='DEFAULT_DIALECT 2')
+    createIndex(env)
+    loadDocs(env)
+    env.dumpAndReload()
+    waitForIndex(env)
+    expected = runQueries(env)
+
+    # The load falls back to indexing the keys
+    persistIndexContents(env)
+    env.expect(debug_cmd(), 'CORRUPT_INDEX_CONTENTS', corruption).ok()
+    env.dumpAndReload()
+    waitForIndex(env)
+    env.expect(debug_cmd(), 'CORRUPT_INDEX_CONTENTS', 'NONE').ok()
+    env.assertEqual(runQueries(env), expected, message=corruption)
+    env.assertEqual(int(index_info(env)['num_docs']), NUM_DOCS, message=corruption)
+
+    # And the index is saved and restored as usual afterwards
+    env.dumpAndReload()
+    waitForIndex(env)
+    env.assertEqual(runQueries(env), expected, message=corruption)
+
+@skip(cluster=True)
+def testIndexContentsFingerprintMismatch():
+    checkDiscardedContentsReindexed('FINGERPRINT')
+
+@skip(cluster=True)
+def testIndexContentsVersionMismatch():
+    checkDiscardedContentsReindexed('VERSION')
+
+@skip(cluster=True)
+def testIndexContentsChecksumMismatch():
+    checkDiscardedContentsReindexed('CHECKSUM')
+
+@skip(cluster=True)
+def testIndexContentsRestoreFailure():
+    # The contents are checksummed but cannot be restored, so the partially restored index is reset
+    checkDiscardedContentsReindexed('CONTENTS')
+
+@skip(cluster=True)
+def testIndexContentsKeyExpiredBeforeLoad():
+    env = Env(moduleArgs='DEFAULT_DIALECT 2')
+    conn = getConnectionByEnv(env)
+    conn.execute_command('DEBUG', 'SET-ACTIVE-EXPIRE', '0')
+    persistIndexContents(env)
+    createIndex(env)
+    loadDocs(env, 100)
+    conn.execute_command('PEXPIRE', 'doc1', 500)
+    env.expect('SAVE').ok()
+
+    # The key expires after the save, so it is not loaded but its document is restored
+    time.sleep(1)
+    conn.execute_command('DEBUG', 'RELOAD', 'NOSAVE')
+    waitForIndex(env)
+    env.assertEqual(int(index_info(env)['num_docs']), 99)
+    env.expect('FT.SEARCH', 'idx', '@n:[1 1]', 'NOCONTENT').equal([0])
+    env.expect('FT.SEARCH', 'idx', '@tag:{tag1}', 'LIMIT', 0, 0).equal([32])
+    conn.execute_command('DEBUG', 'SET-ACTIVE-EXPIRE', '1')
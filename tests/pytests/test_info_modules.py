@@ -2938,3 +2938,31 @@ def test_vecsim_hnsw_tiered_info_metrics():
                   message="FT.INFO flat buffer should be 0 when WORKERS=0")
   env.assertEqual(field_stats_nw['direct_hnsw_insertions'], workers_0_vectors,
                   message="FT.INFO should show direct insertions when WORKERS=0")
+
+@skip(cluster=True)
+def test_stem_cache_info_metrics():
+  env = Env()
+  conn = getConnectionByEnv(env)
+  env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT').ok()
+
+  def stem_cache_counters():
+    info = info_modules_to_dict(conn)['search_stem_cache']
+    return int(info['search_stem_cache_hits']), int(info['search_stem_cache_misses'])
+
+  hits, misses = stem_cache_counters()
+  for i in range(10):
+    conn.execute_command('HSET', f'doc{i}', 't', 'running runners')
+  new_hits, new_misses = stem_cache_counters()
+  # Each word is stemmed by Snowball once at most
+  env.assertEqual(new_hits + new_misses - hits - misses, 20)
+  env.assertLessEqual(new_misses - misses, 2)
+
+  # The query expansion shares the cache
+  env.expect('FT.SEARCH', 'idx', 'running', 'NOCONTENT', 'LIMIT', 0, 0).equal([10])
+  env.assertEqual(stem_cache_counters(), (new_hits + 1, new_misses))
+
+  # Disabling the cache bypasses it
+  env.expect(config_cmd(), 'SET', 'STEM_CACHE_MAX_MEMORY', 0).ok()
+  conn.execute_command('HSET', 'doc10', 't', 'running runners')
+  env.expect('FT.SEARCH', 'idx', 'runner', 'NOCONTENT', 'LIMIT', 0, 0).equal([11])
+  env.assertEqual(stem_cache_counters(), (new_hits + 1, new_misses))
@@ -0,0 +1,91 @@
+"""
+Tests for PACKED_DOCID_ENCODING configuration.
+
+These tests verify that the bit-packed DocID encoding (groups of 128 deltas)
+works correctly with TAG indexes, wildcard queries and GC.
+"""
+
+from RLTest import Env
+from common import skip, config_cmd, forceInvokeGC
+
+
+@skip(cluster=True)
+def testTagIndexGCWithPackedDocIdEncoding():
+    """Test TAG index with GC operations using PACKED_DOCID_ENCODING.
+
+    TAG fields use DocIdsOnly encoding, which becomes PackedDocIdsOnly when
+    PACKED_DOCID_ENCODING=true. GC removes entries from the middle of packed
+    groups, so the surviving entries must be re-packed correctly.
+    """
+    env = Env(moduleArgs='PACKED_DOCID_ENCODING true')
+    env.expect(config_cmd(), 'set', 'FORK_GC_CLEAN_THRESHOLD', 0).ok()
+    env.expect('ft.create', 'idx', 'ON', 'HASH', 'schema', 't', 'TAG').ok()
+
+    # Add enough documents to span multiple blocks and many packed groups
+    num_docs = 3200
+    for i in range(num_docs):
+        env.expect('hset', f'doc{i}', 't', 'testvalue').equal(1)
+
+    res = env.cmd('ft.search', 'idx', '@t:{testvalue}', 'NOCONTENT', 'LIMIT', 0, 0)
+    env.assertEqual(res[0], num_docs, message=res)
+
+    # Delete every third document, leaving gaps inside every group
+    for i in range(0, num_docs, 3):
+        env.expect('del', f'doc{i}').equal(1)
+
+    forceInvokeGC(env, 'idx')
+
+    expected = num_docs - len(range(0, num_docs, 3))
+    res = env.cmd('ft.search', 'idx', '@t:{testvalue}', 'NOCONTENT', 'LIMIT', 0, 0)
+    env.assertEqual(res[0], expected, message=res)
+
+
+@skip(cluster=True)
+def testTagIntersectionWithPackedDocIdEncoding():
+    """Test TAG intersection queries with PACKED_DOCID_ENCODING.
+
+    Intersections skip ahead in the packed inverted indexes, exercising
+    the group-at-a-time seek path.
+    """
+    env = Env(moduleArgs='PACKED_DOCID_ENCODING true')
+    env.expect('ft.create', 'idx', 'ON', 'HASH',
+               'schema', 't1', 'TAG', 't2', 'TAG').ok()
+
+    for i in range(1000):
+        t1 = 'A' if i % 2 == 0 else 'B'
+        t2 = 'X' if i % 7 == 0 else 'Y'
+        env.expect('hset', f'doc{i}', 't1', t1, 't2', t2).equal(2)
+
+    res = env.cmd('ft.search', 'idx', '@t1:{A} @t2:{X}', 'NOCONTENT', 'LIMIT', 0, 0)
+    expected = len([i for i in range(1000) if i % 2 == 0 and i % 7 == 0])
+    env.assertEqual(res[0], expected, message=res)
+
+    res = env.cmd('ft.search', 'idx', '@t1:{B} @t2:{Y}', 'NOCONTENT', 'LIMIT', 0, 0)
+    expected = len([i for i in range(1000) if i % 2 == 1 and i % 7 != 0])
+    env.assertEqual(res[0], expected, message=res)
+
+
+@skip(cluster=True)
+def testWildcardWithPackedDocIdEncoding():
+    """Test wildcard queries with PACKED_DOCID_ENCODING enabled.
+
+    When INDEXALL is ENABLE and PACKED_DOCID_ENCODING is true, the
+    existingDocs inverted index uses PackedDocIdsOnly encoding.
+    """
+    env = Env(moduleArgs='DEFAULT_DIALECT 2 PACKED_DOCID_ENCODING true FORK_GC_CLEAN_THRESHOLD 0')
+    env.expect('ft.create', 'idx', 'INDEXALL', 'ENABLE',
+               'ON', 'HASH', 'SCHEMA', 't', 'TEXT').ok()
+
+    num_docs = 300
+    for i in range(num_docs):
+        env.expect('hset', f'doc{i}', 't', 'hello').equal(1)
+
+    res = env.cmd('ft.search', 'idx', '*', 'NOCONTENT', 'LIMIT', 0, 0)
+    env.assertEqual(res[0], num_docs)
+
+    for i in range(0, num_docs, 2):
+        env.expect('del', f'doc{i}').equal(1)
+
+    forceInvokeGC(env, 'idx')
+    res = env.cmd('ft.search', 'idx', '*', 'NOCONTENT', 'LIMIT', 0, 0)
+    env.assertEqual(res[0], num_docs // 2)
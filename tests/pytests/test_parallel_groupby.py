@@ -0,0 +1,105 @@
+from common import *
+
+# Enough rows for several full waves of the grouper (see GROUPER_WAVE_SIZE) and a partial one
+NUM_DOCS = 3 * 4096 + 500
+
+def setupIndex(env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TAG', 'SORTABLE', 'n', 'NUMERIC', 'SORTABLE',
+               'pair', 'TEXT', 'SORTABLE').ok()
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline(transaction=False)
+    for i in range(NUM_DOCS):
+        pl.execute_command('HSET', f'doc{i}', 't', f'tag{i % 5000}', 'n', i % 997,
+                           'pair', f'a{i % 3},b{i % 11}')
+        if i % 1000 == 999:
+            pl.execute()
+    pl.execute()
+
+def runQueries(env):
+    return [env.cmd(*query) for query in (
+        # High cardinality, with a reducer of every kind
+        ['FT.AGGREGATE', 'idx', '*', 'GROUPBY', 1, '@t',
+         'REDUCE', 'COUNT', 0, 'AS', 'c',
+         'REDUCE', 'SUM', 1, '@n', 'AS', 's',
+         'REDUCE', 'AVG', 1, '@n', 'AS', 'a',
+         'REDUCE', 'MIN', 1, '@n', 'AS', 'lo',
+         'REDUCE', 'MAX', 1, '@n', 'AS', 'hi',
+         'REDUCE', 'COUNT_DISTINCT', 1, '@n', 'AS', 'cd',
+         'REDUCE', 'STDDEV', 1, '@n', 'AS', 'sd',
+         'REDUCE', 'QUANTILE', 2, '@n', 0.5, 'AS', 'q',
+         'REDUCE', 'FIRST_VALUE', 4, '@n', 'BY', '@n', 'DESC', 'AS', 'fv',
+         'SORTBY', 2, '@t', 'ASC', 'MAX', 5000],
+        # Rows split into several groups
+        ['FT.AGGREGATE', 'idx', '*', 'APPLY', 'split(@pair, ",")', 'AS', 'p',
+         'GROUPBY', 1, '@p', 'REDUCE', 'COUNT', 0, 'AS', 'c', 'REDUCE', 'TOLIST', 1, '@n', 'AS', 'l',
+         'APPLY', 'count(@l)', 'AS', 'l', 'SORTBY', 2, '@p', 'ASC'],
+        ['FT.AGGREGATE', 'idx', '@n:[0 10]', 'GROUPBY', 2, '@n', '@t', 'REDUCE', 'COUNT', 0, 'AS', 'c',
+         'SORTBY', 4, '@n', 'ASC', '@t', 'ASC', 'MAX', 100],
+        ['FT.AGGREGATE', 'idx', '*', 'GROUPBY', 0, 'REDUCE', 'COUNT', 0, 'AS', 'c'],
+    )]
+
+@skip(cluster=True)
+def testParallelGroupByMatchesSerial():
+    env = Env(moduleArgs='WORKERS 4')
+    setupIndex(env)
+    serial = runQueries(env)
+
+    # Along with a parallel scan
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 4).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 0).ok()
+    env.assertEqual(runQueries(env), serial)
+
+@skip(cluster=True)
+def testParallelGroupByLimit():
+    env = Env(moduleArgs='WORKERS 4 MAX_AGGREGATE_GROUPS 4999')
+    setupIndex(env)
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 4).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 0).ok()
+
+    env.expect('FT.AGGREGATE', 'idx', '*', 'GROUPBY', 1, '@t', 'REDUCE', 'COUNT', 0, 'AS', 'c').error() \
+        .contains('MAX_AGGREGATE_GROUPS')
+    res = env.cmd('FT.AGGREGATE', 'idx', '@n:[0 500]', 'GROUPBY', 1, '@n', 'REDUCE', 'COUNT', 0, 'AS', 'c')
+    env.assertEqual(res[0], 501)
+
+@skip(cluster=True)
+def testParallelGroupByLoadsFieldsOnce():
+    env = Env(moduleArgs='WORKERS 4', protocol=3)
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'g', 'TAG', 'n', 'NUMERIC').ok()
+    conn = getConnectionByEnv(env)
+    for i in range(100):
+        conn.execute_command('HSET', f'doc{i}', 'g', f'g{i % 7}', 'n', i)
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 4).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 0).ok()
+    env.expect(config_cmd(), 'SET', '_PRINT_PROFILE_CLOCK', 'true').ok()
+
+    # Every partition has its own reducers, but the fields are loaded once
+    res = env.cmd('FT.PROFILE', 'idx', 'AGGREGATE', 'QUERY', '*', 'GROUPBY', 1, '@g',
+                  'REDUCE', 'SUM', 1, '@n', 'AS', 's', 'REDUCE', 'MAX', 1, '@n', 'AS', 'm')
+    shard = res['Profile']['Shards'][0]
+    loader = next(rp for rp in shard['Result processors profile'] if 'Loader' in rp['Type'])
+    fields = [field['Field'] for field in loader['Field loads profile']]
+    env.assertEqual(sorted(fields), ['g', 'n'])
+
+def groupPartitions(env, query):
+    res = env.cmd('FT.PROFILE', 'idx', 'AGGREGATE', 'QUERY', query, 'GROUPBY', 1, '@g',
+                  'REDUCE', 'COUNT', 0, 'AS', 'c')
+    shard = res['Profile']['Shards'][0]
+    grouper = next(rp for rp in shard['Result processors profile'] if rp['Type'] == 'Grouper')
+    return grouper.get('Partitions', 1)
+
+@skip(cluster=True)
+def testParallelGroupByMinDocs():
+    env = Env(moduleArgs='WORKERS 4', protocol=3)
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'g', 'TAG').ok()
+    conn = getConnectionByEnv(env)
+    for i in range(100):
+        conn.execute_command('HSET', f'doc{i}', 'g', f'g{i % 7}')
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 4).ok()
+
+    # Small queries are grouped serially, as they are scanned
+    env.assertEqual(groupPartitions(env, '*'), 1)
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 50).ok()
+    env.assertEqual(groupPartitions(env, '@g:{g1}'), 1)
+    env.assertEqual(groupPartitions(env, '*'), 4)
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 0).ok()
+    env.assertEqual(groupPartitions(env, '@g:{g1}'), 4)
@@ -0,0 +1,63 @@
+from common import *
+
+# Three slices of the document id space and a part of a fourth (see PARALLEL_SCAN_SLICE_SIZE)
+NUM_DOCS = 3 * 16384 + 1000
+
+def setupIndex(env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TAG', 'n', 'NUMERIC', 'SORTABLE', 'body', 'TEXT').ok()
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline(transaction=False)
+    for i in range(NUM_DOCS):
+        pl.execute_command('HSET', f'doc{i}', 't', f'tag{i % 7}', 'n', i, 'body', 'hello' if i % 3 else 'hello world')
+        if i % 1000 == 999:
+            pl.execute()
+    pl.execute()
+
+def runQueries(env):
+    return [env.cmd(*query) for query in (
+        ['FT.AGGREGATE', 'idx', '*', 'GROUPBY', 1, '@t', 'REDUCE', 'COUNT', 0, 'AS', 'c', 'SORTBY', 2, '@t', 'ASC'],
+        ['FT.AGGREGATE', 'idx', 'world', 'GROUPBY', 0, 'REDUCE', 'COUNT', 0, 'AS', 'c'],
+        ['FT.AGGREGATE', 'idx', '@t:{tag3} -world', 'GROUPBY', 0, 'REDUCE', 'SUM', 1, '@n', 'AS', 's'],
+        # Matches only at the end of the id space, so that the scan skips the empty slices
+        ['FT.AGGREGATE', 'idx', f'@n:[{NUM_DOCS - 500} +inf]', 'GROUPBY', 0, 'REDUCE', 'COUNT', 0, 'AS', 'c'],
+        ['FT.SEARCH', 'idx', 'hello', 'LIMIT', 0, 0],
+        ['FT.SEARCH', 'idx', '@t:{tag1 | tag2}', 'SORTBY', 'n', 'DESC', 'LIMIT', 0, 5, 'NOCONTENT'],
+    )]
+
+@skip(cluster=True)
+def testParallelScanMatchesSerialScan():
+    env = Env(moduleArgs='WORKERS 4')
+    setupIndex(env)
+    serial = runQueries(env)
+
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 4).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 0).ok()
+    env.assertEqual(runQueries(env), serial)
+
+    # A degree of parallelism above the number of workers is capped by it
+    env.expect(config_cmd(), 'SET', 'WORKERS', 2).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 16).ok()
+    env.assertEqual(runQueries(env), serial)
+
+@skip(cluster=True)
+def testParallelScanCursor():
+    env = Env(moduleArgs='WORKERS 4')
+    setupIndex(env)
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 4).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_PARALLEL_MIN_DOCS', 0).ok()
+
+    # The results of a parallel scan are read in chunks
+    res, cursor = env.cmd('FT.AGGREGATE', 'idx', 'hello', 'LOAD', 1, '@n', 'SORTBY', 2, '@n', 'ASC',
+                          'MAX', NUM_DOCS, 'WITHCURSOR', 'COUNT', 1000)
+    numbers = [int(row[1]) for row in res[1:]]
+    while cursor:
+        res, cursor = env.cmd('FT.CURSOR', 'READ', 'idx', cursor)
+        numbers += [int(row[1]) for row in res[1:]]
+    env.assertEqual(numbers, list(range(NUM_DOCS)))
+
+def testParallelScanConfig():
+    env = Env()
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 0).error()
+    env.expect(config_cmd(), 'SET', 'QUERY_MAX_PARALLELISM', 1 << 20).error()
+    env.expect('CONFIG', 'SET', 'search-query-max-parallelism', 3).ok()
+    env.expect(config_cmd(), 'GET', 'QUERY_MAX_PARALLELISM').equal([['QUERY_MAX_PARALLELISM', '3']])
@@ -0,0 +1,136 @@
+from common import *
+
+
+def getQueryCacheStats(env, idx='idx'):
+    return to_dict(index_info(env, idx)['query_cache_stats'])
+
+def setupIndex(env, num_docs=10):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'n', 'NUMERIC', 'SORTABLE').ok()
+    conn = getConnectionByEnv(env)
+    for i in range(num_docs):
+        conn.execute_command('HSET', f'doc{i}', 't', f'hello world{i % 2}', 'n', i)
+
+@skip(cluster=True)
+def testQueryCacheDisabledByDefault(env):
+    setupIndex(env)
+    env.cmd('FT.SEARCH', 'idx', 'hello')
+    env.cmd('FT.SEARCH', 'idx', 'hello')
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['hits'], 0)
+    env.assertEqual(stats['misses'], 0)
+    env.assertEqual(stats['entries'], 0)
+
+@skip(cluster=True)
+def testQueryCacheHit(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+
+    for query in (['FT.SEARCH', 'idx', 'hello', 'SORTBY', 'n', 'LIMIT', 0, 3],
+                  ['FT.AGGREGATE', 'idx', '@n:[2 5]', 'LOAD', 1, '@t', 'SORTBY', 2, '@n', 'ASC']):
+        expected = env.cmd(*query)
+        env.assertEqual(env.cmd(*query), expected)
+        env.assertEqual(env.cmd(*query), expected)
+
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['misses'], 2)
+    env.assertEqual(stats['hits'], 4)
+    env.assertEqual(stats['entries'], 2)
+    env.assertGreater(stats['memory'], 0)
+
+    # The key is the parsed query: spacing differences share the entry, reply-shaping arguments do not
+    env.cmd('FT.SEARCH', 'idx', '  hello ', 'SORTBY', 'n', 'LIMIT', 0, 3)
+    env.assertEqual(getQueryCacheStats(env)['hits'], 5)
+    env.cmd('FT.SEARCH', 'idx', 'hello', 'SORTBY', 'n', 'LIMIT', 0, 4)
+    env.assertEqual(getQueryCacheStats(env)['misses'], 3)
+
+    # NOCACHE bypasses the cache
+    env.cmd('FT.SEARCH', 'idx', 'hello', 'SORTBY', 'n', 'LIMIT', 0, 3, 'NOCACHE')
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['hits'], 5)
+    env.assertEqual(stats['misses'], 3)
+
+@skip(cluster=True)
+def testQueryCacheInvalidation(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+    conn = getConnectionByEnv(env)
+    query = ['FT.SEARCH', 'idx', 'hello', 'SORTBY', 'n', 'LIMIT', 0, 100]
+
+    before = env.cmd(*query)
+    env.assertEqual(before[0], 10)
+
+    # Adding a document is visible right away
+    conn.execute_command('HSET', 'doc100', 't', 'hello', 'n', 100)
+    after = env.cmd(*query)
+    env.assertEqual(after[0], 11)
+    env.assertEqual(getQueryCacheStats(env)['invalidations'], 1)
+
+    # So is deleting one
+    conn.execute_command('DEL', 'doc100')
+    env.assertEqual(env.cmd(*query), before)
+
+    # And changing a field that is not indexed but returned
+    conn.execute_command('HSET', 'doc0', 'other', 'value')
+    res = env.cmd(*query)
+    env.assertContains('other', res[2])
+
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['hits'], 0)
+    env.assertEqual(stats['invalidations'], 3)
+
+@skip(cluster=True)
+def testQueryCacheConfigChange(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+    query = ['FT.SEARCH', 'idx', 'wor*', 'NOCONTENT', 'SORTBY', 'n', 'LIMIT', 0, 100]
+
+    env.assertEqual(env.cmd(*query)[0], 10)
+    env.assertEqual(env.cmd(*query)[0], 10)
+    env.assertEqual(getQueryCacheStats(env)['hits'], 1)
+
+    # Runtime config changes are not served replies computed under the previous values
+    env.expect(config_cmd(), 'SET', 'MAXEXPANSIONS', 1).ok()
+    env.assertEqual(env.cmd(*query)[0], 5)
+    env.expect(config_cmd(), 'SET', 'MAXEXPANSIONS', 200).ok()
+    env.assertEqual(env.cmd(*query)[0], 10)
+    env.assertEqual(getQueryCacheStats(env)['hits'], 2)
+
+    env.expect(config_cmd(), 'SET', 'TIMEOUT', 10000).ok()
+    env.cmd(*query)
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['hits'], 2)
+    env.assertEqual(stats['misses'], 3)
+
+@skip(cluster=True)
+def testQueryCacheDocExpiration(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    setupIndex(env)
+    conn = getConnectionByEnv(env)
+    query = ['FT.SEARCH', 'idx', 'hello', 'NOCONTENT', 'SORTBY', 'n', 'LIMIT', 0, 100]
+
+    # The replies of an index with expiring documents depend on the time
+    conn.execute_command('EXPIRE', 'doc0', 10000)
+    env.cmd(*query)
+    env.cmd(*query)
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['hits'], 0)
+    env.assertEqual(stats['misses'], 0)
+    env.assertEqual(stats['entries'], 0)
+
+@skip(cluster=True)
+def testQueryCacheEviction(env):
+    setupIndex(env)
+    # Room for a single small reply
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1536).ok()
+
+    env.cmd('FT.SEARCH', 'idx', 'world0', 'NOCONTENT')
+    env.cmd('FT.SEARCH', 'idx', 'world1', 'NOCONTENT')
+    stats = getQueryCacheStats(env)
+    env.assertEqual(stats['entries'], 1)
+    env.assertEqual(stats['evictions'], 1)
+    env.assertLessEqual(stats['memory'], 1536)
+
+    # Disabling the cache drops its entries
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 0).ok()
+    env.cmd('FT.SEARCH', 'idx', 'world1', 'NOCONTENT')
+    env.assertEqual(getQueryCacheStats(env)['entries'], 0)
@@ -572,6 +572,10 @@ def test_info():
       'offset_vectors_sz_mb': ANY,
       'offsets_per_term_avg': ANY,
       'percent_indexed': 1.0,
+      'query_cache_stats': {'hits': 0, 'misses': 0, 'evictions': 0, 'invalidations': 0, 'entries': 0,
+                            'memory': 0},
+      'filter_cache_stats': {'hits': 0, 'misses': 0, 'evictions': 0, 'invalidations': 0, 'entries': 0,
+                             'memory': 0},
       'records_per_doc_avg': ANY,
       'sortable_values_size_mb': 0.0,
       'geoshapes_sz_mb': 0.0,
@@ -1435,6 +1439,7 @@ def test_ft_info():
           'average_cycle_time_ms': nan,
           'bytes_collected': 0.0,
           'gc_blocks_denied': 0.0,
+          'gc_blocks_merged': 0.0,
           'gc_numeric_trees_missed': 0.0,
           'last_run_time_ms': 0.0,
           'total_cycles': 0.0,
@@ -1465,6 +1470,22 @@ def test_ft_info():
         'offset_vectors_sz_mb': 0.0,
         'offsets_per_term_avg': nan,
         'percent_indexed': 1.0,
+        'query_cache_stats': {
+          'hits': 0,
+          'misses': 0,
+          'evictions': 0,
+          'invalidations': 0,
+          'entries': 0,
+          'memory': 0
+        },
+        'filter_cache_stats': {
+          'hits': 0,
+          'misses': 0,
+          'evictions': 0,
+          'invalidations': 0,
+          'entries': 0,
+          'memory': 0
+        },
         'records_per_doc_avg': nan,
         'sortable_values_size_mb': 0.0,
         'geoshapes_sz_mb': 0.0,
@@ -1517,6 +1538,7 @@ def test_ft_info():
               'average_cycle_time_ms': 0.0,
               'bytes_collected': 0.0,
               'gc_blocks_denied': 0.0,
+              'gc_blocks_merged': 0.0,
               'gc_numeric_trees_missed': 0.0,
               'last_run_time_ms': 0.0,
               'total_cycles': 0.0,
@@ -1550,6 +1572,22 @@ def test_ft_info():
         'offset_vectors_sz_mb': 0.0,
         'offsets_per_term_avg': nan,
         'percent_indexed': 1.0,
+        'query_cache_stats': {
+          'hits': 0,
+          'misses': 0,
+          'evictions': 0,
+          'invalidations': 0,
+          'entries': 0,
+          'memory': 0
+        },
+        'filter_cache_stats': {
+          'hits': 0,
+          'misses': 0,
+          'evictions': 0,
+          'invalidations': 0,
+          'entries': 0,
+          'memory': 0
+        },
         'records_per_doc_avg': nan,
         'sortable_values_size_mb': 0.0,
         'geoshapes_sz_mb': 0.0,